@@ -1,15 +1,23 @@
 #include "../pch.h"
 #include "../Model/GeometryGenerator.h"
+#include "../Model/MeshletBuilder.h"
 #include "App.h"
 
 void App::Initialize()
 {
 	UINT64 totalRenderObjectCount = 0;
 
+	QueryPerformanceCounter(&m_InitBeginTime);
+
 	initMainWidndow();
 	initDirect3D();
 	initPhysics();
+
+	// whole scene goes to GPU in as few submissions as staging ring allows.
+	ResourceManager* pManager = GetResourceManager();
+	pManager->BeginUpload();
 	initExternalData(&totalRenderObjectCount);
+	pManager->EndUpload();
 
 	Renderer::InitialData initData =
 	{
@@ -42,6 +50,7 @@ int App::Run()
 			static UINT s_FrameCount = 0;
 			static UINT64 s_PrevUpdateTick = 0;
 			static UINT64 s_PrevFrameCheckTick = 0;
+			static UINT64 s_DescriptorWriteSum = 0;
 
 			float frameTime = (float)m_Timer.GetElapsedSeconds();
 			float frameChange = 2.0f * frameTime;
@@ -52,16 +61,27 @@ int App::Run()
 			Update(frameChange);
 			s_PrevUpdateTick = curTick;
 			Render();
+			reportLoadingStats(frameTime);
+			s_DescriptorWriteSum += GetLastFrameDescriptorWriteCount();
 
 			if (curTick - s_PrevFrameCheckTick > 1000)
 			{
 				s_PrevFrameCheckTick = curTick;
 
-				WCHAR txt[64];
-				swprintf_s(txt, L"DX12  %uFPS", s_FrameCount);
+				// descriptor writes are averaged over interval. single frame jumps with streaming and table rewrites.
+				WCHAR txt[512];
+				swprintf_s(txt, L"DX12  %uFPS  Cluster culled: %u / %u tris  Streaming: %u (worst %.1fms)  Constants: %.1fKB/frame  Descriptors: %u/frame (table cache %u/%u, pages %u)  State changes: %u/%u draws  State calls: %u issued, %u filtered", s_FrameCount, m_CulledClusterTriangleCount, m_ClusterTriangleCount, GetAssetStreamer()->GetPendingCount(), m_WorstStreamingFrameTime * 1000.0f,
+				           (double)GetResourceManager()->GetFrameConstantAllocator()->GetStats().LastFrameUploadedBytes / 1024.0, (UINT)(s_DescriptorWriteSum / s_FrameCount),
+				           GetLastFrameTableCacheHitCount(), GetLastFrameTableCacheLookupCount(), GetLastFrameDescriptorPageHighWater(),
+				           GetLastFrameStateChangeCount(), GetLastFrameRenderItemCount(), GetLastFrameStateCallIssuedCount(), GetLastFrameStateCallFilteredCount());
 				SetWindowText(m_hMainWindow, txt);
 
+				// same line goes to debug output, so counters of whole run can be recorded and compared.
+				OutputDebugStringW(txt);
+				OutputDebugStringW(L"\n");
+
 				s_FrameCount = 0;
+				s_DescriptorWriteSum = 0;
 			}
 		}
 	}
@@ -79,7 +99,9 @@ void App::Update(const float DELTA_TIME)
 
 		switch (pModel->ModelType)
 		{
+			// every drawn model uploads its frame constants, skybox too.
 			case RenderObjectType_DefaultType:
+			case RenderObjectType_SkyboxType:
 			case RenderObjectType_MirrorType:
 				pModel->UpdateConstantBuffers();
 				break;
@@ -112,6 +134,7 @@ void App::Clear()
 		delete pModel;
 	}
 	m_RenderObjects.clear();
+	GetTextureCache()->Trim();
 	m_Lights.clear();
 	m_LightSpheres.clear();
 
@@ -187,15 +210,17 @@ void App::initExternalData(UINT64* pTotalRenderObjectCount)
 	{
 		for (int i = 0; i < MAX_LIGHTS; ++i)
 		{
-			MeshInfo sphere = INIT_MESH_INFO;
-			MakeSphere(&sphere, 1.0f, 20, 20);
+			std::vector<MeshInfo> sphere(1, INIT_MESH_INFO);
+			MakeSphere(&sphere[0], 1.0f, 20, 20);
+			BuildStaticMeshlets(&sphere);
 
-			m_LightSpheres[i] = new Model(pRenderer, { sphere });
+			m_LightSpheres[i] = new Model(pRenderer, sphere);
 			m_LightSpheres[i]->UpdateWorld(Matrix::CreateTranslation(m_Lights[i].Property.Position));
 
 			MaterialConstant* pSphereMaterialConst = (MaterialConstant*)m_LightSpheres[i]->Meshes[0]->MaterialConstant.pData;
 			pSphereMaterialConst->AlbedoFactor = Vector3(0.0f);
 			pSphereMaterialConst->EmissionFactor = Vector3(1.0f, 1.0f, 0.0f);
+			m_LightSpheres[i]->Meshes[0]->MaterialConstant.MarkDirty();
 			m_LightSpheres[i]->bCastShadow = false; //  ǥ ü ׸ X.
 			for (UINT64 j = 0, size = m_LightSpheres[i]->Meshes.size(); j < size; ++j)
 			{
@@ -203,6 +228,7 @@ void App::initExternalData(UINT64* pTotalRenderObjectCount)
 				MaterialConstant* pMeshMaterialConst = (MaterialConstant*)pCurMesh->MaterialConstant.pData;
 				pMeshMaterialConst->AlbedoFactor = Vector3(0.0f);
 				pMeshMaterialConst->EmissionFactor = Vector3(1.0f, 1.0f, 0.0f);
+				pCurMesh->MaterialConstant.MarkDirty();
 			}
 
 			m_LightSpheres[i]->bIsVisible = true;
@@ -234,6 +260,7 @@ void App::initExternalData(UINT64* pTotalRenderObjectCount)
 		pGroundMaterialConst->EmissionFactor = Vector3(0.0f);
 		pGroundMaterialConst->MetallicFactor = 0.5f;
 		pGroundMaterialConst->RoughnessFactor = 0.3f;
+		pGround->Meshes[0]->MaterialConstant.MarkDirty();
 
 		// Vector3 position = Vector3(0.0f, -1.0f, 0.0f);
 		// Vector3 position = Vector3(0.0f, -0.5f, 0.0f);
@@ -303,6 +330,7 @@ void App::initExternalData(UINT64* pTotalRenderObjectCount)
 			pMeshConst->AlbedoFactor = Vector3(1.0f);
 			pMeshConst->RoughnessFactor = 0.8f;
 			pMeshConst->MetallicFactor = 0.0f;
+			pCurMesh->MaterialConstant.MarkDirty();
 		}
 		m_pCharacter->Name = "MainCharacter";
 		m_pCharacter->bIsPickable = true;
@@ -350,6 +378,7 @@ void App::initExternalData(UINT64* pTotalRenderObjectCount)
 		pGroundMaterialConst->EmissionFactor = Vector3(0.0f);
 		pGroundMaterialConst->MetallicFactor = 0.5f;
 		pGroundMaterialConst->RoughnessFactor = 0.3f;
+		pSlope->Meshes[0]->MaterialConstant.MarkDirty();
 
 		// Vector3 position = Vector3(0.0f, -1.0f, 0.0f);
 		Vector3 position(0.0f);
@@ -504,3 +533,47 @@ void App::updateAnimationState(const float DELTA_TIME)
 	m_pCharacter->UpdateAnimation(s_State, s_FrameCount, DELTA_TIME);
 	++s_FrameCount;
 }
+
+void App::reportLoadingStats(const float FRAME_TIME)
+{
+	AssetStreamer* pStreamer = GetAssetStreamer();
+
+	if (!m_bFirstFrameReported)
+	{
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER curTime;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&curTime);
+		m_bFirstFrameReported = true;
+
+		const TextureCacheStats& CACHE_STATS = GetTextureCache()->GetStats();
+		const UploadStats& UPLOAD_STATS = GetResourceManager()->GetUploadStats();
+		char debugString[512];
+		sprintf_s(debugString, "Time to first frame: %.1fms, %u assets streaming. texture cache %u hits, %u content hits, %u misses. uploads: %u in %u submissions, %.1fMB, %u stalls.\n",
+				  (double)(curTime.QuadPart - m_InitBeginTime.QuadPart) * 1000.0 / (double)frequency.QuadPart, pStreamer->GetPendingCount(),
+				  CACHE_STATS.HitCount, CACHE_STATS.HashHitCount, CACHE_STATS.MissCount,
+				  UPLOAD_STATS.UploadCount, UPLOAD_STATS.SubmitCount, (double)UPLOAD_STATS.UploadedBytes / (1024.0 * 1024.0), UPLOAD_STATS.StallCount);
+		OutputDebugStringA(debugString);
+		return;
+	}
+
+	if (!pStreamer->IsIdle())
+	{
+		m_WorstStreamingFrameTime = Max(m_WorstStreamingFrameTime, FRAME_TIME);
+		m_bStreamingReported = false;
+		return;
+	}
+
+	if (!m_bStreamingReported && pStreamer->GetStats().RequestCount > 0)
+	{
+		const StreamingStats& STATS = pStreamer->GetStats();
+		m_bStreamingReported = true;
+
+		char debugString[512];
+		sprintf_s(debugString, "Streaming done. completed: %u, failed: %u, cancelled: %u, io: %.1fms, decode: %.1fms, max latency: %.1fms, max upload: %.2fms, worst frame: %.1fms\n",
+				  STATS.CompletedCount, STATS.FailedCount, STATS.CancelledCount,
+				  STATS.IOMilliseconds, STATS.DecodeMilliseconds, STATS.MaxLatencyMilliseconds, STATS.MaxCompletionMilliseconds,
+				  m_WorstStreamingFrameTime * 1000.0f);
+		OutputDebugStringA(debugString);
+	}
+}
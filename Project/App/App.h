@@ -1,7 +1,6 @@
 #pragma once
 
 #include "../Graphics/Light.h"
-#include "../Util/LinkedList.h"
 #include "../Model/Model.h"
 #include "../Renderer/Renderer.h"
 #include "../Util/Utility.h"
@@ -25,10 +24,17 @@ protected:
 	void initExternalData(UINT64* pTotalRenderObjectCount);
 
 	void updateAnimationState(const float DELTA_TIME);
+	void reportLoadingStats(const float FRAME_TIME);
 
 private:
 	Timer m_Timer;
 
+	// loading stats.
+	LARGE_INTEGER m_InitBeginTime = {};
+	bool m_bFirstFrameReported = false;
+	bool m_bStreamingReported = false;
+	float m_WorstStreamingFrameTime = 0.0f;
+
 	// data
 	std::vector<Model*> m_RenderObjects;
 	std::vector<Light> m_Lights;
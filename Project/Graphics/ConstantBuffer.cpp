@@ -1,5 +1,6 @@
 #include "../pch.h"
 #include "../Renderer/ResourceManager.h"
+#include "../Util/Utility.h"
 #include "ConstantBuffer.h"
 
 void ConstantBuffer::Initialize(Renderer* pRenderer, UINT64 bufferSize)
@@ -10,7 +11,6 @@ void ConstantBuffer::Initialize(Renderer* pRenderer, UINT64 bufferSize)
 
 	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 
 	m_BufferSize = (bufferSize + 255) & ~(255);
 	m_DataSize = bufferSize;
@@ -18,44 +18,17 @@ void ConstantBuffer::Initialize(Renderer* pRenderer, UINT64 bufferSize)
 	pData = malloc(m_DataSize);
 	ZeroMemory(pData, m_DataSize);
 
-	D3D12_RESOURCE_DESC resourceDesc;
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	resourceDesc.Alignment = 0;
-	resourceDesc.Width = m_BufferSize;
-	resourceDesc.Height = 1;
-	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 1;
-	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.SampleDesc.Quality = 0;
-	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-	D3D12_HEAP_PROPERTIES heapProps;
-	heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-	heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-	heapProps.CreationNodeMask = 1;
-	heapProps.VisibleNodeMask = 1;
-
-	hr = pDevice->CreateCommittedResource(&heapProps,
-										  D3D12_HEAP_FLAG_NONE,
-										  &resourceDesc,
-										  D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER,
-										  nullptr,
-										  IID_PPV_ARGS(&m_pResource));
+	// CBV address must be 256 bytes aligned.
+	hr = pManager->GetUploadBufferPool()->Allocate(m_BufferSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, &m_Allocation);
 	BREAK_IF_FAILED(hr);
-	m_pResource->SetName(L"ConstantResource");
 
-	m_GPUMemAddr = m_pResource->GetGPUVirtualAddress();
-
-	CD3DX12_RANGE writeRange(0, 0);
-	m_pResource->Map(0, &writeRange, &m_pSystemMemAddr);
+	m_GPUMemAddr = m_Allocation.GPUAddress;
+	m_pSystemMemAddr = m_Allocation.pMappedPtr;
 }
 
 void ConstantBuffer::Upload()
 {
-	_ASSERT(m_pResource);
+	_ASSERT(m_Allocation.pResource);
 	_ASSERT(m_pSystemMemAddr);
 	_ASSERT(pData);
 
@@ -76,13 +49,92 @@ void ConstantBuffer::Cleanup()
 	m_GPUMemAddr = 0xffffffffffffffff;
 	// m_CBVHandle = { 0xffffffffffffffff, };
 
-	if (m_pResource)
+	m_pSystemMemAddr = nullptr;
+	if (m_Allocation.pPool)
+	{
+		m_Allocation.pPool->Free(&m_Allocation);
+	}
+}
+
+void FrameConstantBuffer::Initialize(Renderer* pRenderer, UINT64 dataSize)
+{
+	_ASSERT(pRenderer);
+
+	Cleanup();
+
+	HRESULT hr = S_OK;
+	ResourceManager* pManager = pRenderer->GetResourceManager();
+	m_pAllocator = pManager->GetFrameConstantAllocator();
+
+	m_BufferSize = (dataSize + 255) & ~(255);
+	m_DataSize = dataSize;
+
+	pData = malloc(m_DataSize);
+	ZeroMemory(pData, m_DataSize);
+
+	hr = pManager->GetUploadBufferPool()->Allocate(m_BufferSize * m_pAllocator->GetFrameCount(), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, &m_Allocation);
+	BREAK_IF_FAILED(hr);
+}
+
+void FrameConstantBuffer::Upload()
+{
+	_ASSERT(m_pAllocator);
+	_ASSERT(m_Allocation.pMappedPtr);
+	_ASSERT(pData);
+
+	// GPU is done with copy of this frame index, see Renderer::present().
+	const UINT FRAME_INDEX = m_pAllocator->GetFrameIndex();
+	const UINT64 OFFSET = m_BufferSize * FRAME_INDEX;
+	m_GPUMemAddr = m_Allocation.GPUAddress + OFFSET;
+	m_UploadedFrameSerial = m_pAllocator->GetFrameSerial();
+
+	if (m_pCopyVersions[FRAME_INDEX] == m_Version)
 	{
-		CD3DX12_RANGE writeRange(0, 0);
-		m_pResource->Unmap(0, &writeRange);
-		m_pSystemMemAddr = nullptr;
+		// pData written without MarkDirty(). compared against CPU side hash, upload heap is write combined.
+		_ASSERT(HashBytes(pData, m_DataSize) == m_DebugDataHash);
 
-		m_pResource->Release();
-		m_pResource = nullptr;
+		m_pAllocator->CountSkip();
+		return;
+	}
+
+	memcpy(m_Allocation.pMappedPtr + OFFSET, pData, m_DataSize);
+	m_pCopyVersions[FRAME_INDEX] = m_Version;
+#ifdef _DEBUG
+	m_DebugDataHash = HashBytes(pData, m_DataSize);
+#endif
+	m_pAllocator->CountUpload(m_DataSize);
+}
+
+void FrameConstantBuffer::CreateCBV(ID3D12Device5* pDevice, const D3D12_CPU_DESCRIPTOR_HANDLE DEST)
+{
+	_ASSERT(pDevice);
+	// drawn without Upload() in this frame. address may be copy of other frame.
+	_ASSERT(m_pAllocator && m_UploadedFrameSerial == m_pAllocator->GetFrameSerial());
+
+	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
+	cbvDesc.BufferLocation = m_GPUMemAddr;
+	cbvDesc.SizeInBytes = (UINT)m_BufferSize;
+	pDevice->CreateConstantBufferView(&cbvDesc, DEST);
+}
+
+void FrameConstantBuffer::Cleanup()
+{
+	if (pData)
+	{
+		free(pData);
+		pData = nullptr;
+	}
+
+	m_DataSize = 0;
+	m_BufferSize = 0;
+
+	m_GPUMemAddr = 0;
+	m_UploadedFrameSerial = 0;
+	m_Version = 1;
+	ZeroMemory(m_pCopyVersions, sizeof(m_pCopyVersions));
+	m_pAllocator = nullptr;
+	if (m_Allocation.pPool)
+	{
+		m_Allocation.pPool->Free(&m_Allocation);
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../Renderer/Renderer.h"
+#include "../Renderer/GPUBufferPool.h"
+#include "../Renderer/FrameConstantAllocator.h"
 
 class Renderer;
 
@@ -18,7 +20,7 @@ public:
 
 	inline void SetCBVHandle(const D3D12_CPU_DESCRIPTOR_HANDLE HANDLE) { m_CBVHandle = HANDLE; }
 
-	inline ID3D12Resource* GetResource() { return m_pResource; }
+	inline ID3D12Resource* GetResource() { return m_Allocation.pResource; }
 	inline void* GetSysMemAddr() { return m_pSystemMemAddr; }
 	inline D3D12_GPU_VIRTUAL_ADDRESS GetGPUMemAddr() { return m_GPUMemAddr; }
 	inline D3D12_CPU_DESCRIPTOR_HANDLE GetCBVHandle() { return m_CBVHandle; }
@@ -28,7 +30,7 @@ public:
 	void* pData = nullptr;
 
 private:
-	ID3D12Resource* m_pResource = nullptr;
+	GPUBufferAllocation m_Allocation; // range of resource manager's upload buffer pool.
 	void* m_pSystemMemAddr = nullptr;
 	D3D12_GPU_VIRTUAL_ADDRESS m_GPUMemAddr = 0xffffffffffffffff;
 	D3D12_CPU_DESCRIPTOR_HANDLE m_CBVHandle = { 0xffffffffffffffff, };
@@ -36,3 +38,49 @@ private:
 	UINT64 m_BufferSize = 0;
 	UINT64 m_DataSize = 0;
 };
+
+// CPU side constants with one copy per in-flight frame in upload buffer pool.
+// Upload() copies pData into copy of current frame only when it is older than pData, so constants that
+// do not change cost nothing after every copy has caught up. call MarkDirty() after writing pData.
+// For constants that mostly stay same, pData is also read back on CPU. constants written anew every frame
+// take slice of FrameConstantAllocator instead and are written there directly.
+class FrameConstantBuffer
+{
+public:
+	FrameConstantBuffer() = default;
+	~FrameConstantBuffer() { Cleanup(); }
+
+	void Initialize(Renderer* pRenderer, UINT64 dataSize);
+
+	void Upload();
+
+	// CBV of this frame's copy. DEST is slot of per draw descriptor table.
+	void CreateCBV(ID3D12Device5* pDevice, const D3D12_CPU_DESCRIPTOR_HANDLE DEST);
+
+	void Cleanup();
+
+	inline void MarkDirty() { ++m_Version; }
+
+	inline D3D12_GPU_VIRTUAL_ADDRESS GetGPUMemAddr() { return m_GPUMemAddr; }
+	inline UINT64 GetBufferSize() { return m_BufferSize; }
+	inline UINT64 GetVersion() { return m_Version; }
+
+public:
+	void* pData = nullptr;
+
+private:
+	FrameConstantAllocator* m_pAllocator = nullptr;
+	GPUBufferAllocation m_Allocation; // m_BufferSize * frame count bytes, copy of frame i at i * m_BufferSize.
+	D3D12_GPU_VIRTUAL_ADDRESS m_GPUMemAddr = 0;
+	UINT64 m_UploadedFrameSerial = 0;
+
+	// pData starts dirty, copies start at 0.
+	UINT64 m_Version = 1;
+	UINT64 m_pCopyVersions[MAX_CONSTANT_FRAME_COUNT] = { 0, };
+#ifdef _DEBUG
+	UINT64 m_DebugDataHash = 0; // pData at last copy.
+#endif
+
+	UINT64 m_BufferSize = 0;
+	UINT64 m_DataSize = 0;
+};
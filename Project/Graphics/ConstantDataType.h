@@ -25,6 +25,10 @@ ALIGN(16) struct MeshConstant
 	float HeightScale = 0.0f;
 	float WindTrunk = 0.0f;
 	float WindLeaves = 0.0f;
+	Vector3 PositionOffset = Vector3(0.0f); // compact vertex dequantization.
+	float dummy = 0.0f;
+	Vector3 PositionScale = Vector3(1.0f);
+	float dummy2 = 0.0f;
 };
 ALIGN(16) struct MaterialConstant
 {
@@ -35,12 +39,10 @@ ALIGN(16) struct MaterialConstant
 
 	BOOL bUseAlbedoMap = FALSE;
 	BOOL bUseNormalMap = FALSE;
-	BOOL bUseAOMap = FALSE;
+	BOOL bUseORMHMap = FALSE; // channels without map hold neutral value.
 	BOOL bInvertNormalMapY = FALSE;
-	BOOL bUseMetallicMap = FALSE;
-	BOOL bUseRoughnessMap = FALSE;
 	BOOL bUseEmissiveMap = FALSE;
-	float dummy = 0.0f;
+	float dummy[3] = { 0.0f, };
 };
 ALIGN(16) struct LightProperty
 {
@@ -83,11 +85,22 @@ ALIGN(16) struct GlobalConstant
 
 	int TextureToDraw = 0;	 // 0: Env, 1: Specular, 2: Irradiance, ׿: .
 	float EnvLODBias = 0.0f; // ȯ LodBias.
-	float LODBias = 2.0f;    // ٸ ü LodBias.
+	float LODBias = 0.0f;    // ٸ ü LodBias.
 	float GlobalTime = 0.0f;
 
 	int dummy[4] = { 0, };
 };
+// root constants of mesh draws, slots of BindlessDescriptorPool. see BindlessIndices in Common.hlsli.
+struct BindlessIndexRecord
+{
+	UINT Albedo = 0;
+	UINT Emissive = 0;
+	UINT Normal = 0;
+	UINT ORMH = 0;
+	UINT BoneBuffer = 0; // skinned only.
+};
+static const UINT BINDLESS_INDEX_RECORD_SIZE = sizeof(BindlessIndexRecord) / sizeof(UINT);
+
 ALIGN(16) struct ImageFilterConstant
 {
 	float DX;
@@ -50,4 +50,45 @@ enum eRenderPSOType
 	RenderPSOType_Combine,
 	RenderPSOType_Wire,
 	RenderPSOType_PipelineStateCount,
+};
+// every mesh root signature starts with these, common tables follow.
+enum eMeshRootParameter
+{
+	MeshRootParameter_MeshConstant = 0, // b2. root CBV.
+	MeshRootParameter_MaterialConstant, // b3. root CBV.
+	MeshRootParameter_BindlessIndices,  // b5. root constants, BindlessIndexRecord.
+	MeshRootParameter_BindlessTextures, // t0, space1. whole bindless range.
+	MeshRootParameter_BindlessBuffers,  // t0, space2. same range.
+	MeshRootParameter_Count,
+};
+enum eTextureUsage
+{
+	TextureUsage_Color = 0, // srgb. albedo, emissive.
+	TextureUsage_Normal,
+	TextureUsage_ScalarR,   // ao, height.
+	TextureUsage_ScalarG,   // roughness.
+	TextureUsage_ScalarB,   // metallic.
+	TextureUsage_ORMH,      // packed scalar maps, see eORMHChannel.
+	TextureUsage_Count,
+};
+// channels of packed scalar material texture.
+enum eORMHChannel
+{
+	ORMHChannel_Occlusion = 0, // r. ambient occlusion.
+	ORMHChannel_Roughness,     // g.
+	ORMHChannel_Metallic,      // b.
+	ORMHChannel_Height,        // a.
+	ORMHChannel_Count,
+};
+enum eTextureCompressionPreset
+{
+	TextureCompressionPreset_Fast = 0, // color as BC1, BC3 with alpha. ORMH as quick BC7.
+	TextureCompressionPreset_Quality,  // color as BC7.
+};
+enum eStreamingPriority
+{
+	StreamingPriority_High = 0,
+	StreamingPriority_Normal,
+	StreamingPriority_Low,
+	StreamingPriority_Count,
 };
\ No newline at end of file
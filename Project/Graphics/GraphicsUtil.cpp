@@ -11,6 +11,7 @@
 #include "stb_image.h"
 #include "stb_image_write.h"
 
+#include "ImageProcessing.h"
 #include "GraphicsUtil.h"
 
 HRESULT CompileShader(const wchar_t* pszFileName, const char* pszShaderVersion, const D3D_SHADER_MACRO* pSHADER_MACROS, ID3DBlob** ppShader)
@@ -36,6 +37,12 @@ HRESULT CompileShader(const wchar_t* pszFileName, const char* pszShaderVersion,
 	return hr;
 }
 
+static HRESULT expandToRGBA(const unsigned char* pIMG, const int CHANNELS, const int PIXEL_COUNT, std::vector<UCHAR>& image)
+{
+	image.resize((UINT64)PIXEL_COUNT * 4);
+	return ExpandToRGBA(pIMG, CHANNELS, (UINT64)PIXEL_COUNT, image.data());
+}
+
 HRESULT ReadImage(const wchar_t* pszAlbedoFileName, const wchar_t* pszOpacityFileName, std::vector<UCHAR>& image, int* pWidth, int* pHeight)
 {
 	std::vector<UCHAR> opacityImage;
@@ -58,13 +65,7 @@ HRESULT ReadImage(const wchar_t* pszAlbedoFileName, const wchar_t* pszOpacityFil
 		_ASSERT(*pWidth == opaWidth && *pHeight == opaHeight);
 	}
 
-	for (int j = 0; j < *pHeight; ++j)
-	{
-		for (int i = 0; i < *pWidth; ++i)
-		{
-			image[3 + 4 * i + 4 * (*pWidth) * j] = opacityImage[4 * i + 4 * (*pWidth) * j]; // ä .
-		}
-	}
+	CopyRedToAlpha(opacityImage.data(), image.data(), (UINT64)(*pWidth) * (*pHeight));
 
 LB_RET:
 	return hr;
@@ -82,68 +83,31 @@ HRESULT ReadImage(const wchar_t* pszFileName, std::vector<UCHAR>& image, int* pW
 	}
 
 	unsigned char* pImg = stbi_load(pFileName, pWidth, pHeight, &channels, 0);
-
-	// 4äη  .
-	image.resize((*pWidth) * (*pHeight) * 4);
-	switch (channels)
+	if (!pImg)
 	{
-		case 1:
-		{
-			for (int i = 0, size = (*pWidth) * (*pHeight); i < size; ++i)
-			{
-				UCHAR g = pImg[i * channels];
-				for (int c = 0; c < 4; ++c)
-				{
-					image[4 * i + c] = g;
-				}
-			}
-		}
-		break;
+		return E_FAIL;
+	}
 
-		case 2:
-		{
-			for (int i = 0, size = (*pWidth) * (*pHeight); i < size; ++i)
-			{
-				for (int c = 0; c < 2; ++c)
-				{
-					image[4 * i + c] = pImg[i * channels + c];
-				}
-				image[4 * i + 2] = 255;
-				image[4 * i + 3] = 255;
-			}
-		}
-		break;
+	hr = expandToRGBA(pImg, channels, (*pWidth) * (*pHeight), image);
+	free(pImg);
 
-		case 3:
-		{
-			for (int i = 0, size = (*pWidth) * (*pHeight); i < size; ++i)
-			{
-				for (int c = 0; c < 3; ++c)
-				{
-					image[4 * i + c] = pImg[i * channels + c];
-				}
-				image[4 * i + 3] = 255;
-			}
-		}
-		break;
+	return hr;
+}
 
-		case 4:
-		{
-			for (int i = 0, size = (*pWidth) * (*pHeight); i < size; ++i)
-			{
-				for (int c = 0; c < 4; ++c)
-				{
-					image[4 * i + c] = pImg[i * channels + c];
-				}
-			}
-		}
-		break;
+HRESULT ReadImageFromMemory(const UCHAR* pDATA, const UINT64 DATA_SIZE, std::vector<UCHAR>& image, int* pWidth, int* pHeight)
+{
+	_ASSERT(pDATA);
 
-		default:
-			hr = E_FAIL;
-			break;
+	HRESULT hr = S_OK;
+	int channels = 0;
+
+	unsigned char* pImg = stbi_load_from_memory(pDATA, (int)DATA_SIZE, pWidth, pHeight, &channels, 0);
+	if (!pImg)
+	{
+		return E_FAIL;
 	}
 
+	hr = expandToRGBA(pImg, channels, (*pWidth) * (*pHeight), image);
 	free(pImg);
 
 	return hr;
@@ -244,4 +208,27 @@ UINT64 GetPixelSize(const DXGI_FORMAT PIXEL_FORMAT)
 	OutputDebugStringA("\n");
 
 	return sizeof(UCHAR) * 4;
+}
+
+void CreateTextureSRV(ID3D12Device* pDevice, ID3D12Resource* pResource, const D3D12_SHADER_RESOURCE_VIEW_DESC& NULL_VIEW_DESC, const D3D12_CPU_DESCRIPTOR_HANDLE HANDLE)
+{
+	_ASSERT(pDevice);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = NULL_VIEW_DESC;
+	if (pResource)
+	{
+		D3D12_RESOURCE_DESC resourceDesc = pResource->GetDesc();
+		srvDesc.Format = resourceDesc.Format;
+		srvDesc.Texture2D.MipLevels = (UINT)-1;
+
+		// scalar maps are sampled from any of rgb.
+		if (resourceDesc.Format == DXGI_FORMAT_BC4_UNORM)
+		{
+			srvDesc.Shader4ComponentMapping = D3D12_ENCODE_SHADER_4_COMPONENT_MAPPING(D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+																					  D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+																					  D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+																					  D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_1);
+		}
+	}
+	pDevice->CreateShaderResourceView(pResource, &srvDesc, HANDLE);
 }
\ No newline at end of file
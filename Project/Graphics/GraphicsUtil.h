@@ -4,7 +4,11 @@ HRESULT CompileShader(const wchar_t* pszFileName, const char* pszShaderVersion,
 
 HRESULT ReadImage(const wchar_t* pszAlbedoFileName, const wchar_t* pszOpacityFileName, std::vector<UCHAR>& image, int* pWidth, int* pHeight);
 HRESULT ReadImage(const wchar_t* pszFileName, std::vector<UCHAR>& image, int* pWidth, int* pHeight);
+HRESULT ReadImageFromMemory(const UCHAR* pDATA, const UINT64 DATA_SIZE, std::vector<UCHAR>& image, int* pWidth, int* pHeight);
 HRESULT ReadEXRImage(const wchar_t* pszFileName, std::vector<UCHAR>& image, int* pWidth, int* pHeight, DXGI_FORMAT* pPixelFormat);
 HRESULT ReadDDSImage(ID3D12Device* pDevice, ID3D12CommandQueue* pCommandQueue, const wchar_t* pszFileName, ID3D12Resource** ppResource);
 
-UINT64 GetPixelSize(const DXGI_FORMAT PIXEL_FORMAT);
\ No newline at end of file
+UINT64 GetPixelSize(const DXGI_FORMAT PIXEL_FORMAT);
+
+// 2D view of whole mip chain in resource format. NULL_VIEW_DESC is used as is when pResource is nullptr.
+void CreateTextureSRV(ID3D12Device* pDevice, ID3D12Resource* pResource, const D3D12_SHADER_RESOURCE_VIEW_DESC& NULL_VIEW_DESC, const D3D12_CPU_DESCRIPTOR_HANDLE HANDLE);
\ No newline at end of file
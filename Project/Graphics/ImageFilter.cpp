@@ -31,12 +31,9 @@ void ImageFilter::BeforeRender(Renderer* pRenderer, eRenderPSOType psoSetting, U
 
 	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
 	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
 	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
 
 	switch (psoSetting)
@@ -45,18 +42,12 @@ void ImageFilter::BeforeRender(Renderer* pRenderer, eRenderPSOType psoSetting, U
 		case RenderPSOType_BloomDown:
 		case RenderPSOType_BloomUp:
 		{
-			hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 2);
+			// t0, b4
+			const D3D12_CPU_DESCRIPTOR_HANDLE SRC_HANDLES[2] = { m_SRVHandles[0].CPUHandle, m_ConstantBuffer.GetCBVHandle() };
+			hr = pDynamicDescriptorPool->AllocCachedDescriptorTable(&gpuDescriptorTable, SRC_HANDLES, 2);
 			BREAK_IF_FAILED(hr);
 
 			const CD3DX12_RESOURCE_BARRIER BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(m_RTVHandles[0].pResource, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t0
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[0].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// b4
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_ConstantBuffer.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
 			pCommandList->ResourceBarrier(1, &BARRIER);
 			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
@@ -66,26 +57,11 @@ void ImageFilter::BeforeRender(Renderer* pRenderer, eRenderPSOType psoSetting, U
 
 		case RenderPSOType_Combine:
 		{
-			hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 4);
+			// t0, t1, t2, b4
+			const D3D12_CPU_DESCRIPTOR_HANDLE SRC_HANDLES[4] = { m_SRVHandles[0].CPUHandle, m_SRVHandles[1].CPUHandle, m_SRVHandles[2].CPUHandle, m_ConstantBuffer.GetCBVHandle() };
+			hr = pDynamicDescriptorPool->AllocCachedDescriptorTable(&gpuDescriptorTable, SRC_HANDLES, 4);
 			BREAK_IF_FAILED(hr);
 
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t0
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[0].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t1
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[1].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t2
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[2].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// b4
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_ConstantBuffer.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
 			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
 			pCommandList->OMSetRenderTargets(1, &m_RTVHandles[frameIndex].CPUHandle, FALSE, nullptr);
 		}
@@ -107,10 +83,6 @@ void ImageFilter::BeforeRender(UINT threadIndex, ID3D12GraphicsCommandList* pCom
 
 	HRESULT hr = S_OK;
 
-	ID3D12Device5* pDevice = pManager->m_pDevice;
-	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
 	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
 
 	switch (psoSetting)
@@ -119,18 +91,12 @@ void ImageFilter::BeforeRender(UINT threadIndex, ID3D12GraphicsCommandList* pCom
 		case RenderPSOType_BloomDown:
 		case RenderPSOType_BloomUp:
 		{
-			hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 2);
+			// t0, b4
+			const D3D12_CPU_DESCRIPTOR_HANDLE SRC_HANDLES[2] = { m_SRVHandles[0].CPUHandle, m_ConstantBuffer.GetCBVHandle() };
+			hr = pDescriptorPool->AllocCachedDescriptorTable(&gpuDescriptorTable, SRC_HANDLES, 2);
 			BREAK_IF_FAILED(hr);
 
 			const CD3DX12_RESOURCE_BARRIER BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(m_RTVHandles[0].pResource, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t0
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[0].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// b4
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_ConstantBuffer.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
 			pCommandList->ResourceBarrier(1, &BARRIER);
 			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
@@ -140,26 +106,11 @@ void ImageFilter::BeforeRender(UINT threadIndex, ID3D12GraphicsCommandList* pCom
 
 		case RenderPSOType_Combine:
 		{
-			hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 4);
+			// t0, t1, t2, b4
+			const D3D12_CPU_DESCRIPTOR_HANDLE SRC_HANDLES[4] = { m_SRVHandles[0].CPUHandle, m_SRVHandles[1].CPUHandle, m_SRVHandles[2].CPUHandle, m_ConstantBuffer.GetCBVHandle() };
+			hr = pDescriptorPool->AllocCachedDescriptorTable(&gpuDescriptorTable, SRC_HANDLES, 4);
 			BREAK_IF_FAILED(hr);
 
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t0
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[0].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t1
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[1].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// t2
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_SRVHandles[2].CPUHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-			// b4
-			pDevice->CopyDescriptorsSimple(1, dstHandle, m_ConstantBuffer.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
 			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
 			pCommandList->OMSetRenderTargets(1, &m_RTVHandles[*(pManager->m_pFrameIndex)].CPUHandle, FALSE, nullptr);
 		}
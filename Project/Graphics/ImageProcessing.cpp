@@ -0,0 +1,647 @@
+#include "../pch.h"
+#include <intrin.h>
+#include <tmmintrin.h>
+#include "GraphicsUtil.h"
+#include "../Util/Utility.h"
+#include "ImageProcessing.h"
+
+// gcc and clang only emit SSSE3 instructions in functions marked for it. msvc does not need it.
+#ifdef __GNUC__
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define TARGET_SSSE3
+#endif
+
+struct MipLevelJob
+{
+	const UCHAR* pSrc;
+	UCHAR* pDst;
+	UINT SrcWidth;
+	UINT SrcHeight;
+	UINT DstWidth;
+	DXGI_FORMAT Format;
+};
+
+// linear value is 16bit fixed point. 64k encode table keeps dark values exact to 1 step.
+struct SRGBTable
+{
+	USHORT ToLinear[256];
+	UCHAR ToSRGB[65536];
+
+	SRGBTable()
+	{
+		for (int i = 0; i < 256; ++i)
+		{
+			double c = i / 255.0;
+			double linear = (c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4));
+			ToLinear[i] = (USHORT)(linear * 65535.0 + 0.5);
+		}
+		for (int i = 0; i < 65536; ++i)
+		{
+			double linear = i / 65535.0;
+			double c = (linear <= 0.0031308 ? linear * 12.92 : 1.055 * pow(linear, 1.0 / 2.4) - 0.055);
+			ToSRGB[i] = (UCHAR)(c * 255.0 + 0.5);
+		}
+	}
+};
+
+static const SRGBTable* getSRGBTable()
+{
+	// built once, thread safe.
+	static const SRGBTable s_TABLE;
+	return &s_TABLE;
+}
+
+static float halfToFloat(const USHORT HALF)
+{
+	const UINT SIGN = (UINT)(HALF & 0x8000) << 16;
+	const UINT EXPONENT = (HALF >> 10) & 0x1f;
+	const UINT MANTISSA = HALF & 0x3ff;
+
+	UINT bits = 0;
+	if (EXPONENT == 0)
+	{
+		// zero, denormal.
+		float value = (float)MANTISSA * (1.0f / 16777216.0f);
+		return (SIGN ? -value : value);
+	}
+	else if (EXPONENT == 0x1f)
+	{
+		bits = SIGN | 0x7f800000 | (MANTISSA << 13);
+	}
+	else
+	{
+		bits = SIGN | ((EXPONENT + 112) << 23) | (MANTISSA << 13);
+	}
+
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+// round to nearest even.
+static USHORT floatToHalf(const float VALUE)
+{
+	UINT bits;
+	memcpy(&bits, &VALUE, sizeof(UINT));
+
+	const UINT SIGN = (bits >> 16) & 0x8000;
+	bits &= 0x7fffffff;
+
+	if (bits >= 0x47800000)
+	{
+		// overflow, inf, nan.
+		return (USHORT)(SIGN | (bits > 0x7f800000 ? 0x7e00 : 0x7c00));
+	}
+	if (bits < 0x38800000)
+	{
+		// denormal. adding 0.5 lets fpu round mantissa into place.
+		float value;
+		memcpy(&value, &bits, sizeof(float));
+		value += 0.5f;
+		memcpy(&bits, &value, sizeof(UINT));
+		return (USHORT)(SIGN | (bits - 0x3f000000));
+	}
+
+	const UINT MANTISSA_ODD = (bits >> 13) & 1;
+	bits += 0xc8000fff; // rebias exponent(15 - 127) and round.
+	bits += MANTISSA_ODD;
+	return (USHORT)(SIGN | (bits >> 13));
+}
+
+// 4 pixels of 2 rows -> 2 pixels. 16bit lanes.
+static inline __m128i average2x2RGBA8(const __m128i ROW0, const __m128i ROW1)
+{
+	const __m128i ZERO = _mm_setzero_si128();
+	__m128i sumLo = _mm_add_epi16(_mm_unpacklo_epi8(ROW0, ZERO), _mm_unpacklo_epi8(ROW1, ZERO));
+	__m128i sumHi = _mm_add_epi16(_mm_unpackhi_epi8(ROW0, ZERO), _mm_unpackhi_epi8(ROW1, ZERO));
+	__m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sumLo, sumHi), _mm_unpackhi_epi64(sumLo, sumHi));
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+static void downsampleRowsRGBA8(const MipLevelJob* pJOB, const UINT BEGIN, const UINT END)
+{
+	for (UINT y = BEGIN; y < END; ++y)
+	{
+		const UCHAR* pRow0 = pJOB->pSrc + (UINT64)(y * 2) * pJOB->SrcWidth * 4;
+		const UCHAR* pRow1 = pJOB->pSrc + (UINT64)Min((int)(y * 2 + 1), (int)pJOB->SrcHeight - 1) * pJOB->SrcWidth * 4;
+		UCHAR* pDstRow = pJOB->pDst + (UINT64)y * pJOB->DstWidth * 4;
+
+		UINT x = 0;
+		if (pJOB->SrcWidth > 1)
+		{
+			for (; x + 4 <= pJOB->DstWidth; x += 4)
+			{
+				__m128i lo = average2x2RGBA8(_mm_loadu_si128((const __m128i*)(pRow0 + x * 8)), _mm_loadu_si128((const __m128i*)(pRow1 + x * 8)));
+				__m128i hi = average2x2RGBA8(_mm_loadu_si128((const __m128i*)(pRow0 + x * 8 + 16)), _mm_loadu_si128((const __m128i*)(pRow1 + x * 8 + 16)));
+				_mm_storeu_si128((__m128i*)(pDstRow + x * 4), _mm_packus_epi16(lo, hi));
+			}
+		}
+		for (; x < pJOB->DstWidth; ++x)
+		{
+			const UINT X0 = x * 2 * 4;
+			const UINT X1 = (UINT)Min((int)(x * 2 + 1), (int)pJOB->SrcWidth - 1) * 4;
+			for (UINT c = 0; c < 4; ++c)
+			{
+				pDstRow[x * 4 + c] = (UCHAR)((pRow0[X0 + c] + pRow0[X1 + c] + pRow1[X0 + c] + pRow1[X1 + c] + 2) >> 2);
+			}
+		}
+	}
+}
+
+// rgb averaged in linear space, alpha as is. bound by table lookups, so scalar.
+static void downsampleRowsSRGB(const MipLevelJob* pJOB, const UINT BEGIN, const UINT END)
+{
+	const SRGBTable* pTABLE = getSRGBTable();
+
+	for (UINT y = BEGIN; y < END; ++y)
+	{
+		const UCHAR* pRow0 = pJOB->pSrc + (UINT64)(y * 2) * pJOB->SrcWidth * 4;
+		const UCHAR* pRow1 = pJOB->pSrc + (UINT64)Min((int)(y * 2 + 1), (int)pJOB->SrcHeight - 1) * pJOB->SrcWidth * 4;
+		UCHAR* pDstRow = pJOB->pDst + (UINT64)y * pJOB->DstWidth * 4;
+
+		for (UINT x = 0; x < pJOB->DstWidth; ++x)
+		{
+			const UINT X0 = x * 2 * 4;
+			const UINT X1 = (UINT)Min((int)(x * 2 + 1), (int)pJOB->SrcWidth - 1) * 4;
+			for (UINT c = 0; c < 3; ++c)
+			{
+				UINT sum = pTABLE->ToLinear[pRow0[X0 + c]] + pTABLE->ToLinear[pRow0[X1 + c]] + pTABLE->ToLinear[pRow1[X0 + c]] + pTABLE->ToLinear[pRow1[X1 + c]];
+				pDstRow[x * 4 + c] = pTABLE->ToSRGB[(sum + 2) >> 2];
+			}
+			pDstRow[x * 4 + 3] = (UCHAR)((pRow0[X0 + 3] + pRow0[X1 + 3] + pRow1[X0 + 3] + pRow1[X1 + 3] + 2) >> 2);
+		}
+	}
+}
+
+// one pixel per vector.
+static void downsampleRowFloat(const float* pROW0, const float* pROW1, const UINT SRC_WIDTH, const UINT DST_WIDTH, float* pDstRow)
+{
+	const __m128 QUARTER = _mm_set1_ps(0.25f);
+
+	for (UINT x = 0; x < DST_WIDTH; ++x)
+	{
+		const UINT X0 = x * 2 * 4;
+		const UINT X1 = (UINT)Min((int)(x * 2 + 1), (int)SRC_WIDTH - 1) * 4;
+		__m128 sum0 = _mm_add_ps(_mm_loadu_ps(pROW0 + X0), _mm_loadu_ps(pROW0 + X1));
+		__m128 sum1 = _mm_add_ps(_mm_loadu_ps(pROW1 + X0), _mm_loadu_ps(pROW1 + X1));
+		_mm_storeu_ps(pDstRow + x * 4, _mm_mul_ps(_mm_add_ps(sum0, sum1), QUARTER));
+	}
+}
+
+static void downsampleRowsFloat(const MipLevelJob* pJOB, const UINT BEGIN, const UINT END)
+{
+	const float* pSRC = (const float*)pJOB->pSrc;
+	float* pDst = (float*)pJOB->pDst;
+
+	for (UINT y = BEGIN; y < END; ++y)
+	{
+		const float* pROW0 = pSRC + (UINT64)(y * 2) * pJOB->SrcWidth * 4;
+		const float* pROW1 = pSRC + (UINT64)Min((int)(y * 2 + 1), (int)pJOB->SrcHeight - 1) * pJOB->SrcWidth * 4;
+		downsampleRowFloat(pROW0, pROW1, pJOB->SrcWidth, pJOB->DstWidth, pDst + (UINT64)y * pJOB->DstWidth * 4);
+	}
+}
+
+struct HalfTable
+{
+	float ToFloat[65536];
+
+	HalfTable()
+	{
+		for (UINT i = 0; i < 65536; ++i)
+		{
+			ToFloat[i] = halfToFloat((USHORT)i);
+		}
+	}
+};
+
+static const HalfTable* getHalfTable()
+{
+	static const HalfTable s_TABLE;
+	return &s_TABLE;
+}
+
+// rows are widened to float, filtered and narrowed back.
+static void downsampleRowsHalf(const MipLevelJob* pJOB, const UINT BEGIN, const UINT END)
+{
+	const HalfTable* pTABLE = getHalfTable();
+	const USHORT* pSRC = (const USHORT*)pJOB->pSrc;
+	USHORT* pDst = (USHORT*)pJOB->pDst;
+	const UINT64 SRC_ROW_SIZE = (UINT64)pJOB->SrcWidth * 4;
+	const UINT64 DST_ROW_SIZE = (UINT64)pJOB->DstWidth * 4;
+
+	std::vector<float> rows(SRC_ROW_SIZE * 2 + DST_ROW_SIZE);
+	float* pRow0 = rows.data();
+	float* pRow1 = pRow0 + SRC_ROW_SIZE;
+	float* pDstRow = pRow1 + SRC_ROW_SIZE;
+
+	for (UINT y = BEGIN; y < END; ++y)
+	{
+		const USHORT* pHALF_ROW0 = pSRC + (UINT64)(y * 2) * SRC_ROW_SIZE;
+		const USHORT* pHALF_ROW1 = pSRC + (UINT64)Min((int)(y * 2 + 1), (int)pJOB->SrcHeight - 1) * SRC_ROW_SIZE;
+		for (UINT64 i = 0; i < SRC_ROW_SIZE; ++i)
+		{
+			pRow0[i] = pTABLE->ToFloat[pHALF_ROW0[i]];
+			pRow1[i] = pTABLE->ToFloat[pHALF_ROW1[i]];
+		}
+
+		downsampleRowFloat(pRow0, pRow1, pJOB->SrcWidth, pJOB->DstWidth, pDstRow);
+
+		USHORT* pHalfDstRow = pDst + (UINT64)y * DST_ROW_SIZE;
+		for (UINT64 i = 0; i < DST_ROW_SIZE; ++i)
+		{
+			pHalfDstRow[i] = floatToHalf(pDstRow[i]);
+		}
+	}
+}
+
+static void downsampleRange(UINT begin, UINT end, UINT rangeIndex, void* pArg)
+{
+	const MipLevelJob* pJOB = (const MipLevelJob*)pArg;
+
+	switch (pJOB->Format)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+			downsampleRowsRGBA8(pJOB, begin, end);
+			break;
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			downsampleRowsSRGB(pJOB, begin, end);
+			break;
+
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			downsampleRowsHalf(pJOB, begin, end);
+			break;
+
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			downsampleRowsFloat(pJOB, begin, end);
+			break;
+
+		default:
+			__debugbreak();
+			break;
+	}
+}
+
+// x64 guarantees SSE2 only. SSSE3 came with Core 2, but is checked once anyway.
+static bool checkSSSE3()
+{
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 1)
+	{
+		return false;
+	}
+	__cpuid(cpuInfo, 1);
+	return ((cpuInfo[2] & (1 << 9)) != 0);
+}
+
+static bool isSSSE3Supported()
+{
+	static const bool s_bSUPPORTED = checkSSSE3();
+	return s_bSUPPORTED;
+}
+
+// 16 gray pixels -> 64 bytes. SSE2 unpacks, so no shuffle needed.
+static void expandGray(const UCHAR* pSRC, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	UINT64 i = 0;
+	for (; i + 16 <= PIXEL_COUNT; i += 16)
+	{
+		__m128i src = _mm_loadu_si128((const __m128i*)(pSRC + i));
+		__m128i gg0 = _mm_unpacklo_epi8(src, src);
+		__m128i gg1 = _mm_unpackhi_epi8(src, src);
+		__m128i* pDstVector = (__m128i*)(pDst + i * 4);
+		_mm_storeu_si128(pDstVector, _mm_unpacklo_epi16(gg0, gg0));
+		_mm_storeu_si128(pDstVector + 1, _mm_unpackhi_epi16(gg0, gg0));
+		_mm_storeu_si128(pDstVector + 2, _mm_unpacklo_epi16(gg1, gg1));
+		_mm_storeu_si128(pDstVector + 3, _mm_unpackhi_epi16(gg1, gg1));
+	}
+	for (; i < PIXEL_COUNT; ++i)
+	{
+		UCHAR g = pSRC[i];
+		pDst[i * 4] = g;
+		pDst[i * 4 + 1] = g;
+		pDst[i * 4 + 2] = g;
+		pDst[i * 4 + 3] = g;
+	}
+}
+
+// 8 rg pixels -> 32 bytes. rg pairs are 16bit lanes interleaved with 0xffff.
+static void expandRG(const UCHAR* pSRC, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	const __m128i BA_ONE = _mm_set1_epi16(-1);
+
+	UINT64 i = 0;
+	for (; i + 8 <= PIXEL_COUNT; i += 8)
+	{
+		__m128i src = _mm_loadu_si128((const __m128i*)(pSRC + i * 2));
+		__m128i* pDstVector = (__m128i*)(pDst + i * 4);
+		_mm_storeu_si128(pDstVector, _mm_unpacklo_epi16(src, BA_ONE));
+		_mm_storeu_si128(pDstVector + 1, _mm_unpackhi_epi16(src, BA_ONE));
+	}
+	for (; i < PIXEL_COUNT; ++i)
+	{
+		pDst[i * 4] = pSRC[i * 2];
+		pDst[i * 4 + 1] = pSRC[i * 2 + 1];
+		pDst[i * 4 + 2] = 255;
+		pDst[i * 4 + 3] = 255;
+	}
+}
+
+static void expandRGBScalar(const UCHAR* pSRC, const UINT64 BEGIN, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	for (UINT64 i = BEGIN; i < PIXEL_COUNT; ++i)
+	{
+		pDst[i * 4] = pSRC[i * 3];
+		pDst[i * 4 + 1] = pSRC[i * 3 + 1];
+		pDst[i * 4 + 2] = pSRC[i * 3 + 2];
+		pDst[i * 4 + 3] = 255;
+	}
+}
+
+// 4 rgb pixels(12 bytes) -> 16 bytes. 16 byte load reads 4 bytes ahead, so vector loop stops early.
+static TARGET_SSSE3 void expandRGBSSSE3(const UCHAR* pSRC, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	const __m128i SHUFFLE = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i A_ONE = _mm_set1_epi32((int)0xff000000);
+
+	UINT64 i = 0;
+	for (; i + 6 <= PIXEL_COUNT; i += 4)
+	{
+		__m128i src = _mm_loadu_si128((const __m128i*)(pSRC + i * 3));
+		_mm_storeu_si128((__m128i*)(pDst + i * 4), _mm_or_si128(_mm_shuffle_epi8(src, SHUFFLE), A_ONE));
+	}
+	expandRGBScalar(pSRC, i, PIXEL_COUNT, pDst);
+}
+
+static void expandRGB(const UCHAR* pSRC, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	if (isSSSE3Supported())
+	{
+		expandRGBSSSE3(pSRC, PIXEL_COUNT, pDst);
+	}
+	else
+	{
+		expandRGBScalar(pSRC, 0, PIXEL_COUNT, pDst);
+	}
+}
+
+HRESULT ExpandToRGBA(const UCHAR* pSRC, const int CHANNELS, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	_ASSERT(pSRC);
+	_ASSERT(pDst);
+
+	switch (CHANNELS)
+	{
+		case 1:
+			expandGray(pSRC, PIXEL_COUNT, pDst);
+			break;
+
+		case 2:
+			expandRG(pSRC, PIXEL_COUNT, pDst);
+			break;
+
+		case 3:
+			expandRGB(pSRC, PIXEL_COUNT, pDst);
+			break;
+
+		case 4:
+			memcpy(pDst, pSRC, PIXEL_COUNT * 4);
+			break;
+
+		default:
+			return E_FAIL;
+	}
+
+	return S_OK;
+}
+
+void CopyRedToAlpha(const UCHAR* pSRC, UCHAR* pDst, const UINT64 PIXEL_COUNT)
+{
+	_ASSERT(pSRC);
+	_ASSERT(pDst);
+
+	const __m128i RGB_MASK = _mm_set1_epi32(0x00ffffff);
+
+	UINT64 i = 0;
+	for (; i + 4 <= PIXEL_COUNT; i += 4)
+	{
+		__m128i src = _mm_loadu_si128((const __m128i*)(pSRC + i * 4));
+		__m128i dst = _mm_loadu_si128((const __m128i*)(pDst + i * 4));
+		dst = _mm_or_si128(_mm_and_si128(dst, RGB_MASK), _mm_slli_epi32(src, 24));
+		_mm_storeu_si128((__m128i*)(pDst + i * 4), dst);
+	}
+	for (; i < PIXEL_COUNT; ++i)
+	{
+		pDst[i * 4 + 3] = pSRC[i * 4];
+	}
+}
+
+void PackChannel(const UCHAR* pSRC, const UINT SRC_WIDTH, const UINT SRC_HEIGHT, const UINT SRC_CHANNEL,
+				 UCHAR* pDst, const UINT DST_WIDTH, const UINT DST_HEIGHT, const UINT DST_CHANNEL)
+{
+	_ASSERT(pSRC);
+	_ASSERT(pDst);
+	_ASSERT(SRC_CHANNEL < 4 && DST_CHANNEL < 4);
+
+	if (SRC_WIDTH == DST_WIDTH && SRC_HEIGHT == DST_HEIGHT)
+	{
+		const UINT64 PIXEL_COUNT = (UINT64)DST_WIDTH * DST_HEIGHT;
+		const __m128i DST_MASK = _mm_set1_epi32((int)(0xffu << (DST_CHANNEL * 8)));
+		const __m128i LEFT_SHIFT = _mm_cvtsi32_si128(DST_CHANNEL > SRC_CHANNEL ? (DST_CHANNEL - SRC_CHANNEL) * 8 : 0);
+		const __m128i RIGHT_SHIFT = _mm_cvtsi32_si128(SRC_CHANNEL > DST_CHANNEL ? (SRC_CHANNEL - DST_CHANNEL) * 8 : 0);
+
+		UINT64 i = 0;
+		for (; i + 4 <= PIXEL_COUNT; i += 4)
+		{
+			__m128i src = _mm_loadu_si128((const __m128i*)(pSRC + i * 4));
+			__m128i dst = _mm_loadu_si128((const __m128i*)(pDst + i * 4));
+			src = _mm_sll_epi32(_mm_srl_epi32(src, RIGHT_SHIFT), LEFT_SHIFT);
+			dst = _mm_or_si128(_mm_andnot_si128(DST_MASK, dst), _mm_and_si128(src, DST_MASK));
+			_mm_storeu_si128((__m128i*)(pDst + i * 4), dst);
+		}
+		for (; i < PIXEL_COUNT; ++i)
+		{
+			pDst[i * 4 + DST_CHANNEL] = pSRC[i * 4 + SRC_CHANNEL];
+		}
+		return;
+	}
+
+	// texel centers are aligned. weights are 8bit fixed point.
+	const float SCALE_X = (float)SRC_WIDTH / (float)DST_WIDTH;
+	const float SCALE_Y = (float)SRC_HEIGHT / (float)DST_HEIGHT;
+	std::vector<UINT> x0s(DST_WIDTH);
+	std::vector<UINT> x1s(DST_WIDTH);
+	std::vector<UINT> xWeights(DST_WIDTH);
+	for (UINT x = 0; x < DST_WIDTH; ++x)
+	{
+		const float SRC_X = Max(((float)x + 0.5f) * SCALE_X - 0.5f, 0.0f);
+		x0s[x] = Min((int)SRC_X, (int)SRC_WIDTH - 1);
+		x1s[x] = Min((int)x0s[x] + 1, (int)SRC_WIDTH - 1);
+		xWeights[x] = (UINT)((SRC_X - (float)x0s[x]) * 256.0f + 0.5f);
+	}
+
+	for (UINT y = 0; y < DST_HEIGHT; ++y)
+	{
+		const float SRC_Y = Max(((float)y + 0.5f) * SCALE_Y - 0.5f, 0.0f);
+		const UINT Y0 = Min((int)SRC_Y, (int)SRC_HEIGHT - 1);
+		const UINT Y1 = Min((int)Y0 + 1, (int)SRC_HEIGHT - 1);
+		const UINT Y_WEIGHT = (UINT)((SRC_Y - (float)Y0) * 256.0f + 0.5f);
+		const UCHAR* pROW0 = pSRC + (UINT64)Y0 * SRC_WIDTH * 4 + SRC_CHANNEL;
+		const UCHAR* pROW1 = pSRC + (UINT64)Y1 * SRC_WIDTH * 4 + SRC_CHANNEL;
+		UCHAR* pDstRow = pDst + (UINT64)y * DST_WIDTH * 4 + DST_CHANNEL;
+
+		for (UINT x = 0; x < DST_WIDTH; ++x)
+		{
+			const UINT X0 = x0s[x] * 4;
+			const UINT X1 = x1s[x] * 4;
+			const UINT X_WEIGHT = xWeights[x];
+			const UINT TOP = pROW0[X0] * (256 - X_WEIGHT) + pROW0[X1] * X_WEIGHT;
+			const UINT BOTTOM = pROW1[X0] * (256 - X_WEIGHT) + pROW1[X1] * X_WEIGHT;
+			pDstRow[x * 4] = (UCHAR)((TOP * (256 - Y_WEIGHT) + BOTTOM * Y_WEIGHT + 32768) >> 16);
+		}
+	}
+}
+
+void FillChannel(UCHAR* pDst, const UINT64 PIXEL_COUNT, const UINT CHANNEL, const UCHAR VALUE)
+{
+	_ASSERT(pDst);
+	_ASSERT(CHANNEL < 4);
+
+	const __m128i DST_MASK = _mm_set1_epi32((int)(0xffu << (CHANNEL * 8)));
+	const __m128i VALUES = _mm_set1_epi32((int)((UINT)VALUE << (CHANNEL * 8)));
+
+	UINT64 i = 0;
+	for (; i + 4 <= PIXEL_COUNT; i += 4)
+	{
+		__m128i dst = _mm_loadu_si128((const __m128i*)(pDst + i * 4));
+		dst = _mm_or_si128(_mm_andnot_si128(DST_MASK, dst), VALUES);
+		_mm_storeu_si128((__m128i*)(pDst + i * 4), dst);
+	}
+	for (; i < PIXEL_COUNT; ++i)
+	{
+		pDst[i * 4 + CHANNEL] = VALUE;
+	}
+}
+
+UINT GetMipLevelCount(const UINT WIDTH, const UINT HEIGHT)
+{
+	UINT width = WIDTH;
+	UINT height = HEIGHT;
+	UINT levels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = (width > 1 ? width / 2 : 1);
+		height = (height > 1 ? height / 2 : 1);
+		++levels;
+	}
+	return levels;
+}
+
+UINT64 GetMipChainSize(const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT)
+{
+	const UINT BLOCK_SIZE = GetBlockSize(FORMAT);
+	const UINT64 PIXEL_SIZE = (BLOCK_SIZE > 0 ? 0 : GetPixelSize(FORMAT));
+
+	UINT width = WIDTH;
+	UINT height = HEIGHT;
+	UINT64 size = 0;
+	for (UINT i = 0; i < MIP_LEVELS; ++i)
+	{
+		if (BLOCK_SIZE > 0)
+		{
+			size += (UINT64)((width + 3) / 4) * ((height + 3) / 4) * BLOCK_SIZE;
+		}
+		else
+		{
+			size += (UINT64)width * height * PIXEL_SIZE;
+		}
+		width = (width > 1 ? width / 2 : 1);
+		height = (height > 1 ? height / 2 : 1);
+	}
+	return size;
+}
+
+UINT GetBlockSize(const DXGI_FORMAT FORMAT)
+{
+	switch (FORMAT)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+			return 8;
+
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16;
+
+		default:
+			break;
+	}
+	return 0;
+}
+
+HRESULT GenerateMips(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, UINT* pMipLevels, bool bUseMultiThread)
+{
+	_ASSERT(pMipLevels);
+
+	*pMipLevels = 1;
+
+	switch (FORMAT)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			break;
+
+		default:
+			return E_INVALIDARG;
+	}
+
+	// each range gets about this many destination pixels.
+	const UINT MIN_PIXELS_PER_RANGE = 64 * 1024;
+	const UINT64 PIXEL_SIZE = GetPixelSize(FORMAT);
+	const UINT MIP_LEVELS = GetMipLevelCount(WIDTH, HEIGHT);
+	_ASSERT(image.size() >= (UINT64)WIDTH * HEIGHT * PIXEL_SIZE);
+
+	image.resize(GetMipChainSize(WIDTH, HEIGHT, MIP_LEVELS, FORMAT));
+
+	MipLevelJob job;
+	job.Format = FORMAT;
+	job.SrcWidth = WIDTH;
+	job.SrcHeight = HEIGHT;
+
+	UINT64 srcOffset = 0;
+	for (UINT i = 1; i < MIP_LEVELS; ++i)
+	{
+		const UINT DST_WIDTH = (job.SrcWidth > 1 ? job.SrcWidth / 2 : 1);
+		const UINT DST_HEIGHT = (job.SrcHeight > 1 ? job.SrcHeight / 2 : 1);
+		const UINT64 SRC_SIZE = (UINT64)job.SrcWidth * job.SrcHeight * PIXEL_SIZE;
+
+		job.pSrc = image.data() + srcOffset;
+		job.pDst = image.data() + srcOffset + SRC_SIZE;
+		job.DstWidth = DST_WIDTH;
+
+		// levels depend on previous one. rows of a level are split.
+		if (bUseMultiThread)
+		{
+			ParallelFor(DST_HEIGHT, (UINT)Max((int)(MIN_PIXELS_PER_RANGE / DST_WIDTH), 1), downsampleRange, &job);
+		}
+		else
+		{
+			downsampleRange(0, DST_HEIGHT, 0, &job);
+		}
+
+		srcOffset += SRC_SIZE;
+		job.SrcWidth = DST_WIDTH;
+		job.SrcHeight = DST_HEIGHT;
+	}
+
+	*pMipLevels = MIP_LEVELS;
+	return S_OK;
+}
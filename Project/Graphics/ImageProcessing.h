@@ -0,0 +1,29 @@
+#pragma once
+
+// CPU side pixel conversion for texture loading. SSE2 with scalar tail, rgb expansion uses SSSE3 when cpu has it.
+
+// 1 channel -> gggg, 2 channels -> rg11, 3 channels -> rgb1, 4 channels -> copy.
+// pDst must hold PIXEL_COUNT * 4 bytes.
+HRESULT ExpandToRGBA(const UCHAR* pSRC, const int CHANNELS, const UINT64 PIXEL_COUNT, UCHAR* pDst);
+
+// pDst.a = pSRC.r for RGBA8 images. merges separate opacity map into albedo.
+void CopyRedToAlpha(const UCHAR* pSRC, UCHAR* pDst, const UINT64 PIXEL_COUNT);
+
+// pDst.DST_CHANNEL = pSRC.SRC_CHANNEL for RGBA8 images. other channels of pDst are kept.
+// source is resampled bilinearly when sizes differ.
+void PackChannel(const UCHAR* pSRC, const UINT SRC_WIDTH, const UINT SRC_HEIGHT, const UINT SRC_CHANNEL,
+				 UCHAR* pDst, const UINT DST_WIDTH, const UINT DST_HEIGHT, const UINT DST_CHANNEL);
+// pDst.CHANNEL = VALUE for RGBA8 images.
+void FillChannel(UCHAR* pDst, const UINT64 PIXEL_COUNT, const UINT CHANNEL, const UCHAR VALUE);
+
+// Full chain down to 1x1.
+UINT GetMipLevelCount(const UINT WIDTH, const UINT HEIGHT);
+// Tightly packed levels, level 0 first. block compressed formats count 4x4 blocks.
+UINT64 GetMipChainSize(const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT);
+// 0 for uncompressed formats.
+UINT GetBlockSize(const DXGI_FORMAT FORMAT);
+
+// image holds level 0 and receives whole chain. 2x2 box filter, odd last row/column is dropped.
+// RGBA8 UNORM, RGBA8 SRGB(filtered in linear space), RGBA16 FLOAT and RGBA32 FLOAT.
+// bUseMultiThread splits rows of each level. pass false when caller is already a worker thread.
+HRESULT GenerateMips(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, UINT* pMipLevels, bool bUseMultiThread);
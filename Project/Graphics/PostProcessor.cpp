@@ -41,7 +41,7 @@ void PostProcessor::Initizlie(Renderer* pRenderer, const PostProcessingBuffers&
 		hr = pManager->CreateVertexBuffer(sizeof(Vertex),
 										  (UINT)meshInfo.Vertices.size(),
 										  &m_pScreenMesh->Vertex.VertexBufferView,
-										  &m_pScreenMesh->Vertex.pBuffer,
+										  &m_pScreenMesh->Vertex.Allocation,
 										  (void*)meshInfo.Vertices.data());
 		BREAK_IF_FAILED(hr);
 		m_pScreenMesh->Vertex.Count = (UINT)meshInfo.Vertices.size();
@@ -49,7 +49,7 @@ void PostProcessor::Initizlie(Renderer* pRenderer, const PostProcessingBuffers&
 		hr = pManager->CreateIndexBuffer(sizeof(UINT),
 										 (UINT)meshInfo.Indices.size(),
 										 &m_pScreenMesh->Index.IndexBufferView,
-										 &m_pScreenMesh->Index.pBuffer,
+										 &m_pScreenMesh->Index.Allocation,
 										 (void*)meshInfo.Indices.data());
 		BREAK_IF_FAILED(hr);
 		m_pScreenMesh->Index.Count = (UINT)meshInfo.Indices.size();
@@ -163,27 +163,28 @@ void PostProcessor::Render(Renderer* pRenderer, UINT frameIndex)
 	renderPostProcessing(pRenderer, frameIndex);
 }
 
-void PostProcessor::Render(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager, UINT frameIndex)
+void PostProcessor::Render(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager, UINT frameIndex)
 {
-	_ASSERT(pCommandList);
+	_ASSERT(pStateCache);
 	_ASSERT(pDescriptorPool);
 	_ASSERT(pManager);
 
 	ID3D12Device5* pDevice = pManager->m_pDevice;
+	ID3D12GraphicsCommandList* pCommandList = pStateCache->GetCommandList();
 
-	pCommandList->RSSetViewports(1, &m_Viewport);
-	pCommandList->RSSetScissorRects(1, &m_ScissorRect);
+	pStateCache->RSSetViewports(1, &m_Viewport);
+	pStateCache->RSSetScissorRects(1, &m_ScissorRect);
 
 	// ũ    ۿ ؽ ۸ ̸ .
 	pCommandList->IASetVertexBuffers(threadIndex, 1, &m_pScreenMesh->Vertex.VertexBufferView);
 	pCommandList->IASetIndexBuffer(&m_pScreenMesh->Index.IndexBufferView);
 
 	// basic sampling.
-	pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, RenderPSOType_Sampling);
+	pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, RenderPSOType_Sampling);
 	renderImageFilter(threadIndex, pCommandList, pDescriptorPool, pManager, m_BasicSamplingFilter, RenderPSOType_Sampling);
 
 	// post processing.
-	renderPostProcessing(threadIndex, pCommandList, pDescriptorPool, pManager);
+	renderPostProcessing(threadIndex, pStateCache, pDescriptorPool, pManager);
 }
 
 void PostProcessor::Cleanup()
@@ -242,12 +243,12 @@ void PostProcessor::SetDescriptorHeap(Renderer* pRenderer)
 	}
 }
 
-void PostProcessor::SetViewportsAndScissorRects(ID3D12GraphicsCommandList* pCommandList)
+void PostProcessor::SetViewportsAndScissorRects(CommandStateCache* pStateCache)
 {
-	_ASSERT(pCommandList);
+	_ASSERT(pStateCache);
 
-	pCommandList->RSSetViewports(1, &m_Viewport);
-	pCommandList->RSSetScissorRects(1, &m_ScissorRect);
+	pStateCache->RSSetViewports(1, &m_Viewport);
+	pStateCache->RSSetScissorRects(1, &m_ScissorRect);
 }
 
 void PostProcessor::createPostBackBuffers(Renderer* pRenderer)
@@ -454,26 +455,28 @@ void PostProcessor::renderPostProcessing(Renderer* pRenderer, UINT frameIndex)
 	pCommandList->ResourceBarrier(1, &AFTER_BARRIER);
 }
 
-void PostProcessor::renderPostProcessing(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager)
+void PostProcessor::renderPostProcessing(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager)
 {
-	_ASSERT(pCommandList);
+	_ASSERT(pStateCache);
 	_ASSERT(pDescriptorPool);
 	_ASSERT(pManager);
 
+	ID3D12GraphicsCommandList* pCommandList = pStateCache->GetCommandList();
+
 	// bloom pass.
-	/*pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, BloomDown);
+	/*pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, BloomDown);
 	for (UINT64 i = 0, size = m_BloomDownFilters.size(); i < size; ++i)
 	{
 		renderImageFilter(threadIndex, pCommandList, pDescriptorPool, pManager, m_BloomDownFilters[i], BloomDown);
 	}
-	pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, BloomUp);
+	pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, BloomUp);
 	for (UINT64 i = 0, size = m_BloomUpFilters.size(); i < size; ++i)
 	{
 		renderImageFilter(threadIndex, pCommandList, pDescriptorPool, pManager, m_BloomUpFilters[i], BloomUp);
 	}*/
 
 	// combine pass
-	pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, RenderPSOType_Combine);
+	pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, RenderPSOType_Combine);
 	renderImageFilter(threadIndex, pCommandList, pDescriptorPool, pManager, m_CombineFilter, RenderPSOType_Combine);
 
 	const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIERs[2] =
@@ -28,7 +28,7 @@ public:
 	void Update(Renderer* pRenderer);
 
 	void Render(Renderer* pRenderer, UINT frameIndex);
-	void Render(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager, UINT frameIndex);
+	void Render(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager, UINT frameIndex);
 
 	void Cleanup();
 
@@ -39,14 +39,14 @@ public:
 	inline ImageFilter* GetCombineFilterPtr() { return &m_CombineFilter; }
 
 	void SetDescriptorHeap(Renderer* pRenderer);
-	void SetViewportsAndScissorRects(ID3D12GraphicsCommandList* pCommandList);
+	void SetViewportsAndScissorRects(CommandStateCache* pStateCache);
 
 protected:
 	void createPostBackBuffers(Renderer* pRenderer);
 	void createImageResources(Renderer* pRenderer, const int WIDTH, const int HEIGHT, ImageFilter::ImageResource* pImageResource);
 
 	void renderPostProcessing(Renderer* pRenderer, UINT frameIndex);
-	void renderPostProcessing(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager);
+	void renderPostProcessing(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager);
 	void renderImageFilter(Renderer* pRenderer, ImageFilter& imageFilter, eRenderPSOType psoSetting, UINT frameIndex);
 	void renderImageFilter(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, ResourceManager* pManager, ImageFilter& imageFilter, int psoSetting);
 
@@ -49,7 +49,7 @@ void ShadowMap::Initialize(Renderer* pRenderer, UINT lightType)
 		m_pViewPorts[i] = { 0, 0, (float)m_ShadowMapWidth, (float)m_ShadowMapHeight, 0.0f, 1.0f };
 		m_pScissorRects[i] = { 0, 0, (long)m_ShadowMapWidth, (long)m_ShadowMapHeight };
 	}
-	m_ShadowConstantsBufferForGS.Initialize(pRenderer, sizeof(ShadowConstant));
+	m_pFrameConstantAllocator = pRenderer->GetResourceManager()->GetFrameConstantAllocator();
 }
 
 void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lightCam, Camera& mainCamera)
@@ -69,11 +69,11 @@ void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lig
 			Matrix lightSectionView;
 			Matrix lightSectionProjection;
 			Vector3 lightSectionPosition;
+			ShadowConstant* pShadowConstantData = allocShadowConstantsForGS();
 
 			for (int i = 0; i < 4; ++i)
 			{
 				GlobalConstant* pShadowGlobalConstantData = (GlobalConstant*)(m_ShadowConstantBuffers[i].pData);
-				ShadowConstant* pShadowConstantData = (ShadowConstant*)(m_ShadowConstantsBufferForGS.pData);
 
 				calculateCascadeLightViewProjection(&lightSectionPosition, &lightSectionView, &lightSectionProjection, camView, camProjection, property.Direction, i);
 
@@ -87,7 +87,6 @@ void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lig
 
 				m_ShadowConstantBuffers[i].Upload();
 			}
-			m_ShadowConstantsBufferForGS.Upload();
 
 			mainCamera.bUseFirstPersonView = bOriginalFPS;
 		}
@@ -114,10 +113,10 @@ void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lig
 				Vector3(0.0f, 1.0f, 0.0f)
 			};
 
+			ShadowConstant* pShadowConstantData = allocShadowConstantsForGS();
 			for (int i = 0; i < 6; ++i)
 			{
 				GlobalConstant* pShadowGlobalConstantData = (GlobalConstant*)(m_ShadowConstantBuffers[i].pData);
-				ShadowConstant* pShadowConstantData = (ShadowConstant*)(m_ShadowConstantsBufferForGS.pData);
 
 				lightView = DirectX::XMMatrixLookAtLH(property.Position, property.Position + pVIEW_DIRs[i], pUP_DIRs[i]);
 
@@ -131,7 +130,6 @@ void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lig
 
 				m_ShadowConstantBuffers[i].Upload();
 			}
-			m_ShadowConstantsBufferForGS.Upload();
 		}
 		break;
 
@@ -147,6 +145,10 @@ void ShadowMap::Update(Renderer* pRenderer, LightProperty& property, Camera& lig
 			pShadowGlobalConstantData->InverseProjection = lightProjection.Invert().Transpose();
 			pShadowGlobalConstantData->ViewProjection = (lightView * lightProjection).Transpose();
 
+			// slot 5 is bound for spot light too.
+			ShadowConstant* pShadowConstantData = allocShadowConstantsForGS();
+			pShadowConstantData->ViewProjects[0] = pShadowGlobalConstantData->ViewProjection;
+
 			m_ShadowConstantBuffers[0].Upload();
 		}
 		break;
@@ -162,6 +164,8 @@ void ShadowMap::Render(Renderer* pRenderer, std::vector<Model*>* pRenderObjects)
 
 	ResourceManager* pManager = pRenderer->GetResourceManager();
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
+	CommandStateCache* pStateCache = pManager->GetSingleStateCache();
+	const D3D12_GPU_VIRTUAL_ADDRESS SHADOW_CONSTANTS_ADDRESS = GetShadowConstantsForGSAddress();
 	const UINT DSV_DESCRIPTOR_SIZE = pManager->m_DSVDescriptorSize;
 	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
 
@@ -220,7 +224,8 @@ void ShadowMap::Render(Renderer* pRenderer, std::vector<Model*>* pRenderObjects)
 			case RenderObjectType_MirrorType:
 			{
 				pManager->SetCommonState(pso);
-				pCommandList->SetGraphicsRootConstantBufferView(1, m_ShadowConstantsBufferForGS.GetGPUMemAddr());
+				// light cbv goes through cache. bound once per light, again only after root signature change.
+				pStateCache->SetGraphicsRootConstantBufferView(5, SHADOW_CONSTANTS_ADDRESS);
 				pModel->Render(pRenderer, pso);
 			}
 			break;
@@ -229,7 +234,7 @@ void ShadowMap::Render(Renderer* pRenderer, std::vector<Model*>* pRenderObjects)
 			{
 				SkinnedMeshModel* pCharacter = (SkinnedMeshModel*)pModel;
 				pManager->SetCommonState((eRenderPSOType)(pso + 1));
-				pCommandList->SetGraphicsRootConstantBufferView(1, m_ShadowConstantsBufferForGS.GetGPUMemAddr());
+				pStateCache->SetGraphicsRootConstantBufferView(5, SHADOW_CONSTANTS_ADDRESS);
 				pCharacter->Render(pRenderer, (eRenderPSOType)(pso + 1));
 			}
 			break;
@@ -253,7 +258,6 @@ void ShadowMap::Cleanup()
 			{
 				m_ShadowConstantBuffers[i].Cleanup();
 			}
-			m_ShadowConstantsBufferForGS.Cleanup();
 			break;
 
 		case LIGHT_POINT:
@@ -262,7 +266,6 @@ void ShadowMap::Cleanup()
 			{
 				m_ShadowConstantBuffers[i].Cleanup();
 			}
-			m_ShadowConstantsBufferForGS.Cleanup();
 			break;
 
 		case LIGHT_SPOT:
@@ -273,6 +276,10 @@ void ShadowMap::Cleanup()
 		default:
 			break;
 	}
+
+	m_pFrameConstantAllocator = nullptr;
+	m_ShadowConstantsForGSAddress = 0;
+	m_ShadowConstantsForGSFrameSerial = 0;
 }
 
 void ShadowMap::SetShadowWidth(const UINT WIDTH)
@@ -400,10 +407,40 @@ void ShadowMap::SetDescriptorHeap(Renderer* pRenderer)
 	++(pManager->m_CBVSRVUAVHeapSize);
 }
 
-void ShadowMap::SetViewportsAndScissorRect(ID3D12GraphicsCommandList* pCommandList)
+void ShadowMap::SetViewportsAndScissorRect(CommandStateCache* pStateCache)
 {
-	setShadowViewport(pCommandList);
-	setShadowScissorRect(pCommandList);
+	_ASSERT(pStateCache);
+
+	UINT viewportCount = 0;
+	switch (m_LightType & m_TOTAL_LIGHT_TYPE)
+	{
+		case LIGHT_DIRECTIONAL:
+			viewportCount = 4;
+			break;
+
+		case LIGHT_POINT:
+			viewportCount = 6;
+			break;
+
+		case LIGHT_SPOT:
+			viewportCount = 1;
+			break;
+
+		default:
+			__debugbreak();
+			break;
+	}
+
+	pStateCache->RSSetViewports(viewportCount, m_pViewPorts);
+	pStateCache->RSSetScissorRects(viewportCount, m_pScissorRects);
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS ShadowMap::GetShadowConstantsForGSAddress()
+{
+	// Update() skipped in this frame. slice may belong to other frame.
+	_ASSERT(m_pFrameConstantAllocator && m_ShadowConstantsForGSFrameSerial == m_pFrameConstantAllocator->GetFrameSerial());
+
+	return m_ShadowConstantsForGSAddress;
 }
 
 void ShadowMap::setShadowViewport(ID3D12GraphicsCommandList* pCommandList)
@@ -454,6 +491,21 @@ void ShadowMap::setShadowScissorRect(ID3D12GraphicsCommandList* pCommandList)
 	}
 }
 
+ShadowConstant* ShadowMap::allocShadowConstantsForGS()
+{
+	_ASSERT(m_pFrameConstantAllocator);
+
+	HRESULT hr = S_OK;
+	void* pMappedPtr = nullptr;
+
+	// written in place, upload heap is write combined. fields are only written, never read back.
+	hr = m_pFrameConstantAllocator->Allocate(sizeof(ShadowConstant), &m_ShadowConstantsForGSAddress, &pMappedPtr);
+	BREAK_IF_FAILED(hr);
+	m_ShadowConstantsForGSFrameSerial = m_pFrameConstantAllocator->GetFrameSerial();
+
+	return (ShadowConstant*)pMappedPtr;
+}
+
 void ShadowMap::calculateCascadeLightViewProjection(Vector3* pPosition, Matrix* pView, Matrix* pProjection, const Matrix& VIEW, const Matrix& PROJECTION, const Vector3& DIR, int cascadeIndex)
 {
 	_ASSERT(pPosition);
@@ -28,18 +28,22 @@ public:
 	inline Texture* GetDirectionalLightShadowBufferPtr() { return &m_DirectionalLightShadowBuffer; }
 
 	inline ConstantBuffer* GetShadowConstantsBufferPtr() { return m_ShadowConstantBuffers; }
-	inline ConstantBuffer* GetShadowConstantBufferForGSPtr() { return &m_ShadowConstantsBufferForGS; }
 
 	void SetShadowWidth(const UINT WIDTH);
 	void SetShadowHeight(const UINT HEIGHT);
 
 	void SetDescriptorHeap(Renderer* pRenderer);
-	void SetViewportsAndScissorRect(ID3D12GraphicsCommandList* pCommandList);
+	void SetViewportsAndScissorRect(CommandStateCache* pStateCache);
+
+	// slice of frame constant ring written by Update() of this frame.
+	D3D12_GPU_VIRTUAL_ADDRESS GetShadowConstantsForGSAddress();
 
 protected:
 	void setShadowViewport(ID3D12GraphicsCommandList* pCommandList);
 	void setShadowScissorRect(ID3D12GraphicsCommandList* pCommandList);
 
+	ShadowConstant* allocShadowConstantsForGS();
+
 	void calculateCascadeLightViewProjection(Vector3* pPosition, Matrix* pView, Matrix* pProjection, const Matrix& VIEW, const Matrix& PROJECTION, const Vector3& DIR, int cascadeIndex);
 
 private:
@@ -58,5 +62,8 @@ private:
 		Texture m_DirectionalLightShadowBuffer;
 	};
 	ConstantBuffer m_ShadowConstantBuffers[6];	 // spot, point, direc => 0, 6, 4 .
-	ConstantBuffer m_ShadowConstantsBufferForGS; // 2 ̻ view  ϴ    geometry ;
+	// 2 ̻ view  ϴ   geometry .   ring  .
+	FrameConstantAllocator* m_pFrameConstantAllocator = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS m_ShadowConstantsForGSAddress = 0;
+	UINT64 m_ShadowConstantsForGSFrameSerial = 0;
 };
@@ -1,5 +1,6 @@
 #include "../pch.h"
 #include "GraphicsUtil.h"
+#include "ImageProcessing.h"
 #include "../Util/Utility.h"
 #include "Texture.h"
 
@@ -7,17 +8,13 @@ void Texture::Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUs
 {
 	_ASSERT(pRenderer);
 
-	Cleanup();
-
 	HRESULT hr = S_OK;
-	ResourceManager* pManager = pRenderer->GetResourceManager();
-	ID3D12Device* pDevice = pManager->m_pDevice;
-	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
 	std::vector<UCHAR> image;
 	DXGI_FORMAT pixelFormat = (bUseSRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM);
 
 	int width = 0;
 	int height = 0;
+	UINT mipLevels = 1;
 
 	if (GetFileExtension(pszFileName).compare(L"exr") == 0)
 	{
@@ -29,15 +26,34 @@ void Texture::Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUs
 	}
 	BREAK_IF_FAILED(hr);
 
+	if (FAILED(GenerateMips(image, (UINT)width, (UINT)height, pixelFormat, &mipLevels, true)))
+	{
+		mipLevels = 1;
+	}
+
+	Initialize(pRenderer, image.data(), (UINT)width, (UINT)height, pixelFormat, mipLevels);
+}
+
+void Texture::Initialize(Renderer* pRenderer, const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, const UINT MIP_LEVELS)
+{
+	_ASSERT(pRenderer);
+	_ASSERT(pIMAGE);
+	_ASSERT(MIP_LEVELS > 0);
+
+	Cleanup();
+
+	HRESULT hr = S_OK;
+	ResourceManager* pManager = pRenderer->GetResourceManager();
+	ID3D12Device* pDevice = pManager->m_pDevice;
 
 	D3D12_RESOURCE_DESC textureDesc = {};
 	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
 	textureDesc.Alignment = 0;
-	textureDesc.Width = width;
-	textureDesc.Height = height;
+	textureDesc.Width = WIDTH;
+	textureDesc.Height = HEIGHT;
 	textureDesc.DepthOrArraySize = 1;
-	textureDesc.MipLevels = 1;
-	textureDesc.Format = pixelFormat;
+	textureDesc.MipLevels = (UINT16)MIP_LEVELS;
+	textureDesc.Format = FORMAT;
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.SampleDesc.Quality = 0;
 	textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
@@ -50,8 +66,6 @@ void Texture::Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUs
 	heapProps.CreationNodeMask = 1;
 	heapProps.VisibleNodeMask = 1;
 
-	D3D12_RESOURCE_STATES curState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-
 	m_Width = (UINT)textureDesc.Width;
 	m_Height = (UINT)textureDesc.Height;
 	m_Depth = (UINT)textureDesc.DepthOrArraySize;
@@ -59,7 +73,7 @@ void Texture::Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUs
 	hr = pDevice->CreateCommittedResource(&heapProps,
 										  D3D12_HEAP_FLAG_NONE,
 										  &textureDesc,
-										  curState,
+										  D3D12_RESOURCE_STATE_COPY_DEST,
 										  nullptr,
 										  IID_PPV_ARGS(&m_pResource));
 	BREAK_IF_FAILED(hr);
@@ -67,48 +81,9 @@ void Texture::Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUs
 
 	m_GPUMemAddr = m_pResource->GetGPUVirtualAddress();
 
-
-	ID3D12Resource* pUploadResource = nullptr;
-	BYTE* pMappedPtr = nullptr;
-	UINT64 pixelSize = GetPixelSize(textureDesc.Format);
-	UINT num2DSubresources = textureDesc.DepthOrArraySize * textureDesc.MipLevels;
-	UINT64 uploadBufferSize = GetRequiredIntermediateSize(m_pResource, 0, num2DSubresources);
-
-	D3D12_RESOURCE_DESC Desc = m_pResource->GetDesc();
-	D3D12_PLACED_SUBRESOURCE_FOOTPRINT footPrint;
-	UINT rows = 0;
-	UINT64 rowSize = 0;
-	UINT64 totalBytes = 0;
-	CD3DX12_RESOURCE_DESC uploadResourceDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
-
-	pDevice->GetCopyableFootprints(&Desc, 0, 1, 0, &footPrint, &rows, &rowSize, &totalBytes);
-	heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-	hr = pDevice->CreateCommittedResource(&heapProps,
-										  D3D12_HEAP_FLAG_NONE,
-										  &uploadResourceDesc,
-										  D3D12_RESOURCE_STATE_GENERIC_READ,
-										  nullptr,
-										  IID_PPV_ARGS(&pUploadResource));
-	BREAK_IF_FAILED(hr);
-	pUploadResource->SetName(L"TextureUploader");
-
-	CD3DX12_RANGE writeRange(0, 0);
-	hr = pUploadResource->Map(0, &writeRange, (void**)(&pMappedPtr));
+	// staged and recorded now, copied to GPU with other uploads of current batch.
+	hr = pManager->UploadTexture(m_pResource, pIMAGE, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 	BREAK_IF_FAILED(hr);
-
-	const BYTE* pSrc = image.data();
-	BYTE* pDest = pMappedPtr;
-	for (UINT i = 0; i < m_Width; ++i)
-	{
-		memcpy(pDest, pSrc, m_Width * pixelSize);
-		pSrc += (m_Width * pixelSize);
-		pDest += footPrint.Footprint.RowPitch;
-	}
-
-	pUploadResource->Unmap(0, nullptr);
-	pManager->UpdateTexture(m_pResource, pUploadResource, &curState);
-
-	SAFE_RELEASE(pUploadResource);
 }
 
 void Texture::Initialize(Renderer* pRenderer, const D3D12_RESOURCE_DESC& DESC)
@@ -152,6 +127,22 @@ void Texture::InitializeWithDDS(Renderer* pRenderer, const WCHAR* pszFileName)
 	m_pResource->SetName(L"TextureResource");
 }
 
+void Texture::InitializeWithResource(ID3D12Resource* pResource)
+{
+	_ASSERT(pResource);
+
+	Cleanup();
+
+	D3D12_RESOURCE_DESC desc = pResource->GetDesc();
+	m_Width = (UINT)desc.Width;
+	m_Height = desc.Height;
+	m_Depth = desc.DepthOrArraySize;
+
+	m_pResource = pResource;
+	m_pResource->AddRef();
+	m_GPUMemAddr = m_pResource->GetGPUVirtualAddress();
+}
+
 void Texture::Cleanup()
 {
 	m_Width = 0;
@@ -172,7 +163,6 @@ void NonImageTexture::Initialize(Renderer* pRenderer, UINT numElement, UINT elem
 
 	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 
 	ElementCount = numElement;
 	ElementSize = elementSize;
@@ -180,39 +170,17 @@ void NonImageTexture::Initialize(Renderer* pRenderer, UINT numElement, UINT elem
 	pData = malloc(m_BufferSize);
 	ZeroMemory(pData, m_BufferSize);
 
-	D3D12_RESOURCE_DESC resourceDesc;
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	resourceDesc.Alignment = 0;
-	resourceDesc.Width = m_BufferSize;
-	resourceDesc.Height = 1;
-	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 1;
-	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.SampleDesc.Quality = 0;
-	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-	CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-
-	hr = pDevice->CreateCommittedResource(&heapProps,
-										  D3D12_HEAP_FLAG_NONE,
-										  &resourceDesc,
-										  D3D12_RESOURCE_STATE_GENERIC_READ,
-										  nullptr,
-										  IID_PPV_ARGS(&m_pResource));
+	// offset is multiple of element size, so SRV can start at GetFirstElement().
+	hr = pManager->GetUploadBufferPool()->Allocate(m_BufferSize, ElementSize, &m_Allocation);
 	BREAK_IF_FAILED(hr);
-	m_pResource->SetName(L"NonImageTextureResource");
 
-	m_GPUMemAddr = m_pResource->GetGPUVirtualAddress();
-
-	CD3DX12_RANGE writeRange(0, 0);
-	m_pResource->Map(0, &writeRange, &m_pSysMemAddr);
+	m_GPUMemAddr = m_Allocation.GPUAddress;
+	m_pSysMemAddr = m_Allocation.pMappedPtr;
 }
 
 void NonImageTexture::Upload()
 {
-	_ASSERT(m_pResource);
+	_ASSERT(m_Allocation.pResource);
 	_ASSERT(m_pSysMemAddr);
 
 	memcpy(m_pSysMemAddr, pData, m_BufferSize);
@@ -233,13 +201,9 @@ void NonImageTexture::Clear()
 	m_GPUMemAddr = 0xffffffffffffffff;
 	// m_SRVHandle = { 0xffffffffffffffff, };
 
-	if (m_pResource)
+	m_pSysMemAddr = nullptr;
+	if (m_Allocation.pPool)
 	{
-		CD3DX12_RANGE writeRange(0, 0);
-		m_pResource->Unmap(0, &writeRange);
-		m_pSysMemAddr = nullptr;
-
-		m_pResource->Release();
-		m_pResource = nullptr;
+		m_Allocation.pPool->Free(&m_Allocation);
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Renderer/GPUBufferPool.h"
+
 class Texture
 {
 public:
@@ -7,8 +9,11 @@ public:
 	~Texture() { Cleanup(); }
 
 	void Initialize(Renderer* pRenderer, const WCHAR* pszFileName, bool bUseSRGB);
+	// pIMAGE holds MIP_LEVELS levels packed tightly, level 0 first.
+	void Initialize(Renderer* pRenderer, const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, const UINT MIP_LEVELS = 1);
 	void Initialize(Renderer* pRenderer, const D3D12_RESOURCE_DESC& DESC);
 	void InitializeWithDDS(Renderer* pRenderer, const WCHAR* pszFileName);
+	void InitializeWithResource(ID3D12Resource* pResource); // shares resource. adds reference.
 
 	void Cleanup();
 
@@ -45,8 +50,10 @@ public:
 
 	inline void SetSRVHandle(const D3D12_CPU_DESCRIPTOR_HANDLE HANDLE) { m_SRVHandle = HANDLE; }
 
-	inline ID3D12Resource* GetResource() { return m_pResource; }
+	inline ID3D12Resource* GetResource() { return m_Allocation.pResource; }
 	inline void* GetSysMemAddr() { return m_pSysMemAddr; }
+	// buffer is shared with other allocations. SRV starts from this element.
+	inline UINT64 GetFirstElement() { return m_Allocation.Offset / ElementSize; }
 	inline D3D12_GPU_VIRTUAL_ADDRESS GetGPUMemAddr() { return m_GPUMemAddr; }
 	inline D3D12_CPU_DESCRIPTOR_HANDLE GetSRVHandle() { return m_SRVHandle; }
 
@@ -56,7 +63,7 @@ public:
 	UINT64 ElementCount = 0;
 
 private:
-	ID3D12Resource* m_pResource = nullptr;
+	GPUBufferAllocation m_Allocation; // range of resource manager's upload buffer pool.
 	void* m_pSysMemAddr = nullptr;
 	D3D12_GPU_VIRTUAL_ADDRESS m_GPUMemAddr = 0xffffffffffffffff;
 	D3D12_CPU_DESCRIPTOR_HANDLE m_SRVHandle = { 0xffffffffffffffff, };
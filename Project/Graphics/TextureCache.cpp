@@ -0,0 +1,1094 @@
+#include "../pch.h"
+#include "GraphicsUtil.h"
+#include "ImageProcessing.h"
+#include "TextureCompressor.h"
+#include "../Model/MeshInfo.h"
+#include "../Util/Utility.h"
+#include "ConstantBuffer.h"
+#include "TextureCache.h"
+
+// one source map of packed ORMH texture.
+struct ORMHSource
+{
+	std::wstring FileName; // empty when channel has no map.
+	std::vector<UCHAR> Data; // encoded file, or RGBA8 pixels when Width > 0.
+	UINT Width;
+	UINT Height;
+	bool bFromMemory;
+	int SameAs; // earlier channel with same file. -1 if none.
+};
+
+struct TextureLoadJob
+{
+	TextureCache* pCache;
+	TextureCacheEntry* pEntry;
+	bool bHashContent;
+	eTextureUsage Usage;
+	eTextureCompressionPreset Preset;
+	bool bFromMemory;
+
+	std::vector<UCHAR> Image;
+	int Width;
+	int Height;
+	DXGI_FORMAT PixelFormat;
+	UINT MipLevels;
+	UINT64 ContentHash;
+
+	// batch load only.
+	std::wstring FileName;
+	const EmbeddedTexture* pEMBEDDED;
+	HRESULT Result;
+
+	// TextureUsage_ORMH only.
+	ORMHSource ORMHSources[ORMHChannel_Count];
+};
+
+struct TextureBatchContext
+{
+	TextureLoadJob** ppJobs;
+	UINT JobCount;
+	volatile LONG NextJobIndex;
+};
+
+static const WCHAR* s_VARIANT_KEYS[TextureUsage_Count] = { L"|srgb", L"|linear", L"|r", L"|g", L"|b", L"|ormh" };
+
+// channel read from each source. glTF keeps occlusion, roughness and metallic in r, g, b of one file.
+static const UINT s_ORMH_SOURCE_CHANNELS[ORMHChannel_Count] = { 0, 1, 2, 0 };
+// value of channel without map. same shading as no map. height is not sampled then.
+static const UCHAR s_ORMH_NEUTRAL_VALUES[ORMHChannel_Count] = { 255, 255, 255, 128 };
+
+// same file loaded as srgb and linear are different resources.
+// compressed scalar maps keep one channel, so each channel is a resource too.
+static eTextureUsage getVariant(const eTextureUsage USAGE)
+{
+#ifdef USE_TEXTURE_COMPRESSION
+	return USAGE;
+#else
+	if (USAGE == TextureUsage_Color || USAGE == TextureUsage_ORMH)
+	{
+		return USAGE;
+	}
+	return TextureUsage_Normal;
+#endif
+}
+
+static UINT64 hashContent(const std::vector<UCHAR>& FILE_DATA, const eTextureUsage USAGE)
+{
+	const UCHAR VARIANT = (UCHAR)getVariant(USAGE);
+	return HashBytes(&VARIANT, 1, HashBytes(FILE_DATA.data(), FILE_DATA.size()));
+}
+
+static DXGI_FORMAT getPixelFormat(const eTextureUsage USAGE)
+{
+	return (USAGE == TextureUsage_Color ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM);
+}
+
+static void generateMips(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, UINT* pMipLevels, bool bUseMultiThread)
+{
+	if (FAILED(GenerateMips(image, WIDTH, HEIGHT, FORMAT, pMipLevels, bUseMultiThread)))
+	{
+		// unsupported format. level 0 only.
+		*pMipLevels = 1;
+	}
+}
+
+#ifdef USE_TEXTURE_COMPRESSION
+// keeps image as is when usage or size can't be compressed. pFILE_NAMES are sources of image.
+static void compressImage(const std::wstring* pFILE_NAMES, const UINT FILE_COUNT, bool bWriteCache, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+						  std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, DXGI_FORMAT* pPixelFormat, bool bUseMultiThread)
+{
+	HRESULT hr = S_OK;
+	const DXGI_FORMAT SRC_FORMAT = *pPixelFormat;
+	double psnr = 0.0;
+	double* pPSNR = nullptr;
+#ifdef _DEBUG
+	pPSNR = &psnr;
+	const UINT64 SRC_SIZE = image.size();
+#endif
+
+	// float images stay.
+	if (SRC_FORMAT != DXGI_FORMAT_R8G8B8A8_UNORM && SRC_FORMAT != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+	{
+		return;
+	}
+
+	const bool bHAS_ALPHA = (USAGE == TextureUsage_Color && HasAlpha(image.data(), (UINT64)WIDTH * HEIGHT));
+	const DXGI_FORMAT COMPRESSED_FORMAT = GetCompressedFormat(USAGE, PRESET, WIDTH, HEIGHT, bHAS_ALPHA);
+	if (COMPRESSED_FORMAT == DXGI_FORMAT_UNKNOWN)
+	{
+		return;
+	}
+
+	hr = CompressImage(image, WIDTH, HEIGHT, MIP_LEVELS, SRC_FORMAT, USAGE, COMPRESSED_FORMAT, PRESET, bUseMultiThread, pPSNR);
+	if (FAILED(hr))
+	{
+		return;
+	}
+	*pPixelFormat = COMPRESSED_FORMAT;
+
+#ifdef _DEBUG
+	char debugString[256];
+	sprintf_s(debugString, " compressed to format %d. %llu -> %llu bytes, PSNR %.2fdB.\n", (int)COMPRESSED_FORMAT, SRC_SIZE, (UINT64)image.size(), psnr);
+	for (UINT i = 0; i < FILE_COUNT; ++i)
+	{
+		OutputDebugStringW(pFILE_NAMES[i].c_str());
+		OutputDebugStringA(" ");
+	}
+	OutputDebugStringA(debugString);
+#endif
+
+	if (bWriteCache)
+	{
+		WriteCompressedCache(pFILE_NAMES, FILE_COUNT, USAGE, PRESET, image.data(), WIDTH, HEIGHT, MIP_LEVELS, COMPRESSED_FORMAT);
+	}
+}
+#endif
+
+// image receives full mip chain, block compressed with USE_TEXTURE_COMPRESSION.
+static HRESULT decodeImage(const std::wstring& FILE_NAME, const std::vector<UCHAR>& FILE_DATA, bool bFromMemory, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+						   std::vector<UCHAR>& image, int* pWidth, int* pHeight, DXGI_FORMAT* pPixelFormat, UINT* pMipLevels, bool bUseMultiThread)
+{
+	HRESULT hr = S_OK;
+
+#ifdef USE_TEXTURE_COMPRESSION
+	// embedded textures have no file to cache next to.
+	UINT cachedWidth = 0;
+	UINT cachedHeight = 0;
+	if (!bFromMemory && SUCCEEDED(ReadCompressedCache(&FILE_NAME, 1, USAGE, PRESET, image, &cachedWidth, &cachedHeight, pMipLevels, pPixelFormat)))
+	{
+		*pWidth = (int)cachedWidth;
+		*pHeight = (int)cachedHeight;
+		return S_OK;
+	}
+#endif
+
+	// tinyexr reads by path. file is in os cache already.
+	if (!bFromMemory && GetFileExtension(FILE_NAME).compare(L"exr") == 0)
+	{
+		hr = ReadEXRImage(FILE_NAME.c_str(), image, pWidth, pHeight, pPixelFormat);
+	}
+	else
+	{
+		hr = ReadImageFromMemory(FILE_DATA.data(), FILE_DATA.size(), image, pWidth, pHeight);
+	}
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	generateMips(image, (UINT)(*pWidth), (UINT)(*pHeight), *pPixelFormat, pMipLevels, bUseMultiThread);
+#ifdef USE_TEXTURE_COMPRESSION
+	compressImage(&FILE_NAME, 1, !bFromMemory, USAGE, PRESET, image, (UINT)(*pWidth), (UINT)(*pHeight), *pMipLevels, pPixelFormat, bUseMultiThread);
+#endif
+	return hr;
+}
+
+// main thread. embedded maps are copied, MeshInfo can be gone before streamed decoding.
+static void initORMHSources(const std::wstring* pFILE_NAMES, const EmbeddedTexture* const* ppEMBEDDED, ORMHSource* pSources)
+{
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		ORMHSource& source = pSources[i];
+		source.FileName = pFILE_NAMES[i];
+		source.Width = 0;
+		source.Height = 0;
+		source.bFromMemory = (ppEMBEDDED[i] != nullptr);
+		source.SameAs = -1;
+		if (source.FileName.empty())
+		{
+			continue;
+		}
+
+		for (UINT j = 0; j < i; ++j)
+		{
+			if (pSources[j].SameAs < 0 && pSources[j].FileName == source.FileName)
+			{
+				source.SameAs = (int)j;
+				break;
+			}
+		}
+		if (source.SameAs < 0 && ppEMBEDDED[i])
+		{
+			source.Data = ppEMBEDDED[i]->Data;
+			source.Width = ppEMBEDDED[i]->Width;
+			source.Height = ppEMBEDDED[i]->Height;
+		}
+	}
+}
+
+// AssetStreamer reads this one. -1 when every map is embedded.
+static int getStreamedORMHSource(const ORMHSource* pSOURCES)
+{
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		if (!pSOURCES[i].FileName.empty() && !pSOURCES[i].bFromMemory && pSOURCES[i].SameAs < 0)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+// reads files not read yet. channels whose file can't be read are dropped.
+static HRESULT readORMHSources(ORMHSource* pSources)
+{
+	bool bHasSource = false;
+
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		ORMHSource& source = pSources[i];
+		if (source.FileName.empty())
+		{
+			continue;
+		}
+
+		if (source.SameAs >= 0)
+		{
+			if (pSources[source.SameAs].FileName.empty())
+			{
+				source.FileName.clear();
+				continue;
+			}
+		}
+		else if (!source.bFromMemory && source.Data.empty() && FAILED(ReadWholeFile(source.FileName.c_str(), source.Data)))
+		{
+			OutputDebugStringW(source.FileName.c_str());
+			OutputDebugStringA(" can't be read. Skip ORMH channel.\n");
+			source.FileName.clear();
+			continue;
+		}
+		bHasSource = true;
+	}
+
+	return (bHasSource ? S_OK : E_FAIL);
+}
+
+static UINT64 hashORMHSources(const ORMHSource* pSOURCES)
+{
+	const UCHAR VARIANT = (UCHAR)TextureUsage_ORMH;
+	UINT64 hash = HashBytes(&VARIANT, 1);
+
+	for (UCHAR i = 0; i < ORMHChannel_Count; ++i)
+	{
+		const ORMHSource& SOURCE = pSOURCES[i];
+		const ORMHSource& DATA_SOURCE = (SOURCE.SameAs >= 0 ? pSOURCES[SOURCE.SameAs] : SOURCE);
+
+		hash = HashBytes(&i, 1, hash);
+		if (!SOURCE.FileName.empty())
+		{
+			hash = HashBytes(DATA_SOURCE.Data.data(), DATA_SOURCE.Data.size(), hash);
+		}
+	}
+	return hash;
+}
+
+// image receives full mip chain of packed RGBA8, block compressed with USE_TEXTURE_COMPRESSION.
+// packed size is largest source size. smaller maps are resampled.
+static HRESULT decodeORMHImage(ORMHSource* pSources, const eTextureCompressionPreset PRESET, std::vector<UCHAR>& image,
+							   int* pWidth, int* pHeight, DXGI_FORMAT* pPixelFormat, UINT* pMipLevels, bool bUseMultiThread)
+{
+	std::wstring fileNames[ORMHChannel_Count];
+	std::vector<UCHAR> pixels[ORMHChannel_Count];
+	int widths[ORMHChannel_Count] = { 0, };
+	int heights[ORMHChannel_Count] = { 0, };
+	int width = 0;
+	int height = 0;
+	bool bFromMemory = false;
+
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		fileNames[i] = pSources[i].FileName;
+		bFromMemory = (bFromMemory || (!fileNames[i].empty() && pSources[i].bFromMemory));
+	}
+	*pPixelFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+#ifdef USE_TEXTURE_COMPRESSION
+	UINT cachedWidth = 0;
+	UINT cachedHeight = 0;
+	if (!bFromMemory && SUCCEEDED(ReadCompressedCache(fileNames, ORMHChannel_Count, TextureUsage_ORMH, PRESET, image, &cachedWidth, &cachedHeight, pMipLevels, pPixelFormat)))
+	{
+		*pWidth = (int)cachedWidth;
+		*pHeight = (int)cachedHeight;
+		return S_OK;
+	}
+#endif
+
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		ORMHSource& source = pSources[i];
+		if (source.FileName.empty() || source.SameAs >= 0)
+		{
+			continue;
+		}
+
+		if (source.Width > 0)
+		{
+			pixels[i].swap(source.Data);
+			widths[i] = (int)source.Width;
+			heights[i] = (int)source.Height;
+		}
+		else if (FAILED(ReadImageFromMemory(source.Data.data(), source.Data.size(), pixels[i], &widths[i], &heights[i])))
+		{
+			OutputDebugStringW(source.FileName.c_str());
+			OutputDebugStringA(" can't be decoded. Skip ORMH channel.\n");
+			pixels[i].clear();
+			continue;
+		}
+		width = Max(width, widths[i]);
+		height = Max(height, heights[i]);
+	}
+	if (width == 0 || height == 0)
+	{
+		return E_FAIL;
+	}
+
+	const UINT64 PIXEL_COUNT = (UINT64)width * height;
+	image.resize(PIXEL_COUNT * 4);
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		const UINT SRC_INDEX = (pSources[i].SameAs >= 0 ? (UINT)pSources[i].SameAs : i);
+		if (pSources[i].FileName.empty() || pixels[SRC_INDEX].empty())
+		{
+			FillChannel(image.data(), PIXEL_COUNT, i, s_ORMH_NEUTRAL_VALUES[i]);
+			continue;
+		}
+		PackChannel(pixels[SRC_INDEX].data(), (UINT)widths[SRC_INDEX], (UINT)heights[SRC_INDEX], s_ORMH_SOURCE_CHANNELS[i], image.data(), (UINT)width, (UINT)height, i);
+	}
+	*pWidth = width;
+	*pHeight = height;
+
+	generateMips(image, (UINT)width, (UINT)height, *pPixelFormat, pMipLevels, bUseMultiThread);
+#ifdef USE_TEXTURE_COMPRESSION
+	compressImage(fileNames, ORMHChannel_Count, !bFromMemory, TextureUsage_ORMH, PRESET, image, (UINT)width, (UINT)height, *pMipLevels, pPixelFormat, bUseMultiThread);
+#endif
+	return S_OK;
+}
+
+static HRESULT decodeStreamingTexture(StreamingRequest* pRequest)
+{
+	HRESULT hr = S_OK;
+	TextureLoadJob* pJob = (TextureLoadJob*)pRequest->pUserData;
+
+	if (pJob->Usage == TextureUsage_ORMH)
+	{
+		// other maps are read here.
+		pJob->ORMHSources[getStreamedORMHSource(pJob->ORMHSources)].Data.swap(pRequest->FileData);
+
+		hr = readORMHSources(pJob->ORMHSources);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+		if (pJob->bHashContent)
+		{
+			pJob->ContentHash = hashORMHSources(pJob->ORMHSources);
+		}
+		return decodeORMHImage(pJob->ORMHSources, pJob->Preset, pJob->Image, &pJob->Width, &pJob->Height, &pJob->PixelFormat, &pJob->MipLevels, false);
+	}
+
+	if (pJob->bHashContent)
+	{
+		pJob->ContentHash = hashContent(pRequest->FileData, pJob->Usage);
+	}
+	return decodeImage(pRequest->FileName, pRequest->FileData, pJob->bFromMemory, pJob->Usage, pJob->Preset, pJob->Image, &pJob->Width, &pJob->Height, &pJob->PixelFormat, &pJob->MipLevels, false);
+}
+
+static void completeStreamingTexture(StreamingRequest* pRequest, void* pUploadSink)
+{
+	TextureLoadJob* pJob = (TextureLoadJob*)pRequest->pUserData;
+
+	if (SUCCEEDED(pRequest->Result) && pUploadSink)
+	{
+		pJob->pCache->FinishLoading(pJob->pEntry, (Renderer*)pUploadSink, pJob->Image.data(), (UINT)pJob->Width, (UINT)pJob->Height, pJob->MipLevels, pJob->PixelFormat, pJob->ContentHash);
+	}
+	else
+	{
+#ifdef _DEBUG
+		if (pRequest->Result != E_ABORT)
+		{
+			OutputDebugStringW(pRequest->FileName.c_str());
+			OutputDebugStringA(" streaming failed.\n");
+		}
+#endif
+		pJob->pCache->FinishLoading(pJob->pEntry, nullptr, nullptr, 0, 0, 0, DXGI_FORMAT_UNKNOWN, 0);
+	}
+
+	delete pJob;
+	pRequest->pUserData = nullptr;
+}
+
+// Runs on worker threads while main thread waits in EndBatch(), so hash map is read only.
+static void loadBatchTexture(TextureLoadJob* pJob)
+{
+	std::vector<UCHAR> fileData;
+	const std::vector<UCHAR>* pSrcData = &fileData;
+
+	if (pJob->Usage == TextureUsage_ORMH)
+	{
+		pJob->Result = readORMHSources(pJob->ORMHSources);
+		if (FAILED(pJob->Result))
+		{
+			return;
+		}
+		if (pJob->bHashContent)
+		{
+			pJob->ContentHash = hashORMHSources(pJob->ORMHSources);
+			if (pJob->pCache->HasContent(pJob->ContentHash))
+			{
+				pJob->Result = S_OK;
+				return;
+			}
+		}
+		pJob->Result = decodeORMHImage(pJob->ORMHSources, pJob->Preset, pJob->Image, &pJob->Width, &pJob->Height, &pJob->PixelFormat, &pJob->MipLevels, false);
+		return;
+	}
+
+	if (pJob->pEMBEDDED)
+	{
+		pSrcData = &pJob->pEMBEDDED->Data;
+	}
+	else
+	{
+		pJob->Result = ReadWholeFile(pJob->FileName.c_str(), fileData);
+		if (FAILED(pJob->Result))
+		{
+			return;
+		}
+	}
+
+	if (pJob->bHashContent)
+	{
+		pJob->ContentHash = hashContent(*pSrcData, pJob->Usage);
+
+		// FinishLoading() binds loaded one.
+		if (pJob->pCache->HasContent(pJob->ContentHash))
+		{
+			pJob->Result = S_OK;
+			return;
+		}
+	}
+
+	// textures are spread over threads already.
+	pJob->Result = decodeImage(pJob->FileName, *pSrcData, pJob->bFromMemory, pJob->Usage, pJob->Preset, pJob->Image, &pJob->Width, &pJob->Height, &pJob->PixelFormat, &pJob->MipLevels, false);
+}
+
+static void loadBatchTextureRange(UINT begin, UINT end, UINT rangeIndex, void* pArg)
+{
+	TextureBatchContext* pContext = (TextureBatchContext*)pArg;
+
+	// sizes differ a lot between textures. pull next job instead of fixed range.
+	while (true)
+	{
+		LONG jobIndex = InterlockedIncrement(&pContext->NextJobIndex) - 1;
+		if (jobIndex >= (LONG)pContext->JobCount)
+		{
+			break;
+		}
+		loadBatchTexture(pContext->ppJobs[jobIndex]);
+	}
+}
+
+bool TextureCache::Acquire(Renderer* pRenderer, const std::wstring& FILE_NAME, const eTextureUsage USAGE, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner, const EmbeddedTexture* pEMBEDDED)
+{
+	_ASSERT(pRenderer);
+	_ASSERT(pTexture);
+	_ASSERT(pUseFlag);
+
+	if (FILE_NAME.empty())
+	{
+		return false;
+	}
+
+	std::wstring key = NormalizePath(FILE_NAME);
+	key += s_VARIANT_KEYS[getVariant(USAGE)];
+
+	if (bindCachedEntry(pRenderer, key, pTexture, pUseFlag, pFlagBuffer, pOwner))
+	{
+		return true;
+	}
+
+	// file system is touched only on miss.
+	if (!pEMBEDDED)
+	{
+		struct _stat64 sourceFileStat;
+		std::string fileNameA(FILE_NAME.begin(), FILE_NAME.end());
+		if (_stat64(fileNameA.c_str(), &sourceFileStat) == -1)
+		{
+			OutputDebugStringW(FILE_NAME.c_str());
+			OutputDebugStringA(" does not exists. Skip texture reading.\n");
+			return false;
+		}
+	}
+
+	++m_Stats.MissCount;
+
+#ifdef USE_ASSET_STREAMING
+	// raw embedded pixels need no decoding.
+	if (!pEMBEDDED || pEMBEDDED->Width == 0)
+	{
+		TextureLoadJob* pJob = createLoadJob(key, USAGE, pTexture, pUseFlag, pFlagBuffer, pOwner);
+		pJob->bFromMemory = (pEMBEDDED != nullptr);
+
+		// color textures are visible first.
+		AssetStreamer* pStreamer = pRenderer->GetAssetStreamer();
+		eStreamingPriority priority = (USAGE == TextureUsage_Color ? StreamingPriority_High : StreamingPriority_Normal);
+		if (pEMBEDDED)
+		{
+			pStreamer->RequestFromMemory(FILE_NAME.c_str(), pEMBEDDED->Data.data(), pEMBEDDED->Data.size(), priority, decodeStreamingTexture, completeStreamingTexture, this, pJob);
+		}
+		else
+		{
+			pStreamer->Request(FILE_NAME.c_str(), priority, decodeStreamingTexture, completeStreamingTexture, this, pJob);
+		}
+
+		return true;
+	}
+#else
+	if (m_bBatching && (!pEMBEDDED || pEMBEDDED->Width == 0))
+	{
+		TextureLoadJob* pJob = createLoadJob(key, USAGE, pTexture, pUseFlag, pFlagBuffer, pOwner);
+		pJob->bFromMemory = (pEMBEDDED != nullptr);
+		pJob->FileName = FILE_NAME;
+		pJob->pEMBEDDED = pEMBEDDED;
+
+		m_BatchJobs.push_back(pJob);
+		return true;
+	}
+#endif
+
+	return loadEntry(pRenderer, key, FILE_NAME, USAGE, pEMBEDDED, pTexture, pUseFlag);
+}
+
+bool TextureCache::AcquireORMH(Renderer* pRenderer, const std::wstring* pFILE_NAMES, const EmbeddedTexture* const* ppEMBEDDED, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, UINT* pChannelMask, void* pOwner)
+{
+	_ASSERT(pRenderer);
+	_ASSERT(pFILE_NAMES);
+	_ASSERT(ppEMBEDDED);
+	_ASSERT(pTexture);
+	_ASSERT(pUseFlag);
+	_ASSERT(pChannelMask);
+
+	std::wstring fileNames[ORMHChannel_Count];
+	std::wstring key;
+	UINT channelMask = 0;
+
+	// key is made of existing maps only.
+	for (UINT i = 0; i < ORMHChannel_Count; ++i)
+	{
+		const std::wstring& FILE_NAME = pFILE_NAMES[i];
+		key += L"|";
+		if (FILE_NAME.empty())
+		{
+			continue;
+		}
+
+		if (!ppEMBEDDED[i])
+		{
+			struct _stat64 sourceFileStat;
+			std::string fileNameA(FILE_NAME.begin(), FILE_NAME.end());
+			if (_stat64(fileNameA.c_str(), &sourceFileStat) == -1)
+			{
+				OutputDebugStringW(FILE_NAME.c_str());
+				OutputDebugStringA(" does not exists. Skip ORMH channel.\n");
+				continue;
+			}
+		}
+
+		fileNames[i] = FILE_NAME;
+		key += NormalizePath(FILE_NAME);
+		channelMask |= (1 << i);
+	}
+	key += s_VARIANT_KEYS[TextureUsage_ORMH];
+
+	*pChannelMask = channelMask;
+	if (channelMask == 0)
+	{
+		return false;
+	}
+
+	if (bindCachedEntry(pRenderer, key, pTexture, pUseFlag, pFlagBuffer, pOwner))
+	{
+		return true;
+	}
+
+	++m_Stats.MissCount;
+
+	ORMHSource sources[ORMHChannel_Count];
+	initORMHSources(fileNames, ppEMBEDDED, sources);
+
+#ifdef USE_ASSET_STREAMING
+	// embedded only maps are packed right away.
+	const int STREAMED_INDEX = getStreamedORMHSource(sources);
+	if (STREAMED_INDEX >= 0)
+	{
+		TextureLoadJob* pJob = createLoadJob(key, TextureUsage_ORMH, pTexture, pUseFlag, pFlagBuffer, pOwner);
+		for (UINT i = 0; i < ORMHChannel_Count; ++i)
+		{
+			pJob->ORMHSources[i] = std::move(sources[i]);
+		}
+
+		AssetStreamer* pStreamer = pRenderer->GetAssetStreamer();
+		pStreamer->Request(fileNames[STREAMED_INDEX].c_str(), StreamingPriority_Normal, decodeStreamingTexture, completeStreamingTexture, this, pJob);
+		return true;
+	}
+#else
+	if (m_bBatching)
+	{
+		TextureLoadJob* pJob = createLoadJob(key, TextureUsage_ORMH, pTexture, pUseFlag, pFlagBuffer, pOwner);
+		pJob->FileName = key;
+		for (UINT i = 0; i < ORMHChannel_Count; ++i)
+		{
+			pJob->ORMHSources[i] = std::move(sources[i]);
+		}
+
+		m_BatchJobs.push_back(pJob);
+		return true;
+	}
+#endif
+
+	return loadORMHEntry(pRenderer, key, sources, pTexture, pUseFlag);
+}
+
+void TextureCache::BeginBatch()
+{
+	_ASSERT(!m_bBatching);
+	m_bBatching = true;
+}
+
+void TextureCache::EndBatch(Renderer* pRenderer)
+{
+	_ASSERT(m_bBatching);
+	m_bBatching = false;
+
+	const UINT JOB_COUNT = (UINT)m_BatchJobs.size();
+	if (JOB_COUNT == 0)
+	{
+		return;
+	}
+
+#ifdef _DEBUG
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER beginTime;
+	LARGE_INTEGER endTime;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&beginTime);
+#endif
+
+	TextureBatchContext context;
+	context.ppJobs = m_BatchJobs.data();
+	context.JobCount = JOB_COUNT;
+	context.NextJobIndex = 0;
+	ParallelFor(JOB_COUNT, 1, loadBatchTextureRange, &context);
+
+#ifdef _DEBUG
+	QueryPerformanceCounter(&endTime);
+	UINT64 decodedPixelCount = 0;
+#endif
+
+	// uploads stay on main thread in request order, and go to GPU in one submission.
+	ResourceManager* pManager = pRenderer->GetResourceManager();
+	pManager->BeginUpload();
+	for (UINT i = 0; i < JOB_COUNT; ++i)
+	{
+		TextureLoadJob* pJob = m_BatchJobs[i];
+		if (SUCCEEDED(pJob->Result))
+		{
+			FinishLoading(pJob->pEntry, pRenderer, (pJob->Image.empty() ? nullptr : pJob->Image.data()), (UINT)pJob->Width, (UINT)pJob->Height, pJob->MipLevels, pJob->PixelFormat, pJob->ContentHash);
+#ifdef _DEBUG
+			decodedPixelCount += (UINT64)pJob->Width * pJob->Height;
+#endif
+		}
+		else
+		{
+			OutputDebugStringW(pJob->FileName.c_str());
+			OutputDebugStringA(" can't be decoded. Skip texture reading.\n");
+			FinishLoading(pJob->pEntry, nullptr, nullptr, 0, 0, 0, DXGI_FORMAT_UNKNOWN, 0);
+		}
+		delete pJob;
+	}
+	m_BatchJobs.clear();
+	pManager->EndUpload();
+
+#ifdef _DEBUG
+	const double ELAPSED_MILLISECONDS = (double)(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / (double)frequency.QuadPart;
+	char debugString[256];
+	sprintf_s(debugString, "TextureCache: decoded %u textures, %.1f MPixels in %.1fms on %u threads.\n",
+			  JOB_COUNT, (double)decodedPixelCount / 1000000.0, ELAPSED_MILLISECONDS, GetParallelRangeCount(JOB_COUNT, 1));
+	OutputDebugStringA(debugString);
+#endif
+}
+
+void TextureCache::CancelWaiters(void* pOwner)
+{
+	for (std::unordered_map<std::wstring, TextureCacheEntry*>::iterator iter = m_EntryMap.begin(); iter != m_EntryMap.end(); ++iter)
+	{
+		std::vector<TextureCacheWaiter>& waiters = iter->second->Waiters;
+
+		UINT64 writeIndex = 0;
+		for (UINT64 i = 0, size = waiters.size(); i < size; ++i)
+		{
+			if (waiters[i].pOwner != pOwner)
+			{
+				waiters[writeIndex++] = waiters[i];
+			}
+		}
+		waiters.resize(writeIndex);
+	}
+}
+
+void TextureCache::FinishLoading(TextureCacheEntry* pEntry, Renderer* pRenderer, const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT, const UINT64 CONTENT_HASH)
+{
+	_ASSERT(pEntry);
+	_ASSERT(pEntry->bLoading);
+
+	// failed, shutting down, or every waiter is gone.
+	if (!pRenderer || pEntry->Waiters.empty())
+	{
+		removeEntry(pEntry);
+		return;
+	}
+
+	// batch load skips decoding when contents are cached already.
+	TextureCacheEntry* pSameEntry = (CONTENT_HASH != 0 ? findByHash(CONTENT_HASH) : nullptr);
+	if (!pSameEntry && !pIMAGE)
+	{
+		removeEntry(pEntry);
+		return;
+	}
+
+	if (pSameEntry)
+	{
+		++m_Stats.HashHitCount;
+		pEntry->pResource = pSameEntry->pResource;
+	}
+	else
+	{
+		Texture* pFirstTexture = pEntry->Waiters[0].pTexture;
+		pFirstTexture->Initialize(pRenderer, pIMAGE, WIDTH, HEIGHT, FORMAT, MIP_LEVELS);
+		pEntry->pResource = pFirstTexture->GetResource();
+	}
+	pEntry->pResource->AddRef();
+	pEntry->SizeInBytes = (pSameEntry ? pSameEntry->SizeInBytes : GetMipChainSize(WIDTH, HEIGHT, MIP_LEVELS, FORMAT));
+	pEntry->bLoading = false;
+
+	if (CONTENT_HASH != 0)
+	{
+		pEntry->ContentHash = CONTENT_HASH;
+		if (!pSameEntry)
+		{
+			m_HashMap[CONTENT_HASH] = pEntry;
+		}
+	}
+
+	const UINT64 WAITER_COUNT = pEntry->Waiters.size();
+	m_Stats.LoadedBytes += (pSameEntry ? 0 : pEntry->SizeInBytes);
+	m_Stats.SavedBytes += pEntry->SizeInBytes * (pSameEntry ? WAITER_COUNT : WAITER_COUNT - 1);
+
+	for (UINT64 i = 0; i < WAITER_COUNT; ++i)
+	{
+		const TextureCacheWaiter& WAITER = pEntry->Waiters[i];
+		bindEntry(pRenderer, pEntry, WAITER.pTexture, WAITER.pUseFlag);
+		if (WAITER.pFlagBuffer)
+		{
+			// owner may already be drawing with flag off.
+			WAITER.pFlagBuffer->MarkDirty();
+		}
+	}
+	std::vector<TextureCacheWaiter>().swap(pEntry->Waiters);
+}
+
+void TextureCache::Trim()
+{
+	// entries found by content hash share resource with the entry they matched.
+	std::unordered_map<ID3D12Resource*, ULONG> entryCounts;
+	for (std::unordered_map<std::wstring, TextureCacheEntry*>::iterator iter = m_EntryMap.begin(); iter != m_EntryMap.end(); ++iter)
+	{
+		if (iter->second->pResource)
+		{
+			++entryCounts[iter->second->pResource];
+		}
+	}
+
+	std::vector<TextureCacheEntry*> unusedEntries;
+	for (std::unordered_map<std::wstring, TextureCacheEntry*>::iterator iter = m_EntryMap.begin(); iter != m_EntryMap.end(); ++iter)
+	{
+		TextureCacheEntry* pEntry = iter->second;
+		if (pEntry->bLoading || !pEntry->pResource)
+		{
+			continue;
+		}
+
+		// only cache holds it.
+		pEntry->pResource->AddRef();
+		if (pEntry->pResource->Release() == entryCounts[pEntry->pResource])
+		{
+			unusedEntries.push_back(pEntry);
+		}
+	}
+
+	for (UINT64 i = 0, size = unusedEntries.size(); i < size; ++i)
+	{
+		removeEntry(unusedEntries[i]);
+	}
+}
+
+void TextureCache::Cleanup()
+{
+#ifdef _DEBUG
+	if (m_Stats.HitCount + m_Stats.HashHitCount + m_Stats.MissCount > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "TextureCache: %u hits, %u content hits, %u misses. loaded %.1fMB, saved %.1fMB.\n",
+				  m_Stats.HitCount, m_Stats.HashHitCount, m_Stats.MissCount,
+				  (double)m_Stats.LoadedBytes / (1024.0 * 1024.0), (double)m_Stats.SavedBytes / (1024.0 * 1024.0));
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	while (!m_EntryMap.empty())
+	{
+		TextureCacheEntry* pEntry = m_EntryMap.begin()->second;
+
+		// AssetStreamer must be cleaned up first.
+		_ASSERT(!pEntry->bLoading);
+		removeEntry(pEntry);
+	}
+	m_HashMap.clear();
+	m_Stats = {};
+}
+
+// true when KEY is cached or being loaded.
+bool TextureCache::bindCachedEntry(Renderer* pRenderer, const std::wstring& KEY, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner)
+{
+	std::unordered_map<std::wstring, TextureCacheEntry*>::iterator iter = m_EntryMap.find(KEY);
+	if (iter == m_EntryMap.end())
+	{
+		return false;
+	}
+
+	TextureCacheEntry* pEntry = iter->second;
+	++m_Stats.HitCount;
+
+	if (pEntry->bLoading)
+	{
+		pEntry->Waiters.push_back({ pTexture, pUseFlag, pFlagBuffer, pOwner });
+	}
+	else
+	{
+		bindEntry(pRenderer, pEntry, pTexture, pUseFlag);
+		m_Stats.SavedBytes += pEntry->SizeInBytes;
+	}
+	return true;
+}
+
+TextureLoadJob* TextureCache::createLoadJob(const std::wstring& KEY, const eTextureUsage USAGE, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner)
+{
+	TextureCacheEntry* pNewEntry = addEntry(KEY, 0, nullptr);
+	pNewEntry->bLoading = true;
+	pNewEntry->Waiters.push_back({ pTexture, pUseFlag, pFlagBuffer, pOwner });
+
+	TextureLoadJob* pJob = new TextureLoadJob;
+	pJob->pCache = this;
+	pJob->pEntry = pNewEntry;
+	pJob->bHashContent = m_bUseContentHash;
+	pJob->Usage = USAGE;
+	pJob->Preset = m_CompressionPreset;
+	pJob->bFromMemory = false;
+	pJob->Width = 0;
+	pJob->Height = 0;
+	pJob->MipLevels = 1;
+	pJob->PixelFormat = getPixelFormat(USAGE);
+	pJob->ContentHash = 0;
+	pJob->pEMBEDDED = nullptr;
+	pJob->Result = E_FAIL;
+
+	return pJob;
+}
+
+bool TextureCache::loadEntry(Renderer* pRenderer, const std::wstring& KEY, const std::wstring& FILE_NAME, const eTextureUsage USAGE, const EmbeddedTexture* pEMBEDDED, Texture* pTexture, BOOL* pUseFlag)
+{
+	HRESULT hr = S_OK;
+	std::vector<UCHAR> fileData;
+	std::vector<UCHAR> image;
+	int width = 0;
+	int height = 0;
+	UINT mipLevels = 1;
+	DXGI_FORMAT pixelFormat = getPixelFormat(USAGE);
+	UINT64 contentHash = 0;
+
+	const std::vector<UCHAR>* pSrcData = &fileData;
+	if (pEMBEDDED)
+	{
+		pSrcData = &pEMBEDDED->Data;
+	}
+	else
+	{
+		hr = ReadWholeFile(FILE_NAME.c_str(), fileData);
+		if (FAILED(hr))
+		{
+			return false;
+		}
+	}
+
+	if (m_bUseContentHash)
+	{
+		contentHash = hashContent(*pSrcData, USAGE);
+
+		TextureCacheEntry* pSameEntry = findByHash(contentHash);
+		if (pSameEntry)
+		{
+			++m_Stats.HashHitCount;
+			m_Stats.SavedBytes += pSameEntry->SizeInBytes;
+			bindEntry(pRenderer, addEntry(KEY, contentHash, pSameEntry->pResource), pTexture, pUseFlag);
+			return true;
+		}
+	}
+
+	if (pEMBEDDED && pEMBEDDED->Width > 0)
+	{
+		image = pEMBEDDED->Data;
+		width = (int)pEMBEDDED->Width;
+		height = (int)pEMBEDDED->Height;
+		generateMips(image, pEMBEDDED->Width, pEMBEDDED->Height, pixelFormat, &mipLevels, true);
+#ifdef USE_TEXTURE_COMPRESSION
+		compressImage(&FILE_NAME, 1, false, USAGE, m_CompressionPreset, image, pEMBEDDED->Width, pEMBEDDED->Height, mipLevels, &pixelFormat, true);
+#endif
+	}
+	else
+	{
+		hr = decodeImage(FILE_NAME, *pSrcData, (pEMBEDDED != nullptr), USAGE, m_CompressionPreset, image, &width, &height, &pixelFormat, &mipLevels, true);
+		if (FAILED(hr))
+		{
+			OutputDebugStringW(FILE_NAME.c_str());
+			OutputDebugStringA(" can't be decoded. Skip texture reading.\n");
+			return false;
+		}
+	}
+	pTexture->Initialize(pRenderer, image.data(), (UINT)width, (UINT)height, pixelFormat, mipLevels);
+
+	TextureCacheEntry* pNewEntry = addEntry(KEY, contentHash, pTexture->GetResource());
+	m_Stats.LoadedBytes += pNewEntry->SizeInBytes;
+	*pUseFlag = TRUE;
+
+	return true;
+}
+
+bool TextureCache::loadORMHEntry(Renderer* pRenderer, const std::wstring& KEY, ORMHSource* pSources, Texture* pTexture, BOOL* pUseFlag)
+{
+	HRESULT hr = S_OK;
+	std::vector<UCHAR> image;
+	int width = 0;
+	int height = 0;
+	UINT mipLevels = 1;
+	DXGI_FORMAT pixelFormat = getPixelFormat(TextureUsage_ORMH);
+	UINT64 contentHash = 0;
+
+	hr = readORMHSources(pSources);
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	if (m_bUseContentHash)
+	{
+		contentHash = hashORMHSources(pSources);
+
+		TextureCacheEntry* pSameEntry = findByHash(contentHash);
+		if (pSameEntry)
+		{
+			++m_Stats.HashHitCount;
+			m_Stats.SavedBytes += pSameEntry->SizeInBytes;
+			bindEntry(pRenderer, addEntry(KEY, contentHash, pSameEntry->pResource), pTexture, pUseFlag);
+			return true;
+		}
+	}
+
+	hr = decodeORMHImage(pSources, m_CompressionPreset, image, &width, &height, &pixelFormat, &mipLevels, true);
+	if (FAILED(hr))
+	{
+		OutputDebugStringW(KEY.c_str());
+		OutputDebugStringA(" can't be decoded. Skip texture reading.\n");
+		return false;
+	}
+	pTexture->Initialize(pRenderer, image.data(), (UINT)width, (UINT)height, pixelFormat, mipLevels);
+
+	TextureCacheEntry* pNewEntry = addEntry(KEY, contentHash, pTexture->GetResource());
+	m_Stats.LoadedBytes += pNewEntry->SizeInBytes;
+	*pUseFlag = TRUE;
+
+	return true;
+}
+
+TextureCacheEntry* TextureCache::addEntry(const std::wstring& KEY, const UINT64 CONTENT_HASH, ID3D12Resource* pResource)
+{
+	TextureCacheEntry* pNewEntry = new TextureCacheEntry;
+	pNewEntry->Key = KEY;
+	pNewEntry->ContentHash = CONTENT_HASH;
+	pNewEntry->pResource = pResource;
+	pNewEntry->SizeInBytes = 0;
+	pNewEntry->bLoading = false;
+
+	if (pResource)
+	{
+		D3D12_RESOURCE_DESC desc = pResource->GetDesc();
+		pNewEntry->SizeInBytes = GetMipChainSize((UINT)desc.Width, desc.Height, desc.MipLevels, desc.Format);
+		pResource->AddRef();
+	}
+
+	m_EntryMap[KEY] = pNewEntry;
+	if (CONTENT_HASH != 0 && m_HashMap.find(CONTENT_HASH) == m_HashMap.end())
+	{
+		m_HashMap[CONTENT_HASH] = pNewEntry;
+	}
+
+	return pNewEntry;
+}
+
+void TextureCache::removeEntry(TextureCacheEntry* pEntry)
+{
+	_ASSERT(pEntry);
+
+	m_EntryMap.erase(pEntry->Key);
+
+	std::unordered_map<UINT64, TextureCacheEntry*>::iterator hashIter = m_HashMap.find(pEntry->ContentHash);
+	if (hashIter != m_HashMap.end() && hashIter->second == pEntry)
+	{
+		m_HashMap.erase(hashIter);
+	}
+
+	SAFE_RELEASE(pEntry->pResource);
+	delete pEntry;
+}
+
+void TextureCache::bindEntry(Renderer* pRenderer, TextureCacheEntry* pEntry, Texture* pTexture, BOOL* pUseFlag)
+{
+	_ASSERT(pEntry->pResource);
+
+	if (pTexture->GetResource() != pEntry->pResource)
+	{
+		pTexture->InitializeWithResource(pEntry->pResource);
+	}
+
+	// SetDescriptorHeap() already made null view for streamed texture. overwrite it.
+	D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = pTexture->GetSRVHandle();
+	if (srvHandle.ptr != 0xffffffffffffffff)
+	{
+		ID3D12Device5* pDevice = pRenderer->GetResourceManager()->m_pDevice;
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		CreateTextureSRV(pDevice, pEntry->pResource, srvDesc, srvHandle);
+	}
+
+	*pUseFlag = TRUE;
+}
+
+TextureCacheEntry* TextureCache::findByHash(const UINT64 CONTENT_HASH)
+{
+	std::unordered_map<UINT64, TextureCacheEntry*>::iterator iter = m_HashMap.find(CONTENT_HASH);
+	if (iter == m_HashMap.end())
+	{
+		return nullptr;
+	}
+	return iter->second;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <unordered_map>
+#include "Texture.h"
+
+class Renderer;
+class FrameConstantBuffer;
+struct EmbeddedTexture;
+struct TextureLoadJob;
+struct ORMHSource;
+
+struct TextureCacheWaiter
+{
+	Texture* pTexture;
+	BOOL* pUseFlag;
+	FrameConstantBuffer* pFlagBuffer;
+	void* pOwner;
+};
+
+struct TextureCacheEntry
+{
+	std::wstring Key;
+	UINT64 ContentHash; // 0 when not hashed.
+	ID3D12Resource* pResource; // cache holds one reference.
+	UINT64 SizeInBytes;
+
+	bool bLoading;
+	std::vector<TextureCacheWaiter> Waiters; // textures waiting for streamed load.
+};
+
+struct TextureCacheStats
+{
+	UINT HitCount; // same path.
+	UINT HashHitCount; // different path, same file contents.
+	UINT MissCount;
+	UINT64 LoadedBytes;
+	UINT64 SavedBytes; // uploads skipped by sharing.
+};
+
+// Shares image textures between materials. Keyed by normalized path + color space,
+// and optionally by file contents so copies of one file under different names are uploaded once.
+class TextureCache
+{
+public:
+	TextureCache() = default;
+	~TextureCache() { Cleanup(); }
+
+	// Binds cached or newly loaded resource to pTexture and sets *pUseFlag to TRUE.
+	// With USE_ASSET_STREAMING, loading finishes later on main thread. returns false if file can't be read.
+	// pFlagBuffer holds *pUseFlag and is marked dirty when flag is set after Acquire() returns. can be nullptr.
+	// pEMBEDDED is used instead of file when texture is inside model file.
+	// USAGE picks color space, and block format with USE_TEXTURE_COMPRESSION.
+	bool Acquire(Renderer* pRenderer, const std::wstring& FILE_NAME, const eTextureUsage USAGE, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner, const EmbeddedTexture* pEMBEDDED = nullptr);
+	// Packs scalar maps into one texture, see eORMHChannel. channel i is read from channel i of its source, height from r.
+	// pFILE_NAMES and ppEMBEDDED hold ORMHChannel_Count entries. channels without map get neutral value.
+	// *pChannelMask receives (1 << channel) bits of channels that have a map. returns false if there is none.
+	bool AcquireORMH(Renderer* pRenderer, const std::wstring* pFILE_NAMES, const EmbeddedTexture* const* ppEMBEDDED, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, UINT* pChannelMask, void* pOwner);
+	// Textures of pOwner will not be touched by pending loads.
+	void CancelWaiters(void* pOwner);
+
+	// Misses between BeginBatch() and EndBatch() are read and decoded in parallel at EndBatch().
+	// Textures are bound after EndBatch(). no effect with USE_ASSET_STREAMING.
+	void BeginBatch();
+	void EndBatch(Renderer* pRenderer);
+
+	// Main thread. pIMAGE nullptr means load failed or cancelled. pIMAGE holds MIP_LEVELS levels.
+	void FinishLoading(TextureCacheEntry* pEntry, Renderer* pRenderer, const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT, const UINT64 CONTENT_HASH);
+
+	// Releases entries no texture refers to.
+	void Trim();
+	void Cleanup();
+
+	inline void SetUseContentHash(bool bUseContentHash) { m_bUseContentHash = bUseContentHash; }
+	inline void SetCompressionPreset(const eTextureCompressionPreset PRESET) { m_CompressionPreset = PRESET; }
+	inline const TextureCacheStats& GetStats() { return m_Stats; }
+	inline bool HasContent(const UINT64 CONTENT_HASH) { return (m_HashMap.find(CONTENT_HASH) != m_HashMap.end()); }
+
+protected:
+	bool bindCachedEntry(Renderer* pRenderer, const std::wstring& KEY, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner);
+	TextureLoadJob* createLoadJob(const std::wstring& KEY, const eTextureUsage USAGE, Texture* pTexture, BOOL* pUseFlag, FrameConstantBuffer* pFlagBuffer, void* pOwner);
+	bool loadEntry(Renderer* pRenderer, const std::wstring& KEY, const std::wstring& FILE_NAME, const eTextureUsage USAGE, const EmbeddedTexture* pEMBEDDED, Texture* pTexture, BOOL* pUseFlag);
+	bool loadORMHEntry(Renderer* pRenderer, const std::wstring& KEY, ORMHSource* pSources, Texture* pTexture, BOOL* pUseFlag);
+	TextureCacheEntry* addEntry(const std::wstring& KEY, const UINT64 CONTENT_HASH, ID3D12Resource* pResource);
+	void removeEntry(TextureCacheEntry* pEntry);
+	void bindEntry(Renderer* pRenderer, TextureCacheEntry* pEntry, Texture* pTexture, BOOL* pUseFlag);
+	TextureCacheEntry* findByHash(const UINT64 CONTENT_HASH);
+
+private:
+	std::unordered_map<std::wstring, TextureCacheEntry*> m_EntryMap;
+	std::unordered_map<UINT64, TextureCacheEntry*> m_HashMap;
+
+	std::vector<TextureLoadJob*> m_BatchJobs;
+	bool m_bBatching = false;
+
+	bool m_bUseContentHash = true;
+	eTextureCompressionPreset m_CompressionPreset = TextureCompressionPreset_Fast;
+	TextureCacheStats m_Stats = {};
+};
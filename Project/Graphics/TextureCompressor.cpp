@@ -0,0 +1,364 @@
+#include "../pch.h"
+#include <DirectXTex.h>
+#include "ImageProcessing.h"
+#include "../Util/Utility.h"
+#include "TextureCompressor.h"
+
+struct CompressLevelJob
+{
+	DirectX::Image Source; // whole level.
+	DXGI_FORMAT Format;
+	DirectX::TEX_COMPRESS_FLAGS Flags;
+	UCHAR* pDst;
+	UINT64 BlockRowSize;
+	volatile LONG bFailed;
+};
+
+static const WCHAR* s_CACHE_TAGS[TextureUsage_Count] = { L"color", L"normal", L"r", L"g", L"b", L"ormh" };
+
+// empty when every name is empty.
+static std::wstring getCacheFileName(const std::wstring* pSOURCE_FILE_NAMES, const UINT SOURCE_COUNT, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET)
+{
+	std::wstring cacheFileName;
+	UINT64 sourceHash = HASH_SEED;
+	for (UINT i = 0; i < SOURCE_COUNT; ++i)
+	{
+		const std::wstring& SOURCE_FILE_NAME = pSOURCE_FILE_NAMES[i];
+		if (cacheFileName.empty())
+		{
+			cacheFileName = SOURCE_FILE_NAME;
+		}
+		sourceHash = HashBytes(SOURCE_FILE_NAME.c_str(), SOURCE_FILE_NAME.size() * sizeof(WCHAR), HashBytes(&i, sizeof(i), sourceHash));
+	}
+	if (cacheFileName.empty())
+	{
+		return cacheFileName;
+	}
+
+	cacheFileName += L".";
+	cacheFileName += s_CACHE_TAGS[USAGE];
+	if (SOURCE_COUNT > 1)
+	{
+		// same first source can be packed with different maps.
+		WCHAR szHash[24];
+		swprintf_s(szHash, L"_%016llx", sourceHash);
+		cacheFileName += szHash;
+	}
+	if (USAGE == TextureUsage_Color || USAGE == TextureUsage_ORMH)
+	{
+		cacheFileName += (PRESET == TextureCompressionPreset_Quality ? L"_quality" : L"_fast");
+	}
+	cacheFileName += L".dds";
+	return cacheFileName;
+}
+
+static bool getFileTime(const std::wstring& FILE_NAME, __time64_t* pTime)
+{
+	struct _stat64 fileStat;
+	if (_wstat64(FILE_NAME.c_str(), &fileStat) == -1)
+	{
+		return false;
+	}
+	*pTime = fileStat.st_mtime;
+	return true;
+}
+
+static void compressBlockRows(UINT begin, UINT end, UINT rangeIndex, void* pArg)
+{
+	CompressLevelJob* pJob = (CompressLevelJob*)pArg;
+
+	DirectX::Image strip = pJob->Source;
+	strip.height = (size_t)Min((int)(end * 4), (int)pJob->Source.height) - (size_t)begin * 4;
+	strip.pixels = pJob->Source.pixels + (size_t)begin * 4 * pJob->Source.rowPitch;
+	strip.slicePitch = strip.rowPitch * strip.height;
+
+	DirectX::ScratchImage compressed;
+	HRESULT hr = DirectX::Compress(strip, pJob->Format, pJob->Flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+	if (FAILED(hr) || compressed.GetPixelsSize() != (end - begin) * pJob->BlockRowSize)
+	{
+		InterlockedExchange(&pJob->bFailed, 1);
+		return;
+	}
+	memcpy(pJob->pDst + begin * pJob->BlockRowSize, compressed.GetPixels(), compressed.GetPixelsSize());
+}
+
+static double measurePSNR(const UCHAR* pSOURCE, const UCHAR* pCOMPRESSED, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT SRC_FORMAT, const DXGI_FORMAT DST_FORMAT, const UINT CHANNEL_COUNT)
+{
+	const UINT BLOCK_SIZE = GetBlockSize(DST_FORMAT);
+
+	DirectX::Image compressedImage;
+	compressedImage.width = WIDTH;
+	compressedImage.height = HEIGHT;
+	compressedImage.format = DST_FORMAT;
+	compressedImage.rowPitch = (size_t)((WIDTH + 3) / 4) * BLOCK_SIZE;
+	compressedImage.slicePitch = compressedImage.rowPitch * ((HEIGHT + 3) / 4);
+	compressedImage.pixels = (uint8_t*)pCOMPRESSED;
+
+	DirectX::ScratchImage decompressed;
+	if (FAILED(DirectX::Decompress(compressedImage, SRC_FORMAT, decompressed)))
+	{
+		return 0.0;
+	}
+
+	const UCHAR* pDECOMPRESSED = decompressed.GetPixels();
+	const UINT64 PIXEL_COUNT = (UINT64)WIDTH * HEIGHT;
+	double squaredError = 0.0;
+	for (UINT64 i = 0; i < PIXEL_COUNT; ++i)
+	{
+		for (UINT c = 0; c < CHANNEL_COUNT; ++c)
+		{
+			double diff = (double)pSOURCE[i * 4 + c] - (double)pDECOMPRESSED[i * 4 + c];
+			squaredError += diff * diff;
+		}
+	}
+
+	double meanSquaredError = squaredError / (double)(PIXEL_COUNT * CHANNEL_COUNT);
+	if (meanSquaredError <= 0.0)
+	{
+		return 99.0;
+	}
+	return 10.0 * log10(255.0 * 255.0 / meanSquaredError);
+}
+
+DXGI_FORMAT GetCompressedFormat(const eTextureUsage USAGE, const eTextureCompressionPreset PRESET, const UINT WIDTH, const UINT HEIGHT, bool bHasAlpha)
+{
+	// d3d12 needs whole blocks on top level.
+	if (WIDTH % 4 != 0 || HEIGHT % 4 != 0)
+	{
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	switch (USAGE)
+	{
+		case TextureUsage_Color:
+			if (PRESET == TextureCompressionPreset_Quality)
+			{
+				return DXGI_FORMAT_BC7_UNORM_SRGB;
+			}
+			return (bHasAlpha ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM_SRGB);
+
+		case TextureUsage_Normal:
+			return DXGI_FORMAT_BC5_UNORM;
+
+		case TextureUsage_ScalarR:
+		case TextureUsage_ScalarG:
+		case TextureUsage_ScalarB:
+			return DXGI_FORMAT_BC4_UNORM;
+
+		case TextureUsage_ORMH:
+			// channels are unrelated. BC1/BC3 share color endpoints between them.
+			return DXGI_FORMAT_BC7_UNORM;
+
+		default:
+			break;
+	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+bool HasAlpha(const UCHAR* pIMAGE, const UINT64 PIXEL_COUNT)
+{
+	_ASSERT(pIMAGE);
+
+	for (UINT64 i = 0; i < PIXEL_COUNT; ++i)
+	{
+		if (pIMAGE[i * 4 + 3] != 255)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+HRESULT CompressImage(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT SRC_FORMAT,
+					  const eTextureUsage USAGE, const DXGI_FORMAT DST_FORMAT, const eTextureCompressionPreset PRESET, bool bUseMultiThread, double* pPSNR)
+{
+	if ((SRC_FORMAT != DXGI_FORMAT_R8G8B8A8_UNORM && SRC_FORMAT != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) || GetBlockSize(DST_FORMAT) == 0)
+	{
+		return E_INVALIDARG;
+	}
+
+	// each range gets about this many source pixels.
+	const UINT MIN_PIXELS_PER_RANGE = 64 * 1024;
+	const UINT BLOCK_SIZE = GetBlockSize(DST_FORMAT);
+	const UCHAR* pSource = image.data();
+	std::vector<UCHAR> swizzled;
+	std::vector<UCHAR> compressed(GetMipChainSize(WIDTH, HEIGHT, MIP_LEVELS, DST_FORMAT));
+
+	// BC4 encodes red.
+	if (USAGE == TextureUsage_ScalarG || USAGE == TextureUsage_ScalarB)
+	{
+		const UINT CHANNEL = (USAGE == TextureUsage_ScalarG ? 1 : 2);
+		swizzled = image;
+		for (UINT64 i = 0, size = swizzled.size() / 4; i < size; ++i)
+		{
+			swizzled[i * 4] = swizzled[i * 4 + CHANNEL];
+		}
+		pSource = swizzled.data();
+	}
+
+	CompressLevelJob job;
+	job.Format = DST_FORMAT;
+	job.Flags = DirectX::TEX_COMPRESS_DEFAULT;
+	job.bFailed = 0;
+	if (USAGE != TextureUsage_Color)
+	{
+		// no perceptual weighting for data.
+		job.Flags = DirectX::TEX_COMPRESS_UNIFORM;
+	}
+	if (USAGE == TextureUsage_ORMH && PRESET == TextureCompressionPreset_Fast)
+	{
+		job.Flags = (DirectX::TEX_COMPRESS_FLAGS)(job.Flags | DirectX::TEX_COMPRESS_BC7_QUICK);
+	}
+
+	UINT width = WIDTH;
+	UINT height = HEIGHT;
+	UINT64 srcOffset = 0;
+	UINT64 dstOffset = 0;
+	for (UINT i = 0; i < MIP_LEVELS; ++i)
+	{
+		const UINT BLOCK_ROW_COUNT = (height + 3) / 4;
+
+		job.Source.width = width;
+		job.Source.height = height;
+		job.Source.format = SRC_FORMAT;
+		job.Source.rowPitch = (size_t)width * 4;
+		job.Source.slicePitch = job.Source.rowPitch * height;
+		job.Source.pixels = (uint8_t*)(pSource + srcOffset);
+		job.pDst = compressed.data() + dstOffset;
+		job.BlockRowSize = (UINT64)((width + 3) / 4) * BLOCK_SIZE;
+
+		if (bUseMultiThread)
+		{
+			ParallelFor(BLOCK_ROW_COUNT, (UINT)Max((int)(MIN_PIXELS_PER_RANGE / (width * 4)), 1), compressBlockRows, &job);
+		}
+		else
+		{
+			compressBlockRows(0, BLOCK_ROW_COUNT, 0, &job);
+		}
+		if (job.bFailed)
+		{
+			return E_FAIL;
+		}
+
+		srcOffset += job.Source.slicePitch;
+		dstOffset += job.BlockRowSize * BLOCK_ROW_COUNT;
+		width = (width > 1 ? width / 2 : 1);
+		height = (height > 1 ? height / 2 : 1);
+	}
+
+	if (pPSNR)
+	{
+		UINT channelCount = 1;
+		if (USAGE == TextureUsage_Color || USAGE == TextureUsage_ORMH)
+		{
+			channelCount = 4;
+		}
+		else if (USAGE == TextureUsage_Normal)
+		{
+			channelCount = 2;
+		}
+		*pPSNR = measurePSNR(pSource, compressed.data(), WIDTH, HEIGHT, SRC_FORMAT, DST_FORMAT, channelCount);
+	}
+
+	image.swap(compressed);
+	return S_OK;
+}
+
+HRESULT ReadCompressedCache(const std::wstring* pSOURCE_FILE_NAMES, const UINT SOURCE_COUNT, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+							std::vector<UCHAR>& image, UINT* pWidth, UINT* pHeight, UINT* pMipLevels, DXGI_FORMAT* pFormat)
+{
+	HRESULT hr = S_OK;
+	const std::wstring CACHE_FILE_NAME = getCacheFileName(pSOURCE_FILE_NAMES, SOURCE_COUNT, USAGE, PRESET);
+	__time64_t sourceTime = 0;
+	__time64_t cacheTime = 0;
+	DirectX::TexMetadata metaData;
+	DirectX::ScratchImage scratchImage;
+	UINT64 offset = 0;
+
+	if (CACHE_FILE_NAME.empty() || !getFileTime(CACHE_FILE_NAME, &cacheTime))
+	{
+		hr = E_FAIL;
+		goto LB_RET;
+	}
+	for (UINT i = 0; i < SOURCE_COUNT; ++i)
+	{
+		if (pSOURCE_FILE_NAMES[i].empty())
+		{
+			continue;
+		}
+		if (!getFileTime(pSOURCE_FILE_NAMES[i], &sourceTime) || cacheTime < sourceTime)
+		{
+			hr = E_FAIL;
+			goto LB_RET;
+		}
+	}
+
+	hr = DirectX::LoadFromDDSFile(CACHE_FILE_NAME.c_str(), DirectX::DDS_FLAGS_NONE, &metaData, scratchImage);
+	if (FAILED(hr))
+	{
+		goto LB_RET;
+	}
+	if (metaData.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || metaData.arraySize != 1 || GetBlockSize(metaData.format) == 0)
+	{
+		hr = E_FAIL;
+		goto LB_RET;
+	}
+
+	image.resize(GetMipChainSize((UINT)metaData.width, (UINT)metaData.height, (UINT)metaData.mipLevels, metaData.format));
+	for (size_t i = 0; i < metaData.mipLevels; ++i)
+	{
+		const DirectX::Image* pLEVEL = scratchImage.GetImage(i, 0, 0);
+		memcpy(image.data() + offset, pLEVEL->pixels, pLEVEL->slicePitch);
+		offset += pLEVEL->slicePitch;
+	}
+
+	*pWidth = (UINT)metaData.width;
+	*pHeight = (UINT)metaData.height;
+	*pMipLevels = (UINT)metaData.mipLevels;
+	*pFormat = metaData.format;
+
+LB_RET:
+	return hr;
+}
+
+HRESULT WriteCompressedCache(const std::wstring* pSOURCE_FILE_NAMES, const UINT SOURCE_COUNT, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+							 const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT)
+{
+	_ASSERT(pIMAGE);
+
+	const std::wstring CACHE_FILE_NAME = getCacheFileName(pSOURCE_FILE_NAMES, SOURCE_COUNT, USAGE, PRESET);
+	if (CACHE_FILE_NAME.empty())
+	{
+		return E_INVALIDARG;
+	}
+
+	const UINT BLOCK_SIZE = GetBlockSize(FORMAT);
+	std::vector<DirectX::Image> levels(MIP_LEVELS);
+	DirectX::TexMetadata metaData = {};
+	metaData.width = WIDTH;
+	metaData.height = HEIGHT;
+	metaData.depth = 1;
+	metaData.arraySize = 1;
+	metaData.mipLevels = MIP_LEVELS;
+	metaData.format = FORMAT;
+	metaData.dimension = DirectX::TEX_DIMENSION_TEXTURE2D;
+
+	UINT width = WIDTH;
+	UINT height = HEIGHT;
+	UINT64 offset = 0;
+	for (UINT i = 0; i < MIP_LEVELS; ++i)
+	{
+		levels[i].width = width;
+		levels[i].height = height;
+		levels[i].format = FORMAT;
+		levels[i].rowPitch = (size_t)((width + 3) / 4) * BLOCK_SIZE;
+		levels[i].slicePitch = levels[i].rowPitch * ((height + 3) / 4);
+		levels[i].pixels = (uint8_t*)(pIMAGE + offset);
+
+		offset += levels[i].slicePitch;
+		width = (width > 1 ? width / 2 : 1);
+		height = (height > 1 ? height / 2 : 1);
+	}
+
+	return DirectX::SaveToDDSFile(levels.data(), levels.size(), metaData, DirectX::DDS_FLAGS_NONE, CACHE_FILE_NAME.c_str());
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Block compression of material textures at import, see USE_TEXTURE_COMPRESSION.
+// color -> BC1/BC3 or BC7 by preset, normal -> BC5, scalar maps -> BC4, packed ORMH -> BC7.
+// Output is cached as <source>.<usage>.dds next to first source file.
+
+// DXGI_FORMAT_UNKNOWN when image stays uncompressed. top level must be multiple of 4.
+DXGI_FORMAT GetCompressedFormat(const eTextureUsage USAGE, const eTextureCompressionPreset PRESET, const UINT WIDTH, const UINT HEIGHT, bool bHasAlpha);
+// any alpha below 255. RGBA8.
+bool HasAlpha(const UCHAR* pIMAGE, const UINT64 PIXEL_COUNT);
+
+// image holds MIP_LEVELS RGBA8 levels and receives blocks of all levels. unchanged on failure.
+// scalar usages keep their own channel. block rows are split over threads when bUseMultiThread.
+// pPSNR receives level 0 PSNR(dB) over kept channels. nullptr skips the measurement.
+HRESULT CompressImage(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT SRC_FORMAT,
+					  const eTextureUsage USAGE, const DXGI_FORMAT DST_FORMAT, const eTextureCompressionPreset PRESET, bool bUseMultiThread, double* pPSNR);
+
+// pSOURCE_FILE_NAMES are files image is made from. empty names are skipped.
+// fails when cache is missing or older than any source.
+HRESULT ReadCompressedCache(const std::wstring* pSOURCE_FILE_NAMES, const UINT SOURCE_COUNT, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+							std::vector<UCHAR>& image, UINT* pWidth, UINT* pHeight, UINT* pMipLevels, DXGI_FORMAT* pFormat);
+HRESULT WriteCompressedCache(const std::wstring* pSOURCE_FILE_NAMES, const UINT SOURCE_COUNT, const eTextureUsage USAGE, const eTextureCompressionPreset PRESET,
+							 const UCHAR* pIMAGE, const UINT WIDTH, const UINT HEIGHT, const UINT MIP_LEVELS, const DXGI_FORMAT FORMAT);
@@ -95,22 +95,22 @@ void MakeSquare(MeshInfo* pDst, const float SCALE, const Vector2 TEX_SCALE)
 	pDst->Vertices[0].Position = Vector3(-1.0f, 1.0f, 0.0f) * SCALE;
 	pDst->Vertices[0].Normal = Vector3(0.0f, 0.0f, -1.0f);
 	pDst->Vertices[0].Texcoord = Vector2(0.0f, 0.0f) * TEX_SCALE;
-	pDst->Vertices[0].Tangent = Vector3(1.0f, 0.0f, 0.0f);
+	pDst->Vertices[0].Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
 
 	pDst->Vertices[1].Position = Vector3(1.0f, 1.0f, 0.0f) * SCALE;
 	pDst->Vertices[1].Normal = Vector3(0.0f, 0.0f, -1.0f);
 	pDst->Vertices[1].Texcoord = Vector2(1.0f, 0.0f) * TEX_SCALE;
-	pDst->Vertices[1].Tangent = Vector3(1.0f, 0.0f, 0.0f);
+	pDst->Vertices[1].Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
 
 	pDst->Vertices[2].Position = Vector3(1.0f, -1.0f, 0.0f) * SCALE;
 	pDst->Vertices[2].Normal = Vector3(0.0f, 0.0f, -1.0f);
 	pDst->Vertices[2].Texcoord = Vector2(1.0f, 1.0f) * TEX_SCALE;
-	pDst->Vertices[2].Tangent = Vector3(1.0f, 0.0f, 0.0f);
+	pDst->Vertices[2].Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
 
 	pDst->Vertices[3].Position = Vector3(-1.0f, -1.0f, 0.0f) * SCALE;
 	pDst->Vertices[3].Normal = Vector3(0.0f, 0.0f, -1.0f);
 	pDst->Vertices[3].Texcoord = Vector2(0.0f, 1.0f) * TEX_SCALE;
-	pDst->Vertices[3].Tangent = Vector3(1.0f, 0.0f, 0.0f);
+	pDst->Vertices[3].Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
 
 	pDst->Indices = { 0, 1, 2, 0, 2, 3, };
 }
@@ -135,7 +135,7 @@ void MakeSquareGrid(MeshInfo* pDst, const int NUM_SLICES, const int NUM_STACKS,
 			v.Position = Vector3(x, y, 0.0f) * SCALE;
 			v.Normal = Vector3(0.0f, 0.0f, -1.0f);
 			v.Texcoord = Vector2(x + 1.0f, y + 1.0f) * 0.5f * TEX_SCALE;
-			v.Tangent = Vector3(1.0f, 0.0f, 0.0f);
+			v.Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
 
 			x += dx;
 		}
@@ -636,8 +636,9 @@ void MakeSphere(MeshInfo* pDst, const float RADIUS, const int NUM_SLICES, const
 			Vector3 normalOrth = v.Normal - biTangent.Dot(v.Normal) * v.Normal;
 			normalOrth.Normalize();
 
-			v.Tangent = biTangent.Cross(normalOrth);
-			v.Tangent.Normalize();
+			Vector3 tangent = biTangent.Cross(normalOrth);
+			tangent.Normalize();
+			v.Tangent = Vector4(tangent.x, tangent.y, tangent.z, 1.0f);
 		}
 	}
 
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "../pch.h"
+#include "../Renderer/GPUBufferPool.h"
+#include "../Renderer/BindlessDescriptorPool.h"
+#include "../Graphics/ConstantDataType.h"
 #include "../Graphics/ConstantBuffer.h"
 #include "../Graphics/Texture.h"
+#include "MeshletBuilder.h"
 
 // Vertex and Index Info
 struct BufferInfo
 {
-	ID3D12Resource* pBuffer = nullptr;
+	GPUBufferAllocation Allocation; // range of resource manager's default buffer pool.
 	union
 	{
 		D3D12_VERTEX_BUFFER_VIEW VertexBufferView;
@@ -20,10 +24,7 @@ struct Material
 	Texture Albedo;
 	Texture Emissive;
 	Texture Normal;
-	Texture Height;
-	Texture AmbientOcclusion;
-	Texture Metallic;
-	Texture Roughness;
+	Texture ORMH; // ambient occlusion, roughness, metallic, height packed in r, g, b, a.
 };
 class Mesh
 {
@@ -31,28 +32,64 @@ public:
 	Mesh() = default;
 	~Mesh()
 	{
-		if (Vertex.pBuffer)
+		freeBuffer(&Vertex);
+		freeBuffer(&DepthOnlyVertex);
+		freeBuffer(&Index);
+		for (UINT i = 0; i < MAX_MESH_LOD_COUNT - 1; ++i)
 		{
-			Vertex.pBuffer->Release();
-			Vertex.pBuffer = nullptr;
+			freeBuffer(&LODIndices[i]);
 		}
-		if (Index.pBuffer)
+
+		if (pBindlessPool)
 		{
-			Index.pBuffer->Release();
-			Index.pBuffer = nullptr;
+			pBindlessPool->Unregister(Material.Albedo.GetSRVHandle());
+			pBindlessPool->Unregister(Material.Emissive.GetSRVHandle());
+			pBindlessPool->Unregister(Material.Normal.GetSRVHandle());
+			pBindlessPool->Unregister(Material.ORMH.GetSRVHandle());
+			pBindlessPool = nullptr;
 		}
 
 		MeshConstant.Cleanup();
 		MaterialConstant.Cleanup();
 	}
 
+	inline BufferInfo* GetCurrentIndex() { return (CurrentLOD == 0 ? &Index : &LODIndices[CurrentLOD - 1]); }
+	// static mesh without depth only stream falls back to full vertex. position is at offset 0 in both.
+	inline BufferInfo* GetDepthOnlyVertex() { return (DepthOnlyVertex.Allocation.pResource ? &DepthOnlyVertex : &Vertex); }
+
 public:
 	BufferInfo Vertex;
+	BufferInfo DepthOnlyVertex; // position(+skin) only stream for depth only passes.
 	BufferInfo Index;
+	BufferInfo LODIndices[MAX_MESH_LOD_COUNT - 1]; // LOD 1 ~. shares vertex buffer.
+	float LODErrors[MAX_MESH_LOD_COUNT - 1] = { 0.0f, };
+	UINT LODCount = 1;
+	UINT CurrentLOD = 0;
+
+	std::vector<Meshlet> Meshlets;
+	std::vector<MeshletDrawRange> VisibleRanges; // updated per frame.
+	bool bUseClusterCulling = false;
 	Material Material;
 
-	ConstantBuffer MeshConstant;
-	ConstantBuffer MaterialConstant;
+	// Upload() every frame the mesh is drawn, MarkDirty() after writing pData. clean ones are not copied.
+	FrameConstantBuffer MeshConstant;
+	FrameConstantBuffer MaterialConstant;
+
+	// slots of material textures(and bone buffer of skinned model) in bindless range, passed as root constants.
+	// fields stay BINDLESS_NULL_DESCRIPTOR_INDEX for meshes without registered textures, e.g. helper meshes.
+	BindlessIndexRecord IndexRecord;
+	BindlessDescriptorPool* pBindlessPool = nullptr; // set when material textures are registered.
+	// views are copied into their slots again when MaterialConstant version moves, which covers streamed textures replacing SRVs.
+	UINT64 IndexRecordVersion = 0;
 
 	bool bSkinnedMesh = false;
+
+protected:
+	inline void freeBuffer(BufferInfo* pBufferInfo)
+	{
+		if (pBufferInfo->Allocation.pPool)
+		{
+			pBufferInfo->Allocation.pPool->Free(&pBufferInfo->Allocation);
+		}
+	}
 };
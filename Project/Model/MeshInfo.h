@@ -2,8 +2,36 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "Vertex.h"
 
+#define MAX_MESH_LOD_COUNT 4
+
+struct MeshLOD
+{
+	std::vector<UINT> Indices;
+	float Error = 0.0f; // object space geometric error.
+};
+struct Meshlet
+{
+	UINT IndexOffset;
+	UINT TriangleCount;
+	UINT VertexCount;
+
+	// culling data.
+	Vector3 Center;
+	float Radius;
+	Vector3 ConeAxis;
+	float ConeCutoff; // sin(cone half angle). 1.0f means backface cone is not usable.
+};
+// Texture stored inside model file. Shared by meshes of the model.
+struct EmbeddedTexture
+{
+	std::wstring Name; // same as texture file name in MeshInfo.
+	std::vector<UCHAR> Data; // encoded file(png, jpg..) if Width is 0, otherwise RGBA8 pixels.
+	UINT Width;
+	UINT Height;
+};
 struct MeshInfo
 {
 	std::vector<Vertex> Vertices;
@@ -17,6 +45,9 @@ struct MeshInfo
 	std::wstring szMetallicTextureFileName;
 	std::wstring szRoughnessTextureFileName;
 	std::wstring szOpacityTextureFileName;
+	std::vector<MeshLOD> LODs; // LOD 1 ~. LOD 0 is Indices.
+	std::vector<Meshlet> Meshlets; // triangle ranges of Indices.
+	std::vector<std::shared_ptr<EmbeddedTexture>> EmbeddedTextures;
 };
 
 #define INIT_MESH_INFO							 \
@@ -32,6 +63,9 @@ static void ReleaseMeshInfo(MeshInfo** ppMeshInfo)
 	(*ppMeshInfo)->Vertices.clear();
 	(*ppMeshInfo)->SkinnedVertices.clear();
 	(*ppMeshInfo)->Indices.clear();
+	(*ppMeshInfo)->LODs.clear();
+	(*ppMeshInfo)->Meshlets.clear();
+	(*ppMeshInfo)->EmbeddedTextures.clear();
 
 	free(*ppMeshInfo);
 	*ppMeshInfo = nullptr;
@@ -0,0 +1,456 @@
+#include "../pch.h"
+#include <algorithm>
+#include "../Util/Utility.h"
+#include "MeshSimplifier.h"
+
+struct Quadric
+{
+	// symmetric 4x4. plane (n, d) -> n*n^T, n*d, d*d.
+	double A00, A01, A02, A11, A12, A22;
+	double B0, B1, B2;
+	double C;
+	double Weight;
+};
+struct Collapse
+{
+	UINT Src;
+	UINT Dst;
+	float Cost;  // geometric error + attribute penalty.
+	float Error; // geometric error only.
+};
+
+static void addQuadric(Quadric* pDst, const Quadric& SRC)
+{
+	pDst->A00 += SRC.A00; pDst->A01 += SRC.A01; pDst->A02 += SRC.A02;
+	pDst->A11 += SRC.A11; pDst->A12 += SRC.A12; pDst->A22 += SRC.A22;
+	pDst->B0 += SRC.B0; pDst->B1 += SRC.B1; pDst->B2 += SRC.B2;
+	pDst->C += SRC.C;
+	pDst->Weight += SRC.Weight;
+}
+
+static void addPlaneQuadric(Quadric* pDst, const Vector3& P0, const Vector3& P1, const Vector3& P2)
+{
+	Vector3 normal = (P1 - P0).Cross(P2 - P0);
+	float length = normal.Length();
+	if (length < 1e-12f)
+	{
+		return;
+	}
+	normal /= length;
+
+	// area weighted.
+	double weight = (double)length * 0.5;
+	double a = normal.x;
+	double b = normal.y;
+	double c = normal.z;
+	double d = -(double)normal.Dot(P0);
+
+	pDst->A00 += weight * a * a; pDst->A01 += weight * a * b; pDst->A02 += weight * a * c;
+	pDst->A11 += weight * b * b; pDst->A12 += weight * b * c; pDst->A22 += weight * c * c;
+	pDst->B0 += weight * a * d; pDst->B1 += weight * b * d; pDst->B2 += weight * c * d;
+	pDst->C += weight * d * d;
+	pDst->Weight += weight;
+}
+
+// returns weighted mean of squared distance to planes.
+static float evaluateQuadric(const Quadric& QUADRIC, const Vector3& POS)
+{
+	if (QUADRIC.Weight <= 0.0)
+	{
+		return 0.0f;
+	}
+
+	double x = POS.x;
+	double y = POS.y;
+	double z = POS.z;
+	double result = QUADRIC.A00 * x * x + 2.0 * QUADRIC.A01 * x * y + 2.0 * QUADRIC.A02 * x * z +
+					QUADRIC.A11 * y * y + 2.0 * QUADRIC.A12 * y * z + QUADRIC.A22 * z * z +
+					2.0 * (QUADRIC.B0 * x + QUADRIC.B1 * y + QUADRIC.B2 * z) + QUADRIC.C;
+
+	return (float)(fabs(result) / QUADRIC.Weight);
+}
+
+static float getBlendWeightDistance(const SkinnedVertex& V1, const SkinnedVertex& V2)
+{
+	float distance = 0.0f;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		float other = 0.0f;
+		for (int j = 0; j < 8; ++j)
+		{
+			if (V2.BlendWeights[j] > 0.0f && V2.BoneIndices[j] == V1.BoneIndices[i])
+			{
+				other = V2.BlendWeights[j];
+				break;
+			}
+		}
+		distance += fabs(V1.BlendWeights[i] - other);
+	}
+
+	return distance;
+}
+
+// welds vertices sharing same position. pRemap[i] -> representative vertex.
+static void buildPositionRemap(const std::vector<Vertex>& VERTICES, std::vector<UINT>* pRemap, std::vector<UINT>* pWedgeCount)
+{
+	const UINT VERTEX_COUNT = (UINT)VERTICES.size();
+	std::vector<UINT> order(VERTEX_COUNT);
+
+	for (UINT i = 0; i < VERTEX_COUNT; ++i)
+	{
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&VERTICES](UINT a, UINT b)
+			  {
+				  const Vector3& A = VERTICES[a].Position;
+				  const Vector3& B = VERTICES[b].Position;
+				  if (A.x != B.x) return A.x < B.x;
+				  if (A.y != B.y) return A.y < B.y;
+				  if (A.z != B.z) return A.z < B.z;
+				  return a < b;
+			  });
+
+	pRemap->resize(VERTEX_COUNT);
+	pWedgeCount->assign(VERTEX_COUNT, 0);
+
+	UINT first = 0;
+	for (UINT i = 0; i < VERTEX_COUNT; ++i)
+	{
+		if (i == 0 || VERTICES[order[i]].Position != VERTICES[order[i - 1]].Position)
+		{
+			first = order[i];
+		}
+		(*pRemap)[order[i]] = first;
+		++(*pWedgeCount)[first];
+	}
+}
+
+static bool hasFlippedTriangle(const std::vector<Vertex>& VERTICES, const std::vector<UINT>& INDICES, const UINT* pTRIANGLES, const UINT TRIANGLE_COUNT, const UINT SRC, const UINT DST)
+{
+	const Vector3& SRC_POS = VERTICES[SRC].Position;
+	const Vector3& DST_POS = VERTICES[DST].Position;
+
+	for (UINT i = 0; i < TRIANGLE_COUNT; ++i)
+	{
+		const UINT* pTRI = &INDICES[pTRIANGLES[i] * 3];
+		if (pTRI[0] == DST || pTRI[1] == DST || pTRI[2] == DST)
+		{
+			continue; // will be removed.
+		}
+
+		Vector3 p[3] = { VERTICES[pTRI[0]].Position, VERTICES[pTRI[1]].Position, VERTICES[pTRI[2]].Position };
+		Vector3 before = (p[1] - p[0]).Cross(p[2] - p[0]);
+
+		for (int j = 0; j < 3; ++j)
+		{
+			if (pTRI[j] == SRC)
+			{
+				p[j] = DST_POS;
+			}
+		}
+		Vector3 after = (p[1] - p[0]).Cross(p[2] - p[0]);
+
+		if (before.Dot(after) <= 0.0f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+UINT SimplifyMesh(const MeshInfo& MESH_INFO, const std::vector<UINT>& SRC_INDICES, const UINT TARGET_INDEX_COUNT, const LODSetting& SETTING, std::vector<UINT>& dstIndices, float* pResultError)
+{
+	_ASSERT(pResultError);
+
+	const std::vector<Vertex>& VERTICES = MESH_INFO.Vertices;
+	const std::vector<SkinnedVertex>& SKINNED_VERTICES = MESH_INFO.SkinnedVertices;
+	const UINT VERTEX_COUNT = (UINT)VERTICES.size();
+	const bool bIS_SKINNED = (SKINNED_VERTICES.size() == VERTICES.size());
+	const float MAX_ERROR_SQ = SETTING.MaxError * SETTING.MaxError;
+
+	float resultErrorSq = 0.0f;
+
+	dstIndices = SRC_INDICES;
+	*pResultError = 0.0f;
+
+	if (VERTEX_COUNT == 0 || dstIndices.size() <= TARGET_INDEX_COUNT)
+	{
+		return (UINT)dstIndices.size();
+	}
+
+	std::vector<UINT> remap;
+	std::vector<UINT> wedgeCount;
+	buildPositionRemap(VERTICES, &remap, &wedgeCount);
+
+	// lock seams(uv, normal split) and borders.
+	std::vector<bool> bLocked(VERTEX_COUNT, false);
+	{
+		std::vector<UINT64> edges;
+		edges.reserve(dstIndices.size());
+		for (UINT64 i = 0, size = dstIndices.size(); i < size; i += 3)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				UINT64 a = remap[dstIndices[i + j]];
+				UINT64 b = remap[dstIndices[i + (j + 1) % 3]];
+				edges.push_back(a < b ? ((a << 32) | b) : ((b << 32) | a));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		for (UINT64 i = 0, size = edges.size(); i < size;)
+		{
+			UINT64 j = i + 1;
+			while (j < size && edges[j] == edges[i])
+			{
+				++j;
+			}
+			if (j - i != 2)
+			{
+				bLocked[(UINT)(edges[i] >> 32)] = true;
+				bLocked[(UINT)(edges[i] & 0xffffffff)] = true;
+			}
+			i = j;
+		}
+
+		for (UINT i = 0; i < VERTEX_COUNT; ++i)
+		{
+			if (wedgeCount[remap[i]] > 1)
+			{
+				bLocked[remap[i]] = true;
+			}
+		}
+		for (UINT i = 0; i < VERTEX_COUNT; ++i)
+		{
+			bLocked[i] = bLocked[remap[i]];
+		}
+	}
+
+	std::vector<Quadric> quadrics(VERTEX_COUNT);
+	memset(quadrics.data(), 0, sizeof(Quadric) * VERTEX_COUNT);
+	for (UINT64 i = 0, size = dstIndices.size(); i < size; i += 3)
+	{
+		const Vector3& P0 = VERTICES[dstIndices[i]].Position;
+		const Vector3& P1 = VERTICES[dstIndices[i + 1]].Position;
+		const Vector3& P2 = VERTICES[dstIndices[i + 2]].Position;
+
+		Quadric faceQuadric = {};
+		addPlaneQuadric(&faceQuadric, P0, P1, P2);
+		addQuadric(&quadrics[remap[dstIndices[i]]], faceQuadric);
+		addQuadric(&quadrics[remap[dstIndices[i + 1]]], faceQuadric);
+		addQuadric(&quadrics[remap[dstIndices[i + 2]]], faceQuadric);
+	}
+
+	std::vector<Collapse> collapses;
+	std::vector<UINT> triangleOffsets(VERTEX_COUNT + 1);
+	std::vector<UINT> triangles;
+	std::vector<UINT> collapseTarget(VERTEX_COUNT);
+	std::vector<bool> bTouched(VERTEX_COUNT);
+
+	while (dstIndices.size() > TARGET_INDEX_COUNT)
+	{
+		const UINT TRIANGLE_COUNT = (UINT)(dstIndices.size() / 3);
+
+		// vertex -> triangle adjacency.
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (UINT64 i = 0, size = dstIndices.size(); i < size; ++i)
+		{
+			++triangleOffsets[dstIndices[i] + 1];
+		}
+		for (UINT i = 0; i < VERTEX_COUNT; ++i)
+		{
+			triangleOffsets[i + 1] += triangleOffsets[i];
+		}
+		triangles.resize(dstIndices.size());
+		{
+			std::vector<UINT> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (UINT i = 0; i < TRIANGLE_COUNT; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					triangles[fill[dstIndices[i * 3 + j]]++] = i;
+				}
+			}
+		}
+
+		// best collapse per source vertex.
+		collapses.clear();
+		for (UINT i = 0; i < TRIANGLE_COUNT; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				UINT src = dstIndices[i * 3 + j];
+				UINT dst = dstIndices[i * 3 + (j + 1) % 3];
+
+				for (int k = 0; k < 2; ++k)
+				{
+					if (!bLocked[src] && remap[src] != remap[dst])
+					{
+						Quadric merged = quadrics[remap[src]];
+						addQuadric(&merged, quadrics[remap[dst]]);
+
+						const Vertex& SRC_VERTEX = VERTICES[src];
+						const Vertex& DST_VERTEX = VERTICES[dst];
+						float error = evaluateQuadric(merged, DST_VERTEX.Position);
+						float penalty = SETTING.NormalWeight * (1.0f - SRC_VERTEX.Normal.Dot(DST_VERTEX.Normal)) +
+										SETTING.TexcoordWeight * (SRC_VERTEX.Texcoord - DST_VERTEX.Texcoord).LengthSquared();
+						if (bIS_SKINNED)
+						{
+							penalty += SETTING.BlendWeightWeight * getBlendWeightDistance(SKINNED_VERTICES[src], SKINNED_VERTICES[dst]);
+						}
+
+						collapses.push_back({ src, dst, error + penalty * SETTING.MaxError * SETTING.MaxError, error });
+					}
+
+					UINT temp = src;
+					src = dst;
+					dst = temp;
+				}
+			}
+		}
+		if (collapses.empty())
+		{
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& A, const Collapse& B) { return A.Cost < B.Cost; });
+
+		// collapse independent vertices. touched one-ring is not collapsed again in same pass.
+		const UINT TRIANGLES_TO_REMOVE = (UINT)((dstIndices.size() - TARGET_INDEX_COUNT) / 3);
+		UINT removedTriangles = 0;
+		UINT collapseCount = 0;
+
+		for (UINT i = 0; i < VERTEX_COUNT; ++i)
+		{
+			collapseTarget[i] = i;
+		}
+		std::fill(bTouched.begin(), bTouched.end(), false);
+
+		for (UINT64 i = 0, size = collapses.size(); i < size && removedTriangles < TRIANGLES_TO_REMOVE; ++i)
+		{
+			const Collapse& CUR = collapses[i];
+			if (CUR.Error > MAX_ERROR_SQ)
+			{
+				break;
+			}
+			if (bTouched[CUR.Src] || bTouched[CUR.Dst])
+			{
+				continue;
+			}
+
+			const UINT* pSRC_TRIANGLES = &triangles[triangleOffsets[CUR.Src]];
+			const UINT SRC_TRIANGLE_COUNT = triangleOffsets[CUR.Src + 1] - triangleOffsets[CUR.Src];
+			if (hasFlippedTriangle(VERTICES, dstIndices, pSRC_TRIANGLES, SRC_TRIANGLE_COUNT, CUR.Src, CUR.Dst))
+			{
+				continue;
+			}
+
+			for (UINT j = 0; j < SRC_TRIANGLE_COUNT; ++j)
+			{
+				const UINT* pTRI = &dstIndices[pSRC_TRIANGLES[j] * 3];
+				bTouched[pTRI[0]] = true;
+				bTouched[pTRI[1]] = true;
+				bTouched[pTRI[2]] = true;
+				if (pTRI[0] == CUR.Dst || pTRI[1] == CUR.Dst || pTRI[2] == CUR.Dst)
+				{
+					++removedTriangles;
+				}
+			}
+
+			collapseTarget[CUR.Src] = CUR.Dst;
+			addQuadric(&quadrics[remap[CUR.Dst]], quadrics[remap[CUR.Src]]);
+			resultErrorSq = Max(resultErrorSq, CUR.Error);
+			++collapseCount;
+		}
+
+		if (collapseCount == 0)
+		{
+			break;
+		}
+
+		// remap indices and remove degenerated triangles.
+		UINT64 writeIndex = 0;
+		for (UINT64 i = 0, size = dstIndices.size(); i < size; i += 3)
+		{
+			UINT a = collapseTarget[dstIndices[i]];
+			UINT b = collapseTarget[dstIndices[i + 1]];
+			UINT c = collapseTarget[dstIndices[i + 2]];
+
+			if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a])
+			{
+				continue;
+			}
+
+			dstIndices[writeIndex] = a;
+			dstIndices[writeIndex + 1] = b;
+			dstIndices[writeIndex + 2] = c;
+			writeIndex += 3;
+		}
+		dstIndices.resize(writeIndex);
+	}
+
+	*pResultError = sqrtf(resultErrorSq);
+
+	return (UINT)dstIndices.size();
+}
+
+void GenerateLODs(const MeshInfo& MESH_INFO, const LODSetting& SETTING, std::vector<MeshLOD>* pLODs)
+{
+	_ASSERT(pLODs);
+
+	const UINT LOD_COUNT = (UINT)Min((int)SETTING.LODCount, MAX_MESH_LOD_COUNT);
+
+	pLODs->clear();
+
+	if (MESH_INFO.Vertices.empty() || MESH_INFO.Indices.size() < 3 || MESH_INFO.Indices.size() / 3 < SETTING.MinTriangleCount)
+	{
+		return;
+	}
+	pLODs->reserve(LOD_COUNT);
+
+	float accumulatedError = 0.0f;
+	for (UINT lod = 1; lod < LOD_COUNT; ++lod)
+	{
+		const std::vector<UINT>& PREV_INDICES = (lod == 1 ? MESH_INFO.Indices : pLODs->back().Indices);
+		const UINT TARGET_INDEX_COUNT = (UINT)((float)(PREV_INDICES.size() / 3) * SETTING.TriangleRatio) * 3;
+
+		MeshLOD newLOD;
+		float error = 0.0f;
+		UINT indexCount = SimplifyMesh(MESH_INFO, PREV_INDICES, TARGET_INDEX_COUNT, SETTING, newLOD.Indices, &error);
+
+		// no more reduction(locked or error limit).
+		if (indexCount == 0 || indexCount > (UINT)((float)PREV_INDICES.size() * 0.9f))
+		{
+			break;
+		}
+
+		// error is measured against previous LOD. accumulate for error against LOD 0.
+		accumulatedError += error;
+		newLOD.Error = accumulatedError;
+
+#ifdef _DEBUG
+		char debugString[256];
+		sprintf_s(debugString, "LOD%u: %u -> %u triangles(%.1f%%), error: %f\n", lod, (UINT)(MESH_INFO.Indices.size() / 3), indexCount / 3, 100.0f * (float)indexCount / (float)MESH_INFO.Indices.size(), newLOD.Error);
+		OutputDebugStringA(debugString);
+#endif
+
+		pLODs->push_back(newLOD);
+	}
+}
+
+void GenerateLODs(MeshInfo* pMeshInfo, const LODSetting& SETTING)
+{
+	_ASSERT(pMeshInfo);
+	GenerateLODs(*pMeshInfo, SETTING, &pMeshInfo->LODs);
+}
+
+float ComputeScreenSpaceError(const float OBJECT_ERROR, const float DISTANCE, const float FOV_Y, const float SCREEN_HEIGHT)
+{
+	if (DISTANCE <= 1e-4f)
+	{
+		return FLT_MAX;
+	}
+
+	return OBJECT_ERROR * SCREEN_HEIGHT / (2.0f * DISTANCE * tanf(FOV_Y * 0.5f));
+}
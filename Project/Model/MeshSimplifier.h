@@ -0,0 +1,23 @@
+#pragma once
+
+#include "MeshInfo.h"
+
+struct LODSetting
+{
+	UINT LODCount = MAX_MESH_LOD_COUNT;	// including LOD 0.
+	float TriangleRatio = 0.5f;			// target triangle ratio against previous LOD.
+	float MaxError = 0.05f;				// object space. stop collapsing past this.
+	float NormalWeight = 0.01f;
+	float TexcoordWeight = 0.01f;
+	float BlendWeightWeight = 0.05f;
+	UINT MinTriangleCount = 256;		// meshes with less triangles get no LOD chain.
+};
+
+// Quadric error metric simplification. Collapses vertices onto their neighbors so vertex buffer is shared between LODs.
+// Seam and border vertices are locked, which keeps normals, uvs and skin weights intact.
+UINT SimplifyMesh(const MeshInfo& MESH_INFO, const std::vector<UINT>& SRC_INDICES, const UINT TARGET_INDEX_COUNT, const LODSetting& SETTING, std::vector<UINT>& dstIndices, float* pResultError);
+void GenerateLODs(const MeshInfo& MESH_INFO, const LODSetting& SETTING, std::vector<MeshLOD>* pLODs);
+void GenerateLODs(MeshInfo* pMeshInfo, const LODSetting& SETTING = LODSetting());
+
+// object space error -> pixel error.
+float ComputeScreenSpaceError(const float OBJECT_ERROR, const float DISTANCE, const float FOV_Y, const float SCREEN_HEIGHT);
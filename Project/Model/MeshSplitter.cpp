@@ -0,0 +1,130 @@
+#include "../pch.h"
+#include "MeshSplitter.h"
+
+static bool needsSplit(const MeshInfo& MESH_INFO)
+{
+	const UINT VERTEX_COUNT = (UINT)MESH_INFO.Vertices.size();
+	return (!CanUseIndex16(VERTEX_COUNT) && VERTEX_COUNT <= MAX_SPLIT_VERTEX_COUNT &&
+			MESH_INFO.LODs.empty() && MESH_INFO.Meshlets.empty());
+}
+
+static void beginPart(const MeshInfo& SRC, MeshInfo* pPart)
+{
+	// material only.
+	*pPart = INIT_MESH_INFO;
+	pPart->szAlbedoTextureFileName = SRC.szAlbedoTextureFileName;
+	pPart->szEmissiveTextureFileName = SRC.szEmissiveTextureFileName;
+	pPart->szNormalTextureFileName = SRC.szNormalTextureFileName;
+	pPart->szHeightTextureFileName = SRC.szHeightTextureFileName;
+	pPart->szAOTextureFileName = SRC.szAOTextureFileName;
+	pPart->szMetallicTextureFileName = SRC.szMetallicTextureFileName;
+	pPart->szRoughnessTextureFileName = SRC.szRoughnessTextureFileName;
+	pPart->szOpacityTextureFileName = SRC.szOpacityTextureFileName;
+	pPart->EmbeddedTextures = SRC.EmbeddedTextures;
+}
+
+UINT SplitMeshForIndex16(const MeshInfo& SRC, std::vector<MeshInfo>* pDst)
+{
+	_ASSERT(pDst);
+
+	if (!needsSplit(SRC))
+	{
+		pDst->push_back(SRC);
+		return 1;
+	}
+
+	const UINT VERTEX_COUNT = (UINT)SRC.Vertices.size();
+	const UINT TRIANGLE_COUNT = (UINT)(SRC.Indices.size() / 3);
+	const bool bHAS_SKINNED_VERTICES = (SRC.SkinnedVertices.size() == VERTEX_COUNT);
+
+	// src vertex -> part vertex. valid only when remapPart matches current part.
+	std::vector<UINT> remap(VERTEX_COUNT, 0);
+	std::vector<UINT> remapPart(VERTEX_COUNT, 0xffffffff);
+
+	UINT partCount = 0;
+	MeshInfo part;
+	beginPart(SRC, &part);
+
+	for (UINT i = 0; i < TRIANGLE_COUNT; ++i)
+	{
+		const UINT* pTRI = &SRC.Indices[i * 3];
+
+		UINT newVertexCount = 0;
+		for (int j = 0; j < 3; ++j)
+		{
+			if (remapPart[pTRI[j]] != partCount)
+			{
+				++newVertexCount;
+			}
+		}
+
+		// flush current part.
+		if (part.Vertices.size() + newVertexCount > MAX_INDEX16_VERTEX_COUNT)
+		{
+			pDst->push_back(std::move(part));
+			beginPart(SRC, &part);
+			++partCount;
+		}
+
+		for (int j = 0; j < 3; ++j)
+		{
+			const UINT SRC_INDEX = pTRI[j];
+			if (remapPart[SRC_INDEX] != partCount)
+			{
+				remapPart[SRC_INDEX] = partCount;
+				remap[SRC_INDEX] = (UINT)part.Vertices.size();
+
+				part.Vertices.push_back(SRC.Vertices[SRC_INDEX]);
+				if (bHAS_SKINNED_VERTICES)
+				{
+					part.SkinnedVertices.push_back(SRC.SkinnedVertices[SRC_INDEX]);
+				}
+			}
+			part.Indices.push_back(remap[SRC_INDEX]);
+		}
+	}
+
+	pDst->push_back(std::move(part));
+	++partCount;
+
+	return partCount;
+}
+
+UINT SplitMeshesForIndex16(std::vector<MeshInfo>* pMeshInfos)
+{
+	_ASSERT(pMeshInfos);
+
+	bool bNeedsSplit = false;
+	for (UINT64 i = 0, size = pMeshInfos->size(); i < size; ++i)
+	{
+		bNeedsSplit |= needsSplit((*pMeshInfos)[i]);
+	}
+	if (!bNeedsSplit)
+	{
+		return 0;
+	}
+
+	std::vector<MeshInfo> splitMeshInfos;
+	UINT splitMeshCount = 0;
+	splitMeshInfos.reserve(pMeshInfos->size() * 2);
+
+	for (UINT64 i = 0, size = pMeshInfos->size(); i < size; ++i)
+	{
+		const MeshInfo& SRC = (*pMeshInfos)[i];
+		UINT partCount = SplitMeshForIndex16(SRC, &splitMeshInfos);
+		if (partCount > 1)
+		{
+			++splitMeshCount;
+
+#ifdef _DEBUG
+			char debugString[256];
+			sprintf_s(debugString, "Mesh split for 16bit indices: %u vertices -> %u parts.\n", (UINT)SRC.Vertices.size(), partCount);
+			OutputDebugStringA(debugString);
+#endif
+		}
+	}
+
+	pMeshInfos->swap(splitMeshInfos);
+
+	return splitMeshCount;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "MeshInfo.h"
+
+#define MAX_INDEX16_VERTEX_COUNT 65536
+#define MAX_SPLIT_VERTEX_COUNT (MAX_INDEX16_VERTEX_COUNT * 2) // bigger meshes stay 32bit rather than adding draw calls.
+
+inline bool CanUseIndex16(const UINT VERTEX_COUNT) { return (VERTEX_COUNT <= MAX_INDEX16_VERTEX_COUNT); }
+
+// Splits triangles of a mesh into parts that each reference at most MAX_INDEX16_VERTEX_COUNT vertices.
+// Meshes with LODs or meshlets are not split since those reference the original indices.
+// returns part count. 1 means pDst has a copy of SRC.
+UINT SplitMeshForIndex16(const MeshInfo& SRC, std::vector<MeshInfo>* pDst);
+
+// Splits meshes slightly over 16bit range in place. returns number of meshes split.
+UINT SplitMeshesForIndex16(std::vector<MeshInfo>* pMeshInfos);
@@ -0,0 +1,265 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "MeshletBuilder.h"
+
+static void computeMeshletBounds(const std::vector<Vertex>& VERTICES, const std::vector<UINT>& INDICES, Meshlet* pMeshlet)
+{
+	std::vector<Vector3> positions;
+	positions.reserve(pMeshlet->TriangleCount * 3);
+
+	Vector3 normalSum(0.0f);
+	for (UINT i = 0; i < pMeshlet->TriangleCount; ++i)
+	{
+		const UINT* pTRI = &INDICES[pMeshlet->IndexOffset + i * 3];
+		const Vector3& P0 = VERTICES[pTRI[0]].Position;
+		const Vector3& P1 = VERTICES[pTRI[1]].Position;
+		const Vector3& P2 = VERTICES[pTRI[2]].Position;
+
+		positions.push_back(P0);
+		positions.push_back(P1);
+		positions.push_back(P2);
+
+		Vector3 normal = (P1 - P0).Cross(P2 - P0);
+		normal.Normalize();
+		normalSum += normal;
+	}
+
+	DirectX::BoundingSphere sphere;
+	DirectX::BoundingSphere::CreateFromPoints(sphere, positions.size(), positions.data(), sizeof(Vector3));
+	pMeshlet->Center = sphere.Center;
+	pMeshlet->Radius = sphere.Radius;
+
+	// normal cone.
+	pMeshlet->ConeAxis = Vector3(0.0f);
+	pMeshlet->ConeCutoff = 1.0f;
+
+	float axisLength = normalSum.Length();
+	if (axisLength < 1e-6f)
+	{
+		return;
+	}
+	normalSum /= axisLength;
+
+	float minDot = 1.0f;
+	for (UINT i = 0; i < pMeshlet->TriangleCount; ++i)
+	{
+		const Vector3& P0 = positions[i * 3];
+		const Vector3& P1 = positions[i * 3 + 1];
+		const Vector3& P2 = positions[i * 3 + 2];
+
+		Vector3 normal = (P1 - P0).Cross(P2 - P0);
+		normal.Normalize();
+		minDot = Min(minDot, normal.Dot(normalSum));
+	}
+
+	// cone wider than hemisphere is useless for culling.
+	if (minDot <= 0.1f)
+	{
+		return;
+	}
+
+	pMeshlet->ConeAxis = normalSum;
+	pMeshlet->ConeCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+void BuildMeshlets(MeshInfo* pMeshInfo, const UINT MAX_VERTICES, const UINT MAX_TRIANGLES)
+{
+	_ASSERT(pMeshInfo);
+	_ASSERT(MAX_VERTICES >= 3);
+	_ASSERT(MAX_TRIANGLES >= 1);
+
+	const std::vector<Vertex>& VERTICES = pMeshInfo->Vertices;
+	const std::vector<UINT>& INDICES = pMeshInfo->Indices;
+	const UINT VERTEX_COUNT = (UINT)VERTICES.size();
+	const UINT TRIANGLE_COUNT = (UINT)(INDICES.size() / 3);
+
+	pMeshInfo->Meshlets.clear();
+	if (TRIANGLE_COUNT == 0)
+	{
+		return;
+	}
+
+	// vertex -> triangle adjacency.
+	std::vector<UINT> triangleOffsets(VERTEX_COUNT + 1, 0);
+	std::vector<UINT> triangles(TRIANGLE_COUNT * 3);
+	for (UINT i = 0; i < TRIANGLE_COUNT * 3; ++i)
+	{
+		++triangleOffsets[INDICES[i] + 1];
+	}
+	for (UINT i = 0; i < VERTEX_COUNT; ++i)
+	{
+		triangleOffsets[i + 1] += triangleOffsets[i];
+	}
+	{
+		std::vector<UINT> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		for (UINT i = 0; i < TRIANGLE_COUNT; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				triangles[fill[INDICES[i * 3 + j]]++] = i;
+			}
+		}
+	}
+
+	std::vector<UINT> newIndices;
+	std::vector<bool> bEmitted(TRIANGLE_COUNT, false);
+	std::vector<UINT> vertexOwner(VERTEX_COUNT, 0xffffffff); // meshlet id which already has the vertex.
+	std::vector<UINT> candidates;
+	UINT seedCursor = 0;
+
+	newIndices.reserve(INDICES.size());
+
+	while (true)
+	{
+		// seed triangle.
+		while (seedCursor < TRIANGLE_COUNT && bEmitted[seedCursor])
+		{
+			++seedCursor;
+		}
+		if (seedCursor >= TRIANGLE_COUNT)
+		{
+			break;
+		}
+
+		const UINT MESHLET_ID = (UINT)pMeshInfo->Meshlets.size();
+		Meshlet newMeshlet = {};
+		newMeshlet.IndexOffset = (UINT)newIndices.size();
+
+		candidates.clear();
+		UINT triangle = seedCursor;
+
+		while (true)
+		{
+			const UINT* pTRI = &INDICES[triangle * 3];
+
+			// emit triangle.
+			for (int j = 0; j < 3; ++j)
+			{
+				if (vertexOwner[pTRI[j]] != MESHLET_ID)
+				{
+					vertexOwner[pTRI[j]] = MESHLET_ID;
+					++newMeshlet.VertexCount;
+
+					for (UINT k = triangleOffsets[pTRI[j]]; k < triangleOffsets[pTRI[j] + 1]; ++k)
+					{
+						if (!bEmitted[triangles[k]])
+						{
+							candidates.push_back(triangles[k]);
+						}
+					}
+				}
+				newIndices.push_back(pTRI[j]);
+			}
+			bEmitted[triangle] = true;
+			++newMeshlet.TriangleCount;
+
+			if (newMeshlet.TriangleCount >= MAX_TRIANGLES)
+			{
+				break;
+			}
+
+			// next triangle sharing most vertices with current meshlet.
+			UINT bestTriangle = 0xffffffff;
+			UINT bestNewVertexCount = 4;
+			UINT64 writeIndex = 0;
+			for (UINT64 i = 0, size = candidates.size(); i < size; ++i)
+			{
+				UINT candidate = candidates[i];
+				if (bEmitted[candidate])
+				{
+					continue;
+				}
+				candidates[writeIndex++] = candidate;
+
+				const UINT* pCANDIDATE_TRI = &INDICES[candidate * 3];
+				UINT newVertexCount = (vertexOwner[pCANDIDATE_TRI[0]] != MESHLET_ID) + (vertexOwner[pCANDIDATE_TRI[1]] != MESHLET_ID) + (vertexOwner[pCANDIDATE_TRI[2]] != MESHLET_ID);
+				if (newVertexCount < bestNewVertexCount)
+				{
+					bestNewVertexCount = newVertexCount;
+					bestTriangle = candidate;
+				}
+			}
+			candidates.resize(writeIndex);
+
+			if (bestTriangle == 0xffffffff || newMeshlet.VertexCount + bestNewVertexCount > MAX_VERTICES)
+			{
+				break;
+			}
+			triangle = bestTriangle;
+		}
+
+		computeMeshletBounds(VERTICES, newIndices, &newMeshlet);
+		pMeshInfo->Meshlets.push_back(newMeshlet);
+	}
+
+	pMeshInfo->Indices.swap(newIndices);
+
+#ifdef _DEBUG
+	char debugString[256];
+	sprintf_s(debugString, "Meshlets: %u triangles -> %u meshlets.\n", TRIANGLE_COUNT, (UINT)pMeshInfo->Meshlets.size());
+	OutputDebugStringA(debugString);
+#endif
+}
+
+UINT BuildStaticMeshlets(std::vector<MeshInfo>* pMeshInfos)
+{
+	_ASSERT(pMeshInfos);
+
+	UINT builtCount = 0;
+	for (UINT64 i = 0, size = pMeshInfos->size(); i < size; ++i)
+	{
+		MeshInfo* pMeshInfo = &(*pMeshInfos)[i];
+		if (!pMeshInfo->SkinnedVertices.empty() || !pMeshInfo->Meshlets.empty() || pMeshInfo->Indices.size() / 3 < MIN_MESHLET_MESH_TRIANGLES)
+		{
+			continue;
+		}
+
+		BuildMeshlets(pMeshInfo);
+		++builtCount;
+	}
+
+	return builtCount;
+}
+
+UINT CullMeshlets(const std::vector<Meshlet>& MESHLETS, const DirectX::BoundingFrustum& LOCAL_FRUSTUM, const Vector3& LOCAL_EYE_POS, std::vector<MeshletDrawRange>* pDrawRanges)
+{
+	_ASSERT(pDrawRanges);
+
+	UINT culledTriangleCount = 0;
+	pDrawRanges->clear();
+
+	for (UINT64 i = 0, size = MESHLETS.size(); i < size; ++i)
+	{
+		const Meshlet& MESHLET = MESHLETS[i];
+		DirectX::BoundingSphere sphere(MESHLET.Center, MESHLET.Radius);
+
+		// frustum.
+		if (LOCAL_FRUSTUM.Contains(sphere) == DirectX::DISJOINT)
+		{
+			culledTriangleCount += MESHLET.TriangleCount;
+			continue;
+		}
+
+		// backface cone.
+		Vector3 toCenter = MESHLET.Center - LOCAL_EYE_POS;
+		if (toCenter.Dot(MESHLET.ConeAxis) >= MESHLET.ConeCutoff * toCenter.Length() + MESHLET.Radius)
+		{
+			culledTriangleCount += MESHLET.TriangleCount;
+			continue;
+		}
+
+		// merge with previous range.
+		if (!pDrawRanges->empty())
+		{
+			MeshletDrawRange& lastRange = pDrawRanges->back();
+			if (lastRange.IndexOffset + lastRange.IndexCount == MESHLET.IndexOffset)
+			{
+				lastRange.IndexCount += MESHLET.TriangleCount * 3;
+				continue;
+			}
+		}
+		pDrawRanges->push_back({ MESHLET.IndexOffset, MESHLET.TriangleCount * 3 });
+	}
+
+	return culledTriangleCount;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <DirectXCollision.h>
+#include "MeshInfo.h"
+
+#define MAX_MESHLET_VERTICES 64
+#define MAX_MESHLET_TRIANGLES 124
+#define MIN_MESHLET_MESH_TRIANGLES (MAX_MESHLET_TRIANGLES * 4) // smaller meshes are drawn whole.
+
+struct MeshletDrawRange
+{
+	UINT IndexOffset;
+	UINT IndexCount;
+};
+
+// Reorders pMeshInfo->Indices so that each meshlet's triangles are contiguous, then fills pMeshInfo->Meshlets.
+void BuildMeshlets(MeshInfo* pMeshInfo, const UINT MAX_VERTICES = MAX_MESHLET_VERTICES, const UINT MAX_TRIANGLES = MAX_MESHLET_TRIANGLES);
+// BuildMeshlets on static meshes with MIN_MESHLET_MESH_TRIANGLES or more. skinned meshes are skipped since bounds are in bind pose.
+// returns count of meshes built.
+UINT BuildStaticMeshlets(std::vector<MeshInfo>* pMeshInfos);
+
+// Frustum and backface cone test in object space. Adjacent visible meshlets are merged into one draw range.
+// returns culled triangle count.
+UINT CullMeshlets(const std::vector<Meshlet>& MESHLETS, const DirectX::BoundingFrustum& LOCAL_FRUSTUM, const Vector3& LOCAL_EYE_POS, std::vector<MeshletDrawRange>* pDrawRanges);
@@ -2,9 +2,25 @@
 #include "../Graphics/ConstantDataType.h"
 #include "../Graphics/GraphicsUtil.h"
 #include "GeometryGenerator.h"
+#include "MeshSimplifier.h"
+#include "MeshSplitter.h"
+#include "VertexCompression.h"
+#include "VertexStream.h"
 #include "../Util/Utility.h"
 #include "Model.h"
 
+static const EmbeddedTexture* findEmbeddedTexture(const MeshInfo& MESH_INFO, const std::wstring& FILE_NAME)
+{
+	for (UINT64 i = 0, size = MESH_INFO.EmbeddedTextures.size(); i < size; ++i)
+	{
+		if (MESH_INFO.EmbeddedTextures[i]->Name == FILE_NAME)
+		{
+			return MESH_INFO.EmbeddedTextures[i].get();
+		}
+	}
+	return nullptr;
+}
+
 Model::Model(Renderer* pRenderer, std::wstring& basePath, std::wstring& fileName)
 {
 	Initialize(pRenderer, basePath, fileName);
@@ -19,6 +35,7 @@ void Model::Initialize(Renderer* pRenderer, std::wstring& basePath, std::wstring
 {
 	std::vector<MeshInfo> meshInfos;
 	ReadFromFile(meshInfos, basePath, fileName);
+	BuildStaticMeshlets(&meshInfos);
 	Initialize(pRenderer, meshInfos);
 }
 
@@ -27,14 +44,19 @@ void Model::Initialize(Renderer* pRenderer, const std::vector<MeshInfo>& MESH_IN
 	_ASSERT(pRenderer);
 
 	HRESULT hr = S_OK;
-	struct _stat64 sourceFileStat;
 
 	ResourceManager* pManager = pRenderer->GetResourceManager();
 	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
 
+	m_pTextureCache = pRenderer->GetTextureCache();
+	m_pResourceManager = pManager;
+
 	Meshes.reserve(MESH_INFOS.size());
 
+	// textures of all meshes are decoded together, and all buffers and textures are uploaded together.
+	pManager->BeginUpload();
+	m_pTextureCache->BeginBatch();
 	for (UINT64 i = 0, meshSize = MESH_INFOS.size(); i < meshSize; ++i)
 	{
 		const MeshInfo& MESH_DATA = MESH_INFOS[i];
@@ -50,144 +72,78 @@ void Model::Initialize(Renderer* pRenderer, const std::vector<MeshInfo>& MESH_IN
 		pMeshConst->World = Matrix();
 
 		InitMeshBuffers(pRenderer, MESH_DATA, pNewMesh);
+		pNewMesh->Meshlets = MESH_DATA.Meshlets;
 
-		if (!MESH_DATA.szAlbedoTextureFileName.empty())
+		// meshes loaded without LOD chain get one here. added after LOD 0 since they share its vertex buffer.
+		if (MESH_DATA.LODs.empty())
 		{
-			std::string albedoTextureA(MESH_DATA.szAlbedoTextureFileName.begin(), MESH_DATA.szAlbedoTextureFileName.end());
-
-			if (_stat64(albedoTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Albedo.Initialize(pRenderer, MESH_DATA.szAlbedoTextureFileName.c_str(), true);
-				pMaterialConst->bUseAlbedoMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szAlbedoTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
+			std::vector<MeshLOD> lods;
+			GenerateLODs(MESH_DATA, LODSetting(), &lods);
+			initLODBuffers(pRenderer, lods, pNewMesh);
 		}
-		if (!MESH_DATA.szEmissiveTextureFileName.empty())
-		{
-			std::string emissiveTextureA(MESH_DATA.szEmissiveTextureFileName.begin(), MESH_DATA.szEmissiveTextureFileName.end());
 
-			if (_stat64(emissiveTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Emissive.Initialize(pRenderer, MESH_DATA.szEmissiveTextureFileName.c_str(), true);
-				pMaterialConst->bUseEmissiveMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szEmissiveTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
-		}
-		if (!MESH_DATA.szNormalTextureFileName.empty())
-		{
-			std::string normalTextureA(MESH_DATA.szNormalTextureFileName.begin(), MESH_DATA.szNormalTextureFileName.end());
+		m_pTextureCache->Acquire(pRenderer, MESH_DATA.szAlbedoTextureFileName, TextureUsage_Color, &pNewMesh->Material.Albedo, &pMaterialConst->bUseAlbedoMap, &pNewMesh->MaterialConstant, this, findEmbeddedTexture(MESH_DATA, MESH_DATA.szAlbedoTextureFileName));
+		m_pTextureCache->Acquire(pRenderer, MESH_DATA.szEmissiveTextureFileName, TextureUsage_Color, &pNewMesh->Material.Emissive, &pMaterialConst->bUseEmissiveMap, &pNewMesh->MaterialConstant, this, findEmbeddedTexture(MESH_DATA, MESH_DATA.szEmissiveTextureFileName));
+		m_pTextureCache->Acquire(pRenderer, MESH_DATA.szNormalTextureFileName, TextureUsage_Normal, &pNewMesh->Material.Normal, &pMaterialConst->bUseNormalMap, &pNewMesh->MaterialConstant, this, findEmbeddedTexture(MESH_DATA, MESH_DATA.szNormalTextureFileName));
 
-			if (_stat64(normalTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Normal.Initialize(pRenderer, MESH_DATA.szNormalTextureFileName.c_str(), false);
-				pMaterialConst->bUseNormalMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szNormalTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
-		}
-		if (!MESH_DATA.szHeightTextureFileName.empty())
+		// scalar maps are packed into one texture.
+		const std::wstring ORMH_FILE_NAMES[ORMHChannel_Count] = { MESH_DATA.szAOTextureFileName, MESH_DATA.szRoughnessTextureFileName, MESH_DATA.szMetallicTextureFileName, MESH_DATA.szHeightTextureFileName };
+		const EmbeddedTexture* pORMHEmbeddedTextures[ORMHChannel_Count] = { nullptr, };
+		UINT ormhChannelMask = 0;
+		for (UINT j = 0; j < ORMHChannel_Count; ++j)
 		{
-			std::string heightTextureA(MESH_DATA.szHeightTextureFileName.begin(), MESH_DATA.szHeightTextureFileName.end());
-
-			if (_stat64(heightTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Height.Initialize(pRenderer, MESH_DATA.szHeightTextureFileName.c_str(), false);
-				pMeshConst->bUseHeightMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szHeightTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
+			pORMHEmbeddedTextures[j] = findEmbeddedTexture(MESH_DATA, ORMH_FILE_NAMES[j]);
 		}
-		if (!MESH_DATA.szAOTextureFileName.empty())
-		{
-			std::string aoTextureA(MESH_DATA.szAOTextureFileName.begin(), MESH_DATA.szAOTextureFileName.end());
+		m_pTextureCache->AcquireORMH(pRenderer, ORMH_FILE_NAMES, pORMHEmbeddedTextures, &pNewMesh->Material.ORMH, &pMaterialConst->bUseORMHMap, &pNewMesh->MaterialConstant, &ormhChannelMask, this);
+		pMeshConst->bUseHeightMap = ((ormhChannelMask & (1 << ORMHChannel_Height)) ? TRUE : FALSE);
 
-			if (_stat64(aoTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.AmbientOcclusion.Initialize(pRenderer, MESH_DATA.szAOTextureFileName.c_str(), false);
-				pMaterialConst->bUseAOMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szAOTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
-		}
-		if (!MESH_DATA.szMetallicTextureFileName.empty())
-		{
-			std::string metallicTextureA(MESH_DATA.szMetallicTextureFileName.begin(), MESH_DATA.szMetallicTextureFileName.end());
+		Meshes.push_back(pNewMesh);
+	}
+	m_pTextureCache->EndBatch(pRenderer);
 
-			if (_stat64(metallicTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Metallic.Initialize(pRenderer, MESH_DATA.szMetallicTextureFileName.c_str(), false);
-				pMaterialConst->bUseMetallicMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szMetallicTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
-		}
-		if (!MESH_DATA.szRoughnessTextureFileName.empty())
-		{
-			std::string roughnessTextureA(MESH_DATA.szRoughnessTextureFileName.begin(), MESH_DATA.szRoughnessTextureFileName.end());
+	initBoundingBox(pRenderer, MESH_INFOS);
+	initBoundingSphere(pRenderer, MESH_INFOS);
+	pManager->EndUpload();
 
-			if (_stat64(roughnessTextureA.c_str(), &sourceFileStat) != -1)
-			{
-				pNewMesh->Material.Roughness.Initialize(pRenderer, MESH_DATA.szRoughnessTextureFileName.c_str(), false);
-				pMaterialConst->bUseRoughnessMap = TRUE;
-			}
-			else
-			{
-				OutputDebugStringW(MESH_DATA.szRoughnessTextureFileName.c_str());
-				OutputDebugStringA(" does not exists. Skip texture reading.\n");
-			}
+#ifdef _DEBUG
+	// index memory against all 32bit.
+	UINT64 index32Size = 0;
+	UINT64 indexSize = 0;
+	UINT index16MeshCount = 0;
+	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
+	{
+		Mesh* pCurMesh = Meshes[i];
+		if (pCurMesh->Index.IndexBufferView.Format == DXGI_FORMAT_R16_UINT)
+		{
+			++index16MeshCount;
 		}
 
-		Meshes.push_back(pNewMesh);
+		index32Size += pCurMesh->Index.Count * sizeof(UINT);
+		indexSize += pCurMesh->Index.IndexBufferView.SizeInBytes;
+		for (UINT j = 0; j < pCurMesh->LODCount - 1; ++j)
+		{
+			index32Size += pCurMesh->LODIndices[j].Count * sizeof(UINT);
+			indexSize += pCurMesh->LODIndices[j].IndexBufferView.SizeInBytes;
+		}
 	}
 
-	initBoundingBox(pRenderer, MESH_INFOS);
-	initBoundingSphere(pRenderer, MESH_INFOS);
+	char debugString[256];
+	sprintf_s(debugString, "Index buffers: %u / %u meshes 16bit, %llu bytes -> %llu bytes.\n", index16MeshCount, (UINT)Meshes.size(), index32Size, indexSize);
+	OutputDebugStringA(debugString);
+#endif
 }
 
 void Model::InitMeshBuffers(Renderer* pRenderer, const MeshInfo& MESH_INFO, Mesh* pNewMesh)
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
-	ResourceManager* pManager = pRenderer->GetResourceManager();
-
 	// vertex buffer.
-	hr = pManager->CreateVertexBuffer(sizeof(Vertex),
-									  (UINT)MESH_INFO.Vertices.size(),
-									  &pNewMesh->Vertex.VertexBufferView,
-									  &pNewMesh->Vertex.pBuffer,
-									  (void*)MESH_INFO.Vertices.data());
-	BREAK_IF_FAILED(hr);
-	pNewMesh->Vertex.Count = (UINT)MESH_INFO.Vertices.size();
+	initVertexBuffer(pRenderer, MESH_INFO, pNewMesh, false);
 
 	// index buffer.
-	hr = pManager->CreateIndexBuffer(sizeof(UINT),
-									 (UINT)MESH_INFO.Indices.size(),
-									 &pNewMesh->Index.IndexBufferView,
-									 &pNewMesh->Index.pBuffer,
-									 (void*)MESH_INFO.Indices.data());
-	BREAK_IF_FAILED(hr);
-	pNewMesh->Index.Count = (UINT)MESH_INFO.Indices.size();
+	initIndexBuffer(pRenderer, MESH_INFO.Indices, pNewMesh->Vertex.Count, &pNewMesh->Index);
+
+	initLODBuffers(pRenderer, MESH_INFO.LODs, pNewMesh);
 }
 
 void Model::UpdateConstantBuffers()
@@ -197,19 +153,18 @@ void Model::UpdateConstantBuffers()
 		return;
 	}
 
-	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
-	{
-		Mesh* pCurMesh = Meshes[i];
-		pCurMesh->MeshConstant.Upload();
-		pCurMesh->MaterialConstant.Upload();
-	}
-
-	m_pBoundingBoxMesh->MeshConstant.Upload();
-	m_pBoundingSphereMesh->MeshConstant.Upload();
+	updateMeshConstants();
 }
 
 void Model::UpdateWorld(const Matrix& WORLD)
 {
+	// mesh constants already hold this transform. static models are set once and never uploaded again.
+	if (m_WorldVersion > 0 && WORLD == World)
+	{
+		return;
+	}
+	++m_WorldVersion;
+
 	World = WORLD;
 	WorldInverseTranspose = WORLD;
 	WorldInverseTranspose.Translation(Vector3(0.0f));
@@ -228,6 +183,8 @@ void Model::UpdateWorld(const Matrix& WORLD)
 	pSphereMeshConst->World = pBoxMeshConst->World;
 	pSphereMeshConst->WorldInverseTranspose = pBoxMeshConst->WorldInverseTranspose;
 	pSphereMeshConst->WorldInverse = pBoxMeshConst->WorldInverse;
+	m_pBoundingBoxMesh->MeshConstant.MarkDirty();
+	m_pBoundingSphereMesh->MeshConstant.MarkDirty();
 
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
@@ -236,6 +193,67 @@ void Model::UpdateWorld(const Matrix& WORLD)
 		pMeshConst->World = WORLD.Transpose();
 		pMeshConst->WorldInverseTranspose = WorldInverseTranspose.Transpose();
 		pMeshConst->WorldInverse = WorldInverseTranspose.Transpose();
+		pCurMesh->MeshConstant.MarkDirty();
+	}
+}
+
+void Model::UpdateLOD(const Vector3& EYE_POS, const float FOV_Y, const float SCREEN_HEIGHT)
+{
+	// object space error -> world space.
+	float scale = Max(Max(Vector3(World._11, World._12, World._13).Length(), Vector3(World._21, World._22, World._23).Length()), Vector3(World._31, World._32, World._33).Length());
+	float distance = Max((EYE_POS - Vector3(BoundingSphere.Center)).Length() - BoundingSphere.Radius * scale, 1e-3f);
+
+	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
+	{
+		Mesh* pCurMesh = Meshes[i];
+		UINT lod = 0;
+
+		// coarsest LOD under threshold.
+		for (UINT j = 1; j < pCurMesh->LODCount; ++j)
+		{
+			if (ComputeScreenSpaceError(pCurMesh->LODErrors[j - 1] * scale, distance, FOV_Y, SCREEN_HEIGHT) > LODErrorThreshold)
+			{
+				break;
+			}
+			lod = j;
+		}
+
+		pCurMesh->CurrentLOD = lod;
+	}
+}
+
+void Model::UpdateClusterCulling(const DirectX::BoundingFrustum& VIEW_FRUSTUM, const Vector3& EYE_POS)
+{
+	ClusterTriangleCount = 0;
+	CulledClusterTriangleCount = 0;
+
+	// frustum and normal cones keep their shape in object space under uniform scale only.
+	const float SCALE_X = Vector3(World._11, World._12, World._13).Length();
+	const float SCALE_Y = Vector3(World._21, World._22, World._23).Length();
+	const float SCALE_Z = Vector3(World._31, World._32, World._33).Length();
+	const float MAX_SCALE = Max(Max(SCALE_X, SCALE_Y), SCALE_Z);
+	const float MIN_SCALE = Min(Min(SCALE_X, SCALE_Y), SCALE_Z);
+	const bool bUNIFORM_SCALE = (MAX_SCALE - MIN_SCALE <= MAX_SCALE * 1e-3f);
+
+	// test in object space.
+	Matrix worldInverse = World.Invert();
+	DirectX::BoundingFrustum localFrustum;
+	VIEW_FRUSTUM.Transform(localFrustum, worldInverse);
+	Vector3 localEyePos = Vector3::Transform(EYE_POS, worldInverse);
+
+	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
+	{
+		Mesh* pCurMesh = Meshes[i];
+
+		// meshlets are built on LOD 0 indices.
+		pCurMesh->bUseClusterCulling = (bUNIFORM_SCALE && !pCurMesh->Meshlets.empty() && pCurMesh->CurrentLOD == 0);
+		if (!pCurMesh->bUseClusterCulling)
+		{
+			continue;
+		}
+
+		ClusterTriangleCount += pCurMesh->Index.Count / 3;
+		CulledClusterTriangleCount += CullMeshlets(pCurMesh->Meshlets, localFrustum, localEyePos, &pCurMesh->VisibleRanges);
 	}
 }
 
@@ -243,20 +261,14 @@ void Model::Render(Renderer* pRenderer, eRenderPSOType psoSetting)
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
 
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* pCurMesh = Meshes[i];
+		BufferInfo* pVertex = &pCurMesh->Vertex;
+		setMeshRootArguments(pCommandList, pCurMesh);
 
 		switch (psoSetting)
 		{
@@ -265,52 +277,37 @@ void Model::Render(Renderer* pRenderer, eRenderPSOType psoSetting)
 			case RenderPSOType_MirrorBlend: 
 			case RenderPSOType_ReflectionDefault: 
 			case RenderPSOType_ReflectionSkybox:
-			{
-				hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 9);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(2, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// t0 ~ t5
-				pDevice->CopyDescriptorsSimple(6, dstHandle, pCurMesh->Material.Albedo.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(6, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// t6
-				pDevice->CopyDescriptorsSimple(1, dstHandle, pCurMesh->Material.Height.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-			}
-			break;
+				break;
 
 			case RenderPSOType_StencilMask:
 			case RenderPSOType_DepthOnlyDefault: 
 			case RenderPSOType_DepthOnlyCubeDefault: 
 			case RenderPSOType_DepthOnlyCascadeDefault: 
-			{
-				hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 2);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-			}
-			break;
+				pVertex = pCurMesh->GetDepthOnlyVertex();
+				break;
 
 			default:
 				__debugbreak();
 				break;
 		}
 
-		pCommandList->IASetVertexBuffers(0, 1, &pCurMesh->Vertex.VertexBufferView);
-		pCommandList->IASetIndexBuffer(&(pCurMesh->Index.IndexBufferView));
-		pCommandList->DrawIndexedInstanced(pCurMesh->Index.Count, 1, 0, 0, 0);
+		BufferInfo* pIndex = pCurMesh->GetCurrentIndex();
+		pCommandList->IASetVertexBuffers(0, 1, &pVertex->VertexBufferView);
+		pCommandList->IASetIndexBuffer(&pIndex->IndexBufferView);
+
+		// cluster culling result is valid only for main camera.
+		if (psoSetting == RenderPSOType_Default && pCurMesh->bUseClusterCulling)
+		{
+			for (UINT64 j = 0, rangeSize = pCurMesh->VisibleRanges.size(); j < rangeSize; ++j)
+			{
+				const MeshletDrawRange& RANGE = pCurMesh->VisibleRanges[j];
+				pCommandList->DrawIndexedInstanced(RANGE.IndexCount, 1, RANGE.IndexOffset, 0, 0);
+			}
+		}
+		else
+		{
+			pCommandList->DrawIndexedInstanced(pIndex->Count, 1, 0, 0, 0);
+		}
 	}
 }
 
@@ -320,16 +317,12 @@ void Model::Render(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, Dy
 	_ASSERT(pManager);
 	_ASSERT(pDescriptorPool);
 
-	HRESULT hr = S_OK;
-	ID3D12Device5* pDevice = pManager->m_pDevice;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
-
+	// constants and bindless slots are written by main thread in UpdateConstantBuffers().
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* pCurMesh = Meshes[i];
+		BufferInfo* pVertex = &pCurMesh->Vertex;
+		setMeshRootArguments(pCommandList, pCurMesh);
 
 		switch (psoSetting)
 		{
@@ -338,52 +331,37 @@ void Model::Render(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, Dy
 			case RenderPSOType_MirrorBlend: 
 			case RenderPSOType_ReflectionDefault:
 			case RenderPSOType_ReflectionSkybox:
-			{
-				hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 9);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(2, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// t0 ~ t5
-				pDevice->CopyDescriptorsSimple(6, dstHandle, pCurMesh->Material.Albedo.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(6, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// t6
-				pDevice->CopyDescriptorsSimple(1, dstHandle, pCurMesh->Material.Height.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-			}
-			break;
+				break;
 
 			case RenderPSOType_StencilMask:
 			case RenderPSOType_DepthOnlyDefault:
 			case RenderPSOType_DepthOnlyCubeDefault:
 			case RenderPSOType_DepthOnlyCascadeDefault:
-			{
-				hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 2);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-			}
-			break;
+				pVertex = pCurMesh->GetDepthOnlyVertex();
+				break;
 
 			default:
 				__debugbreak();
 				break;
 		}
 
-		pCommandList->IASetVertexBuffers(0, 1, &pCurMesh->Vertex.VertexBufferView);
-		pCommandList->IASetIndexBuffer(&(pCurMesh->Index.IndexBufferView));
-		pCommandList->DrawIndexedInstanced(pCurMesh->Index.Count, 1, 0, 0, 0);
+		BufferInfo* pIndex = pCurMesh->GetCurrentIndex();
+		pCommandList->IASetVertexBuffers(0, 1, &pVertex->VertexBufferView);
+		pCommandList->IASetIndexBuffer(&pIndex->IndexBufferView);
+
+		// cluster culling result is valid only for main camera.
+		if (psoSetting == RenderPSOType_Default && pCurMesh->bUseClusterCulling)
+		{
+			for (UINT64 j = 0, rangeSize = pCurMesh->VisibleRanges.size(); j < rangeSize; ++j)
+			{
+				const MeshletDrawRange& RANGE = pCurMesh->VisibleRanges[j];
+				pCommandList->DrawIndexedInstanced(RANGE.IndexCount, 1, RANGE.IndexOffset, 0, 0);
+			}
+		}
+		else
+		{
+			pCommandList->DrawIndexedInstanced(pIndex->Count, 1, 0, 0, 0);
+		}
 	}
 }
 
@@ -391,34 +369,11 @@ void Model::RenderBoundingBox(Renderer* pRenderer, eRenderPSOType psoSetting)
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	ID3D12DescriptorHeap* pCBVSRVHeap = pManager->m_pCBVSRVUAVHeap;
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
-
-	hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 3);
-	BREAK_IF_FAILED(hr);
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-	CD3DX12_CPU_DESCRIPTOR_HANDLE nullHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), 14, CBV_SRV_DESCRIPTOR_SIZE);
-
-	// b2, b3
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingBoxMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingBoxMesh->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-	// t6(null)
-	pDevice->CopyDescriptorsSimple(1, dstHandle, nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
+	// index record of helper mesh points every texture at null view.
+	setMeshRootArguments(pCommandList, m_pBoundingBoxMesh);
 
 	pCommandList->IASetVertexBuffers(0, 1, &m_pBoundingBoxMesh->Vertex.VertexBufferView);
 	pCommandList->IASetIndexBuffer(&m_pBoundingBoxMesh->Index.IndexBufferView);
@@ -429,34 +384,11 @@ void Model::RenderBoundingSphere(Renderer* pRenderer, eRenderPSOType psoSetting)
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	ID3D12DescriptorHeap* pCBVSRVHeap = pManager->m_pCBVSRVUAVHeap;
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
-
-	hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 3);
-	BREAK_IF_FAILED(hr);
 
-	CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-	CD3DX12_CPU_DESCRIPTOR_HANDLE nullHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), 14, CBV_SRV_DESCRIPTOR_SIZE);
-
-	// b2, b3
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingSphereMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingSphereMesh->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-	// t6(null)
-	pDevice->CopyDescriptorsSimple(1, dstHandle, nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
+	// index record of helper mesh points every texture at null view.
+	setMeshRootArguments(pCommandList, m_pBoundingSphereMesh);
 
 	pCommandList->IASetVertexBuffers(0, 1, &m_pBoundingSphereMesh->Vertex.VertexBufferView);
 	pCommandList->IASetIndexBuffer(&m_pBoundingSphereMesh->Index.IndexBufferView);
@@ -465,6 +397,14 @@ void Model::RenderBoundingSphere(Renderer* pRenderer, eRenderPSOType psoSetting)
 
 void Model::Cleanup()
 {
+	// pending texture loads point into meshes below.
+	if (m_pTextureCache)
+	{
+		m_pTextureCache->CancelWaiters(this);
+		m_pTextureCache = nullptr;
+	}
+	m_pResourceManager = nullptr;
+
 	if (m_pBoundingSphereMesh)
 	{
 		delete m_pBoundingSphereMesh;
@@ -495,12 +435,11 @@ void Model::SetDescriptorHeap(Renderer* pRenderer)
 	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
 	CD3DX12_CPU_DESCRIPTOR_HANDLE cbvSrvLastHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), pManager->m_CBVSRVUAVHeapSize, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.Texture2D.MipLevels = (UINT)-1; // whole mip chain.
 	srvDesc.Texture2D.MostDetailedMip = 0;
 	srvDesc.Texture2D.PlaneSlice = 0;
 	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
@@ -509,91 +448,93 @@ void Model::SetDescriptorHeap(Renderer* pRenderer)
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* pCurMesh = Meshes[i];
-		ConstantBuffer& meshConstant = pCurMesh->MeshConstant;
-		ConstantBuffer& materialConstant = pCurMesh->MaterialConstant;
 		Material* pMaterialBuffer = &pCurMesh->Material;
 
-		cbvDesc.BufferLocation = meshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)meshConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		meshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = materialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)materialConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		materialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
+		// mesh and material constants are bound as root CBVs, textures by slot of bindless range.
 		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Albedo.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Albedo.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Albedo.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Emissive.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Emissive.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Emissive.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
 		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Normal.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Normal.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Normal.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->AmbientOcclusion.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->AmbientOcclusion.SetSRVHandle(cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->ORMH.GetResource(), srvDesc, cbvSrvLastHandle);
+		pMaterialBuffer->ORMH.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Metallic.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Metallic.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
+		registerBindlessTextures(pManager->GetBindlessDescriptorPool(), pCurMesh);
+	}
+}
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Roughness.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Roughness.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
+void Model::updateMeshConstants()
+{
+	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
+	{
+		Mesh* pCurMesh = Meshes[i];
+		pCurMesh->MeshConstant.Upload();
+		pCurMesh->MaterialConstant.Upload();
+		refreshBindlessTextures(pCurMesh);
+	}
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Height.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Height.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
+	m_pBoundingBoxMesh->MeshConstant.Upload();
+	m_pBoundingBoxMesh->MaterialConstant.Upload();
+	m_pBoundingSphereMesh->MeshConstant.Upload();
+	m_pBoundingSphereMesh->MaterialConstant.Upload();
+}
+
+void Model::registerBindlessTextures(BindlessDescriptorPool* pBindlessPool, Mesh* pMesh)
+{
+	_ASSERT(pBindlessPool);
+	_ASSERT(pMesh);
+	_ASSERT(!pMesh->pBindlessPool);
+
+	Material* pMaterial = &pMesh->Material;
+	pMesh->IndexRecord.Albedo = pBindlessPool->Register(pMaterial->Albedo.GetSRVHandle());
+	pMesh->IndexRecord.Emissive = pBindlessPool->Register(pMaterial->Emissive.GetSRVHandle());
+	pMesh->IndexRecord.Normal = pBindlessPool->Register(pMaterial->Normal.GetSRVHandle());
+	pMesh->IndexRecord.ORMH = pBindlessPool->Register(pMaterial->ORMH.GetSRVHandle());
+	pMesh->pBindlessPool = pBindlessPool;
+	pMesh->IndexRecordVersion = pMesh->MaterialConstant.GetVersion();
+}
+
+void Model::refreshBindlessTextures(Mesh* pMesh)
+{
+	_ASSERT(pMesh);
+
+	const UINT64 VERSION = pMesh->MaterialConstant.GetVersion();
+	if (!pMesh->pBindlessPool || pMesh->IndexRecordVersion == VERSION)
+	{
+		return;
 	}
 
-	// bounding box
-	cbvDesc.BufferLocation = m_pBoundingBoxMesh->MeshConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingBoxMesh->MeshConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingBoxMesh->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	cbvDesc.BufferLocation = m_pBoundingBoxMesh->MaterialConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingBoxMesh->MaterialConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingBoxMesh->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	// bounding sphere
-	cbvDesc.BufferLocation = m_pBoundingSphereMesh->MeshConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingSphereMesh->MeshConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingSphereMesh->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	cbvDesc.BufferLocation = m_pBoundingSphereMesh->MaterialConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingSphereMesh->MaterialConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingSphereMesh->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
+	// slots stay, only views are copied again. GPU is done with last frame, see Renderer::present().
+	Material* pMaterial = &pMesh->Material;
+	pMesh->pBindlessPool->Refresh(pMaterial->Albedo.GetSRVHandle());
+	pMesh->pBindlessPool->Refresh(pMaterial->Emissive.GetSRVHandle());
+	pMesh->pBindlessPool->Refresh(pMaterial->Normal.GetSRVHandle());
+	pMesh->pBindlessPool->Refresh(pMaterial->ORMH.GetSRVHandle());
+	pMesh->IndexRecordVersion = VERSION;
+}
+
+void Model::setMeshRootArguments(ID3D12GraphicsCommandList* pCommandList, Mesh* pMesh)
+{
+	_ASSERT(pCommandList);
+	_ASSERT(pMesh);
+
+	pCommandList->SetGraphicsRootConstantBufferView(MeshRootParameter_MeshConstant, pMesh->MeshConstant.GetGPUMemAddr());
+	pCommandList->SetGraphicsRootConstantBufferView(MeshRootParameter_MaterialConstant, pMesh->MaterialConstant.GetGPUMemAddr());
+	pCommandList->SetGraphicsRoot32BitConstants(MeshRootParameter_BindlessIndices, BINDLESS_INDEX_RECORD_SIZE, &pMesh->IndexRecord, 0);
 }
 
 void Model::initBoundingBox(Renderer* pRenderer, const std::vector<MeshInfo>& MESH_INFOS)
@@ -654,6 +595,130 @@ void Model::initBoundingSphere(Renderer* pRenderer, const std::vector<MeshInfo>&
 	InitMeshBuffers(pRenderer, meshData, m_pBoundingSphereMesh);
 }
 
+void Model::initVertexBuffer(Renderer* pRenderer, const MeshInfo& MESH_INFO, Mesh* pNewMesh, bool bUseSkinnedVertices)
+{
+	_ASSERT(pRenderer);
+	_ASSERT(pNewMesh);
+
+	HRESULT hr = S_OK;
+	ResourceManager* pManager = pRenderer->GetResourceManager();
+	const UINT VERTEX_COUNT = (UINT)(bUseSkinnedVertices ? MESH_INFO.SkinnedVertices.size() : MESH_INFO.Vertices.size());
+
+#ifdef USE_COMPACT_VERTEX
+	// dequantization parameters go to mesh constant. MeshConstant must be initialized before.
+	VertexQuantization quantization;
+	ComputeVertexQuantization(MESH_INFO, &quantization);
+
+	MeshConstant* pMeshConst = (MeshConstant*)pNewMesh->MeshConstant.pData;
+	_ASSERT(pMeshConst);
+	pMeshConst->PositionOffset = quantization.PositionOffset;
+	pMeshConst->PositionScale = quantization.PositionScale;
+
+#ifdef _DEBUG
+	if (!ValidateCompactVertices(MESH_INFO, quantization))
+	{
+		OutputDebugStringA("Compact vertex round trip exceeds error bound.\n");
+	}
+#endif
+
+	if (bUseSkinnedVertices)
+	{
+		std::vector<CompactSkinnedVertex> compactVertices;
+		EncodeCompactSkinnedVertices(MESH_INFO.SkinnedVertices, quantization, &compactVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(CompactSkinnedVertex), VERTEX_COUNT, &pNewMesh->Vertex.VertexBufferView, &pNewMesh->Vertex.Allocation, (void*)compactVertices.data());
+		BREAK_IF_FAILED(hr);
+
+		std::vector<CompactDepthOnlySkinnedVertex> depthOnlyVertices;
+		BuildCompactDepthOnlySkinnedVertices(compactVertices, &depthOnlyVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(CompactDepthOnlySkinnedVertex), VERTEX_COUNT, &pNewMesh->DepthOnlyVertex.VertexBufferView, &pNewMesh->DepthOnlyVertex.Allocation, (void*)depthOnlyVertices.data());
+	}
+	else
+	{
+		std::vector<CompactVertex> compactVertices;
+		EncodeCompactVertices(MESH_INFO.Vertices, quantization, &compactVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(CompactVertex), VERTEX_COUNT, &pNewMesh->Vertex.VertexBufferView, &pNewMesh->Vertex.Allocation, (void*)compactVertices.data());
+		BREAK_IF_FAILED(hr);
+
+		std::vector<CompactDepthOnlyVertex> depthOnlyVertices;
+		BuildCompactDepthOnlyVertices(compactVertices, &depthOnlyVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(CompactDepthOnlyVertex), VERTEX_COUNT, &pNewMesh->DepthOnlyVertex.VertexBufferView, &pNewMesh->DepthOnlyVertex.Allocation, (void*)depthOnlyVertices.data());
+	}
+#else
+	if (bUseSkinnedVertices)
+	{
+		hr = pManager->CreateVertexBuffer(sizeof(SkinnedVertex), VERTEX_COUNT, &pNewMesh->Vertex.VertexBufferView, &pNewMesh->Vertex.Allocation, (void*)MESH_INFO.SkinnedVertices.data());
+		BREAK_IF_FAILED(hr);
+
+		std::vector<DepthOnlySkinnedVertex> depthOnlyVertices;
+		BuildDepthOnlySkinnedVertices(MESH_INFO.SkinnedVertices, &depthOnlyVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(DepthOnlySkinnedVertex), VERTEX_COUNT, &pNewMesh->DepthOnlyVertex.VertexBufferView, &pNewMesh->DepthOnlyVertex.Allocation, (void*)depthOnlyVertices.data());
+	}
+	else
+	{
+		hr = pManager->CreateVertexBuffer(sizeof(Vertex), VERTEX_COUNT, &pNewMesh->Vertex.VertexBufferView, &pNewMesh->Vertex.Allocation, (void*)MESH_INFO.Vertices.data());
+		BREAK_IF_FAILED(hr);
+
+		std::vector<DepthOnlyVertex> depthOnlyVertices;
+		BuildDepthOnlyVertices(MESH_INFO.Vertices, &depthOnlyVertices);
+		hr = pManager->CreateVertexBuffer(sizeof(DepthOnlyVertex), VERTEX_COUNT, &pNewMesh->DepthOnlyVertex.VertexBufferView, &pNewMesh->DepthOnlyVertex.Allocation, (void*)depthOnlyVertices.data());
+	}
+#endif
+	BREAK_IF_FAILED(hr);
+
+	pNewMesh->Vertex.Count = VERTEX_COUNT;
+	pNewMesh->DepthOnlyVertex.Count = VERTEX_COUNT;
+	pNewMesh->bSkinnedMesh = bUseSkinnedVertices;
+}
+
+void Model::initIndexBuffer(Renderer* pRenderer, const std::vector<UINT>& INDICES, const UINT VERTEX_COUNT, BufferInfo* pIndex)
+{
+	_ASSERT(pRenderer);
+	_ASSERT(pIndex);
+
+	HRESULT hr = S_OK;
+	ResourceManager* pManager = pRenderer->GetResourceManager();
+	const UINT INDEX_COUNT = (UINT)INDICES.size();
+
+	if (CanUseIndex16(VERTEX_COUNT))
+	{
+		std::vector<USHORT> indices16(INDEX_COUNT);
+		for (UINT i = 0; i < INDEX_COUNT; ++i)
+		{
+			_ASSERT(INDICES[i] < VERTEX_COUNT);
+			indices16[i] = (USHORT)INDICES[i];
+		}
+
+		hr = pManager->CreateIndexBuffer(sizeof(USHORT), INDEX_COUNT, &pIndex->IndexBufferView, &pIndex->Allocation, (void*)indices16.data());
+	}
+	else
+	{
+		hr = pManager->CreateIndexBuffer(sizeof(UINT), INDEX_COUNT, &pIndex->IndexBufferView, &pIndex->Allocation, (void*)INDICES.data());
+	}
+	BREAK_IF_FAILED(hr);
+
+	pIndex->Count = INDEX_COUNT;
+}
+
+void Model::initLODBuffers(Renderer* pRenderer, const std::vector<MeshLOD>& LODS, Mesh* pNewMesh)
+{
+	_ASSERT(pRenderer);
+
+	pNewMesh->LODCount = 1;
+	pNewMesh->CurrentLOD = 0;
+
+	for (UINT64 i = 0, size = LODS.size(); i < size && i < MAX_MESH_LOD_COUNT - 1; ++i)
+	{
+		const MeshLOD& LOD = LODS[i];
+		BufferInfo* pLODIndex = &pNewMesh->LODIndices[i];
+
+		// LODs share vertex buffer of LOD 0.
+		initIndexBuffer(pRenderer, LOD.Indices, pNewMesh->Vertex.Count, pLODIndex);
+
+		pNewMesh->LODErrors[i] = LOD.Error;
+		++(pNewMesh->LODCount);
+	}
+}
+
 DirectX::BoundingBox Model::getBoundingBox(const std::vector<Vertex>& VERTICES)
 {
 	using DirectX::SimpleMath::Vector3;
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "AnimationData.h"
-#include "../Util/LinkedList.h"
 #include "Mesh.h"
 #include "MeshInfo.h"
 #include "../Renderer/ResourceManager.h"
 
 using DirectX::SimpleMath::Matrix;
 
+class TextureCache;
+
 class Model
 {
 public:
@@ -23,6 +24,8 @@ public:
 
 	virtual void UpdateConstantBuffers();
 	void UpdateWorld(const Matrix& WORLD);
+	void UpdateLOD(const Vector3& EYE_POS, const float FOV_Y, const float SCREEN_HEIGHT);
+	void UpdateClusterCulling(const DirectX::BoundingFrustum& VIEW_FRUSTUM, const Vector3& EYE_POS);
 	virtual void UpdateAnimation(int clipID, int frame, const float DELTA_TIME) { }
 
 	virtual void Render(Renderer* pRenderer, eRenderPSOType psoSetting);
@@ -37,6 +40,17 @@ public:
 protected:
 	void initBoundingBox(Renderer* pRenderer, const std::vector<MeshInfo>& MESH_INFOS);
 	void initBoundingSphere(Renderer* pRenderer, const std::vector<MeshInfo>& MESH_INFOS);
+	void initVertexBuffer(Renderer* pRenderer, const MeshInfo& MESH_INFO, Mesh* pNewMesh, bool bUseSkinnedVertices);
+	void initIndexBuffer(Renderer* pRenderer, const std::vector<UINT>& INDICES, const UINT VERTEX_COUNT, BufferInfo* pIndex); // 16bit when VERTEX_COUNT allows.
+	void initLODBuffers(Renderer* pRenderer, const std::vector<MeshLOD>& LODS, Mesh* pNewMesh);
+
+	// uploads constants of meshes and helper meshes, then refreshes bindless slots of meshes whose material moved.
+	void updateMeshConstants();
+	// copies material SRVs into bindless range and fills index record. SRVs are made in SetDescriptorHeap().
+	void registerBindlessTextures(BindlessDescriptorPool* pBindlessPool, Mesh* pMesh);
+	void refreshBindlessTextures(Mesh* pMesh);
+	// b2, b3 of this frame's copies and index record. root signature is set in SetCommonState().
+	void setMeshRootArguments(ID3D12GraphicsCommandList* pCommandList, Mesh* pMesh);
 
 	DirectX::BoundingBox getBoundingBox(const std::vector<Vertex>& VERTICES);
 	void extendBoundingBox(const DirectX::BoundingBox& SRC_BOX, DirectX::BoundingBox* pDestBox);
@@ -58,9 +72,17 @@ public:
 	bool bCastShadow = true;
 	bool bIsPickable = false;
 
-	// ListElem LinkToList = { nullptr, nullptr, this };
+	float LODErrorThreshold = 1.0f; // pixel.
+
+	// cluster culling stats of last frame.
+	UINT ClusterTriangleCount = 0;
+	UINT CulledClusterTriangleCount = 0;
 
 protected:
 	Mesh* m_pBoundingBoxMesh = nullptr;
 	Mesh* m_pBoundingSphereMesh = nullptr;
+	TextureCache* m_pTextureCache = nullptr;
+	ResourceManager* m_pResourceManager = nullptr;
+
+	UINT64 m_WorldVersion = 0; // increases when UpdateWorld() changes World. 0 until first call.
 };
@@ -8,6 +8,8 @@
 #include <locale>
 #include "../pch.h"
 #include "../Util/Utility.h"
+#include "MeshSplitter.h"
+#include "TangentGenerator.h"
 #include "ModelLoader.h"
 
 HRESULT ModelLoader::Load(std::wstring& basePath, std::wstring& fileName, bool _bRevertNormal)
@@ -22,6 +24,7 @@ HRESULT ModelLoader::Load(std::wstring& basePath, std::wstring& fileName, bool _
 
 	std::string fileNameA(fileName.begin(), fileName.end());
 	szBasePath = std::string(basePath.begin(), basePath.end());
+	szFileName = fileNameA;
 
 	Assimp::Importer importer;
 	const aiScene* pSCENE = importer.ReadFile(szBasePath + fileNameA, aiProcess_Triangulate | aiProcess_ConvertToLeftHanded);
@@ -57,6 +60,9 @@ HRESULT ModelLoader::Load(std::wstring& basePath, std::wstring& fileName, bool _
 		}
 
 		updateTangents();
+
+		// meshes slightly over 16bit range are split so that they can use 16bit index buffer.
+		SplitMeshesForIndex16(&MeshInfos);
 	}
 	else
 	{
@@ -83,6 +89,7 @@ HRESULT ModelLoader::LoadAnimation(std::wstring& basePath, std::wstring& fileNam
 
 	std::string fileNameA(fileName.begin(), fileName.end());
 	szBasePath = std::string(basePath.begin(), basePath.end());
+	szFileName = fileNameA;
 
 	Assimp::Importer importer;
 	const aiScene* pSCENE = importer.ReadFile(szBasePath + fileNameA, aiProcess_Triangulate | aiProcess_ConvertToLeftHanded);
@@ -291,22 +298,22 @@ void ModelLoader::processMesh(aiMesh* pMesh, const aiScene* pSCENE, MeshInfo* pM
 	{
 		aiMaterial* pMaterial = pSCENE->mMaterials[pMesh->mMaterialIndex];
 
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_BASE_COLOR, &(pMeshInfo->szAlbedoTextureFileName));
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_BASE_COLOR, &(pMeshInfo->szAlbedoTextureFileName), pMeshInfo);
 		if (pMeshInfo->szAlbedoTextureFileName.empty())
 		{
-			readTextureFileName(pSCENE, pMaterial, aiTextureType_DIFFUSE, &(pMeshInfo->szAlbedoTextureFileName));
+			readTextureFileName(pSCENE, pMaterial, aiTextureType_DIFFUSE, &(pMeshInfo->szAlbedoTextureFileName), pMeshInfo);
 		}
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_EMISSIVE, &(pMeshInfo->szEmissiveTextureFileName));
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_HEIGHT, &(pMeshInfo->szHeightTextureFileName));
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_NORMALS, &(pMeshInfo->szNormalTextureFileName));
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_METALNESS, &(pMeshInfo->szMetallicTextureFileName));
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_DIFFUSE_ROUGHNESS, &(pMeshInfo->szRoughnessTextureFileName));
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_AMBIENT_OCCLUSION, &(pMeshInfo->szAOTextureFileName));
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_EMISSIVE, &(pMeshInfo->szEmissiveTextureFileName), pMeshInfo);
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_HEIGHT, &(pMeshInfo->szHeightTextureFileName), pMeshInfo);
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_NORMALS, &(pMeshInfo->szNormalTextureFileName), pMeshInfo);
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_METALNESS, &(pMeshInfo->szMetallicTextureFileName), pMeshInfo);
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_DIFFUSE_ROUGHNESS, &(pMeshInfo->szRoughnessTextureFileName), pMeshInfo);
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_AMBIENT_OCCLUSION, &(pMeshInfo->szAOTextureFileName), pMeshInfo);
 		if (pMeshInfo->szAOTextureFileName.empty())
 		{
-			readTextureFileName(pSCENE, pMaterial, aiTextureType_LIGHTMAP, &(pMeshInfo->szAOTextureFileName));
+			readTextureFileName(pSCENE, pMaterial, aiTextureType_LIGHTMAP, &(pMeshInfo->szAOTextureFileName), pMeshInfo);
 		}
-		readTextureFileName(pSCENE, pMaterial, aiTextureType_OPACITY, &(pMeshInfo->szOpacityTextureFileName)); //  ǥϴ ؽ.
+		readTextureFileName(pSCENE, pMaterial, aiTextureType_OPACITY, &(pMeshInfo->szOpacityTextureFileName), pMeshInfo); //  ǥϴ ؽ.
 
 		if (!pMeshInfo->szOpacityTextureFileName.empty())
 		{
@@ -367,7 +374,7 @@ void ModelLoader::readAnimation(const aiScene* pSCENE)
 	}
 }
 
-HRESULT ModelLoader::readTextureFileName(const aiScene* pSCENE, aiMaterial* pMaterial, aiTextureType type, std::wstring* pDst)
+HRESULT ModelLoader::readTextureFileName(const aiScene* pSCENE, aiMaterial* pMaterial, aiTextureType type, std::wstring* pDst, MeshInfo* pMeshInfo)
 {
 	HRESULT hr = S_OK;
 
@@ -386,12 +393,23 @@ HRESULT ModelLoader::readTextureFileName(const aiScene* pSCENE, aiMaterial* pMat
 			const aiTexture* pTEXTURE = pSCENE->GetEmbeddedTexture(filePath.C_Str());
 			if (pTEXTURE)
 			{
-				// Embedded texture ϰ png  .(png ƴ ..)
-				if (std::string(pTEXTURE->achFormatHint).find("png") != std::string::npos)
+				// decoded from memory later. model file name is in the name so cache keys don't collide between models.
+				std::string embeddedName = szBasePath + szFileName + "|" + filePath.C_Str();
+				*pDst = std::wstring(embeddedName.begin(), embeddedName.end());
+
+				std::shared_ptr<EmbeddedTexture> pEmbeddedTexture = readEmbeddedTexture(pTEXTURE, *pDst);
+				bool bAlreadyAdded = false;
+				for (UINT64 i = 0, size = pMeshInfo->EmbeddedTextures.size(); i < size; ++i)
+				{
+					if (pMeshInfo->EmbeddedTextures[i] == pEmbeddedTexture)
+					{
+						bAlreadyAdded = true;
+						break;
+					}
+				}
+				if (!bAlreadyAdded)
 				{
-					std::ofstream fileSystem(fullPath.c_str(), std::ios::binary | std::ios::out);
-					fileSystem.write((char*)pTEXTURE->pcData, pTEXTURE->mWidth);
-					fileSystem.close();
+					pMeshInfo->EmbeddedTextures.push_back(pEmbeddedTexture);
 				}
 			}
 			else
@@ -413,35 +431,83 @@ HRESULT ModelLoader::readTextureFileName(const aiScene* pSCENE, aiMaterial* pMat
 	return hr;
 }
 
-void ModelLoader::updateTangents()
+std::shared_ptr<EmbeddedTexture> ModelLoader::readEmbeddedTexture(const aiTexture* pTEXTURE, const std::wstring& NAME)
 {
-	for (UINT64 i = 0, size = MeshInfos.size(); i < size; ++i)
+	_ASSERT(pTEXTURE);
+
+	for (UINT64 i = 0, size = EmbeddedTextures.size(); i < size; ++i)
 	{
-		MeshInfo& curMeshInfo = MeshInfos[i];
-		std::vector<Vertex>& curVertices = curMeshInfo.Vertices;
-		std::vector<SkinnedVertex>& curSkinnedVertices = curMeshInfo.SkinnedVertices;
-		std::vector<uint32_t>& curIndices = curMeshInfo.Indices;
-		UINT64 numFaces = curIndices.size() / 3;
+		if (EmbeddedTextures[i]->Name == NAME)
+		{
+			return EmbeddedTextures[i];
+		}
+	}
 
-		DirectX::XMFLOAT3 tangent;
-		DirectX::XMFLOAT3 bitangent;
+	std::shared_ptr<EmbeddedTexture> pNewTexture = std::make_shared<EmbeddedTexture>();
+	pNewTexture->Name = NAME;
 
-		for (UINT64 j = 0; j < numFaces; ++j)
+	if (pTEXTURE->mHeight == 0)
+	{
+		// compressed. mWidth is byte size. stb finds format from header, so achFormatHint is not needed.
+		const UCHAR* pDATA = (const UCHAR*)pTEXTURE->pcData;
+		pNewTexture->Data.assign(pDATA, pDATA + pTEXTURE->mWidth);
+		pNewTexture->Width = 0;
+		pNewTexture->Height = 0;
+	}
+	else
+	{
+		// raw aiTexel(BGRA8).
+		const UINT64 TEXEL_COUNT = (UINT64)pTEXTURE->mWidth * pTEXTURE->mHeight;
+		pNewTexture->Data.resize(TEXEL_COUNT * 4);
+		for (UINT64 i = 0; i < TEXEL_COUNT; ++i)
 		{
-			calculateTangentBitangent(curVertices[curIndices[j * 3]], curVertices[curIndices[j * 3 + 1]], curVertices[curIndices[j * 3 + 2]], &tangent, &bitangent);
+			const aiTexel& TEXEL = pTEXTURE->pcData[i];
+			pNewTexture->Data[i * 4] = TEXEL.r;
+			pNewTexture->Data[i * 4 + 1] = TEXEL.g;
+			pNewTexture->Data[i * 4 + 2] = TEXEL.b;
+			pNewTexture->Data[i * 4 + 3] = TEXEL.a;
+		}
+		pNewTexture->Width = pTEXTURE->mWidth;
+		pNewTexture->Height = pTEXTURE->mHeight;
+	}
 
-			curVertices[curIndices[j * 3]].Tangent = tangent;
-			curVertices[curIndices[j * 3 + 1]].Tangent = tangent;
-			curVertices[curIndices[j * 3 + 2]].Tangent = tangent;
+	EmbeddedTextures.push_back(pNewTexture);
+	return pNewTexture;
+}
 
-			if (curSkinnedVertices.empty() == false) // vertices skinned vertices  ũ⸦  ִٰ .
-			{
-				curSkinnedVertices[curIndices[j * 3]].Tangent = tangent;
-				curSkinnedVertices[curIndices[j * 3 + 1]].Tangent = tangent;
-				curSkinnedVertices[curIndices[j * 3 + 2]].Tangent = tangent;
-			}
-		}
+void ModelLoader::updateTangents()
+{
+#ifdef _DEBUG
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER beginTime;
+	LARGE_INTEGER endTime;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&beginTime);
+#endif
+
+	TangentStats totalStats = {};
+	UINT vertexCount = 0;
+	for (UINT64 i = 0, size = MeshInfos.size(); i < size; ++i)
+	{
+		TangentStats stats;
+		GenerateTangents(&MeshInfos[i], &stats);
+
+		totalStats.DegenerateFaceCount += stats.DegenerateFaceCount;
+		totalStats.FallbackVertexCount += stats.FallbackVertexCount;
+		totalStats.MirroredVertexCount += stats.MirroredVertexCount;
+		totalStats.RangeCount = Max((int)totalStats.RangeCount, (int)stats.RangeCount);
+		vertexCount += (UINT)MeshInfos[i].Vertices.size();
 	}
+
+#ifdef _DEBUG
+	QueryPerformanceCounter(&endTime);
+
+	char debugString[256];
+	sprintf_s(debugString, "Tangents: %u meshes, %u vertices, up to %u ranges, %.3f ms. degenerate uv faces: %u, fallback vertices: %u, mirrored vertices: %u\n",
+			  (UINT)MeshInfos.size(), vertexCount, totalStats.RangeCount, (double)(endTime.QuadPart - beginTime.QuadPart) * 1000.0 / (double)frequency.QuadPart,
+			  totalStats.DegenerateFaceCount, totalStats.FallbackVertexCount, totalStats.MirroredVertexCount);
+	OutputDebugStringA(debugString);
+#endif
 }
 
 void ModelLoader::updateBoneIDs(aiNode* pNode, int* pCounter)
@@ -460,35 +526,3 @@ void ModelLoader::updateBoneIDs(aiNode* pNode, int* pCounter)
 		}
 	}
 }
-
-void ModelLoader::calculateTangentBitangent(const Vertex& V1, const Vertex& V2, const Vertex& V3, DirectX::XMFLOAT3* pTangent, DirectX::XMFLOAT3* pBitangent)
-{
-	DirectX::XMFLOAT3 vector1;
-	DirectX::XMFLOAT3 vector2;
-	DirectX::XMFLOAT2 tuVector;
-	DirectX::XMFLOAT2 tvVector;
-	DirectX::XMStoreFloat3(&vector1, V2.Position - V1.Position);
-	DirectX::XMStoreFloat3(&vector2, V3.Position - V1.Position);
-	DirectX::XMStoreFloat2(&tuVector, V2.Texcoord - V1.Texcoord);
-	DirectX::XMStoreFloat2(&tvVector, V2.Texcoord - V3.Texcoord);
-
-	float den = 1.0f / (tuVector.x * tvVector.y - tuVector.y * tvVector.x);
-
-	pTangent->x = (tvVector.y * vector1.x - tvVector.x * vector2.x) * den;
-	pTangent->y = (tvVector.y * vector1.y - tvVector.x * vector2.y) * den;
-	pTangent->z = (tvVector.y * vector1.z - tvVector.x * vector2.z) * den;
-
-	pBitangent->x = (tuVector.x * vector2.x - tuVector.y * vector1.x) * den;
-	pBitangent->y = (tuVector.x * vector2.y - tuVector.y * vector1.y) * den;
-	pBitangent->z = (tuVector.x * vector2.z - tuVector.y * vector1.z) * den;
-
-	float length = sqrt((pTangent->x * pTangent->x) + (pTangent->y * pTangent->y) + (pTangent->z * pTangent->z));
-	pTangent->x = pTangent->x / length;
-	pTangent->y = pTangent->y / length;
-	pTangent->z = pTangent->z / length;
-
-	length = sqrt((pBitangent->x * pBitangent->x) + (pBitangent->y * pBitangent->y) + (pBitangent->z * pBitangent->z));
-	pBitangent->x = pBitangent->x / length;
-	pBitangent->y = pBitangent->y / length;
-	pBitangent->z = pBitangent->z / length;
-}
@@ -7,6 +7,7 @@ struct aiNode;
 struct aiScene;
 struct aiMesh;
 struct aiMaterial;
+struct aiTexture;
 enum aiTextureType;
 
 class ModelLoader
@@ -26,16 +27,17 @@ protected:
 	void processMesh(aiMesh* pMesh, const aiScene* pSCENE, MeshInfo* pMeshInfo);
 
 	void readAnimation(const aiScene* pSCENE);
-	HRESULT readTextureFileName(const aiScene* pSCENE, aiMaterial* pMaterial, aiTextureType type, std::wstring* pDst);
+	HRESULT readTextureFileName(const aiScene* pSCENE, aiMaterial* pMaterial, aiTextureType type, std::wstring* pDst, MeshInfo* pMeshInfo);
+	std::shared_ptr<EmbeddedTexture> readEmbeddedTexture(const aiTexture* pTEXTURE, const std::wstring& NAME);
 
 	void updateTangents();
 	void updateBoneIDs(aiNode* pNode, int* pCounter);
 
-	void calculateTangentBitangent(const Vertex& V1, const Vertex& V2, const Vertex& V3, DirectX::XMFLOAT3* pTangent, DirectX::XMFLOAT3* pBitangent);
-
 public:
 	std::string szBasePath;
+	std::string szFileName;
 	std::vector<MeshInfo> MeshInfos;
+	std::vector<std::shared_ptr<EmbeddedTexture>> EmbeddedTextures;
 
 	AnimationData AnimData;
 
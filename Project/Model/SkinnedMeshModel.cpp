@@ -28,80 +28,24 @@ void SkinnedMeshModel::InitMeshBuffers(Renderer* pRenderer, const MeshInfo& MESH
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
-	ResourceManager* pManager = pRenderer->GetResourceManager();
-
 	// vertex buffer.
-	if (MESH_INFO.SkinnedVertices.size() > 0)
-	{
-		hr = pManager->CreateVertexBuffer(sizeof(SkinnedVertex),
-										  (UINT)MESH_INFO.SkinnedVertices.size(),
-										  &pNewMesh->Vertex.VertexBufferView,
-										  &pNewMesh->Vertex.pBuffer,
-										  (void*)MESH_INFO.SkinnedVertices.data());
-		BREAK_IF_FAILED(hr);
-		pNewMesh->Vertex.Count = (UINT)MESH_INFO.SkinnedVertices.size();
-		pNewMesh->bSkinnedMesh = true;
-	}
-	else
-	{
-		hr = pManager->CreateVertexBuffer(sizeof(Vertex),
-										  (UINT)MESH_INFO.Vertices.size(),
-										  &pNewMesh->Vertex.VertexBufferView,
-										  &pNewMesh->Vertex.pBuffer,
-										  (void*)MESH_INFO.Vertices.data());
-		BREAK_IF_FAILED(hr);
-		pNewMesh->Vertex.Count = (UINT)MESH_INFO.Vertices.size();
-	}
+	initVertexBuffer(pRenderer, MESH_INFO, pNewMesh, MESH_INFO.SkinnedVertices.size() > 0);
 
 	// index buffer.
-	hr = pManager->CreateIndexBuffer(sizeof(UINT),
-									 (UINT)MESH_INFO.Indices.size(),
-									 &pNewMesh->Index.IndexBufferView,
-									 &pNewMesh->Index.pBuffer,
-									 (void*)MESH_INFO.Indices.data());
-	BREAK_IF_FAILED(hr);
-	pNewMesh->Index.Count = (UINT)MESH_INFO.Indices.size();
+	initIndexBuffer(pRenderer, MESH_INFO.Indices, pNewMesh->Vertex.Count, &pNewMesh->Index);
+
+	initLODBuffers(pRenderer, MESH_INFO.LODs, pNewMesh);
 }
 
 void SkinnedMeshModel::InitMeshBuffers(Renderer* pRenderer, const MeshInfo& MESH_INFO, Mesh** ppNewMesh)
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
-	ResourceManager* pManager = pRenderer->GetResourceManager();
-
 	// vertex buffer.
-	if (MESH_INFO.SkinnedVertices.size() > 0)
-	{
-		hr = pManager->CreateVertexBuffer(sizeof(SkinnedVertex),
-										  (UINT)MESH_INFO.SkinnedVertices.size(),
-										  &(*ppNewMesh)->Vertex.VertexBufferView,
-										  &(*ppNewMesh)->Vertex.pBuffer,
-										  (void*)MESH_INFO.SkinnedVertices.data());
-		BREAK_IF_FAILED(hr);
-		(*ppNewMesh)->Vertex.Count = (UINT)MESH_INFO.SkinnedVertices.size();
-		(*ppNewMesh)->bSkinnedMesh = true;
-	}
-	else
-	{
-		hr = pManager->CreateVertexBuffer(sizeof(Vertex),
-										  (UINT)MESH_INFO.Vertices.size(),
-										  &(*ppNewMesh)->Vertex.VertexBufferView,
-										  &(*ppNewMesh)->Vertex.pBuffer,
-										  (void*)MESH_INFO.Vertices.data());
-		BREAK_IF_FAILED(hr);
-		(*ppNewMesh)->Vertex.Count = (UINT)MESH_INFO.Vertices.size();
-	}
+	initVertexBuffer(pRenderer, MESH_INFO, *ppNewMesh, MESH_INFO.SkinnedVertices.size() > 0);
 
 	// index buffer.
-	hr = pManager->CreateIndexBuffer(sizeof(UINT),
-									 (UINT)MESH_INFO.Indices.size(),
-									 &(*ppNewMesh)->Index.IndexBufferView,
-									 &(*ppNewMesh)->Index.pBuffer,
-									 (void*)MESH_INFO.Indices.data());
-	BREAK_IF_FAILED(hr);
-	(*ppNewMesh)->Index.Count = (UINT)MESH_INFO.Indices.size();
+	initIndexBuffer(pRenderer, MESH_INFO.Indices, (*ppNewMesh)->Vertex.Count, &(*ppNewMesh)->Index);
 }
 
 void SkinnedMeshModel::InitAnimationData(Renderer* pRenderer, const AnimationData& ANIM_DATA)
@@ -134,14 +78,19 @@ void SkinnedMeshModel::UpdateConstantBuffers()
 		return;
 	}
 
-	Model::UpdateConstantBuffers();
+	updateMeshConstants();
 	m_pBoundingCapsuleMesh->MeshConstant.Upload();
+	m_pBoundingCapsuleMesh->MaterialConstant.Upload();
 	for (int i = 0; i < 4; ++i)
 	{
 		m_ppRightArm[i]->MeshConstant.Upload();
+		m_ppRightArm[i]->MaterialConstant.Upload();
 		m_ppLeftArm[i]->MeshConstant.Upload();
+		m_ppLeftArm[i]->MaterialConstant.Upload();
 		m_ppRightLeg[i]->MeshConstant.Upload();
+		m_ppRightLeg[i]->MaterialConstant.Upload();
 		m_ppLeftLeg[i]->MeshConstant.Upload();
+		m_ppLeftLeg[i]->MaterialConstant.Upload();
 	}
 }
 
@@ -205,69 +154,28 @@ void SkinnedMeshModel::Render(Renderer* pRenderer, eRenderPSOType psoSetting)
 		return;
 	}
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-	bool bIsSkinnedPSO = false;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable;
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable;
 
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* const pCurMesh = Meshes[i];
+		BufferInfo* pVertex = &pCurMesh->Vertex;
+		setMeshRootArguments(pCommandList, pCurMesh);
 
 		switch (psoSetting)
 		{
 			case RenderPSOType_Skinned:
 			case RenderPSOType_ReflectionSkinned:
-			{
-				hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 10);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t7
-				pDevice->CopyDescriptorsSimple(1, dstHandle, BoneTransforms.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(2, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t0 ~ t5
-				pDevice->CopyDescriptorsSimple(6, dstHandle, pCurMesh->Material.Albedo.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(6, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t6
-				pDevice->CopyDescriptorsSimple(1, dstHandle, pCurMesh->Material.Height.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-
-			}
-			break;
+				break;
 
 			case RenderPSOType_DepthOnlySkinned:
 			case RenderPSOType_DepthOnlyCubeSkinned:
 			case RenderPSOType_DepthOnlyCascadeSkinned:
 			{
-				hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 3);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t7
-				pDevice->CopyDescriptorsSimple(1, dstHandle, BoneTransforms.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
+				// skinned depth only layout differs from SkinnedVertex. no fallback.
+				_ASSERT(pCurMesh->DepthOnlyVertex.Allocation.pResource);
+				pVertex = &pCurMesh->DepthOnlyVertex;
 			}
 			break;
 
@@ -276,9 +184,10 @@ void SkinnedMeshModel::Render(Renderer* pRenderer, eRenderPSOType psoSetting)
 				break;
 		}
 
-		pCommandList->IASetVertexBuffers(0, 1, &pCurMesh->Vertex.VertexBufferView);
-		pCommandList->IASetIndexBuffer(&pCurMesh->Index.IndexBufferView);
-		pCommandList->DrawIndexedInstanced(pCurMesh->Index.Count, 1, 0, 0, 0);
+		BufferInfo* pIndex = pCurMesh->GetCurrentIndex();
+		pCommandList->IASetVertexBuffers(0, 1, &pVertex->VertexBufferView);
+		pCommandList->IASetIndexBuffer(&pIndex->IndexBufferView);
+		pCommandList->DrawIndexedInstanced(pIndex->Count, 1, 0, 0, 0);
 	}
 }
 
@@ -293,65 +202,26 @@ void SkinnedMeshModel::Render(UINT threadIndex, ID3D12GraphicsCommandList* pComm
 		return;
 	}
 
-	HRESULT hr = S_OK;
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
-	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable;
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable;
-
+	// constants and bindless slots are written by main thread in UpdateConstantBuffers().
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* const pCurMesh = Meshes[i];
+		BufferInfo* pVertex = &pCurMesh->Vertex;
+		setMeshRootArguments(pCommandList, pCurMesh);
 
 		switch (psoSetting)
 		{
 			case RenderPSOType_Skinned: 
 			case RenderPSOType_ReflectionSkinned:
-			{
-				hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 10);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t7
-				pDevice->CopyDescriptorsSimple(1, dstHandle, BoneTransforms.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(2, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t0 ~ t5
-				pDevice->CopyDescriptorsSimple(6, dstHandle, pCurMesh->Material.Albedo.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(6, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t6
-				pDevice->CopyDescriptorsSimple(1, dstHandle, pCurMesh->Material.Height.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
-
-			}
-			break;
+				break;
 
 			case RenderPSOType_DepthOnlySkinned:
 			case RenderPSOType_DepthOnlyCubeSkinned:
 			case RenderPSOType_DepthOnlyCascadeSkinned:
 			{
-				hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 3);
-				BREAK_IF_FAILED(hr);
-
-				CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// t7
-				pDevice->CopyDescriptorsSimple(1, dstHandle, BoneTransforms.GetSRVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-				dstHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-
-				// b2, b3
-				pDevice->CopyDescriptorsSimple(2, dstHandle, pCurMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-				pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
+				// skinned depth only layout differs from SkinnedVertex. no fallback.
+				_ASSERT(pCurMesh->DepthOnlyVertex.Allocation.pResource);
+				pVertex = &pCurMesh->DepthOnlyVertex;
 			}
 			break;
 
@@ -360,9 +230,10 @@ void SkinnedMeshModel::Render(UINT threadIndex, ID3D12GraphicsCommandList* pComm
 				break;
 		}
 
-		pCommandList->IASetVertexBuffers(0, 1, &pCurMesh->Vertex.VertexBufferView);
-		pCommandList->IASetIndexBuffer(&pCurMesh->Index.IndexBufferView);
-		pCommandList->DrawIndexedInstanced(pCurMesh->Index.Count, 1, 0, 0, 0);
+		BufferInfo* pIndex = pCurMesh->GetCurrentIndex();
+		pCommandList->IASetVertexBuffers(0, 1, &pVertex->VertexBufferView);
+		pCommandList->IASetIndexBuffer(&pIndex->IndexBufferView);
+		pCommandList->DrawIndexedInstanced(pIndex->Count, 1, 0, 0, 0);
 	}
 }
 
@@ -370,34 +241,11 @@ void SkinnedMeshModel::RenderBoundingCapsule(Renderer* pRenderer, eRenderPSOType
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	ID3D12DescriptorHeap* pCBVSRVHeap = pManager->m_pCBVSRVUAVHeap;
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = {};
-
-	hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 3);
-	BREAK_IF_FAILED(hr);
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, CBV_SRV_DESCRIPTOR_SIZE);
-	CD3DX12_CPU_DESCRIPTOR_HANDLE nullHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), 14, CBV_SRV_DESCRIPTOR_SIZE);
-
-	// b2, b3
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingCapsuleMesh->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-	pDevice->CopyDescriptorsSimple(1, dstHandle, m_pBoundingCapsuleMesh->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	dstHandle.Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
 
-	// t6(null)
-	pDevice->CopyDescriptorsSimple(1, dstHandle, nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable);
+	// index record of helper mesh points every texture at null view.
+	setMeshRootArguments(pCommandList, m_pBoundingCapsuleMesh);
 
 	pCommandList->IASetVertexBuffers(0, 1, &m_pBoundingCapsuleMesh->Vertex.VertexBufferView);
 	pCommandList->IASetIndexBuffer(&m_pBoundingCapsuleMesh->Index.IndexBufferView);
@@ -408,105 +256,33 @@ void SkinnedMeshModel::RenderJointSphere(Renderer* pRenderer, eRenderPSOType pso
 {
 	_ASSERT(pRenderer);
 
-	HRESULT hr = S_OK;
 	ResourceManager* pManager = pRenderer->GetResourceManager();
-
-	ID3D12Device5* pDevice = pManager->m_pDevice;
 	ID3D12GraphicsCommandList* pCommandList = pManager->GetCommandList();
-	ID3D12DescriptorHeap* pCBVSRVHeap = pManager->m_pCBVSRVUAVHeap;
-	DynamicDescriptorPool* pDynamicDescriptorPool = pManager->m_pDynamicDescriptorPool;
-	const UINT CBV_SRV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable[16];
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable[16];
-	CD3DX12_CPU_DESCRIPTOR_HANDLE nullHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), 14, CBV_SRV_DESCRIPTOR_SIZE);
-
-	for (int i = 0; i < 16; ++i)
-	{
-		hr = pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable[i], &gpuDescriptorTable[i], 3);
-		BREAK_IF_FAILED(hr);
-	}
 
 	// render all chain spheres.
+	Mesh** ppChains[4] = { m_ppRightArm, m_ppLeftArm, m_ppRightLeg, m_ppLeftLeg };
+	for (int i = 0; i < 4; ++i)
 	{
-		int descriptorTableIndex = 0;
-		for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
 		{
-			// b2, b3
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppRightArm[i]->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppRightArm[i]->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-			// t6(null)
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+			Mesh* pSphere = ppChains[i][j];
+			setMeshRootArguments(pCommandList, pSphere);
 
-			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable[descriptorTableIndex]);
-
-			pCommandList->IASetVertexBuffers(0, 1, &m_ppRightArm[i]->Vertex.VertexBufferView);
-			pCommandList->IASetIndexBuffer(&m_ppRightArm[i]->Index.IndexBufferView);
-			pCommandList->DrawIndexedInstanced(m_ppRightArm[i]->Index.Count, 1, 0, 0, 0);
-			++descriptorTableIndex;
-		}
-		for (int i = 0; i < 4; ++i)
-		{
-			// b2, b3
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppLeftArm[i]->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppLeftArm[i]->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-			// t6(null)
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable[descriptorTableIndex]);
-
-			pCommandList->IASetVertexBuffers(0, 1, &m_ppLeftArm[i]->Vertex.VertexBufferView);
-			pCommandList->IASetIndexBuffer(&m_ppLeftArm[i]->Index.IndexBufferView);
-			pCommandList->DrawIndexedInstanced(m_ppLeftArm[i]->Index.Count, 1, 0, 0, 0);
-			++descriptorTableIndex;
-		}
-		for (int i = 0; i < 4; ++i)
-		{
-			// b2, b3
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppRightLeg[i]->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppRightLeg[i]->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-			// t6(null)
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable[descriptorTableIndex]);
-
-			pCommandList->IASetVertexBuffers(0, 1, &m_ppRightLeg[i]->Vertex.VertexBufferView);
-			pCommandList->IASetIndexBuffer(&m_ppRightLeg[i]->Index.IndexBufferView);
-			pCommandList->DrawIndexedInstanced(m_ppRightLeg[i]->Index.Count, 1, 0, 0, 0);
-			++descriptorTableIndex;
-		}
-		for (int i = 0; i < 4; ++i)
-		{
-			// b2, b3
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppLeftLeg[i]->MeshConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], m_ppLeftLeg[i]->MaterialConstant.GetCBVHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			cpuDescriptorTable[descriptorTableIndex].Offset(1, CBV_SRV_DESCRIPTOR_SIZE);
-
-			// t6(null)
-			pDevice->CopyDescriptorsSimple(1, cpuDescriptorTable[descriptorTableIndex], nullHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-			pCommandList->SetGraphicsRootDescriptorTable(0, gpuDescriptorTable[descriptorTableIndex]);
-
-			pCommandList->IASetVertexBuffers(0, 1, &m_ppLeftLeg[i]->Vertex.VertexBufferView);
-			pCommandList->IASetIndexBuffer(&m_ppLeftLeg[i]->Index.IndexBufferView);
-			pCommandList->DrawIndexedInstanced(m_ppLeftLeg[i]->Index.Count, 1, 0, 0, 0);
-			++descriptorTableIndex;
+			pCommandList->IASetVertexBuffers(0, 1, &pSphere->Vertex.VertexBufferView);
+			pCommandList->IASetIndexBuffer(&pSphere->Index.IndexBufferView);
+			pCommandList->DrawIndexedInstanced(pSphere->Index.Count, 1, 0, 0, 0);
 		}
 	}
 }
 
 void SkinnedMeshModel::Cleanup()
 {
+	if (m_pBindlessPool)
+	{
+		m_pBindlessPool->Unregister(BoneTransforms.GetSRVHandle());
+		m_pBindlessPool = nullptr;
+		m_BoneBufferIndex = BINDLESS_NULL_DESCRIPTOR_INDEX;
+	}
 	BoneTransforms.Clear();
 
 	for (int i = 0; i < 4; ++i)
@@ -550,13 +326,11 @@ void SkinnedMeshModel::SetDescriptorHeap(Renderer* pRenderer)
 	const UINT CBV_SRV_UAV_DESCRIPTOR_SIZE = pManager->m_CBVSRVUAVDescriptorSize;
 	CD3DX12_CPU_DESCRIPTOR_HANDLE cbvSrvLastHandle(pCBVSRVHeap->GetCPUDescriptorHandleForHeapStart(), pManager->m_CBVSRVUAVHeapSize, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	srvDesc.Texture2D.MipLevels = 1;
+	srvDesc.Texture2D.MipLevels = (UINT)-1; // whole mip chain.
 	srvDesc.Texture2D.MostDetailedMip = 0;
 	srvDesc.Texture2D.PlaneSlice = 0;
 	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
@@ -567,7 +341,7 @@ void SkinnedMeshModel::SetDescriptorHeap(Renderer* pRenderer)
 		structuredSRVDesc.Format = DXGI_FORMAT_UNKNOWN;
 		structuredSRVDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
 		structuredSRVDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		structuredSRVDesc.Buffer.FirstElement = 0;
+		structuredSRVDesc.Buffer.FirstElement = BoneTransforms.GetFirstElement();
 		structuredSRVDesc.Buffer.NumElements = (UINT)(BoneTransforms.ElementCount);
 		structuredSRVDesc.Buffer.StructureByteStride = (UINT)(BoneTransforms.ElementSize);
 		structuredSRVDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
@@ -576,176 +350,43 @@ void SkinnedMeshModel::SetDescriptorHeap(Renderer* pRenderer)
 		BoneTransforms.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
+
+		// one slot shared by every mesh of this model.
+		m_pBindlessPool = pManager->GetBindlessDescriptorPool();
+		m_BoneBufferIndex = m_pBindlessPool->Register(BoneTransforms.GetSRVHandle());
 	}
 
 	// meshes.
 	for (UINT64 i = 0, size = Meshes.size(); i < size; ++i)
 	{
 		Mesh* pCurMesh = Meshes[i];
-		ConstantBuffer& meshConstant = pCurMesh->MeshConstant;
-		ConstantBuffer& materialConstant = pCurMesh->MaterialConstant;
 		Material* pMaterialBuffer = &pCurMesh->Material;
 
-		cbvDesc.BufferLocation = meshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(meshConstant.GetBufferSize());
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		meshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = materialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(materialConstant.GetBufferSize());
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		materialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
+		// mesh and material constants are bound as root CBVs, textures and bone buffer by slot of bindless range.
 		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Albedo.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Albedo.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Albedo.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Emissive.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Emissive.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Emissive.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
 		srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Normal.GetResource(), &srvDesc, cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->Normal.GetResource(), srvDesc, cbvSrvLastHandle);
 		pMaterialBuffer->Normal.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Height.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Height.SetSRVHandle(cbvSrvLastHandle);
+		CreateTextureSRV(pDevice, pMaterialBuffer->ORMH.GetResource(), srvDesc, cbvSrvLastHandle);
+		pMaterialBuffer->ORMH.SetSRVHandle(cbvSrvLastHandle);
 		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(pManager->m_CBVSRVUAVHeapSize);
 
-		pDevice->CreateShaderResourceView(pMaterialBuffer->AmbientOcclusion.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->AmbientOcclusion.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Metallic.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Metallic.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		pDevice->CreateShaderResourceView(pMaterialBuffer->Roughness.GetResource(), &srvDesc, cbvSrvLastHandle);
-		pMaterialBuffer->Roughness.SetSRVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-	}
-
-	// bounding box.
-	cbvDesc.BufferLocation = m_pBoundingBoxMesh->MeshConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingBoxMesh->MeshConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingBoxMesh->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	cbvDesc.BufferLocation = m_pBoundingBoxMesh->MaterialConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingBoxMesh->MaterialConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingBoxMesh->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	// bounding sphere.
-	cbvDesc.BufferLocation = m_pBoundingSphereMesh->MeshConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingSphereMesh->MeshConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingSphereMesh->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	cbvDesc.BufferLocation = m_pBoundingSphereMesh->MaterialConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingSphereMesh->MaterialConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingSphereMesh->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	// bounding capsule.
-	cbvDesc.BufferLocation = m_pBoundingCapsuleMesh->MeshConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingCapsuleMesh->MeshConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingCapsuleMesh->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	cbvDesc.BufferLocation = m_pBoundingCapsuleMesh->MaterialConstant.GetGPUMemAddr();
-	cbvDesc.SizeInBytes = (UINT)m_pBoundingCapsuleMesh->MaterialConstant.GetBufferSize();
-	pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-	m_pBoundingCapsuleMesh->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-	cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-	++(pManager->m_CBVSRVUAVHeapSize);
-
-	// all chains.
-	for (int i = 0; i < 4; ++i)
-	{
-		Mesh** ppRightArmPart = &m_ppRightArm[i];
-		Mesh** ppLeftArmPart = &m_ppLeftArm[i];
-		Mesh** ppRightLegPart = &m_ppRightLeg[i];
-		Mesh** ppLeftLegPart = &m_ppLeftLeg[i];
-
-		cbvDesc.BufferLocation = (*ppRightArmPart)->MeshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppRightArmPart)->MeshConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppRightArmPart)->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppRightArmPart)->MaterialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppRightArmPart)->MaterialConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppRightArmPart)->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppLeftArmPart)->MeshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppLeftArmPart)->MeshConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppLeftArmPart)->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppLeftArmPart)->MaterialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppLeftArmPart)->MaterialConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppLeftArmPart)->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppRightLegPart)->MeshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppRightLegPart)->MeshConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppRightLegPart)->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppRightLegPart)->MaterialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppRightLegPart)->MaterialConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppRightLegPart)->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppLeftLegPart)->MeshConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppLeftLegPart)->MeshConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppLeftLegPart)->MeshConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
-
-		cbvDesc.BufferLocation = (*ppLeftLegPart)->MaterialConstant.GetGPUMemAddr();
-		cbvDesc.SizeInBytes = (UINT)(*ppLeftLegPart)->MaterialConstant.GetBufferSize();
-		pDevice->CreateConstantBufferView(&cbvDesc, cbvSrvLastHandle);
-		(*ppLeftLegPart)->MaterialConstant.SetCBVHandle(cbvSrvLastHandle);
-		cbvSrvLastHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
-		++(pManager->m_CBVSRVUAVHeapSize);
+		registerBindlessTextures(m_pBindlessPool, pCurMesh);
+		pCurMesh->IndexRecord.BoneBuffer = m_BoneBufferIndex;
 	}
 }
 
@@ -1024,6 +665,9 @@ void SkinnedMeshModel::updateJointSpheres(int clipID, int frame)
 	pCapsuleMeshConst->World = pBoxMeshConst->World;
 	BoundingBox.Center = pBoxMeshConst->World.Transpose().Translation();
 	BoundingSphere.Center = BoundingBox.Center;
+	m_pBoundingBoxMesh->MeshConstant.MarkDirty();
+	m_pBoundingSphereMesh->MeshConstant.MarkDirty();
+	m_pBoundingCapsuleMesh->MeshConstant.MarkDirty();
 
 	// update debugging sphere for chain.
 	{
@@ -1143,6 +787,14 @@ void SkinnedMeshModel::updateJointSpheres(int clipID, int frame)
 			}
 		}
 
+		for (int i = 0; i < 4; ++i)
+		{
+			m_ppRightArm[i]->MeshConstant.MarkDirty();
+			m_ppLeftArm[i]->MeshConstant.MarkDirty();
+			m_ppRightLeg[i]->MeshConstant.MarkDirty();
+			m_ppLeftLeg[i]->MeshConstant.MarkDirty();
+		}
+
 		RightHandMiddle.Center = ppMeshConstants[3]->World.Transpose().Translation();
 		LeftHandMiddle.Center = ppMeshConstants[7]->World.Transpose().Translation();
 		RightToe.Center = ppMeshConstants[11]->World.Transpose().Translation();
@@ -62,4 +62,7 @@ private:
 	Mesh* m_ppRightLeg[4] = { nullptr, }; // right up leg - right leg - right foot - right toe.
 	Mesh* m_ppLeftLeg[4] = { nullptr, }; // left up leg - left leg - left foot - left toe.
 	Mesh* m_pBoundingCapsuleMesh = nullptr;
+
+	BindlessDescriptorPool* m_pBindlessPool = nullptr; // set when bone buffer is registered.
+	UINT m_BoneBufferIndex = BINDLESS_NULL_DESCRIPTOR_INDEX;
 };
@@ -0,0 +1,188 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "TangentGenerator.h"
+
+static const UINT MIN_TRIANGLES_PER_RANGE = 8192;
+static const UINT MIN_VERTICES_PER_RANGE = 8192;
+
+struct TangentJob
+{
+	const std::vector<Vertex>* pVertices;
+	const std::vector<UINT>* pIndices;
+	std::vector<Vertex>* pDstVertices;
+	std::vector<SkinnedVertex>* pDstSkinnedVertices;
+
+	// per range partial sums. [rangeIndex * VertexCount + vertex]
+	Vector3* pTangentSums;
+	Vector3* pBitangentSums;
+	UINT VertexCount;
+	UINT TriangleCount;
+	UINT RangeCount;
+
+	UINT DegenerateFaceCounts[MAX_PARALLEL_THREAD_COUNT];
+	UINT FallbackVertexCounts[MAX_PARALLEL_THREAD_COUNT];
+	UINT MirroredVertexCounts[MAX_PARALLEL_THREAD_COUNT];
+};
+
+// [begin, end) are triangle ranges, not triangles. so range count does not follow thread count.
+static void accumulateFaceTangents(UINT begin, UINT end, UINT threadRangeIndex, void* pArg)
+{
+	TangentJob* pJob = (TangentJob*)pArg;
+	const std::vector<Vertex>& VERTICES = *pJob->pVertices;
+	const std::vector<UINT>& INDICES = *pJob->pIndices;
+
+	for (UINT rangeIndex = begin; rangeIndex < end; ++rangeIndex)
+	{
+		Vector3* pTangentSums = pJob->pTangentSums + (UINT64)rangeIndex * pJob->VertexCount;
+		Vector3* pBitangentSums = pJob->pBitangentSums + (UINT64)rangeIndex * pJob->VertexCount;
+		const UINT TRIANGLE_BEGIN = (UINT)((UINT64)pJob->TriangleCount * rangeIndex / pJob->RangeCount);
+		const UINT TRIANGLE_END = (UINT)((UINT64)pJob->TriangleCount * (rangeIndex + 1) / pJob->RangeCount);
+		UINT degenerateFaceCount = 0;
+
+		for (UINT i = TRIANGLE_BEGIN; i < TRIANGLE_END; ++i)
+		{
+			const UINT* pTRI = &INDICES[(UINT64)i * 3];
+			const Vertex& V0 = VERTICES[pTRI[0]];
+			const Vertex& V1 = VERTICES[pTRI[1]];
+			const Vertex& V2 = VERTICES[pTRI[2]];
+
+			Vector3 e1 = V1.Position - V0.Position;
+			Vector3 e2 = V2.Position - V0.Position;
+
+			float du1 = V1.Texcoord.x - V0.Texcoord.x;
+			float dv1 = V1.Texcoord.y - V0.Texcoord.y;
+			float du2 = V2.Texcoord.x - V0.Texcoord.x;
+			float dv2 = V2.Texcoord.y - V0.Texcoord.y;
+			float det = du1 * dv2 - du2 * dv1;
+
+			// twice the area. used as weight so that slivers don't dominate.
+			float area = e1.Cross(e2).Length();
+			if (fabsf(det) < 1e-12f || area < 1e-12f)
+			{
+				++degenerateFaceCount;
+				continue;
+			}
+
+			float invDet = 1.0f / det;
+			Vector3 faceTangent = (e1 * dv2 - e2 * dv1) * invDet;
+			Vector3 faceBitangent = (e2 * du1 - e1 * du2) * invDet;
+			faceTangent.Normalize();
+			faceBitangent.Normalize();
+			faceTangent *= area;
+			faceBitangent *= area;
+
+			for (int j = 0; j < 3; ++j)
+			{
+				pTangentSums[pTRI[j]] += faceTangent;
+				pBitangentSums[pTRI[j]] += faceBitangent;
+			}
+		}
+
+		pJob->DegenerateFaceCounts[rangeIndex] = degenerateFaceCount;
+	}
+}
+
+static void resolveVertexTangents(UINT begin, UINT end, UINT rangeIndex, void* pArg)
+{
+	TangentJob* pJob = (TangentJob*)pArg;
+	std::vector<Vertex>& vertices = *pJob->pDstVertices;
+	std::vector<SkinnedVertex>* pSkinnedVertices = pJob->pDstSkinnedVertices;
+	const UINT VERTEX_COUNT = pJob->VertexCount;
+	UINT fallbackVertexCount = 0;
+	UINT mirroredVertexCount = 0;
+
+	for (UINT i = begin; i < end; ++i)
+	{
+		// reduce partial sums.
+		Vector3 t;
+		Vector3 b;
+		for (UINT r = 0; r < pJob->RangeCount; ++r)
+		{
+			t += pJob->pTangentSums[(UINT64)r * VERTEX_COUNT + i];
+			b += pJob->pBitangentSums[(UINT64)r * VERTEX_COUNT + i];
+		}
+
+		// Gram-Schmidt.
+		Vector3 n = vertices[i].Normal;
+		n.Normalize();
+		const float SUM_LENGTH_SQUARED = t.LengthSquared();
+		t -= n * n.Dot(t);
+
+		// relative to sum, which scales with face area. small faces of fine meshes are not degenerate.
+		if (SUM_LENGTH_SQUARED == 0.0f || t.LengthSquared() <= SUM_LENGTH_SQUARED * 1e-8f)
+		{
+			// no uv gradient. any vector perpendicular to normal.
+			Vector3 axis = (fabsf(n.x) < 0.9f ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 1.0f, 0.0f));
+			t = n.Cross(axis).Cross(n);
+			++fallbackVertexCount;
+		}
+		t.Normalize();
+
+		float handedness = (n.Cross(t).Dot(b) < 0.0f ? -1.0f : 1.0f);
+		if (handedness < 0.0f)
+		{
+			++mirroredVertexCount;
+		}
+
+		Vector4 tangent(t.x, t.y, t.z, handedness);
+		vertices[i].Tangent = tangent;
+		if (pSkinnedVertices)
+		{
+			(*pSkinnedVertices)[i].Tangent = tangent;
+		}
+	}
+
+	pJob->FallbackVertexCounts[rangeIndex] = fallbackVertexCount;
+	pJob->MirroredVertexCounts[rangeIndex] = mirroredVertexCount;
+}
+
+void GenerateTangents(MeshInfo* pMeshInfo, TangentStats* pStats, UINT rangeCount)
+{
+	_ASSERT(pMeshInfo);
+
+	const UINT VERTEX_COUNT = (UINT)pMeshInfo->Vertices.size();
+	const UINT TRIANGLE_COUNT = (UINT)(pMeshInfo->Indices.size() / 3);
+	if (pStats)
+	{
+		*pStats = {};
+	}
+	if (VERTEX_COUNT == 0 || TRIANGLE_COUNT == 0)
+	{
+		return;
+	}
+
+	if (rangeCount == 0)
+	{
+		rangeCount = GetParallelRangeCount(TRIANGLE_COUNT, MIN_TRIANGLES_PER_RANGE);
+	}
+	rangeCount = (UINT)Min((int)rangeCount, (int)Min((int)TRIANGLE_COUNT, (int)MAX_PARALLEL_THREAD_COUNT));
+
+	TangentJob job = {};
+	job.pVertices = &pMeshInfo->Vertices;
+	job.pIndices = &pMeshInfo->Indices;
+	job.pDstVertices = &pMeshInfo->Vertices;
+	job.pDstSkinnedVertices = (pMeshInfo->SkinnedVertices.size() == VERTEX_COUNT ? &pMeshInfo->SkinnedVertices : nullptr);
+	job.VertexCount = VERTEX_COUNT;
+	job.TriangleCount = TRIANGLE_COUNT;
+	job.RangeCount = rangeCount;
+
+	std::vector<Vector3> tangentSums((UINT64)rangeCount * VERTEX_COUNT);
+	std::vector<Vector3> bitangentSums((UINT64)rangeCount * VERTEX_COUNT);
+	job.pTangentSums = tangentSums.data();
+	job.pBitangentSums = bitangentSums.data();
+
+	// each triangle range writes its own partial sums. no atomics needed.
+	ParallelFor(rangeCount, 1, accumulateFaceTangents, &job);
+	ParallelFor(VERTEX_COUNT, MIN_VERTICES_PER_RANGE, resolveVertexTangents, &job);
+
+	if (pStats)
+	{
+		for (UINT i = 0; i < MAX_PARALLEL_THREAD_COUNT; ++i)
+		{
+			pStats->DegenerateFaceCount += job.DegenerateFaceCounts[i];
+			pStats->FallbackVertexCount += job.FallbackVertexCounts[i];
+			pStats->MirroredVertexCount += job.MirroredVertexCounts[i];
+		}
+		pStats->RangeCount = rangeCount;
+	}
+}
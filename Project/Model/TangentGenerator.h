@@ -0,0 +1,17 @@
+#pragma once
+
+#include "MeshInfo.h"
+
+struct TangentStats
+{
+	UINT DegenerateFaceCount; // no uv or position area. adds nothing to its vertices.
+	UINT FallbackVertexCount; // no uv gradient left after sums. tangent is any vector perpendicular to normal.
+	UINT MirroredVertexCount; // handedness -1.
+	UINT RangeCount; // triangle ranges summed separately.
+};
+
+// Accumulates area weighted per-face tangents into vertices, then Gram-Schmidt orthonormalizes against normal.
+// Tangent.w stores handedness(bitangent = cross(N, T) * w). Skinned vertices get same tangents when present.
+// Triangles are cut into ranges with partial sums, summed in range order. ranges run in parallel.
+// rangeCount 0 picks it from triangle and core count. result depends on range count only. pStats may be null.
+void GenerateTangents(MeshInfo* pMeshInfo, TangentStats* pStats = nullptr, UINT rangeCount = 0);
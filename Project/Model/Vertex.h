@@ -12,15 +12,58 @@ struct Vertex
 	Vector3 Position;
 	Vector3 Normal;
 	Vector2 Texcoord;
-	Vector3 Tangent; // BiTangent GPU .
+	Vector4 Tangent; // w: handedness. BiTangent GPU .
 };
 struct SkinnedVertex
 {
 	Vector3 Position;
 	Vector3 Normal;
 	Vector2 Texcoord;
-	Vector3 Tangent;
+	Vector4 Tangent;
 
 	float BlendWeights[8] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };  // BLENDWEIGHT0 and 1
 	UCHAR BoneIndices[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }; // BLENDINDICES0 and 1
 };
+
+// GPU side compact encoding. used when USE_COMPACT_VERTEX is defined.
+struct CompactVertex
+{
+	USHORT Position[4]; // unorm16 in mesh bounds. w: tangent handedness(0: -1, 65535: +1).
+	SHORT Normal[2];    // octahedral snorm16.
+	USHORT Texcoord[2]; // half.
+	SHORT Tangent[2];   // octahedral snorm16.
+};
+struct CompactSkinnedVertex
+{
+	USHORT Position[4];
+	SHORT Normal[2];
+	USHORT Texcoord[2];
+	SHORT Tangent[2];
+
+	UCHAR BlendWeights[8] = { 0, 0, 0, 0, 0, 0, 0, 0 }; // unorm8. sum is 255.
+	UCHAR BoneIndices[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+};
+
+// position(+skin) only streams for depth only passes. see VertexStream.h
+struct DepthOnlyVertex
+{
+	Vector3 Position;
+};
+struct DepthOnlySkinnedVertex
+{
+	Vector3 Position;
+
+	float BlendWeights[8] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	UCHAR BoneIndices[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+};
+struct CompactDepthOnlyVertex
+{
+	USHORT Position[4];
+};
+struct CompactDepthOnlySkinnedVertex
+{
+	USHORT Position[4];
+
+	UCHAR BlendWeights[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	UCHAR BoneIndices[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+};
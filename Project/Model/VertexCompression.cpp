@@ -0,0 +1,325 @@
+#include "../pch.h"
+#include <DirectXPackedVector.h>
+#include "../Util/Utility.h"
+#include "VertexCompression.h"
+
+using namespace DirectX::PackedVector;
+
+static Vector3 decodeOctahedral(const SHORT* pSRC)
+{
+	Vector3 v;
+	v.x = Max((float)pSRC[0] / 32767.0f, -1.0f);
+	v.y = Max((float)pSRC[1] / 32767.0f, -1.0f);
+	v.z = 1.0f - fabsf(v.x) - fabsf(v.y);
+
+	float t = Max(-v.z, 0.0f);
+	v.x += (v.x >= 0.0f ? -t : t);
+	v.y += (v.y >= 0.0f ? -t : t);
+	v.Normalize();
+
+	return v;
+}
+
+static void encodeOctahedral(const Vector3& V, SHORT* pDst)
+{
+	float l1Norm = fabsf(V.x) + fabsf(V.y) + fabsf(V.z);
+	if (l1Norm < 1e-12f)
+	{
+		pDst[0] = 0;
+		pDst[1] = 0;
+		return;
+	}
+
+	float x = V.x / l1Norm;
+	float y = V.y / l1Norm;
+	if (V.z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	// pick best of floor/ceil combination instead of plain rounding.
+	Vector3 target = V;
+	target.Normalize();
+
+	float baseX = floorf(Clamp(x, 1.0f, -1.0f) * 32767.0f);
+	float baseY = floorf(Clamp(y, 1.0f, -1.0f) * 32767.0f);
+	float bestDot = -2.0f;
+	for (int i = 0; i < 4; ++i)
+	{
+		SHORT candidate[2] =
+		{
+			(SHORT)Clamp(baseX + (float)(i & 1), 32767.0f, -32767.0f),
+			(SHORT)Clamp(baseY + (float)(i >> 1), 32767.0f, -32767.0f),
+		};
+
+		float dot = decodeOctahedral(candidate).Dot(target);
+		if (dot > bestDot)
+		{
+			bestDot = dot;
+			pDst[0] = candidate[0];
+			pDst[1] = candidate[1];
+		}
+	}
+}
+
+static USHORT encodeUnorm16(const float VALUE)
+{
+	return (USHORT)(Clamp(VALUE, 1.0f, 0.0f) * 65535.0f + 0.5f);
+}
+
+static void encodeCommon(const Vertex& SRC, const VertexQuantization& QUANTIZATION, USHORT* pPosition, SHORT* pNormal, USHORT* pTexcoord, SHORT* pTangent)
+{
+	Vector3 position = (SRC.Position - QUANTIZATION.PositionOffset) / QUANTIZATION.PositionScale;
+	pPosition[0] = encodeUnorm16(position.x);
+	pPosition[1] = encodeUnorm16(position.y);
+	pPosition[2] = encodeUnorm16(position.z);
+	pPosition[3] = (SRC.Tangent.w < 0.0f ? 0 : 65535);
+
+	encodeOctahedral(SRC.Normal, pNormal);
+	encodeOctahedral(Vector3(SRC.Tangent.x, SRC.Tangent.y, SRC.Tangent.z), pTangent);
+
+	pTexcoord[0] = XMConvertFloatToHalf(SRC.Texcoord.x);
+	pTexcoord[1] = XMConvertFloatToHalf(SRC.Texcoord.y);
+}
+
+static void decodeCommon(const USHORT* pPOSITION, const SHORT* pNORMAL, const USHORT* pTEXCOORD, const SHORT* pTANGENT, const VertexQuantization& QUANTIZATION, Vertex* pDst)
+{
+	Vector3 position((float)pPOSITION[0] / 65535.0f, (float)pPOSITION[1] / 65535.0f, (float)pPOSITION[2] / 65535.0f);
+	pDst->Position = position * QUANTIZATION.PositionScale + QUANTIZATION.PositionOffset;
+	pDst->Normal = decodeOctahedral(pNORMAL);
+	pDst->Texcoord = Vector2(XMConvertHalfToFloat(pTEXCOORD[0]), XMConvertHalfToFloat(pTEXCOORD[1]));
+
+	Vector3 tangent = decodeOctahedral(pTANGENT);
+	pDst->Tangent = Vector4(tangent.x, tangent.y, tangent.z, (pPOSITION[3] < 32768 ? -1.0f : 1.0f));
+}
+
+void ComputeVertexQuantization(const MeshInfo& MESH_INFO, VertexQuantization* pQuantization)
+{
+	_ASSERT(pQuantization);
+
+	*pQuantization = VertexQuantization();
+
+	Vector3 minCorner(FLT_MAX);
+	Vector3 maxCorner(-FLT_MAX);
+	if (!MESH_INFO.Vertices.empty())
+	{
+		for (UINT64 i = 0, size = MESH_INFO.Vertices.size(); i < size; ++i)
+		{
+			minCorner = Vector3::Min(minCorner, MESH_INFO.Vertices[i].Position);
+			maxCorner = Vector3::Max(maxCorner, MESH_INFO.Vertices[i].Position);
+		}
+	}
+	else if (!MESH_INFO.SkinnedVertices.empty())
+	{
+		for (UINT64 i = 0, size = MESH_INFO.SkinnedVertices.size(); i < size; ++i)
+		{
+			minCorner = Vector3::Min(minCorner, MESH_INFO.SkinnedVertices[i].Position);
+			maxCorner = Vector3::Max(maxCorner, MESH_INFO.SkinnedVertices[i].Position);
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	// flat axis keeps scale 1 to avoid division by zero.
+	Vector3 extents = maxCorner - minCorner;
+	pQuantization->PositionOffset = minCorner;
+	pQuantization->PositionScale = Vector3(extents.x > 1e-8f ? extents.x : 1.0f,
+										   extents.y > 1e-8f ? extents.y : 1.0f,
+										   extents.z > 1e-8f ? extents.z : 1.0f);
+}
+
+void EncodeCompactVertices(const std::vector<Vertex>& VERTICES, const VertexQuantization& QUANTIZATION, std::vector<CompactVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		CompactVertex& dst = (*pDst)[i];
+		encodeCommon(VERTICES[i], QUANTIZATION, dst.Position, dst.Normal, dst.Texcoord, dst.Tangent);
+	}
+}
+
+void EncodeCompactSkinnedVertices(const std::vector<SkinnedVertex>& VERTICES, const VertexQuantization& QUANTIZATION, std::vector<CompactSkinnedVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		const SkinnedVertex& SRC = VERTICES[i];
+		CompactSkinnedVertex& dst = (*pDst)[i];
+
+		Vertex common;
+		common.Position = SRC.Position;
+		common.Normal = SRC.Normal;
+		common.Texcoord = SRC.Texcoord;
+		common.Tangent = SRC.Tangent;
+		encodeCommon(common, QUANTIZATION, dst.Position, dst.Normal, dst.Texcoord, dst.Tangent);
+
+		// renormalize to 255 so that weights still sum to exactly 1 after quantization.
+		float weightSum = 0.0f;
+		for (int j = 0; j < 8; ++j)
+		{
+			weightSum += SRC.BlendWeights[j];
+		}
+
+		int quantizedSum = 0;
+		int maxIndex = 0;
+		for (int j = 0; j < 8; ++j)
+		{
+			float weight = (weightSum > 0.0f ? SRC.BlendWeights[j] / weightSum : 0.0f);
+			dst.BlendWeights[j] = (UCHAR)(Clamp(weight, 1.0f, 0.0f) * 255.0f + 0.5f);
+			dst.BoneIndices[j] = SRC.BoneIndices[j];
+
+			quantizedSum += dst.BlendWeights[j];
+			if (dst.BlendWeights[j] > dst.BlendWeights[maxIndex])
+			{
+				maxIndex = j;
+			}
+		}
+		if (quantizedSum > 0)
+		{
+			dst.BlendWeights[maxIndex] = (UCHAR)Clamp((float)(dst.BlendWeights[maxIndex] + 255 - quantizedSum), 255.0f, 0.0f);
+		}
+	}
+}
+
+void DecodeCompactVertex(const CompactVertex& SRC, const VertexQuantization& QUANTIZATION, Vertex* pDst)
+{
+	_ASSERT(pDst);
+	decodeCommon(SRC.Position, SRC.Normal, SRC.Texcoord, SRC.Tangent, QUANTIZATION, pDst);
+}
+
+void DecodeCompactSkinnedVertex(const CompactSkinnedVertex& SRC, const VertexQuantization& QUANTIZATION, SkinnedVertex* pDst)
+{
+	_ASSERT(pDst);
+
+	Vertex common;
+	decodeCommon(SRC.Position, SRC.Normal, SRC.Texcoord, SRC.Tangent, QUANTIZATION, &common);
+	pDst->Position = common.Position;
+	pDst->Normal = common.Normal;
+	pDst->Texcoord = common.Texcoord;
+	pDst->Tangent = common.Tangent;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		pDst->BlendWeights[i] = (float)SRC.BlendWeights[i] / 255.0f;
+		pDst->BoneIndices[i] = SRC.BoneIndices[i];
+	}
+}
+
+bool ValidateCompactVertices(const MeshInfo& MESH_INFO, const VertexQuantization& QUANTIZATION)
+{
+	// error bounds.
+	const Vector3 OFFSET = QUANTIZATION.PositionOffset;
+	const Vector3 MAX_POSITION_ERROR = QUANTIZATION.PositionScale / 65535.0f + (QUANTIZATION.PositionScale + Vector3(fabsf(OFFSET.x), fabsf(OFFSET.y), fabsf(OFFSET.z))) * 1e-6f;
+	const float MIN_DIRECTION_DOT = 0.9999f; // about 0.8 degree.
+	const float MAX_TEXCOORD_RELATIVE_ERROR = 1.0f / 1024.0f;
+	const float MAX_WEIGHT_ERROR = 5.0f / 255.0f;
+
+	Vector3 maxPositionError(0.0f);
+	float minNormalDot = 1.0f;
+	float minTangentDot = 1.0f;
+	float maxTexcoordError = 0.0f;
+	float maxWeightError = 0.0f;
+	UINT failCount = 0;
+
+	std::vector<CompactVertex> compactVertices;
+	EncodeCompactVertices(MESH_INFO.Vertices, QUANTIZATION, &compactVertices);
+
+	std::vector<CompactSkinnedVertex> compactSkinnedVertices;
+	EncodeCompactSkinnedVertices(MESH_INFO.SkinnedVertices, QUANTIZATION, &compactSkinnedVertices);
+
+	for (UINT64 i = 0, size = MESH_INFO.Vertices.size(); i < size; ++i)
+	{
+		const Vertex& SRC = MESH_INFO.Vertices[i];
+		Vertex decoded;
+		DecodeCompactVertex(compactVertices[i], QUANTIZATION, &decoded);
+
+		bool bFailed = false;
+
+		Vector3 positionError = decoded.Position - SRC.Position;
+		positionError = Vector3(fabsf(positionError.x), fabsf(positionError.y), fabsf(positionError.z));
+		maxPositionError = Vector3::Max(maxPositionError, positionError);
+		bFailed |= (positionError.x > MAX_POSITION_ERROR.x || positionError.y > MAX_POSITION_ERROR.y || positionError.z > MAX_POSITION_ERROR.z);
+
+		Vector3 srcNormal = SRC.Normal;
+		if (srcNormal.LengthSquared() > 1e-12f)
+		{
+			srcNormal.Normalize();
+			float dot = decoded.Normal.Dot(srcNormal);
+			minNormalDot = Min(minNormalDot, dot);
+			bFailed |= (dot < MIN_DIRECTION_DOT);
+		}
+
+		Vector3 srcTangent(SRC.Tangent.x, SRC.Tangent.y, SRC.Tangent.z);
+		if (srcTangent.LengthSquared() > 1e-12f)
+		{
+			srcTangent.Normalize();
+			float dot = Vector3(decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z).Dot(srcTangent);
+			minTangentDot = Min(minTangentDot, dot);
+			bFailed |= (dot < MIN_DIRECTION_DOT);
+			bFailed |= ((decoded.Tangent.w < 0.0f) != (SRC.Tangent.w < 0.0f));
+		}
+
+		for (int j = 0; j < 2; ++j)
+		{
+			float srcValue = (j == 0 ? SRC.Texcoord.x : SRC.Texcoord.y);
+			float decodedValue = (j == 0 ? decoded.Texcoord.x : decoded.Texcoord.y);
+			float error = fabsf(decodedValue - srcValue) / Max(fabsf(srcValue), 1.0f);
+			maxTexcoordError = Max(maxTexcoordError, error);
+			bFailed |= (error > MAX_TEXCOORD_RELATIVE_ERROR);
+		}
+
+		if (bFailed)
+		{
+			++failCount;
+		}
+	}
+
+	for (UINT64 i = 0, size = MESH_INFO.SkinnedVertices.size(); i < size; ++i)
+	{
+		const SkinnedVertex& SRC = MESH_INFO.SkinnedVertices[i];
+		SkinnedVertex decoded;
+		DecodeCompactSkinnedVertex(compactSkinnedVertices[i], QUANTIZATION, &decoded);
+
+		float weightSum = 0.0f;
+		for (int j = 0; j < 8; ++j)
+		{
+			weightSum += SRC.BlendWeights[j];
+		}
+
+		bool bFailed = false;
+		for (int j = 0; j < 8; ++j)
+		{
+			float srcWeight = (weightSum > 0.0f ? SRC.BlendWeights[j] / weightSum : 0.0f);
+			float error = fabsf(decoded.BlendWeights[j] - srcWeight);
+			maxWeightError = Max(maxWeightError, error);
+			bFailed |= (error > MAX_WEIGHT_ERROR);
+			bFailed |= (decoded.BoneIndices[j] != SRC.BoneIndices[j]);
+		}
+
+		if (bFailed)
+		{
+			++failCount;
+		}
+	}
+
+#ifdef _DEBUG
+	char debugString[512];
+	sprintf_s(debugString, "Compact vertices: %u vertices, %u skinned vertices, %u bytes -> %u bytes. max error position(%f, %f, %f) normal dot %f tangent dot %f uv %f weight %f. failed: %u\n",
+			  (UINT)MESH_INFO.Vertices.size(), (UINT)MESH_INFO.SkinnedVertices.size(),
+			  (UINT)(MESH_INFO.Vertices.size() * sizeof(Vertex) + MESH_INFO.SkinnedVertices.size() * sizeof(SkinnedVertex)),
+			  (UINT)(MESH_INFO.Vertices.size() * sizeof(CompactVertex) + MESH_INFO.SkinnedVertices.size() * sizeof(CompactSkinnedVertex)),
+			  maxPositionError.x, maxPositionError.y, maxPositionError.z, minNormalDot, minTangentDot, maxTexcoordError, maxWeightError, failCount);
+	OutputDebugStringA(debugString);
+#endif
+
+	return (failCount == 0);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "MeshInfo.h"
+
+// Dequantization: position = unorm16 position * PositionScale + PositionOffset.
+struct VertexQuantization
+{
+	Vector3 PositionOffset = Vector3(0.0f);
+	Vector3 PositionScale = Vector3(1.0f);
+};
+
+void ComputeVertexQuantization(const MeshInfo& MESH_INFO, VertexQuantization* pQuantization);
+
+void EncodeCompactVertices(const std::vector<Vertex>& VERTICES, const VertexQuantization& QUANTIZATION, std::vector<CompactVertex>* pDst);
+void EncodeCompactSkinnedVertices(const std::vector<SkinnedVertex>& VERTICES, const VertexQuantization& QUANTIZATION, std::vector<CompactSkinnedVertex>* pDst);
+
+void DecodeCompactVertex(const CompactVertex& SRC, const VertexQuantization& QUANTIZATION, Vertex* pDst);
+void DecodeCompactSkinnedVertex(const CompactSkinnedVertex& SRC, const VertexQuantization& QUANTIZATION, SkinnedVertex* pDst);
+
+// Round trip check against error bounds. returns false if any vertex exceeds them.
+bool ValidateCompactVertices(const MeshInfo& MESH_INFO, const VertexQuantization& QUANTIZATION);
@@ -0,0 +1,64 @@
+#include "../pch.h"
+#include "VertexStream.h"
+
+// must match depth only input layouts in ResourceManager::initShaders().
+static_assert(sizeof(DepthOnlyVertex) == 12, "DepthOnlyVertex layout mismatch.");
+static_assert(sizeof(DepthOnlySkinnedVertex) == 52, "DepthOnlySkinnedVertex layout mismatch.");
+static_assert(offsetof(DepthOnlySkinnedVertex, BlendWeights) == 12 && offsetof(DepthOnlySkinnedVertex, BoneIndices) == 44, "DepthOnlySkinnedVertex layout mismatch.");
+static_assert(sizeof(CompactDepthOnlyVertex) == 8, "CompactDepthOnlyVertex layout mismatch.");
+static_assert(sizeof(CompactDepthOnlySkinnedVertex) == 24, "CompactDepthOnlySkinnedVertex layout mismatch.");
+static_assert(offsetof(CompactDepthOnlySkinnedVertex, BlendWeights) == 8 && offsetof(CompactDepthOnlySkinnedVertex, BoneIndices) == 16, "CompactDepthOnlySkinnedVertex layout mismatch.");
+
+void BuildDepthOnlyVertices(const std::vector<Vertex>& VERTICES, std::vector<DepthOnlyVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		(*pDst)[i].Position = VERTICES[i].Position;
+	}
+}
+
+void BuildDepthOnlySkinnedVertices(const std::vector<SkinnedVertex>& VERTICES, std::vector<DepthOnlySkinnedVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		const SkinnedVertex& SRC = VERTICES[i];
+		DepthOnlySkinnedVertex& dst = (*pDst)[i];
+
+		dst.Position = SRC.Position;
+		memcpy(dst.BlendWeights, SRC.BlendWeights, sizeof(SRC.BlendWeights));
+		memcpy(dst.BoneIndices, SRC.BoneIndices, sizeof(SRC.BoneIndices));
+	}
+}
+
+void BuildCompactDepthOnlyVertices(const std::vector<CompactVertex>& VERTICES, std::vector<CompactDepthOnlyVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		memcpy((*pDst)[i].Position, VERTICES[i].Position, sizeof(VERTICES[i].Position));
+	}
+}
+
+void BuildCompactDepthOnlySkinnedVertices(const std::vector<CompactSkinnedVertex>& VERTICES, std::vector<CompactDepthOnlySkinnedVertex>* pDst)
+{
+	_ASSERT(pDst);
+
+	pDst->resize(VERTICES.size());
+	for (UINT64 i = 0, size = VERTICES.size(); i < size; ++i)
+	{
+		const CompactSkinnedVertex& SRC = VERTICES[i];
+		CompactDepthOnlySkinnedVertex& dst = (*pDst)[i];
+
+		memcpy(dst.Position, SRC.Position, sizeof(SRC.Position));
+		memcpy(dst.BlendWeights, SRC.BlendWeights, sizeof(SRC.BlendWeights));
+		memcpy(dst.BoneIndices, SRC.BoneIndices, sizeof(SRC.BoneIndices));
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "MeshInfo.h"
+
+// Deinterleaved streams for depth only passes. Only position(and skin data) is fetched,
+// which shrinks vertex stride from 48/88 to 12/52 bytes(20/36 to 8/24 with compact vertex).
+void BuildDepthOnlyVertices(const std::vector<Vertex>& VERTICES, std::vector<DepthOnlyVertex>* pDst);
+void BuildDepthOnlySkinnedVertices(const std::vector<SkinnedVertex>& VERTICES, std::vector<DepthOnlySkinnedVertex>* pDst);
+
+// Copies already quantized position, so depth passes rasterize exactly the same positions as main pass.
+void BuildCompactDepthOnlyVertices(const std::vector<CompactVertex>& VERTICES, std::vector<CompactDepthOnlyVertex>* pDst);
+void BuildCompactDepthOnlySkinnedVertices(const std::vector<CompactSkinnedVertex>& VERTICES, std::vector<CompactDepthOnlySkinnedVertex>* pDst);
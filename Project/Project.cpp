@@ -25,6 +25,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 		delete pApp;
 		pApp = nullptr;
 	}
+	ShutdownParallelFor();
 
 #ifdef _DEBUG
 	CheckD3DMemoryLeak();
@@ -0,0 +1,413 @@
+#include "../pch.h"
+#include <float.h>
+#include "../Util/Utility.h"
+#include "AssetStreamer.h"
+
+static UINT WINAPI streamingIOThread(void* pArg)
+{
+	AssetStreamer* pStreamer = (AssetStreamer*)pArg;
+	pStreamer->ProcessIO();
+
+	_endthreadex(0);
+	return 0;
+}
+
+static UINT WINAPI streamingDecodeThread(void* pArg)
+{
+	AssetStreamer* pStreamer = (AssetStreamer*)pArg;
+	pStreamer->ProcessDecode();
+
+	_endthreadex(0);
+	return 0;
+}
+
+void AssetStreamer::Initialize(UINT decodeThreadCount)
+{
+	_ASSERT(!m_bInitialized);
+
+	if (decodeThreadCount < 1)
+	{
+		decodeThreadCount = 1;
+	}
+	if (decodeThreadCount > MAX_STREAMING_DECODE_THREAD_COUNT)
+	{
+		decodeThreadCount = MAX_STREAMING_DECODE_THREAD_COUNT;
+	}
+
+	InitializeCriticalSection(&m_Lock);
+	QueryPerformanceFrequency(&m_QPCFrequency);
+
+	m_hIOSemaphore = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+	m_hDecodeSemaphore = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+	m_hCompletionEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	m_hDestroyEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+	UINT threadID = 0;
+	m_hIOThread = (HANDLE)_beginthreadex(nullptr, 0, streamingIOThread, this, 0, &threadID);
+	SetThreadPriority(m_hIOThread, THREAD_PRIORITY_BELOW_NORMAL);
+
+	m_DecodeThreadCount = decodeThreadCount;
+	for (UINT i = 0; i < m_DecodeThreadCount; ++i)
+	{
+		m_phDecodeThreads[i] = (HANDLE)_beginthreadex(nullptr, 0, streamingDecodeThread, this, 0, &threadID);
+		SetThreadPriority(m_phDecodeThreads[i], THREAD_PRIORITY_BELOW_NORMAL);
+	}
+
+	m_bInitialized = true;
+}
+
+void AssetStreamer::Request(const WCHAR* pszFileName, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData)
+{
+	StreamingRequest* pNewRequest = createRequest(pszFileName, priority, pfnDecode, pfnComplete, pOwner, pUserData);
+
+	EnterCriticalSection(&m_Lock);
+	m_IOQueues[priority].PushBack(pNewRequest);
+	++m_PendingCount;
+	++m_Stats.RequestCount;
+	LeaveCriticalSection(&m_Lock);
+
+	ReleaseSemaphore(m_hIOSemaphore, 1, nullptr);
+}
+
+void AssetStreamer::RequestFromMemory(const WCHAR* pszName, const UCHAR* pDATA, const UINT64 DATA_SIZE, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData)
+{
+	_ASSERT(pDATA);
+	_ASSERT(pfnDecode);
+
+	StreamingRequest* pNewRequest = createRequest(pszName, priority, pfnDecode, pfnComplete, pOwner, pUserData);
+	pNewRequest->FileData.assign(pDATA, pDATA + DATA_SIZE);
+
+	EnterCriticalSection(&m_Lock);
+	m_DecodeQueues[priority].PushBack(pNewRequest);
+	++m_PendingCount;
+	++m_Stats.RequestCount;
+	LeaveCriticalSection(&m_Lock);
+
+	ReleaseSemaphore(m_hDecodeSemaphore, 1, nullptr);
+}
+
+void AssetStreamer::CancelRequests(void* pOwner)
+{
+	if (!m_bInitialized)
+	{
+		return;
+	}
+
+	EnterCriticalSection(&m_Lock);
+
+	for (int i = 0; i < StreamingPriority_Count; ++i)
+	{
+		cancelInQueue(&m_IOQueues[i], pOwner);
+		cancelInQueue(&m_DecodeQueues[i], pOwner);
+	}
+
+	// worker finishes these. completion sees the flag.
+	for (StreamingRequest* pRequest = m_InFlightQueue.GetHead(); pRequest; pRequest = StreamingQueue::GetNext(pRequest))
+	{
+		if (pRequest->pOwner == pOwner)
+		{
+			pRequest->bCancelled = true;
+		}
+	}
+	for (StreamingRequest* pRequest = m_CompletionQueue.GetHead(); pRequest; pRequest = StreamingQueue::GetNext(pRequest))
+	{
+		if (pRequest->pOwner == pOwner)
+		{
+			pRequest->bCancelled = true;
+		}
+	}
+
+	LeaveCriticalSection(&m_Lock);
+}
+
+UINT AssetStreamer::ProcessCompletions(void* pUploadSink, const double TIME_BUDGET_MILLISECONDS)
+{
+	if (!m_bInitialized)
+	{
+		return 0;
+	}
+
+	UINT completedCount = 0;
+	LARGE_INTEGER beginTime;
+	LARGE_INTEGER curTime;
+	QueryPerformanceCounter(&beginTime);
+
+	while (true)
+	{
+		EnterCriticalSection(&m_Lock);
+		StreamingRequest* pRequest = m_CompletionQueue.PopFront();
+		LeaveCriticalSection(&m_Lock);
+
+		if (!pRequest)
+		{
+			break;
+		}
+
+		if (pRequest->bCancelled)
+		{
+			pRequest->Result = E_ABORT;
+		}
+
+		pRequest->pfnComplete(pRequest, pUploadSink);
+		QueryPerformanceCounter(&curTime);
+
+		EnterCriticalSection(&m_Lock);
+		if (pRequest->bCancelled)
+		{
+			++m_Stats.CancelledCount;
+		}
+		else if (FAILED(pRequest->Result))
+		{
+			++m_Stats.FailedCount;
+		}
+		else
+		{
+			++m_Stats.CompletedCount;
+		}
+		m_Stats.IOMilliseconds += toMilliseconds(pRequest->RequestTime, pRequest->IOEndTime);
+		m_Stats.DecodeMilliseconds += toMilliseconds(pRequest->IOEndTime, pRequest->DecodeEndTime);
+		double latency = toMilliseconds(pRequest->RequestTime, curTime);
+		if (latency > m_Stats.MaxLatencyMilliseconds)
+		{
+			m_Stats.MaxLatencyMilliseconds = latency;
+		}
+		--m_PendingCount;
+		LeaveCriticalSection(&m_Lock);
+
+		delete pRequest;
+		++completedCount;
+
+		if (toMilliseconds(beginTime, curTime) >= TIME_BUDGET_MILLISECONDS)
+		{
+			break;
+		}
+	}
+
+	if (completedCount > 0)
+	{
+		double elapsed = toMilliseconds(beginTime, curTime);
+		if (elapsed > m_Stats.MaxCompletionMilliseconds)
+		{
+			m_Stats.MaxCompletionMilliseconds = elapsed;
+		}
+	}
+
+	return completedCount;
+}
+
+void AssetStreamer::Flush(void* pUploadSink)
+{
+	if (!m_bInitialized)
+	{
+		return;
+	}
+
+	while (m_PendingCount > 0)
+	{
+		if (ProcessCompletions(pUploadSink, DBL_MAX) == 0)
+		{
+			WaitForSingleObject(m_hCompletionEvent, INFINITE);
+		}
+	}
+}
+
+void AssetStreamer::ProcessIO()
+{
+	const HANDLE phEVENTS[2] = { m_hDestroyEvent, m_hIOSemaphore };
+
+	while (true)
+	{
+		DWORD eventIndex = WaitForMultipleObjects(2, phEVENTS, FALSE, INFINITE);
+		if (eventIndex != WAIT_OBJECT_0 + 1)
+		{
+			break;
+		}
+
+		// cancelled requests leave extra semaphore count.
+		StreamingRequest* pRequest = popRequest(m_IOQueues);
+		if (!pRequest)
+		{
+			continue;
+		}
+
+		pRequest->Result = ReadWholeFile(pRequest->FileName.c_str(), pRequest->FileData);
+		QueryPerformanceCounter(&pRequest->IOEndTime);
+		pRequest->DecodeEndTime = pRequest->IOEndTime;
+
+		EnterCriticalSection(&m_Lock);
+		m_InFlightQueue.Remove(pRequest);
+		if (FAILED(pRequest->Result) || pRequest->bCancelled || !pRequest->pfnDecode)
+		{
+			pushCompletion(pRequest);
+			LeaveCriticalSection(&m_Lock);
+			continue;
+		}
+		m_DecodeQueues[pRequest->Priority].PushBack(pRequest);
+		LeaveCriticalSection(&m_Lock);
+
+		ReleaseSemaphore(m_hDecodeSemaphore, 1, nullptr);
+	}
+}
+
+void AssetStreamer::ProcessDecode()
+{
+	const HANDLE phEVENTS[2] = { m_hDestroyEvent, m_hDecodeSemaphore };
+
+	while (true)
+	{
+		DWORD eventIndex = WaitForMultipleObjects(2, phEVENTS, FALSE, INFINITE);
+		if (eventIndex != WAIT_OBJECT_0 + 1)
+		{
+			break;
+		}
+
+		StreamingRequest* pRequest = popRequest(m_DecodeQueues);
+		if (!pRequest)
+		{
+			continue;
+		}
+
+		// CancelRequests() may set flag while request is in flight.
+		EnterCriticalSection(&m_Lock);
+		bool bCancelled = pRequest->bCancelled;
+		LeaveCriticalSection(&m_Lock);
+
+		if (!bCancelled)
+		{
+			pRequest->Result = pRequest->pfnDecode(pRequest);
+		}
+		std::vector<UCHAR>().swap(pRequest->FileData);
+		QueryPerformanceCounter(&pRequest->DecodeEndTime);
+
+		EnterCriticalSection(&m_Lock);
+		m_InFlightQueue.Remove(pRequest);
+		pushCompletion(pRequest);
+		LeaveCriticalSection(&m_Lock);
+	}
+}
+
+void AssetStreamer::Cleanup()
+{
+	if (!m_bInitialized)
+	{
+		return;
+	}
+
+	SetEvent(m_hDestroyEvent);
+
+	WaitForSingleObject(m_hIOThread, INFINITE);
+	CloseHandle(m_hIOThread);
+	m_hIOThread = nullptr;
+	for (UINT i = 0; i < m_DecodeThreadCount; ++i)
+	{
+		WaitForSingleObject(m_phDecodeThreads[i], INFINITE);
+		CloseHandle(m_phDecodeThreads[i]);
+		m_phDecodeThreads[i] = nullptr;
+	}
+	m_DecodeThreadCount = 0;
+
+	// all workers are gone. abort leftovers so completion callbacks can release user data.
+	EnterCriticalSection(&m_Lock);
+	for (int i = 0; i < StreamingPriority_Count; ++i)
+	{
+		cancelInQueue(&m_IOQueues[i], nullptr);
+		cancelInQueue(&m_DecodeQueues[i], nullptr);
+	}
+	for (StreamingRequest* pRequest = m_CompletionQueue.GetHead(); pRequest; pRequest = StreamingQueue::GetNext(pRequest))
+	{
+		pRequest->bCancelled = true;
+	}
+	LeaveCriticalSection(&m_Lock);
+	ProcessCompletions(nullptr, DBL_MAX);
+	_ASSERT(m_PendingCount == 0);
+
+	CloseHandle(m_hIOSemaphore);
+	m_hIOSemaphore = nullptr;
+	CloseHandle(m_hDecodeSemaphore);
+	m_hDecodeSemaphore = nullptr;
+	CloseHandle(m_hCompletionEvent);
+	m_hCompletionEvent = nullptr;
+	CloseHandle(m_hDestroyEvent);
+	m_hDestroyEvent = nullptr;
+
+	DeleteCriticalSection(&m_Lock);
+	m_bInitialized = false;
+}
+
+StreamingRequest* AssetStreamer::createRequest(const WCHAR* pszFileName, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData)
+{
+	_ASSERT(m_bInitialized);
+	_ASSERT(pszFileName);
+	_ASSERT(pfnComplete);
+	_ASSERT(priority >= 0 && priority < StreamingPriority_Count);
+
+	StreamingRequest* pNewRequest = new StreamingRequest;
+	pNewRequest->FileName = pszFileName;
+	pNewRequest->Priority = priority;
+	pNewRequest->pfnDecode = pfnDecode;
+	pNewRequest->pfnComplete = pfnComplete;
+	pNewRequest->pOwner = pOwner;
+	pNewRequest->pUserData = pUserData;
+	pNewRequest->Result = S_OK;
+	pNewRequest->bCancelled = false;
+	pNewRequest->LinkInQueue = {};
+	QueryPerformanceCounter(&pNewRequest->RequestTime);
+	pNewRequest->IOEndTime = pNewRequest->RequestTime;
+	pNewRequest->DecodeEndTime = pNewRequest->RequestTime;
+
+	return pNewRequest;
+}
+
+StreamingRequest* AssetStreamer::popRequest(StreamingQueue* pQueues)
+{
+	StreamingRequest* pRequest = nullptr;
+
+	EnterCriticalSection(&m_Lock);
+	for (int i = 0; i < StreamingPriority_Count; ++i)
+	{
+		pRequest = pQueues[i].PopFront();
+		if (pRequest)
+		{
+			m_InFlightQueue.PushBack(pRequest);
+			break;
+		}
+	}
+	LeaveCriticalSection(&m_Lock);
+
+	return pRequest;
+}
+
+// m_Lock must be held, so request is always in some list CancelRequests() walks.
+void AssetStreamer::pushCompletion(StreamingRequest* pRequest)
+{
+	_ASSERT(pRequest);
+
+	m_CompletionQueue.PushBack(pRequest);
+	SetEvent(m_hCompletionEvent);
+}
+
+// m_Lock must be held. nullptr owner cancels all.
+void AssetStreamer::cancelInQueue(StreamingQueue* pQueue, void* pOwner)
+{
+	StreamingRequest* pRequest = pQueue->GetHead();
+	while (pRequest)
+	{
+		StreamingRequest* pNext = StreamingQueue::GetNext(pRequest);
+
+		if (!pOwner || pRequest->pOwner == pOwner)
+		{
+			pRequest->bCancelled = true;
+			std::vector<UCHAR>().swap(pRequest->FileData);
+
+			pQueue->Remove(pRequest);
+			pushCompletion(pRequest);
+		}
+
+		pRequest = pNext;
+	}
+}
+
+double AssetStreamer::toMilliseconds(const LARGE_INTEGER& BEGIN, const LARGE_INTEGER& END)
+{
+	return (double)(END.QuadPart - BEGIN.QuadPart) * 1000.0 / (double)m_QPCFrequency.QuadPart;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../Graphics/EnumType.h"
+#include "../Util/IntrusiveList.h"
+
+struct StreamingRequest;
+
+// Decode thread. pRequest->FileData holds file contents. Must not touch D3D.
+typedef HRESULT (*StreamingDecodeFunc)(StreamingRequest* pRequest);
+// Main thread. Called exactly once per request, also for failed or cancelled ones(see Result), so it owns pUserData release.
+// pUploadSink is what caller passed to ProcessCompletions(). Renderer* in app, nullptr on shutdown.
+typedef void (*StreamingCompleteFunc)(StreamingRequest* pRequest, void* pUploadSink);
+
+struct StreamingRequest
+{
+	std::wstring FileName;
+	eStreamingPriority Priority;
+	StreamingDecodeFunc pfnDecode;
+	StreamingCompleteFunc pfnComplete;
+	void* pOwner; // key for CancelRequests().
+	void* pUserData;
+
+	std::vector<UCHAR> FileData; // filled by IO thread, freed after decode.
+	HRESULT Result;
+	bool bCancelled; // under lock of AssetStreamer while request is in its lists.
+
+	// QPC counter.
+	LARGE_INTEGER RequestTime;
+	LARGE_INTEGER IOEndTime;
+	LARGE_INTEGER DecodeEndTime;
+
+	ListLink<StreamingRequest> LinkInQueue;
+};
+
+typedef IntrusiveList<StreamingRequest, &StreamingRequest::LinkInQueue> StreamingQueue;
+
+struct StreamingStats
+{
+	UINT RequestCount;
+	UINT CompletedCount;
+	UINT FailedCount;
+	UINT CancelledCount;
+
+	double IOMilliseconds; // sum of all requests.
+	double DecodeMilliseconds;
+	double MaxLatencyMilliseconds; // request -> completion on main thread.
+	double MaxCompletionMilliseconds; // longest ProcessCompletions() call. frame time spike caused by uploads.
+};
+
+static const UINT MAX_STREAMING_DECODE_THREAD_COUNT = 4;
+static const double ASSET_STREAMING_BUDGET_MILLISECONDS = 2.0; // main thread upload time per frame.
+
+// One IO thread reads files in priority order, decode threads turn file data into CPU side payload,
+// and main thread finishes requests(GPU upload) in ProcessCompletions() under time budget.
+class AssetStreamer
+{
+public:
+	AssetStreamer() = default;
+	~AssetStreamer() { Cleanup(); }
+
+	void Initialize(UINT decodeThreadCount);
+
+	// thread safe.
+	void Request(const WCHAR* pszFileName, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData);
+	// skips IO. data is copied into FileData and goes to decode threads directly. pszName is for debugging only.
+	void RequestFromMemory(const WCHAR* pszName, const UCHAR* pDATA, const UINT64 DATA_SIZE, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData);
+	void CancelRequests(void* pOwner);
+
+	// main thread. returns completed request count. at least one request is completed per call if ready.
+	UINT ProcessCompletions(void* pUploadSink, const double TIME_BUDGET_MILLISECONDS);
+	// main thread. blocks until all requests so far are completed.
+	void Flush(void* pUploadSink);
+
+	// worker thread entries.
+	void ProcessIO();
+	void ProcessDecode();
+
+	void Cleanup();
+
+	inline bool IsIdle() { return (m_PendingCount == 0); }
+	inline UINT GetPendingCount() { return (UINT)m_PendingCount; }
+	inline const StreamingStats& GetStats() { return m_Stats; }
+
+protected:
+	StreamingRequest* createRequest(const WCHAR* pszFileName, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, StreamingCompleteFunc pfnComplete, void* pOwner, void* pUserData);
+	StreamingRequest* popRequest(StreamingQueue* pQueues);
+	void pushCompletion(StreamingRequest* pRequest);
+	void cancelInQueue(StreamingQueue* pQueue, void* pOwner);
+	double toMilliseconds(const LARGE_INTEGER& BEGIN, const LARGE_INTEGER& END);
+
+private:
+	CRITICAL_SECTION m_Lock;
+	bool m_bInitialized = false;
+
+	HANDLE m_hIOThread = nullptr;
+	HANDLE m_phDecodeThreads[MAX_STREAMING_DECODE_THREAD_COUNT] = { nullptr, };
+	UINT m_DecodeThreadCount = 0;
+
+	HANDLE m_hIOSemaphore = nullptr;
+	HANDLE m_hDecodeSemaphore = nullptr;
+	HANDLE m_hCompletionEvent = nullptr;
+	HANDLE m_hDestroyEvent = nullptr;
+
+	// per priority queues.
+	StreamingQueue m_IOQueues[StreamingPriority_Count];
+	StreamingQueue m_DecodeQueues[StreamingPriority_Count];
+	StreamingQueue m_CompletionQueue;
+
+	// popped by worker, not yet in completion queue.
+	StreamingQueue m_InFlightQueue;
+
+	long volatile m_PendingCount = 0;
+	LARGE_INTEGER m_QPCFrequency = {};
+	StreamingStats m_Stats = {};
+};
@@ -0,0 +1,87 @@
+#include "../pch.h"
+#include "BindlessDescriptorPool.h"
+
+void BindlessDescriptorPool::Initialize(ID3D12Device5* pDevice, PersistentDescriptorPool* pPersistentPool, UINT descriptorCount, const D3D12_CPU_DESCRIPTOR_HANDLE NULL_SRV)
+{
+	_ASSERT(pDevice);
+	_ASSERT(pPersistentPool);
+
+	Cleanup();
+
+	HRESULT hr = S_OK;
+
+	m_pDevice = pDevice;
+	m_CBVSRVUAVDescriptorSize = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	hr = pPersistentPool->AllocDescriptorRange(&m_CPUDescriptorHandle, &m_GPUDescriptorHandle, descriptorCount);
+	BREAK_IF_FAILED(hr);
+
+	m_Registry.Initialize(descriptorCount, BINDLESS_NULL_DESCRIPTOR_INDEX + 1);
+
+	CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(m_CPUDescriptorHandle, BINDLESS_NULL_DESCRIPTOR_INDEX, m_CBVSRVUAVDescriptorSize);
+	m_pDevice->CopyDescriptorsSimple(1, dstHandle, NULL_SRV, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	++m_Stats.WriteCount;
+}
+
+UINT BindlessDescriptorPool::Register(const D3D12_CPU_DESCRIPTOR_HANDLE SRV)
+{
+	_ASSERT(m_pDevice);
+	_ASSERT(SRV.ptr != 0xffffffffffffffff);
+
+	bool bNew = false;
+	const UINT INDEX = m_Registry.Register(SRV.ptr, &bNew);
+	if (INDEX == BINDLESS_INVALID_INDEX)
+	{
+		__debugbreak();
+		return BINDLESS_NULL_DESCRIPTOR_INDEX;
+	}
+
+	if (bNew)
+	{
+		CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(m_CPUDescriptorHandle, (int)INDEX, m_CBVSRVUAVDescriptorSize);
+		m_pDevice->CopyDescriptorsSimple(1, dstHandle, SRV, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		++m_Stats.WriteCount;
+	}
+
+	return INDEX;
+}
+
+void BindlessDescriptorPool::Unregister(const D3D12_CPU_DESCRIPTOR_HANDLE SRV)
+{
+	m_Registry.Release(SRV.ptr);
+}
+
+void BindlessDescriptorPool::Refresh(const D3D12_CPU_DESCRIPTOR_HANDLE SRV)
+{
+	_ASSERT(m_pDevice);
+
+	const UINT INDEX = m_Registry.Find(SRV.ptr);
+	if (INDEX == BINDLESS_INVALID_INDEX)
+	{
+		return;
+	}
+
+	CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(m_CPUDescriptorHandle, (int)INDEX, m_CBVSRVUAVDescriptorSize);
+	m_pDevice->CopyDescriptorsSimple(1, dstHandle, SRV, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	++m_Stats.WriteCount;
+}
+
+void BindlessDescriptorPool::BeginFrame()
+{
+	m_Registry.BeginFrame();
+
+	m_Stats.LastFrameWriteCount = m_Stats.WriteCount;
+	m_Stats.WriteCount = 0;
+}
+
+void BindlessDescriptorPool::Cleanup()
+{
+	// range belongs to persistent pool.
+	m_Registry.Cleanup();
+	m_Stats = {};
+
+	m_CBVSRVUAVDescriptorSize = 0;
+	m_CPUDescriptorHandle = { 0xffffffffffffffff };
+	m_GPUDescriptorHandle = { 0xffffffffffffffff };
+	m_pDevice = nullptr;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../Shaders/BindlessShared.h"
+#include "../Util/BindlessRegistry.h"
+#include "PersistentDescriptorPool.h"
+
+static const UINT BINDLESS_NULL_DESCRIPTOR_INDEX = 0; // null texture SRV. default of every index record field.
+
+struct BindlessDescriptorStats
+{
+	UINT WriteCount; // descriptors copied into range this frame.
+	UINT LastFrameWriteCount; // frame before BeginFrame().
+};
+
+// Range of persistent pool's heap that every mesh texture and bone buffer SRV is copied into once.
+// Mesh root signatures bind whole range as unbounded arrays, draws pass slot indices as root constants.
+// Main thread.
+class BindlessDescriptorPool
+{
+public:
+	BindlessDescriptorPool() = default;
+	~BindlessDescriptorPool() { Cleanup(); }
+
+	// NULL_SRV is copied into BINDLESS_NULL_DESCRIPTOR_INDEX.
+	void Initialize(ID3D12Device5* pDevice, PersistentDescriptorPool* pPersistentPool, UINT descriptorCount, const D3D12_CPU_DESCRIPTOR_HANDLE NULL_SRV);
+
+	// slot holding copy of SRV. registering same handle again only adds reference.
+	// BINDLESS_NULL_DESCRIPTOR_INDEX when range is full.
+	UINT Register(const D3D12_CPU_DESCRIPTOR_HANDLE SRV);
+	void Unregister(const D3D12_CPU_DESCRIPTOR_HANDLE SRV);
+	// SRV was rewritten in place, e.g. by texture streaming. copies it into its slot again.
+	// GPU is idle between frames, see Renderer::present().
+	void Refresh(const D3D12_CPU_DESCRIPTOR_HANDLE SRV);
+
+	void BeginFrame();
+
+	void Cleanup();
+
+	inline D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle() { return m_GPUDescriptorHandle; }
+	inline const BindlessRegistryStats& GetRegistryStats() { return m_Registry.GetStats(); }
+	inline const BindlessDescriptorStats& GetStats() { return m_Stats; }
+
+private:
+	ID3D12Device5* m_pDevice = nullptr;
+	BindlessRegistry m_Registry;
+	UINT m_CBVSRVUAVDescriptorSize = 0;
+	D3D12_CPU_DESCRIPTOR_HANDLE m_CPUDescriptorHandle = { 0xffffffffffffffff, };
+	D3D12_GPU_DESCRIPTOR_HANDLE m_GPUDescriptorHandle = { 0xffffffffffffffff, };
+
+	BindlessDescriptorStats m_Stats = {};
+};
@@ -12,6 +12,8 @@ void CommandListPool::Initialize(ID3D12Device5* pDevice, D3D12_COMMAND_LIST_TYPE
 	m_MaxCmdListNum = maxCommandListNum;
 	m_CommandListType = type;
 	m_PoolIndex = s_Count++;
+
+	m_CmdListObjectPool.Initialize(16, m_MaxCmdListNum);
 }
 
 void CommandListPool::Close()
@@ -32,6 +34,7 @@ void CommandListPool::Close()
 	}
 
 	m_pCurCmdList->bClosed = true;
+	addStateStats(m_pCurCmdList);
 	m_pCurCmdList = nullptr;
 }
 
@@ -54,6 +57,7 @@ void CommandListPool::ClosedAndExecute(ID3D12CommandQueue* pCommandQueue)
 	}
 
 	m_pCurCmdList->bClosed = true;
+	addStateStats(m_pCurCmdList);
 
 	pCommandQueue->ExecuteCommandLists(1, (ID3D12CommandList**)&m_pCurCmdList->pCommandList);
 	m_pCurCmdList = nullptr;
@@ -64,9 +68,9 @@ void CommandListPool::Cleanup()
 	HRESULT hr = S_OK;
 
 	Reset();
-	while (m_pAvailableCmdLinkHead)
+	CommandList* pCmdList = nullptr;
+	while ((pCmdList = m_AvailableCmdLists.PopFront()) != nullptr)
 	{
-		CommandList* pCmdList = (CommandList*)m_pAvailableCmdLinkHead->pItem;
 		pCmdList->pCommandList->Release();
 		pCmdList->pCommandList = nullptr;
 
@@ -74,18 +78,13 @@ void CommandListPool::Cleanup()
 		pCmdList->pCommandAllocator = nullptr;
 		--m_TotalCmdNum;
 
-		UnLinkElemFromList(&m_pAvailableCmdLinkHead, &m_pAvailableCmdLinkTail, &pCmdList->Link);
-		--m_AvailableCmdNum;
-
-		delete pCmdList;
+		m_CmdListObjectPool.Free(pCmdList);
 	}
+	m_CmdListObjectPool.Cleanup();
 
 	m_pCurCmdList = nullptr;
-	m_pAllocatedCmdLinkHead = nullptr;
-	m_pAllocatedCmdLinkTail = nullptr;
+	m_AllocatedCmdLists.Clear();
 
-	m_AllocatedCmdNum = 0;
-	m_AvailableCmdNum = 0;
 	m_TotalCmdNum = 0;
 	m_MaxCmdListNum = 0;
 	m_pDevice = nullptr;
@@ -95,10 +94,9 @@ void CommandListPool::Reset()
 {
 	HRESULT hr = S_OK;
 
-	while (m_pAllocatedCmdLinkHead)
+	CommandList* pCmdList = nullptr;
+	while ((pCmdList = m_AllocatedCmdLists.PopFront()) != nullptr)
 	{
-		CommandList* pCmdList = (CommandList*)m_pAllocatedCmdLinkHead->pItem;
-
 		hr = pCmdList->pCommandAllocator->Reset();
 		BREAK_IF_FAILED(hr);
 
@@ -107,12 +105,10 @@ void CommandListPool::Reset()
 
 		pCmdList->bClosed = false;
 
-		UnLinkElemFromList(&m_pAllocatedCmdLinkHead, &m_pAllocatedCmdLinkTail, &pCmdList->Link);
-		--m_AllocatedCmdNum;
-
-		LinkElemIntoListFIFO(&m_pAvailableCmdLinkHead, &m_pAvailableCmdLinkTail, &pCmdList->Link);
-		++m_AvailableCmdNum;
+		m_AvailableCmdLists.PushBack(pCmdList);
 	}
+
+	m_StateStats = {};
 }
 
 ID3D12GraphicsCommandList* CommandListPool::GetCurrentCommandList()
@@ -130,6 +126,12 @@ ID3D12GraphicsCommandList* CommandListPool::GetCurrentCommandList()
 	return m_pCurCmdList->pCommandList;
 }
 
+CommandStateCache* CommandListPool::GetCurrentStateCache()
+{
+	GetCurrentCommandList();
+	return &m_pCurCmdList->StateCache;
+}
+
 bool CommandListPool::addCmdList()
 {
 	HRESULT hr = S_OK;
@@ -177,15 +179,21 @@ bool CommandListPool::addCmdList()
 		pCommandList->SetName(debugName);
 	}
 
-	pCmdList = new CommandList;
-	ZeroMemory(pCmdList, sizeof(CommandList));
-	pCmdList->Link.pItem = pCmdList;
+	pCmdList = m_CmdListObjectPool.Alloc();
+	if (!pCmdList)
+	{
+#ifdef _DEBUG
+		__debugbreak();
+#endif
+		pCommandList->Release();
+		pCommandAllocator->Release();
+		goto LB_RETURN;
+	}
 	pCmdList->pCommandList = pCommandList;
 	pCmdList->pCommandAllocator = pCommandAllocator;
 	++m_TotalCmdNum;
 
-	LinkElemIntoListFIFO(&m_pAvailableCmdLinkHead, &m_pAvailableCmdLinkTail, &pCmdList->Link);
-	++m_AvailableCmdNum;
+	m_AvailableCmdLists.PushBack(pCmdList);
 	bRet = true;
 
 LB_RETURN:
@@ -196,7 +204,7 @@ CommandList* CommandListPool::allocCmdList()
 {
 	CommandList* pCmdList = nullptr;
 
-	if (!m_pAvailableCmdLinkHead)
+	if (m_AvailableCmdLists.IsEmpty())
 	{
 		if (!addCmdList())
 		{
@@ -204,14 +212,21 @@ CommandList* CommandListPool::allocCmdList()
 		}
 	}
 
-	pCmdList = (CommandList*)m_pAvailableCmdLinkHead->pItem;
+	pCmdList = m_AvailableCmdLists.PopFront();
+	m_AllocatedCmdLists.PushBack(pCmdList);
 
-	UnLinkElemFromList(&m_pAvailableCmdLinkHead, &m_pAvailableCmdLinkTail, &pCmdList->Link);
-	--m_AvailableCmdNum;
-
-	LinkElemIntoListFIFO(&m_pAllocatedCmdLinkHead, &m_pAllocatedCmdLinkTail, &pCmdList->Link);
-	++m_AllocatedCmdNum;
+	// list is opened fresh, nothing of last recording holds.
+	pCmdList->StateCache.Reset(pCmdList->pCommandList);
 
 LB_RETURN:
 	return pCmdList;
 }
+
+void CommandListPool::addStateStats(CommandList* pCmdList)
+{
+	_ASSERT(pCmdList);
+
+	const CommandStateStats& CACHE_STATS = pCmdList->StateCache.GetStats();
+	m_StateStats.IssuedCount += CACHE_STATS.IssuedCount;
+	m_StateStats.FilteredCount += CACHE_STATS.FilteredCount;
+}
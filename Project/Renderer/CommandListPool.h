@@ -1,15 +1,20 @@
 #pragma once
 
-#include "../Util/LinkedList.h"
+#include "../Util/IntrusiveList.h"
+#include "../Util/ObjectPool.h"
+#include "CommandStateCache.h"
 
 struct CommandList
 {
 	ID3D12CommandAllocator* pCommandAllocator;
 	ID3D12GraphicsCommandList* pCommandList;
-	ListElem Link;
+	ListLink<CommandList> Link;
+	CommandStateCache StateCache; // reset when list is handed out.
 	bool bClosed;
 };
 
+typedef IntrusiveList<CommandList, &CommandList::Link> CommandListQueue;
+
 class CommandListPool
 {
 public:
@@ -26,29 +31,33 @@ public:
 	void Reset();
 
 	ID3D12GraphicsCommandList* GetCurrentCommandList();
+	// state cache of current command list. opens one as GetCurrentCommandList() does.
+	CommandStateCache* GetCurrentStateCache();
 	inline UINT GetTotalCmdListNum() const { return m_TotalCmdNum; }
-	inline UINT GetAllocatedCmdListNum() const { return m_AllocatedCmdNum; }
-	inline UINT GetAvailableCmdListNum() const { return m_AvailableCmdNum; }
+	inline UINT GetAllocatedCmdListNum() { return m_AllocatedCmdLists.GetCount(); }
+	inline UINT GetAvailableCmdListNum() { return m_AvailableCmdLists.GetCount(); }
 	inline ID3D12Device5* GetDevice() { return m_pDevice; }
+	// state caches of lists closed since Reset().
+	inline const CommandStateStats& GetStateStats() { return m_StateStats; }
 
 protected:
 	bool addCmdList();
 	CommandList* allocCmdList();
+	void addStateStats(CommandList* pCmdList);
 
 private:
 	ID3D12Device5* m_pDevice = nullptr;
 	D3D12_COMMAND_LIST_TYPE m_CommandListType = D3D12_COMMAND_LIST_TYPE_DIRECT;
-	UINT m_AllocatedCmdNum = 0;
-	UINT m_AvailableCmdNum = 0;
 	UINT m_TotalCmdNum = 0;
 	UINT m_MaxCmdListNum = 0;
 
 	CommandList* m_pCurCmdList = nullptr;
-	ListElem* m_pAllocatedCmdLinkHead = nullptr;
-	ListElem* m_pAllocatedCmdLinkTail = nullptr;
-	ListElem* m_pAvailableCmdLinkHead = nullptr;
-	ListElem* m_pAvailableCmdLinkTail = nullptr;
+	ObjectPool<CommandList> m_CmdListObjectPool;
+	CommandListQueue m_AllocatedCmdLists;
+	CommandListQueue m_AvailableCmdLists;
 
 	UINT m_PoolIndex = 0;
+
+	CommandStateStats m_StateStats = {};
 };
 
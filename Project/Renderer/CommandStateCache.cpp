@@ -0,0 +1,216 @@
+#include "../pch.h"
+#include "CommandStateCache.h"
+
+void CommandStateCache::Reset(ID3D12GraphicsCommandList* pCommandList)
+{
+	_ASSERT(pCommandList);
+
+	m_pCommandList = pCommandList;
+
+	m_DescriptorHeapCount = 0;
+	m_pRootSignature = nullptr;
+	m_pPipelineState = nullptr;
+	m_Topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_bStencilRefSet = false;
+	m_bBlendFactorSet = false;
+	m_ViewportCount = 0;
+	m_ScissorRectCount = 0;
+	clearRootArguments();
+
+	m_Stats = {};
+}
+
+void CommandStateCache::SetDescriptorHeaps(UINT heapCount, ID3D12DescriptorHeap* const* ppHeaps)
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(ppHeaps);
+	_ASSERT(heapCount > 0 && heapCount <= MAX_DESCRIPTOR_HEAP_COUNT);
+
+	if (heapCount == m_DescriptorHeapCount && memcmp(ppHeaps, m_ppDescriptorHeaps, sizeof(ID3D12DescriptorHeap*) * heapCount) == 0)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->SetDescriptorHeaps(heapCount, ppHeaps);
+	memcpy(m_ppDescriptorHeaps, ppHeaps, sizeof(ID3D12DescriptorHeap*) * heapCount);
+	m_DescriptorHeapCount = heapCount;
+	++m_Stats.IssuedCount;
+
+	// tables point into heaps set before.
+	clearRootArguments();
+}
+
+void CommandStateCache::SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature)
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(pRootSignature);
+
+	if (pRootSignature == m_pRootSignature)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->SetGraphicsRootSignature(pRootSignature);
+	m_pRootSignature = pRootSignature;
+	++m_Stats.IssuedCount;
+
+	// D3D12 drops bindings of root arguments on root signature change.
+	clearRootArguments();
+}
+
+void CommandStateCache::SetPipelineState(ID3D12PipelineState* pPipelineState)
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(pPipelineState);
+
+	if (pPipelineState == m_pPipelineState)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->SetPipelineState(pPipelineState);
+	m_pPipelineState = pPipelineState;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+	_ASSERT(m_pCommandList);
+
+	if (topology == m_Topology && topology != D3D_PRIMITIVE_TOPOLOGY_UNDEFINED)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->IASetPrimitiveTopology(topology);
+	m_Topology = topology;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::OMSetStencilRef(UINT stencilRef)
+{
+	_ASSERT(m_pCommandList);
+
+	if (m_bStencilRefSet && stencilRef == m_StencilRef)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->OMSetStencilRef(stencilRef);
+	m_StencilRef = stencilRef;
+	m_bStencilRefSet = true;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::OMSetBlendFactor(const float pBLEND_FACTOR[4])
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(pBLEND_FACTOR);
+
+	if (m_bBlendFactorSet && memcmp(pBLEND_FACTOR, m_pBlendFactor, sizeof(m_pBlendFactor)) == 0)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->OMSetBlendFactor(pBLEND_FACTOR);
+	memcpy(m_pBlendFactor, pBLEND_FACTOR, sizeof(m_pBlendFactor));
+	m_bBlendFactorSet = true;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::RSSetViewports(UINT viewportCount, const D3D12_VIEWPORT* pVIEWPORTS)
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(pVIEWPORTS);
+	_ASSERT(viewportCount > 0 && viewportCount <= MAX_VIEWPORT_COUNT);
+
+	if (viewportCount == m_ViewportCount && memcmp(pVIEWPORTS, m_pViewports, sizeof(D3D12_VIEWPORT) * viewportCount) == 0)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->RSSetViewports(viewportCount, pVIEWPORTS);
+	memcpy(m_pViewports, pVIEWPORTS, sizeof(D3D12_VIEWPORT) * viewportCount);
+	m_ViewportCount = viewportCount;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::RSSetScissorRects(UINT rectCount, const D3D12_RECT* pRECTS)
+{
+	_ASSERT(m_pCommandList);
+	_ASSERT(pRECTS);
+	_ASSERT(rectCount > 0 && rectCount <= MAX_VIEWPORT_COUNT);
+
+	if (rectCount == m_ScissorRectCount && memcmp(pRECTS, m_pScissorRects, sizeof(D3D12_RECT) * rectCount) == 0)
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->RSSetScissorRects(rectCount, pRECTS);
+	memcpy(m_pScissorRects, pRECTS, sizeof(D3D12_RECT) * rectCount);
+	m_ScissorRectCount = rectCount;
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::SetGraphicsRootDescriptorTable(UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+{
+	_ASSERT(m_pCommandList);
+
+	if (testAndSetRootArgument(rootParameterIndex, RootArgumentType_DescriptorTable, baseDescriptor.ptr))
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->SetGraphicsRootDescriptorTable(rootParameterIndex, baseDescriptor);
+	++m_Stats.IssuedCount;
+}
+
+void CommandStateCache::SetGraphicsRootConstantBufferView(UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation)
+{
+	_ASSERT(m_pCommandList);
+
+	if (testAndSetRootArgument(rootParameterIndex, RootArgumentType_ConstantBufferView, bufferLocation))
+	{
+		++m_Stats.FilteredCount;
+		return;
+	}
+
+	m_pCommandList->SetGraphicsRootConstantBufferView(rootParameterIndex, bufferLocation);
+	++m_Stats.IssuedCount;
+}
+
+bool CommandStateCache::testAndSetRootArgument(UINT rootParameterIndex, UINT type, UINT64 value)
+{
+	if (rootParameterIndex >= MAX_ROOT_ARGUMENT_COUNT)
+	{
+		return false;
+	}
+
+	RootArgument* pArgument = &m_pRootArguments[rootParameterIndex];
+	if (pArgument->Type == type && pArgument->Value == value)
+	{
+		return true;
+	}
+
+	pArgument->Type = type;
+	pArgument->Value = value;
+	return false;
+}
+
+void CommandStateCache::clearRootArguments()
+{
+	for (UINT i = 0; i < MAX_ROOT_ARGUMENT_COUNT; ++i)
+	{
+		m_pRootArguments[i].Type = RootArgumentType_None;
+		m_pRootArguments[i].Value = 0;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+struct CommandStateStats
+{
+	UINT IssuedCount; // calls passed to command list.
+	UINT FilteredCount; // calls dropped because state was already set.
+};
+
+// State last set on one command list through this cache. calls setting same state again are dropped.
+// Reset() after command list is opened, since D3D12 clears its state then. nothing is known until set once.
+// changing root signature or heaps forgets root arguments. arguments set on command list directly must use
+// other slots than ones set here under same root signature, or cached ones go stale.
+// Not thread safe. same as command list.
+class CommandStateCache
+{
+public:
+	CommandStateCache() = default;
+	~CommandStateCache() = default;
+
+	// forgets state and stats.
+	void Reset(ID3D12GraphicsCommandList* pCommandList);
+
+	void SetDescriptorHeaps(UINT heapCount, ID3D12DescriptorHeap* const* ppHeaps);
+	void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature);
+	void SetPipelineState(ID3D12PipelineState* pPipelineState);
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology);
+	void OMSetStencilRef(UINT stencilRef);
+	void OMSetBlendFactor(const float pBLEND_FACTOR[4]);
+	void RSSetViewports(UINT viewportCount, const D3D12_VIEWPORT* pVIEWPORTS);
+	void RSSetScissorRects(UINT rectCount, const D3D12_RECT* pRECTS);
+	void SetGraphicsRootDescriptorTable(UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor);
+	void SetGraphicsRootConstantBufferView(UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation);
+
+	inline ID3D12GraphicsCommandList* GetCommandList() { return m_pCommandList; }
+	inline const CommandStateStats& GetStats() { return m_Stats; }
+
+protected:
+	// true when argument is already bound. records it otherwise.
+	bool testAndSetRootArgument(UINT rootParameterIndex, UINT type, UINT64 value);
+	void clearRootArguments();
+
+private:
+	enum eRootArgumentType
+	{
+		RootArgumentType_None = 0,
+		RootArgumentType_DescriptorTable,
+		RootArgumentType_ConstantBufferView,
+	};
+	struct RootArgument
+	{
+		UINT Type;
+		UINT64 Value; // gpu handle or address.
+	};
+
+	static const UINT MAX_DESCRIPTOR_HEAP_COUNT = 2; // cbv_srv_uav, sampler.
+	static const UINT MAX_VIEWPORT_COUNT = D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+	static const UINT MAX_ROOT_ARGUMENT_COUNT = 16; // arguments above are passed through.
+
+	ID3D12GraphicsCommandList* m_pCommandList = nullptr;
+
+	ID3D12DescriptorHeap* m_ppDescriptorHeaps[MAX_DESCRIPTOR_HEAP_COUNT] = { nullptr, };
+	UINT m_DescriptorHeapCount = 0; // 0 when not known.
+	ID3D12RootSignature* m_pRootSignature = nullptr;
+	ID3D12PipelineState* m_pPipelineState = nullptr;
+	D3D12_PRIMITIVE_TOPOLOGY m_Topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	UINT m_StencilRef = 0;
+	bool m_bStencilRefSet = false;
+	float m_pBlendFactor[4] = { 0.0f, };
+	bool m_bBlendFactorSet = false;
+	D3D12_VIEWPORT m_pViewports[MAX_VIEWPORT_COUNT] = {};
+	UINT m_ViewportCount = 0; // 0 when not known.
+	D3D12_RECT m_pScissorRects[MAX_VIEWPORT_COUNT] = {};
+	UINT m_ScissorRectCount = 0; // 0 when not known.
+	RootArgument m_pRootArguments[MAX_ROOT_ARGUMENT_COUNT] = {};
+
+	CommandStateStats m_Stats = {};
+};
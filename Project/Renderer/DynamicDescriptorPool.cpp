@@ -1,61 +1,215 @@
 #include "../pch.h"
 #include "DynamicDescriptorPool.h"
 
-void DynamicDescriptorPool::Initialize(ID3D12Device5* pDevice, UINT maxDescriptorCount)
+void DynamicDescriptorPool::Initialize(ID3D12Device5* pDevice, PersistentDescriptorPool* pPagePool, UINT initialPageCount)
 {
 	_ASSERT(pDevice);
+	_ASSERT(pPagePool);
+	_ASSERT(initialPageCount > 0);
 
 	HRESULT hr = S_OK;
 
 	m_pDevice = pDevice;
-	m_MaxDescriptorCount = maxDescriptorCount;
+	m_pPagePool = pPagePool;
+	m_InitialPageCount = initialPageCount;
 	m_CBVSRVUAVDescriptorSize = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
-	D3D12_DESCRIPTOR_HEAP_DESC commonHeapDesc = {};
-	commonHeapDesc.NumDescriptors = (UINT)m_MaxDescriptorCount;
-	commonHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	commonHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	hr = m_pDevice->CreateDescriptorHeap(&commonHeapDesc, IID_PPV_ARGS(&m_pDescriptorHeap));
-	BREAK_IF_FAILED(hr);
-	m_pDescriptorHeap->SetName(L"DynamicDescriptorHeap");
-
-	m_CPUDescriptorHandle = m_pDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-	m_GPUDescriptorHandle = m_pDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+	m_Pages.reserve(m_InitialPageCount);
+	for (UINT i = 0; i < m_InitialPageCount; ++i)
+	{
+		hr = addPage();
+		BREAK_IF_FAILED(hr);
+	}
+	m_Stats.FramePageHighWater = 1;
 }
 
 HRESULT DynamicDescriptorPool::AllocDescriptorTable(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT descriptorCount)
 {
-	if (m_AllocatedDescriptorCount + (UINT64)descriptorCount > m_MaxDescriptorCount)
+	_ASSERT(m_pPagePool);
+
+	HRESULT hr = S_OK;
+
+	if (descriptorCount > DYNAMIC_DESCRIPTOR_PAGE_SIZE)
 	{
+		++m_Stats.FailCount;
 		return E_FAIL;
 	}
 
+	if (m_PageOffset + descriptorCount > DYNAMIC_DESCRIPTOR_PAGE_SIZE)
+	{
+		// rest of current page is left unused.
+		if (m_CurrentPage + 1 == (UINT)m_Pages.size())
+		{
+			hr = addPage();
+			if (FAILED(hr))
+			{
 #ifdef _DEBUG
-	char debugString[256];
-	sprintf_s(debugString, 256, "Before: %llu  DescriptorCount: %u  After: %llu\n", m_AllocatedDescriptorCount, descriptorCount, m_AllocatedDescriptorCount + descriptorCount);
-	OutputDebugStringA(debugString);
+				char debugString[256];
+				sprintf_s(debugString, 256, "DynamicDescriptorPool: out of pages. %u pages  DescriptorCount: %u\n", (UINT)m_Pages.size(), descriptorCount);
+				OutputDebugStringA(debugString);
 #endif
+				++m_Stats.FailCount;
+				return hr;
+			}
+		}
+		++m_CurrentPage;
+		m_PageOffset = 0;
+
+		if (m_CurrentPage + 1 > m_Stats.FramePageHighWater)
+		{
+			m_Stats.FramePageHighWater = m_CurrentPage + 1;
+		}
+	}
 
-	*pCPUDescriptor = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CPUDescriptorHandle, (int)m_AllocatedDescriptorCount, m_CBVSRVUAVDescriptorSize);
-	*pGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GPUDescriptorHandle, (int)m_AllocatedDescriptorCount, m_CBVSRVUAVDescriptorSize);
+	const DescriptorPage& PAGE = m_Pages[m_CurrentPage];
+	*pCPUDescriptor = CD3DX12_CPU_DESCRIPTOR_HANDLE(PAGE.CPUHandle, (int)m_PageOffset, m_CBVSRVUAVDescriptorSize);
+	*pGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(PAGE.GPUHandle, (int)m_PageOffset, m_CBVSRVUAVDescriptorSize);
+	m_PageOffset += descriptorCount;
 	m_AllocatedDescriptorCount += descriptorCount;
 
 	return S_OK;
 }
 
+void DynamicDescriptorPool::InitTableCache(UINT tableCount)
+{
+	_ASSERT(m_pPagePool);
+	_ASSERT(m_AllocatedDescriptorCount == 0);
+	_ASSERT(tableCount > 0 && tableCount * DESCRIPTOR_TABLE_CACHE_SLOT_SIZE <= DYNAMIC_DESCRIPTOR_PAGE_SIZE);
+
+	HRESULT hr = m_pPagePool->AllocDescriptorPage(&m_CachePage.CPUHandle, &m_CachePage.GPUHandle, &m_CachePage.Index);
+	BREAK_IF_FAILED(hr);
+
+	m_TableCache.Initialize(tableCount);
+	m_bUseTableCache = true;
+}
+
+HRESULT DynamicDescriptorPool::AllocCachedDescriptorTable(D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, const D3D12_CPU_DESCRIPTOR_HANDLE* pSRC_HANDLES, UINT descriptorCount)
+{
+	_ASSERT(pGPUDescriptorHandle);
+	_ASSERT(pSRC_HANDLES);
+
+	HRESULT hr = S_OK;
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
+	UINT slot = UINT_MAX;
+
+	if (m_bUseTableCache && descriptorCount <= DESCRIPTOR_TABLE_CACHE_SLOT_SIZE)
+	{
+		// D3D12_CPU_DESCRIPTOR_HANDLE is one SIZE_T.
+		const UINT64* pHANDLES = (const UINT64*)pSRC_HANDLES;
+		const bool bHIT = m_TableCache.Lookup(pHANDLES, descriptorCount, &slot);
+
+		if (slot != UINT_MAX)
+		{
+			const int OFFSET = (int)(slot * DESCRIPTOR_TABLE_CACHE_SLOT_SIZE);
+			*pGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_CachePage.GPUHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+			if (bHIT)
+			{
+				return S_OK;
+			}
+
+			cpuDescriptorTable = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CachePage.CPUHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+			m_CachedWriteCount += descriptorCount;
+		}
+	}
+
+	if (slot == UINT_MAX)
+	{
+		hr = AllocDescriptorTable(&cpuDescriptorTable, pGPUDescriptorHandle, descriptorCount);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+	}
+
+	// sources are not contiguous. one range per source, one range for destination.
+	UINT pSrcRangeSizes[DESCRIPTOR_TABLE_CACHE_SLOT_SIZE] = { 1, 1, 1, 1, 1, 1, 1, 1 };
+	if (descriptorCount <= DESCRIPTOR_TABLE_CACHE_SLOT_SIZE)
+	{
+		m_pDevice->CopyDescriptors(1, &cpuDescriptorTable, &descriptorCount, descriptorCount, pSRC_HANDLES, pSrcRangeSizes, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	}
+	else
+	{
+		CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable);
+		for (UINT i = 0; i < descriptorCount; ++i)
+		{
+			m_pDevice->CopyDescriptorsSimple(1, dstHandle, pSRC_HANDLES[i], D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
+		}
+	}
+
+	return S_OK;
+}
+
 void DynamicDescriptorPool::Reset()
 {
+	// GPU is done with every table of this pool, see Renderer::present().
+	m_Stats.LastFramePageHighWater = m_Stats.FramePageHighWater;
+	m_Stats.FramePageHighWater = 1;
+
+	// keep as many pages as last frame used, so steady frames do not touch persistent pool.
+	UINT keepCount = m_Stats.LastFramePageHighWater;
+	if (keepCount < m_InitialPageCount)
+	{
+		keepCount = m_InitialPageCount;
+	}
+	while ((UINT)m_Pages.size() > keepCount)
+	{
+		m_pPagePool->FreeDescriptorPage(m_Pages.back().Index);
+		m_Pages.pop_back();
+	}
+	m_Stats.PageCount = (UINT)m_Pages.size();
+
+	m_CurrentPage = 0;
+	m_PageOffset = 0;
 	m_AllocatedDescriptorCount = 0;
+	m_CachedWriteCount = 0;
+
+	if (m_bUseTableCache)
+	{
+		m_TableCache.BeginFrame();
+	}
 }
 
 void DynamicDescriptorPool::Cleanup()
 {
+	if (m_pPagePool)
+	{
+		for (UINT64 i = 0, size = m_Pages.size(); i < size; ++i)
+		{
+			m_pPagePool->FreeDescriptorPage(m_Pages[i].Index);
+		}
+		if (m_bUseTableCache)
+		{
+			m_pPagePool->FreeDescriptorPage(m_CachePage.Index);
+		}
+	}
+	m_Pages.clear();
+	m_CachePage = {};
+
+	m_InitialPageCount = 0;
+	m_CurrentPage = 0;
+	m_PageOffset = 0;
 	m_AllocatedDescriptorCount = 0;
-	m_MaxDescriptorCount = 0;
+	m_CachedWriteCount = 0;
+	m_bUseTableCache = false;
 	m_CBVSRVUAVDescriptorSize = 0;
-	m_CPUDescriptorHandle = { 0xffffffffffffffff };
-	m_GPUDescriptorHandle = { 0xffffffffffffffff };
-	SAFE_RELEASE(m_pDescriptorHeap);
+	m_Stats = {};
 
+	m_pPagePool = nullptr;
 	m_pDevice = nullptr;
 }
+
+HRESULT DynamicDescriptorPool::addPage()
+{
+	DescriptorPage page;
+	HRESULT hr = m_pPagePool->AllocDescriptorPage(&page.CPUHandle, &page.GPUHandle, &page.Index);
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	m_Pages.push_back(page);
+	m_Stats.PageCount = (UINT)m_Pages.size();
+
+	return S_OK;
+}
@@ -1,27 +1,75 @@
 #pragma once
 
+#include "../Util/DescriptorTableCache.h"
+#include "PersistentDescriptorPool.h"
+
+struct DynamicDescriptorPoolStats
+{
+	UINT PageCount; // pages held, used or not.
+	UINT FailCount;
+	UINT FramePageHighWater; // pages used since Reset().
+	UINT LastFramePageHighWater;
+};
+
+// Per frame tables in DYNAMIC_DESCRIPTOR_PAGE_SIZE pages of persistent pool.
+// Table never straddles pages, so GPU handle of table is page local. page is taken when current one is full,
+// pages beyond what last frame used are given back on Reset().
 class DynamicDescriptorPool
 {
 public:
 	DynamicDescriptorPool() = default;
 	~DynamicDescriptorPool() { Cleanup(); }
 
-	void Initialize(ID3D12Device5* pDevice, UINT maxDescriptorCount);
+	// initialPageCount pages are taken now and kept until Cleanup().
+	void Initialize(ID3D12Device5* pDevice, PersistentDescriptorPool* pPagePool, UINT initialPageCount);
 
+	// descriptorCount up to DYNAMIC_DESCRIPTOR_PAGE_SIZE. fails only when pages of persistent pool run out.
 	HRESULT AllocDescriptorTable(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT descriptorCount);
 
+	// takes page of its own for tableCount slots of AllocCachedDescriptorTable(). before any allocation.
+	void InitTableCache(UINT tableCount);
+	// table holding copies of pSRC_HANDLES in order. same handles give same table until evicted, so nothing is copied on hit.
+	// falls back to AllocDescriptorTable() when cache is full or disabled. sources must not be rewritten while cached.
+	HRESULT AllocCachedDescriptorTable(D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, const D3D12_CPU_DESCRIPTOR_HANDLE* pSRC_HANDLES, UINT descriptorCount);
+	// after source descriptors of cached tables are rewritten in place.
+	inline void InvalidateTableCache() { m_TableCache.Invalidate(); }
+
 	void Reset();
 
 	void Cleanup();
 
-	inline ID3D12DescriptorHeap* GetDescriptorHeap() { return m_pDescriptorHeap; }
+	inline ID3D12DescriptorHeap* GetDescriptorHeap() { return m_pPagePool->GetDescriptorHeap(); }
+	inline UINT64 GetAllocatedDescriptorCount() { return m_AllocatedDescriptorCount; }
+	// descriptors copied into cache slots since Reset().
+	inline UINT64 GetCachedWriteCount() { return m_CachedWriteCount; }
+	inline const DescriptorTableCacheStats& GetTableCacheStats() { return m_TableCache.GetStats(); }
+	inline const DynamicDescriptorPoolStats& GetStats() { return m_Stats; }
+
+protected:
+	HRESULT addPage();
 
 private:
+	struct DescriptorPage
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE CPUHandle;
+		D3D12_GPU_DESCRIPTOR_HANDLE GPUHandle;
+		UINT Index; // in persistent pool.
+	};
+
 	ID3D12Device* m_pDevice = nullptr;
-	ID3D12DescriptorHeap* m_pDescriptorHeap = nullptr;
+	PersistentDescriptorPool* m_pPagePool = nullptr;
+	std::vector<DescriptorPage> m_Pages;
+	UINT m_InitialPageCount = 0;
+	UINT m_CurrentPage = 0;
+	UINT m_PageOffset = 0; // descriptors used in current page.
 	UINT64 m_AllocatedDescriptorCount = 0;
-	UINT64 m_MaxDescriptorCount = 0;
 	UINT m_CBVSRVUAVDescriptorSize = 0;
-	D3D12_CPU_DESCRIPTOR_HANDLE m_CPUDescriptorHandle = { 0xffffffffffffffff, };
-	D3D12_GPU_DESCRIPTOR_HANDLE m_GPUDescriptorHandle = { 0xffffffffffffffff, };
+
+	// slots of one page of its own, DESCRIPTOR_TABLE_CACHE_SLOT_SIZE descriptors each.
+	DescriptorTableCache m_TableCache;
+	DescriptorPage m_CachePage = {};
+	bool m_bUseTableCache = false;
+	UINT64 m_CachedWriteCount = 0;
+
+	DynamicDescriptorPoolStats m_Stats = {};
 };
@@ -0,0 +1,101 @@
+#include "../pch.h"
+#include "FrameConstantAllocator.h"
+
+void FrameConstantAllocator::Initialize(ID3D12Device5* pDevice, const UINT FRAME_COUNT, const UINT64 SIZE_PER_FRAME)
+{
+	_ASSERT(pDevice);
+	_ASSERT(FRAME_COUNT > 0 && FRAME_COUNT <= MAX_CONSTANT_FRAME_COUNT);
+	_ASSERT(SIZE_PER_FRAME > 0 && (SIZE_PER_FRAME % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT) == 0);
+
+	Cleanup();
+
+	HRESULT hr = S_OK;
+
+	CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(SIZE_PER_FRAME * FRAME_COUNT);
+	hr = pDevice->CreateCommittedResource(&heapProps,
+										  D3D12_HEAP_FLAG_NONE,
+										  &resourceDesc,
+										  D3D12_RESOURCE_STATE_GENERIC_READ,
+										  nullptr,
+										  IID_PPV_ARGS(&m_pBuffer));
+	BREAK_IF_FAILED(hr);
+	m_pBuffer->SetName(L"FrameConstantBuffer");
+
+	// stays mapped for whole lifetime.
+	CD3DX12_RANGE readRange(0, 0);
+	hr = m_pBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pMappedPtr));
+	BREAK_IF_FAILED(hr);
+
+	m_BufferGPUAddress = m_pBuffer->GetGPUVirtualAddress();
+	m_FrameCount = FRAME_COUNT;
+	m_SizePerFrame = SIZE_PER_FRAME;
+
+	for (UINT i = 0; i < FRAME_COUNT; ++i)
+	{
+		m_pFrameAllocators[i].Initialize(SIZE_PER_FRAME);
+	}
+}
+
+void FrameConstantAllocator::BeginFrame(const UINT FRAME_INDEX)
+{
+	_ASSERT(FRAME_INDEX < m_FrameCount);
+
+	m_FrameIndex = FRAME_INDEX;
+	m_pFrameAllocators[FRAME_INDEX].Reset();
+	++m_FrameSerial;
+
+	m_Stats.AllocationCount = 0;
+	m_Stats.UsedBytes = 0;
+	m_Stats.LastFrameUploadedBytes = m_Stats.UploadedBytes;
+	m_Stats.UploadCount = 0;
+	m_Stats.SkipCount = 0;
+	m_Stats.UploadedBytes = 0;
+}
+
+HRESULT FrameConstantAllocator::Allocate(const UINT64 SIZE, D3D12_GPU_VIRTUAL_ADDRESS* pOutGPUAddress, void** ppOutMappedPtr)
+{
+	_ASSERT(m_pBuffer);
+	_ASSERT(SIZE > 0);
+	_ASSERT(pOutGPUAddress);
+	_ASSERT(ppOutMappedPtr);
+
+	LinearAllocator* pAllocator = &m_pFrameAllocators[m_FrameIndex];
+	const UINT64 OFFSET = pAllocator->Allocate(SIZE, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	if (OFFSET == UINT64_MAX)
+	{
+		// FRAME_CONSTANT_SIZE_PER_FRAME is too small for this scene.
+		__debugbreak();
+		return E_OUTOFMEMORY;
+	}
+
+	const UINT64 BUFFER_OFFSET = m_SizePerFrame * m_FrameIndex + OFFSET;
+	*pOutGPUAddress = m_BufferGPUAddress + BUFFER_OFFSET;
+	*ppOutMappedPtr = m_pMappedPtr + BUFFER_OFFSET;
+
+	m_Stats.AllocationCount = pAllocator->GetAllocationCount();
+	m_Stats.UsedBytes = pAllocator->GetUsedSize();
+	if (m_Stats.UsedBytes > m_Stats.PeakBytes)
+	{
+		m_Stats.PeakBytes = m_Stats.UsedBytes;
+	}
+
+	return S_OK;
+}
+
+void FrameConstantAllocator::Cleanup()
+{
+	if (m_pBuffer)
+	{
+		m_pBuffer->Unmap(0, nullptr);
+		m_pMappedPtr = nullptr;
+		SAFE_RELEASE(m_pBuffer);
+	}
+
+	m_BufferGPUAddress = 0;
+	m_FrameCount = 0;
+	m_FrameIndex = 0;
+	m_SizePerFrame = 0;
+	m_FrameSerial = 0;
+	m_Stats = {};
+}
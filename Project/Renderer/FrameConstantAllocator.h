@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Util/LinearAllocator.h"
+
+static const UINT64 FRAME_CONSTANT_SIZE_PER_FRAME = 256 * 1024;
+static const UINT MAX_CONSTANT_FRAME_COUNT = 3;
+
+struct FrameConstantStats
+{
+	// ring slices of current frame.
+	UINT AllocationCount;
+	UINT64 UsedBytes;
+	UINT64 PeakBytes; // largest frame so far.
+
+	// FrameConstantBuffer copies of current frame. dirty ones are copied, clean ones skipped.
+	UINT UploadCount;
+	UINT SkipCount;
+	UINT64 UploadedBytes;
+	UINT64 LastFrameUploadedBytes; // frame before BeginFrame().
+};
+
+// Per frame constant data. One persistently mapped upload buffer split into one region per in-flight frame,
+// slices are bump allocated from region of current frame and all freed at once by BeginFrame().
+// Slices are for constants rewritten every frame, caller writes them in place. Main thread.
+// slices are valid until region of same frame index begins again.
+// Also tells FrameConstantBuffer which of its per frame copies is current, and counts their uploads.
+class FrameConstantAllocator
+{
+public:
+	FrameConstantAllocator() = default;
+	~FrameConstantAllocator() { Cleanup(); }
+
+	void Initialize(ID3D12Device5* pDevice, const UINT FRAME_COUNT, const UINT64 SIZE_PER_FRAME);
+
+	// GPU must be done with frame that used FRAME_INDEX last.
+	void BeginFrame(const UINT FRAME_INDEX);
+
+	// 256 bytes aligned, so address can be bound as CBV directly. mapped memory is write combined, don't read it.
+	HRESULT Allocate(const UINT64 SIZE, D3D12_GPU_VIRTUAL_ADDRESS* pOutGPUAddress, void** ppOutMappedPtr);
+
+	void Cleanup();
+
+	inline void CountUpload(const UINT64 SIZE) { ++m_Stats.UploadCount; m_Stats.UploadedBytes += SIZE; }
+	inline void CountSkip() { ++m_Stats.SkipCount; }
+
+	// increases every BeginFrame(). tells slice or copy of older frame from current one.
+	inline UINT64 GetFrameSerial() { return m_FrameSerial; }
+	inline UINT GetFrameIndex() { return m_FrameIndex; }
+	inline UINT GetFrameCount() { return m_FrameCount; }
+	inline const FrameConstantStats& GetStats() { return m_Stats; }
+
+private:
+	ID3D12Resource* m_pBuffer = nullptr;
+	UCHAR* m_pMappedPtr = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS m_BufferGPUAddress = 0;
+
+	LinearAllocator m_pFrameAllocators[MAX_CONSTANT_FRAME_COUNT];
+	UINT m_FrameCount = 0;
+	UINT m_FrameIndex = 0;
+	UINT64 m_SizePerFrame = 0;
+	UINT64 m_FrameSerial = 0;
+
+	FrameConstantStats m_Stats = {};
+};
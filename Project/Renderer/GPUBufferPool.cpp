@@ -0,0 +1,218 @@
+#include "../pch.h"
+#include "GPUBufferPool.h"
+
+void GPUBufferPool::Initialize(ID3D12Device5* pDevice, const D3D12_HEAP_TYPE HEAP_TYPE, const UINT64 CHUNK_SIZE, const WCHAR* pszName)
+{
+	_ASSERT(pDevice);
+	_ASSERT(HEAP_TYPE == D3D12_HEAP_TYPE_DEFAULT || HEAP_TYPE == D3D12_HEAP_TYPE_UPLOAD);
+	_ASSERT(CHUNK_SIZE > 0);
+
+	Cleanup();
+
+	m_pDevice = pDevice;
+	m_HeapType = HEAP_TYPE;
+	m_ChunkSize = CHUNK_SIZE;
+	m_pszName = pszName;
+}
+
+HRESULT GPUBufferPool::Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT, GPUBufferAllocation* pOutAllocation)
+{
+	_ASSERT(m_pDevice);
+	_ASSERT(SIZE > 0);
+	_ASSERT(pOutAllocation);
+	_ASSERT(!pOutAllocation->pPool);
+
+	HRESULT hr = S_OK;
+	UINT chunkIndex = 0xffffffff;
+	TLSFAllocation block = {};
+
+	if (SIZE + ALIGNMENT > m_ChunkSize)
+	{
+		// own buffer. resource start is 64KB aligned, which covers any alignment asked here.
+		hr = createChunk(SIZE, true, &chunkIndex);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+		block.Offset = 0;
+		block.Size = SIZE;
+		block.NodeIndex = TLSF_INVALID_NODE;
+		++m_Stats.DedicatedCount;
+	}
+	else
+	{
+		for (UINT i = 0, size = (UINT)m_Chunks.size(); i < size; ++i)
+		{
+			if (m_Chunks[i].pAllocator && m_Chunks[i].pAllocator->Allocate(SIZE, ALIGNMENT, &block))
+			{
+				chunkIndex = i;
+				break;
+			}
+		}
+
+		if (chunkIndex == 0xffffffff)
+		{
+			hr = createChunk(m_ChunkSize, false, &chunkIndex);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+			if (!m_Chunks[chunkIndex].pAllocator->Allocate(SIZE, ALIGNMENT, &block))
+			{
+				__debugbreak();
+				return E_OUTOFMEMORY;
+			}
+		}
+	}
+
+	const Chunk& CHUNK = m_Chunks[chunkIndex];
+	pOutAllocation->pResource = CHUNK.pResource;
+	pOutAllocation->Offset = block.Offset;
+	pOutAllocation->Size = SIZE;
+	pOutAllocation->GPUAddress = CHUNK.pResource->GetGPUVirtualAddress() + block.Offset;
+	pOutAllocation->pMappedPtr = (CHUNK.pMappedPtr ? CHUNK.pMappedPtr + block.Offset : nullptr);
+	pOutAllocation->pPool = this;
+	pOutAllocation->ChunkIndex = chunkIndex;
+	pOutAllocation->Block = block;
+
+	++m_Stats.AllocationCount;
+	m_Stats.UsedBytes += SIZE;
+
+	return hr;
+}
+
+void GPUBufferPool::Free(GPUBufferAllocation* pAllocation)
+{
+	_ASSERT(pAllocation);
+
+	if (!pAllocation->pPool)
+	{
+		return;
+	}
+	_ASSERT(pAllocation->pPool == this);
+	_ASSERT(pAllocation->ChunkIndex < (UINT)m_Chunks.size());
+
+	Chunk* pChunk = &m_Chunks[pAllocation->ChunkIndex];
+	_ASSERT(pChunk->pResource == pAllocation->pResource);
+
+	if (pChunk->pAllocator)
+	{
+		// empty chunks are kept for next loads.
+		pChunk->pAllocator->Free(pAllocation->Block);
+	}
+	else
+	{
+		releaseChunk(pAllocation->ChunkIndex);
+		--m_Stats.DedicatedCount;
+	}
+
+	--m_Stats.AllocationCount;
+	m_Stats.UsedBytes -= pAllocation->Size;
+
+	*pAllocation = GPUBufferAllocation();
+}
+
+void GPUBufferPool::Cleanup()
+{
+#ifdef _DEBUG
+	if (m_Stats.AllocationCount > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "GPUBufferPool: %u allocations(%llu bytes) are not freed.\n", m_Stats.AllocationCount, m_Stats.UsedBytes);
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	for (UINT i = 0, size = (UINT)m_Chunks.size(); i < size; ++i)
+	{
+		releaseChunk(i);
+	}
+	m_Chunks.clear();
+
+	m_Stats = {};
+	m_pszName = nullptr;
+	m_ChunkSize = 0;
+	m_pDevice = nullptr;
+}
+
+HRESULT GPUBufferPool::createChunk(const UINT64 SIZE, bool bDedicated, UINT* pChunkIndex)
+{
+	_ASSERT(pChunkIndex);
+
+	HRESULT hr = S_OK;
+	Chunk newChunk = { nullptr, nullptr, nullptr, SIZE };
+
+	CD3DX12_HEAP_PROPERTIES heapProps(m_HeapType);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(SIZE);
+	hr = m_pDevice->CreateCommittedResource(&heapProps,
+											D3D12_HEAP_FLAG_NONE,
+											&resourceDesc,
+											(m_HeapType == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON),
+											nullptr,
+											IID_PPV_ARGS(&newChunk.pResource));
+	if (FAILED(hr))
+	{
+		__debugbreak();
+		return hr;
+	}
+	if (m_pszName)
+	{
+		newChunk.pResource->SetName(m_pszName);
+	}
+
+	if (m_HeapType == D3D12_HEAP_TYPE_UPLOAD)
+	{
+		CD3DX12_RANGE readRange(0, 0);
+		hr = newChunk.pResource->Map(0, &readRange, reinterpret_cast<void**>(&newChunk.pMappedPtr));
+		BREAK_IF_FAILED(hr);
+	}
+
+	if (!bDedicated)
+	{
+		newChunk.pAllocator = new TLSFAllocator;
+		newChunk.pAllocator->Initialize(SIZE);
+		++m_Stats.ChunkCount;
+	}
+	m_Stats.ReservedBytes += SIZE;
+
+	// reuse slot of released dedicated chunk.
+	for (UINT i = 0, size = (UINT)m_Chunks.size(); i < size; ++i)
+	{
+		if (!m_Chunks[i].pResource)
+		{
+			m_Chunks[i] = newChunk;
+			*pChunkIndex = i;
+			return hr;
+		}
+	}
+
+	*pChunkIndex = (UINT)m_Chunks.size();
+	m_Chunks.push_back(newChunk);
+
+	return hr;
+}
+
+void GPUBufferPool::releaseChunk(const UINT CHUNK_INDEX)
+{
+	Chunk* pChunk = &m_Chunks[CHUNK_INDEX];
+	if (!pChunk->pResource)
+	{
+		return;
+	}
+
+	if (pChunk->pMappedPtr)
+	{
+		pChunk->pResource->Unmap(0, nullptr);
+		pChunk->pMappedPtr = nullptr;
+	}
+	SAFE_RELEASE(pChunk->pResource);
+
+	if (pChunk->pAllocator)
+	{
+		delete pChunk->pAllocator;
+		pChunk->pAllocator = nullptr;
+		--m_Stats.ChunkCount;
+	}
+	m_Stats.ReservedBytes -= pChunk->Size;
+	pChunk->Size = 0;
+}
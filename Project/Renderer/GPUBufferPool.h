@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Util/TLSFAllocator.h"
+
+static const UINT64 DEFAULT_BUFFER_CHUNK_SIZE = 64 * 1024 * 1024;
+static const UINT64 UPLOAD_BUFFER_CHUNK_SIZE = 4 * 1024 * 1024;
+
+class GPUBufferPool;
+
+// Range of chunk buffer. views and CBVs are made from GPUAddress, not from resource start.
+struct GPUBufferAllocation
+{
+	ID3D12Resource* pResource = nullptr; // chunk buffer. not owned.
+	UINT64 Offset = 0;
+	UINT64 Size = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS GPUAddress = 0;
+	UCHAR* pMappedPtr = nullptr; // upload pool only.
+
+	GPUBufferPool* pPool = nullptr; // nullptr when not allocated.
+	UINT ChunkIndex = 0;
+	TLSFAllocation Block = {};
+};
+
+struct GPUBufferPoolStats
+{
+	UINT ChunkCount;
+	UINT DedicatedCount; // allocations larger than chunk.
+	UINT AllocationCount;
+	UINT64 ReservedBytes;
+	UINT64 UsedBytes;
+};
+
+// Sub-allocates buffers from large chunk buffers of one heap type, placement by TLSFAllocator.
+// Default heap chunks stay in COMMON state, so copies and vertex/index reads rely on implicit promotion.
+// Upload heap chunks stay mapped. Main thread. caller frees only after GPU is done with range.
+class GPUBufferPool
+{
+public:
+	GPUBufferPool() = default;
+	~GPUBufferPool() { Cleanup(); }
+
+	void Initialize(ID3D12Device5* pDevice, const D3D12_HEAP_TYPE HEAP_TYPE, const UINT64 CHUNK_SIZE, const WCHAR* pszName);
+
+	HRESULT Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT, GPUBufferAllocation* pOutAllocation);
+	// resets *pAllocation. no-op for empty allocation.
+	void Free(GPUBufferAllocation* pAllocation);
+
+	void Cleanup();
+
+	inline const GPUBufferPoolStats& GetStats() { return m_Stats; }
+
+protected:
+	HRESULT createChunk(const UINT64 SIZE, bool bDedicated, UINT* pChunkIndex);
+	void releaseChunk(const UINT CHUNK_INDEX);
+
+private:
+	struct Chunk
+	{
+		ID3D12Resource* pResource;
+		UCHAR* pMappedPtr;
+		TLSFAllocator* pAllocator; // nullptr for dedicated chunk.
+		UINT64 Size;
+	};
+
+	ID3D12Device5* m_pDevice = nullptr;
+	D3D12_HEAP_TYPE m_HeapType = D3D12_HEAP_TYPE_DEFAULT;
+	UINT64 m_ChunkSize = 0;
+	const WCHAR* m_pszName = nullptr;
+
+	std::vector<Chunk> m_Chunks; // released slots have nullptr resource.
+	GPUBufferPoolStats m_Stats = {};
+};
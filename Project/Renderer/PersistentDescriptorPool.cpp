@@ -0,0 +1,166 @@
+#include "../pch.h"
+#include "PersistentDescriptorPool.h"
+
+void PersistentDescriptorPool::Initialize(ID3D12Device5* pDevice, UINT tableDescriptorCount, UINT dynamicPageCount, UINT rangeDescriptorCount)
+{
+	_ASSERT(pDevice);
+	// IndexCreator tells failure by 0xffff.
+	_ASSERT(dynamicPageCount > 0 && dynamicPageCount < 0xffff);
+
+	Cleanup();
+
+	HRESULT hr = S_OK;
+
+	m_pDevice = pDevice;
+	m_TableDescriptorCount = tableDescriptorCount - tableDescriptorCount % PERSISTENT_DESCRIPTOR_PAGE_SIZE;
+	m_DynamicPageCount = dynamicPageCount;
+	m_MaxRangeDescriptorCount = rangeDescriptorCount;
+	m_CBVSRVUAVDescriptorSize = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	D3D12_DESCRIPTOR_HEAP_DESC commonHeapDesc = {};
+	commonHeapDesc.NumDescriptors = m_TableDescriptorCount + m_DynamicPageCount * DYNAMIC_DESCRIPTOR_PAGE_SIZE + m_MaxRangeDescriptorCount;
+	commonHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	commonHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	hr = m_pDevice->CreateDescriptorHeap(&commonHeapDesc, IID_PPV_ARGS(&m_pDescriptorHeap));
+	BREAK_IF_FAILED(hr);
+	m_pDescriptorHeap->SetName(L"PersistentDescriptorHeap");
+
+	m_CPUDescriptorHandle = m_pDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+	m_GPUDescriptorHandle = m_pDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+
+	m_TableAllocator.Initialize(m_TableDescriptorCount, PERSISTENT_DESCRIPTOR_PAGE_SIZE);
+	m_PageIndexCreator.Initialize(m_DynamicPageCount);
+}
+
+HRESULT PersistentDescriptorPool::AllocDescriptorTable(PersistentDescriptorTable* pOutTable, UINT descriptorCount)
+{
+	_ASSERT(m_pDescriptorHeap);
+	_ASSERT(pOutTable);
+	_ASSERT(!pOutTable->pPool);
+
+	const UINT OFFSET = m_TableAllocator.Alloc(descriptorCount);
+	if (OFFSET == DESCRIPTOR_ALLOCATOR_INVALID_OFFSET)
+	{
+		__debugbreak();
+		return E_OUTOFMEMORY;
+	}
+
+	pOutTable->CPUHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CPUDescriptorHandle, (int)OFFSET, m_CBVSRVUAVDescriptorSize);
+	pOutTable->GPUHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GPUDescriptorHandle, (int)OFFSET, m_CBVSRVUAVDescriptorSize);
+	pOutTable->pPool = this;
+	pOutTable->Offset = OFFSET;
+	pOutTable->Count = descriptorCount;
+
+	++m_Stats.TableCount;
+
+	return S_OK;
+}
+
+void PersistentDescriptorPool::FreeDescriptorTable(PersistentDescriptorTable* pTable)
+{
+	_ASSERT(pTable);
+
+	if (!pTable->pPool)
+	{
+		return;
+	}
+	_ASSERT(pTable->pPool == this);
+	_ASSERT(pTable->Offset < m_TableDescriptorCount);
+
+	m_TableAllocator.Free(pTable->Offset);
+	--m_Stats.TableCount;
+
+	*pTable = PersistentDescriptorTable();
+}
+
+HRESULT PersistentDescriptorPool::AllocDescriptorPage(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT* pOutPageIndex)
+{
+	_ASSERT(m_pDescriptorHeap);
+	_ASSERT(pCPUDescriptor);
+	_ASSERT(pGPUDescriptorHandle);
+	_ASSERT(pOutPageIndex);
+
+	const ULONG PAGE_INDEX = m_PageIndexCreator.Alloc();
+	if (PAGE_INDEX == 0xffff)
+	{
+		return E_OUTOFMEMORY;
+	}
+
+	// pages follow table region.
+	const int OFFSET = (int)(m_TableDescriptorCount + PAGE_INDEX * DYNAMIC_DESCRIPTOR_PAGE_SIZE);
+	*pCPUDescriptor = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CPUDescriptorHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+	*pGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GPUDescriptorHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+	*pOutPageIndex = (UINT)PAGE_INDEX;
+
+	return S_OK;
+}
+
+void PersistentDescriptorPool::FreeDescriptorPage(UINT pageIndex)
+{
+	_ASSERT(pageIndex < m_DynamicPageCount);
+
+	m_PageIndexCreator.Free(pageIndex);
+}
+
+HRESULT PersistentDescriptorPool::AllocDescriptorRange(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT descriptorCount)
+{
+	_ASSERT(m_pDescriptorHeap);
+
+	if (m_Stats.RangeDescriptorCount + descriptorCount > m_MaxRangeDescriptorCount)
+	{
+		__debugbreak();
+		return E_OUTOFMEMORY;
+	}
+
+	// ranges follow dynamic pages.
+	const int OFFSET = (int)(m_TableDescriptorCount + m_DynamicPageCount * DYNAMIC_DESCRIPTOR_PAGE_SIZE + m_Stats.RangeDescriptorCount);
+	*pCPUDescriptor = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CPUDescriptorHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+	*pGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GPUDescriptorHandle, OFFSET, m_CBVSRVUAVDescriptorSize);
+	m_Stats.RangeDescriptorCount += descriptorCount;
+
+	return S_OK;
+}
+
+void PersistentDescriptorPool::BeginFrame()
+{
+	m_TableAllocator.BeginFrame();
+
+	m_Stats.LastFrameWriteCount = m_Stats.WriteCount;
+	m_Stats.WriteCount = 0;
+
+	// render threads are idle here.
+	m_Stats.PageCount = m_PageIndexCreator.GetAllocatedCount();
+	m_Stats.PageFailCount = m_PageIndexCreator.GetFailCount();
+	m_Stats.LastFramePageHighWater = m_PageIndexCreator.GetHighWater();
+	if (m_Stats.LastFramePageHighWater > m_Stats.PeakPageCount)
+	{
+		m_Stats.PeakPageCount = m_Stats.LastFramePageHighWater;
+	}
+	m_PageIndexCreator.ResetHighWater();
+}
+
+void PersistentDescriptorPool::Cleanup()
+{
+#ifdef _DEBUG
+	if (m_Stats.TableCount > 0 || m_PageIndexCreator.GetAllocatedCount() > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "PersistentDescriptorPool: %u tables, %u pages are not freed.\n", m_Stats.TableCount, (UINT)m_PageIndexCreator.GetAllocatedCount());
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	m_TableAllocator.Cleanup();
+	m_PageIndexCreator.Clear();
+	m_Stats = {};
+
+	m_TableDescriptorCount = 0;
+	m_DynamicPageCount = 0;
+	m_MaxRangeDescriptorCount = 0;
+	m_CBVSRVUAVDescriptorSize = 0;
+	m_CPUDescriptorHandle = { 0xffffffffffffffff };
+	m_GPUDescriptorHandle = { 0xffffffffffffffff };
+	SAFE_RELEASE(m_pDescriptorHeap);
+
+	m_pDevice = nullptr;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Util/LockFreeIndexCreator.h"
+#include "../Util/DescriptorAllocator.h"
+
+static const UINT PERSISTENT_DESCRIPTOR_PAGE_SIZE = 64; // size class pages of table region. largest table.
+static const UINT PERSISTENT_TABLE_DESCRIPTOR_COUNT = 2048; // mesh textures live in bindless range, see BindlessDescriptorPool.h
+static const UINT DYNAMIC_DESCRIPTOR_PAGE_SIZE = 1024; // pages of dynamic pools. largest dynamic table.
+
+class PersistentDescriptorPool;
+
+// Block of table region. holds descriptor count rounded up to power of 2.
+struct PersistentDescriptorTable
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE CPUHandle = { 0xffffffffffffffff, };
+	D3D12_GPU_DESCRIPTOR_HANDLE GPUHandle = { 0xffffffffffffffff, };
+
+	PersistentDescriptorPool* pPool = nullptr; // nullptr when not allocated.
+	UINT Offset = 0; // from heap start.
+	UINT Count = 0;
+};
+
+struct PersistentDescriptorStats
+{
+	UINT TableCount;
+	UINT RangeDescriptorCount; // descriptors handed out by AllocDescriptorRange().
+	UINT WriteCount; // descriptors written into tables this frame.
+	UINT LastFrameWriteCount; // frame before BeginFrame().
+
+	// taken at BeginFrame(), page allocation keeps its own counters.
+	UINT PageCount; // dynamic pages taken.
+	UINT PeakPageCount;
+	UINT PageFailCount;
+	UINT LastFramePageHighWater; // most dynamic pages taken at once in frame before BeginFrame().
+};
+
+// Owns the one shader visible CBV/SRV/UAV heap, so tables written once stay valid across frames.
+// Heap is laid out as [tables][dynamic pages][ranges].
+// tables come from size class free lists of DescriptorAllocator. dynamic pages of DYNAMIC_DESCRIPTOR_PAGE_SIZE
+// are taken by dynamic pools on demand and given back when they shrink. ranges live until Cleanup(),
+// for global tables and bindless range.
+// Main thread, except AllocDescriptorPage() / FreeDescriptorPage() which render threads may call without lock.
+// caller frees table or page only after GPU is done with it.
+class PersistentDescriptorPool
+{
+public:
+	PersistentDescriptorPool() = default;
+	~PersistentDescriptorPool() { Cleanup(); }
+
+	void Initialize(ID3D12Device5* pDevice, UINT tableDescriptorCount, UINT dynamicPageCount, UINT rangeDescriptorCount);
+
+	// descriptorCount up to PERSISTENT_DESCRIPTOR_PAGE_SIZE.
+	HRESULT AllocDescriptorTable(PersistentDescriptorTable* pOutTable, UINT descriptorCount);
+	// resets *pTable. no-op for empty table.
+	void FreeDescriptorTable(PersistentDescriptorTable* pTable);
+
+	HRESULT AllocDescriptorPage(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT* pOutPageIndex);
+	void FreeDescriptorPage(UINT pageIndex);
+
+	HRESULT AllocDescriptorRange(D3D12_CPU_DESCRIPTOR_HANDLE* pCPUDescriptor, D3D12_GPU_DESCRIPTOR_HANDLE* pGPUDescriptorHandle, UINT descriptorCount);
+
+	void BeginFrame();
+
+	void Cleanup();
+
+	inline void CountWrite(UINT descriptorCount) { m_Stats.WriteCount += descriptorCount; }
+
+	inline ID3D12DescriptorHeap* GetDescriptorHeap() { return m_pDescriptorHeap; }
+	inline const PersistentDescriptorStats& GetStats() { return m_Stats; }
+	inline const DescriptorAllocatorStats& GetTableAllocatorStats() { return m_TableAllocator.GetStats(); }
+
+private:
+	ID3D12Device5* m_pDevice = nullptr;
+	ID3D12DescriptorHeap* m_pDescriptorHeap = nullptr;
+	DescriptorAllocator m_TableAllocator;
+	LockFreeIndexCreator m_PageIndexCreator;
+
+	UINT m_TableDescriptorCount = 0;
+	UINT m_DynamicPageCount = 0;
+	UINT m_MaxRangeDescriptorCount = 0;
+	UINT m_CBVSRVUAVDescriptorSize = 0;
+	D3D12_CPU_DESCRIPTOR_HANDLE m_CPUDescriptorHandle = { 0xffffffffffffffff, };
+	D3D12_GPU_DESCRIPTOR_HANDLE m_GPUDescriptorHandle = { 0xffffffffffffffff, };
+
+	PersistentDescriptorStats m_Stats = {};
+};
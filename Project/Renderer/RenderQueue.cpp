@@ -17,6 +17,15 @@ void RenderQueue::Initialize(UINT maxItemCount)
 	}
 #endif
 	ZeroMemory(m_pBuffer, m_MaxBufferSize);
+
+	m_pSortEntries = (RadixSortEntry*)malloc(sizeof(RadixSortEntry) * maxItemCount);
+	m_pSortTemp = (RadixSortEntry*)malloc(sizeof(RadixSortEntry) * maxItemCount);
+#ifdef _DEBUG
+	if (!m_pSortEntries || !m_pSortTemp)
+	{
+		__debugbreak();
+	}
+#endif
 }
 
 bool RenderQueue::Add(const RenderItem* pItem)
@@ -42,6 +51,34 @@ LB_RETURN:
 	return bRet;
 }
 
+void RenderQueue::Sort()
+{
+	_ASSERT(!m_bSorted);
+
+	const UINT FIRST_INDEX = m_ReadBufferPos / sizeof(RenderItem);
+	const UINT COUNT = m_AllocatedSize / sizeof(RenderItem) - FIRST_INDEX;
+	const RenderItem* pITEMS = (const RenderItem*)m_pBuffer;
+
+	// entries are 16 bytes, so passes move keys instead of whole items.
+	bool bInOrder = true;
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		m_pSortEntries[i].Key = pITEMS[FIRST_INDEX + i].SortKey;
+		m_pSortEntries[i].Index = FIRST_INDEX + i;
+		bInOrder = bInOrder && (i == 0 || m_pSortEntries[i - 1].Key <= m_pSortEntries[i].Key);
+	}
+	// renderer adds chunks of one sorted list.
+	if (!bInOrder)
+	{
+		RadixSort64(m_pSortEntries, m_pSortTemp, COUNT);
+	}
+
+	m_SortedCount = COUNT;
+	m_SortReadPos = 0;
+	m_ReadBufferPos = m_AllocatedSize;
+	m_bSorted = true;
+}
+
 UINT RenderQueue::Process(UINT threadIndex, ID3D12CommandQueue* pCommandQueue, CommandListPool* pCommandListPool, ResourceManager* pManager, DynamicDescriptorPool* pDescriptorPool, int processCountPerCommandList)
 {
 	_ASSERT(threadIndex >= 0 && threadIndex < MAX_RENDER_THREAD_COUNT);
@@ -57,19 +94,29 @@ UINT RenderQueue::Process(UINT threadIndex, ID3D12CommandQueue* pCommandQueue, C
 	int processedCount = 0;
 	int processedPerCommandList = 0;
 	const RenderItem* pRenderItem = nullptr;
+	int curPSOType = -1; // state of current command list. -1 when nothing is set.
 
+	Sort();
 	while (pRenderItem = dispatch())
 	{
 		pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 
-		ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
+		if (pRenderItem->PSOType != curPSOType)
 		{
-			pDescriptorPool->GetDescriptorHeap(),
-			pManager->m_pSamplerHeap,
-		};
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
+			ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
+			{
+				pDescriptorPool->GetDescriptorHeap(),
+				pManager->m_pSamplerHeap,
+			};
+			pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
+
+			pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, pRenderItem->PSOType);
+			curPSOType = pRenderItem->PSOType;
+			++m_Stats.StateChangeCount;
+		}
+		++m_Stats.ItemCount;
 
-		pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, pRenderItem->PSOType);
 		switch (pRenderItem->ModelType)
 		{
 			case RenderObjectType_DefaultType:
@@ -103,6 +150,9 @@ UINT RenderQueue::Process(UINT threadIndex, ID3D12CommandQueue* pCommandQueue, C
 			++commandListCount;
 			pCommandList = nullptr;
 			processedPerCommandList = 0;
+
+			// next command list starts with no state.
+			curPSOType = -1;
 		}
 	}
 
@@ -138,50 +188,70 @@ UINT RenderQueue::ProcessLight(UINT threadIndex, ID3D12CommandQueue* pCommandQue
 	int processedCount = 0;
 	int processedPerCommandList = 0;
 	const RenderItem* pRenderItem = nullptr;
+	int curPSOType = -1; // state of current command list. -1 when nothing is set.
+	Light* pBoundLight = nullptr;
 
+	Sort();
 	while (pRenderItem = dispatch())
 	{
 		pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 
 		Light* pCurLight = (Light*)pRenderItem->pLight;
 		Texture* pShadowBuffer = nullptr;
 		CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle;
 		ID3D12Resource* pDepthStencilResource = nullptr;
 
-		ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
+		if (pRenderItem->PSOType != curPSOType)
 		{
-			pDescriptorPool->GetDescriptorHeap(),
-			pManager->m_pSamplerHeap,
-		};
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
+			ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
+			{
+				pDescriptorPool->GetDescriptorHeap(),
+				pManager->m_pSamplerHeap,
+			};
+			pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
 
-		pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, pRenderItem->PSOType);
-		switch (pCurLight->Property.LightType & (LIGHT_DIRECTIONAL | LIGHT_POINT | LIGHT_SPOT))
-		{
-			case LIGHT_DIRECTIONAL:
-				pShadowBuffer = pCurLight->LightShadowMap.GetDirectionalLightShadowBufferPtr();
-				pCommandList->SetGraphicsRootConstantBufferView(1, pCurLight->LightShadowMap.GetShadowConstantBufferForGSPtr()->GetGPUMemAddr());
-				break;
+			pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, pRenderItem->PSOType);
+			curPSOType = pRenderItem->PSOType;
+			++m_Stats.StateChangeCount;
 
-			case LIGHT_POINT:
-				pShadowBuffer = pCurLight->LightShadowMap.GetPointLightShadowBufferPtr();
-				pCommandList->SetGraphicsRootConstantBufferView(1, pCurLight->LightShadowMap.GetShadowConstantBufferForGSPtr()->GetGPUMemAddr());
-				break;
+			// root signature change drops root CBV of light.
+			pBoundLight = nullptr;
+		}
+		++m_Stats.ItemCount;
 
-			case LIGHT_SPOT:
-				pShadowBuffer = pCurLight->LightShadowMap.GetSpotLightShadowBufferPtr();
-				pCommandList->SetGraphicsRootConstantBufferView(1, pCurLight->LightShadowMap.GetShadowConstantBufferForGSPtr()->GetGPUMemAddr());
-				break;
+		// light state is set once per run of same light.
+		if (pCurLight != pBoundLight)
+		{
+			pBoundLight = pCurLight;
 
-			default:
-				__debugbreak();
-				break;
-		}
-		dsvHandle = pShadowBuffer->GetDSVHandle();
-		pDepthStencilResource = pShadowBuffer->GetResource();
+			switch (pCurLight->Property.LightType & (LIGHT_DIRECTIONAL | LIGHT_POINT | LIGHT_SPOT))
+			{
+				case LIGHT_DIRECTIONAL:
+					pShadowBuffer = pCurLight->LightShadowMap.GetDirectionalLightShadowBufferPtr();
+					pStateCache->SetGraphicsRootConstantBufferView(5, pCurLight->LightShadowMap.GetShadowConstantsForGSAddress());
+					break;
+
+				case LIGHT_POINT:
+					pShadowBuffer = pCurLight->LightShadowMap.GetPointLightShadowBufferPtr();
+					pStateCache->SetGraphicsRootConstantBufferView(5, pCurLight->LightShadowMap.GetShadowConstantsForGSAddress());
+					break;
+
+				case LIGHT_SPOT:
+					pShadowBuffer = pCurLight->LightShadowMap.GetSpotLightShadowBufferPtr();
+					pStateCache->SetGraphicsRootConstantBufferView(5, pCurLight->LightShadowMap.GetShadowConstantsForGSAddress());
+					break;
+
+				default:
+					__debugbreak();
+					break;
+			}
+			dsvHandle = pShadowBuffer->GetDSVHandle();
+			pDepthStencilResource = pShadowBuffer->GetResource();
 
-		pCurLight->LightShadowMap.SetViewportsAndScissorRect(pCommandList);
-		pCommandList->OMSetRenderTargets(0, nullptr, FALSE, &dsvHandle);
+			pCurLight->LightShadowMap.SetViewportsAndScissorRect(pStateCache);
+			pCommandList->OMSetRenderTargets(0, nullptr, FALSE, &dsvHandle);
+		}
 
 		switch (pRenderItem->ModelType)
 		{
@@ -216,6 +286,9 @@ UINT RenderQueue::ProcessLight(UINT threadIndex, ID3D12CommandQueue* pCommandQue
 			++commandListCount;
 			pCommandList = nullptr;
 			processedPerCommandList = 0;
+
+			// next command list starts with no state.
+			curPSOType = -1;
 		}
 	}
 
@@ -255,6 +328,7 @@ UINT RenderQueue::ProcessPostProcessing(UINT threadIndex, ID3D12CommandQueue* pC
 	while (pRenderItem = dispatch())
 	{
 		pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 
 		ImageFilter* pImageFilter = (ImageFilter*)pRenderItem->pFilter;
 		Mesh* pScreenMesh = (Mesh*)pRenderItem->pObjectHandle;
@@ -264,9 +338,10 @@ UINT RenderQueue::ProcessPostProcessing(UINT threadIndex, ID3D12CommandQueue* pC
 			pDescriptorPool->GetDescriptorHeap(),
 			pManager->m_pSamplerHeap,
 		};
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
+		pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
 
-		pManager->SetCommonState(threadIndex, pCommandList, pDescriptorPool, pRenderItem->PSOType);
+		// filters of same PSO in a row share their state.
+		pManager->SetCommonState(threadIndex, pStateCache, pDescriptorPool, pRenderItem->PSOType);
 		
 		pImageFilter->BeforeRender(threadIndex, pCommandList, pDescriptorPool, pManager, pRenderItem->PSOType);
 		pCommandList->IASetVertexBuffers(0, 1, &pScreenMesh->Vertex.VertexBufferView);
@@ -308,6 +383,10 @@ void RenderQueue::Reset()
 {
 	m_AllocatedSize = 0;
 	m_ReadBufferPos = 0;
+	m_SortedCount = 0;
+	m_SortReadPos = 0;
+	m_bSorted = false;
+	m_Stats = {};
 }
 
 void RenderQueue::Cleanup()
@@ -317,6 +396,20 @@ void RenderQueue::Cleanup()
 		free(m_pBuffer);
 		m_pBuffer = nullptr;
 	}
+	if (m_pSortEntries)
+	{
+		free(m_pSortEntries);
+		m_pSortEntries = nullptr;
+	}
+	if (m_pSortTemp)
+	{
+		free(m_pSortTemp);
+		m_pSortTemp = nullptr;
+	}
+	m_SortedCount = 0;
+	m_SortReadPos = 0;
+	m_bSorted = false;
+	m_Stats = {};
 	m_MaxBufferSize = 0;
 	m_AllocatedSize = 0;
 	m_ReadBufferPos = 0;
@@ -326,6 +419,19 @@ void RenderQueue::Cleanup()
 const RenderItem* RenderQueue::dispatch()
 {
 	const RenderItem* pItem = nullptr;
+
+	if (m_bSorted)
+	{
+		if (m_SortReadPos < m_SortedCount)
+		{
+			pItem = (const RenderItem*)m_pBuffer + m_pSortEntries[m_SortReadPos].Index;
+			++m_SortReadPos;
+			goto LB_RETURN;
+		}
+		// items added after Sort() follow in order.
+		m_bSorted = false;
+	}
+
 	if (m_ReadBufferPos + sizeof(RenderItem) > m_AllocatedSize)
 	{
 		goto LB_RETURN;
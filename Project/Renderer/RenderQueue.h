@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ResourceManager.h"
+#include "../Util/RadixSort.h"
+#include "../Util/RenderSortKey.h"
 
 class ResourceManager;
 
@@ -11,6 +13,13 @@ struct RenderItem
 	void* pObjectHandle;
 	void* pLight; // for shadow pass.
 	void* pFilter;
+	UINT64 SortKey; // see MakeRenderSortKey().
+};
+
+struct RenderQueueStats
+{
+	UINT ItemCount; // processed since Reset().
+	UINT StateChangeCount; // SetCommonState() calls since Reset(). one per item before sorting.
 };
 
 class RenderQueue
@@ -22,6 +31,8 @@ public:
 	void Initialize(UINT maxItemCount);
 
 	bool Add(const RenderItem* pItem);
+	// orders items not dispatched yet by SortKey. Process() and ProcessLight() call it, post processing keeps order.
+	void Sort();
 
 	UINT Process(UINT threadIndex, ID3D12CommandQueue* pCommandQueue, CommandListPool* pCommandListPool, ResourceManager* pManager, DynamicDescriptorPool* pDescriptorPool, int processCountPerCommandList);
 	UINT ProcessLight(UINT threadIndex, ID3D12CommandQueue* pCommandQueue, CommandListPool* pCommandListPool, ResourceManager* pManager, DynamicDescriptorPool* pDescriptorPool, int processCountPerCommandList);
@@ -31,6 +42,8 @@ public:
 
 	void Cleanup();
 
+	inline const RenderQueueStats& GetStats() { return m_Stats; }
+
 protected:
 	const RenderItem* dispatch();
 	
@@ -40,4 +53,13 @@ private:
 	UINT m_AllocatedSize = 0;
 	UINT m_ReadBufferPos = 0;
 	UINT m_RenderObjectCount = 0;
+
+	// item indices in key order, valid while m_bSorted.
+	RadixSortEntry* m_pSortEntries = nullptr;
+	RadixSortEntry* m_pSortTemp = nullptr;
+	UINT m_SortedCount = 0;
+	UINT m_SortReadPos = 0;
+	bool m_bSorted = false;
+
+	RenderQueueStats m_Stats = {};
 };
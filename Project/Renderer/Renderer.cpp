@@ -46,8 +46,6 @@ void Renderer::Initizlie(InitialData* pIntialData)
 	m_PostProcessor.Initizlie(pRenderer, config, m_ScreenWidth, m_ScreenHeight, 2);
 	m_PostProcessor.SetDescriptorHeap(pRenderer);
 
-	m_DynamicDescriptorPool.Initialize(m_pDevice, 1024);
-
 	m_ScreenViewport.TopLeftX = 0;
 	m_ScreenViewport.TopLeftY = 0;
 	m_ScreenViewport.Width = (float)m_ScreenWidth;
@@ -63,6 +61,11 @@ void Renderer::Initizlie(InitialData* pIntialData)
 
 void Renderer::Update(const float DELTA_TIME)
 {
+	// finish streamed assets first, so this frame already uses them. their uploads go in one submission.
+	m_pResourceManager->BeginUpload();
+	m_AssetStreamer.ProcessCompletions(this, ASSET_STREAMING_BUDGET_MILLISECONDS);
+	m_pResourceManager->EndUpload();
+
 	m_PhysicsManager.Update(DELTA_TIME);
 
 	m_Camera.UpdateKeyboard(DELTA_TIME, &m_Keyboard);
@@ -70,6 +73,32 @@ void Renderer::Update(const float DELTA_TIME)
 
 	updateGlobalConstants(DELTA_TIME);
 	updateLightConstants(DELTA_TIME);
+
+	// select mesh LOD by projected error, then cull clusters of LOD 0 meshes.
+	const Vector3 EYE_POS = m_Camera.GetEyePos();
+	const float FOV_Y = DirectX::XMConvertToRadians(m_Camera.GetProjectionFovAngleY());
+	DirectX::BoundingFrustum viewFrustum;
+	DirectX::BoundingFrustum::CreateFromMatrix(viewFrustum, m_Camera.GetProjection());
+	viewFrustum.Transform(viewFrustum, m_Camera.GetView().Invert());
+
+	UINT clusterTriangleCount = 0;
+	UINT culledClusterTriangleCount = 0;
+	for (UINT64 i = 0, size = m_pRenderObjects->size(); i < size; ++i)
+	{
+		Model* pModel = (*m_pRenderObjects)[i];
+		if (!pModel->bIsVisible)
+		{
+			continue;
+		}
+
+		pModel->UpdateLOD(EYE_POS, FOV_Y, (float)m_ScreenHeight);
+		pModel->UpdateClusterCulling(viewFrustum, EYE_POS);
+
+		clusterTriangleCount += pModel->ClusterTriangleCount;
+		culledClusterTriangleCount += pModel->CulledClusterTriangleCount;
+	}
+	m_ClusterTriangleCount = clusterTriangleCount;
+	m_CulledClusterTriangleCount = culledClusterTriangleCount;
 }
 
 void Renderer::Render()
@@ -79,7 +108,10 @@ void Renderer::Render()
 	renderShadowmap();
 	renderObject();
 	renderMirror();
+#ifndef USE_MULTI_THREAD
+	// single command list is open in single thread build only.
 	renderObjectBoundingModel();
+#endif
 	postProcess();
 
 	endRender();
@@ -108,12 +140,13 @@ void Renderer::ProcessByThread(UINT threadIndex, ResourceManager* pManager, int
 		case RenderPass_Collider:
 		{
 			ID3D12GraphicsCommandList* pCommandList = pCommandListPool->GetCurrentCommandList();
+			CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 			CD3DX12_CPU_DESCRIPTOR_HANDLE floatBufferRtvHandle(pManager->m_pRTVHeap->GetCPUDescriptorHandleForHeapStart(), m_FloatBufferRTVOffset, m_pResourceManager->m_RTVDescriptorSize);
 			CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(pManager->m_pDSVHeap->GetCPUDescriptorHandleForHeapStart());
 			// pCommandQueue = m_ppCommandQueue[RenderPass_MainRender];
 
-			pCommandList->RSSetViewports(1, &m_ScreenViewport);
-			pCommandList->RSSetScissorRects(1, &m_ScissorRect);
+			pStateCache->RSSetViewports(1, &m_ScreenViewport);
+			pStateCache->RSSetScissorRects(1, &m_ScissorRect);
 			pCommandList->OMSetRenderTargets(1, &floatBufferRtvHandle, FALSE, &dsvHandle);
 			m_pppRenderQueue[renderPass][threadIndex]->Process(threadIndex, pCommandQueue, pCommandListPool, pManager, pDescriptorPool, 100);
 		}
@@ -163,12 +196,22 @@ void Renderer::Cleanup()
 
 #endif
 
+	// joins loader threads. uploads of leftover requests are dropped.
+	m_AssetStreamer.Cleanup();
+	m_TextureCache.Cleanup();
+
 	fence();
 	for (UINT i = 0; i < SWAP_CHAIN_FRAME_COUNT; ++i)
 	{
 		waitForFenceValue(m_LastFenceValues[i]);
 	}
 
+	// pooled buffers go back to resource manager before it is released.
+	m_GlobalConstant.Cleanup();
+	m_LightConstant.Cleanup();
+	m_ReflectionGlobalConstant.Cleanup();
+	m_PostProcessor.Cleanup();
+
 	if (m_pResourceManager)
 	{
 		delete m_pResourceManager;
@@ -183,10 +226,6 @@ void Renderer::Cleanup()
 	m_FenceValue = 0;
 	SAFE_RELEASE(m_pFence);
 
-	m_GlobalConstant.Cleanup();
-	m_LightConstant.Cleanup();
-	m_ReflectionGlobalConstant.Cleanup();
-
 	for (UINT i = 0; i < SWAP_CHAIN_FRAME_COUNT; ++i)
 	{
 		for (UINT j = 0; j < MAX_RENDER_THREAD_COUNT; ++j)
@@ -216,8 +255,9 @@ void Renderer::Cleanup()
 		}
 	}
 
-	m_PostProcessor.Cleanup();
 	m_DynamicDescriptorPool.Cleanup();
+	m_BindlessDescriptorPool.Cleanup();
+	m_PersistentDescriptorPool.Cleanup();
 
 	SAFE_RELEASE(m_pDefaultDepthStencil);
 
@@ -463,6 +503,19 @@ LRESULT Renderer::MsgProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 					Renderer* pRenderer = this;
 					m_PostProcessor.Initizlie(pRenderer, config, m_ScreenWidth, m_ScreenHeight, 4);
 					m_PostProcessor.SetDescriptorHeap(pRenderer);
+
+					// filter SRVs are rewritten at same handles, so cached tables are stale.
+#ifdef USE_MULTI_THREAD
+					for (UINT i = 0; i < SWAP_CHAIN_FRAME_COUNT; ++i)
+					{
+						for (UINT j = 0; j < m_RenderThreadCount; ++j)
+						{
+							m_pppDescriptorPool[i][j]->InvalidateTableCache();
+						}
+					}
+#else
+					m_DynamicDescriptorPool.InvalidateTableCache();
+#endif
 					m_Camera.SetAspectRatio((float)m_ScreenWidth / (float)m_ScreenHeight);
 				}
 			}
@@ -662,6 +715,22 @@ LB_EXIT:
 		SetDebugLayerInfo(m_pDevice);
 	}
 
+	// bindless tables are BINDLESS_DESCRIPTOR_COUNT srvs each, far above 128 srvs per stage of tier 1.
+	{
+		D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+		hr = m_pDevice->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+		BREAK_IF_FAILED(hr);
+
+		if (options.ResourceBindingTier < (D3D12_RESOURCE_BINDING_TIER)BINDLESS_MIN_RESOURCE_BINDING_TIER)
+		{
+			char errorString[256] = { 0, };
+			sprintf_s(errorString, "Resource binding tier %d is not supported. Bindless descriptor range needs tier %d or higher.\n", (int)options.ResourceBindingTier, BINDLESS_MIN_RESOURCE_BINDING_TIER);
+			OutputDebugStringA(errorString);
+			MessageBoxA(m_hMainWindow, errorString, "Renderer", MB_OK | MB_ICONERROR);
+			__debugbreak();
+		}
+	}
+
 	UINT physicalCoreCount = 0;
 	UINT logicalCoreCount = 0;
 	GetPhysicalCoreCount(&physicalCoreCount, &logicalCoreCount);
@@ -757,6 +826,13 @@ LB_EXIT:
 			}
 		}
 
+		// every dynamic pool takes pages of persistent pool's heap, so persistent tables can be bound with them.
+		// page region covers budgets of all pools plus one table cache page each. pages are shared, so busy pool may go over its budget.
+		const UINT POOL_COUNT = SWAP_CHAIN_FRAME_COUNT * m_RenderThreadCount + 1;
+		const UINT DYNAMIC_PAGE_COUNT = (DYNAMIC_DESCRIPTOR_COUNT + SWAP_CHAIN_FRAME_COUNT * m_RenderThreadCount * THREAD_DYNAMIC_DESCRIPTOR_COUNT) / DYNAMIC_DESCRIPTOR_PAGE_SIZE + POOL_COUNT;
+		const UINT RANGE_DESCRIPTOR_COUNT = GLOBAL_DESCRIPTOR_TABLE_COUNT * GLOBAL_DESCRIPTOR_TABLE_SIZE + BINDLESS_DESCRIPTOR_COUNT;
+		m_PersistentDescriptorPool.Initialize(m_pDevice, PERSISTENT_TABLE_DESCRIPTOR_COUNT, DYNAMIC_PAGE_COUNT, RANGE_DESCRIPTOR_COUNT);
+
 		for (UINT i = 0; i < SWAP_CHAIN_FRAME_COUNT; i++)
 		{
 			for (UINT j = 0; j < m_RenderThreadCount; j++)
@@ -765,9 +841,13 @@ LB_EXIT:
 				m_pppCommandListPool[i][j]->Initialize(m_pDevice, D3D12_COMMAND_LIST_TYPE_DIRECT, 256);
 
 				m_pppDescriptorPool[i][j] = new DynamicDescriptorPool;
-				m_pppDescriptorPool[i][j]->Initialize(m_pDevice, 4096 * 9);
+				m_pppDescriptorPool[i][j]->Initialize(m_pDevice, &m_PersistentDescriptorPool, THREAD_DYNAMIC_DESCRIPTOR_INITIAL_PAGE_COUNT);
+				m_pppDescriptorPool[i][j]->InitTableCache(DYNAMIC_DESCRIPTOR_TABLE_CACHE_COUNT);
 			}
 		}
+
+		m_DynamicDescriptorPool.Initialize(m_pDevice, &m_PersistentDescriptorPool, DYNAMIC_DESCRIPTOR_COUNT / DYNAMIC_DESCRIPTOR_PAGE_SIZE);
+		m_DynamicDescriptorPool.InitTableCache(DYNAMIC_DESCRIPTOR_TABLE_CACHE_COUNT);
 	}
 
 	// create fence
@@ -824,12 +904,17 @@ LB_EXIT:
 		m_pPrevBuffer->SetName(L"PrevBuffer");
 	}
 
-	ResourceManager::InitialData initData = { m_pDevice, m_pCommandQueue, m_ppCommandAllocator, m_ppCommandList, &m_DynamicDescriptorPool, m_hFenceEvent, m_pFence, &m_FrameIndex, &m_FenceValue, m_LastFenceValues };
+	ResourceManager::InitialData initData = { m_pDevice, m_pCommandQueue, m_ppCommandAllocator, m_ppCommandList, &m_DynamicDescriptorPool, &m_PersistentDescriptorPool, &m_BindlessDescriptorPool, m_hFenceEvent, m_pFence, &m_FrameIndex, &m_FenceValue, m_LastFenceValues };
 	m_pResourceManager = new ResourceManager;
 	m_pResourceManager->Initialize(&initData);
 	m_pResourceManager->InitRTVDescriptorHeap(16);
 	m_pResourceManager->InitDSVDescriptorHeap(8);
 	m_pResourceManager->InitCBVSRVUAVDescriptorHeap(1024);
+
+#ifdef USE_ASSET_STREAMING
+	// one core left for main thread. streamer stays uninitialized(no threads) otherwise.
+	m_AssetStreamer.Initialize(physicalCoreCount > 1 ? physicalCoreCount - 1 : 1);
+#endif
 	
 #ifdef USE_MULTI_THREAD
 	// create thread and event
@@ -1084,6 +1169,12 @@ void Renderer::initDescriptorHeap(Texture* pEnvTexture, Texture* pIrradianceText
 		// cbvSrvHandle.Offset(1, CBV_SRV_UAV_DESCRIPTOR_SIZE);
 		++(m_pResourceManager->m_CBVSRVUAVHeapSize);
 
+		// global views above do not change after this.
+		m_pResourceManager->InitGlobalDescriptorTables();
+
+		// unused bindless slots read null view above.
+		m_BindlessDescriptorPool.Initialize(m_pDevice, &m_PersistentDescriptorPool, BINDLESS_DESCRIPTOR_COUNT, cbvSrvHandle);
+
 		// Model   ۵ .
 		for (UINT64 i = 0, size = m_pRenderObjects->size(); i < size; ++i)
 		{
@@ -1198,7 +1289,9 @@ void Renderer::beginRender()
 		m_DynamicDescriptorPool.GetDescriptorHeap(),
 		m_pResourceManager->m_pSamplerHeap
 	};
-	m_ppCommandList[m_FrameIndex]->SetDescriptorHeaps(2, ppDescriptorHeaps);
+	CommandStateCache* pStateCache = m_pResourceManager->GetSingleStateCache();
+	pStateCache->Reset(m_ppCommandList[m_FrameIndex]);
+	pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
 
 #endif
 }
@@ -1242,12 +1335,10 @@ void Renderer::renderShadowmap()
 		}
 		pCommandList->ResourceBarrier(1, &barrier);
 
-		// register object to render queue.
-		m_CurThreadIndex = 0;
-		for (UINT64 i = 0, size = m_pRenderObjects->size(); i < size; ++i)
+		// objects of every light are collected, render queues get them after loop.
+		for (UINT64 j = 0, size = m_pRenderObjects->size(); j < size; ++j)
 		{
-			RenderQueue* pRenderQue = m_pppRenderQueue[RenderPass_Shadow][m_CurThreadIndex];
-			Model* pModel = (*m_pRenderObjects)[i];
+			Model* pModel = (*m_pRenderObjects)[j];
 
 			if (!pModel->bIsVisible || !pModel->bCastShadow)
 			{
@@ -1265,14 +1356,12 @@ void Renderer::renderShadowmap()
 			{
 				item.PSOType = (eRenderPSOType)(renderPSO + 1);			
 			}
-
-			if (!pRenderQue->Add(&item))
-			{
-				__debugbreak();
-			}
-			++m_CurThreadIndex;
+			// light is sub state, so draws of one light are adjacent. depth order does not matter for depth only draws.
+			item.SortKey = MakeRenderSortKey(RenderPass_Shadow, item.PSOType, (UINT)i, 0.0f);
+			m_PassRenderItems.push_back(item);
 		}
 	}
+	distributeRenderItems(RenderPass_Shadow);
 
 	// pCommandListPool->ClosedAndExecute(m_ppCommandQueue[RenderPass_Shadow]);
 	pCommandListPool->ClosedAndExecute(m_pCommandQueue);
@@ -1288,15 +1377,49 @@ void Renderer::renderShadowmap()
 #endif
 }
 
+void Renderer::distributeRenderItems(const UINT RENDER_PASS)
+{
+	_ASSERT(RENDER_PASS < RenderPass_RenderPassCount);
+
+	// one sorted list cut into contiguous chunks, not items dealt round robin. each thread gets whole runs of
+	// same state, so state is set once per run plus once per thread instead of once per run in every thread.
+	const UINT COUNT = (UINT)m_PassRenderItems.size();
+	if (m_PassSortEntries.size() < COUNT)
+	{
+		m_PassSortEntries.resize(COUNT);
+		m_PassSortTemp.resize(COUNT);
+	}
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		m_PassSortEntries[i].Key = m_PassRenderItems[i].SortKey;
+		m_PassSortEntries[i].Index = i;
+	}
+	RadixSort64(m_PassSortEntries.data(), m_PassSortTemp.data(), COUNT);
+
+	for (UINT i = 0; i < m_RenderThreadCount; ++i)
+	{
+		RenderQueue* pRenderQue = m_pppRenderQueue[RENDER_PASS][i];
+		const UINT END = GetRenderChunkBegin(COUNT, m_RenderThreadCount, i + 1);
+		for (UINT j = GetRenderChunkBegin(COUNT, m_RenderThreadCount, i); j < END; ++j)
+		{
+			if (!pRenderQue->Add(&m_PassRenderItems[m_PassSortEntries[j].Index]))
+			{
+				__debugbreak();
+			}
+		}
+	}
+
+	m_PassRenderItems.clear();
+}
+
 void Renderer::renderObject()
 {
 #ifdef USE_MULTI_THREAD
 
 	// register obejct to render queue.
-	m_CurThreadIndex = 0;
+	const Vector3 EYE_POS = m_Camera.GetEyePos();
 	for (UINT64 i = 0, size = m_pRenderObjects->size(); i < size; ++i)
 	{
-		RenderQueue* pRenderQue = m_pppRenderQueue[RenderPass_Object][m_CurThreadIndex];
 		Model* pCurModel = (*m_pRenderObjects)[i];
 
 		if (!pCurModel->bIsVisible)
@@ -1327,13 +1450,10 @@ void Renderer::renderObject()
 			default:
 				break;
 		}
-
-		if (!pRenderQue->Add(&item))
-		{
-			__debugbreak();
-		}
-		++m_CurThreadIndex;
+		item.SortKey = MakeRenderSortKey(RenderPass_Object, item.PSOType, 0, (EYE_POS - Vector3(pCurModel->BoundingSphere.Center)).Length());
+		m_PassRenderItems.push_back(item);
 	}
+	distributeRenderItems(RenderPass_Object);
 
 #else
 
@@ -1411,10 +1531,9 @@ void Renderer::renderMirror()
 #ifdef USE_MULTI_THREAD
 
 	// register object to render queue.
-	m_CurThreadIndex = 0;
+	const Vector3 EYE_POS = m_Camera.GetEyePos();
 	for (UINT64 i = 0, size = m_pRenderObjects->size(); i < size; ++i)
 	{
-		RenderQueue* pRenderQue = m_pppRenderQueue[RenderPass_Mirror][m_CurThreadIndex];
 		Model* pCurModel = (*m_pRenderObjects)[i];
 
 		if (!pCurModel->bIsVisible)
@@ -1445,13 +1564,10 @@ void Renderer::renderMirror()
 			default:
 				break;
 		}
-
-		if (!pRenderQue->Add(&item))
-		{
-			__debugbreak();
-		}
-		++m_CurThreadIndex;
+		item.SortKey = MakeRenderSortKey(RenderPass_Mirror, item.PSOType, 0, (EYE_POS - Vector3(pCurModel->BoundingSphere.Center)).Length());
+		m_PassRenderItems.push_back(item);
 	}
+	distributeRenderItems(RenderPass_Mirror);
 
 #else
 
@@ -1675,6 +1791,7 @@ void Renderer::endRender()
 	// stencil process.
 	{
 		ID3D12GraphicsCommandList* pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 		DynamicDescriptorPool* pDescriptorPool = m_pppDescriptorPool[m_FrameIndex][0];
 		ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
 		{
@@ -1684,10 +1801,10 @@ void Renderer::endRender()
 		CD3DX12_CPU_DESCRIPTOR_HANDLE floatBufferRtvHandle(m_pResourceManager->m_pRTVHeap->GetCPUDescriptorHandleForHeapStart(), m_FloatBufferRTVOffset, m_pResourceManager->m_RTVDescriptorSize);
 		CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_pResourceManager->m_pDSVHeap->GetCPUDescriptorHandleForHeapStart());
 		
-		m_PostProcessor.SetViewportsAndScissorRects(pCommandList);
+		m_PostProcessor.SetViewportsAndScissorRects(pStateCache);
 		pCommandList->OMSetRenderTargets(1, &floatBufferRtvHandle, FALSE, &dsvHandle);
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
-		m_pResourceManager->SetCommonState(0, pCommandList, m_pppDescriptorPool[m_FrameIndex][0], RenderPSOType_StencilMask);
+		pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
+		m_pResourceManager->SetCommonState(0, pStateCache, m_pppDescriptorPool[m_FrameIndex][0], RenderPSOType_StencilMask);
 		m_pMirror->Render(0, pCommandList, pDescriptorPool, m_pResourceManager, RenderPSOType_StencilMask);
 		// pCommandListPool->ClosedAndExecute(m_ppCommandQueue[RenderPass_MainRender]);
 		pCommandListPool->ClosedAndExecute(m_pCommandQueue);
@@ -1700,6 +1817,7 @@ void Renderer::endRender()
 	// mirror blend process.
 	{
 		ID3D12GraphicsCommandList* pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 		DynamicDescriptorPool* pDescriptorPool = m_pppDescriptorPool[m_FrameIndex][0];
 		ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
 		{
@@ -1709,10 +1827,10 @@ void Renderer::endRender()
 		CD3DX12_CPU_DESCRIPTOR_HANDLE floatBufferRtvHandle(m_pResourceManager->m_pRTVHeap->GetCPUDescriptorHandleForHeapStart(), m_FloatBufferRTVOffset, m_pResourceManager->m_RTVDescriptorSize);
 		CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_pResourceManager->m_pDSVHeap->GetCPUDescriptorHandleForHeapStart());
 
-		m_PostProcessor.SetViewportsAndScissorRects(pCommandList);
+		m_PostProcessor.SetViewportsAndScissorRects(pStateCache);
 		pCommandList->OMSetRenderTargets(1, &floatBufferRtvHandle, FALSE, &dsvHandle);
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
-		m_pResourceManager->SetCommonState(0, pCommandList, m_pppDescriptorPool[m_FrameIndex][0], RenderPSOType_MirrorBlend);
+		pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
+		m_pResourceManager->SetCommonState(0, pStateCache, m_pppDescriptorPool[m_FrameIndex][0], RenderPSOType_MirrorBlend);
 		m_pMirror->Render(0, pCommandList, pDescriptorPool, m_pResourceManager, RenderPSOType_MirrorBlend);
 		
 		const CD3DX12_RESOURCE_BARRIER BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(m_pFloatBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
@@ -1726,6 +1844,7 @@ void Renderer::endRender()
 	// postprocessing pass.
 	{
 		ID3D12GraphicsCommandList* pCommandList = pCommandListPool->GetCurrentCommandList();
+		CommandStateCache* pStateCache = pCommandListPool->GetCurrentStateCache();
 		DynamicDescriptorPool* pDescriptorPool = m_pppDescriptorPool[m_FrameIndex][0];
 		// const CD3DX12_RESOURCE_BARRIER BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(m_pFloatBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
 		ID3D12DescriptorHeap* ppDescriptorHeaps[2] =
@@ -1735,8 +1854,8 @@ void Renderer::endRender()
 		};
 		
 		// pCommandList->ResourceBarrier(1, &BARRIER);
-		pCommandList->SetDescriptorHeaps(2, ppDescriptorHeaps);
-		m_PostProcessor.Render(0, pCommandList, pDescriptorPool, m_pResourceManager, m_FrameIndex);
+		pStateCache->SetDescriptorHeaps(2, ppDescriptorHeaps);
+		m_PostProcessor.Render(0, pStateCache, pDescriptorPool, m_pResourceManager, m_FrameIndex);
 	
 		const CD3DX12_RESOURCE_BARRIER RTV_AFTER_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(m_pRenderTargets[m_FrameIndex], D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_PRESENT);
 		pCommandList->ResourceBarrier(1, &RTV_AFTER_BARRIER);
@@ -1744,10 +1863,23 @@ void Renderer::endRender()
 	}
 	fence();
 
+	m_LastFrameRenderItemCount = 0;
+	m_LastFrameStateChangeCount = 0;
+	m_LastFrameStateCallIssuedCount = 0;
+	m_LastFrameStateCallFilteredCount = 0;
+	for (UINT i = 0; i < m_RenderThreadCount; ++i)
+	{
+		const CommandStateStats& STATE_STATS = m_pppCommandListPool[m_FrameIndex][i]->GetStateStats();
+		m_LastFrameStateCallIssuedCount += STATE_STATS.IssuedCount;
+		m_LastFrameStateCallFilteredCount += STATE_STATS.FilteredCount;
+	}
 	for (int i = 0; i < RenderPass_RenderPassCount; ++i)
 	{
 		for (UINT j = 0; j < m_RenderThreadCount; ++j)
 		{
+			const RenderQueueStats& QUEUE_STATS = m_pppRenderQueue[i][j]->GetStats();
+			m_LastFrameRenderItemCount += QUEUE_STATS.ItemCount;
+			m_LastFrameStateChangeCount += QUEUE_STATS.StateChangeCount;
 			m_pppRenderQueue[i][j]->Reset();
 		}
 	}
@@ -1764,6 +1896,10 @@ void Renderer::endRender()
 	ID3D12CommandList* ppCommandLists[] = { m_ppCommandList[m_FrameIndex] };
 	m_pCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
+	const CommandStateStats& STATE_STATS = m_pResourceManager->GetSingleStateCache()->GetStats();
+	m_LastFrameStateCallIssuedCount = STATE_STATS.IssuedCount;
+	m_LastFrameStateCallFilteredCount = STATE_STATS.FilteredCount;
+
 #endif
 }
 
@@ -1790,8 +1926,25 @@ void Renderer::present()
 	UINT nextFrameIndex = m_pSwapChain->GetCurrentBackBufferIndex();
 	waitForFenceValue(m_LastFenceValues[m_FrameIndex]);
 
+	// descriptors written for this frame. persistent tables count only when they are rewritten.
+	m_LastFrameDescriptorWriteCount = m_PersistentDescriptorPool.GetStats().WriteCount + m_BindlessDescriptorPool.GetStats().WriteCount;
+	m_PersistentDescriptorPool.BeginFrame();
+	// dynamic pages held by all pools at once, both frames in flight.
+	m_LastFrameDescriptorPageHighWater = m_PersistentDescriptorPool.GetStats().LastFramePageHighWater;
+	m_BindlessDescriptorPool.BeginFrame();
+	m_LastFrameTableCacheHitCount = 0;
+	m_LastFrameTableCacheLookupCount = 0;
+
 #ifdef USE_MULTI_THREAD
 
+	for (UINT i = 0; i < m_RenderThreadCount; ++i)
+	{
+		DynamicDescriptorPool* pDescriptorPool = m_pppDescriptorPool[m_FrameIndex][i];
+		const DescriptorTableCacheStats& CACHE_STATS = pDescriptorPool->GetTableCacheStats();
+		m_LastFrameDescriptorWriteCount += (UINT)(pDescriptorPool->GetAllocatedDescriptorCount() + pDescriptorPool->GetCachedWriteCount());
+		m_LastFrameTableCacheHitCount += CACHE_STATS.HitCount;
+		m_LastFrameTableCacheLookupCount += CACHE_STATS.HitCount + CACHE_STATS.MissCount;
+	}
 	for (UINT i = 0; i < m_RenderThreadCount; ++i)
 	{
 		m_pppCommandListPool[nextFrameIndex][i]->Reset();
@@ -1800,10 +1953,16 @@ void Renderer::present()
 
 #else
 
+	const DescriptorTableCacheStats& CACHE_STATS = m_DynamicDescriptorPool.GetTableCacheStats();
+	m_LastFrameDescriptorWriteCount += (UINT)(m_DynamicDescriptorPool.GetAllocatedDescriptorCount() + m_DynamicDescriptorPool.GetCachedWriteCount());
+	m_LastFrameTableCacheHitCount = CACHE_STATS.HitCount;
+	m_LastFrameTableCacheLookupCount = CACHE_STATS.HitCount + CACHE_STATS.MissCount;
 	m_DynamicDescriptorPool.Reset();
 
 #endif
 
+	m_pResourceManager->GetFrameConstantAllocator()->BeginFrame(nextFrameIndex);
+
 	m_FrameIndex = nextFrameIndex;
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "AssetStreamer.h"
 #include "../Graphics/Camera.h"
 #include "../Graphics/ConstantDataType.h"
 #include "DynamicDescriptorPool.h"
+#include "PersistentDescriptorPool.h"
+#include "BindlessDescriptorPool.h"
 #include "../Util/KnM.h"
 #include "../Graphics/Light.h"
 #include "../Model/Model.h"
@@ -11,6 +14,7 @@
 #include "../Model/SkinnedMeshModel.h"
 #include "../Physics/PhysicsManager.h"
 #include "../Graphics/PostProcessor.h"
+#include "../Graphics/TextureCache.h"
 
 class Renderer
 {
@@ -47,7 +51,19 @@ public:
 
 	inline ResourceManager* GetResourceManager() { return m_pResourceManager; }
 	inline PhysicsManager* GetPhysicsManager() { return &m_PhysicsManager; }
+	inline AssetStreamer* GetAssetStreamer() { return &m_AssetStreamer; }
+	inline TextureCache* GetTextureCache() { return &m_TextureCache; }
 	inline HWND GetWindow() { return m_hMainWindow; }
+	inline UINT GetLastFrameDescriptorWriteCount() { return m_LastFrameDescriptorWriteCount; }
+	inline UINT GetLastFrameTableCacheHitCount() { return m_LastFrameTableCacheHitCount; }
+	inline UINT GetLastFrameTableCacheLookupCount() { return m_LastFrameTableCacheLookupCount; }
+	inline UINT GetLastFrameDescriptorPageHighWater() { return m_LastFrameDescriptorPageHighWater; }
+	// queued draws and SetCommonState() calls of them. without sorting both are same.
+	inline UINT GetLastFrameRenderItemCount() { return m_LastFrameRenderItemCount; }
+	inline UINT GetLastFrameStateChangeCount() { return m_LastFrameStateChangeCount; }
+	// state calls passed to command lists and dropped as redundant. render threads, or single command list.
+	inline UINT GetLastFrameStateCallIssuedCount() { return m_LastFrameStateCallIssuedCount; }
+	inline UINT GetLastFrameStateCallFilteredCount() { return m_LastFrameStateCallFilteredCount; }
 
 protected:
 	void initMainWidndow();
@@ -59,6 +75,7 @@ protected:
 
 	void beginRender();
 	void renderShadowmap();
+	void distributeRenderItems(const UINT RENDER_PASS);
 	void renderObject();
 	void renderMirror();
 	void renderObjectBoundingModel();
@@ -104,6 +121,10 @@ protected:
 	int m_PickedEndEffectorType = -1;
 	DirectX::SimpleMath::Plane* m_pMirrorPlane = nullptr;
 
+	// stats.
+	UINT m_ClusterTriangleCount = 0;
+	UINT m_CulledClusterTriangleCount = 0;
+
 private:
 	ResourceManager* m_pResourceManager = nullptr;
 
@@ -128,16 +149,31 @@ private:
 	DynamicDescriptorPool* m_pppDescriptorPool[SWAP_CHAIN_FRAME_COUNT][MAX_RENDER_THREAD_COUNT] = { nullptr, };
 	RenderThreadDesc* m_pThreadDescList = nullptr;
 	UINT m_RenderThreadCount = 0;
-	UINT m_CurThreadIndex = 0; // render queue յϰ ֱ  ε.
+	// items of pass being registered. sorted once and cut into one contiguous chunk per render queue.
+	std::vector<RenderItem> m_PassRenderItems;
+	std::vector<RadixSortEntry> m_PassSortEntries;
+	std::vector<RadixSortEntry> m_PassSortTemp;
 
 	long volatile m_pActiveThreadCounts[RenderPass_RenderPassCount] = { 0, };
 	HANDLE m_phCompletedEvents[RenderPass_RenderPassCount] = { nullptr, };
 	/////////////////////////////////////////////
 
 	PhysicsManager m_PhysicsManager;
+	AssetStreamer m_AssetStreamer;
+	TextureCache m_TextureCache;
 
 	// main resources.
+	PersistentDescriptorPool m_PersistentDescriptorPool; // owns shader visible heap of all descriptor pools.
+	BindlessDescriptorPool m_BindlessDescriptorPool; // range of persistent pool. mesh textures and bone buffers.
 	DynamicDescriptorPool m_DynamicDescriptorPool;
+	UINT m_LastFrameDescriptorWriteCount = 0;
+	UINT m_LastFrameTableCacheHitCount = 0;
+	UINT m_LastFrameTableCacheLookupCount = 0;
+	UINT m_LastFrameDescriptorPageHighWater = 0;
+	UINT m_LastFrameRenderItemCount = 0;
+	UINT m_LastFrameStateChangeCount = 0;
+	UINT m_LastFrameStateCallIssuedCount = 0;
+	UINT m_LastFrameStateCallFilteredCount = 0;
 	ID3D12Resource* m_pRenderTargets[SWAP_CHAIN_FRAME_COUNT] = { nullptr, };
 	ID3D12Resource* m_pFloatBuffer = nullptr;
 	ID3D12Resource* m_pPrevBuffer = nullptr;
@@ -29,6 +29,8 @@ void ResourceManager::Initialize(InitialData* pInitialData)
 	m_ppSingleCommandAllocator = pInitialData->ppCommandAllocator;
 	m_ppSingleCommandList = pInitialData->ppCommandList;
 	m_pDynamicDescriptorPool = pInitialData->pDynamicDescriptorPool;
+	m_pPersistentDescriptorPool = pInitialData->pPersistentDescriptorPool;
+	m_pBindlessDescriptorPool = pInitialData->pBindlessDescriptorPool;
 	m_hFenceEvent = pInitialData->hFenceEvent;
 	m_pFence = pInitialData->pFence;
 	m_pFrameIndex = pInitialData->pFrameIndex;
@@ -40,6 +42,12 @@ void ResourceManager::Initialize(InitialData* pInitialData)
 	m_CBVSRVUAVDescriptorSize = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	m_SamplerDescriptorSize = m_pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
 
+	m_UploadBatch.Initialize(m_pDevice, m_pCommandQueue, m_pFence, m_hFenceEvent, m_pFenceValue, STAGING_RING_SIZE);
+	m_DefaultBufferPool.Initialize(m_pDevice, D3D12_HEAP_TYPE_DEFAULT, DEFAULT_BUFFER_CHUNK_SIZE, L"DefaultBufferPool");
+	m_UploadBufferPool.Initialize(m_pDevice, D3D12_HEAP_TYPE_UPLOAD, UPLOAD_BUFFER_CHUNK_SIZE, L"UploadBufferPool");
+	m_FrameConstantAllocator.Initialize(m_pDevice, SWAP_CHAIN_FRAME_COUNT, FRAME_CONSTANT_SIZE_PER_FRAME);
+	m_FrameConstantAllocator.BeginFrame(*m_pFrameIndex);
+
 	initSamplers();
 	initRasterizerStateDescs();
 	initBlendStateDescs();
@@ -108,226 +116,106 @@ void ResourceManager::InitCBVSRVUAVDescriptorHeap(UINT maxDescriptorNum)
 	m_pCBVSRVUAVHeap->SetName(L"ConstantShaderUnorderedResourceViewDescriptorHeap");
 }
 
-HRESULT ResourceManager::CreateVertexBuffer(UINT sizePerVertex, UINT numVertex, D3D12_VERTEX_BUFFER_VIEW* pOutVertexBufferView, ID3D12Resource** ppOutBuffer, void* pInitData)
+HRESULT ResourceManager::CreateVertexBuffer(UINT sizePerVertex, UINT numVertex, D3D12_VERTEX_BUFFER_VIEW* pOutVertexBufferView, GPUBufferAllocation* pOutAllocation, void* pInitData)
 {
 	_ASSERT(m_pDevice);
 	_ASSERT(m_pCommandQueue);
-	_ASSERT(m_ppSingleCommandAllocator);
-	_ASSERT(m_ppSingleCommandList);
+	_ASSERT(pOutAllocation);
 
 	HRESULT hr = S_OK;
 
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
-	ID3D12Resource* pVertexBuffer = nullptr;
-	ID3D12Resource* pUploadBuffer = nullptr;
 	UINT vertexBufferSize = sizePerVertex * numVertex;
 
-	// create vertexbuffer for rendering
-	CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
-	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize);
-	hr = m_pDevice->CreateCommittedResource(&heapProps,
-											D3D12_HEAP_FLAG_NONE,
-											&resourceDesc,
-											D3D12_RESOURCE_STATE_COMMON,
-											nullptr,
-											IID_PPV_ARGS(&pVertexBuffer));
+	// sub-allocate vertexbuffer for rendering
+	hr = m_DefaultBufferPool.Allocate(vertexBufferSize, TLSF_GRANULARITY, pOutAllocation);
 	BREAK_IF_FAILED(hr);
-	
+
 	if (pInitData)
 	{
-		hr = m_ppSingleCommandAllocator[*m_pFrameIndex]->Reset();
+		// chunk is shared by many meshes, so it stays in COMMON and is promoted implicitly.
+		BeginUpload();
+		hr = m_UploadBatch.UploadBuffer(pOutAllocation->pResource, pOutAllocation->Offset, pInitData, vertexBufferSize, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COMMON);
+		EndUpload();
 		BREAK_IF_FAILED(hr);
-
-		hr = m_ppSingleCommandList[*m_pFrameIndex]->Reset(m_ppSingleCommandAllocator[*m_pFrameIndex], nullptr);
-		BREAK_IF_FAILED(hr);
-
-		heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-		resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize);
-		hr = m_pDevice->CreateCommittedResource(&heapProps,
-												D3D12_HEAP_FLAG_NONE,
-												&resourceDesc,
-												D3D12_RESOURCE_STATE_COMMON,
-												nullptr,
-												IID_PPV_ARGS(&pUploadBuffer));
-		BREAK_IF_FAILED(hr);
-		pUploadBuffer->SetName(L"tempVertexUploader");
-
-		UINT8* pVertexDataBegin = nullptr;
-		CD3DX12_RANGE readRange(0, 0);
-
-		hr = pUploadBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin));
-		BREAK_IF_FAILED(hr);
-
-		memcpy(pVertexDataBegin, pInitData, vertexBufferSize);
-		pUploadBuffer->Unmap(0, nullptr);
-
-		const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pVertexBuffer, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-		const CD3DX12_RESOURCE_BARRIER AFTER_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pVertexBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
-		m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &BEFORE_BARRIER);
-		m_ppSingleCommandList[*m_pFrameIndex]->CopyBufferRegion(pVertexBuffer, 0, pUploadBuffer, 0, vertexBufferSize);
-		m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &AFTER_BARRIER);
-
-		m_ppSingleCommandList[*m_pFrameIndex]->Close();
-
-		ID3D12CommandList* ppCommandLists[] = { m_ppSingleCommandList[*m_pFrameIndex] };
-		m_pCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-		fence();
-		waitForGPU(m_pFenceValues[*m_pFrameIndex]);
-
-		SAFE_RELEASE(pUploadBuffer);
 	}
 
-
 	// Initialize the vertex buffer view.
-	vertexBufferView.BufferLocation = pVertexBuffer->GetGPUVirtualAddress();
+	vertexBufferView.BufferLocation = pOutAllocation->GPUAddress;
 	vertexBufferView.StrideInBytes = sizePerVertex;
 	vertexBufferView.SizeInBytes = vertexBufferSize;
 
 	*pOutVertexBufferView = vertexBufferView;
-	*ppOutBuffer = pVertexBuffer;
 	
 	return hr;
 }
 
-HRESULT ResourceManager::CreateIndexBuffer(UINT sizePerIndex, UINT numIndex, D3D12_INDEX_BUFFER_VIEW* pOutIndexBufferView, ID3D12Resource** ppOutBuffer, void* pInitData)
+HRESULT ResourceManager::CreateIndexBuffer(UINT sizePerIndex, UINT numIndex, D3D12_INDEX_BUFFER_VIEW* pOutIndexBufferView, GPUBufferAllocation* pOutAllocation, void* pInitData)
 {
 	_ASSERT(m_pDevice);
 	_ASSERT(m_pCommandQueue);
-	_ASSERT(m_ppSingleCommandAllocator);
-	_ASSERT(m_ppSingleCommandList);
+	_ASSERT(pOutAllocation);
 
 	HRESULT hr = S_OK;
 
 	D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
-	ID3D12Resource* pIndexBuffer = nullptr;
-	ID3D12Resource* pUploadBuffer = nullptr;
 	UINT indexBufferSize = sizePerIndex * numIndex;
 
-	// create vertexbuffer for rendering
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(indexBufferSize);
-	hr = m_pDevice->CreateCommittedResource(&heapProps,
-											D3D12_HEAP_FLAG_NONE,
-											&resourceDesc,
-											D3D12_RESOURCE_STATE_COMMON,
-											nullptr,
-											IID_PPV_ARGS(&pIndexBuffer));
+	_ASSERT(sizePerIndex == sizeof(USHORT) || sizePerIndex == sizeof(UINT));
+
+	// sub-allocate indexbuffer for rendering
+	hr = m_DefaultBufferPool.Allocate(indexBufferSize, TLSF_GRANULARITY, pOutAllocation);
 	BREAK_IF_FAILED(hr);
 
 	if (pInitData)
 	{
-		hr = m_ppSingleCommandAllocator[*m_pFrameIndex]->Reset();
-		BREAK_IF_FAILED(hr);
-
-		hr = m_ppSingleCommandList[*m_pFrameIndex]->Reset(m_ppSingleCommandAllocator[*m_pFrameIndex], nullptr);
-		BREAK_IF_FAILED(hr);
-
-		heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-		resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(indexBufferSize);
-		hr = m_pDevice->CreateCommittedResource(&heapProps,
-												D3D12_HEAP_FLAG_NONE,
-												&resourceDesc,
-												D3D12_RESOURCE_STATE_COMMON,
-												nullptr,
-												IID_PPV_ARGS(&pUploadBuffer));
+		BeginUpload();
+		hr = m_UploadBatch.UploadBuffer(pOutAllocation->pResource, pOutAllocation->Offset, pInitData, indexBufferSize, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COMMON);
+		EndUpload();
 		BREAK_IF_FAILED(hr);
-		pUploadBuffer->SetName(L"tempIndexUploader");
-
-		UINT8* pIndexDataBegin = nullptr;
-		CD3DX12_RANGE readRange(0, 0);
-
-		hr = pUploadBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pIndexDataBegin));
-		BREAK_IF_FAILED(hr);
-
-		memcpy(pIndexDataBegin, pInitData, indexBufferSize);
-		pUploadBuffer->Unmap(0, nullptr);
-
-		const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pIndexBuffer, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
-		const CD3DX12_RESOURCE_BARRIER AFTER_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pIndexBuffer, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
-		m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &BEFORE_BARRIER);
-		m_ppSingleCommandList[*m_pFrameIndex]->CopyBufferRegion(pIndexBuffer, 0, pUploadBuffer, 0, indexBufferSize);
-		m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &AFTER_BARRIER);
-
-		m_ppSingleCommandList[*m_pFrameIndex]->Close();
-
-		ID3D12CommandList* ppCommandLists[] = { m_ppSingleCommandList[*m_pFrameIndex] };
-		m_pCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-		fence();
-		waitForGPU(m_pFenceValues[*m_pFrameIndex]);
-
-		SAFE_RELEASE(pUploadBuffer);
 	}
 
-
-	// Initialize the vertex buffer view.
-	indexBufferView.BufferLocation = pIndexBuffer->GetGPUVirtualAddress();
+	// Initialize the index buffer view.
+	indexBufferView.BufferLocation = pOutAllocation->GPUAddress;
 	indexBufferView.SizeInBytes = indexBufferSize;
-	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	indexBufferView.Format = (sizePerIndex == sizeof(USHORT) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
 
 	*pOutIndexBufferView = indexBufferView;
-	*ppOutBuffer = pIndexBuffer;
 	
 	return hr;
 }
 
-HRESULT ResourceManager::UpdateTexture(ID3D12Resource* pDestResource, ID3D12Resource* pSrcResource, D3D12_RESOURCE_STATES* originalState)
+HRESULT ResourceManager::UploadTexture(ID3D12Resource* pDestResource, const UCHAR* pIMAGE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE)
 {
-	_ASSERT(m_pDevice);
-	_ASSERT(m_ppSingleCommandAllocator);
-	_ASSERT(m_ppSingleCommandList);
+	_ASSERT(pDestResource);
+	_ASSERT(pIMAGE);
 
-	const DWORD MAX_SUB_RESOURCE_NUM = 32;
-	D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint[MAX_SUB_RESOURCE_NUM] = {};
-	UINT	rows[MAX_SUB_RESOURCE_NUM] = {};
-	UINT64	rowSize[MAX_SUB_RESOURCE_NUM] = {};
-	UINT64	totalBytes = 0;
 	HRESULT hr = S_OK;
 
-	D3D12_RESOURCE_DESC Desc = pDestResource->GetDesc();
-	if (Desc.MipLevels > (UINT)_countof(footprint))
-	{
-		__debugbreak();
-	}
+	BeginUpload();
+	hr = m_UploadBatch.UploadTexture(pDestResource, pIMAGE, BEFORE_STATE, AFTER_STATE);
+	EndUpload();
+	BREAK_IF_FAILED(hr);
 
-	m_pDevice->GetCopyableFootprints(&Desc, 0, Desc.MipLevels, 0, footprint, rows, rowSize, &totalBytes);
+	return hr;
+}
 
-	hr = m_ppSingleCommandAllocator[*m_pFrameIndex]->Reset();
-	BREAK_IF_FAILED(hr);
+void ResourceManager::BeginUpload()
+{
+	++m_UploadDepth;
+}
 
-	hr = m_ppSingleCommandList[*m_pFrameIndex]->Reset(m_ppSingleCommandAllocator[*m_pFrameIndex], nullptr);
-	BREAK_IF_FAILED(hr);
+void ResourceManager::EndUpload()
+{
+	_ASSERT(m_UploadDepth > 0);
 
-	const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, *originalState, D3D12_RESOURCE_STATE_COPY_DEST);
-	const CD3DX12_RESOURCE_BARRIER AFTER_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, D3D12_RESOURCE_STATE_COPY_DEST, *originalState);
-	
-	m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &BEFORE_BARRIER);
-	for (DWORD i = 0; i < Desc.MipLevels; i++)
+	--m_UploadDepth;
+	if (m_UploadDepth == 0)
 	{
-		D3D12_TEXTURE_COPY_LOCATION	destLocation = {};
-		destLocation.PlacedFootprint = footprint[i];
-		destLocation.pResource = pDestResource;
-		destLocation.SubresourceIndex = i;
-		destLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-
-		D3D12_TEXTURE_COPY_LOCATION	srcLocation = {};
-		srcLocation.PlacedFootprint = footprint[i];
-		srcLocation.pResource = pSrcResource;
-		srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-
-		m_ppSingleCommandList[*m_pFrameIndex]->CopyTextureRegion(&destLocation, 0, 0, 0, &srcLocation, nullptr);
+		// same queue as rendering, so later frames see uploaded data without waiting here.
+		m_UploadBatch.Submit();
+		m_UploadBatch.Retire();
 	}
-	m_ppSingleCommandList[*m_pFrameIndex]->ResourceBarrier(1, &AFTER_BARRIER);
-	m_ppSingleCommandList[*m_pFrameIndex]->Close();
-
-	ID3D12CommandList* ppCommandLists[] = { m_ppSingleCommandList[*m_pFrameIndex] };
-	m_pCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-	fence();
-	waitForGPU(m_pFenceValues[*m_pFrameIndex]);
-
-	return hr;
 }
 
 void ResourceManager::Cleanup()
@@ -337,6 +225,11 @@ void ResourceManager::Cleanup()
 	{
 		waitForGPU(m_pFenceValues[*m_pFrameIndex]);
 	}
+	m_UploadBatch.Cleanup();
+	m_UploadDepth = 0;
+	m_DefaultBufferPool.Cleanup();
+	m_UploadBufferPool.Cleanup();
+	m_FrameConstantAllocator.Cleanup();
 
 	m_pGlobalConstant = nullptr;
 	m_pLightConstant = nullptr;
@@ -344,6 +237,9 @@ void ResourceManager::Cleanup()
 
 	m_GlobalConstantViewStartOffset = 0xffffffff; // b0, b1
 	m_GlobalShaderResourceViewStartOffset = 0xffffffff; // t8 ~ t16`
+	m_GlobalDescriptorTable = { 0xffffffffffffffff };
+	m_ReflectionGlobalDescriptorTable = { 0xffffffffffffffff };
+	m_DepthOnlyGlobalDescriptorTable = { 0xffffffffffffffff };
 
 	m_RTVDescriptorSize = 0;
 	m_DSVDescriptorSize = 0;
@@ -414,6 +310,8 @@ void ResourceManager::Cleanup()
 	SAFE_RELEASE(m_pRTVHeap);
 
 	m_pDynamicDescriptorPool = nullptr;
+	m_pPersistentDescriptorPool = nullptr;
+	m_pBindlessDescriptorPool = nullptr;
 	m_ppSingleCommandList = nullptr;
 	m_ppSingleCommandAllocator = nullptr;
 	m_pCommandQueue = nullptr;
@@ -427,301 +325,64 @@ void ResourceManager::SetGlobalConstants(ConstantBuffer* pGlobal, ConstantBuffer
 	m_pReflectionConstant = pReflection;
 }
 
-void ResourceManager::SetCommonState(eRenderPSOType psoState)
+void ResourceManager::InitGlobalDescriptorTables()
 {
 	_ASSERT(m_pDevice);
-	_ASSERT(m_ppSingleCommandList);
-	_ASSERT(m_pCBVSRVUAVHeap);
-	_ASSERT(m_pSamplerHeap);
+	_ASSERT(m_pPersistentDescriptorPool);
+	_ASSERT(m_GlobalConstantViewStartOffset != 0xffffffff);
+	_ASSERT(m_GlobalShaderResourceViewStartOffset != 0xffffffff);
 
 	HRESULT hr = S_OK;
-	const float BLEND_FECTOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
 
-	// set dynamic descriptor heap. (for commont resource)
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable({ 0xffffffffffffffff, });
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable({ 0xffffffffffffffff, });
+	// b0 offset of each table. default: global, reflection: reflection global. b1 is light for both.
+	const UINT GLOBAL_VIEW_OFFSETS[GLOBAL_DESCRIPTOR_TABLE_COUNT] = { m_GlobalConstantViewStartOffset, m_GlobalConstantViewStartOffset + 1 };
+	D3D12_GPU_DESCRIPTOR_HANDLE* ppTables[GLOBAL_DESCRIPTOR_TABLE_COUNT] = { &m_GlobalDescriptorTable, &m_ReflectionGlobalDescriptorTable };
 
-	switch (psoState)
+	for (UINT i = 0; i < GLOBAL_DESCRIPTOR_TABLE_COUNT; ++i)
 	{
-		case RenderPSOType_Default:
-		case RenderPSOType_Skinned:
-		case RenderPSOType_Skybox:
-		case RenderPSOType_MirrorBlend: 
-		case RenderPSOType_DepthOnlyCubeDefault:
-		case RenderPSOType_DepthOnlyCubeSkinned:
-		case RenderPSOType_DepthOnlyCascadeDefault:
-		case RenderPSOType_DepthOnlyCascadeSkinned:
-		case RenderPSOType_Sampling:
-		case RenderPSOType_BloomDown:
-		case RenderPSOType_BloomUp:
-		case RenderPSOType_Combine:
-		case RenderPSOType_Wire:
-		{
-			hr = m_pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 11);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-			
-			// b0
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-			cbvHandle.Offset(2, m_CBVSRVUAVDescriptorSize);
-
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable = {};
+		hr = m_pPersistentDescriptorPool->AllocDescriptorRange(&cpuDescriptorTable, ppTables[i], GLOBAL_DESCRIPTOR_TABLE_SIZE);
+		BREAK_IF_FAILED(hr);
 
-		case RenderPSOType_ReflectionDefault:
-		case RenderPSOType_ReflectionSkinned:
-		case RenderPSOType_ReflectionSkybox:
-		{
-			hr = m_pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 11);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset + 1, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-			
-			// b0
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-			cbvHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+		CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
+		CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), GLOBAL_VIEW_OFFSETS[i], m_CBVSRVUAVDescriptorSize);
+		CD3DX12_CPU_DESCRIPTOR_HANDLE lightHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset + 2, m_CBVSRVUAVDescriptorSize);
+		CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
 
-		case RenderPSOType_StencilMask:
-		case RenderPSOType_DepthOnlyDefault:
-		case RenderPSOType_DepthOnlySkinned:
-		{
-			hr = m_pDynamicDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 10);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset + 2, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-		
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+		// b0
+		m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
 
-		default:
-			break;
-	}
+		// b1
+		m_pDevice->CopyDescriptorsSimple(1, dstHandle, lightHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
 
-	// set pipeline state for each state.
-	switch (psoState)
-	{
-	case RenderPSOType_Default:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDefaultSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_Skinned:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pSkinnedRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pSkinnedSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_Skybox:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pSkyboxSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_StencilMask:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pStencilMaskPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(1);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootConstantBufferView(1, m_pGlobalConstant->GetGPUMemAddr());
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_MirrorBlend:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pMirrorBlendSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(1);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetBlendFactor(BLEND_FECTOR);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_ReflectionDefault:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pReflectDefaultSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(1);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_ReflectionSkinned:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pSkinnedRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pReflectSkinnedSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(1);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_ReflectionSkybox:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pReflectSkyboxSolidPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(1);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlyDefault:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlyPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlySkinned:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlySkinnedRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlySkinnedPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlyCubeDefault:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlyCubePSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlyCubeSkinned:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlyCubeSkinnedPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlyCascadeDefault:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlyCascadePSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_DepthOnlyCascadeSkinned:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDepthOnlyCascadeSkinnedPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_Sampling:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pSamplingRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pSamplingPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_BloomDown:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pSamplingRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pBloomDownPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_BloomUp:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pSamplingRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pBloomUpPSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_Combine:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pCombineRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pCombinePSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-
-	case RenderPSOType_Wire:
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootSignature(m_pDefaultWireRootSignature);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetPipelineState(m_pDefaultWirePSO);
-		m_ppSingleCommandList[*m_pFrameIndex]->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-		m_ppSingleCommandList[*m_pFrameIndex]->OMSetStencilRef(0);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-		m_ppSingleCommandList[*m_pFrameIndex]->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
-		break;
-		break;
-
-	default:
-		__debugbreak();
-		break;
+		// t8 ~ t16
+		m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+		m_pPersistentDescriptorPool->CountWrite(GLOBAL_DESCRIPTOR_TABLE_SIZE);
 	}
+
+	m_DepthOnlyGlobalDescriptorTable = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GlobalDescriptorTable, 1, m_CBVSRVUAVDescriptorSize);
+}
+
+void ResourceManager::SetCommonState(eRenderPSOType psoState)
+{
+	_ASSERT(m_ppSingleCommandList);
+	_ASSERT(m_SingleStateCache.GetCommandList() == m_ppSingleCommandList[*m_pFrameIndex]);
+
+	SetCommonState(0, &m_SingleStateCache, m_pDynamicDescriptorPool, psoState);
 }
 
-void ResourceManager::SetCommonState(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, int psoState)
+void ResourceManager::SetCommonState(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, int psoState)
 {
-	_ASSERT(pCommandList);
+	_ASSERT(pStateCache);
 	_ASSERT(pDescriptorPool);
 
-	HRESULT hr = S_OK;
 	const float BLEND_FECTOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
 
-	// set dynamic descriptor heap. (for commont resource)
-	// DynamicDescriptorPool* pDescriptorPool = *(m_ppppDynamicDescriptorPools[*m_pFrameIndex][threadIndex]);
-	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescriptorTable({ 0xffffffffffffffff, });
-	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable({ 0xffffffffffffffff, });
+	// global tables are written once in InitGlobalDescriptorTables().
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuDescriptorTable = { 0xffffffffffffffff, };
 
 	switch (psoState)
 	{
@@ -738,72 +399,20 @@ void ResourceManager::SetCommonState(UINT threadIndex, ID3D12GraphicsCommandList
 		case RenderPSOType_BloomUp:
 		case RenderPSOType_Combine:
 		case RenderPSOType_Wire:
-		{
-			hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 11);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-
-			// b0
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-			cbvHandle.Offset(2, m_CBVSRVUAVDescriptorSize);
-
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+			gpuDescriptorTable = m_GlobalDescriptorTable;
+			break;
 
 		case RenderPSOType_ReflectionDefault:
 		case RenderPSOType_ReflectionSkinned:
 		case RenderPSOType_ReflectionSkybox:
-		{
-			hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 11);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset + 1, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-
-			// b0
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-			cbvHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+			gpuDescriptorTable = m_ReflectionGlobalDescriptorTable;
+			break;
 
 		case RenderPSOType_StencilMask:
 		case RenderPSOType_DepthOnlyDefault:
 		case RenderPSOType_DepthOnlySkinned:
-		{
-			hr = pDescriptorPool->AllocDescriptorTable(&cpuDescriptorTable, &gpuDescriptorTable, 10);
-			BREAK_IF_FAILED(hr);
-
-			CD3DX12_CPU_DESCRIPTOR_HANDLE dstHandle(cpuDescriptorTable, 0, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE cbvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalConstantViewStartOffset + 2, m_CBVSRVUAVDescriptorSize);
-			CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_pCBVSRVUAVHeap->GetCPUDescriptorHandleForHeapStart(), m_GlobalShaderResourceViewStartOffset, m_CBVSRVUAVDescriptorSize);
-
-			// b1
-			m_pDevice->CopyDescriptorsSimple(1, dstHandle, cbvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-			dstHandle.Offset(1, m_CBVSRVUAVDescriptorSize);
-
-			// t8 ~ t16
-			m_pDevice->CopyDescriptorsSimple(9, dstHandle, srvHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		}
-		break;
+			gpuDescriptorTable = m_DepthOnlyGlobalDescriptorTable;
+			break;
 
 		default:
 			break;
@@ -813,176 +422,176 @@ void ResourceManager::SetCommonState(UINT threadIndex, ID3D12GraphicsCommandList
 	switch (psoState)
 	{
 		case RenderPSOType_Default:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultRootSignature);
-			pCommandList->SetPipelineState(m_pDefaultSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultRootSignature);
+			pStateCache->SetPipelineState(m_pDefaultSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_Skinned:
-			pCommandList->SetGraphicsRootSignature(m_pSkinnedRootSignature);
-			pCommandList->SetPipelineState(m_pSkinnedSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pSkinnedRootSignature);
+			pStateCache->SetPipelineState(m_pSkinnedSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_Skybox:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultRootSignature);
-			pCommandList->SetPipelineState(m_pSkyboxSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultRootSignature);
+			pStateCache->SetPipelineState(m_pSkyboxSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_StencilMask:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
-			pCommandList->SetPipelineState(m_pStencilMaskPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(1);
-			pCommandList->SetGraphicsRootConstantBufferView(1, m_pGlobalConstant->GetGPUMemAddr());
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
+			pStateCache->SetPipelineState(m_pStencilMaskPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(1);
+			pStateCache->SetGraphicsRootConstantBufferView(5, m_pGlobalConstant->GetGPUMemAddr());
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_MirrorBlend:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultRootSignature);
-			pCommandList->SetPipelineState(m_pMirrorBlendSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(1);
-			pCommandList->OMSetBlendFactor(BLEND_FECTOR);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultRootSignature);
+			pStateCache->SetPipelineState(m_pMirrorBlendSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(1);
+			pStateCache->OMSetBlendFactor(BLEND_FECTOR);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_ReflectionDefault:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultRootSignature);
-			pCommandList->SetPipelineState(m_pReflectDefaultSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(1);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultRootSignature);
+			pStateCache->SetPipelineState(m_pReflectDefaultSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(1);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_ReflectionSkinned:
-			pCommandList->SetGraphicsRootSignature(m_pSkinnedRootSignature);
-			pCommandList->SetPipelineState(m_pReflectSkinnedSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(1);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pSkinnedRootSignature);
+			pStateCache->SetPipelineState(m_pReflectSkinnedSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(1);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_ReflectionSkybox:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultRootSignature);
-			pCommandList->SetPipelineState(m_pReflectSkyboxSolidPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(1);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultRootSignature);
+			pStateCache->SetPipelineState(m_pReflectSkyboxSolidPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(1);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlyDefault:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlyPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlyPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlySkinned:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlySkinnedRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlySkinnedPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlySkinnedRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlySkinnedPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlyCubeDefault:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlyCubePSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlyCubePSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlyCubeSkinned:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlyCubeSkinnedPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlyCubeSkinnedPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlyCascadeDefault:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlyCascadePSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyAroundRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlyCascadePSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_DepthOnlyCascadeSkinned:
-			pCommandList->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
-			pCommandList->SetPipelineState(m_pDepthOnlyCascadeSkinnedPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(2, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(3, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDepthOnlyAroundSkinnedRootSignature);
+			pStateCache->SetPipelineState(m_pDepthOnlyCascadeSkinnedPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(6, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(7, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_Sampling:
-			pCommandList->SetGraphicsRootSignature(m_pSamplingRootSignature);
-			pCommandList->SetPipelineState(m_pSamplingPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pSamplingRootSignature);
+			pStateCache->SetPipelineState(m_pSamplingPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_BloomDown:
-			pCommandList->SetGraphicsRootSignature(m_pSamplingRootSignature);
-			pCommandList->SetPipelineState(m_pBloomDownPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pSamplingRootSignature);
+			pStateCache->SetPipelineState(m_pBloomDownPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_BloomUp:
-			pCommandList->SetGraphicsRootSignature(m_pSamplingRootSignature);
-			pCommandList->SetPipelineState(m_pBloomUpPSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pSamplingRootSignature);
+			pStateCache->SetPipelineState(m_pBloomUpPSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_Combine:
-			pCommandList->SetGraphicsRootSignature(m_pCombineRootSignature);
-			pCommandList->SetPipelineState(m_pCombinePSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pCombineRootSignature);
+			pStateCache->SetPipelineState(m_pCombinePSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 
 		case RenderPSOType_Wire:
-			pCommandList->SetGraphicsRootSignature(m_pDefaultWireRootSignature);
-			pCommandList->SetPipelineState(m_pDefaultWirePSO);
-			pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
-			pCommandList->OMSetStencilRef(0);
-			pCommandList->SetGraphicsRootDescriptorTable(1, gpuDescriptorTable);
-			pCommandList->SetGraphicsRootDescriptorTable(2, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
+			pStateCache->SetGraphicsRootSignature(m_pDefaultWireRootSignature);
+			pStateCache->SetPipelineState(m_pDefaultWirePSO);
+			pStateCache->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+			pStateCache->OMSetStencilRef(0);
+			pStateCache->SetGraphicsRootDescriptorTable(5, gpuDescriptorTable);
+			pStateCache->SetGraphicsRootDescriptorTable(6, m_pSamplerHeap->GetGPUDescriptorHandleForHeapStart());
 			break;
 			break;
 
@@ -990,6 +599,14 @@ void ResourceManager::SetCommonState(UINT threadIndex, ID3D12GraphicsCommandList
 			__debugbreak();
 			break;
 	}
+
+	// root signatures above except post processing ones start with eMeshRootParameter. bindless range is same for every draw.
+	if (usesMeshRootSignature(psoState))
+	{
+		const D3D12_GPU_DESCRIPTOR_HANDLE BINDLESS_TABLE = m_pBindlessDescriptorPool->GetGPUDescriptorHandle();
+		pStateCache->SetGraphicsRootDescriptorTable(MeshRootParameter_BindlessTextures, BINDLESS_TABLE);
+		pStateCache->SetGraphicsRootDescriptorTable(MeshRootParameter_BindlessBuffers, BINDLESS_TABLE);
+	}
 }
 
 void ResourceManager::initSamplers()
@@ -1256,20 +873,31 @@ void ResourceManager::initPipelineStates()
 	commonResourceRanges[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 4, 13); // t13 ~ t16
 	commonResourceRanges[4].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, 8, 0); // s0 ~ s7
 
+	// both arrays cover whole bindless range, see BindlessDescriptorPool.
+	CD3DX12_DESCRIPTOR_RANGE bindlessResourceRanges[2];
+	bindlessResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, BINDLESS_DESCRIPTOR_COUNT, 0, 1); // t0, space1. textures.
+	bindlessResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, BINDLESS_DESCRIPTOR_COUNT, 0, 2); // t0, space2. bone buffers.
+
+	// prefix of every mesh root signature, see eMeshRootParameter.
+	CD3DX12_ROOT_PARAMETER meshRootParameters[MeshRootParameter_Count];
+	meshRootParameters[MeshRootParameter_MeshConstant].InitAsConstantBufferView(2, 0, D3D12_SHADER_VISIBILITY_ALL); // b2
+	meshRootParameters[MeshRootParameter_MaterialConstant].InitAsConstantBufferView(3, 0, D3D12_SHADER_VISIBILITY_ALL); // b3
+	meshRootParameters[MeshRootParameter_BindlessIndices].InitAsConstants(BINDLESS_INDEX_RECORD_SIZE, 5, 0, D3D12_SHADER_VISIBILITY_ALL); // b5
+	meshRootParameters[MeshRootParameter_BindlessTextures].InitAsDescriptorTable(1, &bindlessResourceRanges[0], D3D12_SHADER_VISIBILITY_ALL);
+	meshRootParameters[MeshRootParameter_BindlessBuffers].InitAsDescriptorTable(1, &bindlessResourceRanges[1], D3D12_SHADER_VISIBILITY_ALL);
+
 	CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
 	ID3DBlob* pSignature = nullptr;
 	ID3DBlob* pError = nullptr;
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perDefaultObjectResourceRanges[3];
-		perDefaultObjectResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-		perDefaultObjectResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 6, 0); // t0 ~ t5
-		perDefaultObjectResourceRanges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 6); // t6
-
-		CD3DX12_ROOT_PARAMETER rootParameters[3];
-		rootParameters[0].InitAsDescriptorTable(3, perDefaultObjectResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[2].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 2];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[6].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1293,18 +921,15 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perSkinnedObjectResourceRanges[4];
-		perSkinnedObjectResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 7); // t7
-		perSkinnedObjectResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-		perSkinnedObjectResourceRanges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 6, 0); // t0 ~ t5
-		perSkinnedObjectResourceRanges[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 6); // t6
-
-		CD3DX12_ROOT_PARAMETER rootParameter[3];
-		rootParameter[0].InitAsDescriptorTable(4, perSkinnedObjectResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameter[1].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameter[2].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 2];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[6].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
-		rootSignatureDesc.Init(_countof(rootParameter), rootParameter, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 		hr = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &pSignature, &pError);
 		if (FAILED(hr))
@@ -1326,14 +951,14 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perDefaultObjectResourceRange[1];
-		perDefaultObjectResourceRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-
-		CD3DX12_ROOT_PARAMETER rootParameters[4];
-		rootParameters[0].InitAsDescriptorTable(1, perDefaultObjectResourceRange, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsConstantBufferView(0, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[2].InitAsDescriptorTable(3, commonResourceRanges + 1, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[3].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 3];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsConstantBufferView(0, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[6].InitAsDescriptorTable(3, commonResourceRanges + 1, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[7].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1357,15 +982,14 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perSkinnedObjectResourceRanges[2];
-		perSkinnedObjectResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 7); // t7
-		perSkinnedObjectResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-		
-		CD3DX12_ROOT_PARAMETER rootParameters[4];
-		rootParameters[0].InitAsDescriptorTable(2, perSkinnedObjectResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsConstantBufferView(0, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[2].InitAsDescriptorTable(3, commonResourceRanges + 1, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[3].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 3];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsConstantBufferView(0, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[6].InitAsDescriptorTable(3, commonResourceRanges + 1, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[7].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1389,14 +1013,14 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perDefaultObjectResourceRange[1];
-		perDefaultObjectResourceRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-
-		CD3DX12_ROOT_PARAMETER rootParameters[4];
-		rootParameters[0].InitAsDescriptorTable(1, perDefaultObjectResourceRange, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsConstantBufferView(4, 0, D3D12_SHADER_VISIBILITY_GEOMETRY);
-		rootParameters[2].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[3].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 3];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsConstantBufferView(4, 0, D3D12_SHADER_VISIBILITY_GEOMETRY);
+		rootParameters[6].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[7].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1420,15 +1044,14 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perSkinnedObjectResourceRanges[2];
-		perSkinnedObjectResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 7); // t7
-		perSkinnedObjectResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-
-		CD3DX12_ROOT_PARAMETER rootParameters[4];
-		rootParameters[0].InitAsDescriptorTable(2, perSkinnedObjectResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsConstantBufferView(4, 0, D3D12_SHADER_VISIBILITY_GEOMETRY);
-		rootParameters[2].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[3].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 3];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsConstantBufferView(4, 0, D3D12_SHADER_VISIBILITY_GEOMETRY);
+		rootParameters[6].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[7].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1516,14 +1139,13 @@ void ResourceManager::initPipelineStates()
 	}
 
 	{
-		CD3DX12_DESCRIPTOR_RANGE perDefaultObjectResourceRanges[2];
-		perDefaultObjectResourceRanges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 2); // b2, b3
-		perDefaultObjectResourceRanges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 6); // t6. ⼭ ׳  ɷ .
-
-		CD3DX12_ROOT_PARAMETER rootParameters[3];
-		rootParameters[0].InitAsDescriptorTable(2, perDefaultObjectResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[1].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
-		rootParameters[2].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
+		CD3DX12_ROOT_PARAMETER rootParameters[MeshRootParameter_Count + 2];
+		for (UINT i = 0; i < MeshRootParameter_Count; ++i)
+		{
+			rootParameters[i] = meshRootParameters[i];
+		}
+		rootParameters[5].InitAsDescriptorTable(4, commonResourceRanges, D3D12_SHADER_VISIBILITY_ALL);
+		rootParameters[6].InitAsDescriptorTable(1, &commonResourceRanges[4], D3D12_SHADER_VISIBILITY_ALL);
 
 		rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -1621,7 +1243,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutBasicDescs, _countof(m_InputLayoutBasicDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlyDescs, _countof(m_InputLayoutDepthOnlyDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pStencilMaskPSO));
 	BREAK_IF_FAILED(hr);
@@ -1722,7 +1344,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutBasicDescs, _countof(m_InputLayoutBasicDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlyDescs, _countof(m_InputLayoutDepthOnlyDescs) };
 	
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlyPSO));
 	BREAK_IF_FAILED(hr);
@@ -1743,7 +1365,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutSkinnedDescs, _countof(m_InputLayoutSkinnedDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlySkinnedDescs, _countof(m_InputLayoutDepthOnlySkinnedDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlySkinnedPSO));
 	BREAK_IF_FAILED(hr);
@@ -1766,7 +1388,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutBasicDescs, _countof(m_InputLayoutBasicDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlyDescs, _countof(m_InputLayoutDepthOnlyDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlyCubePSO));
 	BREAK_IF_FAILED(hr);
@@ -1789,7 +1411,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutSkinnedDescs, _countof(m_InputLayoutSkinnedDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlySkinnedDescs, _countof(m_InputLayoutDepthOnlySkinnedDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlyCubeSkinnedPSO));
 	BREAK_IF_FAILED(hr);
@@ -1812,7 +1434,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutBasicDescs, _countof(m_InputLayoutBasicDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlyDescs, _countof(m_InputLayoutDepthOnlyDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlyCascadePSO));
 	BREAK_IF_FAILED(hr);
@@ -1835,7 +1457,7 @@ void ResourceManager::initPipelineStates()
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
 	psoDesc.SampleDesc.Quality = 0;
-	psoDesc.InputLayout = { m_InputLayoutSkinnedDescs, _countof(m_InputLayoutSkinnedDescs) };
+	psoDesc.InputLayout = { m_InputLayoutDepthOnlySkinnedDescs, _countof(m_InputLayoutDepthOnlySkinnedDescs) };
 
 	hr = m_pDevice->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pDepthOnlyCascadeSkinnedPSO));
 	BREAK_IF_FAILED(hr);
@@ -1949,68 +1571,139 @@ void ResourceManager::initShaders()
 {
 	HRESULT hr = S_OK;
 
+#ifdef USE_COMPACT_VERTEX
+	// CompactVertex, CompactSkinnedVertex.
+	D3D12_INPUT_ELEMENT_DESC basicDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	D3D12_INPUT_ELEMENT_DESC skinncedDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 20, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 1, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 1, DXGI_FORMAT_R8G8B8A8_UINT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	D3D12_INPUT_ELEMENT_DESC skyboxDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	// CompactDepthOnlyVertex, CompactDepthOnlySkinnedVertex.
+	D3D12_INPUT_ELEMENT_DESC depthOnlyDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	D3D12_INPUT_ELEMENT_DESC depthOnlySkinnedDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 1, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 1, DXGI_FORMAT_R8G8B8A8_UINT, 0, 20, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+#else
 	D3D12_INPUT_ELEMENT_DESC basicDescs[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 	};
 	D3D12_INPUT_ELEMENT_DESC skinncedDescs[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 44, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"BLENDWEIGHT", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 60, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 76, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"BLENDINDICES", 1, DXGI_FORMAT_R8G8B8A8_UINT, 0, 80, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 64, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 80, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 1, DXGI_FORMAT_R8G8B8A8_UINT, 0, 84, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 	};
 	D3D12_INPUT_ELEMENT_DESC skyboxDescs[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-		{"TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 	};
+
+	// DepthOnlyVertex, DepthOnlySkinnedVertex.
+	D3D12_INPUT_ELEMENT_DESC depthOnlyDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	D3D12_INPUT_ELEMENT_DESC depthOnlySkinnedDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDWEIGHT", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 28, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, 44, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+		{"BLENDINDICES", 1, DXGI_FORMAT_R8G8B8A8_UINT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+#endif
 	D3D12_INPUT_ELEMENT_DESC samplingDescs[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
 	};
+#ifdef USE_COMPACT_VERTEX
+	const D3D_SHADER_MACRO pVERTEX_MACRO[] =
+	{
+		{"COMPACT_VERTEX", "1"}, { NULL, NULL }
+	};
+	const D3D_SHADER_MACRO pSKINNED_MACRO[] =
+	{
+		{"SKINNED", "1"}, {"COMPACT_VERTEX", "1"}, { NULL, NULL }
+	};
+#else
+	const D3D_SHADER_MACRO* pVERTEX_MACRO = nullptr;
 	const D3D_SHADER_MACRO pSKINNED_MACRO[] =
 	{
 		{"SKINNED", "1"}, { NULL, NULL }
 	};
+#endif
 	memcpy(m_InputLayoutBasicDescs, basicDescs, sizeof(basicDescs));
 	memcpy(m_InputLayoutSkinnedDescs, skinncedDescs, sizeof(skinncedDescs));
 	memcpy(m_InputLayoutSkyboxDescs, skyboxDescs, sizeof(skyboxDescs));
 	memcpy(m_InputLayoutSamplingDescs, samplingDescs, sizeof(samplingDescs));
+	memcpy(m_InputLayoutDepthOnlyDescs, depthOnlyDescs, sizeof(depthOnlyDescs));
+	memcpy(m_InputLayoutDepthOnlySkinnedDescs, depthOnlySkinnedDescs, sizeof(depthOnlySkinnedDescs));
 
-	hr = CompileShader(L"./Shaders/BasicVS.hlsl", "vs_5_1", nullptr, &m_pBasicVS);
+	hr = CompileShader(L"./Shaders/BasicVS.hlsl", "vs_5_1", pVERTEX_MACRO, &m_pBasicVS);
 	BREAK_IF_FAILED(hr);
 
 	hr = CompileShader(L"./Shaders/BasicVS.hlsl", "vs_5_1", pSKINNED_MACRO, &m_pSkinnedVS);
 	BREAK_IF_FAILED(hr);
 
-	hr = CompileShader(L"./Shaders/SkyboxVS.hlsl", "vs_5_1", nullptr, &m_pSkyboxVS);
+	hr = CompileShader(L"./Shaders/SkyboxVS.hlsl", "vs_5_1", pVERTEX_MACRO, &m_pSkyboxVS);
 	BREAK_IF_FAILED(hr);
 
-	hr = CompileShader(L"./Shaders/DepthOnlyVS.hlsl", "vs_5_1", nullptr, &m_pDepthOnlyVS);
+	hr = CompileShader(L"./Shaders/DepthOnlyVS.hlsl", "vs_5_1", pVERTEX_MACRO, &m_pDepthOnlyVS);
 	BREAK_IF_FAILED(hr);
 
 	hr = CompileShader(L"./Shaders/DepthOnlyVS.hlsl", "vs_5_1", pSKINNED_MACRO, &m_pDepthOnlySkinnedVS);
 	BREAK_IF_FAILED(hr);
 
-	hr = CompileShader(L"./Shaders/DepthOnlyCubeVS.hlsl", "vs_5_1", nullptr, &m_pDepthOnlyCubeVS);
+	hr = CompileShader(L"./Shaders/DepthOnlyCubeVS.hlsl", "vs_5_1", pVERTEX_MACRO, &m_pDepthOnlyCubeVS);
 	BREAK_IF_FAILED(hr);
 
 	hr = CompileShader(L"./Shaders/DepthOnlyCubeVS.hlsl", "vs_5_1", pSKINNED_MACRO, &m_pDepthOnlyCubeSkinnedVS);
 	BREAK_IF_FAILED(hr);
 
-	hr = CompileShader(L"./Shaders/DepthOnlyCascadeVS.hlsl", "vs_5_1", nullptr, &m_pDepthOnlyCascadeVS);
+	hr = CompileShader(L"./Shaders/DepthOnlyCascadeVS.hlsl", "vs_5_1", pVERTEX_MACRO, &m_pDepthOnlyCascadeVS);
 	BREAK_IF_FAILED(hr);
 
 	hr = CompileShader(L"./Shaders/DepthOnlyCascadeVS.hlsl", "vs_5_1", pSKINNED_MACRO, &m_pDepthOnlyCascadeSkinnedVS);
@@ -2056,6 +1749,21 @@ void ResourceManager::initShaders()
 	BREAK_IF_FAILED(hr);
 }
 
+bool ResourceManager::usesMeshRootSignature(int psoState)
+{
+	switch (psoState)
+	{
+		case RenderPSOType_Sampling:
+		case RenderPSOType_BloomDown:
+		case RenderPSOType_BloomUp:
+		case RenderPSOType_Combine:
+			return false;
+
+		default:
+			return true;
+	}
+}
+
 UINT64 ResourceManager::fence()
 {
 	++(*m_pFenceValue);
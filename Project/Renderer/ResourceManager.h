@@ -4,14 +4,25 @@
 #include "../Graphics/ConstantBuffer.h"
 #include "CommandListPool.h"
 #include "DynamicDescriptorPool.h"
+#include "PersistentDescriptorPool.h"
+#include "BindlessDescriptorPool.h"
 #include "RenderQueue.h"
 #include "../Graphics/Texture.h"
+#include "FrameConstantAllocator.h"
+#include "GPUBufferPool.h"
+#include "UploadBatch.h"
 
 class ConstantBuffer;
 
 static const UINT SWAP_CHAIN_FRAME_COUNT = 2;
 static const UINT MAX_RENDER_THREAD_COUNT = 6;
 static const UINT MAX_DESCRIPTOR_NUM = 1024;
+static const UINT DYNAMIC_DESCRIPTOR_COUNT = 1024; // single thread. pages kept by its pool.
+static const UINT THREAD_DYNAMIC_DESCRIPTOR_COUNT = 4096 * 9; // per render thread and frame. sizes shared page region.
+static const UINT THREAD_DYNAMIC_DESCRIPTOR_INITIAL_PAGE_COUNT = 4; // pages kept by each render thread pool.
+static const UINT DYNAMIC_DESCRIPTOR_TABLE_CACHE_COUNT = 16; // cached tables per dynamic pool, in page of its own.
+static const UINT GLOBAL_DESCRIPTOR_TABLE_COUNT = 2; // default, reflection.
+static const UINT GLOBAL_DESCRIPTOR_TABLE_SIZE = 11; // b0, b1, t8 ~ t16.
 
 class ResourceManager
 {
@@ -23,6 +34,8 @@ public:
 		ID3D12CommandAllocator** ppCommandAllocator;
 		ID3D12GraphicsCommandList** ppCommandList;
 		DynamicDescriptorPool* pDynamicDescriptorPool;
+		PersistentDescriptorPool* pPersistentDescriptorPool;
+		BindlessDescriptorPool* pBindlessDescriptorPool;
 
 		HANDLE hFenceEvent;
 		ID3D12Fence* pFence;
@@ -40,18 +53,36 @@ public:
 	void InitDSVDescriptorHeap(UINT maxDescriptorNum);
 	void InitCBVSRVUAVDescriptorHeap(UINT maxDescriptorNum);
 
-	HRESULT CreateVertexBuffer(UINT sizePerVertex, UINT numVertex, D3D12_VERTEX_BUFFER_VIEW* pOutVertexBufferView, ID3D12Resource** ppOutBuffer, void* pInitData);
-	HRESULT CreateIndexBuffer(UINT sizePerIndex, UINT numIndex, D3D12_INDEX_BUFFER_VIEW* pOutIndexBufferView, ID3D12Resource** ppOutBuffer, void* pInitData);
+	// buffers are ranges of default pool. free with pOutAllocation->pPool->Free().
+	HRESULT CreateVertexBuffer(UINT sizePerVertex, UINT numVertex, D3D12_VERTEX_BUFFER_VIEW* pOutVertexBufferView, GPUBufferAllocation* pOutAllocation, void* pInitData);
+	HRESULT CreateIndexBuffer(UINT sizePerIndex, UINT numIndex, D3D12_INDEX_BUFFER_VIEW* pOutIndexBufferView, GPUBufferAllocation* pOutAllocation, void* pInitData);
 	
-	HRESULT UpdateTexture(ID3D12Resource* pDestResource, ID3D12Resource* pSrcResource, D3D12_RESOURCE_STATES* originalState);
+	// pIMAGE holds all subresources packed tightly, level 0 first.
+	HRESULT UploadTexture(ID3D12Resource* pDestResource, const UCHAR* pIMAGE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE);
+
+	// Main thread. uploads between BeginUpload() and EndUpload() go to GPU in one submission. nestable.
+	// uploads outside of them are submitted one by one. neither waits for GPU.
+	void BeginUpload();
+	void EndUpload();
 
 	void Cleanup();
 
 	inline ID3D12GraphicsCommandList* GetCommandList() { return m_ppSingleCommandList[*m_pFrameIndex]; }
+	// reset with single command list each frame.
+	inline CommandStateCache* GetSingleStateCache() { return &m_SingleStateCache; }
+	inline const UploadStats& GetUploadStats() { return m_UploadBatch.GetStats(); }
+	inline GPUBufferPool* GetDefaultBufferPool() { return &m_DefaultBufferPool; }
+	inline GPUBufferPool* GetUploadBufferPool() { return &m_UploadBufferPool; }
+	inline FrameConstantAllocator* GetFrameConstantAllocator() { return &m_FrameConstantAllocator; }
+	inline BindlessDescriptorPool* GetBindlessDescriptorPool() { return m_pBindlessDescriptorPool; }
 
 	void SetGlobalConstants(ConstantBuffer* pGlobal, ConstantBuffer* pLight, ConstantBuffer* pReflection);
+	// after global views are written at m_GlobalConstantViewStartOffset and m_GlobalShaderResourceViewStartOffset.
+	void InitGlobalDescriptorTables();
+	// single command list, through m_SingleStateCache.
 	void SetCommonState(eRenderPSOType psoState);
-	void SetCommonState(UINT threadIndex, ID3D12GraphicsCommandList* pCommandList, DynamicDescriptorPool* pDescriptorPool, int psoState);
+	// calls setting state already bound on command list are dropped by pStateCache.
+	void SetCommonState(UINT threadIndex, CommandStateCache* pStateCache, DynamicDescriptorPool* pDescriptorPool, int psoState);
 
 protected:
 	void initSamplers();
@@ -61,6 +92,9 @@ protected:
 	void initPipelineStates();
 	void initShaders();
 
+	// every pso except post processing ones has root signature starting with eMeshRootParameter.
+	bool usesMeshRootSignature(int psoState);
+
 	UINT64 fence();
 	void waitForGPU(UINT64 expectedFenceValue);
 
@@ -75,6 +109,8 @@ public:
 	ID3D12DescriptorHeap* m_pCBVSRVUAVHeap = nullptr;
 	ID3D12DescriptorHeap* m_pSamplerHeap = nullptr;
 	DynamicDescriptorPool* m_pDynamicDescriptorPool = nullptr;
+	PersistentDescriptorPool* m_pPersistentDescriptorPool = nullptr;
+	BindlessDescriptorPool* m_pBindlessDescriptorPool = nullptr;
 
 	UINT* m_pFrameIndex = nullptr;
 
@@ -92,12 +128,31 @@ public:
 	UINT m_GlobalConstantViewStartOffset = 0xffffffff; // b0, b1
 	UINT m_GlobalShaderResourceViewStartOffset = 0xffffffff; // t8 ~ t16
 
+	// root param 1 tables written once in persistent pool. [b0, b1(light), t8 ~ t16]
+	// depth only layout [b1(light), t8 ~ t16] is default table from its second descriptor.
+	D3D12_GPU_DESCRIPTOR_HANDLE m_GlobalDescriptorTable = { 0xffffffffffffffff, };
+	D3D12_GPU_DESCRIPTOR_HANDLE m_ReflectionGlobalDescriptorTable = { 0xffffffffffffffff, };
+	D3D12_GPU_DESCRIPTOR_HANDLE m_DepthOnlyGlobalDescriptorTable = { 0xffffffffffffffff, };
+
 private:
 	HANDLE m_hFenceEvent = nullptr;
 	ID3D12Fence* m_pFence = nullptr;
 	UINT64* m_pFenceValue = nullptr;
 	UINT64* m_pFenceValues = nullptr;
 
+	UploadBatch m_UploadBatch;
+	UINT m_UploadDepth = 0;
+
+	// state on single command list. filters SetCommonState(eRenderPSOType) calls.
+	CommandStateCache m_SingleStateCache;
+
+	// vertex, index buffers / constant, structured buffers.
+	GPUBufferPool m_DefaultBufferPool;
+	GPUBufferPool m_UploadBufferPool;
+
+	// per frame mesh constants.
+	FrameConstantAllocator m_FrameConstantAllocator;
+
 	// root signature.
 	ID3D12RootSignature* m_pDefaultRootSignature = nullptr;
 	ID3D12RootSignature* m_pSkinnedRootSignature = nullptr;
@@ -150,6 +205,8 @@ private:
 	D3D12_INPUT_ELEMENT_DESC m_InputLayoutSkinnedDescs[8] = {};
 	D3D12_INPUT_ELEMENT_DESC m_InputLayoutSkyboxDescs[4] = {};
 	D3D12_INPUT_ELEMENT_DESC m_InputLayoutSamplingDescs[3] = {};
+	D3D12_INPUT_ELEMENT_DESC m_InputLayoutDepthOnlyDescs[1] = {};
+	D3D12_INPUT_ELEMENT_DESC m_InputLayoutDepthOnlySkinnedDescs[5] = {};
 
 	// shaders.
 	ID3DBlob* m_pBasicVS = nullptr;
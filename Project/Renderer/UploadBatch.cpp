@@ -0,0 +1,525 @@
+#include "../pch.h"
+#include "UploadBatch.h"
+
+static void releaseDedicatedBuffer(void* pArg)
+{
+	ID3D12Resource* pBuffer = (ID3D12Resource*)pArg;
+	pBuffer->Release();
+}
+
+void StagingRing::Initialize(const UINT64 SIZE)
+{
+	_ASSERT(SIZE > 0);
+
+	Reset();
+	m_Size = SIZE;
+}
+
+UINT64 StagingRing::Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT)
+{
+	_ASSERT(SIZE > 0 && SIZE <= m_Size);
+	_ASSERT(ALIGNMENT > 0 && (ALIGNMENT & (ALIGNMENT - 1)) == 0);
+
+	// start over from front when everything is free, keeps allocations contiguous.
+	if (m_UsedSize == 0)
+	{
+		m_Head = 0;
+		m_Tail = 0;
+	}
+
+	UINT64 offset = (m_Head + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	bool bWrapped = false;
+
+	if (m_Head >= m_Tail && m_UsedSize < m_Size)
+	{
+		// free space is [head, size) and [0, tail).
+		if (offset + SIZE > m_Size)
+		{
+			if (SIZE > m_Tail)
+			{
+				return UINT64_MAX;
+			}
+			offset = 0;
+			bWrapped = true;
+		}
+	}
+	else if (offset + SIZE > m_Tail)
+	{
+		// free space is [head, tail), or none.
+		return UINT64_MAX;
+	}
+
+	const UINT64 END = offset + SIZE;
+	const UINT64 CONSUMED_SIZE = (bWrapped ? (m_Size - m_Head) + END : END - m_Head);
+	m_Head = END;
+	m_UsedSize += CONSUMED_SIZE;
+	m_OpenSize += CONSUMED_SIZE;
+
+	return offset;
+}
+
+bool StagingRing::CloseBatch(const UINT64 FENCE_VALUE)
+{
+	if (m_OpenSize == 0)
+	{
+		return true;
+	}
+	if (m_BatchCount == MAX_PENDING_UPLOAD_BATCH_COUNT)
+	{
+		return false;
+	}
+
+	Batch* pBatch = &m_pBatches[(m_BatchHead + m_BatchCount) % MAX_PENDING_UPLOAD_BATCH_COUNT];
+	pBatch->FenceValue = FENCE_VALUE;
+	pBatch->End = m_Head;
+	pBatch->Size = m_OpenSize;
+	++m_BatchCount;
+	m_OpenSize = 0;
+
+	return true;
+}
+
+void StagingRing::Retire(const UINT64 COMPLETED_FENCE_VALUE)
+{
+	while (m_BatchCount > 0 && m_pBatches[m_BatchHead].FenceValue <= COMPLETED_FENCE_VALUE)
+	{
+		const Batch& BATCH = m_pBatches[m_BatchHead];
+		m_Tail = BATCH.End;
+		m_UsedSize -= BATCH.Size;
+
+		m_BatchHead = (m_BatchHead + 1) % MAX_PENDING_UPLOAD_BATCH_COUNT;
+		--m_BatchCount;
+	}
+}
+
+void StagingRing::Reset()
+{
+	m_Head = 0;
+	m_Tail = 0;
+	m_UsedSize = 0;
+	m_OpenSize = 0;
+	m_BatchHead = 0;
+	m_BatchCount = 0;
+}
+
+
+void UploadBatch::Initialize(ID3D12Device5* pDevice, ID3D12CommandQueue* pCommandQueue, ID3D12Fence* pFence, HANDLE hFenceEvent, UINT64* pFenceValue, const UINT64 STAGING_SIZE)
+{
+	_ASSERT(pDevice);
+	_ASSERT(pCommandQueue);
+	_ASSERT(pFence);
+	_ASSERT(pFenceValue);
+
+	HRESULT hr = S_OK;
+
+	m_pDevice = pDevice;
+	m_pCommandQueue = pCommandQueue;
+	m_pFence = pFence;
+	m_hFenceEvent = hFenceEvent;
+	m_pFenceValue = pFenceValue;
+
+	CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(STAGING_SIZE);
+	hr = m_pDevice->CreateCommittedResource(&heapProps,
+											D3D12_HEAP_FLAG_NONE,
+											&resourceDesc,
+											D3D12_RESOURCE_STATE_GENERIC_READ,
+											nullptr,
+											IID_PPV_ARGS(&m_pStagingBuffer));
+	BREAK_IF_FAILED(hr);
+	m_pStagingBuffer->SetName(L"StagingRing");
+
+	// stays mapped for whole lifetime.
+	CD3DX12_RANGE readRange(0, 0);
+	hr = m_pStagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_pStagingMappedPtr));
+	BREAK_IF_FAILED(hr);
+
+	m_StagingRing.Initialize(STAGING_SIZE);
+
+	for (UINT i = 0; i < UPLOAD_COMMAND_ALLOCATOR_COUNT; ++i)
+	{
+		hr = m_pDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_ppCommandAllocators[i]));
+		BREAK_IF_FAILED(hr);
+		m_ppCommandAllocators[i]->SetName(L"UploadCommandAllocator");
+		m_pAllocatorFenceValues[i] = 0;
+	}
+
+	hr = m_pDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_ppCommandAllocators[0], nullptr, IID_PPV_ARGS(&m_pCommandList));
+	BREAK_IF_FAILED(hr);
+	m_pCommandList->SetName(L"UploadCommandList");
+	m_pCommandList->Close();
+}
+
+HRESULT UploadBatch::UploadBuffer(ID3D12Resource* pDestResource, const UINT64 DEST_OFFSET, const void* pDATA, const UINT64 SIZE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE)
+{
+	_ASSERT(pDestResource);
+	_ASSERT(pDATA);
+	_ASSERT(SIZE > 0);
+
+	HRESULT hr = S_OK;
+	ID3D12Resource* pSrcResource = nullptr;
+	UINT64 srcOffset = 0;
+	UCHAR* pMappedPtr = nullptr;
+
+	// may submit current batch, so nothing of this upload is recorded before.
+	hr = allocateStaging(SIZE, 16, &pSrcResource, &srcOffset, &pMappedPtr);
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	hr = beginRecording();
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	memcpy(pMappedPtr, pDATA, SIZE);
+
+	const bool bIMPLICIT_TRANSITION = (BEFORE_STATE == D3D12_RESOURCE_STATE_COMMON && AFTER_STATE == D3D12_RESOURCE_STATE_COMMON);
+	if (!bIMPLICIT_TRANSITION && BEFORE_STATE != D3D12_RESOURCE_STATE_COPY_DEST)
+	{
+		const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, BEFORE_STATE, D3D12_RESOURCE_STATE_COPY_DEST);
+		m_pCommandList->ResourceBarrier(1, &BEFORE_BARRIER);
+	}
+	m_pCommandList->CopyBufferRegion(pDestResource, DEST_OFFSET, pSrcResource, srcOffset, SIZE);
+	if (!bIMPLICIT_TRANSITION && AFTER_STATE != D3D12_RESOURCE_STATE_COPY_DEST)
+	{
+		m_PendingBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, D3D12_RESOURCE_STATE_COPY_DEST, AFTER_STATE));
+	}
+
+	++m_Stats.UploadCount;
+	m_Stats.UploadedBytes += SIZE;
+
+	return hr;
+}
+
+HRESULT UploadBatch::UploadTexture(ID3D12Resource* pDestResource, const UCHAR* pIMAGE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE)
+{
+	_ASSERT(pDestResource);
+	_ASSERT(pIMAGE);
+
+	const UINT MAX_SUB_RESOURCE_NUM = 32;
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT footPrints[MAX_SUB_RESOURCE_NUM] = {};
+	UINT rows[MAX_SUB_RESOURCE_NUM] = {};
+	UINT64 rowSizes[MAX_SUB_RESOURCE_NUM] = {};
+	UINT64 totalBytes = 0;
+
+	HRESULT hr = S_OK;
+	ID3D12Resource* pSrcResource = nullptr;
+	UINT64 srcOffset = 0;
+	UCHAR* pMappedPtr = nullptr;
+
+	const D3D12_RESOURCE_DESC DESC = pDestResource->GetDesc();
+	const UINT NUM_SUBRESOURCES = DESC.DepthOrArraySize * DESC.MipLevels;
+	if (NUM_SUBRESOURCES > MAX_SUB_RESOURCE_NUM)
+	{
+		__debugbreak();
+		return E_INVALIDARG;
+	}
+
+	m_pDevice->GetCopyableFootprints(&DESC, 0, NUM_SUBRESOURCES, 0, footPrints, rows, rowSizes, &totalBytes);
+
+	hr = allocateStaging(totalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, &pSrcResource, &srcOffset, &pMappedPtr);
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	hr = beginRecording();
+	if (FAILED(hr))
+	{
+		return hr;
+	}
+
+	if (BEFORE_STATE != D3D12_RESOURCE_STATE_COPY_DEST)
+	{
+		const CD3DX12_RESOURCE_BARRIER BEFORE_BARRIER = CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, BEFORE_STATE, D3D12_RESOURCE_STATE_COPY_DEST);
+		m_pCommandList->ResourceBarrier(1, &BEFORE_BARRIER);
+	}
+
+	// source levels are tightly packed, staging rows are pitched.
+	const UCHAR* pSrc = pIMAGE;
+	for (UINT i = 0; i < NUM_SUBRESOURCES; ++i)
+	{
+		UCHAR* pDest = pMappedPtr + footPrints[i].Offset;
+		for (UINT row = 0; row < rows[i]; ++row)
+		{
+			memcpy(pDest, pSrc, rowSizes[i]);
+			pSrc += rowSizes[i];
+			pDest += footPrints[i].Footprint.RowPitch;
+		}
+
+		D3D12_TEXTURE_COPY_LOCATION destLocation = {};
+		destLocation.pResource = pDestResource;
+		destLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+		destLocation.SubresourceIndex = i;
+
+		D3D12_TEXTURE_COPY_LOCATION srcLocation = {};
+		srcLocation.pResource = pSrcResource;
+		srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+		srcLocation.PlacedFootprint = footPrints[i];
+		srcLocation.PlacedFootprint.Offset += srcOffset;
+
+		m_pCommandList->CopyTextureRegion(&destLocation, 0, 0, 0, &srcLocation, nullptr);
+	}
+
+	if (AFTER_STATE != D3D12_RESOURCE_STATE_COPY_DEST)
+	{
+		m_PendingBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(pDestResource, D3D12_RESOURCE_STATE_COPY_DEST, AFTER_STATE));
+	}
+
+	++m_Stats.UploadCount;
+	m_Stats.UploadedBytes += totalBytes;
+
+	return hr;
+}
+
+void UploadBatch::AddCompletion(UploadCompleteFunc pfnComplete, void* pArg)
+{
+	_ASSERT(pfnComplete);
+
+	// nothing in flight to wait for.
+	if (!m_bRecording && m_pFence->GetCompletedValue() >= m_LastSubmittedFenceValue)
+	{
+		pfnComplete(pArg);
+		return;
+	}
+
+	Completion completion;
+	completion.FenceValue = (m_bRecording ? 0 : m_LastSubmittedFenceValue);
+	completion.pfnComplete = pfnComplete;
+	completion.pArg = pArg;
+	m_Completions.push_back(completion);
+}
+
+UINT64 UploadBatch::Submit()
+{
+	if (!m_bRecording)
+	{
+		return m_LastSubmittedFenceValue;
+	}
+
+	flushBarriers();
+	m_pCommandList->Close();
+
+	ID3D12CommandList* ppCommandLists[] = { m_pCommandList };
+	m_pCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+	++(*m_pFenceValue);
+	const UINT64 FENCE_VALUE = *m_pFenceValue;
+	m_pCommandQueue->Signal(m_pFence, FENCE_VALUE);
+
+	m_pAllocatorFenceValues[m_AllocatorIndex] = FENCE_VALUE;
+	m_AllocatorIndex = (m_AllocatorIndex + 1) % UPLOAD_COMMAND_ALLOCATOR_COUNT;
+
+	while (!m_StagingRing.CloseBatch(FENCE_VALUE))
+	{
+		++m_Stats.StallCount;
+		waitForFenceValue(m_StagingRing.GetOldestFenceValue());
+		Retire();
+	}
+
+	for (UINT64 i = 0, size = m_Completions.size(); i < size; ++i)
+	{
+		if (m_Completions[i].FenceValue == 0)
+		{
+			m_Completions[i].FenceValue = FENCE_VALUE;
+		}
+	}
+
+	m_LastSubmittedFenceValue = FENCE_VALUE;
+	m_bRecording = false;
+	++m_Stats.SubmitCount;
+
+	return FENCE_VALUE;
+}
+
+void UploadBatch::Retire()
+{
+	if (!m_pFence)
+	{
+		return;
+	}
+
+	const UINT64 COMPLETED_FENCE_VALUE = m_pFence->GetCompletedValue();
+	m_StagingRing.Retire(COMPLETED_FENCE_VALUE);
+
+	// stamped in submit order, open ones are at back.
+	UINT64 completedCount = 0;
+	for (UINT64 size = m_Completions.size(); completedCount < size; ++completedCount)
+	{
+		const Completion& COMPLETION = m_Completions[completedCount];
+		if (COMPLETION.FenceValue == 0 || COMPLETION.FenceValue > COMPLETED_FENCE_VALUE)
+		{
+			break;
+		}
+		COMPLETION.pfnComplete(COMPLETION.pArg);
+	}
+	m_Completions.erase(m_Completions.begin(), m_Completions.begin() + completedCount);
+}
+
+void UploadBatch::WaitForIdle()
+{
+	waitForFenceValue(m_LastSubmittedFenceValue);
+	Retire();
+}
+
+void UploadBatch::Cleanup()
+{
+	if (m_bRecording)
+	{
+		// resources recorded here may be gone already, drop them.
+		m_pCommandList->Close();
+		m_PendingBarriers.clear();
+		m_bRecording = false;
+	}
+	if (m_pFence)
+	{
+		WaitForIdle();
+	}
+
+	// left ones belong to dropped batch. GPU is idle, so run them now.
+	for (UINT64 i = 0, size = m_Completions.size(); i < size; ++i)
+	{
+		m_Completions[i].pfnComplete(m_Completions[i].pArg);
+	}
+	m_Completions.clear();
+
+	m_StagingRing.Reset();
+	m_LastSubmittedFenceValue = 0;
+	m_AllocatorIndex = 0;
+
+	SAFE_RELEASE(m_pCommandList);
+	for (UINT i = 0; i < UPLOAD_COMMAND_ALLOCATOR_COUNT; ++i)
+	{
+		SAFE_RELEASE(m_ppCommandAllocators[i]);
+		m_pAllocatorFenceValues[i] = 0;
+	}
+	if (m_pStagingBuffer)
+	{
+		m_pStagingBuffer->Unmap(0, nullptr);
+		m_pStagingMappedPtr = nullptr;
+		SAFE_RELEASE(m_pStagingBuffer);
+	}
+
+	m_pFenceValue = nullptr;
+	m_hFenceEvent = nullptr;
+	m_pFence = nullptr;
+	m_pCommandQueue = nullptr;
+	m_pDevice = nullptr;
+}
+
+HRESULT UploadBatch::beginRecording()
+{
+	if (m_bRecording)
+	{
+		return S_OK;
+	}
+
+	HRESULT hr = S_OK;
+	ID3D12CommandAllocator* pCommandAllocator = m_ppCommandAllocators[m_AllocatorIndex];
+
+	if (m_pFence->GetCompletedValue() < m_pAllocatorFenceValues[m_AllocatorIndex])
+	{
+		++m_Stats.StallCount;
+		waitForFenceValue(m_pAllocatorFenceValues[m_AllocatorIndex]);
+	}
+
+	hr = pCommandAllocator->Reset();
+	BREAK_IF_FAILED(hr);
+
+	hr = m_pCommandList->Reset(pCommandAllocator, nullptr);
+	BREAK_IF_FAILED(hr);
+
+	m_bRecording = true;
+
+	return hr;
+}
+
+HRESULT UploadBatch::allocateStaging(const UINT64 SIZE, const UINT64 ALIGNMENT, ID3D12Resource** ppResource, UINT64* pOffset, UCHAR** ppMappedPtr)
+{
+	_ASSERT(ppResource);
+	_ASSERT(pOffset);
+	_ASSERT(ppMappedPtr);
+
+	HRESULT hr = S_OK;
+
+	if (SIZE > m_StagingRing.GetSize())
+	{
+		ID3D12Resource* pBuffer = nullptr;
+		UCHAR* pMappedPtr = nullptr;
+
+		CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
+		CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(SIZE);
+		hr = m_pDevice->CreateCommittedResource(&heapProps,
+												D3D12_HEAP_FLAG_NONE,
+												&resourceDesc,
+												D3D12_RESOURCE_STATE_GENERIC_READ,
+												nullptr,
+												IID_PPV_ARGS(&pBuffer));
+		BREAK_IF_FAILED(hr);
+		pBuffer->SetName(L"DedicatedUploadBuffer");
+
+		CD3DX12_RANGE readRange(0, 0);
+		hr = pBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pMappedPtr));
+		BREAK_IF_FAILED(hr);
+
+		// belongs to batch being recorded, released once it completes.
+		hr = beginRecording();
+		if (FAILED(hr))
+		{
+			pBuffer->Release();
+			return hr;
+		}
+		AddCompletion(releaseDedicatedBuffer, pBuffer);
+		++m_Stats.DedicatedCount;
+
+		*ppResource = pBuffer;
+		*pOffset = 0;
+		*ppMappedPtr = pMappedPtr;
+		return hr;
+	}
+
+	Retire();
+
+	UINT64 offset = m_StagingRing.Allocate(SIZE, ALIGNMENT);
+	while (offset == UINT64_MAX)
+	{
+		// ring is full of work in flight. send what is recorded and wait for oldest batch.
+		++m_Stats.StallCount;
+		Submit();
+
+		_ASSERT(m_StagingRing.GetPendingBatchCount() > 0);
+		waitForFenceValue(m_StagingRing.GetOldestFenceValue());
+		Retire();
+
+		offset = m_StagingRing.Allocate(SIZE, ALIGNMENT);
+	}
+
+	*ppResource = m_pStagingBuffer;
+	*pOffset = offset;
+	*ppMappedPtr = m_pStagingMappedPtr + offset;
+
+	return hr;
+}
+
+void UploadBatch::flushBarriers()
+{
+	if (m_PendingBarriers.empty())
+	{
+		return;
+	}
+
+	m_pCommandList->ResourceBarrier((UINT)m_PendingBarriers.size(), m_PendingBarriers.data());
+	m_PendingBarriers.clear();
+}
+
+void UploadBatch::waitForFenceValue(const UINT64 FENCE_VALUE)
+{
+	if (m_pFence->GetCompletedValue() < FENCE_VALUE)
+	{
+		m_pFence->SetEventOnCompletion(FENCE_VALUE, m_hFenceEvent);
+		WaitForSingleObject(m_hFenceEvent, INFINITE);
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+static const UINT64 STAGING_RING_SIZE = 64 * 1024 * 1024;
+static const UINT MAX_PENDING_UPLOAD_BATCH_COUNT = 64;
+static const UINT UPLOAD_COMMAND_ALLOCATOR_COUNT = 4;
+
+// Offsets of upload heap ring. Knows nothing of D3D, fence values come from caller.
+// Space allocated between two CloseBatch() calls is freed together by Retire().
+class StagingRing
+{
+public:
+	StagingRing() = default;
+	~StagingRing() = default;
+
+	void Initialize(const UINT64 SIZE);
+
+	// UINT64_MAX when there is no room until older batches retire. ALIGNMENT is power of 2.
+	UINT64 Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT);
+	// returns false when batch queue is full. caller retires oldest batch first.
+	bool CloseBatch(const UINT64 FENCE_VALUE);
+	// frees batches whose fence value is not greater than COMPLETED_FENCE_VALUE.
+	void Retire(const UINT64 COMPLETED_FENCE_VALUE);
+
+	void Reset();
+
+	// 0 when nothing is pending.
+	inline UINT64 GetOldestFenceValue() { return (m_BatchCount > 0 ? m_pBatches[m_BatchHead].FenceValue : 0); }
+	inline UINT GetPendingBatchCount() { return m_BatchCount; }
+	inline UINT64 GetUsedSize() { return m_UsedSize; }
+	inline UINT64 GetSize() { return m_Size; }
+
+private:
+	struct Batch
+	{
+		UINT64 FenceValue;
+		UINT64 End; // head offset at close. tail moves here on retire.
+		UINT64 Size; // bytes including alignment and wrap padding.
+	};
+
+	UINT64 m_Size = 0;
+	UINT64 m_Head = 0;
+	UINT64 m_Tail = 0;
+	UINT64 m_UsedSize = 0;
+	UINT64 m_OpenSize = 0; // allocated since last CloseBatch().
+
+	Batch m_pBatches[MAX_PENDING_UPLOAD_BATCH_COUNT] = {};
+	UINT m_BatchHead = 0;
+	UINT m_BatchCount = 0;
+};
+
+// Main thread. called once fence of batch the callback was added in completes.
+typedef void (*UploadCompleteFunc)(void* pArg);
+
+struct UploadStats
+{
+	UINT SubmitCount;
+	UINT UploadCount;
+	UINT DedicatedCount; // uploads larger than ring.
+	UINT StallCount; // waits for GPU to free ring space or command allocator.
+	UINT64 UploadedBytes;
+};
+
+// Records buffer and texture uploads into one command list and submits them with one fence signal.
+// Source data is copied into staging ring at record time, so callers can free it right away.
+// Destination resources are ready for any later work on the same queue, Submit() never waits.
+class UploadBatch
+{
+public:
+	UploadBatch() = default;
+	~UploadBatch() { Cleanup(); }
+
+	// fence and event are shared with renderer. pFenceValue is last signaled value.
+	void Initialize(ID3D12Device5* pDevice, ID3D12CommandQueue* pCommandQueue, ID3D12Fence* pFence, HANDLE hFenceEvent, UINT64* pFenceValue, const UINT64 STAGING_SIZE);
+
+	// COMMON for both states records no barrier. for buffers shared by many uploads, copy and later reads promote implicitly.
+	HRESULT UploadBuffer(ID3D12Resource* pDestResource, const UINT64 DEST_OFFSET, const void* pDATA, const UINT64 SIZE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE);
+	// pIMAGE holds all subresources packed tightly, level 0 first.
+	HRESULT UploadTexture(ID3D12Resource* pDestResource, const UCHAR* pIMAGE, const D3D12_RESOURCE_STATES BEFORE_STATE, const D3D12_RESOURCE_STATES AFTER_STATE);
+	// pfnComplete runs after everything recorded so far reaches GPU.
+	void AddCompletion(UploadCompleteFunc pfnComplete, void* pArg);
+
+	// closes and executes recorded uploads, then signals fence once. no-op when nothing is recorded.
+	UINT64 Submit();
+	// runs callbacks of completed batches and frees their staging space.
+	void Retire();
+	// blocks until all submitted batches complete.
+	void WaitForIdle();
+
+	void Cleanup();
+
+	inline bool IsEmpty() { return !m_bRecording; }
+	inline const UploadStats& GetStats() { return m_Stats; }
+
+protected:
+	HRESULT beginRecording();
+	// staging space for SIZE bytes. submits and waits for GPU when ring is full.
+	// *ppResource receives ring buffer, or dedicated upload buffer if SIZE does not fit in ring.
+	HRESULT allocateStaging(const UINT64 SIZE, const UINT64 ALIGNMENT, ID3D12Resource** ppResource, UINT64* pOffset, UCHAR** ppMappedPtr);
+	void flushBarriers();
+	void waitForFenceValue(const UINT64 FENCE_VALUE);
+
+private:
+	struct Completion
+	{
+		UINT64 FenceValue; // 0 while batch is open.
+		UploadCompleteFunc pfnComplete;
+		void* pArg;
+	};
+
+	ID3D12Device5* m_pDevice = nullptr;
+	ID3D12CommandQueue* m_pCommandQueue = nullptr;
+	ID3D12Fence* m_pFence = nullptr;
+	HANDLE m_hFenceEvent = nullptr;
+	UINT64* m_pFenceValue = nullptr;
+
+	ID3D12Resource* m_pStagingBuffer = nullptr;
+	UCHAR* m_pStagingMappedPtr = nullptr;
+	StagingRing m_StagingRing;
+
+	ID3D12CommandAllocator* m_ppCommandAllocators[UPLOAD_COMMAND_ALLOCATOR_COUNT] = { nullptr, };
+	UINT64 m_pAllocatorFenceValues[UPLOAD_COMMAND_ALLOCATOR_COUNT] = { 0, };
+	UINT m_AllocatorIndex = 0;
+	ID3D12GraphicsCommandList* m_pCommandList = nullptr;
+	bool m_bRecording = false;
+
+	// copy dest -> final state transitions, issued together at Submit().
+	std::vector<D3D12_RESOURCE_BARRIER> m_PendingBarriers;
+	std::vector<Completion> m_Completions;
+	UINT64 m_LastSubmittedFenceValue = 0;
+
+	UploadStats m_Stats = {};
+};
@@ -12,13 +12,7 @@ struct PixelShaderOutput
 
 static const float3 F_DIELECTRIC = 0.04f; // ݼ(Dielectric)  F0.
 
-// ޽  ؽ t0  .
-Texture2D g_AlbedoTex : register(t0);
-Texture2D g_EmissiveTex : register(t1);
-Texture2D g_NormalTex : register(t2);
-Texture2D g_AmbientOcclusionTex : register(t3);
-Texture2D g_MetallicTex : register(t4);
-Texture2D g_RoughnessTex : register(t5);
+// g_AlbedoTex, g_EmissiveTex, g_NormalTex, g_ORMHTex are slots of bindless range. see Common.hlsli.
 
 float3 SchlickFresnel(float3 F0, float NdotH)
 {
@@ -34,15 +28,16 @@ float3 GetNormal(PixelShaderInput input)
 		return normalWorld;
 	}
 
-	float3 normal = g_NormalTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias).rgb;
+	float3 normal = g_NormalTex.SampleBias(g_LinearWrapSampler, input.Texcoord, g_LODBias).rgb;
 	normal = 2.0f * normal - 1.0f; //   [-1.0, 1.0]
+	normal.z = sqrt(saturate(1.0f - dot(normal.xy, normal.xy))); // BC5 normal maps keep xy only.
 
 		// OpenGL  ָ 쿡 y  .
 	normal.y = (bInvertNormalMapY ? -normal.y : normal.y);
 
 	float3 N = normalWorld;
-	float3 T = normalize(input.WorldTangent - dot(input.WorldTangent, N) * N);
-	float3 B = cross(N, T);
+	float3 T = normalize(input.WorldTangent.xyz - dot(input.WorldTangent.xyz, N) * N);
+	float3 B = cross(N, T) * (input.WorldTangent.w < 0.0f ? -1.0f : 1.0f);
 
 		// matrix float4x4, ⼭  ȯ̶ 3x3 .
 	float3x3 TBN = float3x3(T, B, N);
@@ -415,13 +410,15 @@ PixelShaderOutput main(PixelShaderInput input)
 	float3 pixelToEye = normalize(g_EyeWorld - input.WorldPosition);
 	float3 normalWorld = GetNormal(input);
 
-	float4 albedo = (bUseAlbedoMap ? g_AlbedoTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias) * float4(g_AlbedoFactor, 1.0f) : float4(g_AlbedoFactor, 1.0f));
+	float4 albedo = (bUseAlbedoMap ? g_AlbedoTex.SampleBias(g_LinearWrapSampler, input.Texcoord, g_LODBias) * float4(g_AlbedoFactor, 1.0f) : float4(g_AlbedoFactor, 1.0f));
 	clip(albedo.a - 0.5f); //  κ ȼ ׸ .
 
-	float ao = (bUseAOMap ? g_AmbientOcclusionTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias).r : 1.0f);
-	float metallic = (bUseMetallicMap ? g_MetallicTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias).b * g_MetallicFactor : g_MetallicFactor);
-	float roughness = (bUseRoughnessMap ? g_RoughnessTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias).g * g_RoughnessFactor : g_RoughnessFactor);
-	float3 emission = (bUseEmissiveMap ? g_EmissiveTex.SampleLevel(g_LinearWrapSampler, input.Texcoord, g_LODBias).rgb : g_EmissionFactor);
+	// channels without map are packed as 1.0f.
+	float4 ormh = (bUseORMHMap ? g_ORMHTex.SampleBias(g_LinearWrapSampler, input.Texcoord, g_LODBias) : float4(1.0f, 1.0f, 1.0f, 0.5f));
+	float ao = ormh.r;
+	float metallic = ormh.b * g_MetallicFactor;
+	float roughness = ormh.g * g_RoughnessFactor;
+	float3 emission = (bUseEmissiveMap ? g_EmissiveTex.SampleBias(g_LinearWrapSampler, input.Texcoord, g_LODBias).rgb : g_EmissionFactor);
 
 	float3 ambientLighting = AmbientLightingByIBL(albedo.rgb, normalWorld, pixelToEye, ao, metallic, roughness) * g_StrengthIBL;
 	float3 directLighting = float3(0.0f, 0.0f, 0.0f);
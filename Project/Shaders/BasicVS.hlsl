@@ -1,9 +1,9 @@
 #include "Common.hlsli"
 
-Texture2D g_HeightTex : register(t6);
-
-PixelShaderInput main(VertexShaderInput input)
+PixelShaderInput main(VERTEX_SHADER_INPUT packedInput)
 {
+    VertexShaderInput input = DecodeVertexShaderInput(packedInput);
+
     //  ǥ NDC̱   ǥ ̿ؼ  .
     PixelShaderInput output;
     
@@ -42,12 +42,12 @@ PixelShaderInput main(VertexShaderInput input)
         // weight  1.
         modelPos += weights[i] * mul(float4(input.ModelPosition, 1.0f), g_BoneTransforms[indices[i]]).xyz;
         modelNormal += weights[i] * mul(input.ModelNormal, (float3x3)g_BoneTransforms[indices[i]]);
-        modelTangent += weights[i] * mul(input.ModelTangent, (float3x3)g_BoneTransforms[indices[i]]);
+        modelTangent += weights[i] * mul(input.ModelTangent.xyz, (float3x3)g_BoneTransforms[indices[i]]);
     }
 
     input.ModelPosition = modelPos;
     input.ModelNormal = modelNormal;
-    input.ModelTangent = modelTangent;
+    input.ModelTangent.xyz = modelTangent;
 #endif
     
     output.ModelPosition = input.ModelPosition;
@@ -55,16 +55,16 @@ PixelShaderInput main(VertexShaderInput input)
     output.WorldNormal = normalize(output.WorldNormal);
     output.WorldPosition = mul(float4(input.ModelPosition, 1.0f), g_World).xyz;
     
-    if (bUseHeightMap)
+    if (bUseHeightMap && bUseORMHMap)
     {
-        float height = g_HeightTex.SampleLevel(g_LinearClampSampler, input.Texcoord, 0.0f).r;
+        float height = g_ORMHTex.SampleLevel(g_LinearClampSampler, input.Texcoord, 0.0f).a;
         height = height * 2.0f - 1.0f;
         output.WorldPosition += output.WorldNormal * height * g_HeightScale;
     }
     
     output.ProjectedPosition = mul(float4(output.WorldPosition, 1.0f), g_ViewProjection);
     output.Texcoord = input.Texcoord;
-    output.WorldTangent = mul(float4(input.ModelTangent, 0.0f), g_World).xyz;
+    output.WorldTangent = float4(mul(float4(input.ModelTangent.xyz, 0.0f), g_World).xyz, input.ModelTangent.w);
 
     return output;
 }
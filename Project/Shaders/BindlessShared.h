@@ -0,0 +1,13 @@
+#ifndef BINDLESS_SHARED_H
+#define BINDLESS_SHARED_H
+
+// Included by both C++ (Renderer/BindlessDescriptorPool.h) and HLSL (Common.hlsli), so plain defines only.
+
+// slots of bindless range. shader arrays and root signature ranges are both this size.
+#define BINDLESS_DESCRIPTOR_COUNT 16384
+
+// ranges this large need D3D12_RESOURCE_BINDING_TIER_2 (srvs up to full heap, unused ones left uninitialized).
+// tier 1 allows 128 srvs per stage. Renderer::initDirect3D checks tier at device creation.
+#define BINDLESS_MIN_RESOURCE_BINDING_TIER 2
+
+#endif
@@ -77,6 +77,10 @@ cbuffer MeshConstants : register(b2)
     float g_HeightScale;
     float g_WindTrunk;
     float g_WindLeaves;
+    float3 g_PositionOffset; // compact vertex dequantization.
+    float dummy3;
+    float3 g_PositionScale;
+    float dummy4;
 };
 cbuffer MaterialConstants : register(b3)
 {
@@ -87,17 +91,38 @@ cbuffer MaterialConstants : register(b3)
 
     bool bUseAlbedoMap;
     bool bUseNormalMap;
-    bool bUseAOMap; // Ambient Occlusion
+    bool bUseORMHMap; // Ambient Occlusion, Roughness, Metallic, Height
     bool bInvertNormalMapY;
-    bool bUseMetallicMap;
-    bool bUseRoughnessMap;
     bool bUseEmissiveMap;
     
-    float dummy2;
+    float3 dummy2;
 };
 
+// slots of bindless range for this draw. see BindlessIndexRecord in Graphics/ConstantDataType.h
+cbuffer BindlessIndices : register(b5)
+{
+    uint g_AlbedoIndex;
+    uint g_EmissiveIndex;
+    uint g_NormalIndex;
+    uint g_ORMHIndex;
+    uint g_BoneBufferIndex;
+};
+
+// arrays match root signature ranges.
+#include "BindlessShared.h"
+
+// index is same for whole draw, so no NonUniformResourceIndex.
+Texture2D g_BindlessTextures[BINDLESS_DESCRIPTOR_COUNT] : register(t0, space1);
+
+#define g_AlbedoTex g_BindlessTextures[g_AlbedoIndex]
+#define g_EmissiveTex g_BindlessTextures[g_EmissiveIndex]
+#define g_NormalTex g_BindlessTextures[g_NormalIndex]
+#define g_ORMHTex g_BindlessTextures[g_ORMHIndex] // r: ambient occlusion, g: roughness, b: metallic, a: height.
+
 #ifdef SKINNED
-StructuredBuffer<float4x4> g_BoneTransforms : register(t7);
+StructuredBuffer<float4x4> g_BindlessBoneBuffers[BINDLESS_DESCRIPTOR_COUNT] : register(t0, space2);
+
+#define g_BoneTransforms g_BindlessBoneBuffers[g_BoneBufferIndex]
 
 //cbuffer SkinnedConstants : register(b3)
 //{
@@ -110,7 +135,7 @@ struct VertexShaderInput
     float3 ModelPosition : POSITION; // ǥ ġ position
     float3 ModelNormal : NORMAL; //  ǥ normal    
     float2 Texcoord : TEXCOORD;
-    float3 ModelTangent : TANGENT;
+    float4 ModelTangent : TANGENT; // w: handedness
     
 #ifdef SKINNED
     float4 BoneWeights0 : BLENDWEIGHT0;
@@ -119,13 +144,91 @@ struct VertexShaderInput
     uint4 BoneIndices1 : BLENDINDICES1;
 #endif
 };
+
+// quantized vertex. see Model/VertexCompression.h
+struct CompactVertexShaderInput
+{
+    float4 PackedPosition : POSITION; // unorm16 in mesh bounds. w: tangent handedness.
+    float2 PackedNormal : NORMAL; // octahedral.
+    float2 Texcoord : TEXCOORD;
+    float2 PackedTangent : TANGENT; // octahedral.
+
+#ifdef SKINNED
+    float4 BoneWeights0 : BLENDWEIGHT0;
+    float4 BoneWeights1 : BLENDWEIGHT1;
+    uint4 BoneIndices0 : BLENDINDICES0;
+    uint4 BoneIndices1 : BLENDINDICES1;
+#endif
+};
+
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 v = float3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-v.z);
+    v.x += (v.x >= 0.0f ? -t : t);
+    v.y += (v.y >= 0.0f ? -t : t);
+    return normalize(v);
+}
+
+#ifdef COMPACT_VERTEX
+#define VERTEX_SHADER_INPUT CompactVertexShaderInput
+#else
+#define VERTEX_SHADER_INPUT VertexShaderInput
+#endif
+
+VertexShaderInput DecodeVertexShaderInput(VERTEX_SHADER_INPUT packedInput)
+{
+#ifdef COMPACT_VERTEX
+    VertexShaderInput input;
+    input.ModelPosition = packedInput.PackedPosition.xyz * g_PositionScale + g_PositionOffset;
+    input.ModelNormal = DecodeOctahedral(packedInput.PackedNormal);
+    input.Texcoord = packedInput.Texcoord;
+    input.ModelTangent = float4(DecodeOctahedral(packedInput.PackedTangent), packedInput.PackedPosition.w * 2.0f - 1.0f);
+#ifdef SKINNED
+    input.BoneWeights0 = packedInput.BoneWeights0;
+    input.BoneWeights1 = packedInput.BoneWeights1;
+    input.BoneIndices0 = packedInput.BoneIndices0;
+    input.BoneIndices1 = packedInput.BoneIndices1;
+#endif
+    return input;
+#else
+    return packedInput;
+#endif
+}
+
+// position(+skin) only stream for depth only passes. see Model/VertexStream.h
+struct DepthOnlyVertexShaderInput
+{
+#ifdef COMPACT_VERTEX
+    float4 PackedPosition : POSITION; // unorm16 in mesh bounds.
+#else
+    float3 ModelPosition : POSITION;
+#endif
+
+#ifdef SKINNED
+    float4 BoneWeights0 : BLENDWEIGHT0;
+    float4 BoneWeights1 : BLENDWEIGHT1;
+    uint4 BoneIndices0 : BLENDINDICES0;
+    uint4 BoneIndices1 : BLENDINDICES1;
+#endif
+};
+
+float3 DecodeDepthOnlyPosition(DepthOnlyVertexShaderInput input)
+{
+#ifdef COMPACT_VERTEX
+    return input.PackedPosition.xyz * g_PositionScale + g_PositionOffset;
+#else
+    return input.ModelPosition;
+#endif
+}
+
 struct PixelShaderInput
 {
     float4 ProjectedPosition : SV_POSITION; // Screen position
     float3 WorldPosition : POSITION0; // World position ( 꿡 )
     float3 WorldNormal : NORMAL0;
     float2 Texcoord : TEXCOORD0;
-    float3 WorldTangent : TANGENT0;
+    float4 WorldTangent : TANGENT0;
     float3 ModelPosition : POSITION1; // Volume casting 
 };
 
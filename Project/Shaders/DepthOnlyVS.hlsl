@@ -1,7 +1,9 @@
 #include "Common.hlsli"
 
-float4 main(VertexShaderInput input) : SV_POSITION
+float4 main(DepthOnlyVertexShaderInput input) : SV_POSITION
 {
+    float3 modelPosition = DecodeDepthOnlyPosition(input);
+
 #ifdef SKINNED
     float weights[8];
     weights[0] = input.BoneWeights0.x;
@@ -30,13 +32,13 @@ float4 main(VertexShaderInput input) : SV_POSITION
     for (int i = 0; i < 8; ++i)
     {
         // position .
-        modelPos += weights[i] * mul(float4(input.ModelPosition, 1.0f), g_BoneTransforms[indices[i]]).xyz;
+        modelPos += weights[i] * mul(float4(modelPosition, 1.0f), g_BoneTransforms[indices[i]]).xyz;
     }
 
-    input.ModelPosition = modelPos;
+    modelPosition = modelPos;
 
 #endif
 
-    float4 pos = mul(float4(input.ModelPosition, 1.0f), g_World);
+    float4 pos = mul(float4(modelPosition, 1.0f), g_World);
     return mul(pos, g_ViewProjection);
 }
@@ -6,8 +6,10 @@ struct SkyboxPixelShaderInput
     float3 ModelPosition : POSITION;
 };
 
-SkyboxPixelShaderInput main(VertexShaderInput input)
+SkyboxPixelShaderInput main(VERTEX_SHADER_INPUT packedInput)
 {
+    VertexShaderInput input = DecodeVertexShaderInput(packedInput);
+
     SkyboxPixelShaderInput output;
     output.ModelPosition = input.ModelPosition;
     output.ProjectedPosition = mul(float4(input.ModelPosition, 0.0f), g_View); // ȸ
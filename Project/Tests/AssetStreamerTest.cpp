@@ -0,0 +1,319 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Renderer/AssetStreamer.h"
+#include "TestCommon.h"
+
+// stands in for Renderer. completion callbacks "upload" decoded payload into it.
+struct FakeUploadSink
+{
+	UINT UploadCount;
+	UINT64 UploadedBytes;
+	int pOrder[16];
+};
+
+struct TestItem
+{
+	int ID;
+	UINT64 Payload; // decoded. sum of bytes.
+	HRESULT Result;
+	volatile LONG DecodeCount;
+	UINT CompleteCount;
+	void* pCompleteSink;
+	bool bCompletedOnMainThread;
+};
+
+static std::thread::id s_MainThreadID;
+static HANDLE s_hDecodeGate = nullptr; // manual reset. decode of gated item waits here.
+static HANDLE s_hDecodeStarted = nullptr;
+static volatile LONG s_DecodedCount = 0;
+
+static HRESULT decodeSum(StreamingRequest* pRequest)
+{
+	TestItem* pItem = (TestItem*)pRequest->pUserData;
+	InterlockedIncrement(&pItem->DecodeCount);
+
+	UINT64 sum = 0;
+	for (UINT64 i = 0, size = pRequest->FileData.size(); i < size; ++i)
+	{
+		sum += pRequest->FileData[i];
+	}
+	pItem->Payload = sum;
+
+	InterlockedIncrement(&s_DecodedCount);
+	return S_OK;
+}
+
+// holds the only decode thread, so later requests line up in decode queues.
+static HRESULT decodeGated(StreamingRequest* pRequest)
+{
+	SetEvent(s_hDecodeStarted);
+	WaitForSingleObject(s_hDecodeGate, INFINITE);
+	return decodeSum(pRequest);
+}
+
+static void completeUpload(StreamingRequest* pRequest, void* pUploadSink)
+{
+	TestItem* pItem = (TestItem*)pRequest->pUserData;
+	++pItem->CompleteCount;
+	pItem->Result = pRequest->Result;
+	pItem->pCompleteSink = pUploadSink;
+	pItem->bCompletedOnMainThread = (std::this_thread::get_id() == s_MainThreadID);
+
+	FakeUploadSink* pSink = (FakeUploadSink*)pUploadSink;
+	if (pSink && SUCCEEDED(pRequest->Result))
+	{
+		if (pSink->UploadCount < _countof(pSink->pOrder))
+		{
+			pSink->pOrder[pSink->UploadCount] = pItem->ID;
+		}
+		++pSink->UploadCount;
+		pSink->UploadedBytes += pItem->Payload;
+	}
+}
+
+static void initItems(TestItem* pItems, const UINT COUNT)
+{
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		pItems[i] = {};
+		pItems[i].ID = (int)i;
+		pItems[i].Result = E_FAIL;
+	}
+}
+
+static void requestItem(AssetStreamer* pStreamer, TestItem* pItem, eStreamingPriority priority, StreamingDecodeFunc pfnDecode, void* pOwner)
+{
+	const UCHAR pDATA[4] = { 1, 2, 3, (UCHAR)pItem->ID };
+	pStreamer->RequestFromMemory(L"memory", pDATA, sizeof(pDATA), priority, pfnDecode, completeUpload, pOwner, pItem);
+}
+
+static void waitDecodeStarted()
+{
+	CHECK(WaitForSingleObject(s_hDecodeStarted, 5000) == WAIT_OBJECT_0);
+}
+
+static void testMemoryRequests()
+{
+	AssetStreamer streamer;
+	streamer.Initialize(2);
+
+	FakeUploadSink sink = {};
+	TestItem items[8];
+	initItems(items, _countof(items));
+	for (UINT i = 0; i < _countof(items); ++i)
+	{
+		requestItem(&streamer, &items[i], StreamingPriority_Normal, decodeSum, nullptr);
+	}
+	streamer.Flush(&sink);
+
+	CHECK(streamer.IsIdle());
+	CHECK(sink.UploadCount == _countof(items));
+	UINT64 expectedBytes = 0;
+	for (UINT i = 0; i < _countof(items); ++i)
+	{
+		CHECK(items[i].Result == S_OK);
+		CHECK(items[i].DecodeCount == 1);
+		CHECK(items[i].CompleteCount == 1);
+		CHECK(items[i].pCompleteSink == &sink);
+		CHECK(items[i].bCompletedOnMainThread);
+		CHECK(items[i].Payload == 6 + i);
+		expectedBytes += 6 + i;
+	}
+	CHECK(sink.UploadedBytes == expectedBytes);
+
+	const StreamingStats& STATS = streamer.GetStats();
+	CHECK(STATS.RequestCount == _countof(items));
+	CHECK(STATS.CompletedCount == _countof(items));
+	CHECK(STATS.FailedCount == 0 && STATS.CancelledCount == 0);
+}
+
+static void testFileRequests()
+{
+	const char* pszFILE_NAME = "AssetStreamerTest.tmp";
+	FILE* pFile = fopen(pszFILE_NAME, "wb");
+	CHECK(pFile);
+	if (!pFile)
+	{
+		return;
+	}
+	const UCHAR pDATA[100] = { 7, 0, 9 };
+	fwrite(pDATA, 1, sizeof(pDATA), pFile);
+	fclose(pFile);
+
+	AssetStreamer streamer;
+	streamer.Initialize(1);
+
+	FakeUploadSink sink = {};
+	TestItem items[2];
+	initItems(items, _countof(items));
+	streamer.Request(L"AssetStreamerTest.tmp", StreamingPriority_Normal, decodeSum, completeUpload, nullptr, &items[0]);
+	streamer.Request(L"AssetStreamerTest.missing", StreamingPriority_Normal, decodeSum, completeUpload, nullptr, &items[1]);
+	streamer.Flush(&sink);
+	remove(pszFILE_NAME);
+
+	CHECK(items[0].Result == S_OK && items[0].Payload == 16);
+	// failed IO skips decode but still completes, so owner can release user data.
+	CHECK(FAILED(items[1].Result));
+	CHECK(items[1].DecodeCount == 0);
+	CHECK(items[1].CompleteCount == 1);
+	CHECK(sink.UploadCount == 1);
+	CHECK(streamer.GetStats().FailedCount == 1);
+}
+
+static void testPriorityOrder()
+{
+	AssetStreamer streamer;
+	streamer.Initialize(1);
+	ResetEvent(s_hDecodeGate);
+
+	FakeUploadSink sink = {};
+	TestItem items[4];
+	initItems(items, _countof(items));
+	requestItem(&streamer, &items[0], StreamingPriority_Normal, decodeGated, nullptr);
+	waitDecodeStarted();
+
+	requestItem(&streamer, &items[1], StreamingPriority_Low, decodeSum, nullptr);
+	requestItem(&streamer, &items[2], StreamingPriority_Normal, decodeSum, nullptr);
+	requestItem(&streamer, &items[3], StreamingPriority_High, decodeSum, nullptr);
+	SetEvent(s_hDecodeGate);
+	streamer.Flush(&sink);
+
+	// one decode thread, so completion order is decode order.
+	CHECK(sink.UploadCount == 4);
+	CHECK(sink.pOrder[0] == 0);
+	CHECK(sink.pOrder[1] == 3);
+	CHECK(sink.pOrder[2] == 2);
+	CHECK(sink.pOrder[3] == 1);
+}
+
+static void testCancel()
+{
+	AssetStreamer streamer;
+	streamer.Initialize(1);
+	ResetEvent(s_hDecodeGate);
+
+	int owner0 = 0;
+	int owner1 = 0;
+	FakeUploadSink sink = {};
+	TestItem items[4];
+	initItems(items, _countof(items));
+	requestItem(&streamer, &items[0], StreamingPriority_Normal, decodeGated, &owner0);
+	waitDecodeStarted();
+
+	requestItem(&streamer, &items[1], StreamingPriority_Normal, decodeSum, &owner1);
+	requestItem(&streamer, &items[2], StreamingPriority_High, decodeSum, &owner1);
+	requestItem(&streamer, &items[3], StreamingPriority_Normal, decodeSum, &owner0);
+
+	// queued ones are cancelled in place. items[0] is in flight and gets flag.
+	streamer.CancelRequests(&owner1);
+	streamer.CancelRequests(&items[0]); // not an owner. no effect.
+	SetEvent(s_hDecodeGate);
+	streamer.Flush(&sink);
+
+	CHECK(items[0].Result == S_OK);
+	CHECK(items[1].Result == E_ABORT && items[1].DecodeCount == 0);
+	CHECK(items[2].Result == E_ABORT && items[2].DecodeCount == 0);
+	CHECK(items[3].Result == S_OK && items[3].DecodeCount == 1);
+	for (UINT i = 0; i < _countof(items); ++i)
+	{
+		CHECK(items[i].CompleteCount == 1);
+		CHECK(items[i].pCompleteSink == &sink);
+	}
+	CHECK(sink.UploadCount == 2);
+	CHECK(streamer.GetStats().CancelledCount == 2);
+
+	// cancel while decoding. decode result is thrown away.
+	ResetEvent(s_hDecodeGate);
+	TestItem inFlight[1];
+	initItems(inFlight, 1);
+	requestItem(&streamer, &inFlight[0], StreamingPriority_Normal, decodeGated, &owner0);
+	waitDecodeStarted();
+	streamer.CancelRequests(&owner0);
+	SetEvent(s_hDecodeGate);
+	streamer.Flush(&sink);
+
+	CHECK(inFlight[0].DecodeCount == 1);
+	CHECK(inFlight[0].Result == E_ABORT);
+	CHECK(sink.UploadCount == 2);
+	CHECK(streamer.GetStats().CancelledCount == 3);
+}
+
+static void testTimeBudget()
+{
+	AssetStreamer streamer;
+	streamer.Initialize(2);
+
+	FakeUploadSink sink = {};
+	TestItem items[3];
+	initItems(items, _countof(items));
+	InterlockedExchange(&s_DecodedCount, 0);
+	for (UINT i = 0; i < _countof(items); ++i)
+	{
+		requestItem(&streamer, &items[i], StreamingPriority_Normal, decodeSum, nullptr);
+	}
+	while (s_DecodedCount < (LONG)_countof(items))
+	{
+		Sleep(1);
+	}
+	Sleep(10); // decode thread pushes completion right after decode returns.
+
+	// zero budget still makes progress.
+	CHECK(streamer.ProcessCompletions(&sink, 0.0) == 1);
+	CHECK(streamer.GetPendingCount() == 2);
+	CHECK(streamer.ProcessCompletions(&sink, DBL_MAX) == 2);
+	CHECK(streamer.IsIdle());
+	CHECK(streamer.ProcessCompletions(&sink, DBL_MAX) == 0);
+	CHECK(sink.UploadCount == 3);
+}
+
+static void testCleanupLeftovers()
+{
+	AssetStreamer streamer;
+	streamer.Initialize(1);
+	ResetEvent(s_hDecodeGate);
+
+	TestItem items[3];
+	initItems(items, _countof(items));
+	requestItem(&streamer, &items[0], StreamingPriority_Normal, decodeGated, nullptr);
+	waitDecodeStarted();
+	requestItem(&streamer, &items[1], StreamingPriority_Normal, decodeSum, nullptr);
+	requestItem(&streamer, &items[2], StreamingPriority_Low, decodeSum, nullptr);
+
+	// open gate after Cleanup() asked workers to quit.
+	std::thread opener([]() { Sleep(50); SetEvent(s_hDecodeGate); });
+	streamer.Cleanup();
+	opener.join();
+
+	// no sink on shutdown. callbacks still run once, on calling thread.
+	for (UINT i = 0; i < _countof(items); ++i)
+	{
+		CHECK(items[i].CompleteCount == 1);
+		CHECK(items[i].pCompleteSink == nullptr);
+		CHECK(items[i].Result == E_ABORT);
+		CHECK(items[i].bCompletedOnMainThread);
+	}
+	CHECK(items[1].DecodeCount == 0 && items[2].DecodeCount == 0);
+
+	// not initialized. calls are no-op.
+	CHECK(streamer.ProcessCompletions(nullptr, DBL_MAX) == 0);
+	streamer.CancelRequests(nullptr);
+}
+
+int main()
+{
+	s_MainThreadID = std::this_thread::get_id();
+	s_hDecodeGate = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	s_hDecodeStarted = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+	testMemoryRequests();
+	testFileRequests();
+	testPriorityOrder();
+	testCancel();
+	testTimeBudget();
+	testCleanupLeftovers();
+
+	CloseHandle(s_hDecodeStarted);
+	CloseHandle(s_hDecodeGate);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,214 @@
+#include "../pch.h"
+#include "../Util/IndexCreator.h"
+#include "../Util/BindlessRegistry.h"
+#include "TestCommon.h"
+
+#include <map>
+#include <set>
+
+static void testIndexCreator()
+{
+	IndexCreator indexCreator;
+	indexCreator.Initialize(8);
+
+	std::set<ULONG> indices;
+	for (int i = 0; i < 8; ++i)
+	{
+		const ULONG INDEX = indexCreator.Alloc();
+		CHECK(INDEX < 8);
+		indices.insert(INDEX);
+	}
+	CHECK(indices.size() == 8);
+	CHECK(indexCreator.Alloc() == 0xffff);
+
+	// freed index comes back first.
+	indexCreator.Free(5);
+	indexCreator.Free(2);
+	CHECK(indexCreator.Alloc() == 2);
+	CHECK(indexCreator.Alloc() == 5);
+	CHECK(indexCreator.Alloc() == 0xffff);
+
+	for (ULONG i = 0; i < 8; ++i)
+	{
+		indexCreator.Free(i);
+	}
+	indexCreator.Check();
+	indexCreator.Clear();
+}
+
+static void testRegisterRelease()
+{
+	BindlessRegistry registry;
+	registry.Initialize(16, 1);
+	CHECK(registry.GetCapacity() == 16);
+
+	bool bNew = false;
+	const UINT SLOT = registry.Register(0x1000, &bNew);
+	CHECK(bNew && SLOT >= 1 && SLOT < 16);
+	CHECK(registry.Register(0x1000, &bNew) == SLOT && !bNew);
+	CHECK(registry.Find(0x1000) == SLOT);
+	CHECK(registry.Find(0x2000) == BINDLESS_INVALID_INDEX);
+	CHECK(registry.GetStats().RegisteredCount == 1);
+
+	// last reference frees slot.
+	registry.Release(0x1000);
+	CHECK(registry.Find(0x1000) == SLOT);
+	registry.Release(0x1000);
+	CHECK(registry.Find(0x1000) == BINDLESS_INVALID_INDEX);
+	CHECK(registry.GetStats().RegisteredCount == 0);
+	CHECK(registry.GetStats().PendingFreeCount == 1);
+
+	// released slot is not reused in same frame, GPU may still read it.
+	const UINT NEW_SLOT = registry.Register(0x1000, &bNew);
+	CHECK(bNew && NEW_SLOT != SLOT);
+	registry.Release(0x1000);
+
+	registry.BeginFrame();
+	CHECK(registry.GetStats().PendingFreeCount == 0);
+	CHECK(registry.GetStats().PeakCount == 1);
+
+	// releasing unknown key breaks and changes nothing.
+	const LONG BREAK_COUNT = g_HeadlessDebugBreakCount;
+	registry.Release(0x3000);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 1);
+	CHECK(registry.GetStats().PendingFreeCount == 0);
+
+	registry.Cleanup();
+	CHECK(registry.GetCapacity() == 0);
+}
+
+static void testFull()
+{
+	const UINT CAPACITY = 16;
+	const UINT RESERVED_COUNT = 2;
+	BindlessRegistry registry;
+	registry.Initialize(CAPACITY, RESERVED_COUNT);
+
+	std::set<UINT> slots;
+	bool bNew = false;
+	for (UINT i = 0; i < CAPACITY - RESERVED_COUNT; ++i)
+	{
+		const UINT SLOT = registry.Register(100 + i, &bNew);
+		CHECK(bNew && SLOT >= RESERVED_COUNT && SLOT < CAPACITY);
+		slots.insert(SLOT);
+	}
+	CHECK(slots.size() == CAPACITY - RESERVED_COUNT);
+
+	CHECK(registry.Register(999, &bNew) == BINDLESS_INVALID_INDEX && !bNew);
+	CHECK(registry.GetStats().FailCount == 1);
+
+	// existing keys still register while full.
+	CHECK(registry.Register(100, &bNew) != BINDLESS_INVALID_INDEX && !bNew);
+
+	registry.Release(101);
+	CHECK(registry.Register(999, &bNew) == BINDLESS_INVALID_INDEX);
+	registry.BeginFrame();
+	CHECK(registry.Register(999, &bNew) != BINDLESS_INVALID_INDEX && bNew);
+	CHECK(registry.GetStats().FailCount == 2);
+
+	registry.Release(100);
+	registry.Release(100);
+	registry.Release(999);
+	for (UINT i = 2; i < CAPACITY - RESERVED_COUNT; ++i)
+	{
+		registry.Release(100 + i);
+	}
+	CHECK(registry.GetStats().RegisteredCount == 0);
+	registry.BeginFrame();
+}
+
+// random register, release and frame steps against model of keys and pending slots.
+static void testFuzz()
+{
+	const UINT CAPACITY = 64;
+	const UINT RESERVED_COUNT = 1;
+	BindlessRegistry registry;
+	registry.Initialize(CAPACITY, RESERVED_COUNT);
+
+	struct ModelEntry
+	{
+		UINT Slot;
+		UINT RefCount;
+	};
+	std::map<UINT64, ModelEntry> entries;
+	std::set<UINT> pendingSlots; // released in this frame.
+	TestRandom random;
+	UINT failCount = 0;
+
+	for (int step = 0; step < 200000; ++step)
+	{
+		const UINT ACTION = random.NextUInt(100);
+		const UINT64 KEY = 0x10000 + random.NextUInt(96) * 64;
+		if (ACTION == 0)
+		{
+			registry.BeginFrame();
+			pendingSlots.clear();
+		}
+		else if (ACTION < 55)
+		{
+			bool bNew = false;
+			const UINT SLOT = registry.Register(KEY, &bNew);
+			std::map<UINT64, ModelEntry>::iterator iter = entries.find(KEY);
+			if (iter != entries.end())
+			{
+				CHECK(SLOT == iter->second.Slot && !bNew);
+				++iter->second.RefCount;
+			}
+			else if (SLOT == BINDLESS_INVALID_INDEX)
+			{
+				CHECK(entries.size() + pendingSlots.size() == CAPACITY - RESERVED_COUNT);
+				++failCount;
+			}
+			else
+			{
+				CHECK(bNew && SLOT >= RESERVED_COUNT && SLOT < CAPACITY);
+				CHECK(pendingSlots.count(SLOT) == 0);
+				for (std::map<UINT64, ModelEntry>::iterator other = entries.begin(); other != entries.end(); ++other)
+				{
+					CHECK(other->second.Slot != SLOT);
+				}
+				entries[KEY] = { SLOT, 1 };
+			}
+		}
+		else
+		{
+			std::map<UINT64, ModelEntry>::iterator iter = entries.find(KEY);
+			if (iter == entries.end())
+			{
+				continue;
+			}
+			registry.Release(KEY);
+			if (--iter->second.RefCount == 0)
+			{
+				pendingSlots.insert(iter->second.Slot);
+				entries.erase(iter);
+			}
+		}
+
+		CHECK(registry.GetStats().RegisteredCount == (UINT)entries.size());
+		CHECK(registry.GetStats().PendingFreeCount == (UINT)pendingSlots.size());
+	}
+	CHECK(failCount > 0);
+
+	while (!entries.empty())
+	{
+		registry.Release(entries.begin()->first);
+		if (--entries.begin()->second.RefCount == 0)
+		{
+			entries.erase(entries.begin());
+		}
+	}
+	registry.BeginFrame();
+	CHECK(registry.GetStats().RegisteredCount == 0);
+	CHECK(registry.GetStats().PeakCount <= CAPACITY - RESERVED_COUNT && registry.GetStats().PeakCount > CAPACITY / 2);
+}
+
+int main()
+{
+	testIndexCreator();
+	testRegisterRelease();
+	testFull();
+	testFuzz();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,436 @@
+#include "../pch.h"
+#include "../Renderer/CommandStateCache.h"
+#include "TestCommon.h"
+
+// CommandStateCache against mock command list that records calls and keeps state bound the way D3D12 does.
+// same calls go through cache to one list and straight to another, bound state of both must stay equal.
+
+static const UINT ROOT_ARGUMENT_COUNT = 20; // above limit of cache, so last ones pass through.
+
+enum eCallType
+{
+	CallType_DescriptorHeaps = 0,
+	CallType_RootSignature,
+	CallType_PipelineState,
+	CallType_Topology,
+	CallType_StencilRef,
+	CallType_BlendFactor,
+	CallType_Viewports,
+	CallType_ScissorRects,
+	CallType_RootDescriptorTable,
+	CallType_RootConstantBufferView,
+	CallType_Count,
+};
+
+struct RootArgument
+{
+	UINT Type; // 0 when not bound.
+	UINT64 Value;
+};
+
+struct BoundState
+{
+	ID3D12DescriptorHeap* ppHeaps[2];
+	UINT HeapCount;
+	ID3D12RootSignature* pRootSignature;
+	ID3D12PipelineState* pPipelineState;
+	D3D12_PRIMITIVE_TOPOLOGY Topology;
+	UINT StencilRef;
+	float pBlendFactor[4];
+	D3D12_VIEWPORT pViewports[D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+	UINT ViewportCount;
+	D3D12_RECT pScissorRects[D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+	UINT ScissorRectCount;
+	RootArgument pRootArguments[ROOT_ARGUMENT_COUNT];
+};
+
+struct RecordingCommandList : public ID3D12GraphicsCommandList
+{
+	BoundState State = {};
+	UINT pCallCounts[CallType_Count] = {};
+	UINT CallCount = 0;
+
+	// opened list has no state, as after Reset() of D3D12 command list.
+	void Open()
+	{
+		State = {};
+		for (UINT i = 0; i < CallType_Count; ++i)
+		{
+			pCallCounts[i] = 0;
+		}
+		CallCount = 0;
+	}
+
+	void SetDescriptorHeaps(UINT numDescriptorHeaps, ID3D12DescriptorHeap* const* ppDescriptorHeaps) override
+	{
+		CHECK(numDescriptorHeaps > 0 && numDescriptorHeaps <= 2);
+		memcpy(State.ppHeaps, ppDescriptorHeaps, sizeof(ID3D12DescriptorHeap*) * numDescriptorHeaps);
+		State.HeapCount = numDescriptorHeaps;
+		record(CallType_DescriptorHeaps);
+	}
+	void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) override
+	{
+		// bindings survive only when same root signature is set again.
+		if (pRootSignature != State.pRootSignature)
+		{
+			memset(State.pRootArguments, 0, sizeof(State.pRootArguments));
+		}
+		State.pRootSignature = pRootSignature;
+		record(CallType_RootSignature);
+	}
+	void SetPipelineState(ID3D12PipelineState* pPipelineState) override
+	{
+		State.pPipelineState = pPipelineState;
+		record(CallType_PipelineState);
+	}
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology) override
+	{
+		State.Topology = primitiveTopology;
+		record(CallType_Topology);
+	}
+	void OMSetStencilRef(UINT stencilRef) override
+	{
+		State.StencilRef = stencilRef;
+		record(CallType_StencilRef);
+	}
+	void OMSetBlendFactor(const float blendFactor[4]) override
+	{
+		memcpy(State.pBlendFactor, blendFactor, sizeof(State.pBlendFactor));
+		record(CallType_BlendFactor);
+	}
+	void RSSetViewports(UINT numViewports, const D3D12_VIEWPORT* pViewports) override
+	{
+		memcpy(State.pViewports, pViewports, sizeof(D3D12_VIEWPORT) * numViewports);
+		State.ViewportCount = numViewports;
+		record(CallType_Viewports);
+	}
+	void RSSetScissorRects(UINT numRects, const D3D12_RECT* pRects) override
+	{
+		memcpy(State.pScissorRects, pRects, sizeof(D3D12_RECT) * numRects);
+		State.ScissorRectCount = numRects;
+		record(CallType_ScissorRects);
+	}
+	void SetGraphicsRootDescriptorTable(UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) override
+	{
+		CHECK(State.pRootSignature && rootParameterIndex < ROOT_ARGUMENT_COUNT);
+		State.pRootArguments[rootParameterIndex] = { CallType_RootDescriptorTable, baseDescriptor.ptr };
+		record(CallType_RootDescriptorTable);
+	}
+	void SetGraphicsRootConstantBufferView(UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation) override
+	{
+		CHECK(State.pRootSignature && rootParameterIndex < ROOT_ARGUMENT_COUNT);
+		State.pRootArguments[rootParameterIndex] = { CallType_RootConstantBufferView, bufferLocation };
+		record(CallType_RootConstantBufferView);
+	}
+
+private:
+	void record(UINT type)
+	{
+		++pCallCounts[type];
+		++CallCount;
+	}
+};
+
+static bool isSameState(const BoundState& A, const BoundState& B)
+{
+	if (A.HeapCount != B.HeapCount || memcmp(A.ppHeaps, B.ppHeaps, sizeof(ID3D12DescriptorHeap*) * A.HeapCount) != 0 ||
+		A.pRootSignature != B.pRootSignature || A.pPipelineState != B.pPipelineState || A.Topology != B.Topology ||
+		A.StencilRef != B.StencilRef || memcmp(A.pBlendFactor, B.pBlendFactor, sizeof(A.pBlendFactor)) != 0 ||
+		A.ViewportCount != B.ViewportCount || memcmp(A.pViewports, B.pViewports, sizeof(D3D12_VIEWPORT) * A.ViewportCount) != 0 ||
+		A.ScissorRectCount != B.ScissorRectCount || memcmp(A.pScissorRects, B.pScissorRects, sizeof(D3D12_RECT) * A.ScissorRectCount) != 0)
+	{
+		return false;
+	}
+	for (UINT i = 0; i < ROOT_ARGUMENT_COUNT; ++i)
+	{
+		if (A.pRootArguments[i].Type != B.pRootArguments[i].Type || A.pRootArguments[i].Value != B.pRootArguments[i].Value)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// fake objects. cache and mock only compare pointers.
+static ID3D12DescriptorHeap* getHeap(UINT index) { return (ID3D12DescriptorHeap*)(UINT_PTR)(0x1000 + index * 0x10); }
+static ID3D12RootSignature* getRootSignature(UINT index) { return (ID3D12RootSignature*)(UINT_PTR)(0x2000 + index * 0x10); }
+static ID3D12PipelineState* getPipelineState(UINT index) { return (ID3D12PipelineState*)(UINT_PTR)(0x3000 + index * 0x10); }
+
+static void testFilter()
+{
+	RecordingCommandList commandList;
+	CommandStateCache cache;
+	commandList.Open();
+	cache.Reset(&commandList);
+	CHECK(cache.GetCommandList() == &commandList);
+
+	const float BLEND_FACTOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+	const D3D12_VIEWPORT VIEWPORT = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+	const D3D12_RECT SCISSOR_RECT = { 0, 0, 1280, 720 };
+	ID3D12DescriptorHeap* ppHeaps[2] = { getHeap(0), getHeap(1) };
+
+	// each state set twice. second one is dropped.
+	for (int i = 0; i < 2; ++i)
+	{
+		cache.SetDescriptorHeaps(2, ppHeaps);
+		cache.SetGraphicsRootSignature(getRootSignature(0));
+		cache.SetPipelineState(getPipelineState(0));
+		cache.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		cache.OMSetStencilRef(0);
+		cache.OMSetBlendFactor(BLEND_FACTOR);
+		cache.RSSetViewports(1, &VIEWPORT);
+		cache.RSSetScissorRects(1, &SCISSOR_RECT);
+		cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+		cache.SetGraphicsRootConstantBufferView(6, 0x200);
+	}
+	for (UINT i = 0; i < CallType_Count; ++i)
+	{
+		CHECK(commandList.pCallCounts[i] == 1);
+	}
+	CHECK(cache.GetStats().IssuedCount == CallType_Count);
+	CHECK(cache.GetStats().FilteredCount == CallType_Count);
+
+	// stencil ref 0 is not assumed after Reset(), so first one is issued above. changed values are issued.
+	const float OTHER_BLEND_FACTOR[4] = { 0.5f, 0.5f, 0.5f, 0.0f };
+	const D3D12_VIEWPORT VIEWPORTS[2] = { VIEWPORT, VIEWPORT };
+	cache.SetPipelineState(getPipelineState(1));
+	cache.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+	cache.OMSetStencilRef(1);
+	cache.OMSetBlendFactor(OTHER_BLEND_FACTOR);
+	cache.RSSetViewports(2, VIEWPORTS);
+	cache.SetDescriptorHeaps(1, ppHeaps);
+	CHECK(commandList.CallCount == CallType_Count + 6);
+
+	// undefined topology is never taken as known.
+	cache.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_UNDEFINED);
+	cache.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_UNDEFINED);
+	CHECK(commandList.pCallCounts[CallType_Topology] == 4);
+}
+
+static void testRootArguments()
+{
+	RecordingCommandList commandList;
+	CommandStateCache cache;
+	commandList.Open();
+	cache.Reset(&commandList);
+
+	ID3D12DescriptorHeap* ppHeaps[2] = { getHeap(0), getHeap(1) };
+	cache.SetDescriptorHeaps(2, ppHeaps);
+	cache.SetGraphicsRootSignature(getRootSignature(0));
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 1);
+
+	// same value as other argument type is not same binding.
+	cache.SetGraphicsRootConstantBufferView(5, 0x100);
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	CHECK(commandList.pCallCounts[CallType_RootConstantBufferView] == 1);
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 2);
+
+	// same root signature again keeps arguments.
+	cache.SetGraphicsRootSignature(getRootSignature(0));
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	CHECK(commandList.pCallCounts[CallType_RootSignature] == 1);
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 2);
+
+	// other root signature drops them.
+	cache.SetGraphicsRootSignature(getRootSignature(1));
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 3);
+	CHECK(commandList.State.pRootArguments[5].Type == CallType_RootDescriptorTable);
+
+	// so do other heaps, since tables point into them.
+	ID3D12DescriptorHeap* ppOtherHeaps[2] = { getHeap(2), getHeap(1) };
+	cache.SetDescriptorHeaps(2, ppOtherHeaps);
+	cache.SetGraphicsRootDescriptorTable(5, { 0x100 });
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 4);
+
+	// arguments above limit of cache are always issued.
+	cache.SetGraphicsRootDescriptorTable(ROOT_ARGUMENT_COUNT - 1, { 0x300 });
+	cache.SetGraphicsRootDescriptorTable(ROOT_ARGUMENT_COUNT - 1, { 0x300 });
+	CHECK(commandList.pCallCounts[CallType_RootDescriptorTable] == 6);
+	CHECK(cache.GetStats().IssuedCount == commandList.CallCount);
+}
+
+// list reopened by D3D12 has no state. Reset() of cache forgets everything and clears stats.
+static void testReset()
+{
+	RecordingCommandList commandList;
+	CommandStateCache cache;
+	commandList.Open();
+	cache.Reset(&commandList);
+
+	cache.SetGraphicsRootSignature(getRootSignature(0));
+	cache.SetPipelineState(getPipelineState(0));
+	cache.OMSetStencilRef(1);
+	cache.SetGraphicsRootDescriptorTable(2, { 0x100 });
+	cache.SetPipelineState(getPipelineState(0));
+	CHECK(cache.GetStats().IssuedCount == 4 && cache.GetStats().FilteredCount == 1);
+
+	commandList.Open();
+	cache.Reset(&commandList);
+	CHECK(cache.GetStats().IssuedCount == 0 && cache.GetStats().FilteredCount == 0);
+
+	cache.SetGraphicsRootSignature(getRootSignature(0));
+	cache.SetPipelineState(getPipelineState(0));
+	cache.OMSetStencilRef(1);
+	cache.SetGraphicsRootDescriptorTable(2, { 0x100 });
+	CHECK(commandList.CallCount == 4);
+	CHECK(cache.GetStats().IssuedCount == 4 && cache.GetStats().FilteredCount == 0);
+
+	// other command list.
+	RecordingCommandList otherCommandList;
+	otherCommandList.Open();
+	cache.Reset(&otherCommandList);
+	CHECK(cache.GetCommandList() == &otherCommandList);
+	cache.SetPipelineState(getPipelineState(0));
+	CHECK(otherCommandList.CallCount == 1 && commandList.CallCount == 4);
+}
+
+// random calls with few distinct values, so many repeat. list behind cache must end in same state as list given
+// every call, after each call. reopening lists now and then.
+static void testFuzz()
+{
+	TestRandom random;
+	RecordingCommandList cachedList;
+	RecordingCommandList directList;
+	CommandStateCache cache;
+
+	const D3D12_PRIMITIVE_TOPOLOGY pTOPOLOGIES[3] = { D3D_PRIMITIVE_TOPOLOGY_UNDEFINED, D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST, D3D_PRIMITIVE_TOPOLOGY_LINELIST };
+	UINT directCallCount = 0;
+	UINT issuedCount = 0;
+	UINT filteredCount = 0;
+
+	for (int step = 0; step < 200000; ++step)
+	{
+		if (step % 500 == 0)
+		{
+			issuedCount += cache.GetStats().IssuedCount;
+			filteredCount += cache.GetStats().FilteredCount;
+			directCallCount += directList.CallCount;
+			CHECK(cache.GetStats().IssuedCount == cachedList.CallCount);
+			CHECK(cache.GetStats().IssuedCount + cache.GetStats().FilteredCount == directList.CallCount);
+
+			cachedList.Open();
+			directList.Open();
+			cache.Reset(&cachedList);
+		}
+
+		const UINT TYPE = random.NextUInt(CallType_Count);
+		switch (TYPE)
+		{
+			case CallType_DescriptorHeaps:
+			{
+				const UINT HEAP_COUNT = 1 + random.NextUInt(2);
+				ID3D12DescriptorHeap* ppHeaps[2] = { getHeap(random.NextUInt(2)), getHeap(2 + random.NextUInt(2)) };
+				cache.SetDescriptorHeaps(HEAP_COUNT, ppHeaps);
+				directList.SetDescriptorHeaps(HEAP_COUNT, ppHeaps);
+			}
+			break;
+
+			case CallType_RootSignature:
+			{
+				ID3D12RootSignature* pRootSignature = getRootSignature(random.NextUInt(3));
+				cache.SetGraphicsRootSignature(pRootSignature);
+				directList.SetGraphicsRootSignature(pRootSignature);
+			}
+			break;
+
+			case CallType_PipelineState:
+			{
+				ID3D12PipelineState* pPipelineState = getPipelineState(random.NextUInt(4));
+				cache.SetPipelineState(pPipelineState);
+				directList.SetPipelineState(pPipelineState);
+			}
+			break;
+
+			case CallType_Topology:
+			{
+				const D3D12_PRIMITIVE_TOPOLOGY TOPOLOGY = pTOPOLOGIES[random.NextUInt(3)];
+				cache.IASetPrimitiveTopology(TOPOLOGY);
+				directList.IASetPrimitiveTopology(TOPOLOGY);
+			}
+			break;
+
+			case CallType_StencilRef:
+			{
+				const UINT STENCIL_REF = random.NextUInt(2);
+				cache.OMSetStencilRef(STENCIL_REF);
+				directList.OMSetStencilRef(STENCIL_REF);
+			}
+			break;
+
+			case CallType_BlendFactor:
+			{
+				const float BLEND_FACTOR[4] = { 0.5f, 0.5f, 0.5f, (float)random.NextUInt(2) };
+				cache.OMSetBlendFactor(BLEND_FACTOR);
+				directList.OMSetBlendFactor(BLEND_FACTOR);
+			}
+			break;
+
+			case CallType_Viewports:
+			{
+				const UINT COUNT = 1 + random.NextUInt(3);
+				D3D12_VIEWPORT pViewports[3];
+				for (UINT i = 0; i < COUNT; ++i)
+				{
+					pViewports[i] = { 0.0f, 0.0f, (float)(512 << random.NextUInt(2)), 512.0f, 0.0f, 1.0f };
+				}
+				cache.RSSetViewports(COUNT, pViewports);
+				directList.RSSetViewports(COUNT, pViewports);
+			}
+			break;
+
+			case CallType_ScissorRects:
+			{
+				const UINT COUNT = 1 + random.NextUInt(3);
+				D3D12_RECT pRects[3];
+				for (UINT i = 0; i < COUNT; ++i)
+				{
+					pRects[i] = { 0, 0, (LONG)(512 << random.NextUInt(2)), 512 };
+				}
+				cache.RSSetScissorRects(COUNT, pRects);
+				directList.RSSetScissorRects(COUNT, pRects);
+			}
+			break;
+
+			default:
+			{
+				// root arguments need root signature bound.
+				if (!directList.State.pRootSignature)
+				{
+					break;
+				}
+				const UINT INDEX = (random.NextUInt(8) == 0 ? 16 + random.NextUInt(ROOT_ARGUMENT_COUNT - 16) : random.NextUInt(8));
+				const UINT64 VALUE = 0x100 * (1 + random.NextUInt(3));
+				if (TYPE == CallType_RootDescriptorTable)
+				{
+					cache.SetGraphicsRootDescriptorTable(INDEX, { VALUE });
+					directList.SetGraphicsRootDescriptorTable(INDEX, { VALUE });
+				}
+				else
+				{
+					cache.SetGraphicsRootConstantBufferView(INDEX, VALUE);
+					directList.SetGraphicsRootConstantBufferView(INDEX, VALUE);
+				}
+			}
+			break;
+		}
+
+		CHECK(isSameState(cachedList.State, directList.State));
+	}
+
+	// most repeats are caught.
+	CHECK(filteredCount > directCallCount / 10);
+	CHECK(issuedCount + filteredCount == directCallCount);
+}
+
+int main()
+{
+	testFilter();
+	testRootArguments();
+	testReset();
+	testFuzz();
+
+	return TEST_RESULT();
+}
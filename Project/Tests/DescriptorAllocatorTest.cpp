@@ -0,0 +1,217 @@
+#include "../pch.h"
+#include "../Util/DescriptorAllocator.h"
+#include "TestCommon.h"
+
+#include <map>
+#include <set>
+
+static void testBasic()
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(70, 16);
+	CHECK(allocator.GetPageSize() == 16);
+	CHECK(allocator.GetBlockSize(1) == 1);
+	CHECK(allocator.GetBlockSize(3) == 4);
+	CHECK(allocator.GetBlockSize(16) == 16);
+
+	// blocks are handed out in address order within page.
+	const UINT A = allocator.Alloc(3);
+	const UINT B = allocator.Alloc(4);
+	CHECK(A % 16 == 0 && B == A + 4);
+	CHECK(allocator.GetStats().AllocatedCount == 8);
+	CHECK(allocator.GetStats().PageCount == 1);
+
+	// other size class takes other page.
+	const UINT C = allocator.Alloc(1);
+	CHECK(C / 16 != A / 16);
+	CHECK(allocator.GetStats().PageCount == 2);
+
+	// larger than page fails.
+	CHECK(allocator.Alloc(17) == DESCRIPTOR_ALLOCATOR_INVALID_OFFSET);
+	CHECK(allocator.GetStats().FailCount == 1);
+
+	allocator.Free(A);
+	allocator.Free(B);
+	allocator.Free(C);
+	CHECK(allocator.GetStats().AllocatedCount == 0);
+	CHECK(allocator.GetStats().PeakCount == 9);
+
+	// freeing block twice breaks and changes nothing.
+	const LONG BREAK_COUNT = g_HeadlessDebugBreakCount;
+	allocator.Free(C);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 1);
+	CHECK(allocator.GetStats().AllocatedCount == 0);
+
+	allocator.Cleanup();
+	CHECK(allocator.GetPageSize() == 0);
+}
+
+// alloc and free around page boundary must not give page back and split it again every time.
+static void testKeptPage()
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(64, 16);
+
+	const UINT OFFSET = allocator.Alloc(1);
+	allocator.Free(OFFSET);
+	CHECK(allocator.GetStats().PageCount == 1);
+	for (int i = 0; i < 100; ++i)
+	{
+		CHECK(allocator.Alloc(1) == OFFSET);
+		allocator.Free(OFFSET);
+	}
+	CHECK(allocator.GetStats().PageCount == 1);
+
+	// second empty page of same class goes back.
+	UINT pOffsets[5] = {};
+	for (UINT i = 0; i < 5; ++i)
+	{
+		pOffsets[i] = allocator.Alloc(4);
+	}
+	CHECK(allocator.GetStats().PageCount == 3);
+	allocator.Free(pOffsets[4]);
+	CHECK(allocator.GetStats().PageCount == 3);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		allocator.Free(pOffsets[i]);
+	}
+	CHECK(allocator.GetStats().PageCount == 2);
+
+	// kept page is reused, not new one.
+	const UINT REUSED = allocator.Alloc(4);
+	CHECK(REUSED / 16 == pOffsets[0] / 16 || REUSED / 16 == pOffsets[4] / 16);
+	CHECK(allocator.GetStats().PageCount == 2);
+	allocator.Free(REUSED);
+}
+
+// empty pages kept by other classes go back when some class finds no page.
+static void testKeptPagePressure()
+{
+	DescriptorAllocator allocator;
+	allocator.Initialize(64, 16);
+
+	allocator.Free(allocator.Alloc(1));
+	allocator.Free(allocator.Alloc(2));
+	CHECK(allocator.GetStats().PageCount == 2);
+
+	UINT pOffsets[4] = {};
+	for (UINT i = 0; i < 4; ++i)
+	{
+		pOffsets[i] = allocator.Alloc(16);
+		CHECK(pOffsets[i] != DESCRIPTOR_ALLOCATOR_INVALID_OFFSET);
+	}
+	CHECK(allocator.GetStats().PageCount == 4);
+	CHECK(allocator.GetStats().FailCount == 0);
+
+	CHECK(allocator.Alloc(1) == DESCRIPTOR_ALLOCATOR_INVALID_OFFSET);
+	CHECK(allocator.GetStats().FailCount == 1);
+
+	for (UINT i = 0; i < 4; ++i)
+	{
+		allocator.Free(pOffsets[i]);
+	}
+	CHECK(allocator.GetStats().PageCount == 1);
+}
+
+// random alloc and free against model of live blocks. blocks must not overlap, and alloc fails only
+// when every page holds live blocks and pages of requested class are full.
+static void testFuzz()
+{
+	const UINT PAGE_SIZE = 32;
+	const UINT PAGE_COUNT = 16;
+	DescriptorAllocator allocator;
+	allocator.Initialize(PAGE_COUNT * PAGE_SIZE, PAGE_SIZE);
+
+	TestRandom random;
+	std::map<UINT, UINT> liveBlocks; // offset -> block size.
+	UINT allocatedCount = 0;
+	UINT failCount = 0;
+
+	for (int step = 0; step < 200000; ++step)
+	{
+		const bool bFILLING = ((step / 3000) % 2 == 0);
+		if (liveBlocks.empty() || random.NextUInt(10) < (bFILLING ? 7u : 3u))
+		{
+			const UINT COUNT = 1 + random.NextUInt(random.NextUInt(4) == 0 ? PAGE_SIZE : 4);
+			const UINT BLOCK_SIZE = allocator.GetBlockSize(COUNT);
+			const UINT OFFSET = allocator.Alloc(COUNT);
+			if (OFFSET == DESCRIPTOR_ALLOCATOR_INVALID_OFFSET)
+			{
+				std::map<UINT, UINT> usedBlocksPerPage;
+				std::set<UINT> classPages;
+				for (std::map<UINT, UINT>::iterator iter = liveBlocks.begin(); iter != liveBlocks.end(); ++iter)
+				{
+					++usedBlocksPerPage[iter->first / PAGE_SIZE];
+					if (iter->second == BLOCK_SIZE)
+					{
+						classPages.insert(iter->first / PAGE_SIZE);
+					}
+				}
+				CHECK(usedBlocksPerPage.size() == PAGE_COUNT);
+				for (std::set<UINT>::iterator iter = classPages.begin(); iter != classPages.end(); ++iter)
+				{
+					CHECK(usedBlocksPerPage[*iter] == PAGE_SIZE / BLOCK_SIZE);
+				}
+				++failCount;
+				continue;
+			}
+
+			CHECK(OFFSET % BLOCK_SIZE == 0);
+			CHECK(OFFSET + BLOCK_SIZE <= PAGE_COUNT * PAGE_SIZE);
+			std::map<UINT, UINT>::iterator next = liveBlocks.lower_bound(OFFSET);
+			if (next != liveBlocks.end())
+			{
+				CHECK(next->first >= OFFSET + BLOCK_SIZE);
+			}
+			if (next != liveBlocks.begin())
+			{
+				std::map<UINT, UINT>::iterator prev = next;
+				--prev;
+				CHECK(prev->first + prev->second <= OFFSET);
+			}
+			liveBlocks[OFFSET] = BLOCK_SIZE;
+			allocatedCount += BLOCK_SIZE;
+		}
+		else
+		{
+			std::map<UINT, UINT>::iterator iter = liveBlocks.begin();
+			std::advance(iter, random.NextUInt((UINT)liveBlocks.size()));
+			allocator.Free(iter->first);
+			allocatedCount -= iter->second;
+			liveBlocks.erase(iter);
+		}
+
+		CHECK(allocator.GetStats().AllocatedCount == allocatedCount);
+		// pages with live blocks plus at most one kept page per class.
+		CHECK(allocator.GetStats().PageCount <= PAGE_COUNT);
+		if (step % 64 == 0)
+		{
+			std::set<UINT> usedPages;
+			for (std::map<UINT, UINT>::iterator iter = liveBlocks.begin(); iter != liveBlocks.end(); ++iter)
+			{
+				usedPages.insert(iter->first / PAGE_SIZE);
+			}
+			CHECK(allocator.GetStats().PageCount >= (UINT)usedPages.size());
+			CHECK(allocator.GetStats().PageCount <= (UINT)usedPages.size() + 6);
+		}
+	}
+
+	while (!liveBlocks.empty())
+	{
+		allocator.Free(liveBlocks.begin()->first);
+		liveBlocks.erase(liveBlocks.begin());
+	}
+	CHECK(allocator.GetStats().AllocatedCount == 0);
+	CHECK(allocator.GetStats().PageCount <= 6);
+	CHECK(failCount > 0);
+}
+
+int main()
+{
+	testBasic();
+	testKeptPage();
+	testKeptPagePressure();
+	testFuzz();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,206 @@
+#include "../pch.h"
+#include "../Util/DescriptorTableCache.h"
+#include "TestCommon.h"
+
+// handles are fake values, cache only compares and hashes them.
+
+static void testHitMiss()
+{
+	DescriptorTableCache cache;
+	cache.Initialize(8);
+
+	const UINT64 pA[] = { 0x1000, 0x1020, 0x1040 };
+	const UINT64 pREORDERED[] = { 0x1040, 0x1020, 0x1000 };
+	UINT slot = 0;
+	UINT otherSlot = 0;
+
+	CHECK(!cache.Lookup(pA, 3, &slot));
+	CHECK(slot < 8);
+	CHECK(cache.Lookup(pA, 3, &otherSlot) && otherSlot == slot);
+
+	// order and count are part of key.
+	CHECK(!cache.Lookup(pREORDERED, 3, &otherSlot) && otherSlot != slot && otherSlot < 8);
+	CHECK(!cache.Lookup(pA, 2, &otherSlot) && otherSlot != slot && otherSlot < 8);
+	CHECK(cache.Lookup(pA, 2, &otherSlot));
+
+	const DescriptorTableCacheStats& STATS = cache.GetStats();
+	CHECK(STATS.EntryCount == 3);
+	CHECK(STATS.HitCount == 2);
+	CHECK(STATS.MissCount == 3);
+	CHECK(STATS.EvictCount == 0);
+
+	cache.BeginFrame();
+	CHECK(STATS.LastFrameHitCount == 2 && STATS.LastFrameMissCount == 3);
+	CHECK(STATS.HitCount == 0 && STATS.MissCount == 0);
+
+	// entries survive frames.
+	CHECK(cache.Lookup(pA, 3, &otherSlot) && otherSlot == slot);
+	CHECK(STATS.EntryCount == 3);
+}
+
+// slot used in current frame is never handed out again until BeginFrame().
+static void testFramePinning()
+{
+	DescriptorTableCache cache;
+	cache.Initialize(4);
+
+	UINT64 pHandles[1] = {};
+	UINT pSlots[4] = {};
+	for (UINT i = 0; i < 4; ++i)
+	{
+		pHandles[0] = 100 + i;
+		CHECK(!cache.Lookup(pHandles, 1, &pSlots[i]));
+		for (UINT j = 0; j < i; ++j)
+		{
+			CHECK(pSlots[j] != pSlots[i]);
+		}
+	}
+
+	pHandles[0] = 200;
+	UINT slot = 0;
+	CHECK(!cache.Lookup(pHandles, 1, &slot) && slot == UINT_MAX);
+	CHECK(cache.GetStats().MissCount == 5);
+	CHECK(cache.GetStats().EvictCount == 0);
+
+	// entries of this frame still hit.
+	pHandles[0] = 102;
+	CHECK(cache.Lookup(pHandles, 1, &slot) && slot == pSlots[2]);
+
+	cache.BeginFrame();
+	pHandles[0] = 200;
+	CHECK(!cache.Lookup(pHandles, 1, &slot) && slot < 4);
+	CHECK(cache.GetStats().EvictCount == 1);
+	CHECK(cache.GetStats().EntryCount == 4);
+
+	// Invalidate() forgets entries but keeps this frame's slots pinned.
+	cache.Invalidate();
+	CHECK(cache.GetStats().EntryCount == 0);
+	UINT newSlot = 0;
+	CHECK(!cache.Lookup(pHandles, 1, &newSlot) && newSlot != slot && newSlot < 4);
+	pHandles[0] = 102;
+	CHECK(!cache.Lookup(pHandles, 1, &newSlot) && newSlot != slot && newSlot < 4);
+}
+
+static void testEviction()
+{
+	DescriptorTableCache cache;
+	cache.Initialize(4);
+
+	UINT64 pHandles[2] = { 0, 7 };
+	UINT pSlots[4] = {};
+	for (UINT i = 0; i < 4; ++i)
+	{
+		pHandles[0] = i;
+		cache.Lookup(pHandles, 2, &pSlots[i]);
+	}
+
+	// 0 and 2 used in frame 2, 1 and 3 are left from frame 1.
+	cache.BeginFrame();
+	UINT slot = 0;
+	pHandles[0] = 0;
+	CHECK(cache.Lookup(pHandles, 2, &slot));
+	pHandles[0] = 2;
+	CHECK(cache.Lookup(pHandles, 2, &slot));
+
+	// least recently used go first.
+	cache.BeginFrame();
+	pHandles[0] = 10;
+	CHECK(!cache.Lookup(pHandles, 2, &slot) && (slot == pSlots[1] || slot == pSlots[3]));
+	const UINT FIRST_EVICTED = slot;
+	pHandles[0] = 11;
+	CHECK(!cache.Lookup(pHandles, 2, &slot) && (slot == pSlots[1] || slot == pSlots[3]) && slot != FIRST_EVICTED);
+	CHECK(cache.GetStats().EvictCount == 2);
+
+	pHandles[0] = 0;
+	CHECK(cache.Lookup(pHandles, 2, &slot) && slot == pSlots[0]);
+	pHandles[0] = 2;
+	CHECK(cache.Lookup(pHandles, 2, &slot) && slot == pSlots[2]);
+	pHandles[0] = 1;
+	CHECK(!cache.Lookup(pHandles, 2, &slot) && slot == UINT_MAX);
+	CHECK(cache.GetStats().EntryCount == 4);
+
+	// empty slot is taken before any old entry.
+	DescriptorTableCache emptyCache;
+	emptyCache.Initialize(3);
+	pHandles[0] = 1;
+	emptyCache.Lookup(pHandles, 2, &slot);
+	emptyCache.BeginFrame();
+	pHandles[0] = 2;
+	CHECK(!emptyCache.Lookup(pHandles, 2, &slot));
+	CHECK(emptyCache.GetStats().EvictCount == 0);
+}
+
+// random lookups against model of slot contents.
+static void testFuzz()
+{
+	const UINT SLOT_COUNT = 64;
+	DescriptorTableCache cache;
+	cache.Initialize(SLOT_COUNT);
+
+	TestRandom random;
+	std::vector<std::vector<UINT64>> slotContents(SLOT_COUNT);
+	std::vector<bool> usedThisFrame(SLOT_COUNT, false);
+	UINT usedCount = 0;
+	UINT hitCount = 0;
+	UINT fullCount = 0;
+
+	for (int step = 0; step < 200000; ++step)
+	{
+		if (random.NextUInt(100) == 0)
+		{
+			cache.BeginFrame();
+			usedThisFrame.assign(SLOT_COUNT, false);
+			usedCount = 0;
+		}
+
+		// small handle space, so lists repeat.
+		std::vector<UINT64> handles(1 + random.NextUInt(DESCRIPTOR_TABLE_CACHE_SLOT_SIZE));
+		for (UINT64 i = 0, size = handles.size(); i < size; ++i)
+		{
+			handles[i] = 0x10000 + random.NextUInt(6) * 32;
+		}
+
+		UINT slot = 0;
+		if (cache.Lookup(handles.data(), (UINT)handles.size(), &slot))
+		{
+			CHECK(slot < SLOT_COUNT && slotContents[slot] == handles);
+			++hitCount;
+		}
+		else if (slot == UINT_MAX)
+		{
+			CHECK(usedCount == SLOT_COUNT);
+			++fullCount;
+			continue;
+		}
+		else
+		{
+			CHECK(slot < SLOT_COUNT);
+			CHECK(!usedThisFrame[slot]);
+			// entry must not exist anywhere else.
+			for (UINT i = 0; i < SLOT_COUNT; ++i)
+			{
+				CHECK(slotContents[i] != handles);
+			}
+			slotContents[slot] = handles;
+		}
+
+		if (!usedThisFrame[slot])
+		{
+			usedThisFrame[slot] = true;
+			++usedCount;
+		}
+	}
+
+	CHECK(hitCount > 10000);
+	CHECK(fullCount > 0);
+}
+
+int main()
+{
+	testHitMiss();
+	testFramePinning();
+	testEviction();
+	testFuzz();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// DirectXCollision subset used by headless modules.
+// CreateFromPoints returns a bounding sphere around the centroid, which is looser than DirectXMath's but still contains all points.
+// BoundingFrustum supports identity orientation only. it looks down +z from Origin.
+
+#include <directxtk12/SimpleMath.h>
+
+namespace DirectX
+{
+	enum ContainmentType
+	{
+		DISJOINT = 0,
+		INTERSECTS = 1,
+		CONTAINS = 2,
+	};
+
+	struct BoundingSphere
+	{
+		XMFLOAT3 Center;
+		float Radius;
+
+		BoundingSphere() : Center{ 0.0f, 0.0f, 0.0f }, Radius(1.0f) {}
+		BoundingSphere(const XMFLOAT3& center, float radius) : Center(center), Radius(radius) {}
+
+		static void CreateFromPoints(BoundingSphere& out, size_t count, const XMFLOAT3* pPoints, size_t stride)
+		{
+			SimpleMath::Vector3 center(0.0f);
+			for (size_t i = 0; i < count; ++i)
+			{
+				center += *(const XMFLOAT3*)((const char*)pPoints + i * stride);
+			}
+			center /= (float)(count > 0 ? count : 1);
+
+			float radiusSq = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+			{
+				SimpleMath::Vector3 toPoint = SimpleMath::Vector3(*(const XMFLOAT3*)((const char*)pPoints + i * stride)) - center;
+				radiusSq = fmaxf(radiusSq, toPoint.LengthSquared());
+			}
+
+			out.Center = center;
+			out.Radius = sqrtf(radiusSq);
+		}
+	};
+
+	struct BoundingFrustum
+	{
+		XMFLOAT3 Origin;
+		XMFLOAT4 Orientation;
+		float RightSlope;
+		float LeftSlope;
+		float TopSlope;
+		float BottomSlope;
+		float Near;
+		float Far;
+
+		BoundingFrustum() : Origin{ 0.0f, 0.0f, 0.0f }, Orientation{ 0.0f, 0.0f, 0.0f, 1.0f }, RightSlope(1.0f), LeftSlope(-1.0f), TopSlope(1.0f), BottomSlope(-1.0f), Near(0.0f), Far(1.0f) {}
+
+		ContainmentType Contains(const BoundingSphere& SPHERE) const
+		{
+			const SimpleMath::Vector3 CENTER = SimpleMath::Vector3(SPHERE.Center) - SimpleMath::Vector3(Origin);
+
+			// planes as (normal, offset) with inside where dot(normal, p) <= offset.
+			const float PLANES[6][4] =
+			{
+				{ 0.0f, 0.0f, -1.0f, -Near },
+				{ 0.0f, 0.0f, 1.0f, Far },
+				{ 1.0f, 0.0f, -RightSlope, 0.0f },
+				{ -1.0f, 0.0f, LeftSlope, 0.0f },
+				{ 0.0f, 1.0f, -TopSlope, 0.0f },
+				{ 0.0f, -1.0f, BottomSlope, 0.0f },
+			};
+
+			bool bInside = true;
+			for (int i = 0; i < 6; ++i)
+			{
+				SimpleMath::Vector3 normal(PLANES[i][0], PLANES[i][1], PLANES[i][2]);
+				const float LENGTH = normal.Length();
+				const float DISTANCE = (normal.Dot(CENTER) - PLANES[i][3]) / LENGTH;
+				if (DISTANCE > SPHERE.Radius)
+				{
+					return DISJOINT;
+				}
+				if (DISTANCE > -SPHERE.Radius)
+				{
+					bInside = false;
+				}
+			}
+
+			return (bInside ? CONTAINS : INTERSECTS);
+		}
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// DirectXPackedVector subset used by headless modules. half conversion through compiler's _Float16.
+
+#include <string.h>
+
+namespace DirectX
+{
+	namespace PackedVector
+	{
+		typedef unsigned short HALF;
+
+		inline HALF XMConvertFloatToHalf(float value)
+		{
+			_Float16 half = (_Float16)value;
+			HALF bits;
+			memcpy(&bits, &half, sizeof(bits));
+			return bits;
+		}
+		inline float XMConvertHalfToFloat(HALF value)
+		{
+			_Float16 half;
+			memcpy(&half, &value, sizeof(half));
+			return (float)half;
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// DirectXTex subset used by Graphics/TextureCompressor.cpp. see HeadlessDirectXTex.cpp
+// BC1, BC3, BC4 and BC5 with a plain bounding box encoder, so PSNR is lower than real DirectXTex.
+// BC7 and DDS files return E_NOTIMPL.
+
+#define E_NOTIMPL ((HRESULT)0x80004001)
+
+namespace DirectX
+{
+	enum TEX_DIMENSION
+	{
+		TEX_DIMENSION_TEXTURE1D = 2,
+		TEX_DIMENSION_TEXTURE2D = 3,
+		TEX_DIMENSION_TEXTURE3D = 4,
+	};
+	enum TEX_COMPRESS_FLAGS : unsigned long
+	{
+		TEX_COMPRESS_DEFAULT = 0,
+		TEX_COMPRESS_UNIFORM = 0x40000,
+		TEX_COMPRESS_BC7_QUICK = 0x100000,
+	};
+	enum DDS_FLAGS : unsigned long
+	{
+		DDS_FLAGS_NONE = 0,
+	};
+	static const float TEX_THRESHOLD_DEFAULT = 0.5f;
+
+	struct Image
+	{
+		size_t width;
+		size_t height;
+		DXGI_FORMAT format;
+		size_t rowPitch;
+		size_t slicePitch;
+		uint8_t* pixels;
+	};
+
+	struct TexMetadata
+	{
+		size_t width;
+		size_t height;
+		size_t depth;
+		size_t arraySize;
+		size_t mipLevels;
+		uint32_t miscFlags;
+		uint32_t miscFlags2;
+		DXGI_FORMAT format;
+		TEX_DIMENSION dimension;
+	};
+
+	// single image only.
+	class ScratchImage
+	{
+	public:
+		void Initialize(const size_t WIDTH, const size_t HEIGHT, const DXGI_FORMAT FORMAT, const size_t ROW_PITCH, const size_t ROW_COUNT);
+
+		inline uint8_t* GetPixels() const { return m_Image.pixels; }
+		inline size_t GetPixelsSize() const { return m_Pixels.size(); }
+		inline const Image* GetImage(size_t mip, size_t item, size_t slice) const { return (mip == 0 && item == 0 && slice == 0 ? &m_Image : nullptr); }
+
+	private:
+		std::vector<uint8_t> m_Pixels;
+		Image m_Image = {};
+	};
+
+	HRESULT Compress(const Image& SRC_IMAGE, DXGI_FORMAT format, TEX_COMPRESS_FLAGS compress, float threshold, ScratchImage& image);
+	HRESULT Decompress(const Image& C_IMAGE, DXGI_FORMAT format, ScratchImage& image);
+
+	HRESULT LoadFromDDSFile(const wchar_t* pszFileName, DDS_FLAGS flags, TexMetadata* pMetadata, ScratchImage& image);
+	HRESULT SaveToDDSFile(const Image* pImages, size_t imageCount, const TexMetadata& METADATA, DDS_FLAGS flags, const wchar_t* pszFileName);
+}
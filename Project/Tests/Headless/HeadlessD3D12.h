@@ -0,0 +1,377 @@
+#pragma once
+
+// D3D12 and DXGI names seen by headless modules. interfaces have virtual no-op methods, tests derive mocks
+// from them and override what module under test calls. layouts and values follow d3d12.h where it matters.
+
+struct IDXGIFactory2;
+struct IDXGIAdapter1;
+struct ID3DBlob;
+struct D3D_SHADER_MACRO;
+struct D3D12_SHADER_RESOURCE_VIEW_DESC;
+struct D3D12_CLEAR_VALUE;
+struct D3D12_BOX;
+struct ID3D12PipelineState;
+struct ID3D12RootSignature;
+struct ID3D12DescriptorHeap;
+
+// values match dxgiformat.h.
+enum DXGI_FORMAT
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+	DXGI_FORMAT_R16G16B16A16_FLOAT = 10,
+	DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+	DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+	DXGI_FORMAT_R32_FLOAT = 41,
+	DXGI_FORMAT_R32_SINT = 43,
+	DXGI_FORMAT_R16_FLOAT = 54,
+	DXGI_FORMAT_BC1_UNORM = 71,
+	DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+	DXGI_FORMAT_BC3_UNORM = 77,
+	DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+	DXGI_FORMAT_BC4_UNORM = 80,
+	DXGI_FORMAT_BC5_UNORM = 83,
+	DXGI_FORMAT_BC7_UNORM = 98,
+	DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+};
+
+struct DXGI_SAMPLE_DESC
+{
+	UINT Count;
+	UINT Quality;
+};
+
+// interface ids are not checked. IID_PPV_ARGS only passes output pointer.
+typedef const void* REFIID;
+#define IID_PPV_ARGS(ppType) nullptr, reinterpret_cast<void**>(ppType)
+
+enum D3D12_RESOURCE_STATES
+{
+	D3D12_RESOURCE_STATE_COMMON = 0,
+	D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1,
+	D3D12_RESOURCE_STATE_INDEX_BUFFER = 0x2,
+	D3D12_RESOURCE_STATE_RENDER_TARGET = 0x4,
+	D3D12_RESOURCE_STATE_UNORDERED_ACCESS = 0x8,
+	D3D12_RESOURCE_STATE_DEPTH_WRITE = 0x10,
+	D3D12_RESOURCE_STATE_DEPTH_READ = 0x20,
+	D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE = 0x40,
+	D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE = 0x80,
+	D3D12_RESOURCE_STATE_COPY_DEST = 0x400,
+	D3D12_RESOURCE_STATE_COPY_SOURCE = 0x800,
+	D3D12_RESOURCE_STATE_GENERIC_READ = 0xac3,
+	D3D12_RESOURCE_STATE_PRESENT = 0,
+};
+enum D3D12_HEAP_TYPE
+{
+	D3D12_HEAP_TYPE_DEFAULT = 1,
+	D3D12_HEAP_TYPE_UPLOAD = 2,
+	D3D12_HEAP_TYPE_READBACK = 3,
+};
+enum D3D12_HEAP_FLAGS
+{
+	D3D12_HEAP_FLAG_NONE = 0,
+};
+enum D3D12_RESOURCE_DIMENSION
+{
+	D3D12_RESOURCE_DIMENSION_UNKNOWN = 0,
+	D3D12_RESOURCE_DIMENSION_BUFFER = 1,
+	D3D12_RESOURCE_DIMENSION_TEXTURE2D = 3,
+};
+enum D3D12_TEXTURE_LAYOUT
+{
+	D3D12_TEXTURE_LAYOUT_UNKNOWN = 0,
+	D3D12_TEXTURE_LAYOUT_ROW_MAJOR = 1,
+};
+enum D3D12_RESOURCE_FLAGS
+{
+	D3D12_RESOURCE_FLAG_NONE = 0,
+};
+enum D3D12_COMMAND_LIST_TYPE
+{
+	D3D12_COMMAND_LIST_TYPE_DIRECT = 0,
+	D3D12_COMMAND_LIST_TYPE_COPY = 3,
+};
+enum D3D12_RESOURCE_BARRIER_TYPE
+{
+	D3D12_RESOURCE_BARRIER_TYPE_TRANSITION = 0,
+};
+enum D3D12_RESOURCE_BARRIER_FLAGS
+{
+	D3D12_RESOURCE_BARRIER_FLAG_NONE = 0,
+};
+enum D3D12_TEXTURE_COPY_TYPE
+{
+	D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX = 0,
+	D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT = 1,
+};
+
+// values match d3dcommon.h.
+enum D3D_PRIMITIVE_TOPOLOGY
+{
+	D3D_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+	D3D_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+	D3D_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+	D3D_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+};
+typedef D3D_PRIMITIVE_TOPOLOGY D3D12_PRIMITIVE_TOPOLOGY;
+
+#define D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES 0xffffffff
+#define D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE 16
+#define D3D12_TEXTURE_DATA_PITCH_ALIGNMENT 256
+#define D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT 512
+#define D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT 256
+
+struct D3D12_HEAP_PROPERTIES
+{
+	D3D12_HEAP_TYPE Type;
+	UINT CPUPageProperty;
+	UINT MemoryPoolPreference;
+	UINT CreationNodeMask;
+	UINT VisibleNodeMask;
+};
+
+struct D3D12_RESOURCE_DESC
+{
+	D3D12_RESOURCE_DIMENSION Dimension;
+	UINT64 Alignment;
+	UINT64 Width;
+	UINT Height;
+	USHORT DepthOrArraySize;
+	USHORT MipLevels;
+	DXGI_FORMAT Format;
+	DXGI_SAMPLE_DESC SampleDesc;
+	D3D12_TEXTURE_LAYOUT Layout;
+	D3D12_RESOURCE_FLAGS Flags;
+};
+
+struct D3D12_RANGE
+{
+	SIZE_T Begin;
+	SIZE_T End;
+};
+
+struct D3D12_CPU_DESCRIPTOR_HANDLE
+{
+	SIZE_T ptr;
+};
+struct D3D12_GPU_DESCRIPTOR_HANDLE
+{
+	UINT64 ptr;
+};
+
+typedef UINT64 D3D12_GPU_VIRTUAL_ADDRESS;
+
+struct D3D12_VIEWPORT
+{
+	float TopLeftX;
+	float TopLeftY;
+	float Width;
+	float Height;
+	float MinDepth;
+	float MaxDepth;
+};
+struct D3D12_RECT
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+};
+
+struct ID3D12Resource;
+
+struct D3D12_RESOURCE_TRANSITION_BARRIER
+{
+	ID3D12Resource* pResource;
+	UINT Subresource;
+	D3D12_RESOURCE_STATES StateBefore;
+	D3D12_RESOURCE_STATES StateAfter;
+};
+struct D3D12_RESOURCE_BARRIER
+{
+	D3D12_RESOURCE_BARRIER_TYPE Type;
+	D3D12_RESOURCE_BARRIER_FLAGS Flags;
+	D3D12_RESOURCE_TRANSITION_BARRIER Transition;
+};
+
+struct D3D12_SUBRESOURCE_FOOTPRINT
+{
+	DXGI_FORMAT Format;
+	UINT Width;
+	UINT Height;
+	UINT Depth;
+	UINT RowPitch;
+};
+struct D3D12_PLACED_SUBRESOURCE_FOOTPRINT
+{
+	UINT64 Offset;
+	D3D12_SUBRESOURCE_FOOTPRINT Footprint;
+};
+struct D3D12_TEXTURE_COPY_LOCATION
+{
+	ID3D12Resource* pResource;
+	D3D12_TEXTURE_COPY_TYPE Type;
+	union
+	{
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT PlacedFootprint;
+		UINT SubresourceIndex;
+	};
+};
+
+// interfaces. refcount deletes object at zero, so mocks given to modules that Release() them must be heap allocated.
+struct IUnknown
+{
+	volatile LONG RefCount = 1;
+
+	virtual ~IUnknown() = default;
+	virtual ULONG AddRef() { return (ULONG)InterlockedIncrement(&RefCount); }
+	virtual ULONG Release()
+	{
+		LONG refCount = InterlockedDecrement(&RefCount);
+		if (refCount == 0)
+		{
+			delete this;
+		}
+		return (ULONG)refCount;
+	}
+};
+
+struct ID3D12Object : public IUnknown
+{
+	virtual HRESULT SetName(const WCHAR* pszName) { return S_OK; }
+};
+
+struct ID3D12Resource : public ID3D12Object
+{
+	virtual HRESULT Map(UINT subresource, const D3D12_RANGE* pReadRange, void** ppData) { return E_FAIL; }
+	virtual void Unmap(UINT subresource, const D3D12_RANGE* pWrittenRange) {}
+	virtual D3D12_RESOURCE_DESC GetDesc() { return D3D12_RESOURCE_DESC{}; }
+	virtual UINT64 GetGPUVirtualAddress() { return 0; }
+};
+
+struct ID3D12CommandAllocator : public ID3D12Object
+{
+	virtual HRESULT Reset() { return S_OK; }
+};
+
+struct ID3D12Fence : public ID3D12Object
+{
+	virtual UINT64 GetCompletedValue() { return 0; }
+	virtual HRESULT SetEventOnCompletion(UINT64 value, HANDLE hEvent) { return E_FAIL; }
+};
+
+struct ID3D12CommandList : public ID3D12Object
+{
+};
+
+struct ID3D12GraphicsCommandList : public ID3D12CommandList
+{
+	virtual HRESULT Close() { return S_OK; }
+	virtual HRESULT Reset(ID3D12CommandAllocator* pAllocator, ID3D12PipelineState* pInitialState) { return S_OK; }
+	virtual void ResourceBarrier(UINT numBarriers, const D3D12_RESOURCE_BARRIER* pBarriers) {}
+	virtual void CopyBufferRegion(ID3D12Resource* pDstBuffer, UINT64 dstOffset, ID3D12Resource* pSrcBuffer, UINT64 srcOffset, UINT64 numBytes) {}
+	virtual void CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* pDst, UINT dstX, UINT dstY, UINT dstZ, const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX* pSrcBox) {}
+	virtual void SetDescriptorHeaps(UINT numDescriptorHeaps, ID3D12DescriptorHeap* const* ppDescriptorHeaps) {}
+	virtual void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) {}
+	virtual void SetPipelineState(ID3D12PipelineState* pPipelineState) {}
+	virtual void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitiveTopology) {}
+	virtual void OMSetStencilRef(UINT stencilRef) {}
+	virtual void OMSetBlendFactor(const float blendFactor[4]) {}
+	virtual void RSSetViewports(UINT numViewports, const D3D12_VIEWPORT* pViewports) {}
+	virtual void RSSetScissorRects(UINT numRects, const D3D12_RECT* pRects) {}
+	virtual void SetGraphicsRootDescriptorTable(UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) {}
+	virtual void SetGraphicsRootConstantBufferView(UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS bufferLocation) {}
+};
+
+struct ID3D12CommandQueue : public ID3D12Object
+{
+	virtual void ExecuteCommandLists(UINT numCommandLists, ID3D12CommandList* const* ppCommandLists) {}
+	virtual HRESULT Signal(ID3D12Fence* pFence, UINT64 value) { return S_OK; }
+};
+
+struct ID3D12Device : public ID3D12Object
+{
+	virtual HRESULT CreateCommittedResource(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS heapFlags, const D3D12_RESOURCE_DESC* pDesc,
+											D3D12_RESOURCE_STATES initialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource) { return E_FAIL; }
+	virtual HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type, REFIID riid, void** ppCommandAllocator) { return E_FAIL; }
+	virtual HRESULT CreateCommandList(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* pCommandAllocator, ID3D12PipelineState* pInitialState, REFIID riid, void** ppCommandList) { return E_FAIL; }
+	virtual void GetCopyableFootprints(const D3D12_RESOURCE_DESC* pResourceDesc, UINT firstSubresource, UINT numSubresources, UINT64 baseOffset,
+									   D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts, UINT* pNumRows, UINT64* pRowSizeInBytes, UINT64* pTotalBytes) {}
+};
+struct ID3D12Device5 : public ID3D12Device
+{
+};
+
+// d3dx12.h helpers.
+struct CD3DX12_HEAP_PROPERTIES : public D3D12_HEAP_PROPERTIES
+{
+	explicit CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE type)
+	{
+		Type = type;
+		CPUPageProperty = 0;
+		MemoryPoolPreference = 0;
+		CreationNodeMask = 1;
+		VisibleNodeMask = 1;
+	}
+};
+
+struct CD3DX12_RESOURCE_DESC : public D3D12_RESOURCE_DESC
+{
+	CD3DX12_RESOURCE_DESC() = default;
+	explicit CD3DX12_RESOURCE_DESC(const D3D12_RESOURCE_DESC& DESC) : D3D12_RESOURCE_DESC(DESC) {}
+
+	static CD3DX12_RESOURCE_DESC Buffer(UINT64 width)
+	{
+		CD3DX12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Width = width;
+		desc.Height = 1;
+		desc.DepthOrArraySize = 1;
+		desc.MipLevels = 1;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		return desc;
+	}
+	static CD3DX12_RESOURCE_DESC Tex2D(DXGI_FORMAT format, UINT64 width, UINT height, USHORT arraySize = 1, USHORT mipLevels = 0)
+	{
+		CD3DX12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		desc.Width = width;
+		desc.Height = height;
+		desc.DepthOrArraySize = arraySize;
+		desc.MipLevels = mipLevels;
+		desc.Format = format;
+		desc.SampleDesc.Count = 1;
+		return desc;
+	}
+};
+
+struct CD3DX12_RANGE : public D3D12_RANGE
+{
+	CD3DX12_RANGE(SIZE_T begin, SIZE_T end)
+	{
+		Begin = begin;
+		End = end;
+	}
+};
+
+struct CD3DX12_RESOURCE_BARRIER : public D3D12_RESOURCE_BARRIER
+{
+	static CD3DX12_RESOURCE_BARRIER Transition(ID3D12Resource* pResource, D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter,
+											   UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+	{
+		CD3DX12_RESOURCE_BARRIER result = {};
+		// member Transition is hidden by this function.
+		D3D12_RESOURCE_BARRIER& barrier = result;
+		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barrier.Transition.pResource = pResource;
+		barrier.Transition.Subresource = subresource;
+		barrier.Transition.StateBefore = stateBefore;
+		barrier.Transition.StateAfter = stateAfter;
+		return result;
+	}
+};
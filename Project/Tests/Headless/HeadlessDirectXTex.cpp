@@ -0,0 +1,361 @@
+#include "../../pch.h"
+#include <DirectXTex.h>
+#include "../../Util/Utility.h"
+
+// block encoders pick endpoints from bounding box and nearest palette entry per pixel.
+// layouts follow D3D block compression spec, so decoded blocks match what GPU samples.
+
+using namespace DirectX;
+
+static UINT getBlockSize(const DXGI_FORMAT FORMAT)
+{
+	switch (FORMAT)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+			return 8;
+
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_UNORM:
+			return 16;
+
+		default:
+			break;
+	}
+	return 0;
+}
+
+static USHORT packRGB565(const UINT R, const UINT G, const UINT B)
+{
+	return (USHORT)((((R * 31 + 127) / 255) << 11) | (((G * 63 + 127) / 255) << 5) | ((B * 31 + 127) / 255));
+}
+
+static void unpackRGB565(const USHORT COLOR, UCHAR* pRGB)
+{
+	const UINT R = (COLOR >> 11) & 31;
+	const UINT G = (COLOR >> 5) & 63;
+	const UINT B = COLOR & 31;
+	pRGB[0] = (UCHAR)((R << 3) | (R >> 2));
+	pRGB[1] = (UCHAR)((G << 2) | (G >> 4));
+	pRGB[2] = (UCHAR)((B << 3) | (B >> 2));
+}
+
+// bFourColorOnly for BC3, which ignores endpoint order.
+static void getColorPalette(const USHORT COLOR0, const USHORT COLOR1, bool bFourColorOnly, UCHAR pPalette[4][4])
+{
+	unpackRGB565(COLOR0, pPalette[0]);
+	unpackRGB565(COLOR1, pPalette[1]);
+	pPalette[0][3] = 255;
+	pPalette[1][3] = 255;
+
+	const bool bFOUR_COLOR = (bFourColorOnly || COLOR0 > COLOR1);
+	for (UINT c = 0; c < 3; ++c)
+	{
+		if (bFOUR_COLOR)
+		{
+			pPalette[2][c] = (UCHAR)((2 * pPalette[0][c] + pPalette[1][c] + 1) / 3);
+			pPalette[3][c] = (UCHAR)((pPalette[0][c] + 2 * pPalette[1][c] + 1) / 3);
+		}
+		else
+		{
+			pPalette[2][c] = (UCHAR)((pPalette[0][c] + pPalette[1][c] + 1) / 2);
+			pPalette[3][c] = 0;
+		}
+	}
+	pPalette[2][3] = 255;
+	pPalette[3][3] = (bFOUR_COLOR ? 255 : 0);
+}
+
+static void encodeColorBlock(const UCHAR pPIXELS[16][4], UCHAR* pBlock)
+{
+	UINT pMin[3] = { 255, 255, 255 };
+	UINT pMax[3] = { 0, 0, 0 };
+	for (UINT i = 0; i < 16; ++i)
+	{
+		for (UINT c = 0; c < 3; ++c)
+		{
+			pMin[c] = (UINT)Min((int)pMin[c], (int)pPIXELS[i][c]);
+			pMax[c] = (UINT)Max((int)pMax[c], (int)pPIXELS[i][c]);
+		}
+	}
+
+	USHORT color0 = packRGB565(pMax[0], pMax[1], pMax[2]);
+	USHORT color1 = packRGB565(pMin[0], pMin[1], pMin[2]);
+	if (color0 < color1)
+	{
+		USHORT temp = color0;
+		color0 = color1;
+		color1 = temp;
+	}
+
+	// equal endpoints fall in 3 color mode. index 0 is still exact.
+	UCHAR palette[4][4];
+	getColorPalette(color0, color1, false, palette);
+	const UINT PALETTE_SIZE = (color0 > color1 ? 4 : 1);
+
+	UINT indices = 0;
+	for (UINT i = 0; i < 16; ++i)
+	{
+		UINT bestIndex = 0;
+		int bestError = INT32_MAX;
+		for (UINT p = 0; p < PALETTE_SIZE; ++p)
+		{
+			int error = 0;
+			for (UINT c = 0; c < 3; ++c)
+			{
+				int diff = (int)pPIXELS[i][c] - (int)palette[p][c];
+				error += diff * diff;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+		indices |= bestIndex << (i * 2);
+	}
+
+	memcpy(pBlock, &color0, 2);
+	memcpy(pBlock + 2, &color1, 2);
+	memcpy(pBlock + 4, &indices, 4);
+}
+
+static void decodeColorBlock(const UCHAR* pBLOCK, bool bFourColorOnly, UCHAR pPixels[16][4])
+{
+	USHORT color0;
+	USHORT color1;
+	UINT indices;
+	memcpy(&color0, pBLOCK, 2);
+	memcpy(&color1, pBLOCK + 2, 2);
+	memcpy(&indices, pBLOCK + 4, 4);
+
+	UCHAR palette[4][4];
+	getColorPalette(color0, color1, bFourColorOnly, palette);
+	for (UINT i = 0; i < 16; ++i)
+	{
+		memcpy(pPixels[i], palette[(indices >> (i * 2)) & 3], 4);
+	}
+}
+
+static void getScalarPalette(const UCHAR VALUE0, const UCHAR VALUE1, UCHAR pPalette[8])
+{
+	pPalette[0] = VALUE0;
+	pPalette[1] = VALUE1;
+	if (VALUE0 > VALUE1)
+	{
+		for (UINT i = 1; i < 7; ++i)
+		{
+			pPalette[i + 1] = (UCHAR)(((7 - i) * VALUE0 + i * VALUE1 + 3) / 7);
+		}
+	}
+	else
+	{
+		for (UINT i = 1; i < 5; ++i)
+		{
+			pPalette[i + 1] = (UCHAR)(((5 - i) * VALUE0 + i * VALUE1 + 2) / 5);
+		}
+		pPalette[6] = 0;
+		pPalette[7] = 255;
+	}
+}
+
+static void encodeScalarBlock(const UCHAR pPIXELS[16][4], const UINT CHANNEL, UCHAR* pBlock)
+{
+	UCHAR minValue = 255;
+	UCHAR maxValue = 0;
+	for (UINT i = 0; i < 16; ++i)
+	{
+		minValue = (UCHAR)Min((int)minValue, (int)pPIXELS[i][CHANNEL]);
+		maxValue = (UCHAR)Max((int)maxValue, (int)pPIXELS[i][CHANNEL]);
+	}
+
+	UCHAR palette[8];
+	getScalarPalette(maxValue, minValue, palette);
+
+	UINT64 indices = 0;
+	for (UINT i = 0; i < 16; ++i)
+	{
+		UINT64 bestIndex = 0;
+		int bestError = INT32_MAX;
+		for (UINT p = 0; p < 8; ++p)
+		{
+			int error = abs((int)pPIXELS[i][CHANNEL] - (int)palette[p]);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = p;
+			}
+		}
+		indices |= bestIndex << (i * 3);
+	}
+
+	pBlock[0] = maxValue;
+	pBlock[1] = minValue;
+	memcpy(pBlock + 2, &indices, 6);
+}
+
+static void decodeScalarBlock(const UCHAR* pBLOCK, const UINT CHANNEL, UCHAR pPixels[16][4])
+{
+	UINT64 indices = 0;
+	memcpy(&indices, pBLOCK + 2, 6);
+
+	UCHAR palette[8];
+	getScalarPalette(pBLOCK[0], pBLOCK[1], palette);
+	for (UINT i = 0; i < 16; ++i)
+	{
+		pPixels[i][CHANNEL] = palette[(indices >> (i * 3)) & 7];
+	}
+}
+
+void ScratchImage::Initialize(const size_t WIDTH, const size_t HEIGHT, const DXGI_FORMAT FORMAT, const size_t ROW_PITCH, const size_t ROW_COUNT)
+{
+	m_Pixels.assign(ROW_PITCH * ROW_COUNT, 0);
+	m_Image.width = WIDTH;
+	m_Image.height = HEIGHT;
+	m_Image.format = FORMAT;
+	m_Image.rowPitch = ROW_PITCH;
+	m_Image.slicePitch = ROW_PITCH * ROW_COUNT;
+	m_Image.pixels = m_Pixels.data();
+}
+
+HRESULT DirectX::Compress(const Image& SRC_IMAGE, DXGI_FORMAT format, TEX_COMPRESS_FLAGS compress, float threshold, ScratchImage& image)
+{
+	const UINT BLOCK_SIZE = getBlockSize(format);
+	if (BLOCK_SIZE == 0)
+	{
+		return E_NOTIMPL;
+	}
+	if (SRC_IMAGE.format != DXGI_FORMAT_R8G8B8A8_UNORM && SRC_IMAGE.format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+	{
+		return E_INVALIDARG;
+	}
+
+	const size_t BLOCK_COLUMN_COUNT = (SRC_IMAGE.width + 3) / 4;
+	const size_t BLOCK_ROW_COUNT = (SRC_IMAGE.height + 3) / 4;
+	image.Initialize(SRC_IMAGE.width, SRC_IMAGE.height, format, BLOCK_COLUMN_COUNT * BLOCK_SIZE, BLOCK_ROW_COUNT);
+
+	for (size_t by = 0; by < BLOCK_ROW_COUNT; ++by)
+	{
+		for (size_t bx = 0; bx < BLOCK_COLUMN_COUNT; ++bx)
+		{
+			// edge pixels are repeated into partial blocks.
+			UCHAR pixels[16][4];
+			for (UINT i = 0; i < 16; ++i)
+			{
+				const size_t X = (size_t)Min((int)(bx * 4 + i % 4), (int)SRC_IMAGE.width - 1);
+				const size_t Y = (size_t)Min((int)(by * 4 + i / 4), (int)SRC_IMAGE.height - 1);
+				memcpy(pixels[i], SRC_IMAGE.pixels + Y * SRC_IMAGE.rowPitch + X * 4, 4);
+			}
+
+			UCHAR* pBlock = image.GetPixels() + by * image.GetImage(0, 0, 0)->rowPitch + bx * BLOCK_SIZE;
+			switch (format)
+			{
+				case DXGI_FORMAT_BC1_UNORM:
+				case DXGI_FORMAT_BC1_UNORM_SRGB:
+					encodeColorBlock(pixels, pBlock);
+					break;
+
+				case DXGI_FORMAT_BC3_UNORM:
+				case DXGI_FORMAT_BC3_UNORM_SRGB:
+					encodeScalarBlock(pixels, 3, pBlock);
+					encodeColorBlock(pixels, pBlock + 8);
+					break;
+
+				case DXGI_FORMAT_BC4_UNORM:
+					encodeScalarBlock(pixels, 0, pBlock);
+					break;
+
+				case DXGI_FORMAT_BC5_UNORM:
+					encodeScalarBlock(pixels, 0, pBlock);
+					encodeScalarBlock(pixels, 1, pBlock + 8);
+					break;
+
+				default:
+					break;
+			}
+		}
+	}
+
+	return S_OK;
+}
+
+HRESULT DirectX::Decompress(const Image& C_IMAGE, DXGI_FORMAT format, ScratchImage& image)
+{
+	const UINT BLOCK_SIZE = getBlockSize(C_IMAGE.format);
+	if (BLOCK_SIZE == 0)
+	{
+		return E_NOTIMPL;
+	}
+	if (format != DXGI_FORMAT_R8G8B8A8_UNORM && format != DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+	{
+		return E_INVALIDARG;
+	}
+
+	image.Initialize(C_IMAGE.width, C_IMAGE.height, format, C_IMAGE.width * 4, C_IMAGE.height);
+
+	const size_t BLOCK_COLUMN_COUNT = (C_IMAGE.width + 3) / 4;
+	const size_t BLOCK_ROW_COUNT = (C_IMAGE.height + 3) / 4;
+	for (size_t by = 0; by < BLOCK_ROW_COUNT; ++by)
+	{
+		for (size_t bx = 0; bx < BLOCK_COLUMN_COUNT; ++bx)
+		{
+			const UCHAR* pBLOCK = C_IMAGE.pixels + by * C_IMAGE.rowPitch + bx * BLOCK_SIZE;
+
+			// single channel formats decode as r001, two channel ones as rg01.
+			UCHAR pixels[16][4] = {};
+			for (UINT i = 0; i < 16; ++i)
+			{
+				pixels[i][3] = 255;
+			}
+			switch (C_IMAGE.format)
+			{
+				case DXGI_FORMAT_BC1_UNORM:
+				case DXGI_FORMAT_BC1_UNORM_SRGB:
+					decodeColorBlock(pBLOCK, false, pixels);
+					break;
+
+				case DXGI_FORMAT_BC3_UNORM:
+				case DXGI_FORMAT_BC3_UNORM_SRGB:
+					decodeColorBlock(pBLOCK + 8, true, pixels);
+					decodeScalarBlock(pBLOCK, 3, pixels);
+					break;
+
+				case DXGI_FORMAT_BC4_UNORM:
+					decodeScalarBlock(pBLOCK, 0, pixels);
+					break;
+
+				case DXGI_FORMAT_BC5_UNORM:
+					decodeScalarBlock(pBLOCK, 0, pixels);
+					decodeScalarBlock(pBLOCK + 8, 1, pixels);
+					break;
+
+				default:
+					break;
+			}
+
+			for (UINT i = 0; i < 16; ++i)
+			{
+				const size_t X = bx * 4 + i % 4;
+				const size_t Y = by * 4 + i / 4;
+				if (X < C_IMAGE.width && Y < C_IMAGE.height)
+				{
+					memcpy(image.GetPixels() + Y * C_IMAGE.width * 4 + X * 4, pixels[i], 4);
+				}
+			}
+		}
+	}
+
+	return S_OK;
+}
+
+HRESULT DirectX::LoadFromDDSFile(const wchar_t* pszFileName, DDS_FLAGS flags, TexMetadata* pMetadata, ScratchImage& image)
+{
+	return E_NOTIMPL;
+}
+
+HRESULT DirectX::SaveToDDSFile(const Image* pImages, size_t imageCount, const TexMetadata& METADATA, DDS_FLAGS flags, const wchar_t* pszFileName)
+{
+	return E_NOTIMPL;
+}
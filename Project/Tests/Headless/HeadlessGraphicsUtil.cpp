@@ -0,0 +1,36 @@
+#include "../../pch.h"
+#include "../../Graphics/GraphicsUtil.h"
+
+// portable part of Graphics/GraphicsUtil.cpp.
+
+UINT64 GetPixelSize(const DXGI_FORMAT PIXEL_FORMAT)
+{
+	switch (PIXEL_FORMAT)
+	{
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			return sizeof(USHORT) * 4;
+
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			return sizeof(UINT) * 4;
+
+		case DXGI_FORMAT_R32_FLOAT:
+			return sizeof(UINT);
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+			return sizeof(UCHAR) * 4;
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			return sizeof(UCHAR) * 4;
+
+		case DXGI_FORMAT_R32_SINT:
+			return sizeof(int);
+
+		case DXGI_FORMAT_R16_FLOAT:
+			return sizeof(USHORT);
+
+		default:
+			break;
+	}
+
+	return sizeof(UCHAR) * 4;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+// Win32 subset used by D3D-free modules, so they build and run on linux for Tests/.
+// included from pch.h instead of Windows and D3D12 headers when HEADLESS_TEST is defined.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <string>
+
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned char UCHAR;
+typedef short SHORT;
+typedef unsigned short USHORT;
+typedef int INT;
+typedef unsigned int UINT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef uint32_t DWORD;
+typedef int64_t INT64;
+typedef uint64_t UINT64;
+typedef int64_t LONG64;
+typedef uint64_t ULONG64;
+typedef uintptr_t UINT_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t SIZE_T;
+typedef wchar_t WCHAR;
+typedef int32_t HRESULT;
+typedef void* HANDLE;
+
+#define TRUE 1
+#define FALSE 0
+#define WINAPI
+#define _countof(a) (sizeof(a) / sizeof((a)[0]))
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_FAIL ((HRESULT)0x80004005)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#define E_INVALIDARG ((HRESULT)0x80070057)
+#define E_ABORT ((HRESULT)0x80004004)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+// _ASSERT stops the test. __debugbreak only counts, so tests can expect misuse reports.
+#define _ASSERT(expr)																		  \
+		do																					  \
+		{																					  \
+			if (!(expr))																	  \
+			{																				  \
+				fprintf(stderr, "%s(%d): assertion failed: %s\n", __FILE__, __LINE__, #expr); \
+				abort();																	  \
+			}																				  \
+		} while (0)
+
+extern volatile LONG g_HeadlessDebugBreakCount;
+#define __debugbreak() __atomic_add_fetch(&g_HeadlessDebugBreakCount, 1, __ATOMIC_SEQ_CST)
+
+#define BREAK_IF_FAILED(hr) \
+		if (FAILED(hr))		\
+		{					\
+			__debugbreak(); \
+		}
+#define SAFE_RELEASE(p)		\
+		if (p)				\
+		{					\
+			(p)->Release(); \
+			(p) = nullptr;	\
+		}
+
+inline void OutputDebugStringA(const char* pszText) { fputs(pszText, stdout); }
+inline void OutputDebugStringW(const WCHAR* pszText) { fputws(pszText, stdout); }
+
+template <size_t N, typename... Args>
+inline int sprintf_s(char (&buffer)[N], const char* pszFormat, Args... args) { return snprintf(buffer, N, pszFormat, args...); }
+template <size_t N, typename... Args>
+inline int swprintf_s(WCHAR (&buffer)[N], const WCHAR* pszFormat, Args... args) { return swprintf(buffer, N, pszFormat, args...); }
+
+// file time. see HeadlessUtility.cpp
+typedef int64_t __time64_t;
+struct _stat64
+{
+	__time64_t st_mtime;
+	INT64 st_size;
+};
+int _wstat64(const WCHAR* pszPath, struct _stat64* pStat);
+
+inline void Sleep(DWORD milliseconds) { std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds)); }
+inline void YieldProcessor() { std::this_thread::yield(); }
+
+// interlocked.
+inline LONG InterlockedIncrement(volatile LONG* pAddend) { return __atomic_add_fetch(pAddend, 1, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedDecrement(volatile LONG* pAddend) { return __atomic_sub_fetch(pAddend, 1, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedExchange(volatile LONG* pTarget, LONG value) { return __atomic_exchange_n(pTarget, value, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedExchangeAdd(volatile LONG* pAddend, LONG value) { return __atomic_fetch_add(pAddend, value, __ATOMIC_SEQ_CST); }
+inline LONG InterlockedCompareExchange(volatile LONG* pDestination, LONG exchange, LONG comparand)
+{
+	__atomic_compare_exchange_n(pDestination, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return comparand;
+}
+inline LONG64 InterlockedIncrement64(volatile LONG64* pAddend) { return __atomic_add_fetch(pAddend, 1, __ATOMIC_SEQ_CST); }
+inline LONG64 InterlockedDecrement64(volatile LONG64* pAddend) { return __atomic_sub_fetch(pAddend, 1, __ATOMIC_SEQ_CST); }
+inline LONG64 InterlockedExchange64(volatile LONG64* pTarget, LONG64 value) { return __atomic_exchange_n(pTarget, value, __ATOMIC_SEQ_CST); }
+inline LONG64 InterlockedCompareExchange64(volatile LONG64* pDestination, LONG64 exchange, LONG64 comparand)
+{
+	__atomic_compare_exchange_n(pDestination, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return comparand;
+}
+inline void* InterlockedCompareExchangePointer(void* volatile* pDestination, void* pExchange, void* pComparand)
+{
+	__atomic_compare_exchange_n(pDestination, &pComparand, pExchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return pComparand;
+}
+inline void* InterlockedExchangePointer(void* volatile* pTarget, void* pValue) { return __atomic_exchange_n(pTarget, pValue, __ATOMIC_SEQ_CST); }
+
+// critical section.
+struct CRITICAL_SECTION
+{
+	std::recursive_mutex* pMutex;
+};
+inline void InitializeCriticalSection(CRITICAL_SECTION* pCS) { pCS->pMutex = new std::recursive_mutex; }
+inline void DeleteCriticalSection(CRITICAL_SECTION* pCS)
+{
+	delete pCS->pMutex;
+	pCS->pMutex = nullptr;
+}
+inline void EnterCriticalSection(CRITICAL_SECTION* pCS) { pCS->pMutex->lock(); }
+inline void LeaveCriticalSection(CRITICAL_SECTION* pCS) { pCS->pMutex->unlock(); }
+
+#include "HeadlessThread.h"
+#include "HeadlessD3D12.h"
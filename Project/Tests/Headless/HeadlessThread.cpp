@@ -0,0 +1,178 @@
+#include "../../pch.h"
+#include <condition_variable>
+
+enum eHeadlessHandleType
+{
+	HeadlessHandleType_Event = 0,
+	HeadlessHandleType_Semaphore,
+	HeadlessHandleType_Thread,
+};
+struct HeadlessHandle
+{
+	eHeadlessHandleType Type;
+	bool bManualReset;
+	LONG Count; // event: 0 or 1. semaphore: count. thread: 1 when done.
+	LONG MaxCount;
+	std::thread Thread;
+};
+
+static std::mutex s_HandleLock;
+static std::condition_variable s_HandleSignaled;
+
+static HeadlessHandle* createHandle(eHeadlessHandleType type, bool bManualReset, LONG count, LONG maxCount)
+{
+	HeadlessHandle* pHandle = new HeadlessHandle;
+	pHandle->Type = type;
+	pHandle->bManualReset = bManualReset;
+	pHandle->Count = count;
+	pHandle->MaxCount = maxCount;
+	return pHandle;
+}
+
+// s_HandleLock must be held. consumes signal of auto reset event and semaphore.
+static bool tryAcquire(HeadlessHandle* pHandle)
+{
+	if (pHandle->Count == 0)
+	{
+		return false;
+	}
+	if (pHandle->Type == HeadlessHandleType_Semaphore || (pHandle->Type == HeadlessHandleType_Event && !pHandle->bManualReset))
+	{
+		--(pHandle->Count);
+	}
+	return true;
+}
+
+HANDLE CreateEvent(void* pAttributes, BOOL bManualReset, BOOL bInitialState, const WCHAR* pszName)
+{
+	return createHandle(HeadlessHandleType_Event, bManualReset != FALSE, bInitialState ? 1 : 0, 1);
+}
+
+HANDLE CreateSemaphore(void* pAttributes, LONG initialCount, LONG maximumCount, const WCHAR* pszName)
+{
+	return createHandle(HeadlessHandleType_Semaphore, false, initialCount, maximumCount);
+}
+
+BOOL SetEvent(HANDLE hEvent)
+{
+	HeadlessHandle* pHandle = (HeadlessHandle*)hEvent;
+	{
+		std::lock_guard<std::mutex> lock(s_HandleLock);
+		pHandle->Count = 1;
+	}
+	s_HandleSignaled.notify_all();
+	return TRUE;
+}
+
+BOOL ResetEvent(HANDLE hEvent)
+{
+	HeadlessHandle* pHandle = (HeadlessHandle*)hEvent;
+	std::lock_guard<std::mutex> lock(s_HandleLock);
+	pHandle->Count = 0;
+	return TRUE;
+}
+
+BOOL ReleaseSemaphore(HANDLE hSemaphore, LONG releaseCount, LONG* pPreviousCount)
+{
+	HeadlessHandle* pHandle = (HeadlessHandle*)hSemaphore;
+	{
+		std::lock_guard<std::mutex> lock(s_HandleLock);
+		if (pPreviousCount)
+		{
+			*pPreviousCount = pHandle->Count;
+		}
+		if (pHandle->Count > pHandle->MaxCount - releaseCount)
+		{
+			return FALSE;
+		}
+		pHandle->Count += releaseCount;
+	}
+	s_HandleSignaled.notify_all();
+	return TRUE;
+}
+
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD milliseconds)
+{
+	return WaitForMultipleObjects(1, &hHandle, FALSE, milliseconds);
+}
+
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* phHandles, BOOL bWaitAll, DWORD milliseconds)
+{
+	_ASSERT(!bWaitAll || count == 1); // not needed by tests so far.
+
+	std::unique_lock<std::mutex> lock(s_HandleLock);
+	const std::chrono::steady_clock::time_point DEADLINE = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+
+	while (true)
+	{
+		// lowest signaled index wins, same as Win32.
+		for (DWORD i = 0; i < count; ++i)
+		{
+			if (tryAcquire((HeadlessHandle*)phHandles[i]))
+			{
+				return WAIT_OBJECT_0 + i;
+			}
+		}
+
+		if (milliseconds == INFINITE)
+		{
+			s_HandleSignaled.wait(lock);
+		}
+		else if (s_HandleSignaled.wait_until(lock, DEADLINE) == std::cv_status::timeout)
+		{
+			return WAIT_TIMEOUT;
+		}
+	}
+}
+
+BOOL CloseHandle(HANDLE hHandle)
+{
+	HeadlessHandle* pHandle = (HeadlessHandle*)hHandle;
+	if (!pHandle)
+	{
+		return FALSE;
+	}
+
+	if (pHandle->Thread.joinable())
+	{
+		pHandle->Thread.join();
+	}
+	delete pHandle;
+	return TRUE;
+}
+
+UINT_PTR _beginthreadex(void* pSecurity, UINT stackSize, _beginthreadex_proc_type pfnStart, void* pArg, UINT initFlag, UINT* pThreadID)
+{
+	_ASSERT(pfnStart);
+	_ASSERT(initFlag == 0); // CREATE_SUSPENDED is not supported.
+
+	static volatile LONG s_ThreadID = 0;
+	HeadlessHandle* pHandle = createHandle(HeadlessHandleType_Thread, true, 0, 1);
+	pHandle->Thread = std::thread([pHandle, pfnStart, pArg]()
+	{
+		pfnStart(pArg);
+		{
+			std::lock_guard<std::mutex> lock(s_HandleLock);
+			pHandle->Count = 1;
+		}
+		s_HandleSignaled.notify_all();
+	});
+
+	if (pThreadID)
+	{
+		*pThreadID = (UINT)InterlockedIncrement(&s_ThreadID);
+	}
+	return (UINT_PTR)pHandle;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* pCount)
+{
+	pCount->QuadPart = (INT64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* pFrequency)
+{
+	pFrequency->QuadPart = 1000000000ll;
+	return TRUE;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// Win32 threads, events and semaphores on std::thread. all handles share one lock and condition,
+// which is slow but makes WaitForMultipleObjects simple. see HeadlessThread.cpp
+
+#define INFINITE 0xffffffffu
+#define WAIT_OBJECT_0 0u
+#define WAIT_TIMEOUT 258u
+#define WAIT_FAILED 0xffffffffu
+// LONG is 32 bit as on windows, limits.h has 64 bit long.
+#undef LONG_MAX
+#define LONG_MAX 2147483647
+#define THREAD_PRIORITY_BELOW_NORMAL (-1)
+#define THREAD_PRIORITY_NORMAL 0
+
+union LARGE_INTEGER
+{
+	struct
+	{
+		DWORD LowPart;
+		LONG HighPart;
+	};
+	INT64 QuadPart;
+};
+
+typedef UINT (*_beginthreadex_proc_type)(void* pArg);
+
+HANDLE CreateEvent(void* pAttributes, BOOL bManualReset, BOOL bInitialState, const WCHAR* pszName);
+HANDLE CreateSemaphore(void* pAttributes, LONG initialCount, LONG maximumCount, const WCHAR* pszName);
+BOOL SetEvent(HANDLE hEvent);
+BOOL ResetEvent(HANDLE hEvent);
+BOOL ReleaseSemaphore(HANDLE hSemaphore, LONG releaseCount, LONG* pPreviousCount);
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD milliseconds);
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* phHandles, BOOL bWaitAll, DWORD milliseconds);
+BOOL CloseHandle(HANDLE hHandle);
+
+// stack size and security are ignored. thread handle is signaled when proc returns.
+UINT_PTR _beginthreadex(void* pSecurity, UINT stackSize, _beginthreadex_proc_type pfnStart, void* pArg, UINT initFlag, UINT* pThreadID);
+// returning from proc does the same. headless threads can not end early.
+inline void _endthreadex(UINT) {}
+inline BOOL SetThreadPriority(HANDLE, int) { return TRUE; }
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* pCount);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* pFrequency);
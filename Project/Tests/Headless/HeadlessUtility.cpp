@@ -0,0 +1,118 @@
+#include "../../pch.h"
+#include "../../Util/Utility.h"
+#include <sys/stat.h>
+#undef st_mtime // glibc names it st_mtim.tv_sec.
+
+// portable part of Util/Utility.cpp. ParallelFor runs ranges in order on calling thread, ReadWholeFile and _wstat64 use libc.
+
+volatile LONG g_HeadlessDebugBreakCount = 0;
+
+UINT GetParallelRangeCount(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE)
+{
+	const UINT CORE_COUNT = (UINT)Max((int)std::thread::hardware_concurrency(), 1);
+
+	UINT rangeCount = (COUNT + MIN_COUNT_PER_RANGE - 1) / (MIN_COUNT_PER_RANGE > 0 ? MIN_COUNT_PER_RANGE : 1);
+	rangeCount = (UINT)Min((int)rangeCount, (int)CORE_COUNT);
+	rangeCount = (UINT)Min((int)rangeCount, (int)MAX_PARALLEL_THREAD_COUNT);
+
+	return (rangeCount > 0 ? rangeCount : 1);
+}
+
+void ParallelFor(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE, ParallelJobFunc pfnJob, void* pArg)
+{
+	_ASSERT(pfnJob);
+
+	const UINT RANGE_COUNT = GetParallelRangeCount(COUNT, MIN_COUNT_PER_RANGE);
+	for (UINT i = 0; i < RANGE_COUNT; ++i)
+	{
+		pfnJob((UINT)((UINT64)COUNT * i / RANGE_COUNT), (UINT)((UINT64)COUNT * (i + 1) / RANGE_COUNT), i, pArg);
+	}
+}
+
+HRESULT ReadWholeFile(const WCHAR* pszFileName, std::vector<UCHAR>& fileData)
+{
+	char fileName[1024];
+	if (wcstombs(fileName, pszFileName, sizeof(fileName)) >= sizeof(fileName))
+	{
+		return E_INVALIDARG;
+	}
+
+	FILE* pFile = fopen(fileName, "rb");
+	if (!pFile)
+	{
+		return E_FAIL;
+	}
+
+	HRESULT hr = S_OK;
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	fileData.resize(fileSize > 0 ? (size_t)fileSize : 0);
+	if (!fileData.empty() && fread(fileData.data(), 1, fileData.size(), pFile) != fileData.size())
+	{
+		fileData.clear();
+		hr = E_FAIL;
+	}
+
+	fclose(pFile);
+	return hr;
+}
+
+int _wstat64(const WCHAR* pszPath, struct _stat64* pStat)
+{
+	char path[1024];
+	struct stat fileStat;
+	if (wcstombs(path, pszPath, sizeof(path)) >= sizeof(path) || stat(path, &fileStat) != 0)
+	{
+		return -1;
+	}
+
+	pStat->st_mtime = (__time64_t)fileStat.st_mtim.tv_sec;
+	pStat->st_size = (INT64)fileStat.st_size;
+	return 0;
+}
+
+UINT64 HashBytes(const void* pDATA, const UINT64 SIZE, const UINT64 SEED)
+{
+	const UCHAR* pBYTES = (const UCHAR*)pDATA;
+	UINT64 hash = SEED;
+
+	for (UINT64 i = 0; i < SIZE; ++i)
+	{
+		hash ^= pBYTES[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+UINT64 GetAllocMemSize(UINT64 size)
+{
+	return size + sizeof(UINT64) * 2;
+}
+
+int Min(int x, int y)
+{
+	return (x < y ? x : y);
+}
+
+int Max(int x, int y)
+{
+	return (x > y ? x : y);
+}
+
+float Min(float x, float y)
+{
+	return (x < y ? x : y);
+}
+
+float Max(float x, float y)
+{
+	return (x > y ? x : y);
+}
+
+float Clamp(float x, float upper, float lower)
+{
+	return Max(lower, Min(x, upper));
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// SimpleMath subset used by headless modules. same layout and semantics as DirectXTK, no SIMD.
+
+#include <math.h>
+#include <string.h>
+
+namespace DirectX
+{
+	struct XMFLOAT2
+	{
+		float x;
+		float y;
+	};
+	struct XMFLOAT3
+	{
+		float x;
+		float y;
+		float z;
+	};
+	struct XMFLOAT4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+	};
+	struct XMFLOAT4X4
+	{
+		float m[4][4];
+	};
+
+	namespace SimpleMath
+	{
+		struct Vector2 : public XMFLOAT2
+		{
+			Vector2() : XMFLOAT2{ 0.0f, 0.0f } {}
+			explicit Vector2(float v) : XMFLOAT2{ v, v } {}
+			Vector2(float _x, float _y) : XMFLOAT2{ _x, _y } {}
+
+			bool operator==(const Vector2& V) const { return (x == V.x && y == V.y); }
+			bool operator!=(const Vector2& V) const { return !(*this == V); }
+			Vector2 operator+(const Vector2& V) const { return Vector2(x + V.x, y + V.y); }
+			Vector2 operator-(const Vector2& V) const { return Vector2(x - V.x, y - V.y); }
+			Vector2 operator*(float s) const { return Vector2(x * s, y * s); }
+			Vector2& operator+=(const Vector2& V) { x += V.x; y += V.y; return *this; }
+
+			float Dot(const Vector2& V) const { return x * V.x + y * V.y; }
+			float Length() const { return sqrtf(Dot(*this)); }
+			float LengthSquared() const { return Dot(*this); }
+		};
+
+		struct Vector3 : public XMFLOAT3
+		{
+			Vector3() : XMFLOAT3{ 0.0f, 0.0f, 0.0f } {}
+			Vector3(float v) : XMFLOAT3{ v, v, v } {}
+			Vector3(float _x, float _y, float _z) : XMFLOAT3{ _x, _y, _z } {}
+			Vector3(const XMFLOAT3& V) : XMFLOAT3(V) {}
+
+			bool operator==(const Vector3& V) const { return (x == V.x && y == V.y && z == V.z); }
+			bool operator!=(const Vector3& V) const { return !(*this == V); }
+			Vector3 operator-() const { return Vector3(-x, -y, -z); }
+			Vector3 operator+(const Vector3& V) const { return Vector3(x + V.x, y + V.y, z + V.z); }
+			Vector3 operator-(const Vector3& V) const { return Vector3(x - V.x, y - V.y, z - V.z); }
+			Vector3 operator*(const Vector3& V) const { return Vector3(x * V.x, y * V.y, z * V.z); }
+			Vector3 operator/(const Vector3& V) const { return Vector3(x / V.x, y / V.y, z / V.z); }
+			Vector3 operator*(float s) const { return Vector3(x * s, y * s, z * s); }
+			Vector3 operator/(float s) const { return Vector3(x / s, y / s, z / s); }
+			Vector3& operator+=(const Vector3& V) { x += V.x; y += V.y; z += V.z; return *this; }
+			Vector3& operator-=(const Vector3& V) { x -= V.x; y -= V.y; z -= V.z; return *this; }
+			Vector3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+			Vector3& operator/=(float s) { x /= s; y /= s; z /= s; return *this; }
+
+			float Dot(const Vector3& V) const { return x * V.x + y * V.y + z * V.z; }
+			Vector3 Cross(const Vector3& V) const { return Vector3(y * V.z - z * V.y, z * V.x - x * V.z, x * V.y - y * V.x); }
+			float Length() const { return sqrtf(Dot(*this)); }
+			float LengthSquared() const { return Dot(*this); }
+			void Normalize()
+			{
+				float length = Length();
+				if (length > 0.0f)
+				{
+					*this /= length;
+				}
+			}
+			void Normalize(Vector3& result) const
+			{
+				result = *this;
+				result.Normalize();
+			}
+
+			static Vector3 Min(const Vector3& V1, const Vector3& V2) { return Vector3(fminf(V1.x, V2.x), fminf(V1.y, V2.y), fminf(V1.z, V2.z)); }
+			static Vector3 Max(const Vector3& V1, const Vector3& V2) { return Vector3(fmaxf(V1.x, V2.x), fmaxf(V1.y, V2.y), fmaxf(V1.z, V2.z)); }
+			static float Distance(const Vector3& V1, const Vector3& V2) { return (V1 - V2).Length(); }
+		};
+		inline Vector3 operator*(float s, const Vector3& V) { return V * s; }
+
+		struct Vector4 : public XMFLOAT4
+		{
+			Vector4() : XMFLOAT4{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+			explicit Vector4(float v) : XMFLOAT4{ v, v, v, v } {}
+			Vector4(float _x, float _y, float _z, float _w) : XMFLOAT4{ _x, _y, _z, _w } {}
+			Vector4(const Vector3& V, float _w) : XMFLOAT4{ V.x, V.y, V.z, _w } {}
+
+			bool operator==(const Vector4& V) const { return (x == V.x && y == V.y && z == V.z && w == V.w); }
+			bool operator!=(const Vector4& V) const { return !(*this == V); }
+		};
+
+		struct Matrix : public XMFLOAT4X4
+		{
+			Matrix() : XMFLOAT4X4{ { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } } {}
+		};
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// msvc <intrin.h> subset. gcc keeps x86 intrinsics in x86intrin.h and cpuid in cpuid.h with another signature.
+
+#include <x86intrin.h>
+
+inline void __cpuid(int pCPUInfo[4], int functionID)
+{
+	__asm__ __volatile__("cpuid" : "=a"(pCPUInfo[0]), "=b"(pCPUInfo[1]), "=c"(pCPUInfo[2]), "=d"(pCPUInfo[3]) : "a"(functionID), "c"(0));
+}
@@ -0,0 +1,207 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Graphics/GraphicsUtil.h"
+#include "../Graphics/ImageProcessing.h"
+#include "TestCommon.h"
+
+// channel expansion and alpha merge against plain loops they replaced in GraphicsUtil.cpp,
+// and GenerateMips against scalar per channel box filter. headless ParallelFor is serial, so mips run on one thread.
+//   ImageProcessingBenchmark [image size, default 4096]
+
+static void expandReference(const UCHAR* pSRC, const int CHANNELS, const UINT64 PIXEL_COUNT, UCHAR* pDst)
+{
+	for (UINT64 i = 0; i < PIXEL_COUNT; ++i)
+	{
+		const UCHAR* pPIXEL = pSRC + i * CHANNELS;
+		switch (CHANNELS)
+		{
+			case 1:
+				pDst[i * 4] = pPIXEL[0];
+				pDst[i * 4 + 1] = pPIXEL[0];
+				pDst[i * 4 + 2] = pPIXEL[0];
+				pDst[i * 4 + 3] = pPIXEL[0];
+				break;
+
+			case 2:
+				pDst[i * 4] = pPIXEL[0];
+				pDst[i * 4 + 1] = pPIXEL[1];
+				pDst[i * 4 + 2] = 255;
+				pDst[i * 4 + 3] = 255;
+				break;
+
+			case 3:
+				pDst[i * 4] = pPIXEL[0];
+				pDst[i * 4 + 1] = pPIXEL[1];
+				pDst[i * 4 + 2] = pPIXEL[2];
+				pDst[i * 4 + 3] = 255;
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+static void copyRedToAlphaReference(const UCHAR* pSRC, UCHAR* pDst, const UINT64 PIXEL_COUNT)
+{
+	for (UINT64 i = 0; i < PIXEL_COUNT; ++i)
+	{
+		pDst[i * 4 + 3] = pSRC[i * 4];
+	}
+}
+
+// RGBA8 only. same filter as GenerateMips without vectors.
+static void generateMipsReference(std::vector<UCHAR>& image, const UINT WIDTH, const UINT HEIGHT)
+{
+	const UINT MIP_LEVELS = GetMipLevelCount(WIDTH, HEIGHT);
+	image.resize(GetMipChainSize(WIDTH, HEIGHT, MIP_LEVELS, DXGI_FORMAT_R8G8B8A8_UNORM));
+
+	UINT srcWidth = WIDTH;
+	UINT srcHeight = HEIGHT;
+	UINT64 srcOffset = 0;
+	for (UINT level = 1; level < MIP_LEVELS; ++level)
+	{
+		const UINT DST_WIDTH = (srcWidth > 1 ? srcWidth / 2 : 1);
+		const UINT DST_HEIGHT = (srcHeight > 1 ? srcHeight / 2 : 1);
+		const UCHAR* pSRC = image.data() + srcOffset;
+		UCHAR* pDst = image.data() + srcOffset + (UINT64)srcWidth * srcHeight * 4;
+
+		for (UINT y = 0; y < DST_HEIGHT; ++y)
+		{
+			const UINT Y1 = (UINT)Min((int)(y * 2 + 1), (int)srcHeight - 1);
+			for (UINT x = 0; x < DST_WIDTH; ++x)
+			{
+				const UINT X1 = (UINT)Min((int)(x * 2 + 1), (int)srcWidth - 1);
+				for (UINT c = 0; c < 4; ++c)
+				{
+					UINT sum = pSRC[((UINT64)y * 2 * srcWidth + x * 2) * 4 + c] + pSRC[((UINT64)y * 2 * srcWidth + X1) * 4 + c] +
+							   pSRC[((UINT64)Y1 * srcWidth + x * 2) * 4 + c] + pSRC[((UINT64)Y1 * srcWidth + X1) * 4 + c];
+					pDst[((UINT64)y * DST_WIDTH + x) * 4 + c] = (UCHAR)((sum + 2) >> 2);
+				}
+			}
+		}
+
+		srcOffset += (UINT64)srcWidth * srcHeight * 4;
+		srcWidth = DST_WIDTH;
+		srcHeight = DST_HEIGHT;
+	}
+}
+
+static const int REPEAT_COUNT = 10;
+
+static double toMegaPixelsPerSecond(const UINT64 PIXEL_COUNT, const double SECONDS)
+{
+	return (double)PIXEL_COUNT * REPEAT_COUNT / SECONDS / 1000000.0;
+}
+
+int main(int argc, char** argv)
+{
+	const UINT SIZE = (argc > 1 ? (UINT)atoi(argv[1]) : 4096);
+	// odd count runs vector loops and scalar tails.
+	const UINT64 PIXEL_COUNT = (UINT64)SIZE * SIZE + 7;
+
+	TestRandom random;
+	std::vector<UCHAR> src(PIXEL_COUNT * 4);
+	for (UINT64 i = 0, size = src.size(); i < size; ++i)
+	{
+		src[i] = (UCHAR)random.NextUInt(256);
+	}
+	std::vector<UCHAR> dst(PIXEL_COUNT * 4);
+	std::vector<UCHAR> reference(PIXEL_COUNT * 4);
+
+	printf("%u x %u, %d runs\n", SIZE, SIZE, REPEAT_COUNT);
+
+	const char* ppszNAMES[3] = { "gray", "rg", "rgb" };
+	for (int channels = 1; channels <= 3; ++channels)
+	{
+		double beginTime = GetTestTime();
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			expandReference(src.data(), channels, PIXEL_COUNT, reference.data());
+		}
+		const double REFERENCE_TIME = GetTestTime() - beginTime;
+
+		beginTime = GetTestTime();
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			CHECK(SUCCEEDED(ExpandToRGBA(src.data(), channels, PIXEL_COUNT, dst.data())));
+		}
+		const double TIME = GetTestTime() - beginTime;
+
+		CHECK(memcmp(dst.data(), reference.data(), dst.size()) == 0);
+		printf("%-6s scalar %8.1f MP/s, ExpandToRGBA %8.1f MP/s\n", ppszNAMES[channels - 1], toMegaPixelsPerSecond(PIXEL_COUNT, REFERENCE_TIME), toMegaPixelsPerSecond(PIXEL_COUNT, TIME));
+	}
+
+	{
+		double beginTime = GetTestTime();
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			copyRedToAlphaReference(src.data(), reference.data(), PIXEL_COUNT);
+		}
+		const double REFERENCE_TIME = GetTestTime() - beginTime;
+
+		// same rgb in both, so only alpha can differ.
+		memcpy(dst.data(), reference.data(), dst.size());
+		beginTime = GetTestTime();
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			CopyRedToAlpha(src.data(), dst.data(), PIXEL_COUNT);
+		}
+		const double TIME = GetTestTime() - beginTime;
+
+		CHECK(memcmp(dst.data(), reference.data(), dst.size()) == 0);
+		printf("%-6s scalar %8.1f MP/s, CopyRedToAlpha %6.1f MP/s\n", "alpha", toMegaPixelsPerSecond(PIXEL_COUNT, REFERENCE_TIME), toMegaPixelsPerSecond(PIXEL_COUNT, TIME));
+	}
+
+	CHECK(ExpandToRGBA(src.data(), 5, PIXEL_COUNT, dst.data()) == E_FAIL);
+
+	// mips. MP/s of level 0.
+	const UINT64 LEVEL0_PIXEL_COUNT = (UINT64)SIZE * SIZE;
+	{
+		std::vector<UCHAR> referenceImage;
+		std::vector<UCHAR> image;
+		double referenceTime = 0.0;
+		double time = 0.0;
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			referenceImage.assign(src.begin(), src.begin() + LEVEL0_PIXEL_COUNT * 4);
+			double beginTime = GetTestTime();
+			generateMipsReference(referenceImage, SIZE, SIZE);
+			referenceTime += GetTestTime() - beginTime;
+
+			image.assign(src.begin(), src.begin() + LEVEL0_PIXEL_COUNT * 4);
+			UINT mipLevels = 0;
+			beginTime = GetTestTime();
+			CHECK(SUCCEEDED(GenerateMips(image, SIZE, SIZE, DXGI_FORMAT_R8G8B8A8_UNORM, &mipLevels, false)));
+			time += GetTestTime() - beginTime;
+		}
+
+		CHECK(image == referenceImage);
+		printf("%-6s scalar %8.1f MP/s, GenerateMips %8.1f MP/s\n", "mips", toMegaPixelsPerSecond(LEVEL0_PIXEL_COUNT, referenceTime), toMegaPixelsPerSecond(LEVEL0_PIXEL_COUNT, time));
+	}
+
+	const DXGI_FORMAT MIP_FORMATS[] = { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT };
+	const char* ppszMIP_FORMAT_NAMES[] = { "srgb", "half", "float" };
+	for (UINT f = 0; f < _countof(MIP_FORMATS); ++f)
+	{
+		// contents do not change speed of these filters much. zeros avoid denormal and nan paths.
+		std::vector<UCHAR> image;
+		double time = 0.0;
+		for (int i = 0; i < REPEAT_COUNT; ++i)
+		{
+			image.assign(LEVEL0_PIXEL_COUNT * GetPixelSize(MIP_FORMATS[f]), 0);
+			if (MIP_FORMATS[f] == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+			{
+				memcpy(image.data(), src.data(), image.size());
+			}
+
+			UINT mipLevels = 0;
+			double beginTime = GetTestTime();
+			CHECK(SUCCEEDED(GenerateMips(image, SIZE, SIZE, MIP_FORMATS[f], &mipLevels, false)));
+			time += GetTestTime() - beginTime;
+		}
+		printf("%-6s GenerateMips %8.1f MP/s\n", ppszMIP_FORMAT_NAMES[f], toMegaPixelsPerSecond(LEVEL0_PIXEL_COUNT, time));
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,216 @@
+#include "../pch.h"
+#include <DirectXPackedVector.h>
+#include "../Util/Utility.h"
+#include "../Graphics/GraphicsUtil.h"
+#include "../Graphics/ImageProcessing.h"
+#include "TestCommon.h"
+
+using namespace DirectX::PackedVector;
+
+// GenerateMips levels against a per pixel, per channel box filter in double.
+// each level is checked against reference built from previous output level, so rounding does not add up.
+
+static double srgbToLinear(const double C)
+{
+	return (C <= 0.04045 ? C / 12.92 : pow((C + 0.055) / 1.055, 2.4));
+}
+
+static double linearToSRGB(const double LINEAR)
+{
+	return (LINEAR <= 0.0031308 ? LINEAR * 12.92 : 1.055 * pow(LINEAR, 1.0 / 2.4) - 0.055);
+}
+
+static double loadChannel(const UCHAR* pLEVEL, const UINT64 INDEX, const UINT CHANNEL, const DXGI_FORMAT FORMAT)
+{
+	switch (FORMAT)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+			return pLEVEL[INDEX];
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			return (CHANNEL < 3 ? srgbToLinear(pLEVEL[INDEX] / 255.0) : pLEVEL[INDEX]);
+
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			return XMConvertHalfToFloat(((const HALF*)pLEVEL)[INDEX]);
+
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			return ((const float*)pLEVEL)[INDEX];
+
+		default:
+			break;
+	}
+	return 0.0;
+}
+
+// returns true when pLEVEL holds expected value within format's rounding.
+static bool matchChannel(const UCHAR* pLEVEL, const UINT64 INDEX, const UINT CHANNEL, const DXGI_FORMAT FORMAT, const double EXPECTED)
+{
+	switch (FORMAT)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+			// integer sum + 2 >> 2 is exact.
+			return (pLEVEL[INDEX] == (UCHAR)(((UINT)(EXPECTED * 4.0 + 0.5) + 2) >> 2));
+
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			if (CHANNEL == 3)
+			{
+				return (pLEVEL[INDEX] == (UCHAR)(((UINT)(EXPECTED * 4.0 + 0.5) + 2) >> 2));
+			}
+			// 16bit linear intermediate may round to neighbor step.
+			return (fabs(pLEVEL[INDEX] - linearToSRGB(EXPECTED) * 255.0) <= 1.0);
+
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			return (fabs(XMConvertHalfToFloat(((const HALF*)pLEVEL)[INDEX]) - EXPECTED) <= fabs(EXPECTED) / 1024.0 + 1e-7);
+
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			// inputs are within 100, so float partial sums round at about 1e-5 even when result cancels out to near 0.
+			return (fabs(((const float*)pLEVEL)[INDEX] - EXPECTED) <= 1e-4);
+
+		default:
+			break;
+	}
+	return false;
+}
+
+static void fillRandomImage(std::vector<UCHAR>* pImage, const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT, TestRandom* pRandom)
+{
+	const UINT64 CHANNEL_COUNT = (UINT64)WIDTH * HEIGHT * 4;
+	pImage->resize(CHANNEL_COUNT * GetPixelSize(FORMAT) / 4);
+
+	for (UINT64 i = 0; i < CHANNEL_COUNT; ++i)
+	{
+		switch (FORMAT)
+		{
+			case DXGI_FORMAT_R16G16B16A16_FLOAT:
+				((HALF*)pImage->data())[i] = XMConvertFloatToHalf(pRandom->NextFloat() * 8.0f - 2.0f);
+				break;
+
+			case DXGI_FORMAT_R32G32B32A32_FLOAT:
+				((float*)pImage->data())[i] = pRandom->NextFloat() * 100.0f - 20.0f;
+				break;
+
+			default:
+				(*pImage)[i] = (UCHAR)pRandom->NextUInt(256);
+				break;
+		}
+	}
+}
+
+static void testMipChain(const UINT WIDTH, const UINT HEIGHT, const DXGI_FORMAT FORMAT)
+{
+	TestRandom random;
+	std::vector<UCHAR> image;
+	fillRandomImage(&image, WIDTH, HEIGHT, FORMAT, &random);
+
+	UINT mipLevels = 0;
+	CHECK(SUCCEEDED(GenerateMips(image, WIDTH, HEIGHT, FORMAT, &mipLevels, false)));
+	CHECK(mipLevels == GetMipLevelCount(WIDTH, HEIGHT));
+	CHECK(image.size() == GetMipChainSize(WIDTH, HEIGHT, mipLevels, FORMAT));
+
+	UINT mismatchCount = 0;
+	UINT srcWidth = WIDTH;
+	UINT srcHeight = HEIGHT;
+	for (UINT level = 1; level < mipLevels; ++level)
+	{
+		const UCHAR* pSRC = image.data() + GetMipChainSize(WIDTH, HEIGHT, level - 1, FORMAT);
+		const UCHAR* pDST = image.data() + GetMipChainSize(WIDTH, HEIGHT, level, FORMAT);
+		const UINT DST_WIDTH = (srcWidth > 1 ? srcWidth / 2 : 1);
+		const UINT DST_HEIGHT = (srcHeight > 1 ? srcHeight / 2 : 1);
+
+		for (UINT y = 0; y < DST_HEIGHT; ++y)
+		{
+			// clamped to edge for 1 pixel wide/high sources.
+			const UINT Y0 = y * 2;
+			const UINT Y1 = (UINT)Min((int)(y * 2 + 1), (int)srcHeight - 1);
+			for (UINT x = 0; x < DST_WIDTH; ++x)
+			{
+				const UINT X0 = x * 2;
+				const UINT X1 = (UINT)Min((int)(x * 2 + 1), (int)srcWidth - 1);
+				for (UINT c = 0; c < 4; ++c)
+				{
+					const double SUM = loadChannel(pSRC, ((UINT64)Y0 * srcWidth + X0) * 4 + c, c, FORMAT) +
+									   loadChannel(pSRC, ((UINT64)Y0 * srcWidth + X1) * 4 + c, c, FORMAT) +
+									   loadChannel(pSRC, ((UINT64)Y1 * srcWidth + X0) * 4 + c, c, FORMAT) +
+									   loadChannel(pSRC, ((UINT64)Y1 * srcWidth + X1) * 4 + c, c, FORMAT);
+					if (!matchChannel(pDST, ((UINT64)y * DST_WIDTH + x) * 4 + c, c, FORMAT, SUM * 0.25))
+					{
+						++mismatchCount;
+					}
+				}
+			}
+		}
+
+		srcWidth = DST_WIDTH;
+		srcHeight = DST_HEIGHT;
+	}
+
+	if (mismatchCount > 0)
+	{
+		printf("%u x %u format %d: %u channels differ\n", WIDTH, HEIGHT, (int)FORMAT, mismatchCount);
+	}
+	CHECK(mismatchCount == 0);
+}
+
+static void testFormats()
+{
+	const DXGI_FORMAT FORMATS[] =
+	{
+		DXGI_FORMAT_R8G8B8A8_UNORM,
+		DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+		DXGI_FORMAT_R16G16B16A16_FLOAT,
+		DXGI_FORMAT_R32G32B32A32_FLOAT,
+	};
+	// power of two, odd, one pixel wide/high, vector loop with scalar tail.
+	const UINT SIZES[][2] = { { 64, 64 }, { 37, 20 }, { 1, 9 }, { 256, 1 }, { 5, 3 }, { 70, 33 } };
+
+	for (UINT i = 0; i < _countof(FORMATS); ++i)
+	{
+		for (UINT j = 0; j < _countof(SIZES); ++j)
+		{
+			testMipChain(SIZES[j][0], SIZES[j][1], FORMATS[i]);
+		}
+	}
+}
+
+static void testMultiThreadMatches()
+{
+	const UINT SIZE = 1024;
+	TestRandom random;
+	std::vector<UCHAR> singleThreadImage;
+	fillRandomImage(&singleThreadImage, SIZE, SIZE, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, &random);
+	std::vector<UCHAR> multiThreadImage = singleThreadImage;
+
+	UINT singleThreadLevels = 0;
+	UINT multiThreadLevels = 0;
+	CHECK(SUCCEEDED(GenerateMips(singleThreadImage, SIZE, SIZE, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, &singleThreadLevels, false)));
+	CHECK(SUCCEEDED(GenerateMips(multiThreadImage, SIZE, SIZE, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, &multiThreadLevels, true)));
+	CHECK(singleThreadLevels == multiThreadLevels);
+	CHECK(singleThreadImage == multiThreadImage);
+}
+
+static void testLevelCountAndSize()
+{
+	CHECK(GetMipLevelCount(1, 1) == 1);
+	CHECK(GetMipLevelCount(37, 20) == 6);
+	CHECK(GetMipLevelCount(4096, 1) == 13);
+
+	// 4x4 blocks, at least one per level.
+	CHECK(GetMipChainSize(8, 8, 4, DXGI_FORMAT_BC1_UNORM) == (4 + 1 + 1 + 1) * 8);
+	CHECK(GetMipChainSize(4, 2, 3, DXGI_FORMAT_R8G8B8A8_UNORM) == (8 + 2 + 1) * 4);
+
+	// block compressed and unknown formats are left alone.
+	std::vector<UCHAR> image(64);
+	UINT mipLevels = 0;
+	CHECK(GenerateMips(image, 4, 4, DXGI_FORMAT_BC1_UNORM, &mipLevels, false) == E_INVALIDARG);
+	CHECK(mipLevels == 1);
+	CHECK(image.size() == 64);
+}
+
+int main()
+{
+	testFormats();
+	testMultiThreadMatches();
+	testLevelCountAndSize();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,217 @@
+#include "../pch.h"
+#include "../Util/LinearAllocator.h"
+#include "../Renderer/FrameConstantAllocator.h"
+#include "TestCommon.h"
+
+// LinearAllocator offsets, and FrameConstantAllocator ring on top of it against mock upload buffer.
+
+static void testAlignment()
+{
+	LinearAllocator allocator;
+	allocator.Initialize(4096);
+
+	CHECK(allocator.Allocate(1, 1) == 0);
+	CHECK(allocator.Allocate(10, 16) == 16);
+	CHECK(allocator.Allocate(200, 256) == 256);
+	CHECK(allocator.Allocate(4, 4) == 456);
+	CHECK(allocator.Allocate(0, 256) == 512);
+	CHECK(allocator.GetUsedSize() == 512);
+	CHECK(allocator.GetAllocationCount() == 5);
+
+	TestRandom random;
+	LinearAllocator randomAllocator;
+	randomAllocator.Initialize(1 << 20);
+	UINT64 prevEnd = 0;
+	for (UINT i = 0; i < 1000; ++i)
+	{
+		const UINT64 ALIGNMENT = 1ull << random.NextUInt(9);
+		const UINT64 SIZE = random.NextUInt(300) + 1;
+		const UINT64 OFFSET = randomAllocator.Allocate(SIZE, ALIGNMENT);
+		if (OFFSET == UINT64_MAX)
+		{
+			break;
+		}
+		CHECK(OFFSET % ALIGNMENT == 0);
+		CHECK(OFFSET >= prevEnd && OFFSET - prevEnd < ALIGNMENT);
+		prevEnd = OFFSET + SIZE;
+	}
+}
+
+static void testOverflow()
+{
+	LinearAllocator allocator;
+	allocator.Initialize(1024);
+
+	CHECK(allocator.Allocate(1024, 256) == 0);
+	CHECK(allocator.Allocate(1, 1) == UINT64_MAX);
+	CHECK(allocator.GetUsedSize() == 1024 && allocator.GetAllocationCount() == 1);
+
+	allocator.Reset();
+	CHECK(allocator.Allocate(1000, 1) == 0);
+	// aligned offset itself is past end.
+	CHECK(allocator.Allocate(1, 2048) == UINT64_MAX);
+	// aligned offset fits, size doesn't. failed calls leave offset alone.
+	CHECK(allocator.Allocate(24, 8) == 1000);
+	CHECK(allocator.Allocate(1, 256) == UINT64_MAX);
+	CHECK(allocator.GetUsedSize() == 1024);
+
+	// sizes near UINT64_MAX must not wrap around.
+	allocator.Reset();
+	CHECK(allocator.Allocate(8, 1) == 0);
+	CHECK(allocator.Allocate(UINT64_MAX - 4, 1) == UINT64_MAX);
+	CHECK(allocator.GetUsedSize() == 8);
+}
+
+static void testReset()
+{
+	LinearAllocator allocator;
+	allocator.Initialize(2048);
+
+	allocator.Allocate(1500, 256);
+	CHECK(allocator.GetPeakSize() == 1500);
+	allocator.Reset();
+	CHECK(allocator.GetUsedSize() == 0 && allocator.GetAllocationCount() == 0);
+	CHECK(allocator.GetPeakSize() == 1500);
+
+	CHECK(allocator.Allocate(100, 256) == 0);
+	CHECK(allocator.Allocate(100, 256) == 256);
+	CHECK(allocator.GetPeakSize() == 1500);
+}
+
+struct MockBuffer : public ID3D12Resource
+{
+	std::vector<UCHAR> Memory;
+	UINT MapCount = 0;
+
+	HRESULT Map(UINT subresource, const D3D12_RANGE* pReadRange, void** ppData) override
+	{
+		++MapCount;
+		*ppData = Memory.data();
+		return S_OK;
+	}
+	void Unmap(UINT subresource, const D3D12_RANGE* pWrittenRange) override
+	{
+		CHECK(MapCount > 0);
+		--MapCount;
+	}
+	UINT64 GetGPUVirtualAddress() override { return 0x10000; }
+};
+
+struct MockDevice : public ID3D12Device5
+{
+	MockBuffer* pBuffer = nullptr;
+	D3D12_HEAP_TYPE HeapType = D3D12_HEAP_TYPE_DEFAULT;
+
+	HRESULT CreateCommittedResource(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS heapFlags, const D3D12_RESOURCE_DESC* pDesc,
+									D3D12_RESOURCE_STATES initialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource) override
+	{
+		CHECK(!pBuffer);
+		pBuffer = new MockBuffer;
+		pBuffer->Memory.resize(pDesc->Width);
+		HeapType = pHeapProperties->Type;
+		*ppvResource = pBuffer;
+		return S_OK;
+	}
+};
+
+// slices of one frame are packed 256 bytes apart in region of that frame. BeginFrame() frees only region
+// of frame it begins, so slices GPU may still read in other frames keep their data.
+static void testFrameRing()
+{
+	const UINT FRAME_COUNT = 3;
+	const UINT64 SIZE_PER_FRAME = 4096;
+
+	MockDevice device;
+	FrameConstantAllocator allocator;
+	allocator.Initialize(&device, FRAME_COUNT, SIZE_PER_FRAME);
+	CHECK(device.pBuffer && device.pBuffer->Memory.size() == SIZE_PER_FRAME * FRAME_COUNT);
+	CHECK(device.HeapType == D3D12_HEAP_TYPE_UPLOAD);
+	CHECK(device.pBuffer->MapCount == 1);
+	UCHAR* pBASE = device.pBuffer->Memory.data();
+
+	D3D12_GPU_VIRTUAL_ADDRESS pFirstAddresses[FRAME_COUNT] = {};
+	for (UINT frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		allocator.BeginFrame(frame);
+		for (UINT i = 0; i < 5; ++i)
+		{
+			D3D12_GPU_VIRTUAL_ADDRESS address = 0;
+			void* pMappedPtr = nullptr;
+			CHECK(allocator.Allocate(100 + i * 50, &address, &pMappedPtr) == S_OK);
+			CHECK(address % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+			CHECK(address == 0x10000 + SIZE_PER_FRAME * frame + 256 * i);
+			CHECK((UCHAR*)pMappedPtr == pBASE + (address - 0x10000));
+			memset(pMappedPtr, 0x10 + frame, 100 + i * 50);
+			if (i == 0)
+			{
+				pFirstAddresses[frame] = address;
+			}
+		}
+		CHECK(allocator.GetStats().AllocationCount == 5);
+		CHECK(allocator.GetStats().UsedBytes == 256 * 4 + 300);
+	}
+	CHECK(allocator.GetStats().PeakBytes == 256 * 4 + 300);
+
+	// frame 0 comes around again. its region starts over, frames 1 and 2 are untouched.
+	const UINT64 SERIAL = allocator.GetFrameSerial();
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetFrameSerial() == SERIAL + 1);
+	CHECK(allocator.GetStats().AllocationCount == 0 && allocator.GetStats().UsedBytes == 0);
+
+	D3D12_GPU_VIRTUAL_ADDRESS address = 0;
+	void* pMappedPtr = nullptr;
+	CHECK(allocator.Allocate(64, &address, &pMappedPtr) == S_OK);
+	CHECK(address == pFirstAddresses[0]);
+	memset(pMappedPtr, 0xaa, 64);
+	for (UINT frame = 1; frame < FRAME_COUNT; ++frame)
+	{
+		const UCHAR* pREGION = pBASE + SIZE_PER_FRAME * frame;
+		CHECK(pREGION[0] == 0x10 + frame && pREGION[256 * 4 + 299] == 0x10 + frame);
+	}
+
+	// Cleanup() unmaps and releases buffer. test keeps one reference to look at it.
+	device.pBuffer->AddRef();
+	allocator.Cleanup();
+	CHECK(device.pBuffer->MapCount == 0);
+	device.pBuffer->Release();
+}
+
+// frame region running out reports misuse and fails instead of spilling into next frame's region.
+static void testFrameOverflow()
+{
+	MockDevice device;
+	FrameConstantAllocator allocator;
+	allocator.Initialize(&device, 2, 1024);
+	allocator.BeginFrame(0);
+
+	D3D12_GPU_VIRTUAL_ADDRESS address = 0;
+	void* pMappedPtr = nullptr;
+	for (UINT i = 0; i < 4; ++i)
+	{
+		CHECK(allocator.Allocate(256, &address, &pMappedPtr) == S_OK);
+	}
+
+	const LONG BREAK_COUNT = g_HeadlessDebugBreakCount;
+	address = 0;
+	pMappedPtr = nullptr;
+	CHECK(allocator.Allocate(1, &address, &pMappedPtr) == E_OUTOFMEMORY);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 1);
+	CHECK(address == 0 && pMappedPtr == nullptr);
+	CHECK(allocator.GetStats().UsedBytes == 1024);
+
+	// next frame has its own region.
+	allocator.BeginFrame(1);
+	CHECK(allocator.Allocate(1024, &address, &pMappedPtr) == S_OK);
+	CHECK(address == 0x10000 + 1024);
+}
+
+int main()
+{
+	testAlignment();
+	testOverflow();
+	testReset();
+	testFrameRing();
+	testFrameOverflow();
+
+	return TEST_RESULT();
+}
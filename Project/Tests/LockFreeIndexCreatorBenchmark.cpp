@@ -0,0 +1,107 @@
+#include "../pch.h"
+#include "../Util/IndexCreator.h"
+#include "../Util/LockFreeIndexCreator.h"
+#include "TestCommon.h"
+
+#include <thread>
+
+// LockFreeIndexCreator against IndexCreator behind CRITICAL_SECTION, as PersistentDescriptorPool had it,
+// at 1 thread up to twice hardware threads. each thread holds few indices and takes and gives back one at a time,
+// like recording threads taking descriptor pages. reports ns per alloc/free pair per thread and total pairs per second.
+//   LockFreeIndexCreatorBenchmark [pairs per thread, default 1000000]
+
+static const ULONG INDEX_COUNT = 1024;
+static const UINT HELD_COUNT = 8;
+
+class LockedIndexCreator
+{
+public:
+	LockedIndexCreator() { InitializeCriticalSection(&m_CS); }
+	~LockedIndexCreator() { DeleteCriticalSection(&m_CS); }
+
+	void Initialize(ULONG num) { m_IndexCreator.Initialize(num); }
+
+	ULONG Alloc()
+	{
+		EnterCriticalSection(&m_CS);
+		const ULONG INDEX = m_IndexCreator.Alloc();
+		LeaveCriticalSection(&m_CS);
+		return INDEX;
+	}
+
+	void Free(ULONG index)
+	{
+		EnterCriticalSection(&m_CS);
+		m_IndexCreator.Free(index);
+		LeaveCriticalSection(&m_CS);
+	}
+
+private:
+	CRITICAL_SECTION m_CS;
+	IndexCreator m_IndexCreator;
+};
+
+template <typename T>
+static double run(const UINT THREAD_COUNT, const UINT PAIR_COUNT)
+{
+	T indexCreator;
+	indexCreator.Initialize(INDEX_COUNT);
+
+	volatile LONG failCount = 0;
+	std::vector<std::thread> threads;
+	const double BEGIN_TIME = GetTestTime();
+	for (UINT threadIndex = 0; threadIndex < THREAD_COUNT; ++threadIndex)
+	{
+		threads.emplace_back([&]()
+							 {
+								 ULONG pHeld[HELD_COUNT];
+								 for (UINT i = 0; i < HELD_COUNT; ++i)
+								 {
+									 pHeld[i] = indexCreator.Alloc();
+								 }
+								 for (UINT i = 0; i < PAIR_COUNT; ++i)
+								 {
+									 const UINT SLOT = i % HELD_COUNT;
+									 indexCreator.Free(pHeld[SLOT]);
+									 pHeld[SLOT] = indexCreator.Alloc();
+									 if (pHeld[SLOT] == 0xffff)
+									 {
+										 InterlockedIncrement(&failCount);
+										 return;
+									 }
+								 }
+								 for (UINT i = 0; i < HELD_COUNT; ++i)
+								 {
+									 indexCreator.Free(pHeld[i]);
+								 }
+							 });
+	}
+	for (UINT64 i = 0, size = threads.size(); i < size; ++i)
+	{
+		threads[i].join();
+	}
+	const double TIME = GetTestTime() - BEGIN_TIME;
+
+	CHECK(failCount == 0);
+	return TIME;
+}
+
+int main(int argc, char** argv)
+{
+	const UINT PAIR_COUNT = (argc > 1 ? (UINT)atoi(argv[1]) : 1000000);
+	const UINT HARDWARE_THREAD_COUNT = std::thread::hardware_concurrency();
+	printf("%u indices, %u held per thread, %u pairs per thread, %u hardware threads\n", INDEX_COUNT, HELD_COUNT, PAIR_COUNT, HARDWARE_THREAD_COUNT);
+	printf("threads   lock free ns/pair  Mpairs/s   locked ns/pair  Mpairs/s\n");
+
+	for (UINT threadCount = 1; threadCount <= HARDWARE_THREAD_COUNT * 2 && threadCount * HELD_COUNT <= INDEX_COUNT; threadCount *= 2)
+	{
+		const double LOCK_FREE_TIME = run<LockFreeIndexCreator>(threadCount, PAIR_COUNT);
+		const double LOCKED_TIME = run<LockedIndexCreator>(threadCount, PAIR_COUNT);
+		const double TOTAL_PAIR_COUNT = (double)threadCount * (double)PAIR_COUNT;
+		printf("%7u   %17.1f  %8.2f   %14.1f  %8.2f\n", threadCount,
+			   LOCK_FREE_TIME * 1e9 / (double)PAIR_COUNT, TOTAL_PAIR_COUNT / LOCK_FREE_TIME * 1e-6,
+			   LOCKED_TIME * 1e9 / (double)PAIR_COUNT, TOTAL_PAIR_COUNT / LOCKED_TIME * 1e-6);
+	}
+
+	return TEST_RESULT();
+}
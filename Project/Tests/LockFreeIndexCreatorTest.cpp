@@ -0,0 +1,154 @@
+#include "../pch.h"
+#include "../Util/LockFreeIndexCreator.h"
+#include "TestCommon.h"
+
+#include <set>
+#include <thread>
+
+static void testBasic()
+{
+	LockFreeIndexCreator indexCreator;
+	indexCreator.Initialize(8);
+
+	std::set<ULONG> indices;
+	for (int i = 0; i < 8; ++i)
+	{
+		const ULONG INDEX = indexCreator.Alloc();
+		CHECK(INDEX < 8);
+		indices.insert(INDEX);
+	}
+	CHECK(indices.size() == 8);
+	CHECK(indexCreator.Alloc() == 0xffff);
+	CHECK(indexCreator.GetFailCount() == 1);
+	CHECK(indexCreator.GetHighWater() == 8);
+
+	// freed index comes back first.
+	indexCreator.Free(5);
+	indexCreator.Free(2);
+	CHECK(indexCreator.Alloc() == 2);
+	CHECK(indexCreator.Alloc() == 5);
+	CHECK(indexCreator.GetAllocatedCount() == 8);
+
+	for (ULONG i = 0; i < 8; ++i)
+	{
+		indexCreator.Free(i);
+	}
+	CHECK(indexCreator.GetAllocatedCount() == 0);
+	indexCreator.ResetHighWater();
+	CHECK(indexCreator.GetHighWater() == 0);
+
+	// freeing more than allocated or out of range breaks and changes nothing.
+	const LONG BREAK_COUNT = g_HeadlessDebugBreakCount;
+	indexCreator.Free(3);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 1);
+	CHECK(indexCreator.GetAllocatedCount() == 0);
+	indexCreator.Free(100);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 2);
+
+	// still usable after bad free.
+	const ULONG INDEX = indexCreator.Alloc();
+	CHECK(INDEX < 8 && indexCreator.GetAllocatedCount() == 1);
+	indexCreator.Free(INDEX);
+	indexCreator.Check();
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 2);
+}
+
+// threads take and give back indices at random. owner table catches index handed to two threads at once,
+// few indices against many threads keep head hot, so ABA gets its chance.
+static void testStress(const ULONG NUM, const UINT THREAD_COUNT, const UINT HELD_MAX, const int STEP_COUNT)
+{
+	LockFreeIndexCreator indexCreator;
+	indexCreator.Initialize(NUM);
+
+	std::vector<LONG> owners(NUM, 0);
+	volatile LONG errorCount = 0;
+	volatile LONG failCount = 0;
+
+	std::vector<std::thread> threads;
+	for (UINT threadIndex = 0; threadIndex < THREAD_COUNT; ++threadIndex)
+	{
+		threads.emplace_back([&, threadIndex]()
+							 {
+								 const LONG OWNER = (LONG)threadIndex + 1;
+								 TestRandom random;
+								 random.State ^= (UINT64)OWNER * 0x9E3779B97F4A7C15ull;
+								 std::vector<ULONG> held;
+
+								 for (int step = 0; step < STEP_COUNT; ++step)
+								 {
+									 if (held.size() < HELD_MAX && (held.empty() || random.NextUInt(2) == 0))
+									 {
+										 const ULONG INDEX = indexCreator.Alloc();
+										 if (INDEX == 0xffff)
+										 {
+											 InterlockedIncrement(&failCount);
+											 continue;
+										 }
+										 if (INDEX >= NUM || InterlockedCompareExchange(&owners[INDEX], OWNER, 0) != 0)
+										 {
+											 InterlockedIncrement(&errorCount);
+											 continue;
+										 }
+										 held.push_back(INDEX);
+									 }
+									 else
+									 {
+										 const UINT SLOT = random.NextUInt((UINT)held.size());
+										 const ULONG INDEX = held[SLOT];
+										 held[SLOT] = held.back();
+										 held.pop_back();
+										 if (InterlockedCompareExchange(&owners[INDEX], 0, OWNER) != OWNER)
+										 {
+											 InterlockedIncrement(&errorCount);
+										 }
+										 indexCreator.Free(INDEX);
+									 }
+								 }
+
+								 for (UINT64 i = 0, size = held.size(); i < size; ++i)
+								 {
+									 InterlockedExchange(&owners[held[i]], 0);
+									 indexCreator.Free(held[i]);
+								 }
+							 });
+	}
+	for (UINT64 i = 0, size = threads.size(); i < size; ++i)
+	{
+		threads[i].join();
+	}
+
+	CHECK(errorCount == 0);
+	CHECK(indexCreator.GetAllocatedCount() == 0);
+	CHECK(indexCreator.GetHighWater() <= NUM);
+	CHECK(indexCreator.GetFailCount() == (ULONG)failCount);
+	if (NUM < THREAD_COUNT * HELD_MAX)
+	{
+		CHECK(failCount > 0);
+	}
+
+	// no index lost or doubled in free stack.
+	std::set<ULONG> indices;
+	for (ULONG i = 0; i < NUM; ++i)
+	{
+		indices.insert(indexCreator.Alloc());
+	}
+	CHECK(indices.size() == NUM && *indices.rbegin() < NUM);
+	CHECK(indexCreator.Alloc() == 0xffff);
+	for (std::set<ULONG>::iterator iter = indices.begin(); iter != indices.end(); ++iter)
+	{
+		indexCreator.Free(*iter);
+	}
+}
+
+int main()
+{
+	testBasic();
+
+	const UINT HARDWARE_THREAD_COUNT = std::thread::hardware_concurrency();
+	const UINT THREAD_COUNT = (HARDWARE_THREAD_COUNT > 4 ? HARDWARE_THREAD_COUNT : 4);
+	testStress(16, THREAD_COUNT, 4, 200000);
+	testStress(1024, THREAD_COUNT, 16, 200000);
+	testStress(4, THREAD_COUNT * 2, 2, 100000);
+
+	return TEST_RESULT();
+}
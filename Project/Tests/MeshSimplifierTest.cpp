@@ -0,0 +1,253 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Model/MeshSimplifier.h"
+#include "TestCommon.h"
+
+// welded uv sphere of radius 1. no seam, so nothing is locked.
+static void makeSphere(MeshInfo* pMeshInfo, const UINT SLICE_COUNT, const UINT STACK_COUNT)
+{
+	const float PI = 3.14159265f;
+
+	pMeshInfo->Vertices.clear();
+	pMeshInfo->Indices.clear();
+
+	Vertex top;
+	top.Position = Vector3(0.0f, 1.0f, 0.0f);
+	top.Normal = top.Position;
+	pMeshInfo->Vertices.push_back(top);
+	for (UINT stack = 1; stack < STACK_COUNT; ++stack)
+	{
+		const float THETA = PI * (float)stack / (float)STACK_COUNT;
+		for (UINT slice = 0; slice < SLICE_COUNT; ++slice)
+		{
+			const float PHI = 2.0f * PI * (float)slice / (float)SLICE_COUNT;
+			Vertex v;
+			v.Position = Vector3(sinf(THETA) * cosf(PHI), cosf(THETA), sinf(THETA) * sinf(PHI));
+			v.Normal = v.Position;
+			pMeshInfo->Vertices.push_back(v);
+		}
+	}
+	Vertex bottom;
+	bottom.Position = Vector3(0.0f, -1.0f, 0.0f);
+	bottom.Normal = bottom.Position;
+	pMeshInfo->Vertices.push_back(bottom);
+
+	const UINT BOTTOM = (UINT)pMeshInfo->Vertices.size() - 1;
+	auto ring = [SLICE_COUNT](UINT stack, UINT slice) { return 1 + (stack - 1) * SLICE_COUNT + slice % SLICE_COUNT; };
+	for (UINT slice = 0; slice < SLICE_COUNT; ++slice)
+	{
+		pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { 0, ring(1, slice + 1), ring(1, slice) });
+	}
+	for (UINT stack = 1; stack < STACK_COUNT - 1; ++stack)
+	{
+		for (UINT slice = 0; slice < SLICE_COUNT; ++slice)
+		{
+			const UINT A = ring(stack, slice);
+			const UINT B = ring(stack, slice + 1);
+			const UINT C = ring(stack + 1, slice);
+			const UINT D = ring(stack + 1, slice + 1);
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { A, B, C, B, D, C });
+		}
+	}
+	for (UINT slice = 0; slice < SLICE_COUNT; ++slice)
+	{
+		pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { BOTTOM, ring(STACK_COUNT - 1, slice), ring(STACK_COUNT - 1, slice + 1) });
+	}
+}
+
+// flat grid on y = 0 with open border.
+static void makeGrid(MeshInfo* pMeshInfo, const UINT CELL_COUNT)
+{
+	pMeshInfo->Vertices.clear();
+	pMeshInfo->Indices.clear();
+
+	for (UINT z = 0; z <= CELL_COUNT; ++z)
+	{
+		for (UINT x = 0; x <= CELL_COUNT; ++x)
+		{
+			Vertex v;
+			v.Position = Vector3((float)x / (float)CELL_COUNT, 0.0f, (float)z / (float)CELL_COUNT);
+			v.Normal = Vector3(0.0f, 1.0f, 0.0f);
+			v.Texcoord = Vector2(v.Position.x, v.Position.z);
+			pMeshInfo->Vertices.push_back(v);
+		}
+	}
+	for (UINT z = 0; z < CELL_COUNT; ++z)
+	{
+		for (UINT x = 0; x < CELL_COUNT; ++x)
+		{
+			const UINT A = z * (CELL_COUNT + 1) + x;
+			const UINT B = A + 1;
+			const UINT C = A + CELL_COUNT + 1;
+			const UINT D = C + 1;
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { A, C, B, B, C, D });
+		}
+	}
+}
+
+static bool isValidIndexList(const MeshInfo& MESH_INFO, const std::vector<UINT>& INDICES)
+{
+	if (INDICES.size() % 3 != 0)
+	{
+		return false;
+	}
+	for (UINT64 i = 0, size = INDICES.size(); i < size; i += 3)
+	{
+		if (INDICES[i] >= MESH_INFO.Vertices.size() || INDICES[i + 1] >= MESH_INFO.Vertices.size() || INDICES[i + 2] >= MESH_INFO.Vertices.size())
+		{
+			return false;
+		}
+		if (INDICES[i] == INDICES[i + 1] || INDICES[i + 1] == INDICES[i + 2] || INDICES[i] == INDICES[i + 2])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// largest distance of triangle centroids to unit sphere. LOD 0 has chord sag too.
+static float getSphereDeviation(const MeshInfo& MESH_INFO, const std::vector<UINT>& INDICES)
+{
+	float maxDeviation = 0.0f;
+	for (UINT64 i = 0, size = INDICES.size(); i < size; i += 3)
+	{
+		Vector3 centroid = (MESH_INFO.Vertices[INDICES[i]].Position + MESH_INFO.Vertices[INDICES[i + 1]].Position + MESH_INFO.Vertices[INDICES[i + 2]].Position) / 3.0f;
+		maxDeviation = Max(maxDeviation, 1.0f - centroid.Length());
+	}
+	return maxDeviation;
+}
+
+static void testSphereChain()
+{
+	MeshInfo sphere;
+	makeSphere(&sphere, 64, 32);
+
+	LODSetting setting;
+	setting.MaxError = 0.05f;
+	GenerateLODs(&sphere, setting);
+
+	const float BASE_DEVIATION = getSphereDeviation(sphere, sphere.Indices);
+	CHECK(!sphere.LODs.empty());
+	CHECK(sphere.LODs.size() <= MAX_MESH_LOD_COUNT - 1);
+
+	UINT64 prevTriangleCount = sphere.Indices.size() / 3;
+	float prevError = 0.0f;
+	for (UINT64 i = 0, size = sphere.LODs.size(); i < size; ++i)
+	{
+		const MeshLOD& LOD = sphere.LODs[i];
+		const UINT64 TRIANGLE_COUNT = LOD.Indices.size() / 3;
+		const float DEVIATION = getSphereDeviation(sphere, LOD.Indices);
+
+		printf("sphere LOD%u: %u -> %u triangles(%.1f%%), error %f, centroid deviation %f\n", (UINT)i + 1, (UINT)(sphere.Indices.size() / 3), (UINT)TRIANGLE_COUNT,
+			   100.0f * (float)TRIANGLE_COUNT / (float)(sphere.Indices.size() / 3), LOD.Error, DEVIATION);
+
+		CHECK(isValidIndexList(sphere, LOD.Indices));
+
+		// each LOD removes at least 10%, and lands near requested ratio unless error limit stopped it.
+		CHECK(TRIANGLE_COUNT <= prevTriangleCount * 9 / 10);
+		CHECK(TRIANGLE_COUNT >= (UINT64)((float)prevTriangleCount * setting.TriangleRatio * 0.9f));
+
+		// recorded error accumulates, stays under limit per step and bounds real deviation.
+		CHECK(LOD.Error >= prevError);
+		CHECK(LOD.Error - prevError <= setting.MaxError);
+		CHECK(DEVIATION <= BASE_DEVIATION + LOD.Error);
+
+		prevTriangleCount = TRIANGLE_COUNT;
+		prevError = LOD.Error;
+	}
+}
+
+static void testErrorLimit()
+{
+	MeshInfo sphere;
+	makeSphere(&sphere, 64, 32);
+
+	// any collapse on curved surface costs more than this.
+	LODSetting setting;
+	setting.MaxError = 1e-6f;
+	GenerateLODs(&sphere, setting);
+	CHECK(sphere.LODs.empty());
+}
+
+static void testFlatGridKeepsBorder()
+{
+	const UINT CELL_COUNT = 32;
+
+	MeshInfo grid;
+	makeGrid(&grid, CELL_COUNT);
+
+	// coplanar collapses are free, so even tiny limit allows reduction.
+	LODSetting setting;
+	setting.MaxError = 1e-6f;
+	GenerateLODs(&grid, setting);
+	CHECK(!grid.LODs.empty());
+
+	for (UINT64 i = 0, size = grid.LODs.size(); i < size; ++i)
+	{
+		const MeshLOD& LOD = grid.LODs[i];
+		CHECK(isValidIndexList(grid, LOD.Indices));
+		CHECK(LOD.Error <= 1e-5f);
+
+		// border is locked, so every border vertex is still referenced.
+		std::vector<bool> bUsed(grid.Vertices.size(), false);
+		for (UINT64 j = 0, indexCount = LOD.Indices.size(); j < indexCount; ++j)
+		{
+			bUsed[LOD.Indices[j]] = true;
+		}
+		UINT missingBorderCount = 0;
+		for (UINT z = 0; z <= CELL_COUNT; ++z)
+		{
+			for (UINT x = 0; x <= CELL_COUNT; ++x)
+			{
+				if ((x == 0 || z == 0 || x == CELL_COUNT || z == CELL_COUNT) && !bUsed[z * (CELL_COUNT + 1) + x])
+				{
+					++missingBorderCount;
+				}
+			}
+		}
+		CHECK(missingBorderCount == 0);
+
+		// area is kept.
+		float area = 0.0f;
+		for (UINT64 j = 0, indexCount = LOD.Indices.size(); j < indexCount; j += 3)
+		{
+			const Vector3& P0 = grid.Vertices[LOD.Indices[j]].Position;
+			const Vector3& P1 = grid.Vertices[LOD.Indices[j + 1]].Position;
+			const Vector3& P2 = grid.Vertices[LOD.Indices[j + 2]].Position;
+			area += (P1 - P0).Cross(P2 - P0).Length() * 0.5f;
+		}
+		CHECK(fabsf(area - 1.0f) < 1e-3f);
+
+		printf("grid LOD%u: %u -> %u triangles, error %f\n", (UINT)i + 1, (UINT)(grid.Indices.size() / 3), (UINT)(LOD.Indices.size() / 3), LOD.Error);
+	}
+}
+
+static void testSmallMeshHasNoChain()
+{
+	MeshInfo sphere;
+	makeSphere(&sphere, 8, 4);
+
+	std::vector<MeshLOD> lods;
+	GenerateLODs(sphere, LODSetting(), &lods);
+	CHECK(sphere.Indices.size() / 3 < LODSetting().MinTriangleCount);
+	CHECK(lods.empty());
+}
+
+static void testScreenSpaceError()
+{
+	// error of 1 at distance 1 with 90 degree fov covers half of screen height.
+	const float PIXEL_ERROR = ComputeScreenSpaceError(1.0f, 1.0f, 3.14159265f * 0.5f, 1000.0f);
+	CHECK(fabsf(PIXEL_ERROR - 500.0f) < 1.0f);
+	CHECK(ComputeScreenSpaceError(1.0f, 2.0f, 3.14159265f * 0.5f, 1000.0f) < PIXEL_ERROR);
+}
+
+int main()
+{
+	testSphereChain();
+	testErrorLimit();
+	testFlatGridKeepsBorder();
+	testSmallMeshHasNoChain();
+	testScreenSpaceError();
+
+	return TEST_RESULT();
+}
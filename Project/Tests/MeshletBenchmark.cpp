@@ -0,0 +1,157 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Model/MeshletBuilder.h"
+#include "TestCommon.h"
+
+// culled triangle ratio and cost of CullMeshlets over a set of views.
+// frustum looks down +z. see Headless/DirectXCollision.h.
+
+static void makeSphere(MeshInfo* pMeshInfo, const UINT SLICE_COUNT, const UINT STACK_COUNT)
+{
+	const float PI = 3.14159265f;
+
+	for (UINT stack = 0; stack <= STACK_COUNT; ++stack)
+	{
+		const float THETA = PI * (float)stack / (float)STACK_COUNT;
+		for (UINT slice = 0; slice <= SLICE_COUNT; ++slice)
+		{
+			const float PHI = 2.0f * PI * (float)slice / (float)SLICE_COUNT;
+			Vertex v;
+			v.Position = Vector3(sinf(THETA) * cosf(PHI), cosf(THETA), sinf(THETA) * sinf(PHI));
+			v.Normal = v.Position;
+			pMeshInfo->Vertices.push_back(v);
+		}
+	}
+	for (UINT stack = 0; stack < STACK_COUNT; ++stack)
+	{
+		for (UINT slice = 0; slice < SLICE_COUNT; ++slice)
+		{
+			const UINT A = stack * (SLICE_COUNT + 1) + slice;
+			const UINT B = A + 1;
+			const UINT C = A + SLICE_COUNT + 1;
+			const UINT D = C + 1;
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { A, B, C, B, D, C });
+		}
+	}
+}
+
+static void makeTerrain(MeshInfo* pMeshInfo, const UINT CELL_COUNT, const float SIZE)
+{
+	for (UINT z = 0; z <= CELL_COUNT; ++z)
+	{
+		for (UINT x = 0; x <= CELL_COUNT; ++x)
+		{
+			const float PX = SIZE * (float)x / (float)CELL_COUNT;
+			const float PZ = SIZE * (float)z / (float)CELL_COUNT;
+			Vertex v;
+			v.Position = Vector3(PX, 0.5f * sinf(PX * 0.7f) * cosf(PZ * 0.5f), PZ);
+			v.Normal = Vector3(0.0f, 1.0f, 0.0f);
+			pMeshInfo->Vertices.push_back(v);
+		}
+	}
+	for (UINT z = 0; z < CELL_COUNT; ++z)
+	{
+		for (UINT x = 0; x < CELL_COUNT; ++x)
+		{
+			const UINT A = z * (CELL_COUNT + 1) + x;
+			const UINT B = A + 1;
+			const UINT C = A + CELL_COUNT + 1;
+			const UINT D = C + 1;
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { A, C, B, B, C, D });
+		}
+	}
+}
+
+static void runScene(const char* pszName, MeshInfo* pMeshInfo, const std::vector<Vector3>& EYES, const DirectX::BoundingFrustum& FRUSTUM)
+{
+	const UINT TRIANGLE_COUNT = (UINT)(pMeshInfo->Indices.size() / 3);
+
+	double beginTime = GetTestTime();
+	BuildMeshlets(pMeshInfo);
+	const double BUILD_TIME = GetTestTime() - beginTime;
+
+	UINT meshletTriangleCount = 0;
+	for (UINT64 i = 0, size = pMeshInfo->Meshlets.size(); i < size; ++i)
+	{
+		const Meshlet& MESHLET = pMeshInfo->Meshlets[i];
+		_ASSERT(MESHLET.VertexCount <= MAX_MESHLET_VERTICES && MESHLET.TriangleCount <= MAX_MESHLET_TRIANGLES);
+		meshletTriangleCount += MESHLET.TriangleCount;
+	}
+	_ASSERT(meshletTriangleCount == TRIANGLE_COUNT);
+
+	const UINT REPEAT_COUNT = 200;
+	std::vector<MeshletDrawRange> drawRanges;
+	UINT64 culledTriangleCount = 0;
+	UINT64 rangeCount = 0;
+
+	beginTime = GetTestTime();
+	for (UINT repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+	{
+		for (UINT64 i = 0, size = EYES.size(); i < size; ++i)
+		{
+			DirectX::BoundingFrustum frustum = FRUSTUM;
+			frustum.Origin = EYES[i];
+
+			const UINT CULLED = CullMeshlets(pMeshInfo->Meshlets, frustum, EYES[i], &drawRanges);
+			if (repeat == 0)
+			{
+				culledTriangleCount += CULLED;
+				rangeCount += drawRanges.size();
+			}
+		}
+	}
+	const double CULL_TIME = GetTestTime() - beginTime;
+	const UINT64 VIEW_COUNT = EYES.size();
+
+	printf("%s: %u triangles -> %u meshlets(%.1f triangles avg), build %.2f ms\n", pszName, TRIANGLE_COUNT, (UINT)pMeshInfo->Meshlets.size(),
+		   (double)TRIANGLE_COUNT / (double)pMeshInfo->Meshlets.size(), BUILD_TIME * 1000.0);
+	printf("  %u views: culled %.1f%% of triangles, %.1f draw ranges per view, %.2f us per CullMeshlets\n", (UINT)VIEW_COUNT,
+		   100.0 * (double)culledTriangleCount / (double)(VIEW_COUNT * TRIANGLE_COUNT), (double)rangeCount / (double)VIEW_COUNT,
+		   CULL_TIME * 1e6 / (double)(VIEW_COUNT * REPEAT_COUNT));
+}
+
+int main()
+{
+	DirectX::BoundingFrustum frustum;
+	frustum.RightSlope = 0.6f;
+	frustum.LeftSlope = -0.6f;
+	frustum.TopSlope = 0.4f;
+	frustum.BottomSlope = -0.4f;
+	frustum.Near = 0.1f;
+
+	// closed object seen from outside. backface cones do most of culling.
+	{
+		MeshInfo sphere;
+		makeSphere(&sphere, 256, 128);
+
+		std::vector<Vector3> eyes;
+		for (int y = -4; y <= 4; ++y)
+		{
+			for (int x = -4; x <= 4; ++x)
+			{
+				eyes.push_back(Vector3((float)x * 0.4f, (float)y * 0.4f, -3.0f));
+			}
+		}
+		frustum.Far = 100.0f;
+		runScene("sphere", &sphere, eyes, frustum);
+	}
+
+	// large open mesh seen from inside. frustum does most of culling.
+	{
+		MeshInfo terrain;
+		makeTerrain(&terrain, 256, 64.0f);
+
+		std::vector<Vector3> eyes;
+		for (int z = 0; z < 8; ++z)
+		{
+			for (int x = 0; x < 8; ++x)
+			{
+				eyes.push_back(Vector3(4.0f + (float)x * 8.0f, 2.0f, -4.0f + (float)z * 8.0f));
+			}
+		}
+		frustum.Far = 24.0f;
+		runScene("terrain", &terrain, eyes, frustum);
+	}
+
+	return 0;
+}
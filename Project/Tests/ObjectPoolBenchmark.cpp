@@ -0,0 +1,136 @@
+#include "../pch.h"
+#include "../Util/ObjectPool.h"
+#include "TestCommon.h"
+
+#include <thread>
+
+// ObjectPool with thread caches against new/delete and against one pool cache behind CRITICAL_SECTION,
+// at 1 thread up to hardware threads. each thread keeps window of items and replaces random one per step,
+// some freed items go to next thread so blocks cross caches. reports ns per alloc/free pair per thread.
+//   ObjectPoolBenchmark [pairs per thread, default 2000000]
+
+static const UINT WINDOW_SIZE = 256;
+
+struct Item
+{
+	ID3D12CommandAllocator* pCommandAllocator;
+	ID3D12GraphicsCommandList* pCommandList;
+	void* pLinks[2];
+	UINT64 Payload[4];
+};
+
+struct NewDeleteAllocator
+{
+	void Initialize(UINT) {}
+	Item* Alloc(UINT) { return new Item(); }
+	void Free(Item* pItem, UINT) { delete pItem; }
+};
+
+struct CachedPoolAllocator
+{
+	void Initialize(UINT threadCount) { Pool.Initialize(256, 0, threadCount); }
+	Item* Alloc(UINT threadIndex) { return Pool.Alloc(threadIndex); }
+	void Free(Item* pItem, UINT threadIndex) { Pool.Free(pItem, threadIndex); }
+
+	ObjectPool<Item> Pool;
+};
+
+struct LockedPoolAllocator
+{
+	LockedPoolAllocator() { InitializeCriticalSection(&CS); }
+	~LockedPoolAllocator() { DeleteCriticalSection(&CS); }
+
+	void Initialize(UINT) { Pool.Initialize(256, 0); }
+	Item* Alloc(UINT)
+	{
+		EnterCriticalSection(&CS);
+		Item* pItem = Pool.Alloc();
+		LeaveCriticalSection(&CS);
+		return pItem;
+	}
+	void Free(Item* pItem, UINT)
+	{
+		EnterCriticalSection(&CS);
+		Pool.Free(pItem);
+		LeaveCriticalSection(&CS);
+	}
+
+	CRITICAL_SECTION CS;
+	ObjectPool<Item> Pool;
+};
+
+template <typename T>
+static double run(const UINT THREAD_COUNT, const UINT PAIR_COUNT)
+{
+	T allocator;
+	allocator.Initialize(THREAD_COUNT);
+
+	// one slot per thread, filled by previous thread.
+	std::vector<void*> mailboxes(THREAD_COUNT, nullptr);
+	std::vector<std::thread> threads;
+	const double BEGIN_TIME = GetTestTime();
+	for (UINT threadIndex = 0; threadIndex < THREAD_COUNT; ++threadIndex)
+	{
+		threads.emplace_back([&, threadIndex]()
+							 {
+								 TestRandom random;
+								 random.State ^= (UINT64)(threadIndex + 1) * 0x9E3779B97F4A7C15ull;
+								 Item* ppWindow[WINDOW_SIZE];
+								 for (UINT i = 0; i < WINDOW_SIZE; ++i)
+								 {
+									 ppWindow[i] = allocator.Alloc(threadIndex);
+								 }
+
+								 void** ppNextMailbox = &mailboxes[(threadIndex + 1) % THREAD_COUNT];
+								 for (UINT i = 0; i < PAIR_COUNT; ++i)
+								 {
+									 const UINT SLOT = random.NextUInt(WINDOW_SIZE);
+									 Item* pItem = ppWindow[SLOT];
+									 if (THREAD_COUNT > 1 && i % 16 == 0)
+									 {
+										 // hand to next thread, free what it left for it.
+										 pItem = (Item*)InterlockedExchangePointer(ppNextMailbox, pItem);
+									 }
+									 if (pItem)
+									 {
+										 allocator.Free(pItem, threadIndex);
+									 }
+									 ppWindow[SLOT] = allocator.Alloc(threadIndex);
+									 ppWindow[SLOT]->Payload[0] = i;
+								 }
+
+								 for (UINT i = 0; i < WINDOW_SIZE; ++i)
+								 {
+									 allocator.Free(ppWindow[i], threadIndex);
+								 }
+							 });
+	}
+	for (UINT64 i = 0, size = threads.size(); i < size; ++i)
+	{
+		threads[i].join();
+	}
+	for (UINT i = 0; i < THREAD_COUNT; ++i)
+	{
+		allocator.Free((Item*)mailboxes[i], 0);
+	}
+	return GetTestTime() - BEGIN_TIME;
+}
+
+int main(int argc, char** argv)
+{
+	const UINT PAIR_COUNT = (argc > 1 ? (UINT)atoi(argv[1]) : 2000000);
+	const UINT HARDWARE_THREAD_COUNT = std::thread::hardware_concurrency();
+	printf("%u byte items, window %u, %u pairs per thread, %u hardware threads\n", (UINT)sizeof(Item), WINDOW_SIZE, PAIR_COUNT, HARDWARE_THREAD_COUNT);
+	printf("threads   pool ns/pair   locked pool ns/pair   new/delete ns/pair\n");
+
+	for (UINT threadCount = 1; threadCount <= (HARDWARE_THREAD_COUNT > 1 ? HARDWARE_THREAD_COUNT : 2); threadCount *= 2)
+	{
+		const double POOL_TIME = run<CachedPoolAllocator>(threadCount, PAIR_COUNT);
+		const double LOCKED_TIME = run<LockedPoolAllocator>(threadCount, PAIR_COUNT);
+		const double NEW_DELETE_TIME = run<NewDeleteAllocator>(threadCount, PAIR_COUNT);
+		printf("%7u   %12.1f   %19.1f   %18.1f\n", threadCount,
+			   POOL_TIME * 1e9 / (double)PAIR_COUNT, LOCKED_TIME * 1e9 / (double)PAIR_COUNT, NEW_DELETE_TIME * 1e9 / (double)PAIR_COUNT);
+	}
+
+	return TEST_RESULT();
+}
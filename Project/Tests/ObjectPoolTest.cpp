@@ -0,0 +1,255 @@
+#include "../pch.h"
+#include "../Util/ObjectPool.h"
+#include "TestCommon.h"
+
+#include <set>
+#include <thread>
+
+// built with _DEBUG, so poison checks run.
+
+struct Item
+{
+	UINT64 Owner;
+	UINT64 Value;
+	UINT Tag;
+};
+
+static int s_DestructCount = 0;
+
+struct CountedItem
+{
+	~CountedItem() { ++s_DestructCount; }
+	UINT64 Value[3];
+};
+
+static void testBasic()
+{
+	ObjectPool<Item> pool;
+	pool.Initialize(4, 0);
+
+	// value initialized, handed out in address order.
+	Item* pA = pool.Alloc();
+	Item* pB = pool.Alloc();
+	CHECK(pA && pB && pA->Owner == 0 && pA->Value == 0 && pA->Tag == 0);
+	CHECK((BYTE*)pB - (BYTE*)pA == sizeof(Item));
+	pA->Value = 7;
+
+	Item* ppItems[8] = {};
+	for (UINT i = 0; i < 8; ++i)
+	{
+		ppItems[i] = pool.Alloc();
+		CHECK(ppItems[i]);
+	}
+	CHECK(pool.GetStats().AllocatedCount == 10);
+	CHECK(pool.GetStats().ChunkCount == 3);
+
+	// freed block comes back first.
+	pool.Free(pB);
+	Item* pC = pool.Alloc();
+	CHECK(pC == pB && pC->Value == 0);
+
+	pool.Free(pA);
+	pool.Free(pC);
+	for (UINT i = 0; i < 8; ++i)
+	{
+		pool.Free(ppItems[i]);
+	}
+	pool.Free(nullptr);
+	CHECK(pool.GetStats().AllocatedCount == 0);
+	CHECK(pool.GetStats().PeakCount == 10);
+	CHECK(pool.GetStats().FailCount == 0);
+
+	ObjectPool<CountedItem> countedPool;
+	countedPool.Initialize(8, 0);
+	CountedItem* pCounted = countedPool.Alloc();
+	s_DestructCount = 0;
+	countedPool.Free(pCounted);
+	CHECK(s_DestructCount == 1);
+}
+
+// limit below or between chunk sizes still gives exactly limit.
+static void testMaxBlockCount()
+{
+	const UINT pMAX_COUNTS[] = { 3, 15, 16, 17, 40 };
+	for (UINT i = 0; i < sizeof(pMAX_COUNTS) / sizeof(pMAX_COUNTS[0]); ++i)
+	{
+		const UINT MAX_COUNT = pMAX_COUNTS[i];
+		ObjectPool<Item> pool;
+		pool.Initialize(16, MAX_COUNT);
+
+		std::vector<Item*> items;
+		for (UINT j = 0; j < MAX_COUNT; ++j)
+		{
+			Item* pItem = pool.Alloc();
+			CHECK(pItem);
+			items.push_back(pItem);
+		}
+		CHECK(pool.Alloc() == nullptr);
+		CHECK(pool.GetStats().FailCount == 1);
+		CHECK(pool.GetStats().ChunkCount == (MAX_COUNT + 15) / 16);
+
+		for (UINT64 j = 0, size = items.size(); j < size; ++j)
+		{
+			pool.Free(items[j]);
+		}
+		CHECK(pool.Alloc() != nullptr);
+		pool.Free(items.back());
+	}
+}
+
+static void testPoison()
+{
+	ObjectPool<Item> pool;
+	pool.Initialize(8, 0);
+
+	Item* pA = pool.Alloc();
+	Item* pB = pool.Alloc();
+
+	// freed twice.
+	const LONG BREAK_COUNT = g_HeadlessDebugBreakCount;
+	pool.Free(pA);
+	pool.Free(pA);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 1);
+	CHECK(pool.GetStats().AllocatedCount == 1);
+
+	// written after free is found when block is handed out again.
+	pA->Value = 5;
+	Item* pC = pool.Alloc();
+	CHECK(pC == pA);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 2);
+
+	// more than allocated.
+	pool.Free(pB);
+	pool.Free(pC);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 2);
+	Item item = {};
+	pool.Free(&item);
+	CHECK(g_HeadlessDebugBreakCount == BREAK_COUNT + 3);
+	CHECK(pool.GetStats().AllocatedCount == 0);
+}
+
+// threads allocate, hand items to each other through mailboxes and free items other threads allocated.
+// owner written into item must survive until free, so block handed to two threads at once is found.
+static void testThreads(const UINT THREAD_COUNT, const UINT MAX_COUNT)
+{
+	ObjectPool<Item> pool;
+	pool.Initialize(64, MAX_COUNT, THREAD_COUNT);
+
+	std::vector<void*> mailboxes(THREAD_COUNT * 4, nullptr);
+	volatile LONG errorCount = 0;
+	volatile LONG allocatedCount = 0;
+
+	std::vector<std::thread> threads;
+	for (UINT threadIndex = 0; threadIndex < THREAD_COUNT; ++threadIndex)
+	{
+		threads.emplace_back([&, threadIndex]()
+							 {
+								 TestRandom random;
+								 random.State ^= (UINT64)(threadIndex + 1) * 0x9E3779B97F4A7C15ull;
+								 std::vector<Item*> held;
+
+								 for (int step = 0; step < 100000; ++step)
+								 {
+									 const UINT ACTION = random.NextUInt(10);
+									 if (ACTION < 5 && held.size() < 48)
+									 {
+										 Item* pItem = pool.Alloc(threadIndex);
+										 if (!pItem)
+										 {
+											 continue;
+										 }
+										 if (pItem->Owner != 0 || pItem->Value != 0)
+										 {
+											 InterlockedIncrement(&errorCount);
+										 }
+										 pItem->Owner = threadIndex + 1;
+										 pItem->Value = (UINT64)pItem;
+										 InterlockedIncrement(&allocatedCount);
+										 held.push_back(pItem);
+									 }
+									 else if (ACTION < 7 && !held.empty())
+									 {
+										 // pass to whichever thread picks mailbox up.
+										 void** ppMailbox = &mailboxes[random.NextUInt((UINT)mailboxes.size())];
+										 Item* pItem = (Item*)InterlockedExchangePointer(ppMailbox, held.back());
+										 held.pop_back();
+										 if (pItem)
+										 {
+											 held.push_back(pItem);
+										 }
+									 }
+									 else if (!held.empty())
+									 {
+										 const UINT SLOT = random.NextUInt((UINT)held.size());
+										 Item* pItem = held[SLOT];
+										 held[SLOT] = held.back();
+										 held.pop_back();
+										 if (pItem->Value != (UINT64)pItem || pItem->Owner == 0 || pItem->Owner > THREAD_COUNT)
+										 {
+											 InterlockedIncrement(&errorCount);
+										 }
+										 InterlockedDecrement(&allocatedCount);
+										 pool.Free(pItem, threadIndex);
+									 }
+								 }
+
+								 for (UINT64 i = 0, size = held.size(); i < size; ++i)
+								 {
+									 InterlockedDecrement(&allocatedCount);
+									 pool.Free(held[i], threadIndex);
+								 }
+							 });
+	}
+	for (UINT64 i = 0, size = threads.size(); i < size; ++i)
+	{
+		threads[i].join();
+	}
+	for (UINT64 i = 0, size = mailboxes.size(); i < size; ++i)
+	{
+		if (mailboxes[i])
+		{
+			InterlockedDecrement(&allocatedCount);
+			pool.Free((Item*)mailboxes[i], 0);
+		}
+	}
+
+	CHECK(errorCount == 0);
+	CHECK(allocatedCount == 0);
+	CHECK(pool.GetStats().AllocatedCount == 0);
+	if (MAX_COUNT == 0)
+	{
+		return;
+	}
+	CHECK(pool.GetStats().ChunkCount == (MAX_COUNT + 63) / 64);
+
+	// every block is back and distinct, wherever it was freed. draining each thread cache reaches all of them.
+	std::set<Item*> items;
+	for (UINT i = 0; i < THREAD_COUNT; ++i)
+	{
+		Item* pItem = pool.Alloc(i);
+		while (pItem)
+		{
+			CHECK(items.insert(pItem).second);
+			pItem = pool.Alloc(i);
+		}
+	}
+	CHECK(items.size() == MAX_COUNT);
+	for (std::set<Item*>::iterator iter = items.begin(); iter != items.end(); ++iter)
+	{
+		pool.Free(*iter, 0);
+	}
+}
+
+int main()
+{
+	testBasic();
+	testMaxBlockCount();
+	testPoison();
+
+	const UINT HARDWARE_THREAD_COUNT = std::thread::hardware_concurrency();
+	const UINT THREAD_COUNT = (HARDWARE_THREAD_COUNT > 4 ? HARDWARE_THREAD_COUNT : 4);
+	testThreads(THREAD_COUNT, 0);
+	testThreads(THREAD_COUNT, 100);
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,115 @@
+#include "../pch.h"
+#include "../Util/RadixSort.h"
+#include "../Util/RenderSortKey.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+
+// distribution of one pass to render queues. round robin with sort in each queue, as renderer had it, against
+// one radix sort of whole pass cut into contiguous chunks, and std::sort of whole pass for reference.
+// reports ns per item for sort and distribution, and state changes (runs of same PSO and sub state) over all queues.
+//   RenderSortBenchmark [item count, default 8192] [queue count, default 8]
+
+static const UINT PSO_TYPE_COUNT = 6;
+static const UINT LIGHT_COUNT = 3;
+static const UINT REPEAT_COUNT = 200;
+
+static UINT countStateRuns(const RadixSortEntry* pENTRIES, const UINT COUNT)
+{
+	UINT runCount = 0;
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		runCount += (i == 0 || GetRenderSortKeyState(pENTRIES[i].Key) != GetRenderSortKeyState(pENTRIES[i - 1].Key) ? 1 : 0);
+	}
+	return runCount;
+}
+
+static bool compareByKey(const RadixSortEntry& A, const RadixSortEntry& B) { return A.Key < B.Key; }
+
+int main(int argc, char** argv)
+{
+	const UINT ITEM_COUNT = (argc > 1 ? (UINT)atoi(argv[1]) : 8192);
+	const UINT QUEUE_COUNT = (argc > 2 ? (UINT)atoi(argv[2]) : 8);
+	printf("%u items, %u queues, %u PSO types x %u lights\n", ITEM_COUNT, QUEUE_COUNT, PSO_TYPE_COUNT, LIGHT_COUNT);
+
+	// scene order, like render objects of shadow pass.
+	TestRandom random;
+	std::vector<UINT64> keys(ITEM_COUNT);
+	for (UINT i = 0; i < ITEM_COUNT; ++i)
+	{
+		keys[i] = MakeRenderSortKey(0, random.NextUInt(PSO_TYPE_COUNT), i % LIGHT_COUNT, random.NextFloat() * 1000.0f);
+	}
+
+	std::vector<RadixSortEntry> entries(ITEM_COUNT);
+	std::vector<RadixSortEntry> temp(ITEM_COUNT);
+	std::vector<std::vector<RadixSortEntry>> queues(QUEUE_COUNT, std::vector<RadixSortEntry>(ITEM_COUNT));
+	std::vector<UINT> queueCounts(QUEUE_COUNT);
+
+	// round robin.
+	UINT roundRobinRuns = 0;
+	double beginTime = GetTestTime();
+	for (UINT repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+	{
+		queueCounts.assign(QUEUE_COUNT, 0);
+		for (UINT i = 0; i < ITEM_COUNT; ++i)
+		{
+			const UINT QUEUE = i % QUEUE_COUNT;
+			queues[QUEUE][queueCounts[QUEUE]++] = { keys[i], i };
+		}
+		roundRobinRuns = 0;
+		for (UINT q = 0; q < QUEUE_COUNT; ++q)
+		{
+			RadixSort64(queues[q].data(), temp.data(), queueCounts[q]);
+			roundRobinRuns += countStateRuns(queues[q].data(), queueCounts[q]);
+		}
+	}
+	const double ROUND_ROBIN_TIME = GetTestTime() - beginTime;
+
+	// one sort, contiguous chunks. queues find their chunk in order and skip sorting.
+	UINT chunkRuns = 0;
+	beginTime = GetTestTime();
+	for (UINT repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+	{
+		for (UINT i = 0; i < ITEM_COUNT; ++i)
+		{
+			entries[i] = { keys[i], i };
+		}
+		RadixSort64(entries.data(), temp.data(), ITEM_COUNT);
+
+		chunkRuns = 0;
+		for (UINT q = 0; q < QUEUE_COUNT; ++q)
+		{
+			const UINT BEGIN = GetRenderChunkBegin(ITEM_COUNT, QUEUE_COUNT, q);
+			const UINT END = GetRenderChunkBegin(ITEM_COUNT, QUEUE_COUNT, q + 1);
+			bool bInOrder = true;
+			for (UINT i = BEGIN; i < END; ++i)
+			{
+				queues[q][i - BEGIN] = entries[i];
+				bInOrder = bInOrder && (i == BEGIN || entries[i - 1].Key <= entries[i].Key);
+			}
+			CHECK(bInOrder);
+			chunkRuns += countStateRuns(queues[q].data(), END - BEGIN);
+		}
+	}
+	const double CHUNK_TIME = GetTestTime() - beginTime;
+
+	beginTime = GetTestTime();
+	for (UINT repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+	{
+		for (UINT i = 0; i < ITEM_COUNT; ++i)
+		{
+			entries[i] = { keys[i], i };
+		}
+		std::sort(entries.begin(), entries.end(), compareByKey);
+	}
+	const double STD_SORT_TIME = GetTestTime() - beginTime;
+	const UINT FULL_RUNS = countStateRuns(entries.data(), ITEM_COUNT);
+
+	const double NS_PER_ITEM = 1e9 / ((double)ITEM_COUNT * (double)REPEAT_COUNT);
+	printf("round robin     %6.2f ns/item, %5u state changes\n", ROUND_ROBIN_TIME * NS_PER_ITEM, roundRobinRuns);
+	printf("sorted chunks   %6.2f ns/item, %5u state changes\n", CHUNK_TIME * NS_PER_ITEM, chunkRuns);
+	printf("std::sort       %6.2f ns/item, %5u state changes in one list\n", STD_SORT_TIME * NS_PER_ITEM, FULL_RUNS);
+
+	CHECK(chunkRuns <= FULL_RUNS + QUEUE_COUNT - 1);
+	return TEST_RESULT();
+}
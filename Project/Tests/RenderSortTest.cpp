@@ -0,0 +1,155 @@
+#include "../pch.h"
+#include "../Util/RadixSort.h"
+#include "../Util/RenderSortKey.h"
+#include "TestCommon.h"
+
+#include <algorithm>
+
+static void testKeyOrder()
+{
+	// pass, then PSO, then sub state, then depth.
+	CHECK(MakeRenderSortKey(1, 200, 1000, 500.0f) < MakeRenderSortKey(2, 0, 0, 0.0f));
+	CHECK(MakeRenderSortKey(1, 3, 1000, 500.0f) < MakeRenderSortKey(1, 4, 0, 0.0f));
+	CHECK(MakeRenderSortKey(1, 3, 2, 500.0f) < MakeRenderSortKey(1, 3, 3, 0.0f));
+	CHECK(MakeRenderSortKey(1, 3, 2, 0.5f) < MakeRenderSortKey(1, 3, 2, 2.0f));
+	CHECK(MakeRenderSortKey(1, 3, 2, 1.0f) < MakeRenderSortKey(1, 3, 2, 1.0e30f));
+
+	// negative and zero depth sort first and alike.
+	CHECK(MakeRenderSortKey(1, 3, 2, -5.0f) == MakeRenderSortKey(1, 3, 2, 0.0f));
+	CHECK(MakeRenderSortKey(1, 3, 2, -5.0f) < MakeRenderSortKey(1, 3, 2, 1.0e-30f));
+
+	// fields do not bleed into each other at their limits.
+	const UINT64 KEY = MakeRenderSortKey(15, 255, (1 << 20) - 1, 3.0f);
+	CHECK((KEY >> 60) == 15);
+	CHECK(((KEY >> 52) & 0xff) == 255);
+	CHECK(((KEY >> 32) & 0xfffff) == (1 << 20) - 1);
+	CHECK(GetRenderSortKeyState(KEY) == (KEY >> 32));
+	CHECK(GetRenderSortKeyState(MakeRenderSortKey(2, 7, 9, 1.0f)) == GetRenderSortKeyState(MakeRenderSortKey(2, 7, 9, 100.0f)));
+	CHECK(GetRenderSortKeyState(MakeRenderSortKey(2, 7, 9, 1.0f)) != GetRenderSortKeyState(MakeRenderSortKey(2, 7, 10, 1.0f)));
+
+	// random depths keep float order.
+	TestRandom random;
+	for (int i = 0; i < 10000; ++i)
+	{
+		const float A = random.NextFloat() * 10000.0f;
+		const float B = random.NextFloat() * 10000.0f;
+		CHECK((A < B) == (MakeRenderSortKey(0, 1, 0, A) < MakeRenderSortKey(0, 1, 0, B)));
+	}
+}
+
+static bool compareByKey(const RadixSortEntry& A, const RadixSortEntry& B) { return A.Key < B.Key; }
+
+// against std::stable_sort, so equal keys must keep input order.
+static void testRadixSort()
+{
+	TestRandom random;
+	std::vector<RadixSortEntry> entries;
+	std::vector<RadixSortEntry> temp;
+	std::vector<RadixSortEntry> expected;
+
+	const UINT pCOUNTS[] = { 0, 1, 2, 3, 17, 256, 1000, 50000 };
+	for (UINT c = 0; c < sizeof(pCOUNTS) / sizeof(pCOUNTS[0]); ++c)
+	{
+		for (UINT kind = 0; kind < 4; ++kind)
+		{
+			const UINT COUNT = pCOUNTS[c];
+			entries.resize(COUNT);
+			temp.resize(COUNT);
+			for (UINT i = 0; i < COUNT; ++i)
+			{
+				switch (kind)
+				{
+					case 0:
+						entries[i].Key = random.Next();
+						break;
+					case 1:
+						// few states and depths, many equal keys.
+						entries[i].Key = MakeRenderSortKey(random.NextUInt(3), random.NextUInt(4), random.NextUInt(8), (float)random.NextUInt(4));
+						break;
+					case 2:
+						entries[i].Key = i;
+						break;
+					default:
+						entries[i].Key = ~(UINT64)i;
+						break;
+				}
+				entries[i].Index = i;
+			}
+			expected = entries;
+			std::stable_sort(expected.begin(), expected.end(), compareByKey);
+
+			RadixSort64(entries.data(), temp.data(), COUNT);
+			for (UINT i = 0; i < COUNT; ++i)
+			{
+				CHECK(entries[i].Key == expected[i].Key && entries[i].Index == expected[i].Index);
+			}
+		}
+	}
+}
+
+// chunks of sorted list cover it once, in order, sizes differ by 1 at most.
+static void testChunks()
+{
+	const UINT pCOUNTS[] = { 0, 1, 5, 7, 8, 1000, 8191 };
+	for (UINT c = 0; c < sizeof(pCOUNTS) / sizeof(pCOUNTS[0]); ++c)
+	{
+		for (UINT chunkCount = 1; chunkCount <= 16; ++chunkCount)
+		{
+			const UINT COUNT = pCOUNTS[c];
+			CHECK(GetRenderChunkBegin(COUNT, chunkCount, 0) == 0);
+			CHECK(GetRenderChunkBegin(COUNT, chunkCount, chunkCount) == COUNT);
+
+			UINT minSize = UINT_MAX;
+			UINT maxSize = 0;
+			for (UINT i = 0; i < chunkCount; ++i)
+			{
+				const UINT BEGIN = GetRenderChunkBegin(COUNT, chunkCount, i);
+				const UINT END = GetRenderChunkBegin(COUNT, chunkCount, i + 1);
+				CHECK(BEGIN <= END);
+				minSize = (END - BEGIN < minSize ? END - BEGIN : minSize);
+				maxSize = (END - BEGIN > maxSize ? END - BEGIN : maxSize);
+			}
+			CHECK(maxSize - minSize <= 1);
+		}
+	}
+
+	// state runs of whole sorted list are split by chunk starts only.
+	TestRandom random;
+	const UINT COUNT = 4000;
+	const UINT CHUNK_COUNT = 8;
+	std::vector<RadixSortEntry> entries(COUNT);
+	std::vector<RadixSortEntry> temp(COUNT);
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		entries[i].Key = MakeRenderSortKey(1, random.NextUInt(6), random.NextUInt(4), random.NextFloat() * 100.0f);
+		entries[i].Index = i;
+	}
+	RadixSort64(entries.data(), temp.data(), COUNT);
+
+	UINT runCount = 0;
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		runCount += (i == 0 || GetRenderSortKeyState(entries[i].Key) != GetRenderSortKeyState(entries[i - 1].Key) ? 1 : 0);
+	}
+	UINT chunkRunCount = 0;
+	for (UINT chunk = 0; chunk < CHUNK_COUNT; ++chunk)
+	{
+		const UINT BEGIN = GetRenderChunkBegin(COUNT, CHUNK_COUNT, chunk);
+		const UINT END = GetRenderChunkBegin(COUNT, CHUNK_COUNT, chunk + 1);
+		for (UINT i = BEGIN; i < END; ++i)
+		{
+			chunkRunCount += (i == BEGIN || GetRenderSortKeyState(entries[i].Key) != GetRenderSortKeyState(entries[i - 1].Key) ? 1 : 0);
+		}
+	}
+	CHECK(runCount == 24);
+	CHECK(chunkRunCount <= runCount + CHUNK_COUNT - 1);
+}
+
+int main()
+{
+	testKeyOrder();
+	testRadixSort();
+	testChunks();
+
+	return TEST_RESULT();
+}
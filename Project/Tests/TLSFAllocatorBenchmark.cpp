@@ -0,0 +1,251 @@
+#include "../pch.h"
+#include "../Util/TLSFAllocator.h"
+#include "TestCommon.h"
+
+#include <map>
+
+// TLSFAllocator against exact best fit over ordered maps, on buffer sized requests of GPUBufferPool.
+// reports ns per allocate/free pair, fragmentation (1 - largest free / total free) at steady fill,
+// and fill reached at first failure.
+//   TLSFAllocatorBenchmark [operation count, default 2000000]
+
+// exact best fit with immediate coalescing. O(log n).
+class MapBestFitAllocator
+{
+public:
+	void Initialize(const UINT64 SIZE)
+	{
+		m_FreeSize = SIZE;
+		insertFree(0, SIZE);
+	}
+
+	// returns UINT64_MAX when nothing fits. *pBlockOffset and *pBlockSize are what Free() takes back.
+	UINT64 Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT, UINT64* pBlockOffset, UINT64* pBlockSize)
+	{
+		const UINT64 BLOCK_SIZE = (SIZE + TLSF_GRANULARITY - 1) / TLSF_GRANULARITY * TLSF_GRANULARITY;
+		for (std::multimap<UINT64, UINT64>::iterator iter = m_FreeBySize.lower_bound(BLOCK_SIZE); iter != m_FreeBySize.end(); ++iter)
+		{
+			const UINT64 OFFSET = iter->second;
+			const UINT64 FREE_SIZE = iter->first;
+			const UINT64 ALIGNED_OFFSET = (OFFSET + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+			if (ALIGNED_OFFSET + BLOCK_SIZE > OFFSET + FREE_SIZE)
+			{
+				continue;
+			}
+
+			m_FreeBySize.erase(iter);
+			m_FreeByOffset.erase(OFFSET);
+			if (ALIGNED_OFFSET > OFFSET)
+			{
+				insertFree(OFFSET, ALIGNED_OFFSET - OFFSET);
+			}
+			if (ALIGNED_OFFSET + BLOCK_SIZE < OFFSET + FREE_SIZE)
+			{
+				insertFree(ALIGNED_OFFSET + BLOCK_SIZE, OFFSET + FREE_SIZE - ALIGNED_OFFSET - BLOCK_SIZE);
+			}
+
+			m_FreeSize -= BLOCK_SIZE;
+			*pBlockOffset = ALIGNED_OFFSET;
+			*pBlockSize = BLOCK_SIZE;
+			return ALIGNED_OFFSET;
+		}
+		return UINT64_MAX;
+	}
+
+	void Free(UINT64 offset, UINT64 size)
+	{
+		m_FreeSize += size;
+
+		std::map<UINT64, UINT64>::iterator next = m_FreeByOffset.lower_bound(offset);
+		if (next != m_FreeByOffset.begin())
+		{
+			std::map<UINT64, UINT64>::iterator prev = next;
+			--prev;
+			if (prev->first + prev->second == offset)
+			{
+				offset = prev->first;
+				size += prev->second;
+				eraseFree(prev->first, prev->second);
+			}
+		}
+		if (next != m_FreeByOffset.end() && next->first == offset + size)
+		{
+			size += next->second;
+			eraseFree(next->first, next->second);
+		}
+		insertFree(offset, size);
+	}
+
+	UINT64 GetLargestFreeSize() { return (m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first); }
+	UINT64 GetFreeSize() { return m_FreeSize; }
+
+private:
+	void insertFree(const UINT64 OFFSET, const UINT64 SIZE)
+	{
+		m_FreeByOffset[OFFSET] = SIZE;
+		m_FreeBySize.insert(std::make_pair(SIZE, OFFSET));
+	}
+	void eraseFree(const UINT64 OFFSET, const UINT64 SIZE)
+	{
+		m_FreeByOffset.erase(OFFSET);
+		std::pair<std::multimap<UINT64, UINT64>::iterator, std::multimap<UINT64, UINT64>::iterator> range = m_FreeBySize.equal_range(SIZE);
+		for (std::multimap<UINT64, UINT64>::iterator iter = range.first; iter != range.second; ++iter)
+		{
+			if (iter->second == OFFSET)
+			{
+				m_FreeBySize.erase(iter);
+				break;
+			}
+		}
+	}
+
+	std::map<UINT64, UINT64> m_FreeByOffset;
+	std::multimap<UINT64, UINT64> m_FreeBySize;
+	UINT64 m_FreeSize = 0;
+};
+
+static const UINT64 HEAP_SIZE = 256ull * 1024 * 1024;
+
+struct Request
+{
+	UINT64 Size;
+	UINT64 Alignment;
+};
+
+// mostly small constant and vertex buffers, some large ones. 256 byte aligned, textures like ones at 64KB.
+static Request makeRequest(TestRandom& random)
+{
+	Request request;
+	const UINT KIND = random.NextUInt(100);
+	if (KIND < 70)
+	{
+		request.Size = 256 + random.NextUInt(16 * 1024);
+	}
+	else if (KIND < 95)
+	{
+		request.Size = 16 * 1024 + random.NextUInt(512 * 1024);
+	}
+	else
+	{
+		request.Size = 512 * 1024 + random.NextUInt(4 * 1024 * 1024);
+	}
+	request.Alignment = (random.NextUInt(10) == 0 ? 65536 : 256);
+	return request;
+}
+
+struct BenchmarkResult
+{
+	double NanosecondsPerPair;
+	double AverageFragmentation;
+	double FillAtFirstFailure;
+	UINT FailureCount;
+};
+
+template <typename AllocateFunc, typename FreeFunc, typename FreeSizeFunc, typename LargestFunc>
+static BenchmarkResult run(const UINT OPERATION_COUNT, AllocateFunc allocateSlot, FreeFunc freeSlot, FreeSizeFunc getFreeSize, LargestFunc getLargestFreeSize)
+{
+	BenchmarkResult result = {};
+	TestRandom random;
+	std::vector<UINT> liveSlots; // indices into caller slot arrays.
+	UINT nextSlot = 0;
+	UINT64 fragmentationSampleCount = 0;
+	double fragmentationSum = 0.0;
+
+	const double BEGIN_TIME = GetTestTime();
+	for (UINT i = 0; i < OPERATION_COUNT; ++i)
+	{
+		// keep heap around 80% full once warmed up.
+		const double FILL = 1.0 - (double)getFreeSize() / (double)HEAP_SIZE;
+		const bool bALLOCATE = (liveSlots.empty() || (FILL < 0.8 ? random.NextUInt(4) != 0 : random.NextUInt(4) == 0));
+		if (bALLOCATE)
+		{
+			const Request REQUEST = makeRequest(random);
+			if (allocateSlot(nextSlot, REQUEST))
+			{
+				liveSlots.push_back(nextSlot++);
+			}
+			else
+			{
+				if (result.FailureCount == 0)
+				{
+					result.FillAtFirstFailure = FILL;
+				}
+				++result.FailureCount;
+			}
+		}
+		else
+		{
+			const UINT INDEX = random.NextUInt((UINT)liveSlots.size());
+			freeSlot(liveSlots[INDEX]);
+			liveSlots[INDEX] = liveSlots.back();
+			liveSlots.pop_back();
+		}
+
+		if (i % 1024 == 0 && i > OPERATION_COUNT / 4)
+		{
+			const UINT64 FREE_SIZE = getFreeSize();
+			if (FREE_SIZE > 0)
+			{
+				fragmentationSum += 1.0 - (double)getLargestFreeSize() / (double)FREE_SIZE;
+				++fragmentationSampleCount;
+			}
+		}
+	}
+	for (UINT64 i = 0, size = liveSlots.size(); i < size; ++i)
+	{
+		freeSlot(liveSlots[i]);
+	}
+	const double TIME = GetTestTime() - BEGIN_TIME;
+
+	result.NanosecondsPerPair = TIME * 1e9 / ((double)OPERATION_COUNT / 2.0);
+	result.AverageFragmentation = (fragmentationSampleCount > 0 ? fragmentationSum / (double)fragmentationSampleCount : 0.0);
+	return result;
+}
+
+static void printResult(const char* pszNAME, const BenchmarkResult& RESULT)
+{
+	printf("%-9s %8.1f ns/pair, fragmentation %5.1f%%, first failure at %5.1f%% fill, %u failures\n",
+		   pszNAME, RESULT.NanosecondsPerPair, RESULT.AverageFragmentation * 100.0, RESULT.FillAtFirstFailure * 100.0, RESULT.FailureCount);
+}
+
+int main(int argc, char** argv)
+{
+	const UINT OPERATION_COUNT = (argc > 1 ? (UINT)atoi(argv[1]) : 2000000);
+	printf("%u MB heap, %u operations\n", (UINT)(HEAP_SIZE / (1024 * 1024)), OPERATION_COUNT);
+
+	{
+		TLSFAllocator allocator;
+		allocator.Initialize(HEAP_SIZE);
+		std::vector<TLSFAllocation> slots(OPERATION_COUNT);
+
+		const BenchmarkResult RESULT = run(
+			OPERATION_COUNT,
+			[&](const UINT SLOT, const Request& REQUEST) { return allocator.Allocate(REQUEST.Size, REQUEST.Alignment, &slots[SLOT]); },
+			[&](const UINT SLOT) { allocator.Free(slots[SLOT]); },
+			[&]() { return allocator.GetFreeSize(); },
+			[&]() { return allocator.GetLargestFreeSize(); });
+
+		CHECK(allocator.IsEmpty());
+		CHECK(allocator.GetLargestFreeSize() == allocator.GetSize());
+		printResult("tlsf", RESULT);
+	}
+
+	{
+		MapBestFitAllocator allocator;
+		allocator.Initialize(HEAP_SIZE);
+		std::vector<std::pair<UINT64, UINT64>> slots(OPERATION_COUNT);
+
+		const BenchmarkResult RESULT = run(
+			OPERATION_COUNT,
+			[&](const UINT SLOT, const Request& REQUEST) { return allocator.Allocate(REQUEST.Size, REQUEST.Alignment, &slots[SLOT].first, &slots[SLOT].second) != UINT64_MAX; },
+			[&](const UINT SLOT) { allocator.Free(slots[SLOT].first, slots[SLOT].second); },
+			[&]() { return allocator.GetFreeSize(); },
+			[&]() { return allocator.GetLargestFreeSize(); });
+
+		CHECK(allocator.GetFreeSize() == HEAP_SIZE);
+		CHECK(allocator.GetLargestFreeSize() == HEAP_SIZE);
+		printResult("best fit", RESULT);
+	}
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+#include "../pch.h"
+#include "../Util/TLSFAllocator.h"
+#include "TestCommon.h"
+
+#include <map>
+
+// random allocate and free against model of live blocks. blocks must not overlap,
+// and with full coalescing largest free block is exactly largest gap between live blocks.
+
+static UINT64 getBlockSize(const UINT64 SIZE)
+{
+	return (SIZE > 0 ? (SIZE + TLSF_GRANULARITY - 1) / TLSF_GRANULARITY * TLSF_GRANULARITY : TLSF_GRANULARITY);
+}
+
+// offset -> end of live blocks.
+static UINT64 getLargestGap(const std::map<UINT64, UINT64>& LIVE_BLOCKS, const UINT64 SIZE)
+{
+	UINT64 largestGap = 0;
+	UINT64 prevEnd = 0;
+	for (std::map<UINT64, UINT64>::const_iterator iter = LIVE_BLOCKS.begin(); iter != LIVE_BLOCKS.end(); ++iter)
+	{
+		largestGap = (iter->first - prevEnd > largestGap ? iter->first - prevEnd : largestGap);
+		prevEnd = iter->second;
+	}
+	return (SIZE - prevEnd > largestGap ? SIZE - prevEnd : largestGap);
+}
+
+static void testBasic()
+{
+	TLSFAllocator allocator;
+	allocator.Initialize(1000);
+	CHECK(allocator.GetSize() == 992);
+	CHECK(allocator.GetFreeSize() == 992);
+	CHECK(allocator.GetLargestFreeSize() == 992);
+
+	TLSFAllocation a;
+	TLSFAllocation b;
+	TLSFAllocation c;
+	CHECK(allocator.Allocate(100, 1, &a) && a.Offset == 0 && a.Size == 100);
+	CHECK(allocator.Allocate(0, 1, &b) && b.Offset == 112);
+	CHECK(allocator.Allocate(10, 256, &c) && c.Offset == 256);
+	CHECK(allocator.GetAllocationCount() == 3);
+	CHECK(allocator.GetFreeSize() == 992 - 112 - 16 - 16);
+
+	// too large fails and leaves state alone.
+	TLSFAllocation failed;
+	CHECK(!allocator.Allocate(2000, 1, &failed));
+	CHECK(failed.Offset == UINT64_MAX && failed.NodeIndex == TLSF_INVALID_NODE);
+	CHECK(allocator.GetAllocationCount() == 3);
+
+	// non power of 2 alignment. offset is multiple of both 48 and granularity.
+	TLSFAllocation d;
+	CHECK(allocator.Allocate(20, 48, &d) && d.Offset % 48 == 0 && d.Offset % TLSF_GRANULARITY == 0);
+
+	// freeing middle block merges with both free neighbors.
+	allocator.Free(a);
+	allocator.Free(c);
+	allocator.Free(d);
+	allocator.Free(b);
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetFreeSize() == 992);
+	CHECK(allocator.GetLargestFreeSize() == 992);
+
+	TLSFAllocation whole;
+	CHECK(allocator.Allocate(992, 1, &whole) && whole.Offset == 0);
+	CHECK(allocator.GetFreeSize() == 0);
+	CHECK(allocator.GetLargestFreeSize() == 0);
+	allocator.Free(whole);
+	CHECK(allocator.GetLargestFreeSize() == 992);
+}
+
+static void testFuzz(const UINT64 SIZE, const UINT MAX_ALLOC_SIZE, const int STEP_COUNT, const UINT64 SEED)
+{
+	TLSFAllocator allocator;
+	allocator.Initialize(SIZE);
+
+	TestRandom random;
+	random.State ^= SEED;
+
+	std::vector<TLSFAllocation> allocations;
+	std::map<UINT64, UINT64> liveBlocks;
+	UINT64 usedSize = 0;
+	UINT allocatedCount = 0;
+	UINT failedCount = 0;
+
+	for (int step = 0; step < STEP_COUNT; ++step)
+	{
+		// phases of mostly allocating and mostly freeing, so allocator runs both full and near empty.
+		const bool bFILLING = ((step / 2000) % 2 == 0);
+		const bool bALLOCATE = (allocations.empty() || random.NextUInt(10) < (bFILLING ? 7u : 3u));
+		if (bALLOCATE)
+		{
+			const UINT64 ALLOC_SIZE = random.NextUInt(random.NextUInt(8) == 0 ? MAX_ALLOC_SIZE : MAX_ALLOC_SIZE / 16 + 1);
+			const UINT ALIGNMENT_TYPE = random.NextUInt(4);
+			const UINT64 ALIGNMENT = (ALIGNMENT_TYPE == 0 ? 1 : (ALIGNMENT_TYPE == 1 ? 256 : (ALIGNMENT_TYPE == 2 ? 65536 : 1 + random.NextUInt(200))));
+
+			TLSFAllocation allocation;
+			if (!allocator.Allocate(ALLOC_SIZE, ALIGNMENT, &allocation))
+			{
+				// good fit may miss gap that fits, but never one well above request plus padding.
+				UINT64 align = TLSF_GRANULARITY;
+				while (align % ALIGNMENT != 0)
+				{
+					align += TLSF_GRANULARITY;
+				}
+				const UINT64 PADDING = align - TLSF_GRANULARITY;
+				CHECK(getLargestGap(liveBlocks, allocator.GetSize()) < (getBlockSize(ALLOC_SIZE) + PADDING) * 17 / 16 + TLSF_GRANULARITY);
+				CHECK(allocation.Offset == UINT64_MAX);
+				++failedCount;
+				continue;
+			}
+
+			const UINT64 BLOCK_SIZE = getBlockSize(ALLOC_SIZE);
+			const UINT64 END = allocation.Offset + BLOCK_SIZE;
+			CHECK(allocation.Offset % ALIGNMENT == 0);
+			CHECK(allocation.Offset % TLSF_GRANULARITY == 0);
+			CHECK(allocation.Size == ALLOC_SIZE);
+			CHECK(END <= allocator.GetSize());
+
+			std::map<UINT64, UINT64>::iterator next = liveBlocks.lower_bound(allocation.Offset);
+			if (next != liveBlocks.end())
+			{
+				CHECK(next->first >= END);
+			}
+			if (next != liveBlocks.begin())
+			{
+				std::map<UINT64, UINT64>::iterator prev = next;
+				--prev;
+				CHECK(prev->second <= allocation.Offset);
+			}
+
+			liveBlocks[allocation.Offset] = END;
+			allocations.push_back(allocation);
+			usedSize += BLOCK_SIZE;
+			++allocatedCount;
+		}
+		else
+		{
+			const UINT INDEX = random.NextUInt((UINT)allocations.size());
+			const TLSFAllocation ALLOCATION = allocations[INDEX];
+			allocations[INDEX] = allocations.back();
+			allocations.pop_back();
+
+			allocator.Free(ALLOCATION);
+			usedSize -= liveBlocks[ALLOCATION.Offset] - ALLOCATION.Offset;
+			liveBlocks.erase(ALLOCATION.Offset);
+		}
+
+		CHECK(allocator.GetAllocationCount() == (UINT)allocations.size());
+		CHECK(allocator.GetFreeSize() == allocator.GetSize() - usedSize);
+		if (step % 16 == 0)
+		{
+			CHECK(allocator.GetLargestFreeSize() == getLargestGap(liveBlocks, allocator.GetSize()));
+		}
+	}
+
+	while (!allocations.empty())
+	{
+		allocator.Free(allocations.back());
+		allocations.pop_back();
+	}
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetFreeSize() == allocator.GetSize());
+	CHECK(allocator.GetLargestFreeSize() == allocator.GetSize());
+
+	// fuzz must reach full state.
+	CHECK(allocatedCount > (UINT)STEP_COUNT / 3);
+	CHECK(failedCount > 0);
+}
+
+int main()
+{
+	testBasic();
+	testFuzz(1024 * 1024, 64 * 1024, 100000, 0);
+	testFuzz(64 * 1024, 512, 100000, 1);
+	testFuzz(256ull * 1024 * 1024, 16 * 1024 * 1024, 50000, 2);
+
+	return TEST_RESULT();
+}
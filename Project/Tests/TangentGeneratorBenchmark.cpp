@@ -0,0 +1,96 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Model/TangentGenerator.h"
+#include "TestCommon.h"
+
+// GenerateTangents against serial path ModelLoader had, which gave each vertex tangent of last face touching it.
+// GenerateTangents runs with 1 range and with range count picked for this machine. headless ParallelFor runs
+// ranges on calling thread, so this shows cost of partial sums, not thread speedup.
+//   TangentGeneratorBenchmark [grid size, default 512] [repeat count, default 10]
+
+static void generateLastFaceTangents(MeshInfo* pMeshInfo)
+{
+	std::vector<Vertex>& vertices = pMeshInfo->Vertices;
+	const std::vector<UINT>& INDICES = pMeshInfo->Indices;
+	for (UINT64 i = 0, size = INDICES.size() / 3; i < size; ++i)
+	{
+		Vertex& v0 = vertices[INDICES[i * 3]];
+		Vertex& v1 = vertices[INDICES[i * 3 + 1]];
+		Vertex& v2 = vertices[INDICES[i * 3 + 2]];
+		const Vector3 E1 = v1.Position - v0.Position;
+		const Vector3 E2 = v2.Position - v0.Position;
+		const float DU1 = v1.Texcoord.x - v0.Texcoord.x;
+		const float DV1 = v1.Texcoord.y - v0.Texcoord.y;
+		const float DU2 = v2.Texcoord.x - v0.Texcoord.x;
+		const float DV2 = v2.Texcoord.y - v0.Texcoord.y;
+		const float DEN = 1.0f / (DU1 * DV2 - DU2 * DV1);
+		const Vector3 TANGENT = (E1 * DV2 - E2 * DV1) * DEN;
+		v0.Tangent = v1.Tangent = v2.Tangent = Vector4(TANGENT.x, TANGENT.y, TANGENT.z, 1.0f);
+	}
+}
+
+static void makeGrid(MeshInfo* pMeshInfo, const UINT SIZE)
+{
+	for (UINT y = 0; y <= SIZE; ++y)
+	{
+		for (UINT x = 0; x <= SIZE; ++x)
+		{
+			Vertex v;
+			const float FX = (float)x / (float)SIZE;
+			const float FY = (float)y / (float)SIZE;
+			v.Position = Vector3(FX, FY, sinf(FX * 9.0f) * cosf(FY * 7.0f) * 0.1f);
+			v.Normal = Vector3(0.0f, 0.0f, 1.0f);
+			v.Texcoord = Vector2(FX, FY);
+			pMeshInfo->Vertices.push_back(v);
+		}
+	}
+	for (UINT y = 0; y < SIZE; ++y)
+	{
+		for (UINT x = 0; x < SIZE; ++x)
+		{
+			const UINT I = y * (SIZE + 1) + x;
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { I, I + 1, I + SIZE + 2, I, I + SIZE + 2, I + SIZE + 1 });
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const UINT GRID_SIZE = (argc > 1 ? (UINT)atoi(argv[1]) : 512);
+	const UINT REPEAT_COUNT = (argc > 2 ? (UINT)atoi(argv[2]) : 10);
+
+	MeshInfo mesh;
+	makeGrid(&mesh, GRID_SIZE);
+	const UINT VERTEX_COUNT = (UINT)mesh.Vertices.size();
+	const UINT TRIANGLE_COUNT = (UINT)(mesh.Indices.size() / 3);
+
+	double beginTime = GetTestTime();
+	for (UINT i = 0; i < REPEAT_COUNT; ++i)
+	{
+		generateLastFaceTangents(&mesh);
+	}
+	const double LAST_FACE_TIME = (GetTestTime() - beginTime) / REPEAT_COUNT;
+
+	beginTime = GetTestTime();
+	for (UINT i = 0; i < REPEAT_COUNT; ++i)
+	{
+		GenerateTangents(&mesh, nullptr, 1);
+	}
+	const double SINGLE_RANGE_TIME = (GetTestTime() - beginTime) / REPEAT_COUNT;
+
+	TangentStats stats;
+	beginTime = GetTestTime();
+	for (UINT i = 0; i < REPEAT_COUNT; ++i)
+	{
+		GenerateTangents(&mesh, &stats);
+	}
+	const double AUTO_RANGE_TIME = (GetTestTime() - beginTime) / REPEAT_COUNT;
+
+	printf("%u vertices, %u triangles\n", VERTEX_COUNT, TRIANGLE_COUNT);
+	printf("last face, serial   %8.3f ms\n", LAST_FACE_TIME * 1000.0);
+	printf("accumulated, 1 range %7.3f ms\n", SINGLE_RANGE_TIME * 1000.0);
+	printf("accumulated, %u ranges %6.3f ms\n", stats.RangeCount, AUTO_RANGE_TIME * 1000.0);
+
+	CHECK(stats.DegenerateFaceCount == 0 && stats.FallbackVertexCount == 0);
+	return TEST_RESULT();
+}
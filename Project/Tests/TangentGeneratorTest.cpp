@@ -0,0 +1,253 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Model/TangentGenerator.h"
+#include "TestCommon.h"
+
+static bool isNear(const Vector3& A, const Vector3& B, const float EPSILON)
+{
+	return ((A - B).Length() <= EPSILON);
+}
+
+static Vector3 getTangent(const Vertex& V)
+{
+	return Vector3(V.Tangent.x, V.Tangent.y, V.Tangent.z);
+}
+
+static Vertex makeVertex(const Vector3& POSITION, const Vector3& NORMAL, const Vector2& TEXCOORD)
+{
+	Vertex v;
+	v.Position = POSITION;
+	v.Normal = NORMAL;
+	v.Texcoord = TEXCOORD;
+	return v;
+}
+
+// unit quad in xy plane facing +z. MIRRORED flips u.
+static void makeQuad(MeshInfo* pMeshInfo, const bool MIRRORED)
+{
+	const Vector3 NORMAL(0.0f, 0.0f, 1.0f);
+	const float U0 = (MIRRORED ? 1.0f : 0.0f);
+	const float U1 = (MIRRORED ? 0.0f : 1.0f);
+	pMeshInfo->Vertices.push_back(makeVertex(Vector3(0.0f, 0.0f, 0.0f), NORMAL, Vector2(U0, 0.0f)));
+	pMeshInfo->Vertices.push_back(makeVertex(Vector3(1.0f, 0.0f, 0.0f), NORMAL, Vector2(U1, 0.0f)));
+	pMeshInfo->Vertices.push_back(makeVertex(Vector3(1.0f, 1.0f, 0.0f), NORMAL, Vector2(U1, 1.0f)));
+	pMeshInfo->Vertices.push_back(makeVertex(Vector3(0.0f, 1.0f, 0.0f), NORMAL, Vector2(U0, 1.0f)));
+	pMeshInfo->Indices = { 0, 1, 2, 0, 2, 3 };
+}
+
+// u along +x, v along +y. tangent +x, bitangent cross(N, T) = +y agrees with dP/dv, so w = +1.
+static void testQuad()
+{
+	MeshInfo mesh;
+	makeQuad(&mesh, false);
+
+	TangentStats stats;
+	GenerateTangents(&mesh, &stats);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		CHECK(isNear(getTangent(mesh.Vertices[i]), Vector3(1.0f, 0.0f, 0.0f), 1e-5f));
+		CHECK(mesh.Vertices[i].Tangent.w == 1.0f);
+	}
+	CHECK(stats.DegenerateFaceCount == 0 && stats.FallbackVertexCount == 0 && stats.MirroredVertexCount == 0);
+	CHECK(stats.RangeCount == 1);
+}
+
+// tiny faces of fine mesh keep their tangents. face weights are tiny, but not degenerate.
+static void testSmallScale()
+{
+	MeshInfo mesh;
+	makeQuad(&mesh, false);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		mesh.Vertices[i].Position *= 1e-4f;
+		mesh.Vertices[i].Texcoord = mesh.Vertices[i].Texcoord * 1e-2f;
+	}
+
+	TangentStats stats;
+	GenerateTangents(&mesh, &stats);
+	CHECK(stats.DegenerateFaceCount == 0 && stats.FallbackVertexCount == 0);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		CHECK(isNear(getTangent(mesh.Vertices[i]), Vector3(1.0f, 0.0f, 0.0f), 1e-5f));
+	}
+}
+
+// u runs along -x. tangent -x, and dP/dv disagrees with cross(N, T), so w = -1.
+static void testMirroredQuad()
+{
+	MeshInfo mesh;
+	makeQuad(&mesh, true);
+
+	TangentStats stats;
+	GenerateTangents(&mesh, &stats);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		CHECK(isNear(getTangent(mesh.Vertices[i]), Vector3(-1.0f, 0.0f, 0.0f), 1e-5f));
+		CHECK(mesh.Vertices[i].Tangent.w == -1.0f);
+	}
+	CHECK(stats.MirroredVertexCount == 4 && stats.FallbackVertexCount == 0);
+}
+
+// all uvs same. face adds nothing, vertices fall back to unit vector perpendicular to normal.
+static void testZeroUVArea()
+{
+	MeshInfo mesh;
+	const Vector3 NORMAL(0.0f, 0.6f, 0.8f);
+	mesh.Vertices.push_back(makeVertex(Vector3(0.0f, 0.0f, 0.0f), NORMAL, Vector2(0.5f, 0.5f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(1.0f, 0.0f, 0.0f), NORMAL, Vector2(0.5f, 0.5f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(0.0f, 1.0f, 0.0f), NORMAL, Vector2(0.5f, 0.5f)));
+	mesh.Indices = { 0, 1, 2 };
+
+	TangentStats stats;
+	GenerateTangents(&mesh, &stats);
+	CHECK(stats.DegenerateFaceCount == 1 && stats.FallbackVertexCount == 3);
+	for (UINT i = 0; i < 3; ++i)
+	{
+		const Vector3 TANGENT = getTangent(mesh.Vertices[i]);
+		CHECK(fabsf(TANGENT.Length() - 1.0f) < 1e-5f);
+		CHECK(fabsf(TANGENT.Dot(NORMAL)) < 1e-5f);
+		CHECK(mesh.Vertices[i].Tangent.w == 1.0f || mesh.Vertices[i].Tangent.w == -1.0f);
+	}
+}
+
+// shared vertex gets tangents of both faces weighted by area, then made perpendicular to its own normal.
+static void testAccumulation()
+{
+	MeshInfo mesh;
+	const Vector3 NORMAL(0.0f, 0.0f, 1.0f);
+	Vector3 tiltedNormal(0.3f, 0.0f, 1.0f);
+	tiltedNormal.Normalize();
+
+	// big face with tangent +x, small face with tangent +y. both share vertex 0.
+	mesh.Vertices.push_back(makeVertex(Vector3(0.0f, 0.0f, 0.0f), tiltedNormal, Vector2(0.0f, 0.0f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(3.0f, 0.0f, 0.0f), NORMAL, Vector2(1.0f, 0.0f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(0.0f, 3.0f, 0.0f), NORMAL, Vector2(0.0f, 1.0f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(0.0f, -1.0f, 0.0f), NORMAL, Vector2(1.0f, 0.0f)));
+	mesh.Vertices.push_back(makeVertex(Vector3(-1.0f, 0.0f, 0.0f), NORMAL, Vector2(0.0f, 1.0f)));
+	mesh.Indices = { 0, 1, 2, 0, 3, 4 };
+
+	GenerateTangents(&mesh);
+
+	// 9 * (1, 0, 0) + 1 * (0, -1, 0), then Gram-Schmidt against tilted normal.
+	Vector3 expected(9.0f, -1.0f, 0.0f);
+	expected -= tiltedNormal * tiltedNormal.Dot(expected);
+	expected.Normalize();
+	const Vector3 TANGENT = getTangent(mesh.Vertices[0]);
+	CHECK(isNear(TANGENT, expected, 1e-5f));
+	CHECK(fabsf(TANGENT.Dot(tiltedNormal)) < 1e-5f);
+}
+
+// skinned array gets same tangents when it matches vertex count, stays untouched otherwise.
+static void testSkinned()
+{
+	MeshInfo mesh;
+	makeQuad(&mesh, true);
+	mesh.SkinnedVertices.resize(4);
+	GenerateTangents(&mesh);
+	for (UINT i = 0; i < 4; ++i)
+	{
+		CHECK(mesh.SkinnedVertices[i].Tangent == mesh.Vertices[i].Tangent);
+	}
+
+	MeshInfo mismatched;
+	makeQuad(&mismatched, false);
+	mismatched.SkinnedVertices.resize(2);
+	GenerateTangents(&mismatched);
+	CHECK(mismatched.SkinnedVertices[0].Tangent == Vector4(0.0f, 0.0f, 0.0f, 0.0f));
+}
+
+// wavy grid with random uv jitter and some mirrored and collapsed uvs. one range and many ranges sum same faces
+// in other order only.
+static void makeGrid(MeshInfo* pMeshInfo, const UINT SIZE)
+{
+	TestRandom random;
+	for (UINT y = 0; y <= SIZE; ++y)
+	{
+		for (UINT x = 0; x <= SIZE; ++x)
+		{
+			const float FX = (float)x / (float)SIZE;
+			const float FY = (float)y / (float)SIZE;
+			Vector3 normal(sinf(FX * 6.0f) * 0.3f, cosf(FY * 5.0f) * 0.3f, 1.0f);
+			normal.Normalize();
+			Vector2 texcoord(FX + random.NextFloat() * 0.001f, FY + random.NextFloat() * 0.001f);
+			if (x > SIZE / 2)
+			{
+				texcoord.x = 1.0f - texcoord.x;
+			}
+			if (random.NextUInt(50) == 0)
+			{
+				texcoord = Vector2(0.5f, 0.5f);
+			}
+			pMeshInfo->Vertices.push_back(makeVertex(Vector3(FX, FY, sinf(FX * 9.0f) * cosf(FY * 7.0f) * 0.1f), normal, texcoord));
+		}
+	}
+	for (UINT y = 0; y < SIZE; ++y)
+	{
+		for (UINT x = 0; x < SIZE; ++x)
+		{
+			const UINT I = y * (SIZE + 1) + x;
+			pMeshInfo->Indices.insert(pMeshInfo->Indices.end(), { I, I + 1, I + SIZE + 2, I, I + SIZE + 2, I + SIZE + 1 });
+		}
+	}
+}
+
+static void testRanges()
+{
+	MeshInfo single;
+	makeGrid(&single, 200);
+	TangentStats singleStats;
+	GenerateTangents(&single, &singleStats, 1);
+	CHECK(singleStats.RangeCount == 1);
+	CHECK(singleStats.MirroredVertexCount > 0 && singleStats.DegenerateFaceCount > 0);
+
+	const UINT pRANGE_COUNTS[] = { 2, 7, MAX_PARALLEL_THREAD_COUNT, 1000 };
+	for (UINT r = 0; r < sizeof(pRANGE_COUNTS) / sizeof(pRANGE_COUNTS[0]); ++r)
+	{
+		MeshInfo multi;
+		makeGrid(&multi, 200);
+		TangentStats multiStats;
+		GenerateTangents(&multi, &multiStats, pRANGE_COUNTS[r]);
+		CHECK(multiStats.RangeCount == (pRANGE_COUNTS[r] < MAX_PARALLEL_THREAD_COUNT ? pRANGE_COUNTS[r] : MAX_PARALLEL_THREAD_COUNT));
+		CHECK(multiStats.DegenerateFaceCount == singleStats.DegenerateFaceCount);
+		CHECK(multiStats.FallbackVertexCount == singleStats.FallbackVertexCount);
+		CHECK(multiStats.MirroredVertexCount == singleStats.MirroredVertexCount);
+
+		UINT mismatchCount = 0;
+		for (UINT64 i = 0, size = single.Vertices.size(); i < size; ++i)
+		{
+			if (!isNear(getTangent(single.Vertices[i]), getTangent(multi.Vertices[i]), 1e-4f) || single.Vertices[i].Tangent.w != multi.Vertices[i].Tangent.w)
+			{
+				++mismatchCount;
+			}
+		}
+		CHECK(mismatchCount == 0);
+	}
+
+	// same range count gives same bits on any core count.
+	MeshInfo again;
+	makeGrid(&again, 200);
+	GenerateTangents(&again, nullptr, 7);
+	MeshInfo other;
+	makeGrid(&other, 200);
+	GenerateTangents(&other, nullptr, 7);
+	CHECK(memcmp(again.Vertices.data(), other.Vertices.data(), sizeof(Vertex) * again.Vertices.size()) == 0);
+
+	// empty mesh.
+	MeshInfo empty;
+	TangentStats emptyStats;
+	GenerateTangents(&empty, &emptyStats);
+	CHECK(emptyStats.RangeCount == 0);
+}
+
+int main()
+{
+	testQuad();
+	testSmallScale();
+	testMirroredQuad();
+	testZeroUVArea();
+	testAccumulation();
+	testSkinned();
+	testRanges();
+
+	return TEST_RESULT();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// minimal checks for headless tests. a test returns TEST_RESULT() from main, non zero on any failure.
+
+#include <chrono>
+
+static int g_TestFailCount = 0;
+
+#define CHECK(expr)																	 \
+		do																			 \
+		{																			 \
+			if (!(expr))															 \
+			{																		 \
+				fprintf(stderr, "%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); \
+				++g_TestFailCount;													 \
+			}																		 \
+		} while (0)
+
+#define TEST_RESULT() (g_TestFailCount == 0 ? (printf("passed\n"), 0) : (printf("%d checks failed\n", g_TestFailCount), 1))
+
+// deterministic xorshift. tests must not depend on libc rand.
+struct TestRandom
+{
+	UINT64 State = 88172645463325252ull;
+
+	UINT64 Next()
+	{
+		State ^= State << 13;
+		State ^= State >> 7;
+		State ^= State << 17;
+		return State;
+	}
+	UINT NextUInt(const UINT UPPER) { return (UINT)(Next() % UPPER); }
+	float NextFloat() { return (float)(Next() >> 40) / (float)(1ull << 24); }
+};
+
+// seconds since first call.
+inline double GetTestTime()
+{
+	static const std::chrono::steady_clock::time_point s_START = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_START).count();
+}
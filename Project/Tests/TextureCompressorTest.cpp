@@ -0,0 +1,209 @@
+#include "../pch.h"
+#include <DirectXTex.h>
+#include "../Util/Utility.h"
+#include "../Graphics/GraphicsUtil.h"
+#include "../Graphics/ImageProcessing.h"
+#include "../Graphics/TextureCompressor.h"
+#include "TestCommon.h"
+
+// CompressImage through headless DirectXTex(BC1/BC3/BC4/BC5 only). PSNR limits are for its bounding box encoder,
+// real DirectXTex does better. reported PSNR is checked against decode of returned blocks.
+
+// smooth gradients with a little noise. channels differ so swizzle errors show up.
+static void makeImage(std::vector<UCHAR>* pImage, const UINT WIDTH, const UINT HEIGHT, const UINT NOISE, UINT* pMipLevels)
+{
+	TestRandom random;
+	pImage->resize((UINT64)WIDTH * HEIGHT * 4);
+	for (UINT y = 0; y < HEIGHT; ++y)
+	{
+		for (UINT x = 0; x < WIDTH; ++x)
+		{
+			UCHAR* pPixel = pImage->data() + ((UINT64)y * WIDTH + x) * 4;
+			const float U = (float)x / (float)WIDTH;
+			const float V = (float)y / (float)HEIGHT;
+			const int VALUES[4] =
+			{
+				(int)(U * 255.0f),
+				(int)(V * 200.0f + 30.0f),
+				(int)((0.5f + 0.5f * sinf(U * 6.0f + V * 3.0f)) * 255.0f),
+				(int)((1.0f - U * V) * 255.0f),
+			};
+			for (UINT c = 0; c < 4; ++c)
+			{
+				int noise = (NOISE > 0 ? (int)random.NextUInt(NOISE * 2 + 1) - (int)NOISE : 0);
+				pPixel[c] = (UCHAR)Max(Min(VALUES[c] + noise, 255), 0);
+			}
+		}
+	}
+	CHECK(SUCCEEDED(GenerateMips(*pImage, WIDTH, HEIGHT, DXGI_FORMAT_R8G8B8A8_UNORM, pMipLevels, false)));
+}
+
+// level 0 PSNR over CHANNEL_COUNT channels starting at SRC_CHANNEL of source, decoded from first channels of blocks.
+static double decodePSNR(const std::vector<UCHAR>& SOURCE, const std::vector<UCHAR>& COMPRESSED, const UINT WIDTH, const UINT HEIGHT,
+						 const DXGI_FORMAT FORMAT, const UINT SRC_CHANNEL, const UINT CHANNEL_COUNT)
+{
+	DirectX::Image compressedImage;
+	compressedImage.width = WIDTH;
+	compressedImage.height = HEIGHT;
+	compressedImage.format = FORMAT;
+	compressedImage.rowPitch = (size_t)((WIDTH + 3) / 4) * GetBlockSize(FORMAT);
+	compressedImage.slicePitch = compressedImage.rowPitch * ((HEIGHT + 3) / 4);
+	compressedImage.pixels = (uint8_t*)COMPRESSED.data();
+
+	DirectX::ScratchImage decompressed;
+	CHECK(SUCCEEDED(DirectX::Decompress(compressedImage, DXGI_FORMAT_R8G8B8A8_UNORM, decompressed)));
+
+	const UCHAR* pDECOMPRESSED = decompressed.GetPixels();
+	double squaredError = 0.0;
+	for (UINT64 i = 0, count = (UINT64)WIDTH * HEIGHT; i < count; ++i)
+	{
+		for (UINT c = 0; c < CHANNEL_COUNT; ++c)
+		{
+			double diff = (double)SOURCE[i * 4 + SRC_CHANNEL + c] - (double)pDECOMPRESSED[i * 4 + c];
+			squaredError += diff * diff;
+		}
+	}
+	return 10.0 * log10(255.0 * 255.0 / (squaredError / ((double)WIDTH * HEIGHT * CHANNEL_COUNT)));
+}
+
+struct CompressCase
+{
+	const char* pszName;
+	eTextureUsage Usage;
+	DXGI_FORMAT Format;
+	UINT SrcChannel; // first channel compared.
+	UINT ChannelCount;
+	double MinPSNR;
+};
+
+static void testPSNR()
+{
+	const UINT WIDTH = 128;
+	const UINT HEIGHT = 64;
+	const CompressCase CASES[] =
+	{
+		{ "color bc1", TextureUsage_Color, DXGI_FORMAT_BC1_UNORM_SRGB, 0, 3, 30.0 },
+		{ "color bc3", TextureUsage_Color, DXGI_FORMAT_BC3_UNORM_SRGB, 0, 4, 30.0 },
+		{ "normal bc5", TextureUsage_Normal, DXGI_FORMAT_BC5_UNORM, 0, 2, 38.0 },
+		{ "r bc4", TextureUsage_ScalarR, DXGI_FORMAT_BC4_UNORM, 0, 1, 38.0 },
+		{ "g bc4", TextureUsage_ScalarG, DXGI_FORMAT_BC4_UNORM, 1, 1, 38.0 },
+		{ "b bc4", TextureUsage_ScalarB, DXGI_FORMAT_BC4_UNORM, 2, 1, 38.0 },
+	};
+
+	std::vector<UCHAR> source;
+	UINT mipLevels = 0;
+	makeImage(&source, WIDTH, HEIGHT, 2, &mipLevels);
+
+	for (UINT i = 0; i < _countof(CASES); ++i)
+	{
+		const CompressCase& CASE = CASES[i];
+		const DXGI_FORMAT SRC_FORMAT = (CASE.Usage == TextureUsage_Color ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM);
+
+		// app picks bc1 only for opaque images.
+		std::vector<UCHAR> opaqueSource;
+		if (CASE.Format == DXGI_FORMAT_BC1_UNORM_SRGB)
+		{
+			opaqueSource = source;
+			FillChannel(opaqueSource.data(), opaqueSource.size() / 4, 3, 255);
+		}
+		const std::vector<UCHAR>& CASE_SOURCE = (opaqueSource.empty() ? source : opaqueSource);
+
+		std::vector<UCHAR> image = CASE_SOURCE;
+		double psnr = 0.0;
+		CHECK(SUCCEEDED(CompressImage(image, WIDTH, HEIGHT, mipLevels, SRC_FORMAT, CASE.Usage, CASE.Format, TextureCompressionPreset_Fast, false, &psnr)));
+		CHECK(image.size() == GetMipChainSize(WIDTH, HEIGHT, mipLevels, CASE.Format));
+
+		const double DECODED_PSNR = decodePSNR(CASE_SOURCE, image, WIDTH, HEIGHT, CASE.Format, CASE.SrcChannel, CASE.ChannelCount);
+		printf("%-10s %6.2f dB(%u levels, %u -> %u bytes)\n", CASE.pszName, psnr, mipLevels, (UINT)source.size(), (UINT)image.size());
+		CHECK(psnr >= CASE.MinPSNR);
+		// CompressImage measures alpha of bc1 too. it has no error, so 4 channel PSNR is higher.
+		if (CASE.Format == DXGI_FORMAT_BC1_UNORM_SRGB)
+		{
+			CHECK(psnr >= DECODED_PSNR);
+		}
+		else
+		{
+			CHECK(fabs(psnr - DECODED_PSNR) < 1e-9);
+		}
+	}
+}
+
+static void testNoiseLowersPSNR()
+{
+	const UINT SIZE = 64;
+	std::vector<UCHAR> smooth;
+	std::vector<UCHAR> noisy;
+	UINT mipLevels = 0;
+	makeImage(&smooth, SIZE, SIZE, 0, &mipLevels);
+	makeImage(&noisy, SIZE, SIZE, 40, &mipLevels);
+
+	double smoothPSNR = 0.0;
+	double noisyPSNR = 0.0;
+	CHECK(SUCCEEDED(CompressImage(smooth, SIZE, SIZE, mipLevels, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_ScalarR, DXGI_FORMAT_BC4_UNORM, TextureCompressionPreset_Fast, false, &smoothPSNR)));
+	CHECK(SUCCEEDED(CompressImage(noisy, SIZE, SIZE, mipLevels, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_ScalarR, DXGI_FORMAT_BC4_UNORM, TextureCompressionPreset_Fast, false, &noisyPSNR)));
+	printf("bc4 smooth %.2f dB, noisy %.2f dB\n", smoothPSNR, noisyPSNR);
+	CHECK(noisyPSNR + 6.0 < smoothPSNR);
+}
+
+static void testMultiThreadMatches()
+{
+	const UINT SIZE = 512;
+	std::vector<UCHAR> singleThreadImage;
+	UINT mipLevels = 0;
+	makeImage(&singleThreadImage, SIZE, SIZE, 8, &mipLevels);
+	std::vector<UCHAR> multiThreadImage = singleThreadImage;
+
+	double singleThreadPSNR = 0.0;
+	double multiThreadPSNR = 0.0;
+	CHECK(SUCCEEDED(CompressImage(singleThreadImage, SIZE, SIZE, mipLevels, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_Normal, DXGI_FORMAT_BC5_UNORM, TextureCompressionPreset_Fast, false, &singleThreadPSNR)));
+	CHECK(SUCCEEDED(CompressImage(multiThreadImage, SIZE, SIZE, mipLevels, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_Normal, DXGI_FORMAT_BC5_UNORM, TextureCompressionPreset_Fast, true, &multiThreadPSNR)));
+	CHECK(singleThreadImage == multiThreadImage);
+	CHECK(singleThreadPSNR == multiThreadPSNR);
+}
+
+static void testRejects()
+{
+	std::vector<UCHAR> image(16 * 16 * 4, 128);
+	const std::vector<UCHAR> ORIGINAL = image;
+	double psnr = -1.0;
+
+	// source must be RGBA8, destination block compressed. image and psnr stay as they were.
+	CHECK(CompressImage(image, 16, 16, 1, DXGI_FORMAT_R32G32B32A32_FLOAT, TextureUsage_ScalarR, DXGI_FORMAT_BC4_UNORM, TextureCompressionPreset_Fast, false, &psnr) == E_INVALIDARG);
+	CHECK(CompressImage(image, 16, 16, 1, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_ScalarR, DXGI_FORMAT_R8G8B8A8_UNORM, TextureCompressionPreset_Fast, false, &psnr) == E_INVALIDARG);
+	// encoder failure.
+	CHECK(FAILED(CompressImage(image, 16, 16, 1, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_ORMH, DXGI_FORMAT_BC7_UNORM, TextureCompressionPreset_Fast, false, &psnr)));
+	CHECK(image == ORIGINAL);
+	CHECK(psnr == -1.0);
+
+	// flat image compresses losslessly.
+	CHECK(SUCCEEDED(CompressImage(image, 16, 16, 1, DXGI_FORMAT_R8G8B8A8_UNORM, TextureUsage_ScalarR, DXGI_FORMAT_BC4_UNORM, TextureCompressionPreset_Fast, false, &psnr)));
+	CHECK(psnr == 99.0);
+}
+
+static void testFormatSelection()
+{
+	CHECK(GetCompressedFormat(TextureUsage_Color, TextureCompressionPreset_Fast, 64, 64, false) == DXGI_FORMAT_BC1_UNORM_SRGB);
+	CHECK(GetCompressedFormat(TextureUsage_Color, TextureCompressionPreset_Fast, 64, 64, true) == DXGI_FORMAT_BC3_UNORM_SRGB);
+	CHECK(GetCompressedFormat(TextureUsage_Color, TextureCompressionPreset_Quality, 64, 64, true) == DXGI_FORMAT_BC7_UNORM_SRGB);
+	CHECK(GetCompressedFormat(TextureUsage_Normal, TextureCompressionPreset_Fast, 64, 64, false) == DXGI_FORMAT_BC5_UNORM);
+	CHECK(GetCompressedFormat(TextureUsage_ScalarG, TextureCompressionPreset_Fast, 64, 64, false) == DXGI_FORMAT_BC4_UNORM);
+	CHECK(GetCompressedFormat(TextureUsage_ORMH, TextureCompressionPreset_Fast, 64, 64, false) == DXGI_FORMAT_BC7_UNORM);
+	// top level must be whole blocks.
+	CHECK(GetCompressedFormat(TextureUsage_Normal, TextureCompressionPreset_Fast, 64, 30, false) == DXGI_FORMAT_UNKNOWN);
+
+	UCHAR pixels[8] = { 0, 0, 0, 255, 0, 0, 0, 255 };
+	CHECK(!HasAlpha(pixels, 2));
+	pixels[7] = 254;
+	CHECK(HasAlpha(pixels, 2));
+}
+
+int main()
+{
+	testPSNR();
+	testNoiseLowersPSNR();
+	testMultiThreadMatches();
+	testRejects();
+	testFormatSelection();
+
+	return TEST_RESULT();
+}
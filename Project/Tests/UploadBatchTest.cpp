@@ -0,0 +1,757 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Renderer/UploadBatch.h"
+#include "TestCommon.h"
+
+#include <set>
+
+// StagingRing offsets, then UploadBatch against mock device whose GPU lags behind CPU.
+// mock GPU runs recorded copies only when it reaches them, so staging bytes overwritten too early show up in destination.
+
+static void testRingWrap()
+{
+	StagingRing ring;
+	ring.Initialize(1024);
+
+	CHECK(ring.Allocate(400, 16) == 0);
+	CHECK(ring.CloseBatch(1));
+	CHECK(ring.Allocate(400, 16) == 400);
+	CHECK(ring.CloseBatch(2));
+	CHECK(ring.GetUsedSize() == 800);
+
+	// end has 224 bytes and front is still in use.
+	CHECK(ring.Allocate(300, 16) == UINT64_MAX);
+	ring.Retire(0);
+	CHECK(ring.GetPendingBatchCount() == 2);
+
+	// wraps to front. skipped tail end counts as used until batch retires.
+	ring.Retire(1);
+	CHECK(ring.GetUsedSize() == 400);
+	CHECK(ring.Allocate(300, 16) == 0);
+	CHECK(ring.GetUsedSize() == 924);
+
+	// free space is [300, 400) now.
+	CHECK(ring.Allocate(200, 16) == UINT64_MAX);
+	CHECK(ring.Allocate(96, 16) == 304);
+	CHECK(ring.GetUsedSize() == 1024);
+	CHECK(ring.Allocate(1, 1) == UINT64_MAX);
+	CHECK(ring.CloseBatch(3));
+
+	CHECK(ring.GetOldestFenceValue() == 2);
+	ring.Retire(2);
+	CHECK(ring.GetUsedSize() == 624);
+	ring.Retire(3);
+	CHECK(ring.GetUsedSize() == 0);
+	CHECK(ring.GetPendingBatchCount() == 0);
+	CHECK(ring.GetOldestFenceValue() == 0);
+
+	// empty ring starts over from front.
+	CHECK(ring.Allocate(64, 16) == 0);
+	CHECK(ring.Allocate(10, 16) == 64);
+	CHECK(ring.Allocate(10, 256) == 256);
+	CHECK(ring.GetUsedSize() == 266);
+
+	// closing without allocations adds no batch.
+	CHECK(ring.CloseBatch(4));
+	CHECK(ring.CloseBatch(5));
+	CHECK(ring.GetPendingBatchCount() == 1);
+	ring.Retire(4);
+	CHECK(ring.GetUsedSize() == 0);
+}
+
+static void testRingBatchQueueFull()
+{
+	StagingRing ring;
+	ring.Initialize(4096);
+
+	for (UINT i = 0; i < MAX_PENDING_UPLOAD_BATCH_COUNT; ++i)
+	{
+		CHECK(ring.Allocate(1, 1) != UINT64_MAX);
+		CHECK(ring.CloseBatch(i + 1));
+	}
+	CHECK(ring.Allocate(1, 1) != UINT64_MAX);
+	CHECK(!ring.CloseBatch(MAX_PENDING_UPLOAD_BATCH_COUNT + 1));
+	CHECK(ring.GetOldestFenceValue() == 1);
+
+	ring.Retire(1);
+	CHECK(ring.CloseBatch(MAX_PENDING_UPLOAD_BATCH_COUNT + 1));
+	ring.Retire(MAX_PENDING_UPLOAD_BATCH_COUNT + 1);
+	CHECK(ring.GetUsedSize() == 0);
+}
+
+// random allocate, close and retire against model of live ranges.
+static void testRingFuzz()
+{
+	struct Range
+	{
+		UINT64 Offset;
+		UINT64 Size;
+		UINT64 FenceValue; // 0 while batch is open.
+	};
+
+	const UINT64 RING_SIZE = 8192;
+	StagingRing ring;
+	ring.Initialize(RING_SIZE);
+
+	TestRandom random;
+	std::vector<Range> liveRanges;
+	UINT64 fenceValue = 0;
+	UINT64 completedFenceValue = 0;
+	UINT allocatedCount = 0;
+	UINT failedCount = 0;
+	UINT wrapCount = 0;
+	UINT64 lastOffset = 0;
+
+	for (int step = 0; step < 200000; ++step)
+	{
+		const UINT ACTION = random.NextUInt(10);
+		if (ACTION < 6)
+		{
+			const UINT64 SIZE = 1 + random.NextUInt(random.NextUInt(4) == 0 ? (UINT)RING_SIZE / 2 : 256);
+			const UINT64 ALIGNMENT = 1ull << random.NextUInt(9);
+			const UINT64 OFFSET = ring.Allocate(SIZE, ALIGNMENT);
+			if (OFFSET == UINT64_MAX)
+			{
+				++failedCount;
+				continue;
+			}
+
+			CHECK((OFFSET & (ALIGNMENT - 1)) == 0);
+			CHECK(OFFSET + SIZE <= RING_SIZE);
+			for (UINT64 i = 0, size = liveRanges.size(); i < size; ++i)
+			{
+				const Range& RANGE = liveRanges[i];
+				if (OFFSET < RANGE.Offset + RANGE.Size && RANGE.Offset < OFFSET + SIZE)
+				{
+					CHECK(false);
+					break;
+				}
+			}
+			if (OFFSET < lastOffset)
+			{
+				++wrapCount;
+			}
+			lastOffset = OFFSET;
+
+			liveRanges.push_back({ OFFSET, SIZE, 0 });
+			++allocatedCount;
+		}
+		else if (ACTION < 8)
+		{
+			const bool bHAS_OPEN = (!liveRanges.empty() && liveRanges.back().FenceValue == 0);
+			if (ring.CloseBatch(fenceValue + 1))
+			{
+				if (bHAS_OPEN)
+				{
+					++fenceValue;
+					for (UINT64 i = liveRanges.size(); i > 0 && liveRanges[i - 1].FenceValue == 0; --i)
+					{
+						liveRanges[i - 1].FenceValue = fenceValue;
+					}
+				}
+			}
+			else
+			{
+				CHECK(ring.GetPendingBatchCount() == MAX_PENDING_UPLOAD_BATCH_COUNT);
+			}
+		}
+		else if (fenceValue > completedFenceValue)
+		{
+			completedFenceValue += 1 + random.NextUInt((UINT)(fenceValue - completedFenceValue));
+			ring.Retire(completedFenceValue);
+
+			UINT64 retiredCount = 0;
+			while (retiredCount < liveRanges.size() && liveRanges[retiredCount].FenceValue != 0 && liveRanges[retiredCount].FenceValue <= completedFenceValue)
+			{
+				++retiredCount;
+			}
+			liveRanges.erase(liveRanges.begin(), liveRanges.begin() + retiredCount);
+		}
+
+		UINT64 liveSize = 0;
+		for (UINT64 i = 0, size = liveRanges.size(); i < size; ++i)
+		{
+			liveSize += liveRanges[i].Size;
+		}
+		CHECK(ring.GetUsedSize() >= liveSize && ring.GetUsedSize() <= RING_SIZE);
+		CHECK(ring.GetPendingBatchCount() <= (UINT)(fenceValue - completedFenceValue));
+	}
+
+	CHECK(ring.CloseBatch(fenceValue + 1));
+	ring.Retire(fenceValue + 1);
+	CHECK(ring.GetUsedSize() == 0);
+	CHECK(ring.GetPendingBatchCount() == 0);
+
+	// fuzz must actually fill and wrap ring.
+	CHECK(allocatedCount > 10000);
+	CHECK(failedCount > 1000);
+	CHECK(wrapCount > 1000);
+}
+
+// mock device. commands are kept by reference and run when GPU reaches them.
+enum MOCK_COMMAND_TYPE
+{
+	MOCK_COMMAND_COPY_BUFFER,
+	MOCK_COMMAND_COPY_TEXTURE,
+	MOCK_COMMAND_BARRIER,
+};
+
+struct MockCommand
+{
+	MOCK_COMMAND_TYPE Type;
+	ID3D12Resource* pDest;
+	UINT64 DestOffset; // subresource index for textures.
+	ID3D12Resource* pSrc;
+	UINT64 SrcOffset;
+	UINT64 Size;
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint;
+};
+
+static std::set<ID3D12Resource*> s_LiveResources;
+
+struct MockResource : public ID3D12Resource
+{
+	D3D12_RESOURCE_DESC Desc = {};
+	std::vector<UCHAR> Memory;
+	std::vector<UINT64> SubresourceOffsets; // textures. levels packed tightly.
+	UINT MapCount = 0;
+
+	MockResource(const D3D12_RESOURCE_DESC& DESC) : Desc(DESC)
+	{
+		if (DESC.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+		{
+			Memory.resize(DESC.Width);
+		}
+		else
+		{
+			UINT64 size = 0;
+			for (UINT mip = 0; mip < DESC.MipLevels; ++mip)
+			{
+				SubresourceOffsets.push_back(size);
+				size += (UINT64)Max((int)(DESC.Width >> mip), 1) * Max((int)(DESC.Height >> mip), 1) * 4;
+			}
+			Memory.resize(size);
+		}
+		s_LiveResources.insert(this);
+	}
+	~MockResource() { s_LiveResources.erase(this); }
+
+	HRESULT Map(UINT subresource, const D3D12_RANGE* pReadRange, void** ppData) override
+	{
+		++MapCount;
+		*ppData = Memory.data();
+		return S_OK;
+	}
+	void Unmap(UINT subresource, const D3D12_RANGE* pWrittenRange) override
+	{
+		CHECK(MapCount > 0);
+		--MapCount;
+	}
+	D3D12_RESOURCE_DESC GetDesc() override { return Desc; }
+};
+
+struct MockFence;
+
+struct MockCommandAllocator : public ID3D12CommandAllocator
+{
+	MockFence* pFence = nullptr;
+	UINT64 FenceValue = 0; // last signal after commands recorded with this allocator.
+	UINT ResetCount = 0;
+
+	HRESULT Reset() override;
+};
+
+struct MockCommandList : public ID3D12GraphicsCommandList
+{
+	MockCommandAllocator* pAllocator = nullptr;
+	std::vector<MockCommand> Commands;
+	bool bClosed = false;
+	ID3D12Resource* pStagingBuffer = nullptr;
+	UINT64 LastStagingOffset = 0;
+	UINT StagingWrapCount = 0;
+
+	HRESULT Close() override
+	{
+		CHECK(!bClosed);
+		bClosed = true;
+		return S_OK;
+	}
+	HRESULT Reset(ID3D12CommandAllocator* pCommandAllocator, ID3D12PipelineState* pInitialState) override
+	{
+		CHECK(bClosed);
+		bClosed = false;
+		pAllocator = (MockCommandAllocator*)pCommandAllocator;
+		Commands.clear();
+		return S_OK;
+	}
+	void ResourceBarrier(UINT numBarriers, const D3D12_RESOURCE_BARRIER* pBarriers) override
+	{
+		CHECK(!bClosed);
+		MockCommand command = {};
+		command.Type = MOCK_COMMAND_BARRIER;
+		for (UINT i = 0; i < numBarriers; ++i)
+		{
+			command.pDest = pBarriers[i].Transition.pResource;
+			Commands.push_back(command);
+		}
+	}
+	void CopyBufferRegion(ID3D12Resource* pDstBuffer, UINT64 dstOffset, ID3D12Resource* pSrcBuffer, UINT64 srcOffset, UINT64 numBytes) override
+	{
+		CHECK(!bClosed);
+		MockCommand command = {};
+		command.Type = MOCK_COMMAND_COPY_BUFFER;
+		command.pDest = pDstBuffer;
+		command.DestOffset = dstOffset;
+		command.pSrc = pSrcBuffer;
+		command.SrcOffset = srcOffset;
+		command.Size = numBytes;
+		Commands.push_back(command);
+
+		countStagingWrap(pSrcBuffer, srcOffset);
+	}
+	void CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* pDst, UINT dstX, UINT dstY, UINT dstZ, const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX* pSrcBox) override
+	{
+		CHECK(!bClosed);
+		CHECK(pDst->Type == D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX);
+		CHECK(pSrc->Type == D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT);
+		MockCommand command = {};
+		command.Type = MOCK_COMMAND_COPY_TEXTURE;
+		command.pDest = pDst->pResource;
+		command.DestOffset = pDst->SubresourceIndex;
+		command.pSrc = pSrc->pResource;
+		command.Footprint = pSrc->PlacedFootprint;
+		Commands.push_back(command);
+
+		countStagingWrap(pSrc->pResource, pSrc->PlacedFootprint.Offset);
+	}
+
+private:
+	void countStagingWrap(ID3D12Resource* pSrcResource, const UINT64 SRC_OFFSET)
+	{
+		if (pSrcResource != pStagingBuffer)
+		{
+			return;
+		}
+		if (SRC_OFFSET < LastStagingOffset)
+		{
+			++StagingWrapCount;
+		}
+		LastStagingOffset = SRC_OFFSET;
+	}
+};
+
+struct MockFence : public ID3D12Fence
+{
+	struct MockCommandQueue* pQueue = nullptr;
+	UINT64 CompletedValue = 0;
+
+	UINT64 GetCompletedValue() override { return CompletedValue; }
+	HRESULT SetEventOnCompletion(UINT64 value, HANDLE hEvent) override;
+};
+
+struct MockCommandQueue : public ID3D12CommandQueue
+{
+	struct Submission
+	{
+		std::vector<MockCommand> Commands;
+		UINT64 FenceValue; // 0 until signaled.
+	};
+	std::vector<Submission> Submissions; // not yet run by GPU.
+	std::vector<MockCommandAllocator*> UnsignaledAllocators;
+	MockFence* pFence = nullptr;
+	UINT64 WaitCount = 0;
+
+	void ExecuteCommandLists(UINT numCommandLists, ID3D12CommandList* const* ppCommandLists) override
+	{
+		for (UINT i = 0; i < numCommandLists; ++i)
+		{
+			MockCommandList* pList = (MockCommandList*)ppCommandLists[i];
+			CHECK(pList->bClosed);
+			Submissions.push_back({ pList->Commands, 0 });
+			UnsignaledAllocators.push_back(pList->pAllocator);
+		}
+	}
+	HRESULT Signal(ID3D12Fence* pSignalFence, UINT64 value) override
+	{
+		CHECK(pSignalFence == pFence);
+		for (UINT64 i = 0, size = Submissions.size(); i < size; ++i)
+		{
+			if (Submissions[i].FenceValue == 0)
+			{
+				Submissions[i].FenceValue = value;
+			}
+		}
+		for (UINT64 i = 0, size = UnsignaledAllocators.size(); i < size; ++i)
+		{
+			UnsignaledAllocators[i]->FenceValue = value;
+		}
+		UnsignaledAllocators.clear();
+		return S_OK;
+	}
+
+	// runs one signaled submission. false when nothing is signaled.
+	bool Step()
+	{
+		if (Submissions.empty() || Submissions[0].FenceValue == 0)
+		{
+			return false;
+		}
+
+		const Submission& SUBMISSION = Submissions[0];
+		for (UINT64 i = 0, size = SUBMISSION.Commands.size(); i < size; ++i)
+		{
+			execute(SUBMISSION.Commands[i]);
+		}
+		pFence->CompletedValue = SUBMISSION.FenceValue;
+		Submissions.erase(Submissions.begin());
+		return true;
+	}
+	void RunUntil(const UINT64 FENCE_VALUE)
+	{
+		while (pFence->CompletedValue < FENCE_VALUE && Step())
+		{
+		}
+		CHECK(pFence->CompletedValue >= FENCE_VALUE);
+	}
+
+private:
+	void execute(const MockCommand& COMMAND)
+	{
+		// resources must outlive GPU work that uses them.
+		CHECK(s_LiveResources.count(COMMAND.pDest) == 1);
+		if (COMMAND.Type == MOCK_COMMAND_BARRIER)
+		{
+			return;
+		}
+		CHECK(s_LiveResources.count(COMMAND.pSrc) == 1);
+
+		MockResource* pDest = (MockResource*)COMMAND.pDest;
+		const MockResource* pSRC = (const MockResource*)COMMAND.pSrc;
+		if (COMMAND.Type == MOCK_COMMAND_COPY_BUFFER)
+		{
+			CHECK(COMMAND.DestOffset + COMMAND.Size <= pDest->Memory.size());
+			CHECK(COMMAND.SrcOffset + COMMAND.Size <= pSRC->Memory.size());
+			memcpy(pDest->Memory.data() + COMMAND.DestOffset, pSRC->Memory.data() + COMMAND.SrcOffset, COMMAND.Size);
+			return;
+		}
+
+		const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& FOOTPRINT = COMMAND.Footprint;
+		const UINT64 ROW_SIZE = (UINT64)FOOTPRINT.Footprint.Width * 4;
+		UCHAR* pDestRow = pDest->Memory.data() + pDest->SubresourceOffsets[COMMAND.DestOffset];
+		for (UINT row = 0; row < FOOTPRINT.Footprint.Height; ++row)
+		{
+			const UINT64 SRC_OFFSET = FOOTPRINT.Offset + (UINT64)row * FOOTPRINT.Footprint.RowPitch;
+			CHECK(SRC_OFFSET + ROW_SIZE <= pSRC->Memory.size());
+			memcpy(pDestRow, pSRC->Memory.data() + SRC_OFFSET, ROW_SIZE);
+			pDestRow += ROW_SIZE;
+		}
+	}
+};
+
+HRESULT MockCommandAllocator::Reset()
+{
+	// commands recorded with this allocator must be done.
+	CHECK(pFence->CompletedValue >= FenceValue);
+	++ResetCount;
+	return S_OK;
+}
+
+HRESULT MockFence::SetEventOnCompletion(UINT64 value, HANDLE hEvent)
+{
+	// wait that would block forever is failure.
+	pQueue->RunUntil(value);
+	++pQueue->WaitCount;
+	SetEvent(hEvent);
+	return S_OK;
+}
+
+struct MockDevice : public ID3D12Device5
+{
+	MockFence* pFence = nullptr;
+	std::vector<MockCommandAllocator*> Allocators;
+	MockCommandList* pCommandList = nullptr;
+	ID3D12Resource* pFirstUploadBuffer = nullptr; // staging ring.
+	UINT UploadBufferCount = 0;
+
+	HRESULT CreateCommittedResource(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS heapFlags, const D3D12_RESOURCE_DESC* pDesc,
+									D3D12_RESOURCE_STATES initialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource) override
+	{
+		MockResource* pResource = new MockResource(*pDesc);
+		if (pHeapProperties->Type == D3D12_HEAP_TYPE_UPLOAD)
+		{
+			if (!pFirstUploadBuffer)
+			{
+				pFirstUploadBuffer = pResource;
+			}
+			++UploadBufferCount;
+		}
+		*ppvResource = pResource;
+		return S_OK;
+	}
+	HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type, REFIID riid, void** ppCommandAllocator) override
+	{
+		MockCommandAllocator* pAllocator = new MockCommandAllocator;
+		pAllocator->pFence = pFence;
+		Allocators.push_back(pAllocator);
+		*ppCommandAllocator = pAllocator;
+		return S_OK;
+	}
+	HRESULT CreateCommandList(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type, ID3D12CommandAllocator* pCommandAllocator, ID3D12PipelineState* pInitialState, REFIID riid, void** ppCommandList) override
+	{
+		MockCommandList* pList = new MockCommandList;
+		pList->pAllocator = (MockCommandAllocator*)pCommandAllocator;
+		pList->pStagingBuffer = pFirstUploadBuffer;
+		pCommandList = pList;
+		*ppCommandList = pList;
+		return S_OK;
+	}
+	// RGBA8 2D textures only.
+	void GetCopyableFootprints(const D3D12_RESOURCE_DESC* pResourceDesc, UINT firstSubresource, UINT numSubresources, UINT64 baseOffset,
+							   D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts, UINT* pNumRows, UINT64* pRowSizeInBytes, UINT64* pTotalBytes) override
+	{
+		UINT64 offset = baseOffset;
+		UINT64 end = baseOffset;
+		for (UINT i = 0; i < numSubresources; ++i)
+		{
+			const UINT MIP = firstSubresource + i;
+			const UINT WIDTH = (UINT)Max((int)(pResourceDesc->Width >> MIP), 1);
+			const UINT HEIGHT = (UINT)Max((int)(pResourceDesc->Height >> MIP), 1);
+			const UINT64 ROW_SIZE = (UINT64)WIDTH * 4;
+			const UINT ROW_PITCH = (UINT)((ROW_SIZE + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1));
+
+			offset = (end + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+			pLayouts[i].Offset = offset;
+			pLayouts[i].Footprint = { pResourceDesc->Format, WIDTH, HEIGHT, 1, ROW_PITCH };
+			pNumRows[i] = HEIGHT;
+			pRowSizeInBytes[i] = ROW_SIZE;
+			end = offset + (UINT64)ROW_PITCH * (HEIGHT - 1) + ROW_SIZE;
+		}
+		*pTotalBytes = end - baseOffset;
+	}
+};
+
+struct MockGPU
+{
+	MockDevice Device;
+	MockCommandQueue Queue;
+	MockFence Fence;
+	UINT64 FenceValue = 0;
+	HANDLE hFenceEvent = nullptr;
+
+	MockGPU()
+	{
+		Device.pFence = &Fence;
+		Queue.pFence = &Fence;
+		Fence.pQueue = &Queue;
+		hFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	}
+	~MockGPU() { CloseHandle(hFenceEvent); }
+};
+
+struct CompletionArg
+{
+	MockFence* pFence;
+	UINT64 MinFenceValue; // fence value batch must have reached.
+	UINT CallCount;
+};
+
+static void onUploadComplete(void* pArg)
+{
+	CompletionArg* pCompletion = (CompletionArg*)pArg;
+	CHECK(pCompletion->pFence->CompletedValue >= pCompletion->MinFenceValue);
+	++pCompletion->CallCount;
+}
+
+// small ring wraps many times while GPU lags several batches behind.
+static void testUploadWrap()
+{
+	MockGPU gpu;
+	const UINT64 STAGING_SIZE = 4096;
+	const UINT64 DEST_SIZE = 64 * 1024;
+
+	UploadBatch uploadBatch;
+	uploadBatch.Initialize(&gpu.Device, &gpu.Queue, &gpu.Fence, gpu.hFenceEvent, &gpu.FenceValue, STAGING_SIZE);
+	CHECK(gpu.Device.UploadBufferCount == 1);
+	const size_t BASE_RESOURCE_COUNT = s_LiveResources.size();
+
+	D3D12_RESOURCE_DESC destDesc = CD3DX12_RESOURCE_DESC::Buffer(DEST_SIZE);
+	MockResource* pDest = new MockResource(destDesc);
+	std::vector<UCHAR> expected(DEST_SIZE, 0);
+
+	TestRandom random;
+	std::vector<UCHAR> data;
+	std::vector<CompletionArg> completions(64);
+	UINT completionCount = 0;
+
+	for (int i = 0; i < 3000; ++i)
+	{
+		const UINT64 SIZE = 1 + random.NextUInt(1500);
+		const UINT64 DEST_OFFSET = random.NextUInt((UINT)(DEST_SIZE - SIZE));
+		data.resize(SIZE);
+		for (UINT64 j = 0; j < SIZE; ++j)
+		{
+			data[j] = (UCHAR)random.Next();
+		}
+
+		CHECK(SUCCEEDED(uploadBatch.UploadBuffer(pDest, DEST_OFFSET, data.data(), SIZE, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COMMON)));
+		memcpy(expected.data() + DEST_OFFSET, data.data(), SIZE);
+
+		if (random.NextUInt(8) == 0)
+		{
+			uploadBatch.Submit();
+		}
+		if (completionCount < completions.size() && random.NextUInt(40) == 0)
+		{
+			CompletionArg* pCompletion = &completions[completionCount++];
+			pCompletion->pFence = &gpu.Fence;
+			pCompletion->MinFenceValue = gpu.FenceValue + (uploadBatch.IsEmpty() ? 0 : 1);
+			pCompletion->CallCount = 0;
+			uploadBatch.AddCompletion(onUploadComplete, pCompletion);
+		}
+
+		// GPU runs one batch now and then, far slower than CPU records.
+		if (random.NextUInt(16) == 0)
+		{
+			gpu.Queue.Step();
+		}
+		if (random.NextUInt(4) == 0)
+		{
+			uploadBatch.Retire();
+		}
+	}
+
+	uploadBatch.Submit();
+	uploadBatch.WaitForIdle();
+	CHECK(gpu.Queue.Submissions.empty());
+	CHECK(pDest->Memory == expected);
+
+	const UploadStats& STATS = uploadBatch.GetStats();
+	CHECK(STATS.UploadCount == 3000);
+	CHECK(STATS.DedicatedCount == 0);
+	CHECK(STATS.StallCount > 0);
+	CHECK(STATS.SubmitCount > 100);
+	CHECK(gpu.Device.pCommandList->StagingWrapCount > 100);
+	CHECK(gpu.Device.UploadBufferCount == 1);
+	CHECK(s_LiveResources.size() == BASE_RESOURCE_COUNT + 1);
+
+	for (UINT i = 0; i < completionCount; ++i)
+	{
+		CHECK(completions[i].CallCount == 1);
+	}
+	for (UINT64 i = 0, size = gpu.Device.Allocators.size(); i < size; ++i)
+	{
+		CHECK(gpu.Device.Allocators[i]->ResetCount > 0);
+	}
+
+	uploadBatch.Cleanup();
+	CHECK(s_LiveResources.size() == BASE_RESOURCE_COUNT);
+	pDest->Release();
+	CHECK(s_LiveResources.empty());
+}
+
+// buffer larger than ring goes through dedicated upload buffer, released once its batch completes.
+static void testUploadDedicated()
+{
+	MockGPU gpu;
+	const UINT64 STAGING_SIZE = 1024;
+
+	UploadBatch uploadBatch;
+	uploadBatch.Initialize(&gpu.Device, &gpu.Queue, &gpu.Fence, gpu.hFenceEvent, &gpu.FenceValue, STAGING_SIZE);
+
+	MockResource* pDest = new MockResource(CD3DX12_RESOURCE_DESC::Buffer(8192));
+	std::vector<UCHAR> data(5000);
+	for (UINT64 i = 0, size = data.size(); i < size; ++i)
+	{
+		data[i] = (UCHAR)(i * 7);
+	}
+
+	const size_t RESOURCE_COUNT = s_LiveResources.size();
+	CHECK(SUCCEEDED(uploadBatch.UploadBuffer(pDest, 100, data.data(), data.size(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ)));
+	CHECK(SUCCEEDED(uploadBatch.UploadBuffer(pDest, 6000, data.data(), 512, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_STATE_GENERIC_READ)));
+	CHECK(s_LiveResources.size() == RESOURCE_COUNT + 1);
+
+	CompletionArg completion = { &gpu.Fence, 1, 0 };
+	uploadBatch.AddCompletion(onUploadComplete, &completion);
+	CHECK(uploadBatch.Submit() == 1);
+
+	// GPU has not run yet.
+	uploadBatch.Retire();
+	CHECK(s_LiveResources.size() == RESOURCE_COUNT + 1);
+	CHECK(completion.CallCount == 0);
+
+	gpu.Queue.Step();
+	uploadBatch.Retire();
+	CHECK(s_LiveResources.size() == RESOURCE_COUNT);
+	CHECK(completion.CallCount == 1);
+	CHECK(memcmp(pDest->Memory.data() + 100, data.data(), data.size()) == 0);
+	CHECK(memcmp(pDest->Memory.data() + 6000, data.data(), 512) == 0);
+
+	CHECK(uploadBatch.GetStats().DedicatedCount == 1);
+	CHECK(gpu.Device.UploadBufferCount == 2);
+
+	// nothing in flight, completion runs right away.
+	CompletionArg idleCompletion = { &gpu.Fence, 1, 0 };
+	uploadBatch.AddCompletion(onUploadComplete, &idleCompletion);
+	CHECK(idleCompletion.CallCount == 1);
+
+	uploadBatch.Cleanup();
+	pDest->Release();
+	CHECK(s_LiveResources.empty());
+}
+
+// mip chain through pitched staging rows, with ring wrapping between textures.
+static void testUploadTexture()
+{
+	MockGPU gpu;
+	UploadBatch uploadBatch;
+	uploadBatch.Initialize(&gpu.Device, &gpu.Queue, &gpu.Fence, gpu.hFenceEvent, &gpu.FenceValue, 64 * 1024);
+
+	TestRandom random;
+	std::vector<MockResource*> textures;
+	std::vector<std::vector<UCHAR>> images;
+	for (int i = 0; i < 24; ++i)
+	{
+		const UINT WIDTH = 1 + random.NextUInt(80);
+		const UINT HEIGHT = 1 + random.NextUInt(80);
+		MockResource* pTexture = new MockResource(CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, WIDTH, HEIGHT, 1, 3));
+		std::vector<UCHAR> image(pTexture->Memory.size());
+		for (UINT64 j = 0, size = image.size(); j < size; ++j)
+		{
+			image[j] = (UCHAR)random.Next();
+		}
+
+		CHECK(SUCCEEDED(uploadBatch.UploadTexture(pTexture, image.data(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)));
+		if (random.NextUInt(3) == 0)
+		{
+			uploadBatch.Submit();
+		}
+
+		textures.push_back(pTexture);
+		images.push_back(image);
+	}
+
+	uploadBatch.Submit();
+	uploadBatch.WaitForIdle();
+	for (UINT64 i = 0, size = textures.size(); i < size; ++i)
+	{
+		CHECK(textures[i]->Memory == images[i]);
+		textures[i]->Release();
+	}
+	CHECK(uploadBatch.GetStats().UploadCount == 24);
+	CHECK(gpu.Device.pCommandList->StagingWrapCount > 0);
+
+	uploadBatch.Cleanup();
+	CHECK(s_LiveResources.empty());
+}
+
+int main()
+{
+	testRingWrap();
+	testRingBatchQueueFull();
+	testRingFuzz();
+	testUploadWrap();
+	testUploadDedicated();
+	testUploadTexture();
+
+	return TEST_RESULT();
+}
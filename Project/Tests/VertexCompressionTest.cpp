@@ -0,0 +1,205 @@
+#include "../pch.h"
+#include "../Util/Utility.h"
+#include "../Model/VertexCompression.h"
+#include "TestCommon.h"
+
+static Vector3 randomDirection(TestRandom* pRandom)
+{
+	Vector3 v;
+	do
+	{
+		v = Vector3(pRandom->NextFloat() * 2.0f - 1.0f, pRandom->NextFloat() * 2.0f - 1.0f, pRandom->NextFloat() * 2.0f - 1.0f);
+	} while (v.LengthSquared() < 1e-4f || v.LengthSquared() > 1.0f);
+	v.Normalize();
+	return v;
+}
+
+// off origin, one long and one thin axis, so quantization has to follow bounds.
+static void makeRandomMesh(MeshInfo* pMeshInfo, const UINT VERTEX_COUNT)
+{
+	TestRandom random;
+
+	for (UINT i = 0; i < VERTEX_COUNT; ++i)
+	{
+		Vertex v;
+		v.Position = Vector3(300.0f + random.NextFloat() * 100.0f, random.NextFloat() * 4.0f - 2.0f, random.NextFloat() * 0.02f);
+		v.Normal = randomDirection(&random);
+		Vector3 tangent = v.Normal.Cross(randomDirection(&random));
+		tangent.Normalize();
+		v.Tangent = Vector4(tangent, (i & 1) ? 1.0f : -1.0f);
+		v.Texcoord = Vector2(random.NextFloat() * 8.0f - 4.0f, random.NextFloat() * 8.0f - 4.0f);
+		pMeshInfo->Vertices.push_back(v);
+
+		SkinnedVertex skinned;
+		skinned.Position = v.Position;
+		skinned.Normal = v.Normal;
+		skinned.Texcoord = v.Texcoord;
+		skinned.Tangent = v.Tangent;
+		const UINT INFLUENCE_COUNT = 1 + random.NextUInt(8);
+		for (UINT j = 0; j < INFLUENCE_COUNT; ++j)
+		{
+			skinned.BlendWeights[j] = random.NextFloat() + 0.01f; // not normalized on purpose.
+			skinned.BoneIndices[j] = (UCHAR)random.NextUInt(256);
+		}
+		pMeshInfo->SkinnedVertices.push_back(skinned);
+	}
+}
+
+static void testRoundTripBounds()
+{
+	MeshInfo mesh;
+	makeRandomMesh(&mesh, 20000);
+
+	VertexQuantization quantization;
+	ComputeVertexQuantization(mesh, &quantization);
+	CHECK(ValidateCompactVertices(mesh, quantization));
+
+	std::vector<CompactVertex> compactVertices;
+	EncodeCompactVertices(mesh.Vertices, quantization, &compactVertices);
+	CHECK(compactVertices.size() == mesh.Vertices.size());
+
+	// half a quantization step plus float rounding of offset.
+	const Vector3 MAX_POSITION_ERROR = quantization.PositionScale * (0.5f / 65535.0f) + Vector3(400.0f * 1e-6f);
+	Vector3 maxPositionError(0.0f);
+	float minNormalDot = 1.0f;
+	float minTangentDot = 1.0f;
+	float maxTexcoordError = 0.0f;
+	UINT handednessErrorCount = 0;
+
+	for (UINT64 i = 0, size = mesh.Vertices.size(); i < size; ++i)
+	{
+		const Vertex& SRC = mesh.Vertices[i];
+		Vertex decoded;
+		DecodeCompactVertex(compactVertices[i], quantization, &decoded);
+
+		Vector3 error = decoded.Position - SRC.Position;
+		maxPositionError = Vector3::Max(maxPositionError, Vector3(fabsf(error.x), fabsf(error.y), fabsf(error.z)));
+		minNormalDot = Min(minNormalDot, decoded.Normal.Dot(SRC.Normal));
+		minTangentDot = Min(minTangentDot, Vector3(decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z).Dot(Vector3(SRC.Tangent.x, SRC.Tangent.y, SRC.Tangent.z)));
+		maxTexcoordError = Max(maxTexcoordError, Max(fabsf(decoded.Texcoord.x - SRC.Texcoord.x), fabsf(decoded.Texcoord.y - SRC.Texcoord.y)));
+		if (decoded.Tangent.w != SRC.Tangent.w)
+		{
+			++handednessErrorCount;
+		}
+	}
+
+	printf("position error(%g, %g, %g), normal dot %f, tangent dot %f, uv error %g\n", maxPositionError.x, maxPositionError.y, maxPositionError.z, minNormalDot, minTangentDot, maxTexcoordError);
+	CHECK(maxPositionError.x <= MAX_POSITION_ERROR.x && maxPositionError.y <= MAX_POSITION_ERROR.y && maxPositionError.z <= MAX_POSITION_ERROR.z);
+	CHECK(minNormalDot >= 0.99999f);
+	CHECK(minTangentDot >= 0.99999f);
+	CHECK(maxTexcoordError <= 4.0f / 1024.0f); // half has 10 bit mantissa. |uv| < 4.
+	CHECK(handednessErrorCount == 0);
+
+	printf("%u bytes -> %u bytes per vertex\n", (UINT)sizeof(Vertex), (UINT)sizeof(CompactVertex));
+	CHECK(sizeof(CompactVertex) == 20);
+	CHECK(sizeof(CompactSkinnedVertex) == 36);
+}
+
+static void testSkinWeights()
+{
+	MeshInfo mesh;
+	makeRandomMesh(&mesh, 5000);
+
+	VertexQuantization quantization;
+	ComputeVertexQuantization(mesh, &quantization);
+
+	std::vector<CompactSkinnedVertex> compactVertices;
+	EncodeCompactSkinnedVertices(mesh.SkinnedVertices, quantization, &compactVertices);
+
+	UINT badSumCount = 0;
+	UINT badIndexCount = 0;
+	float maxWeightError = 0.0f;
+	for (UINT64 i = 0, size = mesh.SkinnedVertices.size(); i < size; ++i)
+	{
+		const SkinnedVertex& SRC = mesh.SkinnedVertices[i];
+		const CompactSkinnedVertex& COMPACT = compactVertices[i];
+
+		float srcSum = 0.0f;
+		UINT quantizedSum = 0;
+		for (int j = 0; j < 8; ++j)
+		{
+			srcSum += SRC.BlendWeights[j];
+			quantizedSum += COMPACT.BlendWeights[j];
+		}
+		if (quantizedSum != 255)
+		{
+			++badSumCount;
+		}
+
+		SkinnedVertex decoded;
+		DecodeCompactSkinnedVertex(COMPACT, quantization, &decoded);
+		for (int j = 0; j < 8; ++j)
+		{
+			maxWeightError = Max(maxWeightError, fabsf(decoded.BlendWeights[j] - SRC.BlendWeights[j] / srcSum));
+			if (decoded.BoneIndices[j] != SRC.BoneIndices[j])
+			{
+				++badIndexCount;
+			}
+		}
+	}
+
+	printf("weight error %f\n", maxWeightError);
+	CHECK(badSumCount == 0);
+	CHECK(badIndexCount == 0);
+	CHECK(maxWeightError <= 5.0f / 255.0f);
+}
+
+static void testAxisDirectionsAndFlatMesh()
+{
+	// octahedral fold edges and poles.
+	const Vector3 DIRECTIONS[] =
+	{
+		Vector3(1.0f, 0.0f, 0.0f), Vector3(-1.0f, 0.0f, 0.0f),
+		Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, -1.0f, 0.0f),
+		Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 0.0f, -1.0f),
+		Vector3(0.7071068f, 0.0f, -0.7071068f), Vector3(0.0f, -0.7071068f, -0.7071068f),
+	};
+
+	// all on z = 5. flat axis keeps scale 1 and decodes exactly.
+	MeshInfo mesh;
+	for (UINT i = 0; i < sizeof(DIRECTIONS) / sizeof(DIRECTIONS[0]); ++i)
+	{
+		Vertex v;
+		v.Position = Vector3((float)i, (float)(i % 3), 5.0f);
+		v.Normal = DIRECTIONS[i];
+		v.Tangent = Vector4(DIRECTIONS[(i + 2) % 8], -1.0f);
+		mesh.Vertices.push_back(v);
+	}
+
+	VertexQuantization quantization;
+	ComputeVertexQuantization(mesh, &quantization);
+	CHECK(quantization.PositionScale.z == 1.0f);
+	CHECK(ValidateCompactVertices(mesh, quantization));
+
+	std::vector<CompactVertex> compactVertices;
+	EncodeCompactVertices(mesh.Vertices, quantization, &compactVertices);
+	for (UINT64 i = 0, size = mesh.Vertices.size(); i < size; ++i)
+	{
+		Vertex decoded;
+		DecodeCompactVertex(compactVertices[i], quantization, &decoded);
+		CHECK(decoded.Position.z == 5.0f);
+		CHECK(decoded.Normal.Dot(mesh.Vertices[i].Normal) >= 0.99999f);
+	}
+}
+
+static void testValidateRejects()
+{
+	MeshInfo mesh;
+	makeRandomMesh(&mesh, 100);
+
+	// bounds smaller than mesh clamp positions.
+	VertexQuantization quantization;
+	ComputeVertexQuantization(mesh, &quantization);
+	quantization.PositionScale = quantization.PositionScale * 0.5f;
+	CHECK(!ValidateCompactVertices(mesh, quantization));
+}
+
+int main()
+{
+	testRoundTripBounds();
+	testSkinWeights();
+	testAxisDirectionsAndFlatMesh();
+	testValidateRejects();
+
+	return TEST_RESULT();
+}
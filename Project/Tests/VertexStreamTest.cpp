@@ -0,0 +1,144 @@
+#include "../pch.h"
+#include <stddef.h>
+#include "../Util/Utility.h"
+#include "../Model/VertexCompression.h"
+#include "../Model/VertexStream.h"
+#include "TestCommon.h"
+
+// element offsets of depth only input layouts in ResourceManager::initShaders().
+static void testLayout()
+{
+	CHECK(sizeof(DepthOnlyVertex) == 12);
+	CHECK(offsetof(DepthOnlyVertex, Position) == 0);
+
+	CHECK(sizeof(DepthOnlySkinnedVertex) == 52);
+	CHECK(offsetof(DepthOnlySkinnedVertex, Position) == 0);
+	CHECK(offsetof(DepthOnlySkinnedVertex, BlendWeights) == 12);     // BLENDWEIGHT0
+	CHECK(offsetof(DepthOnlySkinnedVertex, BlendWeights) + 16 == 28); // BLENDWEIGHT1
+	CHECK(offsetof(DepthOnlySkinnedVertex, BoneIndices) == 44);      // BLENDINDICES0
+	CHECK(offsetof(DepthOnlySkinnedVertex, BoneIndices) + 4 == 48);  // BLENDINDICES1
+
+	CHECK(sizeof(CompactDepthOnlyVertex) == 8);
+	CHECK(sizeof(CompactDepthOnlySkinnedVertex) == 24);
+	CHECK(offsetof(CompactDepthOnlySkinnedVertex, BlendWeights) == 8);
+	CHECK(offsetof(CompactDepthOnlySkinnedVertex, BoneIndices) == 16);
+
+	// depth only streams are what depth passes save in fetch.
+	printf("stride %u -> %u, skinned %u -> %u, compact %u -> %u, compact skinned %u -> %u bytes\n",
+		   (UINT)sizeof(Vertex), (UINT)sizeof(DepthOnlyVertex), (UINT)sizeof(SkinnedVertex), (UINT)sizeof(DepthOnlySkinnedVertex),
+		   (UINT)sizeof(CompactVertex), (UINT)sizeof(CompactDepthOnlyVertex), (UINT)sizeof(CompactSkinnedVertex), (UINT)sizeof(CompactDepthOnlySkinnedVertex));
+}
+
+static void makeRandomVertices(const UINT VERTEX_COUNT, std::vector<Vertex>* pVertices, std::vector<SkinnedVertex>* pSkinnedVertices)
+{
+	TestRandom random;
+
+	for (UINT i = 0; i < VERTEX_COUNT; ++i)
+	{
+		SkinnedVertex skinned;
+		skinned.Position = Vector3(random.NextFloat() * 10.0f - 5.0f, random.NextFloat() * 2.0f, random.NextFloat() * 10.0f - 5.0f);
+		skinned.Normal = Vector3(0.0f, 1.0f, 0.0f);
+		skinned.Texcoord = Vector2(random.NextFloat(), random.NextFloat());
+		skinned.Tangent = Vector4(1.0f, 0.0f, 0.0f, 1.0f);
+
+		float weightSum = 0.0f;
+		for (int j = 0; j < 8; ++j)
+		{
+			skinned.BlendWeights[j] = random.NextFloat();
+			skinned.BoneIndices[j] = (UCHAR)random.NextUInt(256);
+			weightSum += skinned.BlendWeights[j];
+		}
+		for (int j = 0; j < 8; ++j)
+		{
+			skinned.BlendWeights[j] /= weightSum;
+		}
+		pSkinnedVertices->push_back(skinned);
+
+		Vertex v;
+		v.Position = skinned.Position;
+		v.Normal = skinned.Normal;
+		v.Texcoord = skinned.Texcoord;
+		v.Tangent = skinned.Tangent;
+		pVertices->push_back(v);
+	}
+}
+
+static void testContent()
+{
+	std::vector<Vertex> vertices;
+	std::vector<SkinnedVertex> skinnedVertices;
+	makeRandomVertices(1000, &vertices, &skinnedVertices);
+
+	std::vector<DepthOnlyVertex> depthOnlyVertices;
+	BuildDepthOnlyVertices(vertices, &depthOnlyVertices);
+	CHECK(depthOnlyVertices.size() == vertices.size());
+
+	std::vector<DepthOnlySkinnedVertex> depthOnlySkinnedVertices;
+	BuildDepthOnlySkinnedVertices(skinnedVertices, &depthOnlySkinnedVertices);
+	CHECK(depthOnlySkinnedVertices.size() == skinnedVertices.size());
+
+	UINT mismatchCount = 0;
+	for (UINT64 i = 0, size = vertices.size(); i < size; ++i)
+	{
+		const SkinnedVertex& SKINNED = skinnedVertices[i];
+		const DepthOnlySkinnedVertex& DEPTH_ONLY_SKINNED = depthOnlySkinnedVertices[i];
+
+		// bit exact, so depth prepass and main pass rasterize same positions.
+		if (memcmp(&depthOnlyVertices[i].Position, &vertices[i].Position, sizeof(Vector3)) != 0 ||
+			memcmp(&DEPTH_ONLY_SKINNED.Position, &SKINNED.Position, sizeof(Vector3)) != 0 ||
+			memcmp(DEPTH_ONLY_SKINNED.BlendWeights, SKINNED.BlendWeights, sizeof(SKINNED.BlendWeights)) != 0 ||
+			memcmp(DEPTH_ONLY_SKINNED.BoneIndices, SKINNED.BoneIndices, sizeof(SKINNED.BoneIndices)) != 0)
+		{
+			++mismatchCount;
+		}
+	}
+	CHECK(mismatchCount == 0);
+
+	// empty input clears output.
+	BuildDepthOnlyVertices(std::vector<Vertex>(), &depthOnlyVertices);
+	CHECK(depthOnlyVertices.empty());
+}
+
+static void testCompactContent()
+{
+	MeshInfo mesh;
+	makeRandomVertices(1000, &mesh.Vertices, &mesh.SkinnedVertices);
+
+	VertexQuantization quantization;
+	ComputeVertexQuantization(mesh, &quantization);
+
+	std::vector<CompactVertex> compactVertices;
+	std::vector<CompactSkinnedVertex> compactSkinnedVertices;
+	EncodeCompactVertices(mesh.Vertices, quantization, &compactVertices);
+	EncodeCompactSkinnedVertices(mesh.SkinnedVertices, quantization, &compactSkinnedVertices);
+
+	std::vector<CompactDepthOnlyVertex> depthOnlyVertices;
+	std::vector<CompactDepthOnlySkinnedVertex> depthOnlySkinnedVertices;
+	BuildCompactDepthOnlyVertices(compactVertices, &depthOnlyVertices);
+	BuildCompactDepthOnlySkinnedVertices(compactSkinnedVertices, &depthOnlySkinnedVertices);
+	CHECK(depthOnlyVertices.size() == compactVertices.size());
+	CHECK(depthOnlySkinnedVertices.size() == compactSkinnedVertices.size());
+
+	// already quantized data is copied, not encoded again.
+	UINT mismatchCount = 0;
+	for (UINT64 i = 0, size = compactVertices.size(); i < size; ++i)
+	{
+		if (memcmp(depthOnlyVertices[i].Position, compactVertices[i].Position, sizeof(compactVertices[i].Position)) != 0 ||
+			memcmp(depthOnlySkinnedVertices[i].Position, compactSkinnedVertices[i].Position, sizeof(compactSkinnedVertices[i].Position)) != 0 ||
+			memcmp(depthOnlySkinnedVertices[i].BlendWeights, compactSkinnedVertices[i].BlendWeights, sizeof(compactSkinnedVertices[i].BlendWeights)) != 0 ||
+			memcmp(depthOnlySkinnedVertices[i].BoneIndices, compactSkinnedVertices[i].BoneIndices, sizeof(compactSkinnedVertices[i].BoneIndices)) != 0)
+		{
+			++mismatchCount;
+		}
+	}
+	CHECK(mismatchCount == 0);
+}
+
+int main()
+{
+	testLayout();
+	testContent();
+	testCompactContent();
+
+	return TEST_RESULT();
+}
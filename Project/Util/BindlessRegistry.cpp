@@ -0,0 +1,114 @@
+#include "../pch.h"
+#include "BindlessRegistry.h"
+
+void BindlessRegistry::Initialize(const UINT CAPACITY, const UINT RESERVED_COUNT)
+{
+	_ASSERT(CAPACITY > RESERVED_COUNT && CAPACITY < 0xffff);
+
+	Cleanup();
+
+	m_Capacity = CAPACITY;
+	m_ReservedCount = RESERVED_COUNT;
+	m_IndexCreator.Initialize(m_Capacity - m_ReservedCount);
+	m_EntryMap.reserve(m_Capacity);
+}
+
+UINT BindlessRegistry::Register(const UINT64 KEY, bool* pbOutNew)
+{
+	_ASSERT(pbOutNew);
+	_ASSERT(m_Capacity > 0);
+
+	*pbOutNew = false;
+
+	std::unordered_map<UINT64, Entry>::iterator iter = m_EntryMap.find(KEY);
+	if (iter != m_EntryMap.end())
+	{
+		++(iter->second.RefCount);
+		return iter->second.Index;
+	}
+
+	ULONG index = m_IndexCreator.Alloc();
+	if (index == 0xffff)
+	{
+		++m_Stats.FailCount;
+		return BINDLESS_INVALID_INDEX;
+	}
+
+	Entry newEntry;
+	newEntry.Index = (UINT)index + m_ReservedCount;
+	newEntry.RefCount = 1;
+	m_EntryMap[KEY] = newEntry;
+
+	++m_Stats.RegisteredCount;
+	if (m_Stats.RegisteredCount > m_Stats.PeakCount)
+	{
+		m_Stats.PeakCount = m_Stats.RegisteredCount;
+	}
+	*pbOutNew = true;
+
+	return newEntry.Index;
+}
+
+void BindlessRegistry::Release(const UINT64 KEY)
+{
+	std::unordered_map<UINT64, Entry>::iterator iter = m_EntryMap.find(KEY);
+	if (iter == m_EntryMap.end())
+	{
+		// released more than registered.
+		__debugbreak();
+		return;
+	}
+
+	--(iter->second.RefCount);
+	if (iter->second.RefCount > 0)
+	{
+		return;
+	}
+
+	m_PendingFrees.push_back(iter->second.Index);
+	m_EntryMap.erase(iter);
+
+	--m_Stats.RegisteredCount;
+	m_Stats.PendingFreeCount = (UINT)m_PendingFrees.size();
+}
+
+UINT BindlessRegistry::Find(const UINT64 KEY)
+{
+	std::unordered_map<UINT64, Entry>::iterator iter = m_EntryMap.find(KEY);
+	if (iter == m_EntryMap.end())
+	{
+		return BINDLESS_INVALID_INDEX;
+	}
+	return iter->second.Index;
+}
+
+void BindlessRegistry::BeginFrame()
+{
+	for (UINT64 i = 0, size = m_PendingFrees.size(); i < size; ++i)
+	{
+		m_IndexCreator.Free(m_PendingFrees[i] - m_ReservedCount);
+	}
+	m_PendingFrees.clear();
+	m_Stats.PendingFreeCount = 0;
+}
+
+void BindlessRegistry::Cleanup()
+{
+#ifdef _DEBUG
+	if (m_Stats.RegisteredCount > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "BindlessRegistry: %u keys are not released.\n", m_Stats.RegisteredCount);
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	// slots still held are dropped with index table.
+	m_IndexCreator.Clear();
+	m_EntryMap.clear();
+	m_PendingFrees.clear();
+
+	m_Capacity = 0;
+	m_ReservedCount = 0;
+	m_Stats = {};
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <unordered_map>
+#include "IndexCreator.h"
+
+static const UINT BINDLESS_INVALID_INDEX = 0xffffffff;
+
+struct BindlessRegistryStats
+{
+	UINT RegisteredCount; // keys holding slot.
+	UINT PeakCount;
+	UINT PendingFreeCount; // released slots waiting for BeginFrame().
+	UINT FailCount; // Register() calls that found no free slot.
+};
+
+// Assigns stable slots of one bindless descriptor range to resource keys, with reference count per key.
+// Key is any value unique to the view, e.g. its CPU descriptor handle. knows nothing of D3D.
+// Slots below reserved count are never handed out, caller fills them with defaults such as null view.
+// Released slot is reused only after next BeginFrame(), so GPU work recorded before release still reads it.
+// Not thread safe.
+class BindlessRegistry
+{
+public:
+	BindlessRegistry() = default;
+	~BindlessRegistry() { Cleanup(); }
+
+	// IndexCreator tells failure by 0xffff, so CAPACITY stays below it.
+	void Initialize(const UINT CAPACITY, const UINT RESERVED_COUNT);
+
+	// slot of KEY. *pbOutNew is true when slot was just assigned and caller has to write its descriptor.
+	// BINDLESS_INVALID_INDEX when every slot is taken.
+	UINT Register(const UINT64 KEY, bool* pbOutNew);
+	// drops one reference. slot is freed with last one.
+	void Release(const UINT64 KEY);
+	// BINDLESS_INVALID_INDEX when KEY is not registered.
+	UINT Find(const UINT64 KEY);
+
+	// caller calls it once GPU is done with every frame recorded before.
+	void BeginFrame();
+
+	void Cleanup();
+
+	inline UINT GetCapacity() { return m_Capacity; }
+	inline const BindlessRegistryStats& GetStats() { return m_Stats; }
+
+private:
+	struct Entry
+	{
+		UINT Index;
+		UINT RefCount;
+	};
+
+	IndexCreator m_IndexCreator; // slot - reserved count.
+	std::unordered_map<UINT64, Entry> m_EntryMap;
+	std::vector<UINT> m_PendingFrees;
+
+	UINT m_Capacity = 0;
+	UINT m_ReservedCount = 0;
+
+	BindlessRegistryStats m_Stats = {};
+};
@@ -0,0 +1,204 @@
+#include "../pch.h"
+#include "DescriptorAllocator.h"
+
+void DescriptorAllocator::Initialize(const UINT DESCRIPTOR_COUNT, const UINT PAGE_SIZE)
+{
+	_ASSERT(PAGE_SIZE > 0 && (PAGE_SIZE & (PAGE_SIZE - 1)) == 0);
+
+	Cleanup();
+
+	m_PageSize = PAGE_SIZE;
+	m_PageCount = DESCRIPTOR_COUNT / PAGE_SIZE;
+	// IndexCreator tells failure by 0xffff.
+	_ASSERT(m_PageCount > 0 && m_PageCount < 0xffff);
+
+	m_PageIndexCreator.Initialize(m_PageCount);
+	m_Pages.resize(m_PageCount, Page{ 0, 0 });
+	m_FreeLists.resize(getSizeClass(m_PageSize) + 1);
+	m_KeptPages.resize(m_FreeLists.size(), DESCRIPTOR_ALLOCATOR_INVALID_OFFSET);
+}
+
+UINT DescriptorAllocator::Alloc(const UINT COUNT)
+{
+	_ASSERT(m_PageSize > 0);
+	_ASSERT(COUNT > 0);
+
+	if (COUNT > m_PageSize)
+	{
+		++m_Stats.FailCount;
+		return DESCRIPTOR_ALLOCATOR_INVALID_OFFSET;
+	}
+
+	const UINT SIZE_CLASS = getSizeClass(COUNT);
+	std::vector<UINT>& freeList = m_FreeLists[SIZE_CLASS];
+	if (freeList.empty() && !addPage(SIZE_CLASS))
+	{
+		// empty pages kept by other classes go first.
+		if (!releaseKeptPages() || !addPage(SIZE_CLASS))
+		{
+			++m_Stats.FailCount;
+			return DESCRIPTOR_ALLOCATOR_INVALID_OFFSET;
+		}
+	}
+
+	const UINT OFFSET = freeList.back();
+	const UINT PAGE_INDEX = OFFSET / m_PageSize;
+	freeList.pop_back();
+	++(m_Pages[PAGE_INDEX].UsedBlockCount);
+	if (m_KeptPages[SIZE_CLASS] == PAGE_INDEX)
+	{
+		m_KeptPages[SIZE_CLASS] = DESCRIPTOR_ALLOCATOR_INVALID_OFFSET;
+	}
+
+	m_Stats.AllocatedCount += (1 << SIZE_CLASS);
+	if (m_Stats.AllocatedCount > m_Stats.PeakCount)
+	{
+		m_Stats.PeakCount = m_Stats.AllocatedCount;
+	}
+	if (m_Stats.AllocatedCount > m_Stats.FrameHighWater)
+	{
+		m_Stats.FrameHighWater = m_Stats.AllocatedCount;
+	}
+
+	return OFFSET;
+}
+
+void DescriptorAllocator::Free(const UINT OFFSET)
+{
+	const UINT PAGE_INDEX = OFFSET / m_PageSize;
+	_ASSERT(PAGE_INDEX < m_PageCount);
+
+	Page* pPage = &m_Pages[PAGE_INDEX];
+	if (pPage->UsedBlockCount == 0)
+	{
+		// freed more than allocated.
+		__debugbreak();
+		return;
+	}
+	_ASSERT(OFFSET % (1 << pPage->SizeClass) == 0);
+
+	m_FreeLists[pPage->SizeClass].push_back(OFFSET);
+	--(pPage->UsedBlockCount);
+	m_Stats.AllocatedCount -= (1 << pPage->SizeClass);
+
+	if (pPage->UsedBlockCount == 0)
+	{
+		UINT* pKeptPage = &m_KeptPages[pPage->SizeClass];
+		if (*pKeptPage == DESCRIPTOR_ALLOCATOR_INVALID_OFFSET)
+		{
+			*pKeptPage = PAGE_INDEX;
+		}
+		else
+		{
+			releasePage(PAGE_INDEX);
+		}
+	}
+}
+
+void DescriptorAllocator::BeginFrame()
+{
+	m_Stats.LastFrameHighWater = m_Stats.FrameHighWater;
+	m_Stats.FrameHighWater = m_Stats.AllocatedCount;
+}
+
+void DescriptorAllocator::Cleanup()
+{
+#ifdef _DEBUG
+	if (m_Stats.AllocatedCount > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "DescriptorAllocator: %u descriptors are not freed.\n", m_Stats.AllocatedCount);
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	// pages still taken are dropped with index table.
+	m_PageIndexCreator.Clear();
+	m_Pages.clear();
+	m_FreeLists.clear();
+	m_KeptPages.clear();
+
+	m_PageSize = 0;
+	m_PageCount = 0;
+	m_Stats = {};
+}
+
+UINT DescriptorAllocator::GetBlockSize(const UINT COUNT)
+{
+	return (1 << getSizeClass(COUNT));
+}
+
+UINT DescriptorAllocator::getSizeClass(const UINT COUNT)
+{
+	_ASSERT(COUNT > 0);
+
+	// smallest power of 2 not below COUNT.
+	UINT sizeClass = 0;
+	while ((1u << sizeClass) < COUNT)
+	{
+		++sizeClass;
+	}
+	return sizeClass;
+}
+
+bool DescriptorAllocator::addPage(const UINT SIZE_CLASS)
+{
+	const ULONG PAGE_INDEX = m_PageIndexCreator.Alloc();
+	if (PAGE_INDEX == 0xffff)
+	{
+		return false;
+	}
+
+	Page* pPage = &m_Pages[PAGE_INDEX];
+	pPage->SizeClass = SIZE_CLASS;
+	pPage->UsedBlockCount = 0;
+
+	// pushed back to front, so blocks are handed out in address order.
+	const UINT BLOCK_SIZE = (1 << SIZE_CLASS);
+	const UINT PAGE_START = (UINT)PAGE_INDEX * m_PageSize;
+	std::vector<UINT>& freeList = m_FreeLists[SIZE_CLASS];
+	for (UINT offset = m_PageSize; offset > 0; offset -= BLOCK_SIZE)
+	{
+		freeList.push_back(PAGE_START + offset - BLOCK_SIZE);
+	}
+
+	++m_Stats.PageCount;
+	return true;
+}
+
+void DescriptorAllocator::releasePage(const UINT PAGE_INDEX)
+{
+	const UINT PAGE_START = PAGE_INDEX * m_PageSize;
+	const UINT PAGE_END = PAGE_START + m_PageSize;
+	std::vector<UINT>& freeList = m_FreeLists[m_Pages[PAGE_INDEX].SizeClass];
+
+	// every block of page is in list now. pages are released rarely, linear scan is fine.
+	UINT64 keepCount = 0;
+	for (UINT64 i = 0, size = freeList.size(); i < size; ++i)
+	{
+		if (freeList[i] < PAGE_START || freeList[i] >= PAGE_END)
+		{
+			freeList[keepCount] = freeList[i];
+			++keepCount;
+		}
+	}
+	freeList.resize(keepCount);
+
+	m_PageIndexCreator.Free(PAGE_INDEX);
+	--m_Stats.PageCount;
+}
+
+bool DescriptorAllocator::releaseKeptPages()
+{
+	bool bReleased = false;
+	for (UINT64 i = 0, size = m_KeptPages.size(); i < size; ++i)
+	{
+		if (m_KeptPages[i] != DESCRIPTOR_ALLOCATOR_INVALID_OFFSET)
+		{
+			releasePage(m_KeptPages[i]);
+			m_KeptPages[i] = DESCRIPTOR_ALLOCATOR_INVALID_OFFSET;
+			bReleased = true;
+		}
+	}
+	return bReleased;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "IndexCreator.h"
+
+static const UINT DESCRIPTOR_ALLOCATOR_INVALID_OFFSET = 0xffffffff;
+
+struct DescriptorAllocatorStats
+{
+	UINT AllocatedCount; // descriptors in live blocks, block sizes not requested counts.
+	UINT PeakCount;
+	UINT PageCount; // pages split into blocks of some size class, kept empty ones included.
+	UINT FailCount;
+	UINT FrameHighWater; // most descriptors alive at once since BeginFrame().
+	UINT LastFrameHighWater;
+};
+
+// Size class free lists over descriptor offsets of one range, for descriptors that live across frames.
+// Range is split into pages handed out by IndexCreator. page serves one size class, power of 2 up to page size,
+// and is split into blocks of it. freed block goes back to free list of its class. each class keeps one empty page,
+// so alloc and free around page boundary do not split and scan page every time. other empty pages go back to
+// IndexCreator with their last block, kept ones too once some class finds no page.
+// knows nothing of D3D, caller maps offsets onto its heap.
+// Not thread safe.
+class DescriptorAllocator
+{
+public:
+	DescriptorAllocator() = default;
+	~DescriptorAllocator() { Cleanup(); }
+
+	// PAGE_SIZE is power of 2. descriptors after last whole page are not used.
+	void Initialize(const UINT DESCRIPTOR_COUNT, const UINT PAGE_SIZE);
+
+	// offset of block holding COUNT descriptors. DESCRIPTOR_ALLOCATOR_INVALID_OFFSET when COUNT is larger
+	// than page or every page is taken.
+	UINT Alloc(const UINT COUNT);
+	void Free(const UINT OFFSET);
+
+	void BeginFrame();
+
+	void Cleanup();
+
+	// size of block Alloc(COUNT) returns.
+	UINT GetBlockSize(const UINT COUNT);
+
+	inline UINT GetPageSize() { return m_PageSize; }
+	inline const DescriptorAllocatorStats& GetStats() { return m_Stats; }
+
+protected:
+	UINT getSizeClass(const UINT COUNT);
+	bool addPage(const UINT SIZE_CLASS);
+	void releasePage(const UINT PAGE_INDEX);
+	// false when no class keeps empty page.
+	bool releaseKeptPages();
+
+private:
+	struct Page
+	{
+		UINT SizeClass;
+		UINT UsedBlockCount; // 0 when page is free or kept empty.
+	};
+
+	IndexCreator m_PageIndexCreator;
+	std::vector<Page> m_Pages;
+	std::vector<std::vector<UINT>> m_FreeLists; // block offsets per size class.
+	std::vector<UINT> m_KeptPages; // empty page per size class. DESCRIPTOR_ALLOCATOR_INVALID_OFFSET when none.
+
+	UINT m_PageSize = 0;
+	UINT m_PageCount = 0;
+
+	DescriptorAllocatorStats m_Stats = {};
+};
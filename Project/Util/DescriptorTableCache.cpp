@@ -0,0 +1,117 @@
+#include "../pch.h"
+#include "Utility.h"
+#include "DescriptorTableCache.h"
+
+void DescriptorTableCache::Initialize(const UINT SLOT_COUNT)
+{
+	_ASSERT(SLOT_COUNT > 0);
+
+	m_Slots.clear();
+	m_Slots.resize(SLOT_COUNT, Slot{});
+	m_SlotMap.clear();
+	m_SlotMap.reserve(SLOT_COUNT);
+	m_Frame = 1;
+	m_Stats = {};
+}
+
+bool DescriptorTableCache::Lookup(const UINT64* pHANDLES, const UINT COUNT, UINT* pOutSlot)
+{
+	_ASSERT(pHANDLES);
+	_ASSERT(pOutSlot);
+	_ASSERT(COUNT > 0 && COUNT <= DESCRIPTOR_TABLE_CACHE_SLOT_SIZE);
+
+	const UINT64 HASH = HashBytes(pHANDLES, sizeof(UINT64) * COUNT);
+
+	std::unordered_map<UINT64, UINT>::iterator iter = m_SlotMap.find(HASH);
+	if (iter != m_SlotMap.end())
+	{
+		Slot* pSlot = &m_Slots[iter->second];
+		if (pSlot->Count == COUNT && memcmp(pSlot->pHandles, pHANDLES, sizeof(UINT64) * COUNT) == 0)
+		{
+			pSlot->LastUsedFrame = m_Frame;
+			*pOutSlot = iter->second;
+			++m_Stats.HitCount;
+			return true;
+		}
+
+		// hash collision. other list keeps the slot.
+		*pOutSlot = UINT_MAX;
+		++m_Stats.MissCount;
+		return false;
+	}
+
+	++m_Stats.MissCount;
+
+	const UINT SLOT_INDEX = findReplaceableSlot();
+	*pOutSlot = SLOT_INDEX;
+	if (SLOT_INDEX == UINT_MAX)
+	{
+		return false;
+	}
+
+	Slot* pSlot = &m_Slots[SLOT_INDEX];
+	if (pSlot->Count > 0)
+	{
+		m_SlotMap.erase(pSlot->Hash);
+		--m_Stats.EntryCount;
+		++m_Stats.EvictCount;
+	}
+
+	pSlot->Hash = HASH;
+	memcpy(pSlot->pHandles, pHANDLES, sizeof(UINT64) * COUNT);
+	pSlot->Count = COUNT;
+	pSlot->LastUsedFrame = m_Frame;
+	m_SlotMap[HASH] = SLOT_INDEX;
+	++m_Stats.EntryCount;
+
+	return false;
+}
+
+void DescriptorTableCache::BeginFrame()
+{
+	++m_Frame;
+
+	m_Stats.LastFrameHitCount = m_Stats.HitCount;
+	m_Stats.LastFrameMissCount = m_Stats.MissCount;
+	m_Stats.HitCount = 0;
+	m_Stats.MissCount = 0;
+	m_Stats.EvictCount = 0;
+}
+
+void DescriptorTableCache::Invalidate()
+{
+	for (UINT i = 0, size = (UINT)m_Slots.size(); i < size; ++i)
+	{
+		// LastUsedFrame is kept, GPU may still read tables of this frame.
+		m_Slots[i].Count = 0;
+	}
+	m_SlotMap.clear();
+	m_Stats.EntryCount = 0;
+}
+
+UINT DescriptorTableCache::findReplaceableSlot()
+{
+	UINT result = UINT_MAX;
+	UINT64 oldestFrame = m_Frame;
+
+	for (UINT i = 0, size = (UINT)m_Slots.size(); i < size; ++i)
+	{
+		const Slot& SLOT = m_Slots[i];
+		if (SLOT.LastUsedFrame >= m_Frame)
+		{
+			// GPU may read it in this frame.
+			continue;
+		}
+		if (SLOT.Count == 0)
+		{
+			return i;
+		}
+		if (SLOT.LastUsedFrame < oldestFrame)
+		{
+			result = i;
+			oldestFrame = SLOT.LastUsedFrame;
+		}
+	}
+
+	return result;
+}
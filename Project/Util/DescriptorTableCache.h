@@ -0,0 +1,56 @@
+#pragma once
+
+#include <unordered_map>
+
+static const UINT DESCRIPTOR_TABLE_CACHE_SLOT_SIZE = 8; // most source handles per cached table.
+
+struct DescriptorTableCacheStats
+{
+	UINT EntryCount;
+	UINT HitCount; // since BeginFrame().
+	UINT MissCount; // since BeginFrame(). includes lookups that found no slot.
+	UINT EvictCount; // since BeginFrame().
+	UINT LastFrameHitCount;
+	UINT LastFrameMissCount;
+};
+
+// Maps list of source descriptor handles to slot of fixed region, keyed by hash of the handles.
+// Handles are plain values here, it knows nothing of D3D. caller copies descriptors into slot on miss.
+// Slot used since last BeginFrame() is never replaced, older ones are replaced least recently used first.
+// So caller calls BeginFrame() only once GPU is done with tables of the frames before.
+// Not thread safe.
+class DescriptorTableCache
+{
+public:
+	DescriptorTableCache() = default;
+	~DescriptorTableCache() = default;
+
+	void Initialize(const UINT SLOT_COUNT);
+
+	// true on hit. on miss *pOutSlot is slot to fill, or UINT_MAX when every slot is used in this frame.
+	bool Lookup(const UINT64* pHANDLES, const UINT COUNT, UINT* pOutSlot);
+
+	void BeginFrame();
+	// forgets every entry, for when source descriptors are rewritten. slots of this frame stay in use.
+	void Invalidate();
+
+	inline UINT GetSlotCount() { return (UINT)m_Slots.size(); }
+	inline const DescriptorTableCacheStats& GetStats() { return m_Stats; }
+
+private:
+	struct Slot
+	{
+		UINT64 Hash;
+		UINT64 pHandles[DESCRIPTOR_TABLE_CACHE_SLOT_SIZE];
+		UINT Count; // 0 when empty.
+		UINT64 LastUsedFrame;
+	};
+
+	UINT findReplaceableSlot();
+
+	std::vector<Slot> m_Slots;
+	std::unordered_map<UINT64, UINT> m_SlotMap; // hash -> slot index.
+	UINT64 m_Frame = 1; // slots start at 0, so all of them are replaceable.
+
+	DescriptorTableCacheStats m_Stats = {};
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+// Links of T in IntrusiveList. T holds one per list it can be in at the same time.
+template <typename T>
+struct ListLink
+{
+	T* pPrev = nullptr;
+	T* pNext = nullptr;
+};
+
+// Doubly linked list threaded through LINK member of T. linking never allocates and items come out typed.
+// list does not own items.
+// Not thread safe.
+template <typename T, ListLink<T> T::* LINK>
+class IntrusiveList
+{
+public:
+	IntrusiveList() = default;
+	~IntrusiveList() = default;
+
+	void PushFront(T* pItem);
+	void PushBack(T* pItem);
+	// pItem must be in this list.
+	void Remove(T* pItem);
+	// nullptr when empty.
+	T* PopFront();
+
+	// forgets items without touching their links.
+	void Clear();
+
+	inline T* GetHead() { return m_pHead; }
+	inline T* GetTail() { return m_pTail; }
+	inline static T* GetNext(T* pItem) { return (pItem->*LINK).pNext; }
+	inline static T* GetPrev(T* pItem) { return (pItem->*LINK).pPrev; }
+	inline UINT GetCount() { return m_Count; }
+	inline bool IsEmpty() { return (m_pHead == nullptr); }
+
+private:
+	T* m_pHead = nullptr;
+	T* m_pTail = nullptr;
+	UINT m_Count = 0;
+};
+
+template <typename T, ListLink<T> T::* LINK>
+void IntrusiveList<T, LINK>::PushFront(T* pItem)
+{
+	_ASSERT(pItem);
+
+	ListLink<T>& link = pItem->*LINK;
+#ifdef _DEBUG
+	if (link.pPrev || link.pNext || m_pHead == pItem)
+	{
+		// already linked.
+		__debugbreak();
+	}
+#endif
+
+	link.pPrev = nullptr;
+	link.pNext = m_pHead;
+	if (m_pHead)
+	{
+		(m_pHead->*LINK).pPrev = pItem;
+	}
+	else
+	{
+		m_pTail = pItem;
+	}
+	m_pHead = pItem;
+	++m_Count;
+}
+
+template <typename T, ListLink<T> T::* LINK>
+void IntrusiveList<T, LINK>::PushBack(T* pItem)
+{
+	_ASSERT(pItem);
+
+	ListLink<T>& link = pItem->*LINK;
+#ifdef _DEBUG
+	if (link.pPrev || link.pNext || m_pHead == pItem)
+	{
+		// already linked.
+		__debugbreak();
+	}
+#endif
+
+	link.pPrev = m_pTail;
+	link.pNext = nullptr;
+	if (m_pTail)
+	{
+		(m_pTail->*LINK).pNext = pItem;
+	}
+	else
+	{
+		m_pHead = pItem;
+	}
+	m_pTail = pItem;
+	++m_Count;
+}
+
+template <typename T, ListLink<T> T::* LINK>
+void IntrusiveList<T, LINK>::Remove(T* pItem)
+{
+	_ASSERT(pItem);
+	_ASSERT(m_Count > 0);
+
+	ListLink<T>& link = pItem->*LINK;
+
+	if (link.pPrev)
+	{
+#ifdef _DEBUG
+		if ((link.pPrev->*LINK).pNext != pItem)
+		{
+			__debugbreak();
+		}
+#endif
+		(link.pPrev->*LINK).pNext = link.pNext;
+	}
+	else
+	{
+#ifdef _DEBUG
+		if (m_pHead != pItem)
+		{
+			__debugbreak();
+		}
+#endif
+		m_pHead = link.pNext;
+	}
+
+	if (link.pNext)
+	{
+		(link.pNext->*LINK).pPrev = link.pPrev;
+	}
+	else
+	{
+#ifdef _DEBUG
+		if (m_pTail != pItem)
+		{
+			__debugbreak();
+		}
+#endif
+		m_pTail = link.pPrev;
+	}
+
+	link.pPrev = nullptr;
+	link.pNext = nullptr;
+	--m_Count;
+}
+
+template <typename T, ListLink<T> T::* LINK>
+T* IntrusiveList<T, LINK>::PopFront()
+{
+	T* pItem = m_pHead;
+	if (pItem)
+	{
+		Remove(pItem);
+	}
+	return pItem;
+}
+
+template <typename T, ListLink<T> T::* LINK>
+void IntrusiveList<T, LINK>::Clear()
+{
+	m_pHead = nullptr;
+	m_pTail = nullptr;
+	m_Count = 0;
+}
@@ -0,0 +1,39 @@
+#include "../pch.h"
+#include "LinearAllocator.h"
+
+void LinearAllocator::Initialize(const UINT64 SIZE)
+{
+	_ASSERT(SIZE > 0);
+
+	m_Size = SIZE;
+	m_Offset = 0;
+	m_PeakSize = 0;
+	m_AllocationCount = 0;
+}
+
+UINT64 LinearAllocator::Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT)
+{
+	_ASSERT(m_Size > 0);
+	_ASSERT(ALIGNMENT > 0 && (ALIGNMENT & (ALIGNMENT - 1)) == 0);
+
+	const UINT64 OFFSET = (m_Offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	if (OFFSET > m_Size || SIZE > m_Size - OFFSET)
+	{
+		return UINT64_MAX;
+	}
+
+	m_Offset = OFFSET + SIZE;
+	++m_AllocationCount;
+	if (m_Offset > m_PeakSize)
+	{
+		m_PeakSize = m_Offset;
+	}
+
+	return OFFSET;
+}
+
+void LinearAllocator::Reset()
+{
+	m_Offset = 0;
+	m_AllocationCount = 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Bump allocator over offsets of one memory range. Reset() frees everything at once.
+// Owns no memory and calls no OS or D3D API, caller maps offsets onto its own buffer.
+// Not thread safe.
+class LinearAllocator
+{
+public:
+	LinearAllocator() = default;
+	~LinearAllocator() = default;
+
+	void Initialize(const UINT64 SIZE);
+
+	// UINT64_MAX when range is full. ALIGNMENT is power of 2.
+	UINT64 Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT);
+	void Reset();
+
+	inline UINT64 GetSize() { return m_Size; }
+	inline UINT64 GetUsedSize() { return m_Offset; }
+	inline UINT64 GetPeakSize() { return m_PeakSize; }
+	inline UINT GetAllocationCount() { return m_AllocationCount; }
+
+private:
+	UINT64 m_Size = 0;
+	UINT64 m_Offset = 0;
+	UINT64 m_PeakSize = 0; // largest used size seen before Reset().
+	UINT m_AllocationCount = 0;
+};
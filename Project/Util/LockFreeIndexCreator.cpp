@@ -0,0 +1,140 @@
+#include "../pch.h"
+#include "LockFreeIndexCreator.h"
+
+LockFreeIndexCreator::~LockFreeIndexCreator()
+{
+	Check();
+	Clear();
+}
+
+void LockFreeIndexCreator::Initialize(ULONG num)
+{
+	// 0xffff is failure of Alloc().
+	_ASSERT(num > 0 && num < 0xffff);
+
+	m_pNextTable = new LONG[num];
+	m_MaxNum = num;
+
+	for (ULONG i = 0; i < m_MaxNum - 1; ++i)
+	{
+		m_pNextTable[i] = (LONG)(i + 1);
+	}
+	m_pNextTable[m_MaxNum - 1] = (LONG)INVALID_INDEX;
+
+	m_Head = packHead(0, 0);
+	m_AllocatedCount = 0;
+	m_HighWater = 0;
+	m_FailCount = 0;
+}
+
+ULONG LockFreeIndexCreator::Alloc()
+{
+	_ASSERT(m_pNextTable);
+
+	LONG64 oldHead = m_Head;
+	ULONG index = 0;
+
+	while (true)
+	{
+		index = getHeadIndex(oldHead);
+		if (index == INVALID_INDEX)
+		{
+			InterlockedIncrement(&m_FailCount);
+			return 0xffff;
+		}
+
+		// next may be stale when index is taken by other thread meanwhile. tag of head changed then, so exchange fails.
+		const LONG64 NEW_HEAD = packHead((ULONG)m_pNextTable[index], getHeadTag(oldHead) + 1);
+		const LONG64 PREV_HEAD = InterlockedCompareExchange64(&m_Head, NEW_HEAD, oldHead);
+		if (PREV_HEAD == oldHead)
+		{
+			break;
+		}
+		oldHead = PREV_HEAD;
+	}
+
+	const LONG ALLOCATED_COUNT = InterlockedIncrement(&m_AllocatedCount);
+	LONG highWater = m_HighWater;
+	while (ALLOCATED_COUNT > highWater)
+	{
+		const LONG PREV_HIGH_WATER = InterlockedCompareExchange(&m_HighWater, ALLOCATED_COUNT, highWater);
+		if (PREV_HIGH_WATER == highWater)
+		{
+			break;
+		}
+		highWater = PREV_HIGH_WATER;
+	}
+
+	return index;
+}
+
+void LockFreeIndexCreator::Free(ULONG index)
+{
+	_ASSERT(m_pNextTable);
+
+	if (index >= m_MaxNum)
+	{
+		__debugbreak();
+		return;
+	}
+
+	// count is checked before it goes down, so freeing more than allocated leaves it at 0.
+	LONG allocatedCount = m_AllocatedCount;
+	while (true)
+	{
+		if (allocatedCount <= 0)
+		{
+			__debugbreak();
+			return;
+		}
+
+		const LONG PREV_ALLOCATED_COUNT = InterlockedCompareExchange(&m_AllocatedCount, allocatedCount - 1, allocatedCount);
+		if (PREV_ALLOCATED_COUNT == allocatedCount)
+		{
+			break;
+		}
+		allocatedCount = PREV_ALLOCATED_COUNT;
+	}
+
+	LONG64 oldHead = m_Head;
+	while (true)
+	{
+		m_pNextTable[index] = (LONG)getHeadIndex(oldHead);
+
+		const LONG64 NEW_HEAD = packHead(index, getHeadTag(oldHead) + 1);
+		const LONG64 PREV_HEAD = InterlockedCompareExchange64(&m_Head, NEW_HEAD, oldHead);
+		if (PREV_HEAD == oldHead)
+		{
+			break;
+		}
+		oldHead = PREV_HEAD;
+	}
+}
+
+void LockFreeIndexCreator::Clear()
+{
+	m_MaxNum = 0;
+	m_Head = packHead(INVALID_INDEX, 0);
+	m_AllocatedCount = 0;
+	m_HighWater = 0;
+	m_FailCount = 0;
+
+	if (m_pNextTable)
+	{
+		delete[] m_pNextTable;
+		m_pNextTable = nullptr;
+	}
+}
+
+void LockFreeIndexCreator::Check()
+{
+	if (m_AllocatedCount)
+	{
+		__debugbreak();
+	}
+}
+
+void LockFreeIndexCreator::ResetHighWater()
+{
+	m_HighWater = m_AllocatedCount;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// IndexCreator any thread may call Alloc() / Free() on without lock.
+// Free indices form Treiber stack threaded through m_pNextTable. head packs index in low 32 bits and tag in high 32 bits,
+// tag changes on every push and pop so head popped and pushed back in between does not pass compare exchange (ABA).
+// Initialize() / Clear() / ResetHighWater() while no other thread uses it.
+class LockFreeIndexCreator
+{
+public:
+	LockFreeIndexCreator() = default;
+	~LockFreeIndexCreator();
+
+	void Initialize(ULONG num);
+
+	// 0xffff when every index is taken, same as IndexCreator.
+	ULONG Alloc();
+
+	void Free(ULONG index);
+
+	void Clear();
+
+	void Check();
+
+	// most indices taken at once since last call.
+	inline ULONG GetHighWater() { return (ULONG)m_HighWater; }
+	void ResetHighWater();
+
+	inline ULONG GetAllocatedCount() { return (ULONG)m_AllocatedCount; }
+	inline ULONG GetFailCount() { return (ULONG)m_FailCount; }
+
+private:
+	static const ULONG INVALID_INDEX = 0xffffffff; // end of stack.
+
+	inline static LONG64 packHead(const ULONG INDEX, const ULONG TAG) { return (LONG64)(((UINT64)TAG << 32) | INDEX); }
+	inline static ULONG getHeadIndex(const LONG64 HEAD) { return (ULONG)((UINT64)HEAD & 0xffffffff); }
+	inline static ULONG getHeadTag(const LONG64 HEAD) { return (ULONG)((UINT64)HEAD >> 32); }
+
+	volatile LONG* m_pNextTable = nullptr; // next free index of each free index.
+	alignas(8) volatile LONG64 m_Head = 0;
+	ULONG m_MaxNum = 0;
+
+	volatile LONG m_AllocatedCount = 0;
+	volatile LONG m_HighWater = 0;
+	volatile LONG m_FailCount = 0;
+};
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <new>
+
+struct ObjectPoolStats
+{
+	UINT AllocatedCount;
+	UINT PeakCount;
+	UINT ChunkCount;
+	UINT FailCount;
+};
+
+// Fixed size blocks for T, carved from chunks of blockCountPerChunk blocks. free blocks form singly linked lists
+// through their first bytes. each of threadCount threads keeps cache list of its own and takes or gives back batches
+// of blocks from shared list under lock, so Alloc() / Free() lock once per batch and touch heap only when new chunk is needed.
+// block may be freed by other thread than one allocated it. chunks live until Cleanup(), so heap is not touched once
+// pool has grown to its peak.
+// debug build fills free blocks with OBJECT_POOL_POISON, breaks in Alloc() when it finds them written and in Free()
+// when block is still poisoned (freed twice).
+template <typename T>
+class ObjectPool
+{
+public:
+	ObjectPool() = default;
+	~ObjectPool() { Cleanup(); }
+
+	// maxBlockCount 0 is unlimited, otherwise last chunk is cut to it. threadIndex of Alloc() / Free() is below threadCount.
+	void Initialize(UINT blockCountPerChunk, UINT maxBlockCount, UINT threadCount = 1);
+
+	// value initialized T. nullptr when maxBlockCount is reached. blocks cached by other threads are not looked at.
+	T* Alloc(UINT threadIndex = 0);
+	void Free(T* pItem, UINT threadIndex = 0);
+
+	// every item must be freed before.
+	void Cleanup();
+
+	// sums thread caches. call while no other thread uses pool.
+	// PeakCount is sum of peaks of each thread, exact with one thread.
+	const ObjectPoolStats& GetStats();
+
+protected:
+	struct ThreadCache
+	{
+		void* pFreeHead;
+		UINT FreeCount;
+		int AllocatedCount; // goes below 0 when blocks of other threads are freed here.
+		int PeakCount;
+		UINT FailCount;
+		// caches are 128 bytes apart, so two threads never write one cache line however array is aligned.
+		BYTE Padding[128 - sizeof(void*) - sizeof(UINT) * 4];
+	};
+
+	bool refill(ThreadCache* pCache);
+	void giveBack(ThreadCache* pCache, UINT count);
+	bool addChunk();
+
+private:
+	static const BYTE OBJECT_POOL_POISON = 0xdd;
+	static const UINT OBJECT_POOL_MAX_BATCH = 32;
+	// free block holds next free block pointer.
+	static const UINT64 BLOCK_ALIGNMENT = (alignof(T) > alignof(void*) ? alignof(T) : alignof(void*));
+	static const UINT64 BLOCK_SIZE = ((sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+	// malloc alignment on x64.
+	static_assert(BLOCK_ALIGNMENT <= 16, "ObjectPool: alignment above 16 is not supported.");
+
+	// shared list and chunks, under m_CS.
+	CRITICAL_SECTION m_CS;
+	std::vector<BYTE*> m_Chunks;
+	void* m_pFreeHead = nullptr;
+	UINT m_BlockCount = 0;
+
+	ThreadCache* m_pCaches = nullptr;
+	UINT m_ThreadCount = 0;
+	UINT m_BatchCount = 0;
+	UINT m_BlockCountPerChunk = 0;
+	UINT m_MaxBlockCount = 0;
+
+	ObjectPoolStats m_Stats = {};
+};
+
+template <typename T>
+void ObjectPool<T>::Initialize(UINT blockCountPerChunk, UINT maxBlockCount, UINT threadCount)
+{
+	_ASSERT(blockCountPerChunk > 0);
+	_ASSERT(threadCount > 0);
+
+	Cleanup();
+
+	InitializeCriticalSection(&m_CS);
+
+	m_pCaches = new ThreadCache[threadCount];
+	memset(m_pCaches, 0, sizeof(ThreadCache) * threadCount);
+	m_ThreadCount = threadCount;
+	m_BlockCountPerChunk = blockCountPerChunk;
+	m_MaxBlockCount = maxBlockCount;
+
+	// small limited pool is not all held in few caches.
+	m_BatchCount = OBJECT_POOL_MAX_BATCH;
+	if (maxBlockCount > 0 && threadCount > 1)
+	{
+		const UINT SHARE = maxBlockCount / (threadCount * 4);
+		m_BatchCount = (SHARE < 1 ? 1 : (SHARE < m_BatchCount ? SHARE : m_BatchCount));
+	}
+}
+
+template <typename T>
+T* ObjectPool<T>::Alloc(UINT threadIndex)
+{
+	_ASSERT(threadIndex < m_ThreadCount);
+
+	ThreadCache* pCache = &m_pCaches[threadIndex];
+	if (!pCache->pFreeHead && !refill(pCache))
+	{
+		++pCache->FailCount;
+		return nullptr;
+	}
+
+	BYTE* pBlock = (BYTE*)pCache->pFreeHead;
+	pCache->pFreeHead = *(void**)pBlock;
+	--pCache->FreeCount;
+
+#ifdef _DEBUG
+	// written after Free().
+	for (UINT64 i = sizeof(void*); i < BLOCK_SIZE; ++i)
+	{
+		if (pBlock[i] != OBJECT_POOL_POISON)
+		{
+			__debugbreak();
+			break;
+		}
+	}
+#endif
+
+	++pCache->AllocatedCount;
+	if (pCache->AllocatedCount > pCache->PeakCount)
+	{
+		pCache->PeakCount = pCache->AllocatedCount;
+	}
+
+	// DEBUG_NEW of pch.h does not take placement form.
+#pragma push_macro("new")
+#undef new
+	return ::new ((void*)pBlock) T();
+#pragma pop_macro("new")
+}
+
+template <typename T>
+void ObjectPool<T>::Free(T* pItem, UINT threadIndex)
+{
+	_ASSERT(threadIndex < m_ThreadCount);
+
+	if (!pItem)
+	{
+		return;
+	}
+
+	ThreadCache* pCache = &m_pCaches[threadIndex];
+	if (m_ThreadCount == 1 && pCache->AllocatedCount == 0)
+	{
+		// freed more than allocated.
+		__debugbreak();
+		return;
+	}
+
+	BYTE* pBlock = (BYTE*)pItem;
+#ifdef _DEBUG
+	// poisoned past next pointer is free block, freed twice. T of pointer size is not caught.
+	if (BLOCK_SIZE > sizeof(void*))
+	{
+		UINT64 i = sizeof(void*);
+		while (i < BLOCK_SIZE && pBlock[i] == OBJECT_POOL_POISON)
+		{
+			++i;
+		}
+		if (i == BLOCK_SIZE)
+		{
+			__debugbreak();
+			return;
+		}
+	}
+#endif
+
+	pItem->~T();
+
+#ifdef _DEBUG
+	memset(pBlock, OBJECT_POOL_POISON, BLOCK_SIZE);
+#endif
+	*(void**)pBlock = pCache->pFreeHead;
+	pCache->pFreeHead = pBlock;
+	++pCache->FreeCount;
+	--pCache->AllocatedCount;
+
+	// keeps batch for next refill.
+	if (pCache->FreeCount > m_BatchCount * 2)
+	{
+		giveBack(pCache, m_BatchCount);
+	}
+}
+
+template <typename T>
+void ObjectPool<T>::Cleanup()
+{
+	if (!m_pCaches)
+	{
+		return;
+	}
+
+#ifdef _DEBUG
+	if (GetStats().AllocatedCount > 0)
+	{
+		char debugString[256];
+		sprintf_s(debugString, "ObjectPool: %u items are not freed.\n", m_Stats.AllocatedCount);
+		OutputDebugStringA(debugString);
+	}
+#endif
+
+	for (UINT64 i = 0, size = m_Chunks.size(); i < size; ++i)
+	{
+		free(m_Chunks[i]);
+	}
+	m_Chunks.clear();
+	m_pFreeHead = nullptr;
+	m_BlockCount = 0;
+
+	delete[] m_pCaches;
+	m_pCaches = nullptr;
+	DeleteCriticalSection(&m_CS);
+
+	m_ThreadCount = 0;
+	m_BatchCount = 0;
+	m_BlockCountPerChunk = 0;
+	m_MaxBlockCount = 0;
+	m_Stats = {};
+}
+
+template <typename T>
+const ObjectPoolStats& ObjectPool<T>::GetStats()
+{
+	int allocatedCount = 0;
+	int peakCount = 0;
+	m_Stats.FailCount = 0;
+	for (UINT i = 0; i < m_ThreadCount; ++i)
+	{
+		allocatedCount += m_pCaches[i].AllocatedCount;
+		peakCount += m_pCaches[i].PeakCount;
+		m_Stats.FailCount += m_pCaches[i].FailCount;
+	}
+	m_Stats.AllocatedCount = (UINT)allocatedCount;
+	m_Stats.PeakCount = (UINT)peakCount;
+	return m_Stats;
+}
+
+template <typename T>
+bool ObjectPool<T>::refill(ThreadCache* pCache)
+{
+	_ASSERT(!pCache->pFreeHead);
+
+	EnterCriticalSection(&m_CS);
+
+	// batch is cut off front of shared list, so blocks keep address order. new chunk only when list is empty.
+	UINT count = 0;
+	void* pLast = nullptr;
+	while (count < m_BatchCount)
+	{
+		if (!m_pFreeHead && (count > 0 || !addChunk()))
+		{
+			break;
+		}
+
+		void* pBlock = m_pFreeHead;
+		m_pFreeHead = *(void**)pBlock;
+		if (pLast)
+		{
+			*(void**)pLast = pBlock;
+		}
+		else
+		{
+			pCache->pFreeHead = pBlock;
+		}
+		pLast = pBlock;
+		++count;
+	}
+	if (pLast)
+	{
+		*(void**)pLast = nullptr;
+	}
+
+	LeaveCriticalSection(&m_CS);
+
+	pCache->FreeCount = count;
+	return (count > 0);
+}
+
+template <typename T>
+void ObjectPool<T>::giveBack(ThreadCache* pCache, UINT count)
+{
+	_ASSERT(count <= pCache->FreeCount);
+
+	// cut batch off cache first, lock only to link it.
+	void* pFirst = pCache->pFreeHead;
+	void* pLast = pFirst;
+	for (UINT i = 1; i < count; ++i)
+	{
+		pLast = *(void**)pLast;
+	}
+	pCache->pFreeHead = *(void**)pLast;
+	pCache->FreeCount -= count;
+
+	EnterCriticalSection(&m_CS);
+	*(void**)pLast = m_pFreeHead;
+	m_pFreeHead = pFirst;
+	LeaveCriticalSection(&m_CS);
+}
+
+template <typename T>
+bool ObjectPool<T>::addChunk()
+{
+	UINT blockCount = m_BlockCountPerChunk;
+	if (m_MaxBlockCount > 0)
+	{
+		if (m_BlockCount >= m_MaxBlockCount)
+		{
+			return false;
+		}
+		// last chunk is cut, so limit below chunk size is not lost.
+		blockCount = (m_MaxBlockCount - m_BlockCount < blockCount ? m_MaxBlockCount - m_BlockCount : blockCount);
+	}
+
+	BYTE* pChunk = (BYTE*)malloc(BLOCK_SIZE * blockCount);
+	if (!pChunk)
+	{
+		__debugbreak();
+		return false;
+	}
+#ifdef _DEBUG
+	memset(pChunk, OBJECT_POOL_POISON, BLOCK_SIZE * blockCount);
+#endif
+	m_Chunks.push_back(pChunk);
+	m_BlockCount += blockCount;
+	++m_Stats.ChunkCount;
+
+	// linked back to front, so blocks are handed out in address order.
+	for (UINT i = blockCount; i > 0; --i)
+	{
+		BYTE* pBlock = pChunk + BLOCK_SIZE * (i - 1);
+		*(void**)pBlock = m_pFreeHead;
+		m_pFreeHead = pBlock;
+	}
+
+	return true;
+}
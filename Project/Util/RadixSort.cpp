@@ -0,0 +1,65 @@
+#include "../pch.h"
+#include "RadixSort.h"
+
+void RadixSort64(RadixSortEntry* pEntries, RadixSortEntry* pTemp, const UINT COUNT)
+{
+	const UINT PASS_COUNT = 8;
+	const UINT BUCKET_COUNT = 256;
+
+	// empty list may come with null buffers.
+	if (COUNT < 2)
+	{
+		return;
+	}
+
+	_ASSERT(pEntries);
+	_ASSERT(pTemp);
+
+	UINT ppHistograms[PASS_COUNT][BUCKET_COUNT] = {};
+	for (UINT i = 0; i < COUNT; ++i)
+	{
+		const UINT64 KEY = pEntries[i].Key;
+		for (UINT pass = 0; pass < PASS_COUNT; ++pass)
+		{
+			++ppHistograms[pass][(KEY >> (pass * 8)) & 0xff];
+		}
+	}
+
+	RadixSortEntry* pSrc = pEntries;
+	RadixSortEntry* pDst = pTemp;
+	for (UINT pass = 0; pass < PASS_COUNT; ++pass)
+	{
+		UINT* pHistogram = ppHistograms[pass];
+
+		// same byte everywhere, order does not change.
+		if (pHistogram[(pSrc[0].Key >> (pass * 8)) & 0xff] == COUNT)
+		{
+			continue;
+		}
+
+		// counts to start offsets.
+		UINT offset = 0;
+		for (UINT i = 0; i < BUCKET_COUNT; ++i)
+		{
+			const UINT BUCKET_SIZE = pHistogram[i];
+			pHistogram[i] = offset;
+			offset += BUCKET_SIZE;
+		}
+
+		for (UINT i = 0; i < COUNT; ++i)
+		{
+			const UINT BUCKET = (UINT)((pSrc[i].Key >> (pass * 8)) & 0xff);
+			pDst[pHistogram[BUCKET]] = pSrc[i];
+			++pHistogram[BUCKET];
+		}
+
+		RadixSortEntry* pSwap = pSrc;
+		pSrc = pDst;
+		pDst = pSwap;
+	}
+
+	if (pSrc != pEntries)
+	{
+		memcpy(pEntries, pSrc, sizeof(RadixSortEntry) * COUNT);
+	}
+}
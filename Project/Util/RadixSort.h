@@ -0,0 +1,12 @@
+#pragma once
+
+struct RadixSortEntry
+{
+	UINT64 Key;
+	UINT Index; // of item in caller's array.
+};
+
+// Stable LSD radix sort of entries by Key, ascending. 8 bits per pass, histograms of all passes are built
+// in one read of input, and passes where every key has same byte are skipped.
+// pTemp holds COUNT entries. result is in pEntries.
+void RadixSort64(RadixSortEntry* pEntries, RadixSortEntry* pTemp, const UINT COUNT);
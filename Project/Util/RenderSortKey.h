@@ -0,0 +1,29 @@
+#pragma once
+
+// [63:60] render pass, [59:52] PSO type, [51:32] sub state, [31:0] depth. queue draws smaller keys first.
+// so items of same PSO are adjacent and state is set once per run.
+// sub state is state besides PSO that costs rebinding, e.g. light of shadow pass.
+// materials are bindless and cost nothing to switch, so they are not in key.
+// DEPTH is view distance, not negative. bits of positive float sort same as its value, so near draws go first.
+inline UINT64 MakeRenderSortKey(const UINT RENDER_PASS, const UINT PSO_TYPE, const UINT SUB_STATE, const float DEPTH)
+{
+	_ASSERT(RENDER_PASS < 16 && PSO_TYPE < 256 && SUB_STATE < (1 << 20));
+
+	const float CLAMPED_DEPTH = (DEPTH > 0.0f ? DEPTH : 0.0f);
+	UINT depthBits = 0;
+	memcpy(&depthBits, &CLAMPED_DEPTH, sizeof(UINT));
+
+	return ((UINT64)RENDER_PASS << 60) | ((UINT64)PSO_TYPE << 52) | ((UINT64)SUB_STATE << 32) | (UINT64)depthBits;
+}
+
+// state part of key. items with same state share PSO and sub state.
+inline UINT64 GetRenderSortKeyState(const UINT64 KEY) { return (KEY >> 32); }
+
+// first item of chunk CHUNK_INDEX when COUNT items sorted by key are cut into CHUNK_COUNT contiguous chunks.
+// chunk CHUNK_INDEX is [GetRenderChunkBegin(CHUNK_INDEX), GetRenderChunkBegin(CHUNK_INDEX + 1)), sizes differ by 1 at most.
+// each thread then rebinds state once per run in its chunk, plus once at chunk start.
+inline UINT GetRenderChunkBegin(const UINT COUNT, const UINT CHUNK_COUNT, const UINT CHUNK_INDEX)
+{
+	_ASSERT(CHUNK_COUNT > 0 && CHUNK_INDEX <= CHUNK_COUNT);
+	return (UINT)((UINT64)COUNT * CHUNK_INDEX / CHUNK_COUNT);
+}
@@ -0,0 +1,362 @@
+#include "../pch.h"
+#include "TLSFAllocator.h"
+
+// index of highest / lowest set bit. VALUE must not be 0.
+static UINT findLastSet(const UINT64 VALUE)
+{
+	_ASSERT(VALUE);
+
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanReverse64(&index, VALUE);
+	return (UINT)index;
+#else
+	return (UINT)(63 - __builtin_clzll(VALUE));
+#endif
+}
+
+static UINT findFirstSet(const UINT64 VALUE)
+{
+	_ASSERT(VALUE);
+
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanForward64(&index, VALUE);
+	return (UINT)index;
+#else
+	return (UINT)__builtin_ctzll(VALUE);
+#endif
+}
+
+static UINT64 getGCD(UINT64 a, UINT64 b)
+{
+	while (b)
+	{
+		const UINT64 REMAINDER = a % b;
+		a = b;
+		b = REMAINDER;
+	}
+	return a;
+}
+
+void TLSFAllocator::Initialize(const UINT64 SIZE)
+{
+	Cleanup();
+
+	m_Size = SIZE - SIZE % TLSF_GRANULARITY;
+	_ASSERT(m_Size > 0);
+
+	for (UINT fl = 0; fl < TLSF_FL_COUNT; ++fl)
+	{
+		for (UINT sl = 0; sl < TLSF_SL_COUNT; ++sl)
+		{
+			m_ppBinHeads[fl][sl] = TLSF_INVALID_NODE;
+		}
+	}
+
+	const UINT NODE_INDEX = createNode(0, m_Size);
+	m_Nodes[NODE_INDEX].bFree = true;
+	insertFreeNode(NODE_INDEX);
+	m_FreeSize = m_Size;
+}
+
+bool TLSFAllocator::Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT, TLSFAllocation* pOutAllocation)
+{
+	_ASSERT(pOutAllocation);
+	_ASSERT(m_Size > 0);
+
+	pOutAllocation->Offset = UINT64_MAX;
+	pOutAllocation->Size = SIZE;
+	pOutAllocation->NodeIndex = TLSF_INVALID_NODE;
+
+	const UINT64 BLOCK_SIZE = (SIZE > 0 ? (SIZE + TLSF_GRANULARITY - 1) / TLSF_GRANULARITY * TLSF_GRANULARITY : TLSF_GRANULARITY);
+	// offsets stay multiple of granularity, so alignment is raised to common multiple of both.
+	const UINT64 ALIGN = (ALIGNMENT > 1 ? ALIGNMENT / getGCD(ALIGNMENT, TLSF_GRANULARITY) * TLSF_GRANULARITY : TLSF_GRANULARITY);
+	// worst case front padding is included in search, so found block always fits.
+	const UINT64 REQUEST_SIZE = BLOCK_SIZE + ALIGN - TLSF_GRANULARITY;
+	if (REQUEST_SIZE > m_FreeSize)
+	{
+		return false;
+	}
+
+	const UINT NODE_INDEX = findFreeNode(REQUEST_SIZE);
+	if (NODE_INDEX == TLSF_INVALID_NODE)
+	{
+		return false;
+	}
+	removeFreeNode(NODE_INDEX);
+
+	const UINT64 ALIGNED_OFFSET = (m_Nodes[NODE_INDEX].Offset + ALIGN - 1) / ALIGN * ALIGN;
+	const UINT64 FRONT_SIZE = ALIGNED_OFFSET - m_Nodes[NODE_INDEX].Offset;
+	if (FRONT_SIZE > 0)
+	{
+		// previous physical block is in use, otherwise it would have been merged. no coalescing needed.
+		const UINT FRONT_INDEX = createNode(m_Nodes[NODE_INDEX].Offset, FRONT_SIZE);
+		Node* pFront = &m_Nodes[FRONT_INDEX];
+		Node* pNode = &m_Nodes[NODE_INDEX];
+
+		pFront->bFree = true;
+		pFront->PrevPhysical = pNode->PrevPhysical;
+		pFront->NextPhysical = NODE_INDEX;
+		if (pNode->PrevPhysical != TLSF_INVALID_NODE)
+		{
+			m_Nodes[pNode->PrevPhysical].NextPhysical = FRONT_INDEX;
+		}
+		pNode->PrevPhysical = FRONT_INDEX;
+		pNode->Offset = ALIGNED_OFFSET;
+		pNode->Size -= FRONT_SIZE;
+
+		insertFreeNode(FRONT_INDEX);
+	}
+
+	const UINT64 BACK_SIZE = m_Nodes[NODE_INDEX].Size - BLOCK_SIZE;
+	if (BACK_SIZE > 0)
+	{
+		const UINT BACK_INDEX = createNode(ALIGNED_OFFSET + BLOCK_SIZE, BACK_SIZE);
+		Node* pBack = &m_Nodes[BACK_INDEX];
+		Node* pNode = &m_Nodes[NODE_INDEX];
+
+		pBack->bFree = true;
+		pBack->PrevPhysical = NODE_INDEX;
+		pBack->NextPhysical = pNode->NextPhysical;
+		if (pNode->NextPhysical != TLSF_INVALID_NODE)
+		{
+			m_Nodes[pNode->NextPhysical].PrevPhysical = BACK_INDEX;
+		}
+		pNode->NextPhysical = BACK_INDEX;
+		pNode->Size = BLOCK_SIZE;
+
+		insertFreeNode(BACK_INDEX);
+	}
+
+	m_Nodes[NODE_INDEX].bFree = false;
+	m_FreeSize -= BLOCK_SIZE;
+	++m_AllocationCount;
+
+	pOutAllocation->Offset = ALIGNED_OFFSET;
+	pOutAllocation->NodeIndex = NODE_INDEX;
+
+	return true;
+}
+
+void TLSFAllocator::Free(const TLSFAllocation& ALLOCATION)
+{
+	_ASSERT(ALLOCATION.NodeIndex < (UINT)m_Nodes.size());
+	_ASSERT(!m_Nodes[ALLOCATION.NodeIndex].bFree);
+	_ASSERT(m_AllocationCount > 0);
+
+	UINT nodeIndex = ALLOCATION.NodeIndex;
+	m_Nodes[nodeIndex].bFree = true;
+	m_FreeSize += m_Nodes[nodeIndex].Size;
+	--m_AllocationCount;
+
+	// merge with free neighbors.
+	const UINT PREV_INDEX = m_Nodes[nodeIndex].PrevPhysical;
+	if (PREV_INDEX != TLSF_INVALID_NODE && m_Nodes[PREV_INDEX].bFree)
+	{
+		removeFreeNode(PREV_INDEX);
+
+		Node* pPrev = &m_Nodes[PREV_INDEX];
+		Node* pNode = &m_Nodes[nodeIndex];
+		pPrev->Size += pNode->Size;
+		pPrev->NextPhysical = pNode->NextPhysical;
+		if (pNode->NextPhysical != TLSF_INVALID_NODE)
+		{
+			m_Nodes[pNode->NextPhysical].PrevPhysical = PREV_INDEX;
+		}
+
+		releaseNode(nodeIndex);
+		nodeIndex = PREV_INDEX;
+	}
+
+	const UINT NEXT_INDEX = m_Nodes[nodeIndex].NextPhysical;
+	if (NEXT_INDEX != TLSF_INVALID_NODE && m_Nodes[NEXT_INDEX].bFree)
+	{
+		removeFreeNode(NEXT_INDEX);
+
+		Node* pNext = &m_Nodes[NEXT_INDEX];
+		Node* pNode = &m_Nodes[nodeIndex];
+		pNode->Size += pNext->Size;
+		pNode->NextPhysical = pNext->NextPhysical;
+		if (pNext->NextPhysical != TLSF_INVALID_NODE)
+		{
+			m_Nodes[pNext->NextPhysical].PrevPhysical = nodeIndex;
+		}
+
+		releaseNode(NEXT_INDEX);
+	}
+
+	insertFreeNode(nodeIndex);
+}
+
+void TLSFAllocator::Cleanup()
+{
+	m_Nodes.clear();
+	m_UnusedNodes.clear();
+
+	m_FLBitmap = 0;
+	for (UINT fl = 0; fl < TLSF_FL_COUNT; ++fl)
+	{
+		m_pSLBitmaps[fl] = 0;
+	}
+
+	m_Size = 0;
+	m_FreeSize = 0;
+	m_AllocationCount = 0;
+}
+
+UINT64 TLSFAllocator::GetLargestFreeSize()
+{
+	if (m_FLBitmap == 0)
+	{
+		return 0;
+	}
+
+	const UINT FL = findLastSet(m_FLBitmap);
+	const UINT SL = findLastSet(m_pSLBitmaps[FL]);
+	UINT64 largestSize = 0;
+	for (UINT nodeIndex = m_ppBinHeads[FL][SL]; nodeIndex != TLSF_INVALID_NODE; nodeIndex = m_Nodes[nodeIndex].NextFree)
+	{
+		largestSize = (m_Nodes[nodeIndex].Size > largestSize ? m_Nodes[nodeIndex].Size : largestSize);
+	}
+
+	return largestSize;
+}
+
+void TLSFAllocator::mapInsert(const UINT64 SIZE, UINT* pFL, UINT* pSL)
+{
+	// first level 0 holds exact sizes below TLSF_SL_COUNT units, others split each power of 2 range linearly.
+	const UINT64 UNITS = SIZE / TLSF_GRANULARITY;
+	if (UNITS < TLSF_SL_COUNT)
+	{
+		*pFL = 0;
+		*pSL = (UINT)UNITS;
+		return;
+	}
+
+	const UINT HIGH_BIT = findLastSet(UNITS);
+	*pFL = HIGH_BIT - TLSF_SL_LOG2 + 1;
+	*pSL = (UINT)(UNITS >> (HIGH_BIT - TLSF_SL_LOG2)) - TLSF_SL_COUNT;
+	_ASSERT(*pFL < TLSF_FL_COUNT);
+}
+
+void TLSFAllocator::mapSearch(const UINT64 SIZE, UINT* pFL, UINT* pSL)
+{
+	UINT64 units = SIZE / TLSF_GRANULARITY;
+	if (units >= TLSF_SL_COUNT)
+	{
+		units += (1ull << (findLastSet(units) - TLSF_SL_LOG2)) - 1;
+	}
+	mapInsert(units * TLSF_GRANULARITY, pFL, pSL);
+}
+
+UINT TLSFAllocator::findFreeNode(const UINT64 SIZE)
+{
+	UINT fl = 0;
+	UINT sl = 0;
+	mapSearch(SIZE, &fl, &sl);
+	if (fl >= TLSF_FL_COUNT)
+	{
+		return TLSF_INVALID_NODE;
+	}
+
+	UINT slBitmap = m_pSLBitmaps[fl] & (0xffffffff << sl);
+	if (slBitmap == 0)
+	{
+		const UINT64 FL_BITMAP = (fl + 1 < 64 ? m_FLBitmap & (~0ull << (fl + 1)) : 0);
+		if (FL_BITMAP == 0)
+		{
+			return TLSF_INVALID_NODE;
+		}
+		fl = findFirstSet(FL_BITMAP);
+		slBitmap = m_pSLBitmaps[fl];
+	}
+	sl = findFirstSet(slBitmap);
+
+	return m_ppBinHeads[fl][sl];
+}
+
+void TLSFAllocator::insertFreeNode(const UINT NODE_INDEX)
+{
+	UINT fl = 0;
+	UINT sl = 0;
+	Node* pNode = &m_Nodes[NODE_INDEX];
+	mapInsert(pNode->Size, &fl, &sl);
+
+	const UINT HEAD_INDEX = m_ppBinHeads[fl][sl];
+	pNode->PrevFree = TLSF_INVALID_NODE;
+	pNode->NextFree = HEAD_INDEX;
+	if (HEAD_INDEX != TLSF_INVALID_NODE)
+	{
+		m_Nodes[HEAD_INDEX].PrevFree = NODE_INDEX;
+	}
+	m_ppBinHeads[fl][sl] = NODE_INDEX;
+
+	m_FLBitmap |= (1ull << fl);
+	m_pSLBitmaps[fl] |= (1u << sl);
+}
+
+void TLSFAllocator::removeFreeNode(const UINT NODE_INDEX)
+{
+	UINT fl = 0;
+	UINT sl = 0;
+	Node* pNode = &m_Nodes[NODE_INDEX];
+	mapInsert(pNode->Size, &fl, &sl);
+
+	if (pNode->PrevFree != TLSF_INVALID_NODE)
+	{
+		m_Nodes[pNode->PrevFree].NextFree = pNode->NextFree;
+	}
+	else
+	{
+		m_ppBinHeads[fl][sl] = pNode->NextFree;
+	}
+	if (pNode->NextFree != TLSF_INVALID_NODE)
+	{
+		m_Nodes[pNode->NextFree].PrevFree = pNode->PrevFree;
+	}
+	pNode->PrevFree = TLSF_INVALID_NODE;
+	pNode->NextFree = TLSF_INVALID_NODE;
+
+	if (m_ppBinHeads[fl][sl] == TLSF_INVALID_NODE)
+	{
+		m_pSLBitmaps[fl] &= ~(1u << sl);
+		if (m_pSLBitmaps[fl] == 0)
+		{
+			m_FLBitmap &= ~(1ull << fl);
+		}
+	}
+}
+
+UINT TLSFAllocator::createNode(const UINT64 OFFSET, const UINT64 SIZE)
+{
+	UINT nodeIndex = TLSF_INVALID_NODE;
+	if (!m_UnusedNodes.empty())
+	{
+		nodeIndex = m_UnusedNodes.back();
+		m_UnusedNodes.pop_back();
+	}
+	else
+	{
+		nodeIndex = (UINT)m_Nodes.size();
+		m_Nodes.push_back(Node());
+	}
+
+	Node* pNode = &m_Nodes[nodeIndex];
+	pNode->Offset = OFFSET;
+	pNode->Size = SIZE;
+	pNode->PrevPhysical = TLSF_INVALID_NODE;
+	pNode->NextPhysical = TLSF_INVALID_NODE;
+	pNode->PrevFree = TLSF_INVALID_NODE;
+	pNode->NextFree = TLSF_INVALID_NODE;
+	pNode->bFree = false;
+
+	return nodeIndex;
+}
+
+void TLSFAllocator::releaseNode(const UINT NODE_INDEX)
+{
+	m_Nodes[NODE_INDEX].bFree = false;
+	m_Nodes[NODE_INDEX].Size = 0;
+	m_UnusedNodes.push_back(NODE_INDEX);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// Two level segregated fit allocator over offsets of one memory range. O(1) allocate and free.
+// Owns no memory and calls no OS or D3D API, caller maps offsets onto its own buffer.
+// Not thread safe.
+
+static const UINT64 TLSF_GRANULARITY = 16; // offsets and sizes are multiples of this.
+static const UINT TLSF_SL_LOG2 = 4;
+static const UINT TLSF_SL_COUNT = 1 << TLSF_SL_LOG2;
+static const UINT TLSF_FL_COUNT = 40;
+static const UINT TLSF_INVALID_NODE = 0xffffffff;
+
+struct TLSFAllocation
+{
+	UINT64 Offset; // aligned. UINT64_MAX when allocation failed.
+	UINT64 Size; // requested size.
+	UINT NodeIndex; // pass back to Free().
+};
+
+class TLSFAllocator
+{
+public:
+	TLSFAllocator() = default;
+	~TLSFAllocator() { Cleanup(); }
+
+	void Initialize(const UINT64 SIZE);
+
+	// ALIGNMENT may be any value, not only power of 2. returns false when no free block is large enough.
+	bool Allocate(const UINT64 SIZE, const UINT64 ALIGNMENT, TLSFAllocation* pOutAllocation);
+	void Free(const TLSFAllocation& ALLOCATION);
+
+	void Cleanup();
+
+	// walks bins of largest class. for stats, not for hot path.
+	UINT64 GetLargestFreeSize();
+
+	inline UINT64 GetSize() { return m_Size; }
+	inline UINT64 GetFreeSize() { return m_FreeSize; }
+	inline UINT GetAllocationCount() { return m_AllocationCount; }
+	inline bool IsEmpty() { return (m_AllocationCount == 0); }
+
+protected:
+	void mapInsert(const UINT64 SIZE, UINT* pFL, UINT* pSL);
+	// rounds size up so every block in found bin fits.
+	void mapSearch(const UINT64 SIZE, UINT* pFL, UINT* pSL);
+	UINT findFreeNode(const UINT64 SIZE);
+
+	void insertFreeNode(const UINT NODE_INDEX);
+	void removeFreeNode(const UINT NODE_INDEX);
+	UINT createNode(const UINT64 OFFSET, const UINT64 SIZE);
+	void releaseNode(const UINT NODE_INDEX);
+
+private:
+	struct Node
+	{
+		UINT64 Offset;
+		UINT64 Size;
+		UINT PrevPhysical; // neighbors by address.
+		UINT NextPhysical;
+		UINT PrevFree; // neighbors in bin.
+		UINT NextFree;
+		bool bFree;
+	};
+
+	std::vector<Node> m_Nodes;
+	std::vector<UINT> m_UnusedNodes;
+
+	UINT64 m_FLBitmap = 0;
+	UINT m_pSLBitmaps[TLSF_FL_COUNT] = { 0, };
+	UINT m_ppBinHeads[TLSF_FL_COUNT][TLSF_SL_COUNT] = {};
+
+	UINT64 m_Size = 0;
+	UINT64 m_FreeSize = 0;
+	UINT m_AllocationCount = 0;
+};
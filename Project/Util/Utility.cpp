@@ -206,6 +206,203 @@ void GetPhysicalCoreCount(UINT* pPhysicalCoreCount, UINT* pLogicalCoreCount)
 	free(pBuffer);
 }
 
+struct ParallelRange
+{
+	ParallelJobFunc pfnJob;
+	void* pArg;
+	UINT Begin;
+	UINT End;
+	UINT RangeIndex;
+};
+struct ParallelWorker
+{
+	HANDLE hThread;
+	HANDLE hStartEvent;
+	ParallelRange* pRange; // nullptr on start means exit.
+};
+// workers live until ShutdownParallelFor(). one ParallelFor uses them at a time.
+struct ParallelWorkerPool
+{
+	ParallelWorker Workers[MAX_PARALLEL_THREAD_COUNT - 1];
+	UINT WorkerCount;
+	HANDLE hDoneEvent;
+	volatile LONG PendingCount;
+	volatile LONG bBusy;
+};
+static ParallelWorkerPool s_ParallelWorkerPool = {};
+static volatile LONG s_ParallelWorkerPoolState = 0; // 0: none, 1: creating, 2: ready.
+
+static UINT WINAPI parallelWorkerThread(void* pArg)
+{
+	ParallelWorker* pWorker = (ParallelWorker*)pArg;
+
+	while (true)
+	{
+		WaitForSingleObject(pWorker->hStartEvent, INFINITE);
+
+		ParallelRange* pRange = pWorker->pRange;
+		if (!pRange)
+		{
+			break;
+		}
+		pRange->pfnJob(pRange->Begin, pRange->End, pRange->RangeIndex, pRange->pArg);
+
+		if (InterlockedDecrement(&s_ParallelWorkerPool.PendingCount) == 0)
+		{
+			SetEvent(s_ParallelWorkerPool.hDoneEvent);
+		}
+	}
+
+	_endthreadex(0);
+	return 0;
+}
+
+// returns false when workers can not be used.
+static bool createParallelWorkerPool()
+{
+	if (InterlockedCompareExchange(&s_ParallelWorkerPoolState, 1, 0) != 0)
+	{
+		while (s_ParallelWorkerPoolState == 1)
+		{
+			Sleep(0);
+		}
+		return (s_ParallelWorkerPool.WorkerCount > 0);
+	}
+
+	ParallelWorkerPool* pPool = &s_ParallelWorkerPool;
+	const UINT WORKER_COUNT = GetParallelRangeCount(MAX_PARALLEL_THREAD_COUNT, 1) - 1;
+
+	pPool->hDoneEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (pPool->hDoneEvent)
+	{
+		for (UINT i = 0; i < WORKER_COUNT; ++i)
+		{
+			ParallelWorker* pWorker = &pPool->Workers[i];
+			pWorker->hStartEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+			if (!pWorker->hStartEvent)
+			{
+				break;
+			}
+
+			UINT threadID = 0;
+			pWorker->hThread = (HANDLE)_beginthreadex(nullptr, 0, parallelWorkerThread, pWorker, 0, &threadID);
+			if (!pWorker->hThread)
+			{
+				CloseHandle(pWorker->hStartEvent);
+				pWorker->hStartEvent = nullptr;
+				break;
+			}
+			++(pPool->WorkerCount);
+		}
+	}
+
+	InterlockedExchange(&s_ParallelWorkerPoolState, 2);
+	return (pPool->WorkerCount > 0);
+}
+
+UINT GetParallelRangeCount(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE)
+{
+	static UINT s_PhysicalCoreCount = 0;
+	if (s_PhysicalCoreCount == 0)
+	{
+		UINT logicalCoreCount = 0;
+		GetPhysicalCoreCount(&s_PhysicalCoreCount, &logicalCoreCount);
+		if (s_PhysicalCoreCount == 0)
+		{
+			s_PhysicalCoreCount = 1;
+		}
+	}
+
+	UINT rangeCount = (COUNT + MIN_COUNT_PER_RANGE - 1) / (MIN_COUNT_PER_RANGE > 0 ? MIN_COUNT_PER_RANGE : 1);
+	rangeCount = (UINT)Min((int)rangeCount, (int)s_PhysicalCoreCount);
+	rangeCount = (UINT)Min((int)rangeCount, (int)MAX_PARALLEL_THREAD_COUNT);
+
+	return (rangeCount > 0 ? rangeCount : 1);
+}
+
+void ParallelFor(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE, ParallelJobFunc pfnJob, void* pArg)
+{
+	_ASSERT(pfnJob);
+
+	if (COUNT == 0)
+	{
+		return;
+	}
+
+	ParallelWorkerPool* pPool = &s_ParallelWorkerPool;
+	ParallelRange ranges[MAX_PARALLEL_THREAD_COUNT];
+	UINT rangeCount = GetParallelRangeCount(COUNT, MIN_COUNT_PER_RANGE);
+
+	// nested or concurrent calls find workers busy and run their ranges on calling thread.
+	bool bUseWorkers = (rangeCount > 1 && (s_ParallelWorkerPoolState == 2 ? pPool->WorkerCount > 0 : createParallelWorkerPool()) &&
+						InterlockedCompareExchange(&pPool->bBusy, TRUE, FALSE) == FALSE);
+	if (bUseWorkers)
+	{
+		rangeCount = (UINT)Min((int)rangeCount, (int)pPool->WorkerCount + 1);
+	}
+
+	for (UINT i = 0; i < rangeCount; ++i)
+	{
+		ranges[i].pfnJob = pfnJob;
+		ranges[i].pArg = pArg;
+		ranges[i].Begin = (UINT)((UINT64)COUNT * i / rangeCount);
+		ranges[i].End = (UINT)((UINT64)COUNT * (i + 1) / rangeCount);
+		ranges[i].RangeIndex = i;
+	}
+
+	if (!bUseWorkers)
+	{
+		for (UINT i = 0; i < rangeCount; ++i)
+		{
+			pfnJob(ranges[i].Begin, ranges[i].End, i, pArg);
+		}
+		return;
+	}
+
+	pPool->PendingCount = (LONG)(rangeCount - 1);
+	for (UINT i = 1; i < rangeCount; ++i)
+	{
+		ParallelWorker* pWorker = &pPool->Workers[i - 1];
+		pWorker->pRange = &ranges[i];
+		SetEvent(pWorker->hStartEvent);
+	}
+
+	pfnJob(ranges[0].Begin, ranges[0].End, 0, pArg);
+
+	WaitForSingleObject(pPool->hDoneEvent, INFINITE);
+	InterlockedExchange(&pPool->bBusy, FALSE);
+}
+
+void ShutdownParallelFor()
+{
+	ParallelWorkerPool* pPool = &s_ParallelWorkerPool;
+	if (s_ParallelWorkerPoolState != 2)
+	{
+		return;
+	}
+
+	for (UINT i = 0; i < pPool->WorkerCount; ++i)
+	{
+		ParallelWorker* pWorker = &pPool->Workers[i];
+		pWorker->pRange = nullptr;
+		SetEvent(pWorker->hStartEvent);
+		WaitForSingleObject(pWorker->hThread, INFINITE);
+
+		CloseHandle(pWorker->hThread);
+		CloseHandle(pWorker->hStartEvent);
+		pWorker->hThread = nullptr;
+		pWorker->hStartEvent = nullptr;
+	}
+	pPool->WorkerCount = 0;
+
+	if (pPool->hDoneEvent)
+	{
+		CloseHandle(pPool->hDoneEvent);
+		pPool->hDoneEvent = nullptr;
+	}
+	InterlockedExchange(&s_ParallelWorkerPoolState, 0);
+}
+
 std::string RemoveBasePath(const std::string& szFilePath)
 {
 	size_t lastSlash;
@@ -252,6 +449,78 @@ std::wstring GetFileExtension(const std::wstring& szFilePath)
 	return fileName.substr(extOffset + 1);
 }
 
+std::wstring NormalizePath(const std::wstring& szFilePath)
+{
+	WCHAR szFullPath[MAX_PATH];
+	std::wstring normalized;
+
+	DWORD length = GetFullPathNameW(szFilePath.c_str(), MAX_PATH, szFullPath, nullptr);
+	if (length == 0 || length >= MAX_PATH)
+	{
+		normalized = szFilePath;
+	}
+	else
+	{
+		normalized = szFullPath;
+	}
+
+	for (UINT64 i = 0, size = normalized.size(); i < size; ++i)
+	{
+		WCHAR ch = normalized[i];
+		if (ch == L'/')
+		{
+			ch = L'\\';
+		}
+		normalized[i] = towlower(ch);
+	}
+
+	return normalized;
+}
+
+HRESULT ReadWholeFile(const WCHAR* pszFileName, std::vector<UCHAR>& fileData)
+{
+	HRESULT hr = S_OK;
+	LARGE_INTEGER fileSize = {};
+	DWORD readBytes = 0;
+
+	HANDLE hFile = CreateFileW(pszFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return HRESULT_FROM_WIN32(GetLastError());
+	}
+
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.HighPart != 0)
+	{
+		hr = E_FAIL;
+		goto LB_RET;
+	}
+
+	fileData.resize(fileSize.LowPart);
+	if (fileSize.LowPart > 0 && (!ReadFile(hFile, fileData.data(), fileSize.LowPart, &readBytes, nullptr) || readBytes != fileSize.LowPart))
+	{
+		fileData.clear();
+		hr = E_FAIL;
+	}
+
+LB_RET:
+	CloseHandle(hFile);
+	return hr;
+}
+
+UINT64 HashBytes(const void* pDATA, const UINT64 SIZE, const UINT64 SEED)
+{
+	const UCHAR* pBYTES = (const UCHAR*)pDATA;
+	UINT64 hash = SEED;
+
+	for (UINT64 i = 0; i < SIZE; ++i)
+	{
+		hash ^= pBYTES[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
 UINT64 GetAllocMemSize(UINT64 size)
 {
 	return size + sizeof(UINT64) * 2;
@@ -13,9 +13,26 @@ void SetDebugLayerInfo(ID3D12Device* pD3DDevice);
 
 void GetPhysicalCoreCount(UINT* pPhysicalCoreCount, UINT* pLogicalCoreCount);
 
+// Splits [0, COUNT) into ranges and runs them on worker threads. Range 0 runs on calling thread.
+// Blocks until all ranges are done. Workers are created on first use and reused. While they are busy,
+// nested or concurrent calls run their ranges on calling thread. Range count is at most GetParallelRangeCount().
+typedef void (*ParallelJobFunc)(UINT begin, UINT end, UINT rangeIndex, void* pArg);
+static const UINT MAX_PARALLEL_THREAD_COUNT = 16;
+UINT GetParallelRangeCount(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE);
+void ParallelFor(const UINT COUNT, const UINT MIN_COUNT_PER_RANGE, ParallelJobFunc pfnJob, void* pArg);
+// Ends worker threads. call at exit, when no ParallelFor is running.
+void ShutdownParallelFor();
+
 std::string RemoveBasePath(const std::string& szFilePath);
 std::wstring RemoveBasePath(const std::wstring& szFilePath);
 std::wstring GetFileExtension(const std::wstring& szFilepath);
+// absolute, lower case, backslash separated. for use as cache key.
+std::wstring NormalizePath(const std::wstring& szFilePath);
+HRESULT ReadWholeFile(const WCHAR* pszFileName, std::vector<UCHAR>& fileData);
+
+// FNV-1a.
+static const UINT64 HASH_SEED = 14695981039346656037ull;
+UINT64 HashBytes(const void* pDATA, const UINT64 SIZE, const UINT64 SEED = HASH_SEED);
 
 UINT64 GetAllocMemSize(UINT64 size);
 
@@ -1,6 +1,12 @@
 #ifndef PCH_H
 #define PCH_H
 
+#ifdef HEADLESS_TEST
+// linux build of D3D-free modules for Tests/.
+#include "Tests/Headless/HeadlessPlatform.h"
+#include "Graphics/EnumType.h"
+#else
+
 #define PX_SUPPORT_OMNI_PVD
 #include <PxPhysicsAPI.h>
 
@@ -51,6 +57,9 @@
 #include <synchapi.h>
 
 // #define USE_MULTI_THREAD
+// #define USE_COMPACT_VERTEX // quantized vertex buffers. see Model/VertexCompression.h
+// #define USE_ASSET_STREAMING // load material textures in background. see Renderer/AssetStreamer.h
+// #define USE_TEXTURE_COMPRESSION // BC encode material textures at import. see Graphics/TextureCompressor.h
 
 #include "Graphics/EnumType.h"
 #include "Renderer/Renderer.h"
@@ -69,4 +78,5 @@
 // #define ALIGN(size) __declspec(align(size))
 
 
+#endif // HEADLESS_TEST
 #endif